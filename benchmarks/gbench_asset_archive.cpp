@@ -0,0 +1,139 @@
+#include <cstdlib> // for getenv()
+#include "benchmark/benchmark.h"
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <ncine/IFile.h>
+#include <ncine/FileSystem.h>
+#include <ncine/AssetArchive.h>
+
+namespace nc = ncine;
+
+const char *DataDirectoryName = "gbench_asset_archive_data";
+const char *ArchiveName = "gbench_asset_archive_data.ncar";
+const unsigned int NumDirectories = 16;
+const unsigned int MaxFiles = 4096;
+const unsigned int FileSize = 2048;
+
+nctl::String dataDirectory;
+nctl::String archiveFilename;
+nctl::Array<nctl::String> filenames;
+nctl::Array<unsigned char> buffer(FileSize);
+
+/// Returns the directory for temporary files of the operating system
+nctl::String tempDir()
+{
+#ifdef _WIN32
+	const char *tempEnv = getenv("TEMP");
+	const char *defaultDir = ".";
+#else
+	const char *tempEnv = getenv("TMPDIR");
+	const char *defaultDir = "/tmp";
+#endif
+	return nctl::String((tempEnv && tempEnv[0] != '\0') ? tempEnv : defaultDir);
+}
+
+/// Deletes all the files and directories that might have been created by `createData()`
+void deleteData()
+{
+	nc::AssetArchive::unmountAll();
+	nctl::String filename(256);
+	for (unsigned int i = 0; i < MaxFiles; i++)
+	{
+		filename.format("%s/dir%02u/file%04u.bin", dataDirectory.data(), i % NumDirectories, i);
+		if (nc::fs::isFile(filename.data()))
+			nc::fs::deleteFile(filename.data());
+	}
+	for (unsigned int i = 0; i < NumDirectories; i++)
+	{
+		filename.format("%s/dir%02u", dataDirectory.data(), i);
+		if (nc::fs::isDirectory(filename.data()))
+			nc::fs::deleteEmptyDir(filename.data());
+	}
+	if (nc::fs::isDirectory(dataDirectory.data()))
+		nc::fs::deleteEmptyDir(dataDirectory.data());
+	if (nc::fs::isFile(archiveFilename.data()))
+		nc::fs::deleteFile(archiveFilename.data());
+}
+
+/// Creates a tree of small files, like the assets loaded at startup, and packs it in an archive
+void createData(unsigned int numFiles)
+{
+	static unsigned int numCreatedFiles = 0;
+	if (numCreatedFiles == numFiles)
+		return;
+
+	filenames.clear();
+	nc::fs::createDir(dataDirectory.data());
+	buffer.setSize(FileSize);
+	for (unsigned int i = 0; i < FileSize; i++)
+		buffer[i] = static_cast<unsigned char>(i);
+
+	nctl::String filename(256);
+	for (unsigned int i = 0; i < numFiles; i++)
+	{
+		filename.format("%s/dir%02u", dataDirectory.data(), i % NumDirectories);
+		nc::fs::createDir(filename.data());
+		filename.formatAppend("/file%04u.bin", i);
+		filenames.pushBack(filename);
+
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename.data());
+		fileHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+		fileHandle->write(buffer.data(), FileSize);
+	}
+
+	nc::AssetArchive::unmountAll();
+	nc::AssetArchive::build(dataDirectory.data(), archiveFilename.data());
+	numCreatedFiles = numFiles;
+}
+
+void readFiles(benchmark::State &state)
+{
+	for (unsigned int i = 0; i < state.range(0); i++)
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filenames[i].data());
+		fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+		fileHandle->read(buffer.data(), FileSize);
+	}
+}
+
+static void BM_LooseFiles(benchmark::State &state)
+{
+	createData(state.range(0));
+
+	for (auto _ : state)
+		readFiles(state);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LooseFiles)->Arg(MaxFiles / 4)->Arg(MaxFiles / 2)->Arg(MaxFiles);
+
+static void BM_ArchiveFiles(benchmark::State &state)
+{
+	createData(state.range(0));
+
+	for (auto _ : state)
+	{
+		nc::AssetArchive::mount(archiveFilename.data(), dataDirectory.data());
+		readFiles(state);
+		nc::AssetArchive::unmountAll();
+	}
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArchiveFiles)->Arg(MaxFiles / 4)->Arg(MaxFiles / 2)->Arg(MaxFiles);
+
+int main(int argc, char **argv)
+{
+	// The data is created in the temporary directory and deleted when the benchmarks have finished
+	const nctl::String baseDir = tempDir();
+	dataDirectory = nc::fs::joinPath(baseDir, DataDirectoryName);
+	archiveFilename = nc::fs::joinPath(baseDir, ArchiveName);
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	deleteData();
+
+	return 0;
+}
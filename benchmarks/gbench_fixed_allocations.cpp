@@ -5,6 +5,8 @@
 #include <nctl/StackAllocator.h>
 #include <nctl/PoolAllocator.h>
 #include <nctl/FreeListAllocator.h>
+#include <nctl/AtomicPoolAllocator.h>
+#include <nctl/ThreadCachingAllocator.h>
 
 const unsigned int BufferSize = (65536 + 4) * 1024;
 uint8_t buffer[BufferSize];
@@ -232,4 +234,57 @@ BENCHMARK(BM_FixedAllocations_FreeListAllocator_Reverse_NoDefrag)->Args({ Repeti
                                                                  ->Args({ Repetitions / 4, 4096 })->Args({ Repetitions / 2, 4096 })->Args({ Repetitions, 4096 })
                                                                  ->Args({ Repetitions / 4, 65536 })->Args({ Repetitions / 2, 65536 })->Args({ Repetitions, 65536 });
 
+static void BM_FixedAllocations_malloc_Threaded(benchmark::State &state)
+{
+	void *ptrs[Repetitions];
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			ptrs[i] = malloc(state.range(1));
+		for (unsigned int i = 0; i < state.range(0); i++)
+			free(ptrs[i]);
+	}
+}
+BENCHMARK(BM_FixedAllocations_malloc_Threaded)->Args({ Repetitions / 4, 1024 })->Args({ Repetitions, 1024 })
+                                              ->Args({ Repetitions / 4, 4096 })->Args({ Repetitions, 4096 })->ThreadRange(1, 8);
+
+nctl::AtomicPoolAllocator atomicPool;
+
+static void BM_FixedAllocations_AtomicPoolAllocator_Threaded(benchmark::State &state)
+{
+	// The other threads wait for the first one at the start of the loop
+	if (state.thread_index() == 0)
+		atomicPool.init(state.range(1), BufferSize, buffer);
+	void *ptrs[Repetitions];
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			ptrs[i] = atomicPool.allocate(state.range(1));
+		for (unsigned int i = 0; i < state.range(0); i++)
+			atomicPool.deallocate(ptrs[i]);
+	}
+}
+BENCHMARK(BM_FixedAllocations_AtomicPoolAllocator_Threaded)->Args({ Repetitions / 4, 1024 })->Args({ Repetitions, 1024 })
+                                                           ->Args({ Repetitions / 4, 4096 })->Args({ Repetitions, 4096 })->ThreadRange(1, 8);
+
+nctl::MallocAllocator backingAllocator;
+nctl::ThreadCachingAllocator threadCaching(backingAllocator);
+
+static void BM_FixedAllocations_ThreadCachingAllocator_Threaded(benchmark::State &state)
+{
+	void *ptrs[Repetitions];
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			ptrs[i] = threadCaching.allocate(state.range(1));
+		for (unsigned int i = 0; i < state.range(0); i++)
+			threadCaching.deallocate(ptrs[i]);
+	}
+}
+BENCHMARK(BM_FixedAllocations_ThreadCachingAllocator_Threaded)->Args({ Repetitions / 4, 1024 })->Args({ Repetitions, 1024 })
+                                                              ->Args({ Repetitions / 4, 4096 })->Args({ Repetitions, 4096 })->ThreadRange(1, 8);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+#include "benchmark/benchmark.h"
+#include <nctl/Array.h>
+#include <nctl/algorithms.h>
+#include <ncine/Random.h>
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumCommands = 128 * 1024;
+const unsigned int NumMaterials = 64;
+
+/// A command with the same sorting keys as a render command
+struct Command
+{
+	uint64_t materialSortKey;
+	uint32_t idSortKey;
+};
+
+struct SortElement
+{
+	uint64_t materialSortKey;
+	uint32_t idSortKey;
+	Command *command;
+};
+
+bool ascendingOrder(const Command *a, const Command *b)
+{
+	return (a->materialSortKey != b->materialSortKey)
+	           ? a->materialSortKey < b->materialSortKey
+	           : a->idSortKey < b->idSortKey;
+}
+
+nctl::Array<Command> commands(NumCommands);
+nctl::Array<Command *> unsortedCommands(NumCommands);
+
+void initCommands()
+{
+	nc::random().init(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL);
+
+	commands.clear();
+	unsortedCommands.clear();
+	for (unsigned int i = 0; i < NumCommands; i++)
+	{
+		// Layer and visit order in the upper half, few materials in the lower one
+		const uint64_t layerSortKey = nc::random().integer(0, 16) << 16 | nc::random().integer(0, 0xffff);
+		const uint64_t materialKey = nc::random().integer(0, NumMaterials);
+		commands.pushBack({ (layerSortKey << 32) | materialKey, nc::random().integer() });
+	}
+	for (unsigned int i = 0; i < NumCommands; i++)
+		unsortedCommands.pushBack(&commands[i]);
+}
+
+}
+
+static void BM_SortQuicksort(benchmark::State &state)
+{
+	initCommands();
+	nctl::Array<Command *> queue(state.range(0));
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		queue.clear();
+		for (unsigned int i = 0; i < state.range(0); i++)
+			queue.pushBack(unsortedCommands[i]);
+		state.ResumeTiming();
+
+		nctl::quicksort(queue.begin(), queue.end(), ascendingOrder);
+		benchmark::DoNotOptimize(queue);
+	}
+}
+BENCHMARK(BM_SortQuicksort)->Arg(NumCommands / 128)->Arg(NumCommands / 32)->Arg(NumCommands / 8)->Arg(NumCommands);
+
+static void BM_SortRadix(benchmark::State &state)
+{
+	initCommands();
+	nctl::Array<Command *> queue(state.range(0));
+	// Buffers are reused across iterations, like across frames
+	nctl::Array<SortElement> elements(state.range(0));
+	nctl::Array<SortElement> scratch(state.range(0));
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		queue.clear();
+		for (unsigned int i = 0; i < state.range(0); i++)
+			queue.pushBack(unsortedCommands[i]);
+		state.ResumeTiming();
+
+		const unsigned int size = queue.size();
+		elements.setSize(size);
+		scratch.setSize(size);
+		for (unsigned int i = 0; i < size; i++)
+			elements[i] = { queue[i]->materialSortKey, queue[i]->idSortKey, queue[i] };
+
+		SortElement *first = elements.data();
+		nctl::radixSort(first, first + size, scratch.data(), [](const SortElement &element) { return element.idSortKey; });
+		nctl::radixSort(first, first + size, scratch.data(), [](const SortElement &element) { return element.materialSortKey; });
+
+		for (unsigned int i = 0; i < size; i++)
+			queue[i] = elements[i].command;
+		benchmark::DoNotOptimize(queue);
+	}
+}
+BENCHMARK(BM_SortRadix)->Arg(NumCommands / 128)->Arg(NumCommands / 32)->Arg(NumCommands / 8)->Arg(NumCommands);
+
+BENCHMARK_MAIN();
@@ -5,6 +5,7 @@
 #include <nctl/StackAllocator.h>
 #include <nctl/PoolAllocator.h>
 #include <nctl/FreeListAllocator.h>
+#include <nctl/ThreadCachingAllocator.h>
 
 const unsigned int BufferSize = 65536 * 1024 + 512;
 uint16_t buffer[BufferSize];
@@ -210,4 +211,39 @@ static void BM_RandomAllocations_FreeListAllocator_NoDefrag_Reverse(benchmark::S
 }
 BENCHMARK(BM_RandomAllocations_FreeListAllocator_NoDefrag_Reverse)->Arg(Repetitions / 4)->Arg(Repetitions / 2)->Arg(Repetitions);
 
+static void BM_RandomAllocations_malloc_Threaded(benchmark::State &state)
+{
+	if (state.thread_index() == 0)
+		setup();
+	void *ptrs[Repetitions];
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			ptrs[i] = malloc(allocSizes[i]);
+		for (unsigned int i = 0; i < state.range(0); i++)
+			free(ptrs[i]);
+	}
+}
+BENCHMARK(BM_RandomAllocations_malloc_Threaded)->Arg(Repetitions / 4)->Arg(Repetitions)->ThreadRange(1, 8);
+
+nctl::MallocAllocator backingAllocator;
+nctl::ThreadCachingAllocator threadCaching(backingAllocator);
+
+static void BM_RandomAllocations_ThreadCachingAllocator_Threaded(benchmark::State &state)
+{
+	if (state.thread_index() == 0)
+		setup();
+	void *ptrs[Repetitions];
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			ptrs[i] = threadCaching.allocate(allocSizes[i]);
+		for (unsigned int i = 0; i < state.range(0); i++)
+			threadCaching.deallocate(ptrs[i]);
+	}
+}
+BENCHMARK(BM_RandomAllocations_ThreadCachingAllocator_Threaded)->Arg(Repetitions / 4)->Arg(Repetitions)->ThreadRange(1, 8);
+
 BENCHMARK_MAIN();
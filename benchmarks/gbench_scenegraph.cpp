@@ -0,0 +1,506 @@
+#include "benchmark/benchmark.h"
+#include <ncine/config.h>
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+#include <ncine/PCApplication.h>
+#include <ncine/IAppEventHandler.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/Random.h>
+#include <ncine/TimeStamp.h>
+#include <ncine/Texture.h>
+#include <ncine/Font.h>
+#include <ncine/Camera.h>
+#include <ncine/Viewport.h>
+#include <ncine/Sprite.h>
+#include <ncine/MeshSprite.h>
+#include <ncine/TextNode.h>
+#include <ncine/ParticleSystem.h>
+#include <ncine/ParticleInitializer.h>
+#include "RenderQueue.h"
+#include "RenderResources.h"
+#include "RenderBuffersManager.h"
+#include "RenderCommandPool.h"
+#include "SpatialGrid.h"
+
+#if NCINE_WITH_ALLOCATORS
+	#include <nctl/AllocManager.h>
+	#include <nctl/FrameAllocator.h>
+#endif
+
+namespace nc = ncine;
+
+namespace {
+
+/// The fixed seeds used to generate every scene, so that results can be compared across runs and releases
+const uint64_t RandomState = 0x853c49e6748fea9bULL;
+const uint64_t RandomSequence = 0xda3e39cb94b95bdbULL;
+
+/// A fixed interval makes the animation of a frame independent from the time taken by the previous one
+const float FrameInterval = 1.0f / 60.0f;
+/// The scenes are generated for a fixed size, regardless of the resolution of the graphics device
+const float SceneWidth = 1280.0f;
+const float SceneHeight = 720.0f;
+/// Nodes are spread over an area larger than the screen, to have some of them culled
+const float SceneMargin = 0.25f;
+/// The cell size of the spatial grid for the scenes that use it
+const float GridCellSize = 128.0f;
+
+const unsigned int NumTextures = 4;
+const int TextureSize = 128;
+/// One node every `AnimateEvery` has its rotation changed every frame
+const unsigned int AnimateEvery = 4;
+
+const unsigned int NumChains = 256;
+const float ChainOffset = 12.0f;
+const float ChainRotation = 4.0f;
+const float ChainScale = 0.98f;
+
+const unsigned int ParticlesPerSystem = 32;
+const unsigned int TextLength = 16;
+const unsigned int NumViewportSprites = 32 * 1024;
+
+const unsigned int NumTexelPoints = 5;
+const nc::Vector2f TexelPoints[NumTexelPoints] = {
+	{ 3.0f, 79.0f }, { 26.0f, 2.0f }, { 64.0f, 125.0f }, { 102.0f, 2.0f }, { 125.0f, 79.0f }
+};
+
+const unsigned int FontTextureSize = 256;
+const unsigned int FontGlyphSize = 16;
+const unsigned int FontFirstGlyph = 32;
+const unsigned int FontLastGlyph = 126;
+
+/// The phases of a frame that are measured separately
+struct Phase
+{
+	enum
+	{
+		UPDATE,
+		CULLING,
+		VISIT,
+		SORT,
+		BATCHING,
+		COMMIT,
+
+		COUNT
+	};
+};
+
+/// The last three phases are the steps of `RenderQueue::sortAndCommit()`, each one is only run once per frame
+const char *PhaseNames[Phase::COUNT] = { "Update", "Culling", "Visit", "Sort", "CreateBatches", "Commit" };
+
+int benchmarkArgc = 0;
+char **benchmarkArgv = nullptr;
+
+nctl::UniquePtr<nc::Texture> textures[NumTextures];
+nctl::UniquePtr<nc::Texture> fontTexture;
+nctl::UniquePtr<nc::Font> font;
+
+/// Creates the textures and the font shared by all the scenes, no asset file is needed
+void createResources()
+{
+	for (unsigned int i = 0; i < NumTextures; i++)
+	{
+		nctl::String textureName;
+		textureName.format("Texture%u", i);
+		// Half of the textures are opaque, their commands are sorted by material and batched together
+		const nc::Texture::Format format = (i % 2 == 0) ? nc::Texture::Format::RGB8 : nc::Texture::Format::RGBA8;
+		textures[i] = nctl::makeUnique<nc::Texture>(textureName.data(), format, TextureSize, TextureSize);
+	}
+
+	// A monospaced font laid out on a grid of glyphs
+	const unsigned int glyphsPerRow = FontTextureSize / FontGlyphSize;
+	nctl::String fntBuffer(8192);
+	fntBuffer.format("info face=\"Benchmark\" size=%u bold=0 italic=0 charset=\"\" unicode=1 stretchH=100 smooth=1 aa=1 padding=0,0,0,0 spacing=0,0 outline=0\n", FontGlyphSize);
+	fntBuffer.formatAppend("common lineHeight=%u base=%u scaleW=%u scaleH=%u pages=1 packed=0 alphaChnl=0 redChnl=4 greenChnl=4 blueChnl=4\n",
+	                       FontGlyphSize, FontGlyphSize - 4, FontTextureSize, FontTextureSize);
+	fntBuffer.formatAppend("page id=0 file=\"Benchmark.png\"\n");
+	fntBuffer.formatAppend("chars count=%u\n", FontLastGlyph - FontFirstGlyph + 1);
+	for (unsigned int glyph = FontFirstGlyph; glyph <= FontLastGlyph; glyph++)
+	{
+		const unsigned int index = glyph - FontFirstGlyph;
+		fntBuffer.formatAppend("char id=%u x=%u y=%u width=%u height=%u xoffset=0 yoffset=0 xadvance=%u page=0 chnl=15\n", glyph,
+		                       (index % glyphsPerRow) * FontGlyphSize, (index / glyphsPerRow) * FontGlyphSize, FontGlyphSize, FontGlyphSize, FontGlyphSize);
+	}
+
+	fontTexture = nctl::makeUnique<nc::Texture>("FontTexture", nc::Texture::Format::R8, FontTextureSize, FontTextureSize);
+	font = nctl::makeUnique<nc::Font>("Benchmark.fnt", reinterpret_cast<const unsigned char *>(fntBuffer.data()), fntBuffer.length(), fontTexture.get());
+}
+
+void destroyResources()
+{
+	font.reset(nullptr);
+	fontTexture.reset(nullptr);
+	for (unsigned int i = 0; i < NumTextures; i++)
+		textures[i].reset(nullptr);
+}
+
+/// A viewport that runs the phases of a frame one at a time
+class BenchmarkViewport : public nc::Viewport
+{
+  public:
+	BenchmarkViewport()
+	    : nc::Viewport() {}
+
+	/// Returns the number of commands that have been visited this frame
+	inline unsigned int numCommands() const { return renderQueue_->opaqueQueue().size() + renderQueue_->transparentQueue().size(); }
+
+	/// Transforms the nodes of the viewport
+	inline void updateNodes(float interval) { rootNode_->update(interval); }
+
+	/// Updates the culling state of the nodes
+	/*! \note The frame counter does not advance while benchmarks run, `Viewport::update()` skips the nodes already updated by `updateNodes()` */
+	inline void cullNodes() { update(); }
+
+	inline void visitNodes() { visit(); }
+	inline void sortCommands() { renderQueue_->sort(); }
+	inline void createBatches() { renderQueue_->createBatches(); }
+
+	/// Commits the commands like `Viewport::sortAndCommitQueue()` does after sorting and batching them
+	/*! \note The current viewport has already been set by `visitNodes()` */
+	void commitCommands()
+	{
+		renderQueue_->commit();
+		stateBits_.set(StateBitPositions::CommittedBit);
+	}
+
+	/// Clears the queue like `ScreenViewport::draw()` does at the end of a frame
+	void endFrame()
+	{
+		renderQueue_->clear();
+		stateBits_.reset();
+	}
+
+};
+
+/// A procedurally generated scene, rendered by one or more viewports
+class Scene
+{
+  public:
+	explicit Scene(unsigned int numViewports)
+	    : numCommands_(0), frame_(0)
+	{
+		nc::random().init(RandomState, RandomSequence);
+		for (unsigned int i = 0; i < numViewports; i++)
+		{
+			roots_.pushBack(nctl::makeUnique<nc::SceneNode>());
+			cameras_.pushBack(nctl::makeUnique<nc::Camera>());
+			viewports_.pushBack(nctl::makeUnique<BenchmarkViewport>());
+			viewports_.back()->setRootNode(roots_.back().get());
+			viewports_.back()->setCamera(cameras_.back().get());
+		}
+	}
+
+	~Scene()
+	{
+		// Children are destroyed before their parents, as nodes have been added in hierarchy order
+		while (nodes_.isEmpty() == false)
+			nodes_.popBack();
+	}
+
+	inline unsigned int numNodes() const { return nodes_.size(); }
+	inline unsigned int numCommands() const { return numCommands_; }
+
+	/// Sprites at random positions, all children of the root node
+	void createFlatSprites(unsigned int numSprites, bool withGrid)
+	{
+		if (withGrid)
+			viewports_[0]->setCullingGridCellSize(GridCellSize);
+		for (unsigned int i = 0; i < numSprites; i++)
+			addSprite(roots_[0].get(), randomPosition());
+	}
+
+	/// Chains of nested sprites, each child is transformed relative to its parent
+	void createDeepHierarchy(unsigned int depth)
+	{
+		for (unsigned int i = 0; i < NumChains; i++)
+		{
+			nc::SceneNode *parent = roots_[0].get();
+			nc::Vector2f position = randomPosition();
+			for (unsigned int j = 0; j < depth; j++)
+			{
+				nc::Sprite *sprite = addSprite(parent, position);
+				sprite->setRotation(ChainRotation);
+				sprite->setScale(ChainScale);
+				parent = sprite;
+				position.set(ChainOffset, 0.0f);
+			}
+		}
+	}
+
+	/// Sprites, mesh sprites, text nodes and particle systems in the same proportions of a typical game scene
+	void createMixed(unsigned int numNodes)
+	{
+		nc::ParticleInitializer particleInit;
+		particleInit.setAmount(ParticlesPerSystem);
+		// Particles are not supposed to die during the benchmark
+		particleInit.setLife(3600.0f);
+		particleInit.setPositionInDisc(32.0f);
+		particleInit.setVelocity(-1.0f, -1.0f, 1.0f, 1.0f);
+
+		nctl::String string(TextLength);
+		for (unsigned int i = 0; i < numNodes; i++)
+		{
+			nc::SceneNode *root = roots_[0].get();
+			switch (i % 8)
+			{
+				case 0:
+				case 1:
+				case 2:
+				case 3:
+					addSprite(root, randomPosition());
+					break;
+				case 4:
+				case 5:
+				{
+					nctl::UniquePtr<nc::MeshSprite> meshSprite = nctl::makeUnique<nc::MeshSprite>(root, randomTexture(), randomPosition());
+					meshSprite->createVerticesFromTexels(NumTexelPoints, TexelPoints);
+					meshSprite->setScale(nc::random().real(0.25f, 0.5f));
+					nodes_.pushBack(nctl::move(meshSprite));
+					break;
+				}
+				case 6:
+				{
+					nctl::UniquePtr<nc::TextNode> textNode = nctl::makeUnique<nc::TextNode>(root, font.get(), TextLength);
+					textNode->setPosition(randomPosition());
+					string.format("Node #%u", i);
+					textNode->setString(string);
+					nodes_.pushBack(nctl::move(textNode));
+					break;
+				}
+				case 7:
+				{
+					nctl::UniquePtr<nc::ParticleSystem> particleSystem = nctl::makeUnique<nc::ParticleSystem>(root, ParticlesPerSystem, randomTexture());
+					particleSystem->setPosition(randomPosition());
+					particleSystem->emitParticles(particleInit);
+					nodes_.pushBack(nctl::move(particleSystem));
+					break;
+				}
+			}
+		}
+	}
+
+	/// The same number of sprites split among viewports, each one with its own root node and camera
+	void createViewports()
+	{
+		const unsigned int numViewports = viewports_.size();
+		const unsigned int spritesPerViewport = NumViewportSprites / numViewports;
+		for (unsigned int i = 0; i < numViewports; i++)
+		{
+			cameras_[i]->setView(nc::random().real(-SceneMargin, SceneMargin) * SceneWidth,
+			                     nc::random().real(-SceneMargin, SceneMargin) * SceneHeight, 0.0f, 1.0f);
+			for (unsigned int j = 0; j < spritesPerViewport; j++)
+				addSprite(roots_[i].get(), randomPosition());
+		}
+	}
+
+	/// Runs all the phases of a frame that precede drawing, storing the time taken by each one
+	void runFrame(float phaseTimes[Phase::COUNT])
+	{
+#if NCINE_WITH_ALLOCATORS
+		nctl::theFrameAllocator().nextFrame();
+#endif
+		animate();
+
+		nc::TimeStamp startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->updateNodes(FrameInterval);
+		phaseTimes[Phase::UPDATE] = startTime.secondsSince();
+
+		startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->cullNodes();
+		phaseTimes[Phase::CULLING] = startTime.secondsSince();
+
+		startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->visitNodes();
+		phaseTimes[Phase::VISIT] = startTime.secondsSince();
+
+		startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->sortCommands();
+		phaseTimes[Phase::SORT] = startTime.secondsSince();
+
+		// The previous frame layout is reused if the sorted queues are unchanged
+		startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->createBatches();
+		phaseTimes[Phase::BATCHING] = startTime.secondsSince();
+
+		startTime = nc::TimeStamp::now();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->commitCommands();
+		phaseTimes[Phase::COMMIT] = startTime.secondsSince();
+
+		numCommands_ = 0;
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			numCommands_ += viewport->numCommands();
+
+		nc::RenderResources::buffersManager().flushUnmap();
+		for (nctl::UniquePtr<BenchmarkViewport> &viewport : viewports_)
+			viewport->endFrame();
+		nc::RenderResources::buffersManager().remap();
+		nc::RenderResources::renderCommandPool().reset();
+	}
+
+  private:
+	/// Nodes in hierarchy order, parents always come before their children
+	nctl::Array<nctl::UniquePtr<nc::SceneNode>> nodes_;
+	nctl::Array<nctl::UniquePtr<nc::SceneNode>> roots_;
+	nctl::Array<nctl::UniquePtr<nc::Camera>> cameras_;
+	nctl::Array<nctl::UniquePtr<BenchmarkViewport>> viewports_;
+	unsigned int numCommands_;
+	unsigned int frame_;
+
+	/// Changes the rotation of a fixed subset of nodes
+	void animate()
+	{
+		frame_++;
+		for (unsigned int i = frame_ % AnimateEvery; i < nodes_.size(); i += AnimateEvery)
+			nodes_[i]->setRotation(nodes_[i]->rotation() + 1.0f);
+	}
+
+	nc::Vector2f randomPosition() const
+	{
+		return nc::Vector2f(nc::random().real(-SceneMargin, 1.0f + SceneMargin) * SceneWidth,
+		                    nc::random().real(-SceneMargin, 1.0f + SceneMargin) * SceneHeight);
+	}
+
+	nc::Texture *randomTexture() const
+	{
+		return textures[nc::random().integer(0, NumTextures)].get();
+	}
+
+	nc::Sprite *addSprite(nc::SceneNode *parent, const nc::Vector2f &position)
+	{
+		nctl::UniquePtr<nc::Sprite> sprite = nctl::makeUnique<nc::Sprite>(parent, randomTexture(), position.x, position.y);
+		sprite->setRotation(nc::random().real(0.0f, 360.0f));
+		sprite->setScale(nc::random().real(0.25f, 0.5f));
+		nc::Sprite *spritePtr = sprite.get();
+		nodes_.pushBack(nctl::move(sprite));
+		return spritePtr;
+	}
+};
+
+void runBenchmark(benchmark::State &state, Scene &scene, unsigned int phase)
+{
+	float phaseTimes[Phase::COUNT];
+	// The first frame creates the render commands and fills the caches of the render queues
+	scene.runFrame(phaseTimes);
+
+	for (auto _ : state)
+	{
+		scene.runFrame(phaseTimes);
+		state.SetIterationTime(phaseTimes[phase]);
+	}
+
+	state.counters["Nodes"] = scene.numNodes();
+	state.counters["Commands"] = scene.numCommands();
+	state.SetItemsProcessed(state.iterations() * scene.numNodes());
+}
+
+void BM_FlatSprites(benchmark::State &state, unsigned int phase)
+{
+	Scene scene(1);
+	scene.createFlatSprites(state.range(0), state.range(1) != 0);
+	runBenchmark(state, scene, phase);
+}
+
+void BM_DeepHierarchy(benchmark::State &state, unsigned int phase)
+{
+	Scene scene(1);
+	scene.createDeepHierarchy(state.range(0));
+	runBenchmark(state, scene, phase);
+}
+
+void BM_Mixed(benchmark::State &state, unsigned int phase)
+{
+	Scene scene(1);
+	scene.createMixed(state.range(0));
+	runBenchmark(state, scene, phase);
+}
+
+void BM_Viewports(benchmark::State &state, unsigned int phase)
+{
+	Scene scene(state.range(0));
+	scene.createViewports();
+	runBenchmark(state, scene, phase);
+}
+
+void registerBenchmarks()
+{
+	nctl::String name(64);
+	for (unsigned int phase = 0; phase < Phase::COUNT; phase++)
+	{
+		name.format("BM_FlatSprites/%s", PhaseNames[phase]);
+		benchmark::RegisterBenchmark(name.data(), BM_FlatSprites, phase)
+		    ->ArgsProduct({ { 1000, 10000, 100000 }, { 0, 1 } })
+		    ->ArgNames({ "sprites", "grid" })
+		    ->UseManualTime()
+		    ->Unit(benchmark::kMicrosecond);
+
+		name.format("BM_DeepHierarchy/%s", PhaseNames[phase]);
+		benchmark::RegisterBenchmark(name.data(), BM_DeepHierarchy, phase)
+		    ->Arg(16)->Arg(64)->Arg(256)
+		    ->ArgName("depth")
+		    ->UseManualTime()
+		    ->Unit(benchmark::kMicrosecond);
+
+		name.format("BM_Mixed/%s", PhaseNames[phase]);
+		benchmark::RegisterBenchmark(name.data(), BM_Mixed, phase)
+		    ->Arg(1000)->Arg(10000)->Arg(50000)
+		    ->ArgName("nodes")
+		    ->UseManualTime()
+		    ->Unit(benchmark::kMicrosecond);
+
+		name.format("BM_Viewports/%s", PhaseNames[phase]);
+		benchmark::RegisterBenchmark(name.data(), BM_Viewports, phase)
+		    ->Arg(1)->Arg(4)->Arg(16)->Arg(64)
+		    ->ArgName("viewports")
+		    ->UseManualTime()
+		    ->Unit(benchmark::kMicrosecond);
+	}
+}
+
+/// Runs the benchmarks inside the application, after the rendering resources have been initialized
+class BenchmarkEventHandler : public nc::IAppEventHandler
+{
+  public:
+	void onPreInit(nc::AppConfiguration &config) override
+	{
+		config.withAudio = false;
+		config.withDebugOverlay = false;
+		config.withThreads = false;
+		config.headlessFrames = 1;
+		config.consoleLogLevel = nc::ILogger::LogLevel::WARN;
+		config.resolution.set(static_cast<int>(SceneWidth), static_cast<int>(SceneHeight));
+	}
+
+	void onInit() override
+	{
+		benchmark::Initialize(&benchmarkArgc, benchmarkArgv);
+		benchmark::AddCustomContext("random_state", "0x853c49e6748fea9b");
+		benchmark::AddCustomContext("random_sequence", "0xda3e39cb94b95bdb");
+
+		createResources();
+		registerBenchmarks();
+		benchmark::RunSpecifiedBenchmarks();
+		benchmark::Shutdown();
+		destroyResources();
+	}
+};
+
+nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
+{
+	return nctl::makeUnique<BenchmarkEventHandler>();
+}
+
+}
+
+int main(int argc, char **argv)
+{
+	benchmarkArgc = argc;
+	benchmarkArgv = argv;
+	return nc::PCApplication::start(createAppEventHandler, argc, argv);
+}
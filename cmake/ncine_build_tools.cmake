@@ -0,0 +1,3 @@
+if(NCINE_BUILD_TOOLS AND NOT ANDROID AND NOT EMSCRIPTEN)
+	add_subdirectory(tools)
+endif()
@@ -41,7 +41,24 @@ if(GLEW_FOUND)
 	target_link_libraries(ncine PRIVATE GLEW::GLEW)
 endif()
 
-if(GLFW_FOUND AND NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
+if(NCINE_WITH_NULL_GFX)
+	target_compile_definitions(ncine PRIVATE "WITH_NULL_GFX")
+
+	list(APPEND PRIVATE_HEADERS
+		${NCINE_ROOT}/src/include/NullGL.h
+		${NCINE_ROOT}/src/include/NullGLProgram.h
+		${NCINE_ROOT}/src/include/NullInputManager.h
+		${NCINE_ROOT}/src/include/NullGfxDevice.h
+		${NCINE_ROOT}/src/include/HeadlessReport.h
+	)
+	list(APPEND SOURCES
+		${NCINE_ROOT}/src/graphics/opengl/NullGL.cpp
+		${NCINE_ROOT}/src/graphics/opengl/NullGLProgram.cpp
+		${NCINE_ROOT}/src/input/NullInputManager.cpp
+		${NCINE_ROOT}/src/graphics/NullGfxDevice.cpp
+		${NCINE_ROOT}/src/HeadlessReport.cpp
+	)
+elseif(GLFW_FOUND AND NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
 	target_compile_definitions(ncine PRIVATE "WITH_GLFW")
 	target_link_libraries(ncine PRIVATE GLFW::GLFW)
 
@@ -161,6 +178,10 @@ if(WEBP_FOUND)
 		${NCINE_ROOT}/src/graphics/TextureLoaderWebP.cpp
 		${NCINE_ROOT}/src/graphics/TextureSaverWebP.cpp)
 endif()
+if(FREETYPE_FOUND)
+	target_compile_definitions(ncine PRIVATE "WITH_FREETYPE")
+	target_link_libraries(ncine PRIVATE Freetype::Freetype)
+endif()
 
 if(Threads_FOUND)
 	target_compile_definitions(ncine PRIVATE "WITH_THREADS")
@@ -186,6 +207,8 @@ if(Threads_FOUND)
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadPool.h)
 	list(APPEND SOURCES ${NCINE_ROOT}/src/threading/ThreadPool.cpp)
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadCommands.h)
+	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/SceneUpdater.h)
+	list(APPEND SOURCES ${NCINE_ROOT}/src/graphics/SceneUpdater.cpp)
 endif()
 
 if(LUA_FOUND)
@@ -334,6 +357,9 @@ if(NCINE_WITH_ALLOCATORS)
 		${NCINE_ROOT}/include/nctl/PoolAllocator.h
 		${NCINE_ROOT}/include/nctl/FreeListAllocator.h
 		${NCINE_ROOT}/include/nctl/ProxyAllocator.h
+		${NCINE_ROOT}/include/nctl/AtomicPoolAllocator.h
+		${NCINE_ROOT}/include/nctl/ThreadCachingAllocator.h
+		${NCINE_ROOT}/include/nctl/FrameAllocator.h
 	)
 
 	list(APPEND SOURCES
@@ -345,6 +371,9 @@ if(NCINE_WITH_ALLOCATORS)
 		${NCINE_ROOT}/src/base/PoolAllocator.cpp
 		${NCINE_ROOT}/src/base/FreeListAllocator.cpp
 		${NCINE_ROOT}/src/base/ProxyAllocator.cpp
+		${NCINE_ROOT}/src/base/AtomicPoolAllocator.cpp
+		${NCINE_ROOT}/src/base/ThreadCachingAllocator.cpp
+		${NCINE_ROOT}/src/base/FrameAllocator.cpp
 	)
 endif()
 
@@ -380,7 +409,10 @@ if(NCINE_WITH_IMGUI)
 		${NCINE_ROOT}/src/input/ImGuiJoyMappedInput.cpp
 	)
 
-	if(GLFW_FOUND AND NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
+	if(NCINE_WITH_NULL_GFX)
+		list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ImGuiNullInput.h)
+		list(APPEND SOURCES ${NCINE_ROOT}/src/input/ImGuiNullInput.cpp)
+	elseif(GLFW_FOUND AND NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
 		list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ImGuiGlfwInput.h)
 		list(APPEND SOURCES ${NCINE_ROOT}/src/input/ImGuiGlfwInput.cpp)
 	elseif(SDL2_FOUND AND NCINE_PREFERRED_BACKEND STREQUAL "SDL2")
@@ -440,7 +472,7 @@ endif()
 
 if(NCINE_WITH_TRACY)
 	target_compile_definitions(ncine PRIVATE "WITH_TRACY")
-	if(NOT ANDROID AND NOT APPLE AND NOT EMSCRIPTEN)
+	if(NOT ANDROID AND NOT APPLE AND NOT EMSCRIPTEN AND NOT NCINE_WITH_NULL_GFX)
 		target_compile_definitions(ncine PRIVATE "WITH_TRACY_OPENGL")
 	endif()
 	target_compile_definitions(ncine PUBLIC "TRACY_ENABLE")
@@ -495,6 +527,14 @@ if(NCINE_WITH_RENDERDOC AND NOT APPLE)
 	list(APPEND SOURCES ${NCINE_ROOT}/src/graphics/RenderDocCapture.cpp)
 endif()
 
+if(NCINE_COUNT_ALLOCATIONS)
+	target_compile_definitions(ncine PRIVATE "COUNT_ALLOCATIONS")
+	# The Tracy and the allocators overrides of the global operators already count allocations
+	if(NOT NCINE_WITH_TRACY AND NOT NCINE_OVERRIDE_NEW)
+		list(APPEND SOURCES ${NCINE_ROOT}/src/counting_memory.cpp)
+	endif()
+endif()
+
 if(NCINE_BUILD_ANDROID)
 	list(APPEND HEADERS
 		${NCINE_ROOT}/include/ncine/AndroidApplication.h
@@ -220,6 +220,7 @@ if(NCINE_WITH_ALLOCATORS)
 		file(APPEND ${CFGALLOC_H_FILE} "#define USE_FREELIST\n")
 		file(APPEND ${CFGALLOC_H_FILE} "#define FREELIST_BUFFER (${NCINE_FREELIST_BUFFER})\n")
 	endif()
+	file(APPEND ${CFGALLOC_H_FILE} "#define FRAME_ARENA_BUFFER (${NCINE_FRAME_ARENA_BUFFER})\n")
 endif()
 
 if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
@@ -235,7 +236,9 @@ if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
 		set(NCINE_WITH_OPENGLES TRUE)
 	endif()
 	set(NCINE_WITH_GLEW ${GLEW_FOUND})
-	if(NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
+	if(NCINE_WITH_NULL_GFX)
+		# The window backends are not compiled when using the null graphics device
+	elseif(NCINE_PREFERRED_BACKEND STREQUAL "GLFW")
 		set(NCINE_WITH_GLFW ${GLFW_FOUND})
 	elseif(NCINE_PREFERRED_BACKEND STREQUAL "SDL2")
 		set(NCINE_WITH_SDL ${SDL2_FOUND})
@@ -244,6 +247,7 @@ if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
 	endif()
 	set(NCINE_WITH_PNG ${PNG_FOUND})
 	set(NCINE_WITH_WEBP ${WEBP_FOUND})
+	set(NCINE_WITH_FREETYPE ${FREETYPE_FOUND})
 	set(NCINE_WITH_AUDIO ${OPENAL_FOUND})
 	if(NCINE_WITH_AUDIO AND VORBIS_FOUND)
 		set(NCINE_WITH_VORBIS TRUE)
@@ -279,6 +283,9 @@ if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
 	if(NCINE_WITH_QT5)
 		message(STATUS "NCINE_WITH_QT5: " ${NCINE_WITH_QT5})
 	endif()
+	if(NCINE_WITH_NULL_GFX)
+		message(STATUS "NCINE_WITH_NULL_GFX: " ${NCINE_WITH_NULL_GFX})
+	endif()
 	if(NCINE_WITH_AUDIO)
 		message(STATUS "NCINE_WITH_AUDIO: " ${NCINE_WITH_AUDIO})
 	endif()
@@ -291,6 +298,9 @@ if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
 	if(NCINE_WITH_WEBP)
 		message(STATUS "NCINE_WITH_WEBP: " ${NCINE_WITH_WEBP})
 	endif()
+	if(NCINE_WITH_FREETYPE)
+		message(STATUS "NCINE_WITH_FREETYPE: " ${NCINE_WITH_FREETYPE})
+	endif()
 	if(NCINE_WITH_LUA)
 		message(STATUS "NCINE_WITH_LUA: " ${NCINE_WITH_LUA})
 	endif()
@@ -312,4 +322,7 @@ if(EXISTS ${CMAKE_SOURCE_DIR}/config.h.in)
 	if(NCINE_WITH_RENDERDOC)
 		message(STATUS "NCINE_WITH_RENDERDOC: " ${NCINE_WITH_RENDERDOC})
 	endif()
+	if(NCINE_COUNT_ALLOCATIONS)
+		message(STATUS "NCINE_COUNT_ALLOCATIONS: " ${NCINE_COUNT_ALLOCATIONS})
+	endif()
 endif()
@@ -29,9 +29,11 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/DisplayMode.h
 	${NCINE_ROOT}/include/ncine/TimeStamp.h
 	${NCINE_ROOT}/include/ncine/Timer.h
+	${NCINE_ROOT}/include/ncine/AllocationCounter.h
 	${NCINE_ROOT}/include/ncine/Font.h
 	${NCINE_ROOT}/include/ncine/FileSystem.h
 	${NCINE_ROOT}/include/ncine/IFile.h
+	${NCINE_ROOT}/include/ncine/AssetArchive.h
 	${NCINE_ROOT}/include/ncine/IGfxDevice.h
 	${NCINE_ROOT}/include/ncine/Texture.h
 	${NCINE_ROOT}/include/ncine/ITextureSaver.h
@@ -89,7 +89,7 @@ endif()
 if(NCINE_WITH_THREADS)
 	find_package(Threads)
 endif()
-if(NOT ANDROID)
+if(NOT ANDROID AND NOT NCINE_WITH_NULL_GFX)
 	find_package(OpenGL REQUIRED)
 endif()
 if(MSVC)
@@ -122,13 +122,16 @@ elseif(NOT ANDROID) # GCC and LLVM
 	if(WIN32)
 		find_package(GLEW REQUIRED)
 	else()
-		if(NCINE_WITH_GLEW)
+		# The null graphics device replaces OpenGL, there are no functions for GLEW to load
+		if(NCINE_WITH_GLEW AND NOT NCINE_WITH_NULL_GFX)
 			find_package(GLEW)
 		endif()
 	endif()
 	if(NCINE_ARM_PROCESSOR)
 		include(check_atomic)
-		find_package(OpenGLES2)
+		if(NOT NCINE_WITH_NULL_GFX)
+			find_package(OpenGLES2)
+		endif()
 	endif()
 	# Look for both GLFW and SDL2 to make the fallback logic work
 	find_package(GLFW)
@@ -139,6 +142,9 @@ elseif(NOT ANDROID) # GCC and LLVM
 	if(NCINE_WITH_WEBP)
 		find_package(WebP)
 	endif()
+	if(NCINE_WITH_FREETYPE)
+		find_package(Freetype)
+	endif()
 	if(NCINE_WITH_AUDIO)
 		find_package(OpenAL)
 		if(NCINE_WITH_VORBIS)
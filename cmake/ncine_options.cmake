@@ -1,6 +1,7 @@
 option(NCINE_BUILD_TESTS "Build the engine test programs" ON)
 option(NCINE_BUILD_UNIT_TESTS "Build the engine unit tests" OFF)
 option(NCINE_BUILD_BENCHMARKS "Build the engine micro benchmarks" OFF)
+option(NCINE_BUILD_TOOLS "Build the engine command line tools" OFF)
 option(NCINE_INSTALL_DEV_SUPPORT "Install files to support development" ON)
 option(NCINE_LINKTIME_OPTIMIZATION "Compile the engine with link time optimization when in release" OFF)
 option(NCINE_AUTOVECTORIZATION_REPORT "Enable report generation from compiler auto-vectorization" OFF)
@@ -27,6 +28,7 @@ if(NOT WIN32 AND NOT NCINE_ARM_PROCESSOR)
 endif()
 option(NCINE_WITH_PNG "Enable PNG image file loading" ON)
 option(NCINE_WITH_WEBP "Enable WebP image file loading" ON)
+option(NCINE_WITH_FREETYPE "Enable FreeType to generate distance field fonts from vector font files" OFF)
 option(NCINE_WITH_AUDIO "Enable OpenAL support and thus sound" ON)
 option(NCINE_WITH_VORBIS "Enable Ogg Vorbis audio file loading" ON)
 option(NCINE_WITH_LUA "Enable Lua scripting integration" ON)
@@ -39,10 +41,18 @@ option(NCINE_WITH_IMGUI "Enable the integration with Dear ImGui" ON)
 option(NCINE_WITH_NUKLEAR "Enable the integration with Nuklear" OFF)
 option(NCINE_WITH_TRACY "Enable the integration with the Tracy frame profiler" OFF)
 option(NCINE_WITH_RENDERDOC "Enable the integration with RenderDoc" OFF)
+option(NCINE_COUNT_ALLOCATIONS "Count the allocations performed during every frame" OFF)
+if(NOT WIN32 AND NOT APPLE AND NOT EMSCRIPTEN AND NOT NCINE_BUILD_ANDROID)
+	option(NCINE_WITH_NULL_GFX "Replace the window backend and OpenGL with a headless device that only counts calls" OFF)
+endif()
 
 if(EMSCRIPTEN)
 	set(NCINE_DYNAMIC_LIBRARY OFF)
 endif()
+if(NCINE_WITH_NULL_GFX AND NCINE_WITH_NUKLEAR)
+	message(WARNING "Nuklear is not supported by the null graphics device and it will be disabled")
+	set(NCINE_WITH_NUKLEAR OFF)
+endif()
 
 set(NCINE_DATA_DIR "${PARENT_SOURCE_DIR}/nCine-data" CACHE PATH "Set the path to the engine data directory")
 set(NCINE_ICONS_DIR "${PARENT_SOURCE_DIR}/nCine-data/icons" CACHE PATH "Set the path to the engine icons directory")
@@ -62,6 +72,7 @@ if(NCINE_WITH_ALLOCATORS)
 	option(NCINE_OVERRIDE_NEW "Override global new and delete operators to use custom allocators" OFF)
 	option(NCINE_USE_FREELIST "Use the free list custom allocator instead of malloc()/free()" OFF)
 	set(NCINE_FREELIST_BUFFER "33554432" CACHE STRING "Size in bytes of the free list allocator buffer")
+	set(NCINE_FRAME_ARENA_BUFFER "4194304" CACHE STRING "Size in bytes of the buffer shared by the two arenas of the frame allocator")
 endif()
 
 if(NCINE_WITH_RENDERDOC)
@@ -93,6 +104,7 @@ if("${NCINE_OPTIONS_PRESETS}" STREQUAL "BinDist" OR
 	set(NCINE_BUILD_TESTS ON)
 	set(NCINE_BUILD_UNIT_TESTS OFF)
 	set(NCINE_BUILD_BENCHMARKS OFF)
+	set(NCINE_BUILD_TOOLS OFF)
 	set(NCINE_LINKTIME_OPTIMIZATION ON)
 	set(NCINE_AUTOVECTORIZATION_REPORT OFF)
 	set(NCINE_DYNAMIC_LIBRARY ON)
@@ -4,29 +4,40 @@ set(PRIVATE_HEADERS
 	${NCINE_ROOT}/src/include/Clock.h
 	${NCINE_ROOT}/src/include/ArrayIndexer.h
 	${NCINE_ROOT}/src/include/FrameTimer.h
+	${NCINE_ROOT}/src/include/JobPool.h
+	${NCINE_ROOT}/src/include/JobQueue.h
+	${NCINE_ROOT}/src/include/JobSystem.h
 	${NCINE_ROOT}/src/include/MemoryFile.h
 	${NCINE_ROOT}/src/include/StandardFile.h
+	${NCINE_ROOT}/src/include/MappedFile.h
+	${NCINE_ROOT}/src/include/ArchiveFile.h
 	${NCINE_ROOT}/src/include/FileLogger.h
 	${NCINE_ROOT}/src/include/JoyMapping.h
 	${NCINE_ROOT}/src/input/JoyMappingDb.h
 	${NCINE_ROOT}/src/include/FntParser.h
+	${NCINE_ROOT}/src/include/FontAtlas.h
+	${NCINE_ROOT}/src/include/SkylinePacker.h
 	${NCINE_ROOT}/src/include/FontGlyph.h
 	${NCINE_ROOT}/src/include/GfxCapabilities.h
 	${NCINE_ROOT}/src/include/RenderResources.h
 	${NCINE_ROOT}/src/include/RenderCommand.h
 	${NCINE_ROOT}/src/include/RenderQueue.h
+	${NCINE_ROOT}/src/include/SpatialGrid.h
 	${NCINE_ROOT}/src/include/Material.h
 	${NCINE_ROOT}/src/include/Geometry.h
 	${NCINE_ROOT}/src/include/Particle.h
+	${NCINE_ROOT}/src/include/ParticleData.h
 	${NCINE_ROOT}/src/include/TextureFormat.h
 	${NCINE_ROOT}/src/include/ITextureLoader.h
 	${NCINE_ROOT}/src/include/TextureLoaderRaw.h
+	${NCINE_ROOT}/src/include/AsyncTextureLoader.h
 	${NCINE_ROOT}/src/include/TextureLoaderDds.h
 	${NCINE_ROOT}/src/include/TextureLoaderPvr.h
 	${NCINE_ROOT}/src/include/TextureLoaderKtx.h
 	${NCINE_ROOT}/src/include/GLHashMap.h
 	${NCINE_ROOT}/src/include/GLBufferObject.h
 	${NCINE_ROOT}/src/include/GLBufferObject.h
+	${NCINE_ROOT}/src/include/GLFence.h
 	${NCINE_ROOT}/src/include/GLFramebufferObject.h
 	${NCINE_ROOT}/src/include/GLRenderbuffer.h
 	${NCINE_ROOT}/src/include/GLShader.h
@@ -6,7 +6,12 @@ set(SOURCES
 	${NCINE_ROOT}/src/base/Utf8.cpp
 	${NCINE_ROOT}/src/base/String.cpp
 	${NCINE_ROOT}/src/base/Clock.cpp
+	${NCINE_ROOT}/src/base/AllocationCounter.cpp
 	${NCINE_ROOT}/src/ServiceLocator.cpp
+	${NCINE_ROOT}/src/threading/JobPool.cpp
+	${NCINE_ROOT}/src/threading/JobQueue.cpp
+	${NCINE_ROOT}/src/threading/JobSystem.cpp
+	${NCINE_ROOT}/src/threading/NullThreadPool.cpp
 	${NCINE_ROOT}/src/FileLogger.cpp
 	${NCINE_ROOT}/src/ArrayIndexer.cpp
 	${NCINE_ROOT}/src/TimeStamp.cpp
@@ -14,11 +19,16 @@ set(SOURCES
 	${NCINE_ROOT}/src/FrameTimer.cpp
 	${NCINE_ROOT}/src/Font.cpp
 	${NCINE_ROOT}/src/FntParser.cpp
+	${NCINE_ROOT}/src/FontAtlas.cpp
+	${NCINE_ROOT}/src/SkylinePacker.cpp
 	${NCINE_ROOT}/src/FontGlyph.cpp
 	${NCINE_ROOT}/src/FileSystem.cpp
 	${NCINE_ROOT}/src/IFile.cpp
 	${NCINE_ROOT}/src/MemoryFile.cpp
 	${NCINE_ROOT}/src/StandardFile.cpp
+	${NCINE_ROOT}/src/MappedFile.cpp
+	${NCINE_ROOT}/src/ArchiveFile.cpp
+	${NCINE_ROOT}/src/AssetArchive.cpp
 	${NCINE_ROOT}/src/input/IInputManager.cpp
 	${NCINE_ROOT}/src/input/JoyMapping.cpp
 	${NCINE_ROOT}/src/graphics/Color.cpp
@@ -39,10 +49,12 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/TextureLoaderKtx.cpp
 	${NCINE_ROOT}/src/graphics/ITextureSaver.cpp
 	${NCINE_ROOT}/src/graphics/Texture.cpp
+	${NCINE_ROOT}/src/graphics/AsyncTextureLoader.cpp
 	${NCINE_ROOT}/src/graphics/Shader.cpp
 	${NCINE_ROOT}/src/graphics/ShaderState.cpp
 	${NCINE_ROOT}/src/graphics/DrawableNode.cpp
 	${NCINE_ROOT}/src/graphics/SceneNode.cpp
+	${NCINE_ROOT}/src/graphics/SpatialGrid.cpp
 	${NCINE_ROOT}/src/graphics/BaseSprite.cpp
 	${NCINE_ROOT}/src/graphics/Sprite.cpp
 	${NCINE_ROOT}/src/graphics/MeshSprite.cpp
@@ -50,12 +62,14 @@ set(SOURCES
 	${NCINE_ROOT}/src/AppConfiguration.cpp
 	${NCINE_ROOT}/src/graphics/Particle.cpp
 	${NCINE_ROOT}/src/graphics/ParticleAffectors.cpp
+	${NCINE_ROOT}/src/graphics/ParticleData.cpp
 	${NCINE_ROOT}/src/graphics/ParticleSystem.cpp
 	${NCINE_ROOT}/src/graphics/ParticleInitializer.cpp
 	${NCINE_ROOT}/src/graphics/TextNode.cpp
 	${NCINE_ROOT}/src/graphics/RectAnimation.cpp
 	${NCINE_ROOT}/src/graphics/AnimatedSprite.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLBufferObject.cpp
+	${NCINE_ROOT}/src/graphics/opengl/GLFence.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLFramebufferObject.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLRenderbuffer.cpp
 	${NCINE_ROOT}/src/graphics/opengl/GLShader.cpp
@@ -0,0 +1,55 @@
+#ifndef CLASS_NCINE_ALLOCATIONCOUNTER
+#define CLASS_NCINE_ALLOCATIONCOUNTER
+
+#include <cstddef>
+#include "common_defines.h"
+
+namespace ncine {
+
+/// A class that counts the allocations performed during every frame, in total and per zone
+/*! The counting hooks in the allocators and in the global `new` operators are only compiled
+ *  when the engine is built with the `NCINE_COUNT_ALLOCATIONS` option.
+ *  The zone is set per thread, the application marks the phases of a frame with its `Application::Timings` values. */
+class DLL_PUBLIC AllocationCounter
+{
+  public:
+	/// Maximum number of zones
+	static const unsigned int MaxZones = 16;
+	/// The zone of the allocations performed outside of any other one
+	static const unsigned int NoZone = MaxZones;
+
+	/// The number of allocations and the number of bytes allocated
+	struct Counters
+	{
+		Counters()
+		    : numAllocations(0), bytes(0) {}
+
+		unsigned long numAllocations;
+		unsigned long bytes;
+	};
+
+	/// Returns true if the engine has been compiled with the counting hooks
+	static bool isAvailable();
+
+	/// Counts an allocation in the current frame and in the zone of the calling thread
+	static void countAllocation(size_t bytes);
+
+	/// Sets the zone of the calling thread and returns the previous one
+	static unsigned int setZone(unsigned int zone);
+	/// Returns the zone of the calling thread
+	static unsigned int zone();
+
+	/// Starts a new frame, the counters of the current one become the last frame ones
+	static void nextFrame();
+
+	/// Returns the counters of all the allocations performed during the last frame
+	static Counters lastFrame();
+	/// Returns the counters of the allocations performed in a zone during the last frame
+	static Counters lastFrame(unsigned int zone);
+	/// Returns the counters of all the allocations performed since the start of the application
+	static Counters total();
+};
+
+}
+
+#endif
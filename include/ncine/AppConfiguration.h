@@ -53,6 +53,9 @@ class DLL_PUBLIC AppConfiguration
 
 	/// The flag is `true` if mapping is used to update OpenGL buffers
 	bool useBufferMapping;
+	/// The flag is `true` if OpenGL buffers are mapped only once and written as rings of sections, one per frame in flight
+	/*! \note It requires OpenGL 4.4 or the `GL_ARB_buffer_storage` extension, `useBufferMapping` is used when it is not supported. */
+	bool usePersistentMapping;
 	/// The flag is `true` when error checking and introspection of shader programs are deferred to first use
 	/*! \note The value is only taken into account when the scenegraph is being used */
 	bool deferShaderQueries;
@@ -60,10 +63,17 @@ class DLL_PUBLIC AppConfiguration
 	/*! \note Increasing this value too much might negatively affect batching shaders compilation time.
 	A value of zero restores the default behavior of non fixed size for batches. */
 	unsigned int fixedBatchSize;
+	/// The flag is `true` if the instance data of batches is stored in texture buffers instead of uniform buffers
+	/*! \note Texture buffers are not limited to 64 KiB, but they are only available on desktop OpenGL.
+	The uniform buffer path is used when they are not supported.
+	The number of commands in a texture buffer batch is limited by `tboSize` instead of by `RenderingSettings::maxBatchSize`. */
+	bool useTextureBufferBatching;
 	/// The maximum size in bytes for each VBO collecting geometry data
 	unsigned long vboSize;
 	/// The maximum size in bytes for each IBO collecting index data
 	unsigned long iboSize;
+	/// The maximum size in bytes for each texture buffer collecting batched instance data
+	unsigned long tboSize;
 	/// The maximum size for the pool of VAOs
 	unsigned int vaoPoolSize;
 	/// The initial size for the pool of render commands
@@ -75,6 +85,15 @@ class DLL_PUBLIC AppConfiguration
 	bool withAudio;
 	/// The flag is `true` if the threading subsystem is enabled
 	bool withThreads;
+	/// The flag is `true` if the scenegraph update is split into jobs for the worker threads
+	/*! \note The value is only taken into account when both the threading subsystem and the scenegraph are being used
+	 *  \warning Node updates, including the ones overridden by the application, run on the worker threads, see `SceneNode::update()` */
+	bool withParallelUpdate;
+	/// The maximum depth, starting from the root node, at which subtrees are split into separate update jobs
+	unsigned int parallelUpdateDepth;
+	/// The minimum number of nodes a single update job should process
+	/*! \note Subtrees with fewer nodes are grouped together into the same job */
+	unsigned int parallelUpdateMinNodes;
 	/// The flag is `true` if the scenegraph based rendering is enabled
 	bool withScenegraph;
 	/// The flag is `true` if the vertical synchronization is enabled
@@ -83,6 +102,11 @@ class DLL_PUBLIC AppConfiguration
 	bool withGlDebugContext;
 	/// The flag is `true` if console log messages should use colors
 	bool withConsoleColors;
+	/// The number of frames after which an application using the null graphics device quits, or 0 for no limit
+	/*! \note The null graphics device is used when the engine is built with the `NCINE_WITH_NULL_GFX` option, which replaces OpenGL with a layer that only counts calls */
+	unsigned int headlessFrames;
+	/// The file where the JSON report of a headless run is written when the application quits, or an empty string for no report
+	nctl::String headlessReportFile;
 
 	/// \returns The path for the application to load data from
 	const nctl::String &dataPath() const;
@@ -17,6 +17,8 @@ class IInputManager;
 class IAppEventHandler;
 class ImGuiDrawing;
 class NuklearDrawing;
+class SceneUpdater;
+class AsyncTextureLoader;
 
 /// Main entry point and handler for nCine applications
 class DLL_PUBLIC Application
@@ -26,19 +28,26 @@ class DLL_PUBLIC Application
 	struct RenderingSettings
 	{
 		RenderingSettings()
-		    : batchingEnabled(true), batchingWithIndices(false),
-		      cullingEnabled(true), minBatchSize(4), maxBatchSize(500) {}
+		    : batchingEnabled(true), batchingWithIndices(false), parallelBatchingEnabled(false),
+		      glyphInstancingEnabled(true), cullingEnabled(true), minBatchSize(4), maxBatchSize(500), maxTextureUploadTime(2.0f) {}
 
 		/// True if batching is enabled
 		bool batchingEnabled;
 		/// True if using indices for vertex batching
 		bool batchingWithIndices;
+		/// True if batches are filled in parallel by the worker threads of the thread pool
+		bool parallelBatchingEnabled;
+		/// True if batched text nodes are drawn with one instance per glyph instead of copying their vertices
+		bool glyphInstancingEnabled;
 		/// True if node culling is enabled
 		bool cullingEnabled;
 		/// Minimum size for a batch to be collected
 		unsigned int minBatchSize;
 		/// Maximum size for a batch before a forced split
+		/*! \note Batches with instance data in a texture buffer can be bigger, up to the number of instances that fit in it */
 		unsigned int maxBatchSize;
+		/// Milliseconds spent each frame uploading asynchronously loaded textures, at least one is always uploaded
+		float maxTextureUploadTime;
 	};
 
 	/// GUI settings (for ImGui and Nuklear) that can be changed at run-time
@@ -139,6 +148,12 @@ class DLL_PUBLIC Application
 	/// Returns the quit flag value
 	inline bool shouldQuit() const { return shouldQuit_; }
 
+	/// Returns the exit code of the application
+	inline int exitCode() const { return exitCode_; }
+	/// Sets the exit code returned by the application when it quits
+	/*! \note It is only used by the desktop version */
+	inline void setExitCode(int exitCode) { exitCode_ = exitCode; }
+
 	/// Returns the focus flag value
 	inline bool hasFocus() const { return hasFocus_; }
 
@@ -147,6 +162,7 @@ class DLL_PUBLIC Application
 	bool autoSuspension_;
 	bool hasFocus_;
 	bool shouldQuit_;
+	int exitCode_;
 	const AppConfiguration appCfg_;
 	RenderingSettings renderingSettings_;
 	GuiSettings guiSettings_;
@@ -158,6 +174,10 @@ class DLL_PUBLIC Application
 	nctl::UniquePtr<IGfxDevice> gfxDevice_;
 	nctl::UniquePtr<SceneNode> rootNode_;
 	nctl::UniquePtr<ScreenViewport> screenViewport_;
+	nctl::UniquePtr<AsyncTextureLoader> asyncTextureLoader_;
+#ifdef WITH_THREADS
+	nctl::UniquePtr<SceneUpdater> sceneUpdater_;
+#endif
 	nctl::UniquePtr<IDebugOverlay> debugOverlay_;
 	nctl::UniquePtr<IInputManager> inputManager_;
 	nctl::UniquePtr<IAppEventHandler> appEventHandler_;
@@ -205,7 +225,8 @@ class DLL_PUBLIC Application
 #ifdef __EMSCRIPTEN__
 	friend class IGfxDevice;
 #endif
-	friend class Viewport; // for `onDrawViewport()`
+	friend class Viewport; // for `onDrawViewport()` and `sceneUpdater_`
+	friend class Texture; // for `asyncTextureLoader_`
 	friend class GlfwInputManager; // for `resizeScreenViewport()`
 	friend class Qt5Widget; // for `resizeScreenViewport()`
 };
@@ -0,0 +1,88 @@
+#ifndef CLASS_NCINE_ASSETARCHIVE
+#define CLASS_NCINE_ASSETARCHIVE
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class IFile;
+
+/// The class that builds and mounts read-only packed asset archives
+/*! An archive is made of a header, a directory of entries sorted by the hash of their path,
+ *  the path names and the file blobs, each of them aligned to `BlobAlignment` bytes.
+ *  Mounted archives are memory-mapped and paths starting with their mount point are resolved through them
+ *  by `IFile::createFileHandle()` and `IFile::createMappedFileHandle()`, without any other file system access.
+ *  \note Archives should be mounted and unmounted when no file is being opened by other threads */
+class DLL_PUBLIC AssetArchive
+{
+  public:
+	/// The compression method of a blob
+	/*! \note Only uncompressed blobs are supported, the other values are reserved */
+	enum class Compression : uint8_t
+	{
+		NONE = 0,
+		LZ4,
+		ZSTD
+	};
+
+	/// The archive header, all numbers are stored as little endian
+	struct Header
+	{
+		char signature[4];
+		uint16_t version;
+		uint16_t flags;
+		uint32_t numEntries;
+		uint32_t namesSize;
+		uint64_t directoryOffset;
+		uint64_t namesOffset;
+	};
+
+	/// A directory entry, all numbers are stored as little endian
+	struct Entry
+	{
+		/// The hash of the path relative to the archive root, with forward slashes as separators
+		uint64_t pathHash;
+		uint64_t offset;
+		/// The uncompressed size of the blob
+		uint64_t size;
+		/// The size of the blob in the archive
+		uint64_t storedSize;
+		uint32_t nameOffset;
+		uint16_t nameLength;
+		uint8_t compression;
+		uint8_t padding;
+	};
+
+	static const char Signature[4];
+	static const uint16_t Version = 1;
+	/// The alignment in bytes of every blob inside the archive
+	static const unsigned int BlobAlignment = 16;
+
+	/// Builds an archive from all the files inside a directory and its subdirectories
+	static bool build(const char *directory, const char *archiveFilename);
+
+	/// Mounts an archive so that paths starting with the mount point are resolved through it
+	/*! \param mountPoint The path prefix of the archive files, an empty string to use relative paths
+	 *  \note Archives mounted later have precedence over the ones mounted before */
+	static bool mount(const char *archiveFilename, const char *mountPoint);
+	/// Unmounts an archive, file handles that are still alive keep its mapping valid
+	static bool unmount(const char *archiveFilename);
+	/// Unmounts all archives
+	static void unmountAll();
+	/// Returns the number of mounted archives
+	static unsigned int numMounted();
+
+	/// Returns true if a path is resolved by one of the mounted archives
+	static bool contains(const char *filename);
+	/// Returns a read-only handle for a file resolved by one of the mounted archives or `nullptr` if it is not found
+	static nctl::UniquePtr<IFile> createFileHandle(const char *filename);
+
+	/// Returns the hash of a path relative to an archive root, as stored in the directory entries
+	static uint64_t hashPath(const char *path);
+};
+
+}
+
+#endif
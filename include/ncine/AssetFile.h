@@ -28,6 +28,8 @@ class DLL_PUBLIC AssetFile : public IFile
 	unsigned long int write(const void *buffer, unsigned long int bytes) override { return 0; }
 
 	bool isOpened() const override;
+	/// Returns the asset buffer when the file is not opened with a file descriptor
+	const unsigned char *data() const override;
 
 	/// Sets the global pointer to the AAssetManager
 	static void initAssetManager(struct android_app *state) { assetManager_ = state->activity->assetManager; }
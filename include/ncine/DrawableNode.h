@@ -8,6 +8,7 @@ namespace ncine {
 
 class RenderCommand;
 class RenderQueue;
+class SpatialGrid;
 
 /// A class for objects that can be drawn through the render queue
 class DLL_PUBLIC DrawableNode : public SceneNode
@@ -125,7 +126,8 @@ class DLL_PUBLIC DrawableNode : public SceneNode
 	/// Calculates updated values for the AABB
 	virtual void updateAabb();
 	/// Called by each viewport update method to update a node culling state
-	void updateCulling();
+	/*! \return True if the overlap test is left to the specified spatial grid */
+	bool updateCulling(SpatialGrid *spatialGrid);
 
 	/// Protected copy constructor used to clone objects
 	DrawableNode(const DrawableNode &other);
@@ -137,11 +139,19 @@ class DLL_PUBLIC DrawableNode : public SceneNode
 	virtual void updateRenderCommand() = 0;
 
   private:
+	/// The spatial grid indexing this node, if any
+	SpatialGrid *spatialGrid_;
+	/// The index of the grid cell storing this node
+	unsigned int spatialGridCell_;
+	/// The index of this node among the ones stored in the same grid cell
+	unsigned int spatialGridSlot_;
+
 	/// Deleted assignment operator
 	DrawableNode &operator=(const DrawableNode &) = delete;
 
 	friend class ShaderState;
 	friend class Viewport;
+	friend class SpatialGrid;
 };
 
 }
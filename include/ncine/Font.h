@@ -8,6 +8,7 @@
 namespace ncine {
 
 class FntParser;
+class FontAtlas;
 class FontGlyph;
 class Texture;
 
@@ -24,7 +25,32 @@ class DLL_PUBLIC Font : public Object
 		/// Glyph data is in the red channel
 		GLYPH_IN_RED,
 		/// Glyph data is in all four channels (glyphs are colored)
-		GLYPH_SPRITE
+		GLYPH_SPRITE,
+		/// Glyph data is a signed distance field in the red channel, text stays sharp when scaled
+		GLYPH_DISTANCE_FIELD
+	};
+
+	/// The settings used to generate a distance field atlas at runtime
+	struct DistanceFieldSettings
+	{
+		DistanceFieldSettings()
+		    : glyphSize(48), spread(6), firstCodepoint(32), lastCodepoint(126), withCache(true), cacheDirectory(nullptr) {}
+
+		/// The height in pixels of the glyphs rasterized from a vector font
+		/*! \note A single size is enough for every text node, as the distance field can be scaled */
+		unsigned int glyphSize;
+		/// The distance in pixels covered by the field on both sides of the glyph edges
+		unsigned int spread;
+		/// The first codepoint rasterized from a vector font
+		unsigned int firstCodepoint;
+		/// The last codepoint rasterized from a vector font
+		/*! \note It is clamped to the Basic Multilingual Plane. Kerning pairs are read from the TrueType `kern` table,
+		 *  a font without one has kerning only if no more than 256 glyphs are rasterized. */
+		unsigned int lastCodepoint;
+		/// True if the generated atlas is saved to the cache directory and loaded from it the next time
+		bool withCache;
+		/// The directory of the cached atlases, a subdirectory of the save path if `nullptr`
+		const char *cacheDirectory;
 	};
 
 	/// Constructs an empty font object with no glyphs nor kerning pairs
@@ -60,6 +86,13 @@ class DLL_PUBLIC Font : public Object
 	bool loadFromFile(const char *fntFilename, const char *texFilename);
 	bool loadFromFile(const char *fntFilename, Texture *texture);
 
+	/// Generates a distance field atlas from an AngelCode's `FNT` file and the bitmap texture it specifies
+	/*! \note The glyphs are not rasterized again, the bitmap size should be big enough for the biggest text */
+	bool loadDistanceFieldFromFile(const char *fntFilename, const DistanceFieldSettings &settings);
+	/// Generates a distance field atlas rasterizing the glyphs of a vector font file, like a TrueType or an OpenType one
+	/*! \note It needs the engine to be compiled with FreeType support */
+	bool loadDistanceFieldFromVectorFile(const char *fontFilename, const DistanceFieldSettings &settings);
+
 	/// Returns the constant texture object in use by the font
 	inline const Texture *texture() const { return (texture_ != nullptr) ? texture_.get() : texturePtr_; }
 	/// Returns the texture object in use by the font
@@ -79,6 +112,8 @@ class DLL_PUBLIC Font : public Object
 	inline unsigned int numKernings() const { return numKernings_; }
 	/// Returns a constant pointer to a glyph
 	const FontGlyph *glyph(unsigned int glyphId) const;
+	/// Returns the kerning amount between two glyphs, or zero if the pair has none
+	int kerning(unsigned int firstGlyphId, unsigned int secondGlyphId) const;
 
 	/// Returns the mode detected by the font to render text nodes
 	inline RenderMode renderMode() const { return renderMode_; }
@@ -111,6 +146,10 @@ class DLL_PUBLIC Font : public Object
 	static const unsigned int GlyphHashmapSize = 1024;
 	/// Hashmap of font glyphs encoded in more than one UTF-8 code unit
 	nctl::HashMap<unsigned short int, FontGlyph> glyphHashMap_;
+	/// Minimum number of buckets in the kerning pairs hashmap
+	static const unsigned int KerningHashmapSize = 64;
+	/// Hashmap of kerning amounts, the key packs the first glyph id in the high half and the second one in the low half
+	nctl::HashMap<unsigned int, int> kerningHashMap_;
 
 	RenderMode renderMode_;
 
@@ -129,6 +168,8 @@ class DLL_PUBLIC Font : public Object
 	void determineRenderMode(const FntParser &fntParser);
 	/// Retrieves font information from the FNT parser
 	void retrieveInfoFromFnt(const FntParser &fntParser);
+	/// Retrieves font information from a distance field atlas and creates its texture
+	void retrieveInfoFromAtlas(const FontAtlas &atlas);
 };
 
 }
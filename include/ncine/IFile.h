@@ -18,7 +18,9 @@ class DLL_PUBLIC IFile
 		BASE = 0,
 		MEMORY,
 		STANDARD,
-		ASSET
+		ASSET,
+		MAPPED,
+		ARCHIVE
 	};
 
 	/// Open mode bitmask
@@ -63,6 +65,9 @@ class DLL_PUBLIC IFile
 	inline void setCloseOnDestruction(bool shouldCloseOnDestruction) { shouldCloseOnDestruction_ = shouldCloseOnDestruction; }
 	/// Returns true if the file has been sucessfully opened
 	virtual bool isOpened() const;
+	/// Returns a read-only view of the whole file content if it is available without copies, `nullptr` otherwise
+	/*! \note The pointer is valid only until the file is closed and it does not depend on the seek position */
+	virtual const unsigned char *data() const { return nullptr; }
 
 	/// Returns file name with path
 	const char *filename() const { return filename_.data(); }
@@ -107,8 +112,12 @@ class DLL_PUBLIC IFile
 	/// Returns a read-only memory file
 	static nctl::UniquePtr<IFile> createFromMemory(const unsigned char *bufferPtr, unsigned long int bufferSize);
 
-	/// Returns the proper file handle according to prepended tags
+	/// Returns the proper file handle according to prepended tags or to mounted asset archives
+	/*! \note Files resolved by an asset archive can only be opened for reading */
 	static nctl::UniquePtr<IFile> createFileHandle(const char *filename);
+	/// Returns a handle that memory-maps a standard file when opened, or the proper one according to prepended tags
+	/*! \note Only read modes are supported by memory-mapped files */
+	static nctl::UniquePtr<IFile> createMappedFileHandle(const char *filename);
 
   protected:
 	/// File type
@@ -40,6 +40,7 @@ class DLL_PUBLIC IGfxCapabilities
 			UNIFORM_BUFFER_OFFSET_ALIGNMENT,
 			MAX_VERTEX_ATTRIB_STRIDE,
 			MAX_COLOR_ATTACHMENTS,
+			MAX_TEXTURE_BUFFER_SIZE,
 
 			COUNT
 		};
@@ -57,6 +58,7 @@ class DLL_PUBLIC IGfxCapabilities
 			AMD_COMPRESSED_ATC_TEXTURE,
 			IMG_TEXTURE_COMPRESSION_PVRTC,
 			KHR_TEXTURE_COMPRESSION_ASTC_LDR,
+			ARB_BUFFER_STORAGE,
 
 			COUNT
 		};
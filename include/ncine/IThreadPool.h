@@ -7,23 +7,90 @@
 
 namespace ncine {
 
+struct Job;
+class JobSystem;
+
+/// The handle of a job, used to run it, wait for it or attach other jobs to it
+/*! \note The storage of a job is recycled after many other jobs have been created by the same thread, or by any thread that does not belong to the pool */
+using JobId = Job *;
+
 /// Thread pool interface class
+/*! Besides the legacy command queue, a thread pool is also a job system with work stealing.
+ *  Jobs can be created, run and waited for by the main thread or by other jobs.
+ *  Any other thread can use the pool as well, but its jobs always go through the background queue
+ *  and it does not help executing jobs while waiting. */
 class DLL_PUBLIC IThreadPool
 {
   public:
+	/// The function executed by a job, the data pointer points to the copy stored in the job
+	using JobFunction = void (*)(JobId job, const void *data);
+	/// The function executed on a range of indices by `parallelFor()`
+	using ParallelForFunction = void (*)(unsigned int first, unsigned int count, const void *data);
+
+	/// The maximum number of bytes of user data that can be copied inside a job
+	static const unsigned int MaxJobDataSize = 64;
+	/// The maximum number of continuations that can be added to a job
+	static const unsigned int MaxContinuations = 4;
+
 	virtual ~IThreadPool() = 0;
 
 	/// Enqueues a command request for a worker thread
+	/*! \note It can be called from any thread, commands are executed like background jobs and never on the calling thread */
 	virtual void enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand) = 0;
+	/// Returns the number of worker threads
+	virtual unsigned int numThreads() const = 0;
+
+	/// Creates a new job that copies the specified data, it will not be executed until it is run
+	virtual JobId createJob(JobFunction jobFunction, const void *data, unsigned int dataSize) = 0;
+	/// Creates a new job as a child of another one, the parent will not finish until all of its children have
+	virtual JobId createJobAsChild(JobId parent, JobFunction jobFunction, const void *data, unsigned int dataSize) = 0;
+	/// Adds a job that will be run as soon as the ancestor one has finished
+	/*! \note Continuations should be added before running the ancestor job */
+	virtual bool addContinuation(JobId ancestor, JobId continuation) = 0;
+	/// Queues a job for execution
+	/*! \note The job is executed right away by the calling thread if its queue is full */
+	virtual void run(JobId job) = 0;
+	/// Queues a job that is only executed by worker threads, never by a thread helping while waiting for other jobs
+	/*! \note It is meant for long jobs, like file decoding, that should not stall the main thread inside a frame */
+	virtual void runInBackground(JobId job) = 0;
+	/// Executes other jobs while waiting for the specified one to finish
+	virtual void wait(JobId job) = 0;
+	/// Returns true if the job and all of its children have finished
+	virtual bool isFinished(JobId job) const = 0;
+
+	/// Splits a range of indices in batches of at most the specified size, executing them in parallel and waiting for all of them
+	virtual void parallelFor(unsigned int count, unsigned int batchSize, ParallelForFunction function, const void *data) = 0;
 };
 
 inline IThreadPool::~IThreadPool() {}
 
 /// A fake thread pool which doesn't create any thread
+/*! Commands are discarded while jobs are executed serially on the calling thread. */
 class DLL_PUBLIC NullThreadPool : public IThreadPool
 {
   public:
+	NullThreadPool();
+	~NullThreadPool() override;
+
 	void enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand) override {}
+	unsigned int numThreads() const override { return 0; }
+
+	JobId createJob(JobFunction jobFunction, const void *data, unsigned int dataSize) override;
+	JobId createJobAsChild(JobId parent, JobFunction jobFunction, const void *data, unsigned int dataSize) override;
+	bool addContinuation(JobId ancestor, JobId continuation) override;
+	void run(JobId job) override;
+	/// Background jobs are executed right away like any other job, as there are no worker threads
+	void runInBackground(JobId job) override;
+	void wait(JobId job) override;
+	bool isFinished(JobId job) const override;
+
+	void parallelFor(unsigned int count, unsigned int batchSize, ParallelForFunction function, const void *data) override;
+
+  private:
+	/// The job system is only created the first time a job is needed
+	nctl::UniquePtr<JobSystem> jobSystem_;
+
+	JobSystem &jobSystem();
 };
 
 }
@@ -6,6 +6,7 @@
 namespace ncine {
 
 class Qt5Widget;
+class HeadlessReport;
 
 /// Handler class for nCine applications on PC
 class DLL_PUBLIC PCApplication : public Application
@@ -21,6 +22,9 @@ class DLL_PUBLIC PCApplication : public Application
 	/// A pointer to the custom Qt5 widget
 	Qt5Widget *qt5Widget_;
 
+	/// The report of the frames rendered by the null graphics device
+	nctl::UniquePtr<HeadlessReport> headlessReport_;
+
 	/// Must be called at the beginning to initialize the application
 	void init(nctl::UniquePtr<IAppEventHandler> (*createAppEventHandler)(), int argc, char **argv);
 	/// Must be called continuously to keep the application running
@@ -32,10 +36,9 @@ class DLL_PUBLIC PCApplication : public Application
 #endif
 
 	/// Private constructor
-	PCApplication()
-	    : Application(), wasSuspended_(false), qt5Widget_(nullptr) {}
+	PCApplication();
 	/// Private destructor
-	~PCApplication() = default;
+	~PCApplication();
 	/// Deleted copy constructor
 	PCApplication(const PCApplication &) = delete;
 	/// Deleted assignment operator
@@ -8,6 +8,7 @@
 namespace ncine {
 
 class Particle;
+class ParticleData;
 
 const unsigned int StepsInitialSize = 4;
 
@@ -33,6 +34,11 @@ class DLL_PUBLIC ParticleAffector
 	void affect(Particle *particle);
 	/// Affects a property of the specified particle, without calculating the normalized age
 	virtual void affect(Particle *particle, float normalizedAge) = 0;
+	/// Affects a property of a contiguous range of particles in a structure of arrays storage
+	/*! \note The normalized age of the particles should have already been calculated
+	 *  \note The default implementation copies every particle in a temporary one and calls `affect()`,
+	 *  derived affectors can override it to work on the arrays directly */
+	virtual void affectRange(ParticleData &data, unsigned int first, unsigned int count);
 
 	/// Returns the object type (RTTI)
 	inline Type type() const { return type_; }
@@ -87,6 +93,8 @@ class DLL_PUBLIC ColorAffector : public ParticleAffector
 
 	/// Affects the color of the specified particle
 	void affect(Particle *particle, float normalizedAge) override;
+	/// Affects the color of a contiguous range of particles in a structure of arrays storage
+	void affectRange(ParticleData &data, unsigned int first, unsigned int count) override;
 	void addColorStep(float age, const Colorf &color);
 	inline void addColorStep(const ColorStep &step) { addColorStep(step.age, step.color); }
 
@@ -147,6 +155,8 @@ class DLL_PUBLIC SizeAffector : public ParticleAffector
 
 	/// Affects the size of the specified particle
 	void affect(Particle *particle, float normalizedAge) override;
+	/// Affects the size of a contiguous range of particles in a structure of arrays storage
+	void affectRange(ParticleData &data, unsigned int first, unsigned int count) override;
 	inline void addSizeStep(float age, float scale) { addSizeStep(age, scale, scale); }
 	void addSizeStep(float age, float scaleX, float scaleY);
 	inline void addSizeStep(float age, const Vector2f &scale) { addSizeStep(age, scale.x, scale.y); }
@@ -205,6 +215,8 @@ class DLL_PUBLIC RotationAffector : public ParticleAffector
 
 	/// Affects the rotation of the specified particle
 	void affect(Particle *particle, float normalizedAge) override;
+	/// Affects the rotation of a contiguous range of particles in a structure of arrays storage
+	void affectRange(ParticleData &data, unsigned int first, unsigned int count) override;
 	void addRotationStep(float age, float angle);
 	inline void addRotationStep(const RotationStep &step) { addRotationStep(step.age, step.angle); }
 
@@ -251,6 +263,8 @@ class DLL_PUBLIC PositionAffector : public ParticleAffector
 
 	/// Affects the position of the specified particle
 	void affect(Particle *particle, float normalizedAge) override;
+	/// Affects the position of a contiguous range of particles in a structure of arrays storage
+	void affectRange(ParticleData &data, unsigned int first, unsigned int count) override;
 	void addPositionStep(float age, float posX, float posY);
 	inline void addPositionStep(float age, const Vector2f &position) { addPositionStep(age, position.x, position.y); }
 	inline void addPositionStep(const PositionStep &step) { addPositionStep(step.age, step.position); }
@@ -298,6 +312,8 @@ class DLL_PUBLIC VelocityAffector : public ParticleAffector
 
 	/// Affects the velocity of the specified particle
 	void affect(Particle *particle, float normalizedAge) override;
+	/// Affects the velocity of a contiguous range of particles in a structure of arrays storage
+	void affectRange(ParticleData &data, unsigned int first, unsigned int count) override;
 	void addVelocityStep(float age, float velX, float velY);
 	inline void addVelocityStep(float age, const Vector2f &velocity) { addVelocityStep(age, velocity.x, velocity.y); }
 	inline void addVelocityStep(const VelocityStep &step) { addVelocityStep(step.age, step.velocity); }
@@ -12,16 +12,32 @@ namespace ncine {
 
 class Texture;
 class Particle;
+class ParticleData;
+class RenderCommand;
 struct ParticleInitializer;
 
 /// The class representing a particle system
 class DLL_PUBLIC ParticleSystem : public SceneNode
 {
   public:
+	/// The way particles are stored and rendered
+	enum class Mode
+	{
+		/// Every particle is a sprite child node with its own render command
+		NODES,
+		/// Particle properties are stored in contiguous arrays and rendered with a single command
+		ARRAYS
+	};
+
 	/// Constructs a particle system with the specified maximum amount of particles
 	ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture);
 	/// Constructs a particle system with the specified maximum amount of particles and the specified texture rectangle
 	ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Recti texRect);
+	/// Constructs a particle system with the specified maximum amount of particles and storage mode
+	ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Mode mode);
+	/// Constructs a particle system with the specified maximum amount of particles, texture rectangle and storage mode
+	ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Recti texRect, Mode mode);
+	~ParticleSystem() override;
 
 	/// Default move constructor
 	ParticleSystem(ParticleSystem &&);
@@ -31,6 +47,9 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 	/// Returns a copy of this object
 	inline ParticleSystem clone() const { return ParticleSystem(*this); }
 
+	/// Returns the storage mode of the system
+	inline Mode mode() const { return mode_; }
+
 	/// Adds a particle affector
 	inline void addAffector(nctl::UniquePtr<ParticleAffector> affector) { affectors_.pushBack(nctl::move(affector)); }
 	/// Deletes all particle affectors
@@ -61,9 +80,9 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 	inline void setAffectorsEnabled(bool affectorsEnabled) { affectorsEnabled_ = affectorsEnabled; }
 
 	/// Returns the total number of particles in the system
-	inline unsigned int numParticles() const { return particleArray_.size(); }
+	inline unsigned int numParticles() const { return poolSize_; }
 	/// Returns the number of particles currently alive
-	inline unsigned int numAliveParticles() const { return particleArray_.size() - poolTop_ - 1; }
+	inline unsigned int numAliveParticles() const { return poolSize_ - poolTop_ - 1; }
 
 	/// Sets the texture object for every particle
 	void setTexture(Texture *texture);
@@ -89,6 +108,7 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 	void setLayer(uint16_t layer);
 
 	void update(float interval) override;
+	bool draw(RenderQueue &renderQueue) override;
 
 	inline static ObjectType sType() { return ObjectType::PARTICLE_SYSTEM; }
 
@@ -97,6 +117,8 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 	ParticleSystem(const ParticleSystem &other);
 
   private:
+	/// The storage mode of the system
+	Mode mode_;
 	/// The particle pool size
 	unsigned int poolSize_;
 	/// The index of the next free particle in the pool
@@ -104,11 +126,19 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 	/// The pool containing available particles (only dead ones)
 	nctl::Array<Particle *> particlePool_;
 	/// The array containing every particle (dead or alive)
+	/*! In `ARRAYS` mode it only contains a template particle holding the properties shared by every particle */
 	nctl::Array<nctl::UniquePtr<Particle>> particleArray_;
 
 	/// The array of particle affectors
 	nctl::Array<nctl::UniquePtr<ParticleAffector>> affectors_;
 
+	/// The structure of arrays with all particles properties (`ARRAYS` mode only)
+	nctl::UniquePtr<ParticleData> particleData_;
+	/// The render command used to draw all particles at once (`ARRAYS` mode only)
+	nctl::UniquePtr<RenderCommand> renderCommand_;
+	/// The vertices of all alive particles (`ARRAYS` mode only)
+	nctl::Array<float> vertices_;
+
 	/// A flag indicating whether the system should be simulated in local space
 	bool inLocalSpace_;
 
@@ -117,6 +147,15 @@ class DLL_PUBLIC ParticleSystem : public SceneNode
 
 	/// Deleted assignment operator
 	ParticleSystem &operator=(const ParticleSystem &) = delete;
+
+	/// Updates all particles stored as child nodes
+	void updateNodes(float interval);
+	/// Initializes the render command and the vertices array for the `ARRAYS` mode
+	void initArrays();
+	/// Updates all particles stored in the structure of arrays
+	void updateArrays(float interval);
+	/// Fills the vertices array with the quads of all alive particles
+	void fillVertices();
 };
 
 }
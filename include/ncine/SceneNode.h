@@ -87,6 +87,10 @@ class DLL_PUBLIC SceneNode : public Object
 	inline uint16_t visitOrderIndex() const { return visitOrderIndex_; }
 
 	/// Called once every frame to update the node
+	/*! \warning When the parallel update is enabled in the application configuration, this method can be called
+	 *  on a worker thread, concurrently with the update of nodes belonging to other subtrees. An overriding method should
+	 *  only modify the node and its descendants, and it should not use shared state without synchronization,
+	 *  like the global random generator, other scene nodes or a non thread-safe allocator. */
 	virtual void update(float interval);
 	/// Draws the node and visits its children
 	virtual void visit(RenderQueue &renderQueue, unsigned int &visitOrderIndex);
@@ -100,12 +104,19 @@ class DLL_PUBLIC SceneNode : public Object
 	/// Returns true if the node is drawing
 	inline bool isDrawEnabled() const { return drawEnabled_; }
 	/// Enables or disables node drawing
-	inline void setDrawEnabled(bool drawEnabled) { drawEnabled_ = drawEnabled; }
+	void setDrawEnabled(bool drawEnabled);
 	/// Returns true if the node is both updating and drawing
 	inline bool isEnabled() const { return (updateEnabled_ == true && drawEnabled_ == true); }
 	/// Enables or disables both node updating and drawing
 	void setEnabled(bool isEnabled);
 
+	/// Returns true if the node and its children are static
+	inline bool isStatic() const { return isStatic_; }
+	/// Sets the node and its children as static, skipping their update and culling work when nothing changes
+	/*! \note Only changes to the transformation or the color of a static node or of its ancestors are detected,
+	 *  changes to its children are applied after calling this method again. */
+	void setStatic(bool isStatic);
+
 	/// Returns node position relative to its parent
 	inline Vector2f position() const { return position_; }
 	/// Returns absolute node position
@@ -216,6 +227,21 @@ class DLL_PUBLIC SceneNode : public Object
 	bool updateEnabled_;
 	bool drawEnabled_;
 
+	/// A flag indicating whether the node and its children are static
+	bool isStatic_;
+	/// Set when a static subtree has been updated once and can be skipped until something changes
+	bool staticUpdated_;
+	/// Set when the last update of a static subtree has been skipped
+	bool staticUpdateSkipped_;
+	/// The identifier of the spatial grid that indexes every drawable node of a static subtree, zero if none
+	/*! \note An identifier is never reused, unlike the address of a destroyed grid */
+	unsigned int staticSpatialGridId_;
+	/// The position of the node in the depth-first order of the last culling update of a viewport with a spatial grid
+	/*! \note It is used to visit the nodes collected from the grid in the same order as the scenegraph */
+	unsigned int spatialGridOrder_;
+	/// The order following the last node of a static subtree, used to skip the subtree while its first order does not change
+	unsigned int staticSpatialGridEndOrder_;
+
 	/// A pointer to the parent node
 	SceneNode *parent_;
 	/// The array of child nodes
@@ -289,6 +315,16 @@ class DLL_PUBLIC SceneNode : public Object
 	void swapChildPointer(SceneNode *first, SceneNode *second);
 
 	virtual void transform();
+
+	/// Returns true if the update of a static subtree can be skipped
+	bool canSkipStaticUpdate() const;
+
+	/// Draws the node without visiting its children, incrementing the visit order index if it has been rendered
+	void visitNode(RenderQueue &renderQueue, unsigned int &visitOrderIndex);
+
+	friend class SceneUpdater;
+	friend class Viewport;
+	friend class SpatialGrid;
 };
 
 inline const nctl::Array<const SceneNode *> &SceneNode::children() const
@@ -299,7 +335,7 @@ inline const nctl::Array<const SceneNode *> &SceneNode::children() const
 inline void SceneNode::setEnabled(bool enabled)
 {
 	updateEnabled_ = enabled;
-	drawEnabled_ = enabled;
+	setDrawEnabled(enabled);
 }
 
 inline void SceneNode::setPosition(float x, float y)
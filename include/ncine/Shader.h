@@ -49,7 +49,8 @@ class DLL_PUBLIC Shader : public Object
 		SPRITE_NOTEXTURE,
 		TEXTNODE_ALPHA,
 		TEXTNODE_RED,
-		TEXTNODE_SPRITE
+		TEXTNODE_SPRITE,
+		TEXTNODE_DISTANCE_FIELD
 	};
 
 	/// Creates an OpenGL shader program name
@@ -112,15 +112,22 @@ class DLL_PUBLIC TextNode : public DrawableNode
 		    : x(xx), y(yy), u(uu), v(vv) {}
 	};
 
-	/// Position of degenerate vertices in glyph quad
-	enum class Degenerate
+	/// A glyph of the string placed in the text layout
+	struct ShapedGlyph
 	{
-		NONE,
-		START,
-		START_END,
-		END
+		/// The font glyph to render
+		const FontGlyph *glyph;
+		/// Index of the first code unit of the glyph in the string
+		unsigned int byteIndex;
+		/// Index of the line of text containing the glyph
+		unsigned int line;
+		/// Advance on the X-axis from the start of the line, kerning included
+		float xAdvance;
 	};
 
+	/// Marks the end of the dirty range of bytes when the string length has changed
+	static const unsigned int EndOfString = ~0u;
+
 	/// The string to be rendered
 	nctl::String string_;
 	/// Dirty flag for vertices and texture coordinates
@@ -134,12 +141,20 @@ class DLL_PUBLIC TextNode : public DrawableNode
 	/// The array of vertex positions interleaved with texture coordinates for every glyph in the node
 	nctl::Array<Vertex> interleavedVertices_;
 
-	/// Advance on the X-axis for the next processed glyph
-	mutable float xAdvance_;
-	/// Advance on the Y-axis for the next processed glyph
-	mutable float yAdvance_;
+	/// The glyphs of the string laid out by the last boundaries calculation
+	mutable nctl::Array<ShapedGlyph> shapedGlyphs_;
+	/// First byte of the string that has changed since the last layout
+	mutable unsigned int dirtyByteStart_;
+	/// One past the last byte of the string that has changed since the last layout, or `EndOfString`
+	mutable unsigned int dirtyByteEnd_;
+	/// First laid out glyph with vertices to update
+	mutable unsigned int dirtyGlyphStart_;
+	/// One past the last laid out glyph with vertices to update
+	mutable unsigned int dirtyGlyphEnd_;
 	/// Text width for each line of text
 	mutable nctl::Array<float> lineLengths_;
+	/// Position offset of each line of text, as used by the vertices in the array
+	nctl::Array<Vector2f> lineOffsets_;
 	/// Horizontal text alignment of multiple lines
 	Alignment alignment_;
 	/// The line height for the text node
@@ -153,12 +168,21 @@ class DLL_PUBLIC TextNode : public DrawableNode
 	/// Initializer method for constructors and the copy constructor
 	void init();
 
+	/// Marks the whole string as changed, to be laid out again from the start
+	void invalidateLayout();
+	/// Marks the range of bytes that differs between the current string and a new one
+	void invalidateLayout(const char *string, unsigned int length);
+
 	/// Calculates rectangle boundaries for the rendered text
 	void calculateBoundaries() const;
+	/// Lays out the glyphs of the changed part of the string and updates line lengths
+	void shapeString() const;
 	/// Calculates align offset for a particular line
 	float calculateAlignment(unsigned int lineIndex) const;
-	/// Fills the batch draw command with data from a glyph
-	void processGlyph(const FontGlyph *glyph, Degenerate degen);
+	/// Updates the vertices of the glyphs that have been laid out again or whose line has moved
+	void updateVertices();
+	/// Fills the batch draw command with data from a laid out glyph
+	void processGlyph(unsigned int glyphIndex);
 
 	void shaderHasChanged() override;
 
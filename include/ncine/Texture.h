@@ -44,6 +44,9 @@ class DLL_PUBLIC Texture : public Object
 		REPEAT
 	};
 
+	/// The function called on the main thread when an asynchronous loading has finished
+	using LoadedCallback = void (*)(Texture &texture, bool hasLoaded, void *userData);
+
 	/// Creates an OpenGL texture name
 	Texture();
 
@@ -63,10 +66,10 @@ class DLL_PUBLIC Texture : public Object
 
 	~Texture() override;
 
-	/// Default move constructor
-	Texture(Texture &&);
-	/// Default move assignment operator
-	Texture &operator=(Texture &&);
+	/// Move constructor
+	Texture(Texture &&other);
+	/// Move assignment operator
+	Texture &operator=(Texture &&other);
 
 	/// Initializes an empty texture with the specified format, MIP levels, and size
 	void init(const char *name, Format format, int mipMapCount, int width, int height);
@@ -79,6 +82,12 @@ class DLL_PUBLIC Texture : public Object
 
 	bool loadFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
 	bool loadFromFile(const char *filename);
+	/// Reads and decodes an image file on a worker thread, the texture is uploaded later on the main thread
+	bool loadFromFileAsync(const char *filename);
+	/// Reads and decodes an image file on a worker thread, then uploads it and invokes the callback on the main thread
+	bool loadFromFileAsync(const char *filename, LoadedCallback callback, void *userData);
+	/// Returns true if an asynchronous loading has been requested and has not finished yet
+	inline bool isLoading() const { return isLoading_; }
 
 	/// Loads all texture texels in raw format from a memory buffer in the first mip level
 	bool loadFromTexels(const unsigned char *bufferPtr);
@@ -164,6 +173,7 @@ class DLL_PUBLIC Texture : public Object
 
 	bool isChromaKeyEnabled_;
 	Color chromaKeyColor_;
+	bool isLoading_;
 
 	/// Deleted copy constructor
 	Texture(const Texture &) = delete;
@@ -173,8 +183,12 @@ class DLL_PUBLIC Texture : public Object
 	/// Initialize an empty texture by creating storage for it
 	void initialize(const ITextureLoader &texLoader);
 	/// Loads the data in a previously initialized texture
-	void load(const ITextureLoader &texLoader);
+	/*! \return False if the pixels of a level cannot be read */
+	bool load(const ITextureLoader &texLoader);
+	/// Creates storage and loads the data of a texture loader that has already decoded a file
+	bool loadFromLoader(const char *name, const ITextureLoader &texLoader);
 
+	friend class AsyncTextureLoader;
 	friend class Material;
 	friend class Viewport;
 };
@@ -16,6 +16,7 @@ class Camera;
 class RenderQueue;
 class GLFramebufferObject;
 class Texture;
+class SpatialGrid;
 
 /// The class handling a viewport and its corresponding render target texture
 class DLL_PUBLIC Viewport
@@ -123,6 +124,13 @@ class DLL_PUBLIC Viewport
 
 	/// Returns the rectangle for screen culling
 	inline Rectf cullingRect() const { return cullingRect_; }
+	/// Returns the cell size of the spatial grid used for culling, or zero if the grid is not used
+	float cullingGridCellSize() const;
+	/// Sets the cell size of a spatial grid used for culling, zero tests every node against the culling rectangle
+	/*! \note A node can only be stored in one grid, other viewports with the same root node test it directly
+	 *  \note With a grid only the drawable nodes overlapping the culling rectangle and the particle systems are visited,
+	 *  the `SceneNode::visit()` method is not called and overriding it has no effect */
+	void setCullingGridCellSize(float cellSize);
 
 	/// Returns the last frame this viewport was cleared
 	inline unsigned long int lastFrameCleared() const { return lastFrameCleared_; }
@@ -144,7 +152,7 @@ class DLL_PUBLIC Viewport
 	/// Returns the root node
 	inline SceneNode *rootNode() { return rootNode_; }
 	/// Sets the root node
-	inline void setRootNode(SceneNode *rootNode) { rootNode_ = rootNode; }
+	void setRootNode(SceneNode *rootNode);
 
 	/// Returns the reverse ordered array of viewports to be drawn before the screen
 	static nctl::Array<Viewport *> &chain() { return chain_; }
@@ -188,6 +196,12 @@ class DLL_PUBLIC Viewport
 
 	/// The render queue of commands for this viewport/RT
 	nctl::UniquePtr<RenderQueue> renderQueue_;
+	/// The optional spatial grid used as a culling broad-phase
+	nctl::UniquePtr<SpatialGrid> spatialGrid_;
+	/// The nodes collected from the spatial grid and the ones that are not stored in it, in scenegraph order
+	nctl::Array<SceneNode *> gridVisitNodes_;
+	/// True if the last update collected the nodes to visit with the spatial grid
+	bool visitFromGrid_;
 
 	nctl::UniquePtr<GLFramebufferObject> fbo_;
 
@@ -219,7 +233,9 @@ class DLL_PUBLIC Viewport
   private:
 	unsigned int numColorAttachments_;
 
-	void updateCulling(SceneNode *node);
+	/// Updates the culling state of a subtree, returning true if all of its drawable nodes are stored in the spatial grid
+	/*! \note Nodes are numbered in depth-first order, the ones to visit that are not in the grid are collected */
+	bool updateCulling(SceneNode *node, unsigned int &order);
 
 	friend class Application;
 	friend class ScreenViewport;
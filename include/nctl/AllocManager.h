@@ -6,6 +6,7 @@
 namespace nctl {
 
 class IAllocator;
+class FrameAllocator;
 
 /// Allocator manager initializer
 class DLL_PUBLIC AllocManagerInitializer
@@ -19,10 +20,14 @@ class DLL_PUBLIC AllocManagerInitializer
 class DLL_PUBLIC AllocManager
 {
   public:
-	inline IAllocator &defaultAllocator() { return *defaultAllocator_; }
+	/// Returns the default allocator of the calling thread if it has one, otherwise the global one
+	IAllocator &defaultAllocator();
 	inline IAllocator &stringAllocator() { return *stringAllocator_; }
 
 	IAllocator *setDefaultAllocator(IAllocator *allocator);
+	/// Sets a default allocator only for the calling thread, `nullptr` to go back to the global one
+	/*! \note Memory should be deallocated by the same allocator, the override should be removed only after that */
+	IAllocator *setThreadDefaultAllocator(IAllocator *allocator);
 	IAllocator *setStringAllocator(IAllocator *allocator);
 
   private:
@@ -40,6 +45,8 @@ extern DLL_PUBLIC AllocManager &theAllocManager();
 
 extern DLL_PUBLIC IAllocator &theDefaultAllocator();
 extern DLL_PUBLIC IAllocator &theStringAllocator();
+/// Returns the allocator for transient data that only needs to live until the end of the next frame
+extern DLL_PUBLIC FrameAllocator &theFrameAllocator();
 extern DLL_PUBLIC IAllocator &theImGuiAllocator();
 extern DLL_PUBLIC IAllocator &theNuklearAllocator();
 extern DLL_PUBLIC IAllocator &theLuaAllocator();
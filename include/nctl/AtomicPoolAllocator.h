@@ -0,0 +1,58 @@
+#ifndef CLASS_NCTL_ATOMICPOOLALLOCATOR
+#define CLASS_NCTL_ATOMICPOOLALLOCATOR
+
+#include <nctl/IAllocator.h>
+#include <nctl/Atomic.h>
+
+namespace nctl {
+
+/// A lock-free pool allocator that can be used by multiple threads at the same time
+/*! The free list is a stack of element indices with a tag incremented by every operation, to prevent the ABA problem.
+ *  \note The `usedMemory()` and `numAllocations()` statistics are not updated, use `numAllocatedElements()` instead */
+class DLL_PUBLIC AtomicPoolAllocator : public IAllocator
+{
+  public:
+	AtomicPoolAllocator()
+	    : AtomicPoolAllocator("AtomicPool") {}
+	explicit AtomicPoolAllocator(const char *name);
+	AtomicPoolAllocator(size_t elementSize, size_t size, void *base)
+	    : AtomicPoolAllocator("AtomicPool", elementSize, DefaultAlignment, size, base) {}
+	AtomicPoolAllocator(const char *name, size_t elementSize, size_t size, void *base)
+	    : AtomicPoolAllocator(name, elementSize, DefaultAlignment, size, base) {}
+	AtomicPoolAllocator(size_t elementSize, uint8_t elementAlignment, size_t size, void *base)
+	    : AtomicPoolAllocator("AtomicPool", elementSize, elementAlignment, size, base) {}
+	AtomicPoolAllocator(const char *name, size_t elementSize, uint8_t elementAlignment, size_t size, void *base);
+	~AtomicPoolAllocator();
+
+	/// Initializes the pool, it should not be called while other threads are using the allocator
+	inline void init(size_t elementSize, size_t size, void *base) { init(elementSize, DefaultAlignment, size, base); }
+	void init(size_t elementSize, uint8_t elementAlignment, size_t size, void *base);
+	inline size_t elementSize() const { return elementSize_; }
+	inline uint8_t elementAlignment() const { return elementAlignment_; }
+	inline uint32_t numElements() const { return numElements_; }
+	/// Returns the number of elements currently allocated
+	inline int32_t numAllocatedElements() { return numAllocatedElements_.load(Atomic32::MemoryModel::RELAXED); }
+
+  private:
+	size_t elementSize_;
+	uint8_t elementAlignment_;
+	/// The address of the first element in the buffer
+	void *elements_;
+	uint32_t numElements_;
+	/// The free list head, a tag in the high 32 bits and the index of the first free element plus one in the low ones
+	Atomic64 freeListHead_;
+	Atomic32 numAllocatedElements_;
+
+	AtomicPoolAllocator(const AtomicPoolAllocator &) = delete;
+	AtomicPoolAllocator &operator=(const AtomicPoolAllocator &) = delete;
+
+	void internalInit();
+
+	static void *allocateImpl(IAllocator *allocator, size_t size, uint8_t alignment);
+	static void *reallocateImpl(IAllocator *allocator, void *ptr, size_t size, uint8_t alignment, size_t &oldSize);
+	static void deallocateImpl(IAllocator *allocator, void *ptr);
+};
+
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CLASS_NCTL_FRAMEALLOCATOR
+#define CLASS_NCTL_FRAMEALLOCATOR
+
+#include <nctl/IAllocator.h>
+#include <nctl/LinearAllocator.h>
+
+namespace nctl {
+
+/// A double-buffered linear allocator for the transient data of a frame
+/*! The buffer is split into two linear arenas, one for the current frame and one for the previous one.
+ *  Every allocation stays valid until the end of the next frame, when its arena is cleared to be reused.
+ *  Allocations that do not fit in the arena are served by the fallback allocator and released at the same time.
+ *  \note Deallocations do nothing, the memory is only reclaimed by `nextFrame()`
+ *  \note It is not thread-safe, it should only be used by the thread that calls `nextFrame()` */
+class DLL_PUBLIC FrameAllocator : public IAllocator
+{
+  public:
+	FrameAllocator(size_t size, void *base, IAllocator &fallbackAllocator)
+	    : FrameAllocator("Frame", size, base, fallbackAllocator) {}
+	FrameAllocator(const char *name, size_t size, void *base, IAllocator &fallbackAllocator);
+	~FrameAllocator();
+
+	/// Starts a new frame, discarding the allocations performed two frames ago
+	void nextFrame();
+
+	/// Returns the size in bytes of the arena of a single frame
+	inline size_t frameCapacity() const { return arenas_[0].size(); }
+	/// Returns the maximum number of bytes allocated during a single frame, overflows included
+	inline size_t highWaterMark() const { return highWaterMark_; }
+	/// Returns the number of bytes allocated during the last completed frame, overflows included
+	inline size_t lastFrameUsedMemory() const { return lastFrameUsedMemory_; }
+	/// Returns the number of allocations served by the fallback allocator during the last completed frame
+	inline unsigned int lastFrameNumOverflows() const { return lastFrameNumOverflows_; }
+
+  private:
+	/// The header in front of an allocation served by the fallback allocator
+	struct OverflowHeader
+	{
+		OverflowHeader *next;
+		void *backingPtr;
+		size_t size;
+	};
+
+	LinearAllocator arenas_[2];
+	IAllocator &fallbackAllocator_;
+	/// The lists of fallback allocations to release when their arena is cleared
+	OverflowHeader *overflows_[2];
+	unsigned int current_;
+
+	size_t highWaterMark_;
+	size_t lastFrameUsedMemory_;
+	unsigned int numOverflows_;
+	unsigned int lastFrameNumOverflows_;
+
+	FrameAllocator(const FrameAllocator &) = delete;
+	FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+	/// Clears an arena and releases its fallback allocations
+	void clearArena(unsigned int index);
+	void *allocateOverflow(size_t bytes, uint8_t alignment);
+
+	static void *allocateImpl(IAllocator *allocator, size_t size, uint8_t alignment);
+	static void *reallocateImpl(IAllocator *allocator, void *ptr, size_t size, uint8_t alignment, size_t &oldSize);
+	static void deallocateImpl(IAllocator *allocator, void *ptr);
+};
+
+}
+
+#endif
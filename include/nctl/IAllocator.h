@@ -102,6 +102,8 @@ class DLL_PUBLIC IAllocator
 	size_t usedMemory_;
 	size_t numAllocations_;
 	bool copyOnReallocation_;
+	/// False for allocators whose allocations are not counted by `AllocationCounter`, like proxies or arenas
+	bool countAllocations_;
 
 #if defined(RECORD_ALLOCATIONS) || defined(WITH_TRACY) || 1
 	AllocateFunction realAllocateFunc_;
@@ -0,0 +1,94 @@
+#ifndef CLASS_NCTL_THREADCACHINGALLOCATOR
+#define CLASS_NCTL_THREADCACHINGALLOCATOR
+
+#include <nctl/IAllocator.h>
+#include <nctl/Atomic.h>
+
+namespace nctl {
+
+/// A thread-safe allocator front-end with per-thread caches of blocks over a shared backing allocator
+/*! Small allocations are served by power of two size classes. Each thread has a magazine of free blocks per class,
+ *  it can allocate and deallocate without synchronization until the magazine needs to be refilled from, or flushed to,
+ *  the shared depot. The backing allocator is only accessed under a lock, to carve new blocks or for big allocations.
+ *  \note The backing allocator should not be used directly by other threads
+ *  \note The `usedMemory()` and `numAllocations()` statistics refer to the memory requested to the backing allocator */
+class DLL_PUBLIC ThreadCachingAllocator : public IAllocator
+{
+  public:
+	/// Number of power of two size classes, from `MinClassSize` bytes
+	static const unsigned int NumSizeClasses = 12;
+	/// Size of the smallest class in bytes
+	static const unsigned int MinClassSize = 16;
+	/// Maximum number of free blocks in the magazine of a thread for every size class
+	static const unsigned int MagazineCapacity = 32;
+	/// Maximum number of allocators that can have a cache for the same thread
+	static const unsigned int MaxCachesPerThread = 8;
+
+	explicit ThreadCachingAllocator(IAllocator &backingAllocator)
+	    : ThreadCachingAllocator("ThreadCaching", backingAllocator) {}
+	ThreadCachingAllocator(const char *name, IAllocator &backingAllocator);
+	/// Returns all the memory to the backing allocator
+	/*! \note It should not be destroyed while other threads are still using it */
+	~ThreadCachingAllocator();
+
+	/// Returns the biggest allocation size served by the size classes
+	static inline size_t maxClassSize() { return MinClassSize << (NumSizeClasses - 1); }
+
+	/// Returns the blocks cached by the calling thread to the shared depot and destroys its cache
+	/*! \note It should be called by threads that stop using the allocator before they terminate */
+	void releaseThreadCache();
+
+  private:
+	/// The stack of free blocks of a size class for one thread
+	struct Magazine
+	{
+		unsigned int count;
+		void *blocks[MagazineCapacity];
+	};
+
+	/// The per-thread cache, only accessed by the thread that owns it
+	struct ThreadCache
+	{
+		Magazine magazines[NumSizeClasses];
+		ThreadCache *next;
+	};
+
+	IAllocator &backingAllocator_;
+	/// The unique identifier used to find the caches of this allocator among the ones of a thread
+	uint32_t id_;
+	/// The spin lock protecting the depot, the chunks and the caches lists
+	Atomic32 lock_;
+
+	/// The shared lists of free blocks, linked through their first bytes
+	void *depot_[NumSizeClasses];
+	/// The list of chunks carved into blocks, linked through their headers
+	void *chunks_;
+	/// The list of caches created for threads
+	ThreadCache *caches_;
+
+	ThreadCachingAllocator(const ThreadCachingAllocator &) = delete;
+	ThreadCachingAllocator &operator=(const ThreadCachingAllocator &) = delete;
+
+	void acquireLock();
+	void releaseLock();
+
+	/// Returns the cache of the calling thread, creating it if needed, or `nullptr` if the thread cannot have one
+	ThreadCache *threadCache();
+	/// Moves half a magazine of blocks from the depot to the magazine, carving a new chunk if needed
+	bool refill(Magazine &magazine, unsigned int sizeClass);
+	/// Moves half a magazine of blocks from the magazine to the depot
+	void flush(Magazine &magazine, unsigned int sizeClass);
+	/// Carves a new chunk from the backing allocator into blocks of the specified class and adds them to the depot
+	bool carveChunk(unsigned int sizeClass);
+
+	void *allocateBig(size_t bytes, uint8_t alignment);
+	void deallocateBig(void *ptr);
+
+	static void *allocateImpl(IAllocator *allocator, size_t size, uint8_t alignment);
+	static void *reallocateImpl(IAllocator *allocator, void *ptr, size_t size, uint8_t alignment, size_t &oldSize);
+	static void deallocateImpl(IAllocator *allocator, void *ptr);
+};
+
+}
+
+#endif
@@ -794,6 +794,69 @@ inline void quicksortDesc(Iterator first, Iterator last)
 	quicksort(first, last, IteratorTraits<Iterator>::IteratorCategory(), IsNotLess<typename IteratorTraits<Iterator>::ValueType>);
 }
 
+/// Stable least significant digit radix sort on the unsigned integer key returned by a function
+/*! Elements are moved back and forth between the range and a scratch buffer of at least the same size,
+ *  so they should be cheap to copy. Passes on a byte that is equal for every key are skipped.
+ *  To sort on multiple keys, sort on the least significant one first. */
+template <class T, class KeyFunction>
+void radixSort(T *first, T *last, T *scratch, KeyFunction keyFunc)
+{
+	using KeyType = decltype(keyFunc(*first));
+	const unsigned int NumPasses = sizeof(KeyType);
+	const unsigned int NumBuckets = 256;
+
+	const unsigned int size = static_cast<unsigned int>(last - first);
+	if (size < 2)
+		return;
+
+	// Computing the histograms of all passes with a single read of the keys
+	unsigned int histograms[NumPasses][NumBuckets] = {};
+	for (unsigned int i = 0; i < size; i++)
+	{
+		const KeyType key = keyFunc(first[i]);
+		for (unsigned int pass = 0; pass < NumPasses; pass++)
+			histograms[pass][(key >> (pass * 8)) & 0xff]++;
+	}
+
+	T *source = first;
+	T *destination = scratch;
+	for (unsigned int pass = 0; pass < NumPasses; pass++)
+	{
+		unsigned int *histogram = histograms[pass];
+		const unsigned int shift = pass * 8;
+
+		// Skipping the pass if all keys share the same byte
+		if (histogram[(keyFunc(source[0]) >> shift) & 0xff] == size)
+			continue;
+
+		// Transforming the counts into starting offsets
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < NumBuckets; bucket++)
+		{
+			const unsigned int count = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += count;
+		}
+
+		for (unsigned int i = 0; i < size; i++)
+		{
+			const unsigned int bucket = (keyFunc(source[i]) >> shift) & 0xff;
+			destination[histogram[bucket]++] = source[i];
+		}
+
+		T *temp = source;
+		source = destination;
+		destination = temp;
+	}
+
+	// Copying back the elements if the last pass wrote them in the scratch buffer
+	if (source != first)
+	{
+		for (unsigned int i = 0; i < size; i++)
+			first[i] = source[i];
+	}
+}
+
 }
 
 #endif
@@ -31,8 +31,10 @@ AppConfiguration::AppConfiguration()
       windowTitle(128),
       windowIconFilename(128),
       useBufferMapping(false),
+      usePersistentMapping(false),
       deferShaderQueries(true),
       fixedBatchSize(10),
+      useTextureBufferBatching(false),
 #if defined(WITH_IMGUI) || defined(WITH_NUKLEAR)
       vboSize(512 * 1024),
       iboSize(128 * 1024),
@@ -40,15 +42,21 @@ AppConfiguration::AppConfiguration()
       vboSize(64 * 1024),
       iboSize(8 * 1024),
 #endif
+      tboSize(4 * 1024 * 1024),
       vaoPoolSize(16),
       renderCommandPoolSize(32),
       withDebugOverlay(false),
       withAudio(true),
       withThreads(false),
+      withParallelUpdate(false),
+      parallelUpdateDepth(2),
+      parallelUpdateMinNodes(256),
       withScenegraph(true),
       withVSync(true),
       withGlDebugContext(false),
       withConsoleColors(true),
+      headlessFrames(0),
+      headlessReportFile(128),
 
       // Compile-time variables
       glCoreProfile_(true),
@@ -74,6 +82,7 @@ AppConfiguration::AppConfiguration()
 	dataPath() = "/";
 	// Always disable mapping on Emscripten as it is not supported by WebGL 2
 	useBufferMapping = false;
+	usePersistentMapping = false;
 #endif
 
 #if defined(__linux__) && defined(WITH_SDL)
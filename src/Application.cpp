@@ -12,16 +12,25 @@
 #include "Timer.h" // for `sleep()`
 #include "FrameTimer.h"
 #include "SceneNode.h"
+#include "AsyncTextureLoader.h"
+#include "RenderStatistics.h"
+#include "AllocationCounter.h"
 #include <nctl/StaticString.h>
 #include "IInputManager.h"
 #include "JoyMapping.h"
 
+#ifdef WITH_ALLOCATORS
+	#include <nctl/AllocManager.h>
+	#include <nctl/FrameAllocator.h>
+#endif
+
 #ifdef WITH_AUDIO
 	#include "ALAudioDevice.h"
 #endif
 
 #ifdef WITH_THREADS
 	#include "ThreadPool.h"
+	#include "SceneUpdater.h"
 #endif
 
 #ifdef WITH_LUA
@@ -56,7 +65,7 @@ namespace {
 ///////////////////////////////////////////////////////////
 
 Application::Application()
-    : isSuspended_(false), autoSuspension_(true), hasFocus_(true), shouldQuit_(false)
+    : isSuspended_(false), autoSuspension_(true), hasFocus_(true), shouldQuit_(false), exitCode_(EXIT_SUCCESS)
 {
 }
 
@@ -134,6 +143,7 @@ void Application::initCommon()
 	TracyGpuCollect;
 
 	frameTimer_ = nctl::makeUnique<FrameTimer>(appCfg_.frameTimerLogInterval, appCfg_.profileTextUpdateTime());
+	asyncTextureLoader_ = nctl::makeUnique<AsyncTextureLoader>();
 
 #ifdef WITH_IMGUI
 	imguiDrawing_ = nctl::makeUnique<ImGuiDrawing>(appCfg_.withScenegraph);
@@ -149,6 +159,13 @@ void Application::initCommon()
 		rootNode_ = nctl::makeUnique<SceneNode>();
 		screenViewport_ = nctl::makeUnique<ScreenViewport>();
 		screenViewport_->setRootNode(rootNode_.get());
+#ifdef WITH_THREADS
+		if (appCfg_.withThreads && appCfg_.withParallelUpdate)
+		{
+			sceneUpdater_ = nctl::makeUnique<SceneUpdater>(theServiceLocator().threadPool(),
+			                                               appCfg_.parallelUpdateDepth, appCfg_.parallelUpdateMinNodes);
+		}
+#endif
 	}
 	else
 		RenderResources::createMinimal(); // some resources are still required for rendering
@@ -193,12 +210,21 @@ void Application::step()
 	ZoneScoped;
 	frameTimer_->addFrame();
 
+#ifdef WITH_ALLOCATORS
+	// The transient allocations of two frames ago are discarded, the ones of the last frame are still valid
+	nctl::theFrameAllocator().nextFrame();
+#endif
+	RenderStatistics::gatherFrameArenaStatistics();
+	AllocationCounter::nextFrame();
+
 #ifdef WITH_IMGUI
 	{
 		ZoneScopedN("ImGui newFrame");
 		profileStartTime_ = TimeStamp::now();
+		AllocationCounter::setZone(Timings::IMGUI);
 		imguiDrawing_->newFrame();
 		timings_[Timings::IMGUI] = profileStartTime_.secondsSince();
+		AllocationCounter::setZone(AllocationCounter::NoZone);
 	}
 #endif
 
@@ -206,8 +232,10 @@ void Application::step()
 	{
 		ZoneScopedN("Nuklear newFrame");
 		profileStartTime_ = TimeStamp::now();
+		AllocationCounter::setZone(Timings::NUKLEAR);
 		nuklearDrawing_->newFrame();
 		timings_[Timings::NUKLEAR] = profileStartTime_.secondsSince();
+		AllocationCounter::setZone(AllocationCounter::NoZone);
 	}
 #endif
 
@@ -223,11 +251,16 @@ void Application::step()
 	}
 #endif
 
+	// Textures are uploaded before `onFrameStart()` so that completion callbacks are invoked before user code
+	asyncTextureLoader_->update(renderingSettings_.maxTextureUploadTime);
+
 	{
 		ZoneScopedN("onFrameStart");
 		profileStartTime_ = TimeStamp::now();
+		AllocationCounter::setZone(Timings::FRAME_START);
 		appEventHandler_->onFrameStart();
 		timings_[Timings::FRAME_START] = profileStartTime_.secondsSince();
+		AllocationCounter::setZone(AllocationCounter::NoZone);
 	}
 
 	if (debugOverlay_)
@@ -239,33 +272,41 @@ void Application::step()
 		{
 			ZoneScopedN("Update");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::UPDATE);
 			screenViewport_->update();
 			timings_[Timings::UPDATE] = profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 
 		{
 			ZoneScopedN("onPostUpdate");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::POST_UPDATE);
 			appEventHandler_->onPostUpdate();
 			timings_[Timings::POST_UPDATE] = profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 
 		{
 			ZoneScopedN("Visit");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::VISIT);
 			screenViewport_->visit();
 			timings_[Timings::VISIT] = profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 
 #ifdef WITH_IMGUI
 		{
 			ZoneScopedN("ImGui endFrame");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::IMGUI);
 			RenderQueue *imguiRenderQueue = (guiSettings_.imguiViewport) ?
 			            guiSettings_.imguiViewport->renderQueue_.get() :
 			            screenViewport_->renderQueue_.get();
 			imguiDrawing_->endFrame(*imguiRenderQueue);
 			timings_[Timings::IMGUI] += profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 #endif
 
@@ -273,20 +314,24 @@ void Application::step()
 		{
 			ZoneScopedN("Nuklear endFrame");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::NUKLEAR);
 			RenderQueue *nuklearRenderQueue = (guiSettings_.nuklearViewport) ?
 			            guiSettings_.nuklearViewport->renderQueue_.get() :
 			            screenViewport_->renderQueue_.get();
 			nuklearDrawing_->endFrame(*nuklearRenderQueue);
 			timings_[Timings::NUKLEAR] += profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 #endif
 
 		{
 			ZoneScopedN("Draw");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::DRAW);
 			screenViewport_->sortAndCommitQueue();
 			screenViewport_->draw();
 			timings_[Timings::DRAW] = profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 	}
 	else
@@ -295,8 +340,10 @@ void Application::step()
 		{
 			ZoneScopedN("ImGui endFrame");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::IMGUI);
 			imguiDrawing_->endFrame();
 			timings_[Timings::IMGUI] += profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 #endif
 
@@ -304,8 +351,10 @@ void Application::step()
 		{
 			ZoneScopedN("Nuklear endFrame");
 			profileStartTime_ = TimeStamp::now();
+			AllocationCounter::setZone(Timings::NUKLEAR);
 			nuklearDrawing_->endFrame();
 			timings_[Timings::NUKLEAR] += profileStartTime_.secondsSince();
+			AllocationCounter::setZone(AllocationCounter::NoZone);
 		}
 #endif
 	}
@@ -318,8 +367,10 @@ void Application::step()
 	{
 		ZoneScopedN("onFrameEnd");
 		profileStartTime_ = TimeStamp::now();
+		AllocationCounter::setZone(Timings::FRAME_END);
 		appEventHandler_->onFrameEnd();
 		timings_[Timings::FRAME_END] = profileStartTime_.secondsSince();
+		AllocationCounter::setZone(AllocationCounter::NoZone);
 	}
 
 	if (debugOverlay_)
@@ -359,7 +410,11 @@ void Application::shutdownCommon()
 #endif
 
 	debugOverlay_.reset(nullptr);
+#ifdef WITH_THREADS
+	sceneUpdater_.reset(nullptr);
+#endif
 	rootNode_.reset(nullptr);
+	asyncTextureLoader_.reset(nullptr);
 	RenderResources::dispose();
 	frameTimer_.reset(nullptr);
 	inputManager_.reset(nullptr);
@@ -0,0 +1,114 @@
+#include <cstring> // for memcpy()
+
+#include "common_macros.h"
+#include "ArchiveFile.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ArchiveFile::ArchiveFile(const char *filename, const nctl::SharedPtr<IFile> &archiveHandle, const unsigned char *blobData, unsigned long int blobSize)
+    : IFile(filename), archiveHandle_(archiveHandle), blobData_(blobData), seekOffset_(0), isOpened_(false)
+{
+	ASSERT(archiveHandle_);
+	type_ = FileType::ARCHIVE;
+	fileSize_ = blobSize;
+}
+
+ArchiveFile::~ArchiveFile()
+{
+	if (shouldCloseOnDestruction_)
+		close();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ArchiveFile::open(unsigned char mode)
+{
+	// Checking if the file is already opened
+	if (isOpened_)
+		LOGW_X("File \"%s\" is already opened", filename_.data());
+	else if (mode & OpenMode::WRITE || (mode & OpenMode::READ) == 0)
+		LOGE_X("Cannot open the archived file \"%s\", wrong open mode", filename_.data());
+	else
+	{
+		seekOffset_ = 0;
+		isOpened_ = true;
+	}
+}
+
+void ArchiveFile::close()
+{
+	seekOffset_ = 0;
+	isOpened_ = false;
+}
+
+/*! Like `fseek()` it returns zero on success, as expected by the Ogg Vorbis callbacks */
+long int ArchiveFile::seek(long int offset, int whence) const
+{
+	long int seekValue = -1;
+
+	if (isOpened_)
+	{
+		switch (whence)
+		{
+			case SEEK_SET:
+				seekValue = offset;
+				break;
+			case SEEK_CUR:
+				seekValue = seekOffset_ + offset;
+				break;
+			case SEEK_END:
+				seekValue = fileSize_ + offset;
+				break;
+		}
+	}
+
+	if (seekValue < 0 || seekValue > static_cast<long int>(fileSize_))
+		return -1;
+
+	seekOffset_ = seekValue;
+	return 0;
+}
+
+long int ArchiveFile::tell() const
+{
+	long int tellValue = -1;
+
+	if (isOpened_)
+		tellValue = seekOffset_;
+
+	return tellValue;
+}
+
+unsigned long int ArchiveFile::read(void *buffer, unsigned long int bytes) const
+{
+	ASSERT(buffer);
+
+	unsigned long int bytesRead = 0;
+
+	if (isOpened_ && blobData_)
+	{
+		bytesRead = (seekOffset_ + bytes > fileSize_) ? fileSize_ - seekOffset_ : bytes;
+		memcpy(buffer, blobData_ + seekOffset_, bytesRead);
+		seekOffset_ += bytesRead;
+	}
+
+	return bytesRead;
+}
+
+unsigned long int ArchiveFile::write(const void *buffer, unsigned long int bytes)
+{
+	return 0;
+}
+
+bool ArchiveFile::isOpened() const
+{
+	return isOpened_;
+}
+
+}
@@ -0,0 +1,518 @@
+#include <cstring> // for memcmp() and strnlen()
+#include <nctl/Array.h>
+#include <nctl/SharedPtr.h>
+#include <nctl/HashFunctions.h>
+#include <nctl/algorithms.h>
+
+#include "common_macros.h"
+#include "AssetArchive.h"
+#include "ArchiveFile.h"
+#include "FileSystem.h"
+
+namespace ncine {
+
+namespace {
+
+	static_assert(sizeof(AssetArchive::Header) == 32, "The archive header should be 32 bytes long");
+	static_assert(sizeof(AssetArchive::Entry) == 40, "An archive directory entry should be 40 bytes long");
+
+	const uint64_t PathHashSeed = 0x6E43696E65417263ULL;
+	/// Maximum number of characters for a path relative to the archive root
+	const unsigned int MaxPathLength = 512;
+
+	struct MountedArchive
+	{
+		MountedArchive() {}
+		MountedArchive(const char *archiveFilename, const char *archiveMountPoint)
+		    : filename(archiveFilename), mountPoint(archiveMountPoint) {}
+
+		nctl::String filename;
+		nctl::String mountPoint;
+		/// The handle keeps the archive mapping valid, it is shared with the files opened from the archive
+		nctl::SharedPtr<IFile> fileHandle;
+		const AssetArchive::Entry *entries = nullptr;
+		unsigned int numEntries = 0;
+		const char *names = nullptr;
+	};
+
+	/// A file collected by `build()`, sorted by path hash before writing the directory
+	struct SourceFile
+	{
+		uint64_t pathHash;
+		nctl::String path;
+		unsigned long int size;
+	};
+
+	nctl::Array<MountedArchive> &mountedArchives()
+	{
+		static nctl::Array<MountedArchive> archives;
+		return archives;
+	}
+
+	uint64_t alignOffset(uint64_t offset)
+	{
+		return (offset + AssetArchive::BlobAlignment - 1) & ~static_cast<uint64_t>(AssetArchive::BlobAlignment - 1);
+	}
+
+	/// A path buffer aligned for `fasthash64()` to properly work on Emscripten without alignment faults
+	struct PathBuffer
+	{
+		uint64_t words[MaxPathLength / sizeof(uint64_t)];
+		inline const char *chars() const { return reinterpret_cast<const char *>(words); }
+	};
+
+	/// Copies a path converting backslashes to forward slashes
+	unsigned int normalizePath(const char *path, PathBuffer &dest)
+	{
+		char *destChars = reinterpret_cast<char *>(dest.words);
+		unsigned int length = 0;
+		while (path[length] != '\0' && length < MaxPathLength)
+		{
+			destChars[length] = (path[length] == '\\') ? '/' : path[length];
+			length++;
+		}
+
+		return length;
+	}
+
+	bool hasMountPoint(const char *filename, const nctl::String &mountPoint)
+	{
+		for (unsigned int i = 0; i < mountPoint.length(); i++)
+		{
+			const char c = (filename[i] == '\\') ? '/' : filename[i];
+			if (c != mountPoint[i])
+				return false;
+		}
+		return true;
+	}
+
+	uint64_t hashNormalizedPath(const PathBuffer &path, unsigned int length)
+	{
+		return nctl::fasthash64(path.words, length, PathHashSeed);
+	}
+
+	const AssetArchive::Entry *findEntry(const MountedArchive &archive, const PathBuffer &path, unsigned int length)
+	{
+		const uint64_t pathHash = hashNormalizedPath(path, length);
+
+		// Lower bound binary search, entries with colliding hashes are adjacent
+		unsigned int first = 0;
+		unsigned int count = archive.numEntries;
+		while (count > 0)
+		{
+			const unsigned int step = count / 2;
+			if (IFile::int64FromLE(archive.entries[first + step].pathHash) < pathHash)
+			{
+				first += step + 1;
+				count -= step + 1;
+			}
+			else
+				count = step;
+		}
+
+		for (unsigned int i = first; i < archive.numEntries; i++)
+		{
+			const AssetArchive::Entry &entry = archive.entries[i];
+			if (IFile::int64FromLE(entry.pathHash) != pathHash)
+				break;
+
+			const char *name = archive.names + IFile::int32FromLE(entry.nameOffset);
+			if (IFile::int16FromLE(entry.nameLength) == length && memcmp(name, path.chars(), length) == 0)
+				return &entry;
+		}
+
+		return nullptr;
+	}
+
+	/// Returns the entry of a path in the mounted archive with the highest precedence, or `nullptr`
+	const AssetArchive::Entry *resolvePath(const char *filename, const MountedArchive **resolvingArchive)
+	{
+		const nctl::Array<MountedArchive> &archives = mountedArchives();
+		if (archives.isEmpty())
+			return nullptr;
+
+		const unsigned int filenameLength = strnlen(filename, MaxPathLength);
+		for (int i = static_cast<int>(archives.size()) - 1; i >= 0; i--)
+		{
+			const MountedArchive &archive = archives[i];
+			const unsigned int mountPointLength = archive.mountPoint.length();
+			if (filenameLength <= mountPointLength || hasMountPoint(filename, archive.mountPoint) == false)
+				continue;
+
+			PathBuffer path;
+			const unsigned int length = normalizePath(filename + mountPointLength, path);
+			const AssetArchive::Entry *entry = findEntry(archive, path, length);
+			if (entry)
+			{
+				if (resolvingArchive)
+					*resolvingArchive = &archive;
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool validateArchive(MountedArchive &archive)
+	{
+		const unsigned char *data = archive.fileHandle->data();
+		const uint64_t size = static_cast<uint64_t>(archive.fileHandle->size());
+		if (data == nullptr || size < sizeof(AssetArchive::Header))
+		{
+			LOGE_X("File \"%s\" is not a valid archive", archive.filename.data());
+			return false;
+		}
+
+		const AssetArchive::Header &header = *reinterpret_cast<const AssetArchive::Header *>(data);
+		if (memcmp(header.signature, AssetArchive::Signature, sizeof(header.signature)) != 0)
+		{
+			LOGE_X("File \"%s\" is not a valid archive", archive.filename.data());
+			return false;
+		}
+		else if (IFile::int16FromLE(header.version) != AssetArchive::Version)
+		{
+			LOGE_X("Archive \"%s\" has an unsupported version: %u", archive.filename.data(), IFile::int16FromLE(header.version));
+			return false;
+		}
+
+		const uint32_t numEntries = IFile::int32FromLE(header.numEntries);
+		const uint32_t namesSize = IFile::int32FromLE(header.namesSize);
+		const uint64_t directoryOffset = IFile::int64FromLE(header.directoryOffset);
+		const uint64_t namesOffset = IFile::int64FromLE(header.namesOffset);
+		// Offsets are compared with what is left of the archive, so that a corrupted one cannot wrap the sums around
+		if (directoryOffset % sizeof(uint64_t) != 0 || directoryOffset > size || numEntries * sizeof(AssetArchive::Entry) > size - directoryOffset ||
+		    namesOffset > size || namesSize > size - namesOffset)
+		{
+			LOGE_X("Archive \"%s\" is truncated or corrupted", archive.filename.data());
+			return false;
+		}
+
+		archive.entries = reinterpret_cast<const AssetArchive::Entry *>(data + directoryOffset);
+		archive.numEntries = numEntries;
+		archive.names = reinterpret_cast<const char *>(data + namesOffset);
+
+		for (unsigned int i = 0; i < numEntries; i++)
+		{
+			const AssetArchive::Entry &entry = archive.entries[i];
+			const uint64_t offset = IFile::int64FromLE(entry.offset);
+			const uint64_t storedSize = IFile::int64FromLE(entry.storedSize);
+			const uint32_t nameOffset = IFile::int32FromLE(entry.nameOffset);
+			if (offset > size || storedSize > size - offset || nameOffset > namesSize || IFile::int16FromLE(entry.nameLength) > namesSize - nameOffset ||
+			    (i > 0 && IFile::int64FromLE(archive.entries[i - 1].pathHash) > IFile::int64FromLE(entry.pathHash)))
+			{
+				LOGE_X("Archive \"%s\" is truncated or corrupted", archive.filename.data());
+				return false;
+			}
+			else if (static_cast<AssetArchive::Compression>(entry.compression) != AssetArchive::Compression::NONE)
+			{
+				LOGE_X("Archive \"%s\" contains compressed blobs, which are not supported", archive.filename.data());
+				return false;
+			}
+			else if (IFile::int64FromLE(entry.size) != storedSize)
+			{
+				// The size of an uncompressed blob is the number of bytes that are read from the archive
+				LOGE_X("Archive \"%s\" has an uncompressed blob with a size that differs from the stored one", archive.filename.data());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// Returns a copy of the header with all numbers converted to little endian
+	AssetArchive::Header headerToLE(const AssetArchive::Header &header)
+	{
+		AssetArchive::Header leHeader = header;
+		leHeader.version = IFile::int16FromLE(header.version);
+		leHeader.flags = IFile::int16FromLE(header.flags);
+		leHeader.numEntries = IFile::int32FromLE(header.numEntries);
+		leHeader.namesSize = IFile::int32FromLE(header.namesSize);
+		leHeader.directoryOffset = IFile::int64FromLE(header.directoryOffset);
+		leHeader.namesOffset = IFile::int64FromLE(header.namesOffset);
+		return leHeader;
+	}
+
+	/// Returns a copy of the directory entry with all numbers converted to little endian
+	AssetArchive::Entry entryToLE(const AssetArchive::Entry &entry)
+	{
+		AssetArchive::Entry leEntry = entry;
+		leEntry.pathHash = IFile::int64FromLE(entry.pathHash);
+		leEntry.offset = IFile::int64FromLE(entry.offset);
+		leEntry.size = IFile::int64FromLE(entry.size);
+		leEntry.storedSize = IFile::int64FromLE(entry.storedSize);
+		leEntry.nameOffset = IFile::int32FromLE(entry.nameOffset);
+		leEntry.nameLength = IFile::int16FromLE(entry.nameLength);
+		return leEntry;
+	}
+
+	bool writeBytes(IFile &fileHandle, const void *buffer, unsigned long int bytes)
+	{
+		return (bytes == 0 || fileHandle.write(buffer, bytes) == bytes);
+	}
+
+	/// Writes the header, the directory, the names and the blobs of an archive, returning false on the first error
+	bool writeArchive(const char *archiveFilename, const char *directory, const AssetArchive::Header &header,
+	                  const nctl::Array<AssetArchive::Entry> &entries, const nctl::Array<SourceFile> &sourceFiles)
+	{
+		nctl::UniquePtr<IFile> archiveHandle = IFile::createFileHandle(archiveFilename);
+		archiveHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+		if (archiveHandle->isOpened() == false)
+			return false;
+
+		// The conversion functions from little endian also convert to it, as they only swap bytes
+		const AssetArchive::Header leHeader = headerToLE(header);
+		if (writeBytes(*archiveHandle, &leHeader, sizeof(AssetArchive::Header)) == false)
+			return false;
+		for (const AssetArchive::Entry &entry : entries)
+		{
+			const AssetArchive::Entry leEntry = entryToLE(entry);
+			if (writeBytes(*archiveHandle, &leEntry, sizeof(AssetArchive::Entry)) == false)
+				return false;
+		}
+		for (const SourceFile &sourceFile : sourceFiles)
+		{
+			if (writeBytes(*archiveHandle, sourceFile.path.data(), sourceFile.path.length()) == false)
+				return false;
+		}
+
+		static const unsigned char Padding[AssetArchive::BlobAlignment] = {};
+		uint64_t writeOffset = header.namesOffset + header.namesSize;
+		nctl::Array<unsigned char> buffer;
+		for (unsigned int i = 0; i < sourceFiles.size(); i++)
+		{
+			if (writeBytes(*archiveHandle, Padding, entries[i].offset - writeOffset) == false)
+				return false;
+			writeOffset = entries[i].offset;
+
+			const nctl::String sourcePath = fs::joinPath(directory, sourceFiles[i].path);
+			nctl::UniquePtr<IFile> sourceHandle = IFile::createFileHandle(sourcePath.data());
+			sourceHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+			if (sourceHandle->isOpened() == false)
+				return false;
+
+			buffer.setSize(sourceFiles[i].size);
+			if (sourceFiles[i].size > 0 && sourceHandle->read(buffer.data(), sourceFiles[i].size) != sourceFiles[i].size)
+			{
+				LOGE_X("Cannot read the whole file \"%s\"", sourcePath.data());
+				return false;
+			}
+			if (writeBytes(*archiveHandle, buffer.data(), sourceFiles[i].size) == false)
+				return false;
+			writeOffset += sourceFiles[i].size;
+		}
+
+		return true;
+	}
+
+	void collectFiles(const nctl::String &rootDir, const nctl::String &relativeDir, nctl::Array<SourceFile> &sourceFiles)
+	{
+		const nctl::String dirPath = relativeDir.isEmpty() ? rootDir : fs::joinPath(rootDir, relativeDir);
+		FileSystem::Directory dir(dirPath.data());
+
+		const char *entryName = dir.readNext();
+		while (entryName)
+		{
+			if (strcmp(entryName, ".") != 0 && strcmp(entryName, "..") != 0)
+			{
+				nctl::String relativePath(MaxPathLength);
+				if (relativeDir.isEmpty() == false)
+				{
+					relativePath = relativeDir;
+					relativePath.append("/");
+				}
+				relativePath.append(entryName);
+
+				const nctl::String fullPath = fs::joinPath(rootDir, relativePath);
+				if (fs::isDirectory(fullPath.data()))
+					collectFiles(rootDir, relativePath, sourceFiles);
+				else if (fs::isFile(fullPath.data()))
+				{
+					const unsigned long int fileSize = static_cast<unsigned long int>(fs::fileSize(fullPath.data()));
+					sourceFiles.pushBack(SourceFile{ 0, relativePath, fileSize });
+				}
+			}
+			entryName = dir.readNext();
+		}
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const char AssetArchive::Signature[4] = { 'N', 'C', 'A', 'R' };
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool AssetArchive::build(const char *directory, const char *archiveFilename)
+{
+	ASSERT(directory);
+	ASSERT(archiveFilename);
+
+	if (fs::isDirectory(directory) == false)
+	{
+		LOGE_X("Cannot build an archive from \"%s\", it is not a directory", directory);
+		return false;
+	}
+
+	nctl::Array<SourceFile> sourceFiles;
+	collectFiles(directory, nctl::String(), sourceFiles);
+	for (SourceFile &sourceFile : sourceFiles)
+	{
+		if (sourceFile.path.length() >= MaxPathLength)
+		{
+			LOGE_X("Cannot archive \"%s\", the path is too long", sourceFile.path.data());
+			return false;
+		}
+
+		sourceFile.pathHash = hashPath(sourceFile.path.data());
+	}
+	nctl::quicksort(sourceFiles.begin(), sourceFiles.end(), [](const SourceFile &a, const SourceFile &b) { return a.pathHash < b.pathHash; });
+
+	// Laying out the directory, the names and the blobs
+	Header header = {};
+	memcpy(header.signature, Signature, sizeof(header.signature));
+	header.version = Version;
+	header.numEntries = sourceFiles.size();
+	header.directoryOffset = sizeof(Header);
+	header.namesOffset = header.directoryOffset + sourceFiles.size() * sizeof(Entry);
+
+	nctl::Array<Entry> entries(sourceFiles.size());
+	uint64_t blobOffset = 0;
+	for (const SourceFile &sourceFile : sourceFiles)
+	{
+		Entry entry = {};
+		entry.pathHash = sourceFile.pathHash;
+		entry.size = sourceFile.size;
+		entry.storedSize = sourceFile.size;
+		entry.nameOffset = header.namesSize;
+		entry.nameLength = static_cast<uint16_t>(sourceFile.path.length());
+		entry.compression = static_cast<uint8_t>(Compression::NONE);
+		header.namesSize += sourceFile.path.length();
+
+		entry.offset = blobOffset;
+		blobOffset = alignOffset(blobOffset + entry.storedSize);
+		entries.pushBack(entry);
+	}
+	const uint64_t firstBlobOffset = alignOffset(header.namesOffset + header.namesSize);
+	for (Entry &entry : entries)
+		entry.offset += firstBlobOffset;
+
+	// The archive is written to a temporary file first, so that a failed build does not leave a partial archive behind
+	nctl::String tempFilename(archiveFilename);
+	tempFilename.append(".tmp");
+	if (writeArchive(tempFilename.data(), directory, header, entries, sourceFiles) == false)
+	{
+		LOGE_X("Cannot write the archive \"%s\"", archiveFilename);
+		fs::deleteFile(tempFilename.data());
+		return false;
+	}
+
+	bool renamed = fs::rename(tempFilename.data(), archiveFilename);
+	if (renamed == false && fs::isFile(archiveFilename))
+	{
+		// `MoveFile()` on Windows does not replace an existing file
+		renamed = fs::deleteFile(archiveFilename) && fs::rename(tempFilename.data(), archiveFilename);
+	}
+	if (renamed == false)
+	{
+		LOGE_X("Cannot rename \"%s\" to \"%s\"", tempFilename.data(), archiveFilename);
+		fs::deleteFile(tempFilename.data());
+		return false;
+	}
+
+	LOGI_X("Archive \"%s\" built with %u files from \"%s\"", archiveFilename, sourceFiles.size(), directory);
+	return true;
+}
+
+bool AssetArchive::mount(const char *archiveFilename, const char *mountPoint)
+{
+	ASSERT(archiveFilename);
+	ASSERT(mountPoint);
+
+	unmount(archiveFilename);
+
+	MountedArchive archive(archiveFilename, mountPoint);
+	// The mount point always ends with a separator, unless it is empty
+	for (unsigned int i = 0; i < archive.mountPoint.length(); i++)
+	{
+		if (archive.mountPoint[i] == '\\')
+			archive.mountPoint[i] = '/';
+	}
+	if (archive.mountPoint.isEmpty() == false && archive.mountPoint[archive.mountPoint.length() - 1] != '/')
+		archive.mountPoint.append("/");
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createMappedFileHandle(archiveFilename);
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+	archive.fileHandle = nctl::SharedPtr<IFile>(nctl::move(fileHandle));
+
+	if (validateArchive(archive) == false)
+		return false;
+
+	LOGI_X("Archive \"%s\" with %u files mounted on \"%s\"", archiveFilename, archive.numEntries, archive.mountPoint.data());
+	mountedArchives().pushBack(nctl::move(archive));
+	return true;
+}
+
+bool AssetArchive::unmount(const char *archiveFilename)
+{
+	ASSERT(archiveFilename);
+
+	nctl::Array<MountedArchive> &archives = mountedArchives();
+	for (unsigned int i = 0; i < archives.size(); i++)
+	{
+		if (archives[i].filename == archiveFilename)
+		{
+			archives.removeAt(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void AssetArchive::unmountAll()
+{
+	mountedArchives().clear();
+}
+
+unsigned int AssetArchive::numMounted()
+{
+	return mountedArchives().size();
+}
+
+bool AssetArchive::contains(const char *filename)
+{
+	ASSERT(filename);
+	return (resolvePath(filename, nullptr) != nullptr);
+}
+
+nctl::UniquePtr<IFile> AssetArchive::createFileHandle(const char *filename)
+{
+	ASSERT(filename);
+
+	const MountedArchive *archive = nullptr;
+	const Entry *entry = resolvePath(filename, &archive);
+	if (entry == nullptr)
+		return nctl::UniquePtr<IFile>();
+
+	const uint64_t size = IFile::int64FromLE(entry->size);
+	const unsigned char *blobData = (size > 0) ? archive->fileHandle->data() + IFile::int64FromLE(entry->offset) : nullptr;
+	return nctl::makeUnique<ArchiveFile>(filename, archive->fileHandle, blobData, static_cast<unsigned long int>(size));
+}
+
+uint64_t AssetArchive::hashPath(const char *path)
+{
+	ASSERT(path);
+
+	PathBuffer normalizedPath;
+	const unsigned int length = normalizePath(path, normalizedPath);
+	return hashNormalizedPath(normalizedPath, length);
+}
+
+}
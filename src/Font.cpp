@@ -1,19 +1,314 @@
+#include <cstring> // for memcpy()
 #include "common_macros.h"
 #include "return_macros.h"
 #include <nctl/CString.h>
+#include <nctl/HashFunctions.h>
 #include "Font.h"
 #include "FntParser.h"
+#include "FontAtlas.h"
 #include "FontGlyph.h"
 #include "Texture.h"
+#include "ITextureLoader.h"
+#include "IFile.h"
 #include "FileSystem.h"
+#include "ServiceLocator.h"
 #include "tracy.h"
 
 #ifdef __ANDROID__
 	#include "AssetFile.h"
 #endif
 
+#ifdef WITH_FREETYPE
+	#include <ft2build.h>
+	#include FT_FREETYPE_H
+	#include FT_TRUETYPE_TABLES_H
+	#include FT_TRUETYPE_TAGS_H
+#endif
+
 namespace ncine {
 
+namespace {
+
+	const uint64_t AtlasHashSeed = 0x6E43696E65534446ULL;
+	/// The name of the cache directory inside the save path
+	const char *AtlasCacheDirName = "ncine_font_cache";
+	/// The maximum size of a distance field atlas, even if the device supports bigger textures
+	const unsigned int MaxAtlasSize = 4096;
+
+	nctl::String fntTextureFilename(const char *fntFilename, const FntParser &fntParser)
+	{
+#ifdef __ANDROID__
+		nctl::String dirName = fs::dirName(AssetFile::assetPath(fntFilename));
+
+		nctl::String texFilename(256);
+		if (AssetFile::assetPath(fntFilename) != fntFilename)
+			texFilename.append(AssetFile::Prefix);
+		if (dirName != ".")
+			texFilename.append(fs::joinPath(dirName, fntParser.pageTag(0).file).data());
+		else
+			texFilename.append(fntParser.pageTag(0).file.data());
+#else
+		nctl::String dirName = fs::dirName(fntFilename);
+		nctl::String texFilename = fs::absoluteJoinPath(dirName, fntParser.pageTag(0).file);
+#endif
+		return texFilename;
+	}
+
+	bool readFile(const char *filename, nctl::Array<unsigned char> &buffer)
+	{
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+		fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		const unsigned long int fileSize = static_cast<unsigned long int>(fileHandle->size());
+		buffer.setSize(fileSize);
+		return (fileHandle->read(buffer.data(), fileSize) == fileSize);
+	}
+
+	/// Mixes the generation settings into the hash of the source data, so that the cache is invalidated when they change
+	uint64_t hashSettings(const Font::DistanceFieldSettings &settings, bool fromVectorFont, uint64_t sourceHash)
+	{
+		const uint32_t values[4] = { settings.spread, fromVectorFont ? settings.glyphSize : 0,
+			                         fromVectorFont ? settings.firstCodepoint : 0, fromVectorFont ? settings.lastCodepoint : 0 };
+		return nctl::fasthash64(values, sizeof(values), sourceHash);
+	}
+
+	nctl::String atlasCacheDirectory(const Font::DistanceFieldSettings &settings)
+	{
+		if (settings.cacheDirectory)
+			return nctl::String(settings.cacheDirectory);
+		return fs::joinPath(fs::savePath(), AtlasCacheDirName);
+	}
+
+	/// The atlases generated from the same source file with different settings are cached separately
+	/*! The hash of the source directory tells apart files with the same name in different directories */
+	nctl::String atlasCacheFilename(const char *sourceFilename, const Font::DistanceFieldSettings &settings, bool fromVectorFont)
+	{
+		nctl::String sourcePath = fs::absolutePath(sourceFilename);
+		if (sourcePath.isEmpty())
+			sourcePath = sourceFilename;
+		const nctl::String sourceDirectory = fs::dirName(sourcePath.data());
+
+		nctl::String filename = fs::baseName(sourceFilename);
+		filename.formatAppend("_%08x", nctl::fasthash32(sourceDirectory.data(), sourceDirectory.length(), static_cast<uint32_t>(AtlasHashSeed)));
+		if (fromVectorFont)
+			filename.formatAppend("_%u", settings.glyphSize);
+		filename.formatAppend("_%u.ncdf", settings.spread);
+		return fs::joinPath(atlasCacheDirectory(settings), filename);
+	}
+
+	void saveAtlasToCache(const FontAtlas &atlas, const Font::DistanceFieldSettings &settings, const nctl::String &cacheFilename, uint64_t sourceHash)
+	{
+		const nctl::String cacheDirectory = atlasCacheDirectory(settings);
+		if (fs::isDirectory(cacheDirectory.data()) == false && fs::createDir(cacheDirectory.data()) == false)
+		{
+			LOGW_X("Cannot create the font atlas cache directory \"%s\"", cacheDirectory.data());
+			return;
+		}
+
+		if (atlas.saveToFile(cacheFilename.data(), sourceHash))
+			LOGI_X("Font atlas saved to \"%s\"", cacheFilename.data());
+		else
+			LOGW_X("Cannot save the font atlas to \"%s\"", cacheFilename.data());
+	}
+
+	unsigned int maxAtlasSize()
+	{
+		const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
+		const int maxTextureSize = gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_TEXTURE_SIZE);
+		return (maxTextureSize > 0 && static_cast<unsigned int>(maxTextureSize) < MaxAtlasSize) ? static_cast<unsigned int>(maxTextureSize) : MaxAtlasSize;
+	}
+
+	/// Returns the texture channel holding the glyph coverage, following the same logic used to determine the render mode
+	unsigned int coverageChannel(const FntParser::CommonTag &commonTag, unsigned int numChannels)
+	{
+		if (numChannels == 2)
+			return 1; // luminance and alpha
+		else if (numChannels == 4)
+		{
+			const bool glyphInRed = (commonTag.alphaChnl != FntParser::ChannelData::GLYPH && commonTag.redChnl == FntParser::ChannelData::GLYPH);
+			return glyphInRed ? 0 : 3;
+		}
+		return 0;
+	}
+
+#ifdef WITH_FREETYPE
+	/// The maximum number of glyphs whose pairs are all checked for kerning, when a font has no `kern` table to read
+	const unsigned int MaxKerningScanGlyphs = 256;
+
+	uint16_t readUint16(const unsigned char *bytes)
+	{
+		uint16_t value;
+		memcpy(&value, bytes, sizeof(uint16_t));
+		return IFile::int16FromBE(value);
+	}
+
+	uint32_t readUint32(const unsigned char *bytes)
+	{
+		uint32_t value;
+		memcpy(&value, bytes, sizeof(uint32_t));
+		return IFile::int32FromBE(value);
+	}
+
+	/// Reads the horizontal kerning pairs of the format 0 subtables of the TrueType `kern` table
+	/*! Only the pairs stored in the table are visited, instead of all the pairs of rasterized glyphs.
+	 *  \return False if the font has no `kern` table */
+	bool readKerningTable(FT_Face face, const nctl::Array<unsigned int> &codepoints, const nctl::Array<FT_UInt> &glyphIndices, FontAtlas &atlas)
+	{
+		FT_ULong tableLength = 0;
+		if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, nullptr, &tableLength) != 0 || tableLength < 4)
+			return false;
+		nctl::Array<unsigned char> table(tableLength);
+		table.setSize(tableLength);
+		if (FT_Load_Sfnt_Table(face, TTAG_kern, 0, table.data(), &tableLength) != 0)
+			return false;
+
+		// Every glyph index links to the first rasterized codepoint using it, the codepoints sharing a glyph are chained
+		const unsigned int numFaceGlyphs = static_cast<unsigned int>(face->num_glyphs);
+		nctl::Array<int> firstCodepoints(numFaceGlyphs);
+		firstCodepoints.setSize(numFaceGlyphs);
+		for (unsigned int i = 0; i < numFaceGlyphs; i++)
+			firstCodepoints[i] = -1;
+		nctl::Array<int> nextCodepoints(codepoints.size());
+		nextCodepoints.setSize(codepoints.size());
+		for (unsigned int i = codepoints.size(); i > 0; i--)
+		{
+			nextCodepoints[i - 1] = firstCodepoints[glyphIndices[i - 1]];
+			firstCodepoints[glyphIndices[i - 1]] = static_cast<int>(i - 1);
+		}
+
+		// The Microsoft table has a version of zero and 16 bit headers, the Apple one has a version of one and 32 bit headers
+		const unsigned char *data = table.data();
+		const bool appleTable = (readUint16(data) == 1);
+		if (appleTable && tableLength < 8)
+			return true;
+		const unsigned long numSubtables = appleTable ? readUint32(data + 4) : readUint16(data + 2);
+		const unsigned long subtableHeaderSize = appleTable ? 8 : 6;
+		unsigned long offset = appleTable ? 8 : 4;
+		for (unsigned long i = 0; i < numSubtables && offset + subtableHeaderSize + 8 <= tableLength; i++)
+		{
+			const unsigned char *subtable = data + offset;
+			const uint16_t coverage = readUint16(subtable + 4);
+			const unsigned long length = appleTable ? readUint32(subtable) : readUint16(subtable + 2);
+			// Vertical, cross-stream, variation and minimum value subtables are skipped
+			const unsigned int format = appleTable ? (coverage & 0xFF) : (coverage >> 8);
+			const bool horizontal = appleTable ? (coverage & 0xE000) == 0 : (coverage & 0x7) == 0x1;
+
+			// The length of a big Microsoft subtable overflows its 16 bits, the number of pairs is used instead
+			const unsigned long maxNumPairs = (tableLength - offset - subtableHeaderSize - 8) / 6;
+			unsigned long numPairs = readUint16(subtable + subtableHeaderSize);
+			numPairs = (numPairs < maxNumPairs) ? numPairs : maxNumPairs;
+
+			if (format == 0 && horizontal)
+			{
+				const unsigned char *pairs = subtable + subtableHeaderSize + 8;
+				for (unsigned long j = 0; j < numPairs; j++)
+				{
+					const unsigned int left = readUint16(pairs + j * 6);
+					const unsigned int right = readUint16(pairs + j * 6 + 2);
+					const int16_t value = static_cast<int16_t>(readUint16(pairs + j * 6 + 4));
+					if (left >= numFaceGlyphs || right >= numFaceGlyphs)
+						continue;
+
+					// Scaled to 26.6 fixed point pixels and rounded like `FT_Get_Kerning()` does
+					const int amount = static_cast<int>((FT_MulFix(value, face->size->metrics.x_scale) + 32) >> 6);
+					if (amount == 0)
+						continue;
+
+					for (int first = firstCodepoints[left]; first >= 0; first = nextCodepoints[first])
+					{
+						for (int second = firstCodepoints[right]; second >= 0; second = nextCodepoints[second])
+							atlas.addKerning(codepoints[first], codepoints[second], amount);
+					}
+				}
+			}
+
+			if (format != 0 && length == 0)
+				break;
+			const unsigned long format0Length = subtableHeaderSize + 8 + numPairs * 6;
+			offset += (format == 0 && format0Length > length) ? format0Length : length;
+		}
+
+		return true;
+	}
+
+	bool rasterizeVectorFont(const char *fontFilename, const nctl::Array<unsigned char> &fontBuffer,
+	                         const Font::DistanceFieldSettings &settings, FontAtlas &atlas)
+	{
+		ZoneScoped;
+		FT_Library library;
+		if (FT_Init_FreeType(&library) != 0)
+		{
+			LOGE("Cannot initialize the FreeType library");
+			return false;
+		}
+
+		FT_Face face;
+		if (FT_New_Memory_Face(library, fontBuffer.data(), static_cast<FT_Long>(fontBuffer.size()), 0, &face) != 0)
+		{
+			LOGE_X("Cannot open the vector font \"%s\"", fontFilename);
+			FT_Done_FreeType(library);
+			return false;
+		}
+		FT_Set_Pixel_Sizes(face, 0, settings.glyphSize);
+
+		// FreeType metrics are in 26.6 fixed point
+		const FT_Size_Metrics &metrics = face->size->metrics;
+		const int base = static_cast<int>((metrics.ascender + 32) >> 6);
+		atlas.setLineMetrics(static_cast<unsigned int>((metrics.height + 32) >> 6), static_cast<unsigned int>(base));
+
+		// Glyph identifiers are limited to the Basic Multilingual Plane
+		const unsigned int lastCodepoint = (settings.lastCodepoint < 0xFFFF) ? settings.lastCodepoint : 0xFFFF;
+		nctl::Array<unsigned int> codepoints;
+		nctl::Array<FT_UInt> glyphIndices;
+		for (unsigned int codepoint = settings.firstCodepoint; codepoint <= lastCodepoint; codepoint++)
+		{
+			const FT_UInt glyphIndex = FT_Get_Char_Index(face, codepoint);
+			if (glyphIndex == 0 || FT_Load_Glyph(face, glyphIndex, FT_LOAD_RENDER) != 0)
+				continue;
+
+			const FT_GlyphSlot slot = face->glyph;
+			const FT_Bitmap &bitmap = slot->bitmap;
+			if (bitmap.rows > 0 && (bitmap.pixel_mode != FT_PIXEL_MODE_GRAY || bitmap.pitch < 0))
+			{
+				LOGW_X("Glyph for codepoint %u of \"%s\" has an unsupported bitmap format", codepoint, fontFilename);
+				continue;
+			}
+
+			atlas.addGlyph(codepoint, bitmap.buffer, 1, static_cast<unsigned int>(bitmap.pitch), bitmap.width, bitmap.rows,
+			               slot->bitmap_left, base - slot->bitmap_top, static_cast<int>((slot->advance.x + 32) >> 6));
+			codepoints.pushBack(codepoint);
+			glyphIndices.pushBack(glyphIndex);
+		}
+
+		if (FT_HAS_KERNING(face) && readKerningTable(face, codepoints, glyphIndices, atlas) == false)
+		{
+			// Without a table to read, every pair of glyphs has to be checked
+			if (glyphIndices.size() > MaxKerningScanGlyphs)
+				LOGW_X("Kerning of \"%s\" is ignored, it has no kerning table and more than %u glyphs have been rasterized", fontFilename, MaxKerningScanGlyphs);
+			else
+			{
+				for (unsigned int i = 0; i < glyphIndices.size(); i++)
+				{
+					for (unsigned int j = 0; j < glyphIndices.size(); j++)
+					{
+						FT_Vector delta;
+						if (FT_Get_Kerning(face, glyphIndices[i], glyphIndices[j], FT_KERNING_DEFAULT, &delta) == 0 && delta.x != 0)
+							atlas.addKerning(codepoints[i], codepoints[j], static_cast<int>(delta.x / 64));
+					}
+				}
+			}
+		}
+
+		FT_Done_Face(face);
+		FT_Done_FreeType(library);
+		return true;
+	}
+#endif
+
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -22,7 +317,7 @@ Font::Font()
     : Object(ObjectType::FONT), texturePtr_(nullptr), lineHeight_(0),
       base_(0), width_(0), height_(0), numGlyphs_(0), numKernings_(0),
       glyphArray_(nctl::makeUnique<FontGlyph[]>(GlyphArraySize)),
-      glyphHashMap_(GlyphHashmapSize), renderMode_(RenderMode::GLYPH_IN_RED)
+      glyphHashMap_(GlyphHashmapSize), kerningHashMap_(KerningHashmapSize), renderMode_(RenderMode::GLYPH_IN_RED)
 {
 }
 
@@ -184,21 +479,7 @@ bool Font::loadFromFile(const char *fntFilename)
 	if (fntParser.numCharTags() == 0)
 		return false;
 
-#ifdef __ANDROID__
-	nctl::String dirName = fs::dirName(AssetFile::assetPath(fntFilename));
-
-	static nctl::String texFilename(256);
-	if (AssetFile::assetPath(fntFilename) != fntFilename)
-		texFilename.append(AssetFile::Prefix);
-	if (dirName != ".")
-		texFilename.append(fs::joinPath(dirName, fntParser.pageTag(0).file).data());
-	else
-		texFilename.append(fntParser.pageTag(0).file.data());
-#else
-	nctl::String dirName = fs::dirName(fntFilename);
-	nctl::String texFilename = fs::absoluteJoinPath(dirName, fntParser.pageTag(0).file);
-#endif
-
+	const nctl::String texFilename = fntTextureFilename(fntFilename, fntParser);
 	const bool texHasLoaded = loadTextureFromFile(texFilename.data());
 	if (texHasLoaded == false)
 		return false;
@@ -259,6 +540,131 @@ bool Font::loadFromFile(const char *fntFilename, Texture *texture)
 	return true;
 }
 
+/*! \note The atlas is generated once and then loaded from the cache, as long as the FNT file and its texture do not change */
+bool Font::loadDistanceFieldFromFile(const char *fntFilename, const DistanceFieldSettings &settings)
+{
+	ZoneScoped;
+	ZoneText(fntFilename, nctl::strnlen(fntFilename, nctl::String::MaxCStringLength));
+
+	nctl::Array<unsigned char> fntBuffer;
+	if (readFile(fntFilename, fntBuffer) == false)
+		return false;
+
+	FntParser fntParser(reinterpret_cast<const char *>(fntBuffer.data()), fntBuffer.size());
+	if (fntParser.numCharTags() == 0)
+		return false;
+
+	const FntParser::CommonTag &commonTag = fntParser.commonTag();
+	RETURNF_ASSERT_MSG_X(commonTag.pages == 1, "Multiple texture pages are not supported (pages: %d)", commonTag.pages);
+	RETURNF_ASSERT_MSG(commonTag.packed == false, "Characters packed into each of the texture channels are not supported");
+
+	const nctl::String texFilename = fntTextureFilename(fntFilename, fntParser);
+	nctl::Array<unsigned char> texBuffer;
+	if (readFile(texFilename.data(), texBuffer) == false)
+		return false;
+
+	uint64_t sourceHash = nctl::fasthash64(fntBuffer.data(), fntBuffer.size(), AtlasHashSeed);
+	sourceHash = nctl::fasthash64(texBuffer.data(), texBuffer.size(), sourceHash);
+	sourceHash = hashSettings(settings, false, sourceHash);
+
+	FontAtlas atlas(settings.spread);
+	const nctl::String cacheFilename = atlasCacheFilename(fntFilename, settings, false);
+	if (settings.withCache == false || atlas.loadFromFile(cacheFilename.data(), sourceHash) == false)
+	{
+		nctl::UniquePtr<ITextureLoader> texLoader = ITextureLoader::createFromMemory(texFilename.data(), texBuffer.data(), texBuffer.size());
+		if (texLoader->hasLoaded() == false)
+			return false;
+
+		const TextureFormat &texFormat = texLoader->texFormat();
+		RETURNF_ASSERT_MSG(texFormat.isCompressed() == false, "Compressed textures are not supported to generate a distance field");
+		RETURNF_ASSERT_MSG_X(commonTag.scaleW == texLoader->width(), "Texture width is different than FNT scale width: %u instead of %u", texLoader->width(), commonTag.scaleW);
+		RETURNF_ASSERT_MSG_X(commonTag.scaleH == texLoader->height(), "Texture height is different than FNT scale height: %u instead of %u", texLoader->height(), commonTag.scaleH);
+
+		nctl::UniquePtr<GLubyte[]> levelBuffer;
+		if (texLoader->isStreamed())
+			levelBuffer = nctl::makeUnique<GLubyte[]>(texLoader->dataSize(0));
+		const GLubyte *pixels = texLoader->levelPixels(0, levelBuffer.get());
+		if (pixels == nullptr)
+		{
+			LOGE_X("Cannot read the pixels of texture \"%s\"", texFilename.data());
+			return false;
+		}
+		const unsigned int numChannels = texFormat.numChannels();
+		const unsigned int channel = coverageChannel(commonTag, numChannels);
+		const unsigned int rowStride = texLoader->width() * numChannels;
+
+		atlas.setLineMetrics(static_cast<unsigned int>(commonTag.lineHeight), static_cast<unsigned int>(commonTag.base));
+		for (unsigned int i = 0; i < fntParser.numCharTags(); i++)
+		{
+			const FntParser::CharTag &charTag = fntParser.charTag(i);
+			if (charTag.id < 0 || charTag.x < 0 || charTag.y < 0 || charTag.width < 0 || charTag.height < 0 ||
+			    charTag.x + charTag.width > commonTag.scaleW || charTag.y + charTag.height > commonTag.scaleH)
+			{
+				LOGW_X("Glyph %d of \"%s\" is outside of the texture", charTag.id, fntFilename);
+				continue;
+			}
+
+			const GLubyte *coverage = pixels + charTag.y * rowStride + charTag.x * numChannels + channel;
+			atlas.addGlyph(static_cast<unsigned int>(charTag.id), coverage, numChannels, rowStride, static_cast<unsigned int>(charTag.width),
+			               static_cast<unsigned int>(charTag.height), charTag.xoffset, charTag.yoffset, charTag.xadvance);
+		}
+		for (unsigned int i = 0; i < fntParser.numKerningTags(); i++)
+		{
+			const FntParser::KerningTag &kerningTag = fntParser.kerningTag(i);
+			if (kerningTag.first >= 0 && kerningTag.second >= 0)
+				atlas.addKerning(static_cast<unsigned int>(kerningTag.first), static_cast<unsigned int>(kerningTag.second), kerningTag.amount);
+		}
+
+		if (atlas.pack(maxAtlasSize()) == false)
+			return false;
+		if (settings.withCache)
+			saveAtlasToCache(atlas, settings, cacheFilename, sourceHash);
+	}
+
+	setName(fntFilename);
+	retrieveInfoFromAtlas(atlas);
+	return true;
+}
+
+/*! \note The atlas is generated once and then loaded from the cache, as long as the font file does not change */
+bool Font::loadDistanceFieldFromVectorFile(const char *fontFilename, const DistanceFieldSettings &settings)
+{
+#ifdef WITH_FREETYPE
+	ZoneScoped;
+	ZoneText(fontFilename, nctl::strnlen(fontFilename, nctl::String::MaxCStringLength));
+
+	RETURNF_ASSERT_MSG(settings.glyphSize > 0, "The glyph size should be greater than zero");
+	RETURNF_ASSERT_MSG_X(settings.firstCodepoint <= settings.lastCodepoint, "The first codepoint %u is after the last one %u",
+	                     settings.firstCodepoint, settings.lastCodepoint);
+
+	nctl::Array<unsigned char> fontBuffer;
+	if (readFile(fontFilename, fontBuffer) == false)
+		return false;
+
+	uint64_t sourceHash = nctl::fasthash64(fontBuffer.data(), fontBuffer.size(), AtlasHashSeed);
+	sourceHash = hashSettings(settings, true, sourceHash);
+
+	FontAtlas atlas(settings.spread);
+	const nctl::String cacheFilename = atlasCacheFilename(fontFilename, settings, true);
+	if (settings.withCache == false || atlas.loadFromFile(cacheFilename.data(), sourceHash) == false)
+	{
+		if (rasterizeVectorFont(fontFilename, fontBuffer, settings, atlas) == false)
+			return false;
+		if (atlas.pack(maxAtlasSize()) == false)
+			return false;
+		if (settings.withCache)
+			saveAtlasToCache(atlas, settings, cacheFilename, sourceHash);
+	}
+
+	setName(fontFilename);
+	retrieveInfoFromAtlas(atlas);
+	return true;
+#else
+	LOGE_X("Vector font \"%s\" cannot be loaded without FreeType support", fontFilename);
+	return false;
+#endif
+}
+
 bool Font::setTexture(Texture *texture)
 {
 	if (texture == nullptr || texture->dataSize() == 0)
@@ -277,6 +683,15 @@ const FontGlyph *Font::glyph(unsigned int glyphId) const
 		return glyphHashMap_.find(glyphId);
 }
 
+int Font::kerning(unsigned int firstGlyphId, unsigned int secondGlyphId) const
+{
+	if (kerningHashMap_.isEmpty() || firstGlyphId > 0xFFFF || secondGlyphId > 0xFFFF)
+		return 0;
+
+	const int *amount = kerningHashMap_.find((firstGlyphId << 16) | secondGlyphId);
+	return (amount != nullptr) ? *amount : 0;
+}
+
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -389,17 +804,74 @@ void Font::retrieveInfoFromFnt(const FntParser &fntParser)
 		numGlyphs_++;
 	}
 
+	// Keeping the load factor of the kerning hashmap below one half
+	const unsigned int kerningCapacity = fntParser.numKerningTags() * 2;
+	kerningHashMap_ = nctl::HashMap<unsigned int, int>(kerningCapacity > KerningHashmapSize ? kerningCapacity : KerningHashmapSize);
 	for (unsigned int i = 0; i < fntParser.numKerningTags(); i++)
 	{
 		const FntParser::KerningTag &kerningTag = fntParser.kerningTag(i);
-		if (kerningTag.first < static_cast<int>(GlyphArraySize))
-			glyphArray_[kerningTag.first].addKerning(kerningTag.second, kerningTag.amount);
-		else
-			glyphHashMap_[kerningTag.first].addKerning(kerningTag.second, kerningTag.amount);
-		numKernings_++;
+		if (kerningTag.first < 0 || kerningTag.first > 0xFFFF || kerningTag.second < 0 || kerningTag.second > 0xFFFF)
+			continue;
+
+		const unsigned int key = (static_cast<unsigned int>(kerningTag.first) << 16) | static_cast<unsigned int>(kerningTag.second);
+		if (kerningHashMap_.insert(key, kerningTag.amount))
+			numKernings_++;
 	}
 
 	LOGI_X("FNT file information retrieved: %u glyphs and %u kernings", numGlyphs_, numKernings_);
 }
 
+void Font::retrieveInfoFromAtlas(const FontAtlas &atlas)
+{
+	lineHeight_ = atlas.lineHeight();
+	base_ = atlas.base();
+	width_ = atlas.width();
+	height_ = atlas.height();
+
+	// Discarding the glyphs and the kerning pairs of any previously loaded font
+	for (unsigned int i = 0; i < GlyphArraySize; i++)
+		glyphArray_[i].set(0, 0, 0, 0, 0, 0, 0);
+	glyphHashMap_.clear();
+	numGlyphs_ = 0;
+	numKernings_ = 0;
+
+	const unsigned int numGlyphs = (atlas.numGlyphs() < GlyphArraySize + GlyphHashmapSize) ? atlas.numGlyphs() : GlyphArraySize + GlyphHashmapSize;
+	for (unsigned int i = 0; i < numGlyphs; i++)
+	{
+		const FontAtlas::Glyph &glyph = atlas.glyph(i);
+		if (glyph.id < GlyphArraySize)
+			glyphArray_[glyph.id].set(glyph.x, glyph.y, glyph.width, glyph.height, glyph.xOffset, glyph.yOffset, glyph.xAdvance);
+		else if (glyph.id <= 0xFFFF)
+			glyphHashMap_.emplace(glyph.id, glyph.x, glyph.y, glyph.width, glyph.height, glyph.xOffset, glyph.yOffset, glyph.xAdvance);
+		else
+			continue;
+		numGlyphs_++;
+	}
+
+	// Keeping the load factor of the kerning hashmap below one half
+	const unsigned int kerningCapacity = atlas.numKernings() * 2;
+	kerningHashMap_ = nctl::HashMap<unsigned int, int>(kerningCapacity > KerningHashmapSize ? kerningCapacity : KerningHashmapSize);
+	for (unsigned int i = 0; i < atlas.numKernings(); i++)
+	{
+		const FontAtlas::Kerning &kerning = atlas.kerning(i);
+		if (kerning.first > 0xFFFF || kerning.second > 0xFFFF)
+			continue;
+
+		if (kerningHashMap_.insert((kerning.first << 16) | kerning.second, kerning.amount))
+			numKernings_++;
+	}
+
+	if (texture_ == nullptr)
+		texture_ = nctl::makeUnique<Texture>();
+	texturePtr_ = nullptr;
+	texture_->init(name(), Texture::Format::R8, static_cast<int>(width_), static_cast<int>(height_));
+	texture_->loadFromTexels(atlas.texels());
+	// The distance field needs to be interpolated between texels to reconstruct smooth edges
+	texture_->setMinFiltering(Texture::Filtering::LINEAR);
+	texture_->setMagFiltering(Texture::Filtering::LINEAR);
+
+	renderMode_ = RenderMode::GLYPH_DISTANCE_FIELD;
+	LOGI_X("Distance field atlas information retrieved: %u glyphs and %u kernings", numGlyphs_, numKernings_);
+}
+
 }
@@ -0,0 +1,432 @@
+#include <cmath> // for sqrtf()
+#include <cstring> // for memcmp() and memset()
+#include <nctl/algorithms.h>
+
+#include "common_macros.h"
+#include "FontAtlas.h"
+#include "SkylinePacker.h"
+#include "IFile.h"
+#include "FileSystem.h"
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+
+	static_assert(sizeof(FontAtlas::Header) == 40, "The font atlas header should be 40 bytes long");
+	static_assert(sizeof(FontAtlas::Glyph) == 32, "A font atlas glyph should be 32 bytes long");
+	static_assert(sizeof(FontAtlas::Kerning) == 12, "A font atlas kerning pair should be 12 bytes long");
+
+	/// A distance bigger than any other in a glyph field, it marks the pixels that are not part of the feature
+	const float Infinity = 1e20f;
+	/// The empty space in pixels between two glyphs in the atlas
+	const unsigned int GlyphGap = 1;
+	/// The minimum size of the atlas in both dimensions
+	const unsigned int MinAtlasSize = 64;
+
+	unsigned int nextPowerOfTwo(unsigned int value)
+	{
+		unsigned int powerOfTwo = 1;
+		while (powerOfTwo < value)
+			powerOfTwo <<= 1;
+		return powerOfTwo;
+	}
+
+	/// Encodes a signed distance in pixels, positive inside the glyph, as a byte with the edge at one half
+	unsigned char encodeDistance(float distance, unsigned int spread)
+	{
+		const float value = 255.0f * (0.5f + distance / (2.0f * spread));
+		if (value <= 0.0f)
+			return 0;
+		else if (value >= 255.0f)
+			return 255;
+		return static_cast<unsigned char>(value + 0.5f);
+	}
+
+	int32_t signedInt32FromLE(int32_t number)
+	{
+		return static_cast<int32_t>(IFile::int32FromLE(static_cast<uint32_t>(number)));
+	}
+
+	/// Converts a glyph between the little endian order of the cache file and the native one, the conversion is symmetric
+	FontAtlas::Glyph glyphFromLE(const FontAtlas::Glyph &glyph)
+	{
+		const FontAtlas::Glyph converted = { IFile::int32FromLE(glyph.id), IFile::int32FromLE(glyph.x), IFile::int32FromLE(glyph.y),
+			                                 IFile::int32FromLE(glyph.width), IFile::int32FromLE(glyph.height),
+			                                 signedInt32FromLE(glyph.xOffset), signedInt32FromLE(glyph.yOffset), signedInt32FromLE(glyph.xAdvance) };
+		return converted;
+	}
+
+	/// Converts a kerning pair between the little endian order of the cache file and the native one
+	FontAtlas::Kerning kerningFromLE(const FontAtlas::Kerning &kerning)
+	{
+		const FontAtlas::Kerning converted = { IFile::int32FromLE(kerning.first), IFile::int32FromLE(kerning.second), signedInt32FromLE(kerning.amount) };
+		return converted;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const char FontAtlas::Signature[4] = { 'N', 'C', 'D', 'F' };
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FontAtlas::FontAtlas(unsigned int spread)
+    : spread_(spread), lineHeight_(0), base_(0), width_(0), height_(0)
+{
+	ASSERT(spread > 0);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FontAtlas::setLineMetrics(unsigned int lineHeight, unsigned int base)
+{
+	lineHeight_ = lineHeight;
+	base_ = base;
+}
+
+/*! The transform follows the approach of Felzenszwalb and Huttenlocher, with the anti-aliased coverage of edge pixels
+ *  used to place the edge inside them instead of on their boundaries. */
+void FontAtlas::addGlyph(unsigned int id, const unsigned char *coverage, unsigned int pixelStride, unsigned int rowStride,
+                         unsigned int width, unsigned int height, int xOffset, int yOffset, int xAdvance)
+{
+	ZoneScoped;
+	// Glyphs with no pixels, like the space, only advance the pen
+	if (width == 0 || height == 0)
+	{
+		const Glyph glyph = { id, 0, 0, 0, 0, xOffset, yOffset, xAdvance };
+		glyphs_.pushBack(glyph);
+		fieldOffsets_.pushBack(fields_.size());
+		return;
+	}
+
+	ASSERT(coverage);
+	const unsigned int paddedWidth = width + 2 * spread_;
+	const unsigned int paddedHeight = height + 2 * spread_;
+	const unsigned int numPixels = paddedWidth * paddedHeight;
+
+	outerGrid_.setSize(numPixels);
+	innerGrid_.setSize(numPixels);
+	for (unsigned int i = 0; i < numPixels; i++)
+	{
+		outerGrid_[i] = Infinity;
+		innerGrid_[i] = 0.0f;
+	}
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned char *row = coverage + y * rowStride;
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const unsigned int index = (y + spread_) * paddedWidth + x + spread_;
+			const unsigned char value = row[x * pixelStride];
+			if (value == 255)
+			{
+				outerGrid_[index] = 0.0f;
+				innerGrid_[index] = Infinity;
+			}
+			else if (value > 0)
+			{
+				// The edge is inside a partially covered pixel, at a distance that depends on the coverage
+				const float distance = 0.5f - value / 255.0f;
+				outerGrid_[index] = (distance > 0.0f) ? distance * distance : 0.0f;
+				innerGrid_[index] = (distance < 0.0f) ? distance * distance : 0.0f;
+			}
+		}
+	}
+
+	distanceTransform(outerGrid_.data(), paddedWidth, paddedHeight);
+	distanceTransform(innerGrid_.data(), paddedWidth, paddedHeight);
+
+	const unsigned int fieldOffset = fields_.size();
+	fields_.setSize(fieldOffset + numPixels);
+	unsigned char *field = fields_.data() + fieldOffset;
+	for (unsigned int i = 0; i < numPixels; i++)
+		field[i] = encodeDistance(sqrtf(innerGrid_[i]) - sqrtf(outerGrid_[i]), spread_);
+
+	const int spread = static_cast<int>(spread_);
+	const Glyph glyph = { id, 0, 0, paddedWidth, paddedHeight, xOffset - spread, yOffset - spread, xAdvance };
+	glyphs_.pushBack(glyph);
+	fieldOffsets_.pushBack(fieldOffset);
+}
+
+void FontAtlas::addKerning(unsigned int first, unsigned int second, int amount)
+{
+	const Kerning kerning = { first, second, amount };
+	kernings_.pushBack(kerning);
+}
+
+bool FontAtlas::pack(unsigned int maxSize)
+{
+	ZoneScoped;
+	if (glyphs_.isEmpty())
+	{
+		LOGE("There are no glyphs to pack in the font atlas");
+		return false;
+	}
+
+	// Taller glyphs are packed first, they leave less space unused below the skyline
+	nctl::Array<unsigned int> order(glyphs_.size());
+	unsigned long totalArea = 0;
+	unsigned int maxGlyphWidth = 0;
+	unsigned int maxGlyphHeight = 0;
+	for (unsigned int i = 0; i < glyphs_.size(); i++)
+	{
+		const Glyph &glyph = glyphs_[i];
+		order.pushBack(i);
+		totalArea += static_cast<unsigned long>(glyph.width + GlyphGap) * (glyph.height + GlyphGap);
+		if (glyph.width > maxGlyphWidth)
+			maxGlyphWidth = glyph.width;
+		if (glyph.height > maxGlyphHeight)
+			maxGlyphHeight = glyph.height;
+	}
+	nctl::quicksort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+		return (glyphs_[a].height != glyphs_[b].height) ? glyphs_[a].height > glyphs_[b].height : glyphs_[a].width > glyphs_[b].width;
+	});
+
+	unsigned int width = nextPowerOfTwo(maxGlyphWidth + GlyphGap);
+	unsigned int height = nextPowerOfTwo(maxGlyphHeight + GlyphGap);
+	width = (width > MinAtlasSize) ? width : MinAtlasSize;
+	height = (height > MinAtlasSize) ? height : MinAtlasSize;
+	// Doubling the narrower dimension until the atlas is big enough to contain the area of all glyphs
+	while (static_cast<unsigned long>(width) * height < totalArea)
+	{
+		if (width <= height)
+			width *= 2;
+		else
+			height *= 2;
+	}
+
+	nctl::Array<Vector2i> positions(glyphs_.size());
+	positions.setSize(glyphs_.size());
+	SkylinePacker packer(width, height);
+	while (width <= maxSize && height <= maxSize)
+	{
+		bool allPacked = true;
+		for (unsigned int i = 0; i < order.size(); i++)
+		{
+			const Glyph &glyph = glyphs_[order[i]];
+			if (glyph.width == 0 || glyph.height == 0)
+				continue;
+
+			if (packer.insert(glyph.width + GlyphGap, glyph.height + GlyphGap, positions[order[i]]) == false)
+			{
+				allPacked = false;
+				break;
+			}
+		}
+
+		if (allPacked)
+			break;
+
+		if (width <= height)
+			width *= 2;
+		else
+			height *= 2;
+		packer.reset(width, height);
+	}
+
+	if (width > maxSize || height > maxSize)
+	{
+		LOGE_X("The %u glyphs do not fit in a font atlas of %u x %u pixels", glyphs_.size(), maxSize, maxSize);
+		return false;
+	}
+
+	width_ = width;
+	height_ = height;
+	texels_.setSize(width * height);
+	memset(texels_.data(), 0, width * height);
+	for (unsigned int i = 0; i < glyphs_.size(); i++)
+	{
+		Glyph &glyph = glyphs_[i];
+		if (glyph.width == 0 || glyph.height == 0)
+			continue;
+
+		glyph.x = static_cast<uint32_t>(positions[i].x);
+		glyph.y = static_cast<uint32_t>(positions[i].y);
+		const unsigned char *field = fields_.data() + fieldOffsets_[i];
+		for (unsigned int y = 0; y < glyph.height; y++)
+			memcpy(texels_.data() + (glyph.y + y) * width + glyph.x, field + y * glyph.width, glyph.width);
+	}
+
+	LOGI_X("Font atlas of %u x %u pixels packed with %u glyphs, %.1f%% of its area is used",
+	       width_, height_, glyphs_.size(), 100.0f * packer.usedArea() / (width_ * height_));
+
+	fields_.clear();
+	fieldOffsets_.clear();
+	return true;
+}
+
+bool FontAtlas::saveToFile(const char *filename, uint64_t sourceHash) const
+{
+	ASSERT(filename);
+	ASSERT(width_ > 0 && height_ > 0);
+
+	// Numbers are converted to little endian, the same functions used when reading work in both directions
+	Header header = {};
+	memcpy(header.signature, Signature, sizeof(header.signature));
+	header.version = IFile::int16FromLE(Version);
+	header.spread = IFile::int16FromLE(static_cast<uint16_t>(spread_));
+	header.sourceHash = IFile::int64FromLE(sourceHash);
+	header.width = IFile::int32FromLE(width_);
+	header.height = IFile::int32FromLE(height_);
+	header.lineHeight = IFile::int32FromLE(lineHeight_);
+	header.base = IFile::int32FromLE(base_);
+	header.numGlyphs = IFile::int32FromLE(glyphs_.size());
+	header.numKernings = IFile::int32FromLE(kernings_.size());
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	unsigned long int numBytes = fileHandle->write(&header, sizeof(Header));
+	for (const Glyph &glyph : glyphs_)
+	{
+		const Glyph leGlyph = glyphFromLE(glyph);
+		numBytes += fileHandle->write(&leGlyph, sizeof(Glyph));
+	}
+	for (const Kerning &kerning : kernings_)
+	{
+		const Kerning leKerning = kerningFromLE(kerning);
+		numBytes += fileHandle->write(&leKerning, sizeof(Kerning));
+	}
+	numBytes += fileHandle->write(texels_.data(), width_ * height_);
+
+	const unsigned long int expectedSize = sizeof(Header) + glyphs_.size() * sizeof(Glyph) + kernings_.size() * sizeof(Kerning) + width_ * height_;
+	return (numBytes == expectedSize);
+}
+
+bool FontAtlas::loadFromFile(const char *filename, uint64_t sourceHash)
+{
+	ZoneScoped;
+	ASSERT(filename);
+
+	// A missing cache file is not an error, the atlas has just not been generated yet
+	if (fs::isFile(filename) == false)
+		return false;
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	Header header;
+	const unsigned long int fileSize = static_cast<unsigned long int>(fileHandle->size());
+	if (fileSize < sizeof(Header) || fileHandle->read(&header, sizeof(Header)) != sizeof(Header) ||
+	    memcmp(header.signature, Signature, sizeof(header.signature)) != 0)
+	{
+		LOGW_X("File \"%s\" is not a valid font atlas", filename);
+		return false;
+	}
+
+	// A stale atlas is silently regenerated
+	if (IFile::int16FromLE(header.version) != Version || IFile::int16FromLE(header.spread) != spread_ ||
+	    IFile::int64FromLE(header.sourceHash) != sourceHash)
+	{
+		return false;
+	}
+
+	const unsigned int width = IFile::int32FromLE(header.width);
+	const unsigned int height = IFile::int32FromLE(header.height);
+	const unsigned int numGlyphs = IFile::int32FromLE(header.numGlyphs);
+	const unsigned int numKernings = IFile::int32FromLE(header.numKernings);
+	const uint64_t expectedSize = sizeof(Header) + static_cast<uint64_t>(numGlyphs) * sizeof(Glyph) +
+	                              static_cast<uint64_t>(numKernings) * sizeof(Kerning) + static_cast<uint64_t>(width) * height;
+	if (expectedSize != fileSize)
+	{
+		LOGW_X("Font atlas \"%s\" is truncated or corrupted", filename);
+		return false;
+	}
+
+	glyphs_.setSize(numGlyphs);
+	kernings_.setSize(numKernings);
+	texels_.setSize(width * height);
+	fileHandle->read(glyphs_.data(), numGlyphs * sizeof(Glyph));
+	if (numKernings > 0)
+		fileHandle->read(kernings_.data(), numKernings * sizeof(Kerning));
+	fileHandle->read(texels_.data(), width * height);
+
+	for (Glyph &glyph : glyphs_)
+		glyph = glyphFromLE(glyph);
+	for (Kerning &kerning : kernings_)
+		kerning = kerningFromLE(kerning);
+
+	width_ = width;
+	height_ = height;
+	lineHeight_ = IFile::int32FromLE(header.lineHeight);
+	base_ = IFile::int32FromLE(header.base);
+	fields_.clear();
+	fieldOffsets_.clear();
+
+	LOGI_X("Font atlas of %u x %u pixels with %u glyphs loaded from \"%s\"", width_, height_, numGlyphs, filename);
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FontAtlas::distanceTransform(float *grid, unsigned int width, unsigned int height)
+{
+	const unsigned int maxLength = (width > height) ? width : height;
+	sampledFunction_.setSize(maxLength);
+	parabolaVertices_.setSize(maxLength);
+	parabolaBoundaries_.setSize(maxLength + 1);
+
+	for (unsigned int x = 0; x < width; x++)
+		distanceTransform(grid, x, width, height);
+	for (unsigned int y = 0; y < height; y++)
+		distanceTransform(grid, y * width, 1, width);
+}
+
+/*! The lower envelope of the parabolas rooted at every sample is computed first, then it is sampled again. */
+void FontAtlas::distanceTransform(float *grid, unsigned int offset, unsigned int stride, unsigned int length)
+{
+	float *f = sampledFunction_.data();
+	int *v = parabolaVertices_.data();
+	float *z = parabolaBoundaries_.data();
+
+	v[0] = 0;
+	z[0] = -Infinity;
+	z[1] = Infinity;
+	f[0] = grid[offset];
+
+	int k = 0;
+	for (unsigned int q = 1; q < length; q++)
+	{
+		f[q] = grid[offset + q * stride];
+		const float q2 = static_cast<float>(q * q);
+
+		float s = 0.0f;
+		do
+		{
+			const int r = v[k];
+			s = (f[q] - f[r] + q2 - static_cast<float>(r * r)) / (static_cast<float>(q) - r) * 0.5f;
+		} while (s <= z[k] && --k > -1);
+
+		k++;
+		v[k] = static_cast<int>(q);
+		z[k] = s;
+		z[k + 1] = Infinity;
+	}
+
+	k = 0;
+	for (unsigned int q = 0; q < length; q++)
+	{
+		while (z[k + 1] < q)
+			k++;
+		const int r = v[k];
+		const float qr = static_cast<float>(static_cast<int>(q) - r);
+		grid[offset + q * stride] = f[r] + qr * qr;
+	}
+}
+
+}
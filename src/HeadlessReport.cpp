@@ -0,0 +1,180 @@
+#include "common_macros.h"
+#include "HeadlessReport.h"
+#include "RenderStatistics.h"
+#include "AllocationCounter.h"
+#include "NullGL.h"
+#include "IFile.h"
+#include <nctl/algorithms.h>
+
+namespace ncine {
+
+namespace {
+
+	const char *FrameTimingNames[] = { "frame_start", "update_visit_draw", "update", "post_update",
+		                               "visit", "draw", "imgui", "nuklear", "frame_end" };
+
+	/// Returns the sample at the specified fraction of an array sorted in ascending order
+	float percentile(const nctl::Array<float> &sorted, float fraction)
+	{
+		const unsigned int index = static_cast<unsigned int>((sorted.size() - 1) * fraction + 0.5f);
+		return sorted[index];
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+HeadlessReport::HeadlessReport(unsigned int numFrames)
+{
+	static_assert(sizeof(FrameTimingNames) / sizeof(*FrameTimingNames) == NumFrameTimings, "Missing frame timing names");
+
+	// Reserving all the space in advance avoids allocations between the sampled frames
+	const unsigned int capacity = (numFrames > 0) ? numFrames : 1024;
+	frameTimes_.setCapacity(capacity);
+	for (unsigned int i = 0; i < NumFrameTimings; i++)
+		frameTimings_[i].setCapacity(capacity);
+
+	for (unsigned int i = 0; i < Counters::COUNT; i++)
+	{
+		counterSums_[i] = 0;
+		counterMaxs_[i] = 0;
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void HeadlessReport::addFrame()
+{
+	const Application &application = theApplication();
+	frameTimes_.pushBack(application.interval());
+	for (unsigned int i = 0; i < NumFrameTimings; i++)
+		frameTimings_[i].pushBack(application.timings()[FirstFrameTiming + i]);
+
+	const RenderStatistics::Commands &commands = RenderStatistics::allCommands();
+	addCounter(Counters::COMMANDS, commands.commands);
+	addCounter(Counters::TRANSPARENTS, commands.transparents);
+	addCounter(Counters::VERTICES, commands.vertices);
+	addCounter(Counters::INSTANCES, commands.instances);
+	addCounter(Counters::CULLED_NODES, RenderStatistics::culled());
+
+	const NullGL::Counters glCounters = NullGL::lastFrame();
+	addCounter(Counters::GL_CALLS, glCounters.numCalls);
+	addCounter(Counters::GL_DRAW_CALLS, glCounters.numDrawCalls);
+	addCounter(Counters::GL_INSTANCES, glCounters.numInstances);
+	addCounter(Counters::GL_VERTICES, glCounters.numVertices);
+	addCounter(Counters::GL_UPLOADED_BYTES, glCounters.uploadedBytes);
+	addCounter(Counters::GL_MAPPINGS, glCounters.numMappings);
+
+	const AllocationCounter::Counters allocations = AllocationCounter::lastFrame();
+	addCounter(Counters::ALLOCATIONS, allocations.numAllocations);
+	addCounter(Counters::ALLOCATED_BYTES, allocations.bytes);
+}
+
+bool HeadlessReport::write(const char *filename) const
+{
+	ASSERT(filename);
+
+	Application &application = theApplication();
+	const float *timings = application.timings();
+
+	nctl::String json(4096);
+	json.format("{\n\t\"frames\": %u,\n", numFrames());
+	json.formatAppend("\t\"resolution\": [%d, %d],\n", application.gfxDevice().width(), application.gfxDevice().height());
+
+	json.append("\t\"init_timings_ms\": {\n");
+	json.formatAppend("\t\t\"pre_init\": %.3f,\n", timings[Application::Timings::PRE_INIT] * 1000.0f);
+	json.formatAppend("\t\t\"init_common\": %.3f,\n", timings[Application::Timings::INIT_COMMON] * 1000.0f);
+	json.formatAppend("\t\t\"app_init\": %.3f\n", timings[Application::Timings::APP_INIT] * 1000.0f);
+	json.append("\t},\n");
+
+	json.append("\t\"frame_timings_ms\": {\n");
+	appendSeries(json, "frame", frameTimes_, false);
+	for (unsigned int i = 0; i < NumFrameTimings; i++)
+		appendSeries(json, FrameTimingNames[i], frameTimings_[i], i == NumFrameTimings - 1);
+	json.append("\t},\n");
+
+	json.append("\t\"render_statistics\": {\n");
+	appendCounter(json, "commands", Counters::COMMANDS, false);
+	appendCounter(json, "transparents", Counters::TRANSPARENTS, false);
+	appendCounter(json, "vertices", Counters::VERTICES, false);
+	appendCounter(json, "instances", Counters::INSTANCES, false);
+	appendCounter(json, "culled_nodes", Counters::CULLED_NODES, true);
+	json.append("\t},\n");
+
+	json.append("\t\"null_gl\": {\n");
+	appendCounter(json, "calls", Counters::GL_CALLS, false);
+	appendCounter(json, "draw_calls", Counters::GL_DRAW_CALLS, false);
+	appendCounter(json, "instances", Counters::GL_INSTANCES, false);
+	appendCounter(json, "vertices", Counters::GL_VERTICES, false);
+	appendCounter(json, "uploaded_bytes", Counters::GL_UPLOADED_BYTES, false);
+	appendCounter(json, "mappings", Counters::GL_MAPPINGS, true);
+	json.append("\t},\n");
+
+	json.append("\t\"allocations\": {\n");
+	json.formatAppend("\t\t\"available\": %s,\n", AllocationCounter::isAvailable() ? "true" : "false");
+	appendCounter(json, "count", Counters::ALLOCATIONS, false);
+	appendCounter(json, "bytes", Counters::ALLOCATED_BYTES, true);
+	json.append("\t}\n}\n");
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->open(IFile::OpenMode::WRITE);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGE_X("Cannot write the headless report to \"%s\"", filename);
+		return false;
+	}
+
+	fileHandle->write(json.data(), json.length());
+	LOGI_X("Headless report of %u frames written to \"%s\"", numFrames(), filename);
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void HeadlessReport::addCounter(Counters::Enum counter, unsigned long value)
+{
+	counterSums_[counter] += value;
+	if (value > counterMaxs_[counter])
+		counterMaxs_[counter] = value;
+}
+
+void HeadlessReport::appendSeries(nctl::String &json, const char *name, const nctl::Array<float> &samples, bool isLast) const
+{
+	float min = 0.0f;
+	float average = 0.0f;
+	float median = 0.0f;
+	float p95 = 0.0f;
+	float max = 0.0f;
+
+	if (samples.isEmpty() == false)
+	{
+		nctl::Array<float> sorted(samples);
+		nctl::quicksort(sorted.begin(), sorted.end());
+
+		for (unsigned int i = 0; i < sorted.size(); i++)
+			average += sorted[i];
+		average /= sorted.size();
+
+		min = sorted.front();
+		median = percentile(sorted, 0.5f);
+		p95 = percentile(sorted, 0.95f);
+		max = sorted.back();
+	}
+
+	json.formatAppend("\t\t\"%s\": { \"min\": %.4f, \"avg\": %.4f, \"median\": %.4f, \"p95\": %.4f, \"max\": %.4f }%s\n",
+	                  name, min * 1000.0f, average * 1000.0f, median * 1000.0f, p95 * 1000.0f, max * 1000.0f, isLast ? "" : ",");
+}
+
+void HeadlessReport::appendCounter(nctl::String &json, const char *name, Counters::Enum counter, bool isLast) const
+{
+	const double average = (numFrames() > 0) ? counterSums_[counter] / static_cast<double>(numFrames()) : 0.0;
+	json.formatAppend("\t\t\"%s\": { \"avg\": %.2f, \"max\": %lu }%s\n", name, average, counterMaxs_[counter], isLast ? "" : ",");
+}
+
+}
@@ -2,6 +2,8 @@
 #include "IFile.h"
 #include "MemoryFile.h"
 #include "StandardFile.h"
+#include "MappedFile.h"
+#include "AssetArchive.h"
 
 #ifdef __ANDROID__
 	#include <cstring>
@@ -66,6 +68,10 @@ nctl::UniquePtr<IFile> IFile::createFromMemory(const unsigned char *bufferPtr, u
 nctl::UniquePtr<IFile> IFile::createFileHandle(const char *filename)
 {
 	ASSERT(filename);
+	nctl::UniquePtr<IFile> archiveFile = AssetArchive::createFileHandle(filename);
+	if (archiveFile)
+		return archiveFile;
+
 #ifdef __ANDROID__
 	const char *assetFilename = AssetFile::assetPath(filename);
 	if (assetFilename)
@@ -75,4 +81,20 @@ nctl::UniquePtr<IFile> IFile::createFileHandle(const char *filename)
 		return nctl::makeUnique<StandardFile>(filename);
 }
 
+nctl::UniquePtr<IFile> IFile::createMappedFileHandle(const char *filename)
+{
+	ASSERT(filename);
+	nctl::UniquePtr<IFile> archiveFile = AssetArchive::createFileHandle(filename);
+	if (archiveFile)
+		return archiveFile;
+
+#ifdef __ANDROID__
+	const char *assetFilename = AssetFile::assetPath(filename);
+	if (assetFilename)
+		return nctl::makeUnique<AssetFile>(assetFilename);
+	else
+#endif
+		return nctl::makeUnique<MappedFile>(filename);
+}
+
 }
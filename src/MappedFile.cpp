@@ -0,0 +1,227 @@
+#ifdef _WIN32
+	#include "common_windefines.h"
+	#include <windef.h>
+	#include <WinBase.h>
+	#include <fileapi.h>
+	#include <handleapi.h>
+	#include <memoryapi.h>
+#else
+	#include <sys/stat.h> // for open() and fstat()
+	#include <sys/mman.h> // for mmap()
+	#include <fcntl.h> // for open()
+	#include <unistd.h> // for close()
+#endif
+#include <cstring> // for memcpy()
+
+#include "common_macros.h"
+#include "MappedFile.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(const char *filename)
+    : IFile(filename), mappedData_(nullptr), seekOffset_(0), isOpened_(false)
+#ifdef _WIN32
+      ,
+      fileHandle_(INVALID_HANDLE_VALUE), mappingHandle_(nullptr)
+#endif
+{
+	type_ = FileType::MAPPED;
+}
+
+MappedFile::~MappedFile()
+{
+	if (shouldCloseOnDestruction_)
+		close();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void MappedFile::open(unsigned char mode)
+{
+	// Checking if the file is already opened
+	if (isOpened_)
+	{
+		LOGW_X("File \"%s\" is already opened", filename_.data());
+		return;
+	}
+	else if (mode & OpenMode::WRITE || (mode & OpenMode::READ) == 0)
+	{
+		LOGE_X("Cannot open the file \"%s\", wrong open mode", filename_.data());
+		return;
+	}
+
+#ifdef _WIN32
+	fileHandle_ = CreateFileA(filename_.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle_ == INVALID_HANDLE_VALUE)
+	{
+		LOGE_X("Cannot open the file \"%s\"", filename_.data());
+		return;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(fileHandle_, &fileSize) == 0)
+	{
+		LOGE_X("Cannot get the size of the file \"%s\"", filename_.data());
+		CloseHandle(fileHandle_);
+		fileHandle_ = INVALID_HANDLE_VALUE;
+		return;
+	}
+	fileSize_ = static_cast<unsigned long int>(fileSize.QuadPart);
+
+	// Empty files cannot be mapped but they are still valid
+	if (fileSize_ > 0)
+	{
+		mappingHandle_ = CreateFileMappingA(fileHandle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle_ != nullptr)
+			mappedData_ = static_cast<const unsigned char *>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+
+		if (mappedData_ == nullptr)
+		{
+			LOGE_X("Cannot map the file \"%s\"", filename_.data());
+			if (mappingHandle_ != nullptr)
+				CloseHandle(mappingHandle_);
+			CloseHandle(fileHandle_);
+			mappingHandle_ = nullptr;
+			fileHandle_ = INVALID_HANDLE_VALUE;
+			fileSize_ = 0;
+			return;
+		}
+	}
+#else
+	fileDescriptor_ = ::open(filename_.data(), O_RDONLY);
+	if (fileDescriptor_ < 0)
+	{
+		LOGE_X("Cannot open the file \"%s\"", filename_.data());
+		return;
+	}
+
+	struct stat fileStat;
+	if (fstat(fileDescriptor_, &fileStat) < 0)
+	{
+		LOGE_X("Cannot get the size of the file \"%s\"", filename_.data());
+		::close(fileDescriptor_);
+		fileDescriptor_ = -1;
+		return;
+	}
+	fileSize_ = static_cast<unsigned long int>(fileStat.st_size);
+
+	// Empty files cannot be mapped but they are still valid
+	if (fileSize_ > 0)
+	{
+		void *mapping = mmap(nullptr, fileSize_, PROT_READ, MAP_PRIVATE, fileDescriptor_, 0);
+		if (mapping == MAP_FAILED)
+		{
+			LOGE_X("Cannot map the file \"%s\"", filename_.data());
+			::close(fileDescriptor_);
+			fileDescriptor_ = -1;
+			fileSize_ = 0;
+			return;
+		}
+		mappedData_ = static_cast<const unsigned char *>(mapping);
+	}
+#endif
+
+	LOGI_X("File \"%s\" opened and mapped", filename_.data());
+	seekOffset_ = 0;
+	isOpened_ = true;
+}
+
+void MappedFile::close()
+{
+	if (isOpened_ == false)
+		return;
+
+#ifdef _WIN32
+	if (mappedData_)
+		UnmapViewOfFile(mappedData_);
+	if (mappingHandle_ != nullptr)
+		CloseHandle(mappingHandle_);
+	CloseHandle(fileHandle_);
+	mappingHandle_ = nullptr;
+	fileHandle_ = INVALID_HANDLE_VALUE;
+#else
+	if (mappedData_)
+		munmap(const_cast<unsigned char *>(mappedData_), fileSize_);
+	const int retValue = ::close(fileDescriptor_);
+	if (retValue < 0)
+		LOGW_X("Cannot close the file \"%s\"", filename_.data());
+	fileDescriptor_ = -1;
+#endif
+
+	LOGI_X("File \"%s\" unmapped and closed", filename_.data());
+	mappedData_ = nullptr;
+	seekOffset_ = 0;
+	isOpened_ = false;
+}
+
+/*! Like `fseek()` it returns zero on success, as expected by the Ogg Vorbis callbacks */
+long int MappedFile::seek(long int offset, int whence) const
+{
+	long int seekValue = -1;
+
+	if (isOpened_)
+	{
+		switch (whence)
+		{
+			case SEEK_SET:
+				seekValue = offset;
+				break;
+			case SEEK_CUR:
+				seekValue = seekOffset_ + offset;
+				break;
+			case SEEK_END:
+				seekValue = fileSize_ + offset;
+				break;
+		}
+	}
+
+	if (seekValue < 0 || seekValue > static_cast<long int>(fileSize_))
+		return -1;
+
+	seekOffset_ = seekValue;
+	return 0;
+}
+
+long int MappedFile::tell() const
+{
+	long int tellValue = -1;
+
+	if (isOpened_)
+		tellValue = seekOffset_;
+
+	return tellValue;
+}
+
+unsigned long int MappedFile::read(void *buffer, unsigned long int bytes) const
+{
+	ASSERT(buffer);
+
+	unsigned long int bytesRead = 0;
+
+	if (isOpened_ && mappedData_)
+	{
+		bytesRead = (seekOffset_ + bytes > fileSize_) ? fileSize_ - seekOffset_ : bytes;
+		memcpy(buffer, mappedData_ + seekOffset_, bytesRead);
+		seekOffset_ += bytesRead;
+	}
+
+	return bytesRead;
+}
+
+unsigned long int MappedFile::write(const void *buffer, unsigned long int bytes)
+{
+	return 0;
+}
+
+bool MappedFile::isOpened() const
+{
+	return isOpened_;
+}
+
+}
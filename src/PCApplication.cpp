@@ -1,9 +1,14 @@
+#include <cstdlib> // for EXIT_FAILURE
 #include "PCApplication.h"
 #include "IAppEventHandler.h"
 #include "FileLogger.h"
 #include "FileSystem.h"
+#include "HeadlessReport.h"
 
-#if defined(WITH_SDL)
+#if defined(WITH_NULL_GFX)
+	#include "NullGfxDevice.h"
+	#include "NullInputManager.h"
+#elif defined(WITH_SDL)
 	#include "SdlGfxDevice.h"
 	#include "SdlInputManager.h"
 	#ifdef WITH_NUKLEAR
@@ -31,6 +36,17 @@ Application &theApplication()
 	return instance;
 }
 
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+PCApplication::PCApplication()
+    : Application(), wasSuspended_(false), qt5Widget_(nullptr)
+{
+}
+
+PCApplication::~PCApplication() = default;
+
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -47,10 +63,16 @@ int PCApplication::start(nctl::UniquePtr<IAppEventHandler> (*createAppEventHandl
 #else
 	emscripten_set_main_loop(PCApplication::emscriptenStep, 0, 1);
 	emscripten_set_main_loop_timing(EM_TIMING_RAF, 1);
+#endif
+#if defined(WITH_NULL_GFX)
+	// A headless run is unattended, a report that cannot be written makes it fail
+	if (app.appCfg_.headlessReportFile.isEmpty() == false &&
+	    app.headlessReport_->write(app.appCfg_.headlessReportFile.data()) == false)
+		app.exitCode_ = EXIT_FAILURE;
 #endif
 	app.shutdownCommon();
 
-	return EXIT_SUCCESS;
+	return app.exitCode_;
 }
 
 ///////////////////////////////////////////////////////////
@@ -85,7 +107,11 @@ void PCApplication::init(nctl::UniquePtr<IAppEventHandler> (*createAppEventHandl
 	DisplayMode displayMode(8, 8, 8, 8, 24, 8, DisplayMode::DoubleBuffering::ENABLED, vSyncMode);
 
 	const IGfxDevice::WindowMode windowMode(appCfg_);
-#if defined(WITH_SDL)
+#if defined(WITH_NULL_GFX)
+	gfxDevice_ = nctl::makeUnique<NullGfxDevice>(windowMode, glContextInfo, displayMode);
+	inputManager_ = nctl::makeUnique<NullInputManager>();
+	headlessReport_ = nctl::makeUnique<HeadlessReport>(appCfg_.headlessFrames);
+#elif defined(WITH_SDL)
 	gfxDevice_ = nctl::makeUnique<SdlGfxDevice>(windowMode, glContextInfo, displayMode);
 	inputManager_ = nctl::makeUnique<SdlInputManager>();
 #elif defined(WITH_GLFW)
@@ -128,10 +154,22 @@ void PCApplication::run()
 	}
 
 	if (suspended == false)
+	{
 		step();
+#if defined(WITH_NULL_GFX)
+		headlessReport_->addFrame();
+		if (appCfg_.headlessFrames > 0 && headlessReport_->numFrames() >= appCfg_.headlessFrames)
+			shouldQuit_ = true;
+#endif
+	}
 }
 
-#if defined(WITH_SDL)
+#if defined(WITH_NULL_GFX)
+void PCApplication::processEvents()
+{
+	// The null graphics device has no window and no events to process
+}
+#elif defined(WITH_SDL)
 void PCApplication::processEvents()
 {
 	ZoneScoped;
@@ -0,0 +1,132 @@
+#include "common_macros.h"
+#include "SkylinePacker.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height)
+    : width_(0), height_(0), usedArea_(0), skyline_(16)
+{
+	reset(width, height);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SkylinePacker::reset(unsigned int width, unsigned int height)
+{
+	ASSERT(width > 0 && height > 0);
+
+	width_ = width;
+	height_ = height;
+	usedArea_ = 0;
+	skyline_.clear();
+	skyline_.pushBack(Segment(0, 0, width));
+}
+
+bool SkylinePacker::insert(unsigned int width, unsigned int height, Vector2i &position)
+{
+	if (width == 0 || height == 0)
+	{
+		position.set(0, 0);
+		return true;
+	}
+
+	int bestIndex = -1;
+	unsigned int bestBottom = 0;
+	unsigned int bestWidth = 0;
+	for (unsigned int i = 0; i < skyline_.size(); i++)
+	{
+		const int y = fitsAt(i, width, height);
+		if (y < 0)
+			continue;
+
+		const unsigned int bottom = static_cast<unsigned int>(y) + height;
+		if (bestIndex < 0 || bottom < bestBottom || (bottom == bestBottom && skyline_[i].width < bestWidth))
+		{
+			bestIndex = static_cast<int>(i);
+			bestBottom = bottom;
+			bestWidth = skyline_[i].width;
+		}
+	}
+
+	if (bestIndex < 0)
+		return false;
+
+	const unsigned int x = skyline_[bestIndex].x;
+	const unsigned int y = bestBottom - height;
+	addSegment(static_cast<unsigned int>(bestIndex), x, y, width, height);
+	usedArea_ += static_cast<unsigned long>(width) * height;
+
+	position.set(static_cast<int>(x), static_cast<int>(y));
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int SkylinePacker::fitsAt(unsigned int segmentIndex, unsigned int width, unsigned int height) const
+{
+	const unsigned int x = skyline_[segmentIndex].x;
+	if (x + width > width_)
+		return -1;
+
+	// The rectangle rests on the highest segment among the ones it spans
+	unsigned int y = 0;
+	unsigned int widthLeft = width;
+	for (unsigned int i = segmentIndex; widthLeft > 0; i++)
+	{
+		ASSERT(i < skyline_.size());
+		const Segment &segment = skyline_[i];
+		if (segment.y > y)
+			y = segment.y;
+		if (y + height > height_)
+			return -1;
+
+		widthLeft -= (segment.width < widthLeft) ? segment.width : widthLeft;
+	}
+
+	return static_cast<int>(y);
+}
+
+void SkylinePacker::addSegment(unsigned int segmentIndex, unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	skyline_.insertAt(segmentIndex, Segment(x, y + height, width));
+
+	// Shrinking or removing the segments that are now below the rectangle
+	const unsigned int right = x + width;
+	unsigned int i = segmentIndex + 1;
+	while (i < skyline_.size() && skyline_[i].x < right)
+	{
+		Segment &segment = skyline_[i];
+		const unsigned int overlap = right - segment.x;
+		if (segment.width <= overlap)
+			skyline_.removeAt(i);
+		else
+		{
+			segment.x += overlap;
+			segment.width -= overlap;
+			break;
+		}
+	}
+
+	// Merging adjacent segments at the same height
+	i = 0;
+	while (i + 1 < skyline_.size())
+	{
+		if (skyline_[i].y == skyline_[i + 1].y)
+		{
+			skyline_[i].width += skyline_[i + 1].width;
+			skyline_.removeAt(i + 1);
+		}
+		else
+			i++;
+	}
+}
+
+}
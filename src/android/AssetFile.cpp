@@ -142,6 +142,15 @@ bool AssetFile::isOpened() const
 		return false;
 }
 
+/*! The buffer of an asset stored uncompressed points inside the memory-mapped package, a compressed one is inflated first */
+const unsigned char *AssetFile::data() const
+{
+	if (asset_)
+		return static_cast<const unsigned char *>(AAsset_getBuffer(asset_));
+	else
+		return nullptr;
+}
+
 const char *AssetFile::assetPath(const char *path)
 {
 	ASSERT(path);
@@ -199,9 +199,14 @@ bool AudioBuffer::load(IAudioLoader &audioLoader)
 
 	// Buffer size calculated as samples * channels * bytes per samples
 	const unsigned long int bufferSize = audioLoader.bufferSize();
-	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(bufferSize);
-
 	nctl::UniquePtr<IAudioReader> audioReader = audioLoader.createReader();
+
+	// Samples that are already in memory, like uncompressed ones in a memory-mapped file, are not copied
+	const unsigned char *samples = audioReader->samples(bufferSize);
+	if (samples != nullptr)
+		return loadFromSamples(samples, bufferSize);
+
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(bufferSize);
 	audioReader->read(buffer.get(), bufferSize);
 
 	return loadFromSamples(buffer.get(), bufferSize);
@@ -37,6 +37,16 @@ unsigned long int AudioReaderWav::read(void *buffer, unsigned long int bufferSiz
 	return bufferSeek;
 }
 
+/*! PCM samples are stored uncompressed after the header and can be read directly from a memory-mapped file */
+const unsigned char *AudioReaderWav::samples(unsigned long int bufferSize) const
+{
+	const unsigned char *fileData = fileHandle_->data();
+	if (fileData == nullptr || static_cast<unsigned long int>(fileHandle_->size()) < AudioLoaderWav::HeaderSize + bufferSize)
+		return nullptr;
+
+	return fileData + AudioLoaderWav::HeaderSize;
+}
+
 void AudioReaderWav::rewind() const
 {
 	if (fileHandle_->ptr())
@@ -31,8 +31,8 @@ nctl::UniquePtr<IAudioLoader> IAudioLoader::createFromMemory(const char *bufferN
 nctl::UniquePtr<IAudioLoader> IAudioLoader::createFromFile(const char *filename)
 {
 	LOGI_X("Loading file: \"%s\"", filename);
-	// Creating a handle from IFile static method to detect assets file
-	return createLoader(nctl::move(IFile::createFileHandle(filename)), filename);
+	// Creating a handle from IFile static method to detect assets file, uncompressed samples can then be read from the mapping
+	return createLoader(nctl::move(IFile::createMappedFileHandle(filename)), filename);
 }
 
 ///////////////////////////////////////////////////////////
@@ -4,6 +4,7 @@
 #include <nctl/MallocAllocator.h>
 #include <nctl/FreeListAllocator.h>
 #include <nctl/ProxyAllocator.h>
+#include <nctl/FrameAllocator.h>
 
 #ifdef WITH_IMGUI
 	#include "imgui.h"
@@ -25,6 +26,7 @@ static AllocManagerInitializer allocManagerInit __attribute__((init_priority(101
 alignas(sizeof(AllocManager)) static uint8_t allocManagerBuffer[sizeof(AllocManager)];
 static AllocManager &allocManager = reinterpret_cast<AllocManager &>(allocManagerBuffer);
 static IAllocator *mainAllocator = nullptr;
+static thread_local IAllocator *threadDefaultAllocator = nullptr;
 
 #ifdef USE_FREELIST
 static const unsigned int FreeListSize = FREELIST_BUFFER;
@@ -36,6 +38,11 @@ alignas(IAllocator::DefaultAlignment) static uint8_t mallocAllocatorBuffer[sizeo
 static MallocAllocator &mallocAllocator = reinterpret_cast<MallocAllocator &>(mallocAllocatorBuffer);
 #endif
 
+static const unsigned int FrameArenaSize = FRAME_ARENA_BUFFER;
+alignas(IAllocator::DefaultAlignment) static uint8_t frameArenaMemory[FrameArenaSize];
+alignas(IAllocator::DefaultAlignment) static uint8_t frameAllocatorBuffer[sizeof(FrameAllocator)];
+static FrameAllocator &frameAllocator = reinterpret_cast<FrameAllocator &>(frameAllocatorBuffer);
+
 #ifdef WITH_IMGUI
 alignas(IAllocator::DefaultAlignment) static uint8_t imguiAllocatorBuffer[sizeof(ProxyAllocator)];
 static ProxyAllocator &imguiAllocator = reinterpret_cast<ProxyAllocator &>(imguiAllocatorBuffer);
@@ -66,6 +73,11 @@ IAllocator &theStringAllocator()
 	return theAllocManager().stringAllocator();
 }
 
+FrameAllocator &theFrameAllocator()
+{
+	return frameAllocator;
+}
+
 IAllocator &theImGuiAllocator()
 {
 #ifdef WITH_IMGUI
@@ -127,6 +139,8 @@ AllocManager::AllocManager()
 	defaultAllocator_ = mainAllocator;
 	stringAllocator_ = mainAllocator;
 
+	new (&frameAllocator) FrameAllocator("Frame", FrameArenaSize, frameArenaMemory, *mainAllocator);
+
 #ifdef WITH_IMGUI
 	new (&imguiAllocator) ProxyAllocator("ImGui", *mainAllocator);
 	ImGui::SetAllocatorFunctions(imguiAllocate, imguiDeallocate);
@@ -151,6 +165,8 @@ AllocManager::~AllocManager()
 	(&imguiAllocator)->~ProxyAllocator();
 #endif
 
+	(&frameAllocator)->~FrameAllocator();
+
 #ifdef USE_FREELIST
 	(&freelistAllocator)->~FreeListAllocator();
 #else
@@ -172,6 +188,11 @@ AllocManagerInitializer::~AllocManagerInitializer()
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+IAllocator &AllocManager::defaultAllocator()
+{
+	return (threadDefaultAllocator != nullptr) ? *threadDefaultAllocator : *defaultAllocator_;
+}
+
 IAllocator *AllocManager::setDefaultAllocator(IAllocator *allocator)
 {
 	IAllocator *previous = defaultAllocator_;
@@ -179,6 +200,13 @@ IAllocator *AllocManager::setDefaultAllocator(IAllocator *allocator)
 	return previous;
 }
 
+IAllocator *AllocManager::setThreadDefaultAllocator(IAllocator *allocator)
+{
+	IAllocator *previous = threadDefaultAllocator;
+	threadDefaultAllocator = allocator;
+	return previous;
+}
+
 IAllocator *AllocManager::setStringAllocator(IAllocator *allocator)
 {
 	IAllocator *previous = stringAllocator_;
@@ -0,0 +1,95 @@
+#include "AllocationCounter.h"
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+namespace {
+
+	/// The counters of the current frame, the last element is for allocations outside of any zone
+	nctl::Atomic64 frameAllocations[AllocationCounter::MaxZones + 1];
+	nctl::Atomic64 frameBytes[AllocationCounter::MaxZones + 1];
+	AllocationCounter::Counters lastFrameCounters[AllocationCounter::MaxZones + 1];
+
+	nctl::Atomic64 totalAllocations;
+	nctl::Atomic64 totalBytes;
+
+	thread_local unsigned int currentZone = AllocationCounter::NoZone;
+
+	/// Moves the current value of an atomic counter to a plain one, without losing concurrent increments
+	unsigned long drainCounter(nctl::Atomic64 &counter)
+	{
+		const int64_t value = counter.load(nctl::Atomic64::MemoryModel::RELAXED);
+		counter.fetchSub(value, nctl::Atomic64::MemoryModel::RELAXED);
+		return static_cast<unsigned long>(value);
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool AllocationCounter::isAvailable()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AllocationCounter::countAllocation(size_t bytes)
+{
+	const unsigned int zone = currentZone;
+	frameAllocations[zone].fetchAdd(1, nctl::Atomic64::MemoryModel::RELAXED);
+	frameBytes[zone].fetchAdd(static_cast<int64_t>(bytes), nctl::Atomic64::MemoryModel::RELAXED);
+	totalAllocations.fetchAdd(1, nctl::Atomic64::MemoryModel::RELAXED);
+	totalBytes.fetchAdd(static_cast<int64_t>(bytes), nctl::Atomic64::MemoryModel::RELAXED);
+}
+
+unsigned int AllocationCounter::setZone(unsigned int zone)
+{
+	const unsigned int previousZone = currentZone;
+	currentZone = (zone < MaxZones) ? zone : NoZone;
+	return previousZone;
+}
+
+unsigned int AllocationCounter::zone()
+{
+	return currentZone;
+}
+
+void AllocationCounter::nextFrame()
+{
+	for (unsigned int i = 0; i <= MaxZones; i++)
+	{
+		lastFrameCounters[i].numAllocations = drainCounter(frameAllocations[i]);
+		lastFrameCounters[i].bytes = drainCounter(frameBytes[i]);
+	}
+}
+
+AllocationCounter::Counters AllocationCounter::lastFrame()
+{
+	Counters counters;
+	for (unsigned int i = 0; i <= MaxZones; i++)
+	{
+		counters.numAllocations += lastFrameCounters[i].numAllocations;
+		counters.bytes += lastFrameCounters[i].bytes;
+	}
+	return counters;
+}
+
+AllocationCounter::Counters AllocationCounter::lastFrame(unsigned int zone)
+{
+	return lastFrameCounters[(zone < MaxZones) ? zone : NoZone];
+}
+
+AllocationCounter::Counters AllocationCounter::total()
+{
+	Counters counters;
+	counters.numAllocations = static_cast<unsigned long>(totalAllocations.load(nctl::Atomic64::MemoryModel::RELAXED));
+	counters.bytes = static_cast<unsigned long>(totalBytes.load(nctl::Atomic64::MemoryModel::RELAXED));
+	return counters;
+}
+
+}
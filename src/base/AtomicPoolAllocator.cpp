@@ -0,0 +1,153 @@
+#include <ncine/common_macros.h>
+#include <nctl/AtomicPoolAllocator.h>
+#include <nctl/PointerMath.h>
+
+namespace nctl {
+
+namespace {
+
+	/// Free elements store the index of the next free element plus one, zero marks the end of the list
+	inline uint32_t &nextFreeIndex(void *element) { return *reinterpret_cast<uint32_t *>(element); }
+
+	inline int64_t packHead(uint32_t tag, uint32_t index) { return static_cast<int64_t>((static_cast<uint64_t>(tag) << 32) | index); }
+	inline uint32_t headTag(int64_t head) { return static_cast<uint32_t>(static_cast<uint64_t>(head) >> 32); }
+	inline uint32_t headIndex(int64_t head) { return static_cast<uint32_t>(static_cast<uint64_t>(head) & 0xFFFFFFFF); }
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AtomicPoolAllocator::AtomicPoolAllocator(const char *name)
+    : IAllocator(name, allocateImpl, reallocateImpl, deallocateImpl),
+      elementSize_(0), elementAlignment_(0), elements_(nullptr), numElements_(0)
+{
+}
+
+AtomicPoolAllocator::AtomicPoolAllocator(const char *name, size_t elementSize, uint8_t elementAlignment, size_t size, void *base)
+    : IAllocator(name, allocateImpl, reallocateImpl, deallocateImpl, size, base),
+      elementSize_(elementSize), elementAlignment_(elementAlignment), elements_(nullptr), numElements_(0)
+{
+	internalInit();
+}
+
+AtomicPoolAllocator::~AtomicPoolAllocator()
+{
+	FATAL_ASSERT(numAllocatedElements_.load() == 0);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void AtomicPoolAllocator::init(size_t elementSize, uint8_t elementAlignment, size_t size, void *base)
+{
+	FATAL_ASSERT(numAllocatedElements_.load() == 0);
+	size_ = size;
+	base_ = base;
+	elementSize_ = elementSize;
+	elementAlignment_ = elementAlignment;
+
+	internalInit();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void AtomicPoolAllocator::internalInit()
+{
+	// The element should be big enough to store the index of the next one in the free list
+	ASSERT(elementSize_ >= sizeof(uint32_t));
+	// Element addresses should keep the alignment
+	ASSERT(elementSize_ % elementAlignment_ == 0);
+
+	const uint8_t adjustment = PointerMath::alignAdjustment(base_, elementAlignment_);
+	elements_ = PointerMath::add(base_, adjustment);
+	const size_t numElements = (size_ - adjustment) / elementSize_;
+	FATAL_ASSERT(numElements < 0xFFFFFFFF);
+	numElements_ = static_cast<uint32_t>(numElements);
+
+	// Initialize the free elements list
+	for (uint32_t i = 0; i < numElements_; i++)
+		nextFreeIndex(PointerMath::add(elements_, i * elementSize_)) = (i + 1 < numElements_) ? i + 2 : 0;
+
+	freeListHead_.store(packHead(0, numElements_ > 0 ? 1 : 0), Atomic64::MemoryModel::RELEASE);
+	numAllocatedElements_.store(0, Atomic32::MemoryModel::RELEASE);
+}
+
+void *AtomicPoolAllocator::allocateImpl(IAllocator *allocator, size_t bytes, uint8_t alignment)
+{
+	FATAL_ASSERT(bytes > 0);
+	FATAL_ASSERT_MSG((alignment & (alignment - 1)) == 0, "The alignment should be a power of two");
+	FATAL_ASSERT_MSG(alignment >= 1 && alignment <= 128, "The alignment must be between 1 and 128");
+
+	FATAL_ASSERT(allocator);
+	AtomicPoolAllocator *allocatorImpl = static_cast<AtomicPoolAllocator *>(allocator);
+
+	FATAL_ASSERT(bytes == allocatorImpl->elementSize_);
+	FATAL_ASSERT(alignment == allocatorImpl->elementAlignment_);
+
+	void *element = nullptr;
+	int64_t head = allocatorImpl->freeListHead_.load(Atomic64::MemoryModel::ACQUIRE);
+	while (true)
+	{
+		const uint32_t index = headIndex(head);
+		if (index == 0)
+			return nullptr;
+
+		// The next index might be stale if another thread has already popped the element, the tag makes the exchange fail in that case
+		element = PointerMath::add(allocatorImpl->elements_, (index - 1) * allocatorImpl->elementSize_);
+		const int64_t newHead = packHead(headTag(head) + 1, nextFreeIndex(element));
+		if (allocatorImpl->freeListHead_.cmpExchange(newHead, head, Atomic64::MemoryModel::ACQUIRE))
+			break;
+		head = allocatorImpl->freeListHead_.load(Atomic64::MemoryModel::ACQUIRE);
+	}
+
+	allocatorImpl->numAllocatedElements_.fetchAdd(1, Atomic32::MemoryModel::RELAXED);
+	return element;
+}
+
+void *AtomicPoolAllocator::reallocateImpl(IAllocator *allocator, void *ptr, size_t bytes, uint8_t alignment, size_t &oldSize)
+{
+	ASSERT_MSG(false, "AtomicPoolAllocator cannot reallocate");
+
+	FATAL_ASSERT(allocator);
+	AtomicPoolAllocator *allocatorImpl = static_cast<AtomicPoolAllocator *>(allocator);
+
+	// Never try to allocte a new block and perform a copy of the data in `IAllocator`
+	allocatorImpl->copyOnReallocation_ = false;
+	oldSize = 0;
+
+	return nullptr;
+}
+
+void AtomicPoolAllocator::deallocateImpl(IAllocator *allocator, void *ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	FATAL_ASSERT(allocator);
+	AtomicPoolAllocator *allocatorImpl = static_cast<AtomicPoolAllocator *>(allocator);
+
+	const size_t offset = PointerMath::subtract(ptr, allocatorImpl->elements_);
+	FATAL_ASSERT(offset % allocatorImpl->elementSize_ == 0);
+	const uint32_t index = static_cast<uint32_t>(offset / allocatorImpl->elementSize_) + 1;
+	FATAL_ASSERT(index <= allocatorImpl->numElements_);
+
+	int64_t head = allocatorImpl->freeListHead_.load(Atomic64::MemoryModel::RELAXED);
+	while (true)
+	{
+		nextFreeIndex(ptr) = headIndex(head);
+		const int64_t newHead = packHead(headTag(head) + 1, index);
+		if (allocatorImpl->freeListHead_.cmpExchange(newHead, head, Atomic64::MemoryModel::RELEASE))
+			break;
+		head = allocatorImpl->freeListHead_.load(Atomic64::MemoryModel::RELAXED);
+	}
+
+	FATAL_ASSERT(allocatorImpl->numAllocatedElements_.load(Atomic32::MemoryModel::RELAXED) > 0);
+	allocatorImpl->numAllocatedElements_.fetchSub(1, Atomic32::MemoryModel::RELAXED);
+}
+
+}
@@ -0,0 +1,146 @@
+#include <ncine/common_macros.h>
+#include <nctl/FrameAllocator.h>
+#include <nctl/PointerMath.h>
+
+namespace nctl {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FrameAllocator::FrameAllocator(const char *name, size_t size, void *base, IAllocator &fallbackAllocator)
+    : IAllocator(name, allocateImpl, reallocateImpl, deallocateImpl, size, base),
+      fallbackAllocator_(fallbackAllocator),
+      overflows_{ nullptr, nullptr }, current_(0), highWaterMark_(0), lastFrameUsedMemory_(0),
+      numOverflows_(0), lastFrameNumOverflows_(0)
+{
+	FATAL_ASSERT(size >= 2 * DefaultAlignment);
+	FATAL_ASSERT(base != nullptr);
+
+	const size_t arenaSize = (size / 2) & ~static_cast<size_t>(DefaultAlignment - 1);
+	arenas_[0].init(arenaSize, base);
+	arenas_[1].init(arenaSize, PointerMath::add(base, arenaSize));
+
+	// Arena allocations are not heap allocations, overflows are counted by the fallback allocator
+	countAllocations_ = false;
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	clearArena(0);
+	clearArena(1);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FrameAllocator::nextFrame()
+{
+	lastFrameUsedMemory_ = usedMemory_;
+	lastFrameNumOverflows_ = numOverflows_;
+	if (highWaterMark_ < usedMemory_)
+		highWaterMark_ = usedMemory_;
+
+	// The arena of two frames ago becomes the one of the new frame
+	current_ = (current_ + 1) % 2;
+	clearArena(current_);
+
+	usedMemory_ = 0;
+	numAllocations_ = 0;
+	numOverflows_ = 0;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FrameAllocator::clearArena(unsigned int index)
+{
+	arenas_[index].clear();
+
+	while (overflows_[index])
+	{
+		OverflowHeader *next = overflows_[index]->next;
+		fallbackAllocator_.deallocate(overflows_[index]->backingPtr);
+		overflows_[index] = next;
+	}
+}
+
+void *FrameAllocator::allocateOverflow(size_t bytes, uint8_t alignment)
+{
+	// The header is stored right before the returned address
+	if (alignment < alignof(OverflowHeader))
+		alignment = alignof(OverflowHeader);
+
+	void *backingPtr = fallbackAllocator_.allocate(bytes + sizeof(OverflowHeader) + alignment);
+	if (backingPtr == nullptr)
+		return nullptr;
+
+	void *ptr = PointerMath::align(PointerMath::add(backingPtr, sizeof(OverflowHeader)), alignment);
+	OverflowHeader *header = static_cast<OverflowHeader *>(PointerMath::subtract(ptr, sizeof(OverflowHeader)));
+	header->next = overflows_[current_];
+	header->backingPtr = backingPtr;
+	header->size = bytes;
+	overflows_[current_] = header;
+
+	numOverflows_++;
+	return ptr;
+}
+
+void *FrameAllocator::allocateImpl(IAllocator *allocator, size_t bytes, uint8_t alignment)
+{
+	FATAL_ASSERT(bytes > 0);
+	FATAL_ASSERT_MSG((alignment & (alignment - 1)) == 0, "The alignment should be a power of two");
+	FATAL_ASSERT_MSG(alignment >= 1 && alignment <= 128, "The alignment must be between 1 and 128");
+
+	FATAL_ASSERT(allocator);
+	FrameAllocator *allocatorImpl = static_cast<FrameAllocator *>(allocator);
+
+	void *ptr = allocatorImpl->arenas_[allocatorImpl->current_].allocate(bytes, alignment);
+	if (ptr == nullptr)
+		ptr = allocatorImpl->allocateOverflow(bytes, alignment);
+
+	if (ptr)
+	{
+		allocatorImpl->usedMemory_ += bytes;
+		allocatorImpl->numAllocations_++;
+	}
+
+	return ptr;
+}
+
+void *FrameAllocator::reallocateImpl(IAllocator *allocator, void *ptr, size_t bytes, uint8_t alignment, size_t &oldSize)
+{
+	FATAL_ASSERT(ptr != nullptr);
+	FATAL_ASSERT(bytes > 0);
+	FATAL_ASSERT_MSG((alignment & (alignment - 1)) == 0, "The alignment should be a power of two");
+	FATAL_ASSERT_MSG(alignment >= 1 && alignment <= 128, "The alignment must be between 1 and 128");
+
+	FATAL_ASSERT(allocator);
+	FrameAllocator *allocatorImpl = static_cast<FrameAllocator *>(allocator);
+
+	// The size of an arena allocation is not stored, copying up to the end of the used part of its arena is always safe
+	oldSize = 0;
+	for (const LinearAllocator &arena : allocatorImpl->arenas_)
+	{
+		if (ptr >= arena.base() && ptr < arena.current())
+		{
+			oldSize = reinterpret_cast<uintptr_t>(arena.current()) - reinterpret_cast<uintptr_t>(ptr);
+			return nullptr;
+		}
+	}
+
+	const OverflowHeader *header = static_cast<const OverflowHeader *>(PointerMath::subtract(ptr, sizeof(OverflowHeader)));
+	oldSize = header->size;
+
+	// `IAllocator` allocates a new block and performs a copy, the old one is reclaimed with its frame
+	return nullptr;
+}
+
+void FrameAllocator::deallocateImpl(IAllocator *allocator, void *ptr)
+{
+	// Memory is reclaimed when the arena of the frame is cleared
+}
+
+}
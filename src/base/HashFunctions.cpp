@@ -19,7 +19,7 @@ uint64_t fasthash64(const void *buf, size_t len, uint64_t seed)
 	uint64_t h = seed ^ (len * m);
 	uint64_t v = 0;
 
-	while (pos <= end)
+	while (pos != end)
 	{
 		v = *pos++;
 		h ^= fasthash_mix(v);
@@ -8,6 +8,10 @@
 
 #include "tracy.h"
 
+#ifdef COUNT_ALLOCATIONS
+	#include "AllocationCounter.h"
+#endif
+
 namespace nctl {
 
 ///////////////////////////////////////////////////////////
@@ -16,12 +20,12 @@ namespace nctl {
 
 IAllocator::IAllocator(const char *name, AllocateFunction allocFunc, ReallocateFunction reallocFunc, DeallocateFunction deallocFunc, size_t size, void *base)
 
-#if !defined(RECORD_ALLOCATIONS) && !defined(WITH_TRACY)
+#if !defined(RECORD_ALLOCATIONS) && !defined(WITH_TRACY) && !defined(COUNT_ALLOCATIONS)
     : allocateFunc_(allocFunc), reallocateFunc_(reallocFunc), deallocateFunc_(deallocFunc),
-      size_(size), base_(base), usedMemory_(0), numAllocations_(0), copyOnReallocation_(true)
+      size_(size), base_(base), usedMemory_(0), numAllocations_(0), copyOnReallocation_(true), countAllocations_(true)
 #else
     : allocateFunc_(wrapAllocate), reallocateFunc_(wrapReallocate), deallocateFunc_(wrapDeallocate),
-      size_(size), base_(base), usedMemory_(0), numAllocations_(0), copyOnReallocation_(true),
+      size_(size), base_(base), usedMemory_(0), numAllocations_(0), copyOnReallocation_(true), countAllocations_(true),
       realAllocateFunc_(allocFunc), realReallocateFunc_(reallocFunc), realDeallocateFunc_(deallocFunc)
 #endif
 #if defined(RECORD_ALLOCATIONS)
@@ -187,7 +191,7 @@ void *IAllocator::reallocate(void *ptr, size_t bytes, uint8_t alignment)
 // PROTECTED FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-#if defined(RECORD_ALLOCATIONS) || defined(WITH_TRACY)
+#if defined(RECORD_ALLOCATIONS) || defined(WITH_TRACY) || defined(COUNT_ALLOCATIONS)
 
 void *IAllocator::wrapAllocate(IAllocator *allocator, size_t bytes, uint8_t alignment)
 {
@@ -197,6 +201,11 @@ void *IAllocator::wrapAllocate(IAllocator *allocator, size_t bytes, uint8_t alig
 		TracyAllocNS(ptr, bytes, 5, allocator->name_);
 	#endif
 
+	#ifdef COUNT_ALLOCATIONS
+	if (ptr && allocator->countAllocations_)
+		ncine::AllocationCounter::countAllocation(bytes);
+	#endif
+
 	#ifdef RECORD_ALLOCATIONS
 	if (allocator->recordAllocations_ && allocator->numEntries_ < MaxEntries && ptr != nullptr && bytes > 0)
 	{
@@ -225,6 +234,11 @@ void *IAllocator::wrapReallocate(IAllocator *allocator, void *ptr, size_t bytes,
 	}
 	#endif
 
+	#ifdef COUNT_ALLOCATIONS
+	if (newPtr && allocator->countAllocations_)
+		ncine::AllocationCounter::countAllocation(bytes);
+	#endif
+
 	#ifdef RECORD_ALLOCATIONS
 	if (allocator->recordAllocations_ && newPtr != nullptr)
 	{
@@ -11,6 +11,8 @@ ProxyAllocator::ProxyAllocator(const char *name, IAllocator &allocator)
     : IAllocator(name, allocateImpl, reallocateImpl, deallocateImpl, 0, nullptr),
       allocator_(allocator)
 {
+	// Allocations are already counted by the subject allocator
+	countAllocations_ = false;
 }
 
 ProxyAllocator::~ProxyAllocator()
@@ -161,7 +161,7 @@ void String::setCapacity(unsigned int newCapacity)
 #if !NCINE_WITH_ALLOCATORS
 		newArray = static_cast<char *>(::operator new[](newCapacity * sizeof(char)));
 #else
-		newArray = theStringAllocator().newArray<char>(capacity_);
+		newArray = theStringAllocator().newArray<char>(newCapacity);
 #endif
 		if (length_ > 0)
 		{
@@ -169,9 +169,9 @@ void String::setCapacity(unsigned int newCapacity)
 				length_ = newCapacity; // cropping last elements
 
 			if (capacity_ > SmallBufferSize)
-				nctl::strncpy(newArray, capacity_, array_.begin_, length_);
+				nctl::strncpy(newArray, newCapacity, array_.begin_, length_);
 			else
-				nctl::strncpy(newArray, SmallBufferSize, array_.local_, length_);
+				nctl::strncpy(newArray, newCapacity, array_.local_, length_);
 
 			newArray[length_] = '\0';
 		}
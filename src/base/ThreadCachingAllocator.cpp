@@ -0,0 +1,383 @@
+#include <ncine/common_macros.h>
+#include <nctl/ThreadCachingAllocator.h>
+#include <nctl/PointerMath.h>
+
+namespace nctl {
+
+namespace {
+
+	/// The header in front of every block, it is written once when a chunk is carved
+	struct BlockHeader
+	{
+		uint32_t sizeClass;
+		/// Offset of a big allocation from the start of the backing allocation
+		uint32_t offset;
+		/// The size of the class or the size of the backing allocation for big ones
+		uint64_t size;
+	};
+
+	/// The header at the start of every chunk carved into blocks
+	struct ChunkHeader
+	{
+		void *next;
+		size_t size;
+	};
+
+	const unsigned int HeaderSize = 16;
+	static_assert(sizeof(BlockHeader) == HeaderSize, "The block header should be 16 bytes long");
+	static_assert(sizeof(ChunkHeader) <= HeaderSize, "The chunk header should not be longer than a block header");
+	static_assert(HeaderSize % IAllocator::DefaultAlignment == 0, "The block header should not break the default alignment");
+
+	/// The size class of allocations performed directly by the backing allocator
+	const uint32_t BigClass = 0xFFFFFFFF;
+	/// The minimum size of a chunk carved into blocks
+	const size_t ChunkSize = 64 * 1024;
+
+	/// The cache of a thread for one allocator, threads are not notified when an allocator is destroyed
+	struct ThreadCacheSlot
+	{
+		uint32_t allocatorId;
+		void *cache;
+	};
+
+	thread_local ThreadCacheSlot threadCacheSlots[ThreadCachingAllocator::MaxCachesPerThread];
+
+	uint32_t nextAllocatorId()
+	{
+		static Atomic32 counter;
+		return static_cast<uint32_t>(counter.fetchAdd(1)) + 1;
+	}
+
+	inline BlockHeader *blockHeader(void *ptr) { return static_cast<BlockHeader *>(PointerMath::subtract(ptr, HeaderSize)); }
+	inline void *&nextFreeBlock(void *ptr) { return *static_cast<void **>(ptr); }
+	inline size_t classSize(unsigned int sizeClass) { return ThreadCachingAllocator::MinClassSize << sizeClass; }
+
+	unsigned int sizeClass(size_t bytes)
+	{
+		unsigned int sizeClass = 0;
+		while (classSize(sizeClass) < bytes)
+			sizeClass++;
+		return sizeClass;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ThreadCachingAllocator::ThreadCachingAllocator(const char *name, IAllocator &backingAllocator)
+    : IAllocator(name, allocateImpl, reallocateImpl, deallocateImpl),
+      backingAllocator_(backingAllocator), id_(nextAllocatorId()), lock_(0), chunks_(nullptr), caches_(nullptr)
+{
+	for (unsigned int i = 0; i < NumSizeClasses; i++)
+		depot_[i] = nullptr;
+}
+
+ThreadCachingAllocator::~ThreadCachingAllocator()
+{
+	while (caches_)
+	{
+		ThreadCache *next = caches_->next;
+		backingAllocator_.deallocate(caches_);
+		usedMemory_ -= sizeof(ThreadCache);
+		numAllocations_--;
+		caches_ = next;
+	}
+
+	while (chunks_)
+	{
+		ChunkHeader *chunk = static_cast<ChunkHeader *>(chunks_);
+		chunks_ = chunk->next;
+		usedMemory_ -= chunk->size;
+		numAllocations_--;
+		backingAllocator_.deallocate(chunk);
+	}
+
+	// Big allocations should have all been deallocated
+	FATAL_ASSERT(numAllocations_ == 0);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::releaseThreadCache()
+{
+	for (ThreadCacheSlot &slot : threadCacheSlots)
+	{
+		if (slot.allocatorId != id_)
+			continue;
+
+		ThreadCache *cache = static_cast<ThreadCache *>(slot.cache);
+		acquireLock();
+		for (unsigned int i = 0; i < NumSizeClasses; i++)
+		{
+			Magazine &magazine = cache->magazines[i];
+			for (unsigned int j = 0; j < magazine.count; j++)
+			{
+				nextFreeBlock(magazine.blocks[j]) = depot_[i];
+				depot_[i] = magazine.blocks[j];
+			}
+		}
+
+		ThreadCache **link = &caches_;
+		while (*link != cache)
+			link = &(*link)->next;
+		*link = cache->next;
+
+		backingAllocator_.deallocate(cache);
+		usedMemory_ -= sizeof(ThreadCache);
+		numAllocations_--;
+		releaseLock();
+
+		slot.allocatorId = 0;
+		slot.cache = nullptr;
+		return;
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ThreadCachingAllocator::acquireLock()
+{
+	while (lock_.cmpExchange(1, 0, Atomic32::MemoryModel::ACQUIRE) == false)
+	{
+		// Waiting for the lock to be released before trying again
+		while (lock_.load(Atomic32::MemoryModel::RELAXED) != 0) {}
+	}
+}
+
+void ThreadCachingAllocator::releaseLock()
+{
+	lock_.store(0, Atomic32::MemoryModel::RELEASE);
+}
+
+ThreadCachingAllocator::ThreadCache *ThreadCachingAllocator::threadCache()
+{
+	ThreadCacheSlot *freeSlot = nullptr;
+	for (ThreadCacheSlot &slot : threadCacheSlots)
+	{
+		if (slot.allocatorId == id_)
+			return static_cast<ThreadCache *>(slot.cache);
+		else if (slot.allocatorId == 0 && freeSlot == nullptr)
+			freeSlot = &slot;
+	}
+
+	// The thread will use the depot directly if it has no free slots left
+	if (freeSlot == nullptr)
+		return nullptr;
+
+	acquireLock();
+	ThreadCache *cache = static_cast<ThreadCache *>(backingAllocator_.allocate(sizeof(ThreadCache)));
+	if (cache)
+	{
+		for (unsigned int i = 0; i < NumSizeClasses; i++)
+			cache->magazines[i].count = 0;
+		cache->next = caches_;
+		caches_ = cache;
+		usedMemory_ += sizeof(ThreadCache);
+		numAllocations_++;
+	}
+	releaseLock();
+
+	if (cache)
+	{
+		freeSlot->allocatorId = id_;
+		freeSlot->cache = cache;
+	}
+	return cache;
+}
+
+bool ThreadCachingAllocator::refill(Magazine &magazine, unsigned int sizeClass)
+{
+	acquireLock();
+	if (depot_[sizeClass] == nullptr && carveChunk(sizeClass) == false)
+	{
+		releaseLock();
+		return false;
+	}
+
+	while (magazine.count < MagazineCapacity / 2 && depot_[sizeClass] != nullptr)
+	{
+		void *block = depot_[sizeClass];
+		depot_[sizeClass] = nextFreeBlock(block);
+		magazine.blocks[magazine.count++] = block;
+	}
+	releaseLock();
+
+	return true;
+}
+
+void ThreadCachingAllocator::flush(Magazine &magazine, unsigned int sizeClass)
+{
+	acquireLock();
+	while (magazine.count > MagazineCapacity / 2)
+	{
+		void *block = magazine.blocks[--magazine.count];
+		nextFreeBlock(block) = depot_[sizeClass];
+		depot_[sizeClass] = block;
+	}
+	releaseLock();
+}
+
+bool ThreadCachingAllocator::carveChunk(unsigned int sizeClass)
+{
+	const size_t blockSize = HeaderSize + classSize(sizeClass);
+	const size_t numBlocks = (ChunkSize / blockSize > 0) ? ChunkSize / blockSize : 1;
+	// Every chunk starts with a header that links it to the other ones
+	const size_t chunkBytes = HeaderSize + numBlocks * blockSize;
+
+	ChunkHeader *chunk = static_cast<ChunkHeader *>(backingAllocator_.allocate(chunkBytes));
+	if (chunk == nullptr)
+		return false;
+
+	chunk->next = chunks_;
+	chunk->size = chunkBytes;
+	chunks_ = chunk;
+	usedMemory_ += chunkBytes;
+	numAllocations_++;
+
+	for (size_t i = 0; i < numBlocks; i++)
+	{
+		void *ptr = PointerMath::add(chunk, HeaderSize + i * blockSize + HeaderSize);
+		BlockHeader *header = blockHeader(ptr);
+		header->sizeClass = sizeClass;
+		header->offset = 0;
+		header->size = classSize(sizeClass);
+
+		nextFreeBlock(ptr) = depot_[sizeClass];
+		depot_[sizeClass] = ptr;
+	}
+
+	return true;
+}
+
+void *ThreadCachingAllocator::allocateBig(size_t bytes, uint8_t alignment)
+{
+	const size_t totalBytes = bytes + HeaderSize + alignment;
+
+	acquireLock();
+	void *backingPtr = backingAllocator_.allocate(totalBytes);
+	if (backingPtr)
+	{
+		usedMemory_ += totalBytes;
+		numAllocations_++;
+	}
+	releaseLock();
+
+	if (backingPtr == nullptr)
+		return nullptr;
+
+	void *ptr = PointerMath::align(PointerMath::add(backingPtr, HeaderSize), alignment);
+	BlockHeader *header = blockHeader(ptr);
+	header->sizeClass = BigClass;
+	header->offset = static_cast<uint32_t>(PointerMath::subtract(ptr, backingPtr));
+	header->size = totalBytes;
+
+	return ptr;
+}
+
+void ThreadCachingAllocator::deallocateBig(void *ptr)
+{
+	const BlockHeader *header = blockHeader(ptr);
+	const size_t totalBytes = header->size;
+	void *backingPtr = PointerMath::subtract(ptr, header->offset);
+
+	acquireLock();
+	backingAllocator_.deallocate(backingPtr);
+	FATAL_ASSERT(numAllocations_ > 0);
+	usedMemory_ -= totalBytes;
+	numAllocations_--;
+	releaseLock();
+}
+
+void *ThreadCachingAllocator::allocateImpl(IAllocator *allocator, size_t bytes, uint8_t alignment)
+{
+	FATAL_ASSERT(bytes > 0);
+	FATAL_ASSERT_MSG((alignment & (alignment - 1)) == 0, "The alignment should be a power of two");
+	FATAL_ASSERT_MSG(alignment >= 1 && alignment <= 128, "The alignment must be between 1 and 128");
+
+	FATAL_ASSERT(allocator);
+	ThreadCachingAllocator *allocatorImpl = static_cast<ThreadCachingAllocator *>(allocator);
+
+	// Blocks of the size classes are only aligned to the default alignment
+	if (bytes > maxClassSize() || alignment > DefaultAlignment)
+		return allocatorImpl->allocateBig(bytes, alignment);
+
+	const unsigned int blockClass = sizeClass(bytes);
+	ThreadCache *cache = allocatorImpl->threadCache();
+	if (cache)
+	{
+		Magazine &magazine = cache->magazines[blockClass];
+		if (magazine.count == 0 && allocatorImpl->refill(magazine, blockClass) == false)
+			return nullptr;
+		return magazine.blocks[--magazine.count];
+	}
+
+	void *ptr = nullptr;
+	allocatorImpl->acquireLock();
+	if (allocatorImpl->depot_[blockClass] != nullptr || allocatorImpl->carveChunk(blockClass))
+	{
+		ptr = allocatorImpl->depot_[blockClass];
+		allocatorImpl->depot_[blockClass] = nextFreeBlock(ptr);
+	}
+	allocatorImpl->releaseLock();
+
+	return ptr;
+}
+
+void *ThreadCachingAllocator::reallocateImpl(IAllocator *allocator, void *ptr, size_t bytes, uint8_t alignment, size_t &oldSize)
+{
+	FATAL_ASSERT(ptr != nullptr);
+	FATAL_ASSERT(bytes > 0);
+	FATAL_ASSERT_MSG((alignment & (alignment - 1)) == 0, "The alignment should be a power of two");
+	FATAL_ASSERT_MSG(alignment >= 1 && alignment <= 128, "The alignment must be between 1 and 128");
+
+	FATAL_ASSERT(allocator);
+	const BlockHeader *header = blockHeader(ptr);
+	// The usable size of a big allocation is at least the requested one
+	oldSize = (header->sizeClass == BigClass) ? header->size - header->offset : header->size;
+
+	// The allocation is kept if it is big enough, otherwise `IAllocator` allocates a new one and performs a copy
+	if (bytes <= oldSize && PointerMath::alignAdjustment(ptr, alignment) == 0)
+		return ptr;
+
+	return nullptr;
+}
+
+void ThreadCachingAllocator::deallocateImpl(IAllocator *allocator, void *ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	FATAL_ASSERT(allocator);
+	ThreadCachingAllocator *allocatorImpl = static_cast<ThreadCachingAllocator *>(allocator);
+
+	const unsigned int blockClass = blockHeader(ptr)->sizeClass;
+	if (blockClass == BigClass)
+	{
+		allocatorImpl->deallocateBig(ptr);
+		return;
+	}
+	FATAL_ASSERT(blockClass < NumSizeClasses);
+
+	ThreadCache *cache = allocatorImpl->threadCache();
+	if (cache)
+	{
+		Magazine &magazine = cache->magazines[blockClass];
+		if (magazine.count == MagazineCapacity)
+			allocatorImpl->flush(magazine, blockClass);
+		magazine.blocks[magazine.count++] = ptr;
+		return;
+	}
+
+	allocatorImpl->acquireLock();
+	nextFreeBlock(ptr) = allocatorImpl->depot_[blockClass];
+	allocatorImpl->depot_[blockClass] = ptr;
+	allocatorImpl->releaseLock();
+}
+
+}
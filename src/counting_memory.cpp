@@ -0,0 +1,43 @@
+#include <cstdlib>
+
+#ifdef WITH_ALLOCATORS
+	#include "allocators_config.h"
+#endif
+
+#include "AllocationCounter.h"
+
+#ifndef OVERRIDE_NEW
+void *operator new(std::size_t count)
+{
+	auto ptr = malloc(count);
+	ncine::AllocationCounter::countAllocation(count);
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	free(ptr);
+}
+
+void *operator new[](std::size_t count)
+{
+	auto ptr = malloc(count);
+	ncine::AllocationCounter::countAllocation(count);
+	return ptr;
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+	free(ptr);
+}
+#endif
@@ -0,0 +1,191 @@
+#include <nctl/algorithms.h>
+#include "common_macros.h"
+#include "AsyncTextureLoader.h"
+#include "ServiceLocator.h"
+#include "TimeStamp.h"
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AsyncTextureLoader::AsyncTextureLoader()
+    : requests_(16)
+{
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	for (nctl::UniquePtr<Request> &request : requests_)
+	{
+		if (request->texture)
+			request->texture->isLoading_ = false;
+
+		// Jobs write into the request, it cannot be destroyed before they finish
+		if (request->job && request->isDecoded.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0)
+			threadPool.wait(request->job);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int AsyncTextureLoader::numDecodingRequests()
+{
+	unsigned int numDecoding = 0;
+	for (nctl::UniquePtr<Request> &request : requests_)
+	{
+		// Requests being completed by `update()` have already been moved out of the array
+		if (request && request->job && request->isDecoded.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0)
+			numDecoding++;
+	}
+
+	return numDecoding;
+}
+
+/*! \note Half of the worker threads are left free for the jobs of the frame */
+unsigned int AsyncTextureLoader::maxDecodingRequests() const
+{
+	return nctl::max(theServiceLocator().threadPool().numThreads() / 2, 1U);
+}
+
+void AsyncTextureLoader::enqueue(Texture *texture, const char *filename, Texture::LoadedCallback callback, void *userData)
+{
+	ASSERT(texture);
+	ASSERT(filename);
+
+	cancel(texture);
+	requests_.pushBack(nctl::makeUnique<Request>(texture, filename, callback, userData));
+	texture->isLoading_ = true;
+
+	submitDecodingJobs();
+}
+
+void AsyncTextureLoader::cancel(Texture *texture)
+{
+	const int index = findRequest(texture);
+	if (index >= 0)
+	{
+		requests_[index]->texture = nullptr;
+		texture->isLoading_ = false;
+	}
+}
+
+void AsyncTextureLoader::replace(Texture *oldTexture, Texture *newTexture)
+{
+	const int index = findRequest(oldTexture);
+	if (index >= 0)
+		requests_[index]->texture = newTexture;
+}
+
+void AsyncTextureLoader::update(float maxUploadTime)
+{
+	if (requests_.isEmpty())
+		return;
+
+	ZoneScoped;
+	const TimeStamp startTime = TimeStamp::now();
+	unsigned int numUploads = 0;
+	unsigned int numKept = 0;
+
+	for (unsigned int i = 0; i < requests_.size(); i++)
+	{
+		const bool canUpload = (numUploads == 0 || startTime.millisecondsSince() < maxUploadTime);
+
+		// A cancelled request that has not been submitted yet can be discarded right away
+		if (requests_[i]->job == nullptr && requests_[i]->texture == nullptr)
+			continue;
+
+		// Requests are kept in order, a request waiting for its job or for the next frame keeps its position
+		if (requests_[i]->isDecoded.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0 || (requests_[i]->texture && canUpload == false))
+		{
+			if (numKept != i)
+				requests_[numKept] = nctl::move(requests_[i]);
+			numKept++;
+			continue;
+		}
+
+		// The request is moved out of the array as the callback might enqueue or cancel other requests
+		nctl::UniquePtr<Request> request(nctl::move(requests_[i]));
+		Texture *texture = request->texture;
+		if (texture)
+		{
+			texture->isLoading_ = false;
+			bool hasLoaded = request->texLoader->hasLoaded();
+			if (hasLoaded)
+			{
+				hasLoaded = texture->loadFromLoader(request->filename.data(), *request->texLoader);
+				numUploads++;
+			}
+			if (hasLoaded == false)
+				LOGE_X("Texture \"%s\" cannot be loaded", request->filename.data());
+
+			if (request->callback)
+				request->callback(*texture, hasLoaded, request->userData);
+		}
+	}
+	requests_.setSize(numKept);
+
+	// Decoding jobs that have finished since the last submission have made room for new ones
+	submitDecodingJobs();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int AsyncTextureLoader::findRequest(const Texture *texture) const
+{
+	for (unsigned int i = 0; i < requests_.size(); i++)
+	{
+		// Requests being completed by `update()` have already been moved out of the array
+		if (requests_[i] && requests_[i]->texture == texture)
+			return static_cast<int>(i);
+	}
+
+	return -1;
+}
+
+void AsyncTextureLoader::submitDecodingJobs()
+{
+	const unsigned int maxDecoding = maxDecodingRequests();
+	unsigned int numDecoding = numDecodingRequests();
+	if (numDecoding >= maxDecoding)
+		return;
+
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	for (nctl::UniquePtr<Request> &request : requests_)
+	{
+		if (request == nullptr || request->job || request->texture == nullptr)
+			continue;
+
+		const Request *requestPtr = request.get();
+		request->job = threadPool.createJob(decodeJob, &requestPtr, sizeof(Request *));
+		threadPool.runInBackground(request->job);
+
+		// Without worker threads the job has already been executed
+		if (request->isDecoded.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0)
+			numDecoding++;
+		if (numDecoding >= maxDecoding)
+			break;
+	}
+}
+
+void AsyncTextureLoader::decodeJob(JobId job, const void *data)
+{
+	ZoneScoped;
+	Request *request = *static_cast<Request *const *>(data);
+	ZoneText(request->filename.data(), request->filename.length());
+
+	request->texLoader = ITextureLoader::createFromFile(request->filename.data());
+	// Levels of GPU-ready formats are read here, not by the upload on the main thread
+	if (request->texLoader->hasLoaded())
+		request->texLoader->readStreamedPixels();
+	request->isDecoded.store(1, nctl::Atomic32::MemoryModel::RELEASE);
+}
+
+}
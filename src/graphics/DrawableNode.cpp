@@ -6,6 +6,7 @@
 #include "Viewport.h"
 #include "Application.h"
 #include "RenderStatistics.h"
+#include "SpatialGrid.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -77,7 +78,7 @@ const Vector2f DrawableNode::AnchorTopRight(1.0f, 1.0f);
 DrawableNode::DrawableNode(SceneNode *parent, float xx, float yy)
     : SceneNode(parent, xx, yy), width_(0.0f), height_(0.0f),
       renderCommand_(nctl::makeUnique<RenderCommand>()),
-      lastFrameRendered_(0)
+      lastFrameRendered_(0), spatialGrid_(nullptr), spatialGridCell_(0), spatialGridSlot_(0)
 {
 	renderCommand_->setIdSortKey(id());
 }
@@ -97,11 +98,39 @@ DrawableNode::DrawableNode()
 {
 }
 
-DrawableNode::~DrawableNode() = default;
+DrawableNode::~DrawableNode()
+{
+	if (spatialGrid_)
+		spatialGrid_->remove(this);
+}
+
+DrawableNode::DrawableNode(DrawableNode &&other)
+    : SceneNode(nctl::move(other)), width_(other.width_), height_(other.height_),
+      renderCommand_(nctl::move(other.renderCommand_)), lastFrameRendered_(other.lastFrameRendered_),
+      aabb_(other.aabb_), spatialGrid_(nullptr), spatialGridCell_(0), spatialGridSlot_(0)
+{
+	// The grid should not keep pointing to the moved-from node
+	if (other.spatialGrid_)
+		other.spatialGrid_->replace(&other, this);
+}
+
+DrawableNode &DrawableNode::operator=(DrawableNode &&other)
+{
+	SceneNode::operator=(nctl::move(other));
+
+	width_ = other.width_;
+	height_ = other.height_;
+	renderCommand_ = nctl::move(other.renderCommand_);
+	lastFrameRendered_ = other.lastFrameRendered_;
+	aabb_ = other.aabb_;
 
-DrawableNode::DrawableNode(DrawableNode &&) = default;
+	if (spatialGrid_)
+		spatialGrid_->remove(this);
+	if (other.spatialGrid_)
+		other.spatialGrid_->replace(&other, this);
 
-DrawableNode &DrawableNode::operator=(DrawableNode &&) = default;
+	return *this;
+}
 
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -220,17 +249,29 @@ void DrawableNode::updateAabb()
 	aabb_ = Rectf::fromCenterSize(absPosition_.x, absPosition_.y, rotatedWidth, rotatedHeight);
 }
 
-void DrawableNode::updateCulling()
+bool DrawableNode::updateCulling(SpatialGrid *spatialGrid)
 {
 	const bool cullingEnabled = theApplication().renderingSettings().cullingEnabled;
-	if (drawEnabled_ && cullingEnabled && width_ > 0 && height_ > 0)
+	if (cullingEnabled == false)
+		return false;
+
+	if (drawEnabled_ && width_ > 0 && height_ > 0)
 	{
-		if (dirtyBits_.test(DirtyBitPositions::AabbBit))
+		const bool aabbChanged = dirtyBits_.test(DirtyBitPositions::AabbBit);
+		if (aabbChanged)
 		{
 			updateAabb();
 			dirtyBits_.reset(DirtyBitPositions::AabbBit);
 		}
 
+		// A node can only be stored in one grid, other viewports sharing it fall back to the direct test
+		if (spatialGrid && (spatialGrid_ == nullptr || spatialGrid_ == spatialGrid))
+		{
+			if (aabbChanged || spatialGrid_ == nullptr)
+				spatialGrid->update(this);
+			return true;
+		}
+
 		// Check if at least one viewport in the chain overlaps with this node
 		if (lastFrameRendered_ < theApplication().numFrames())
 		{
@@ -239,14 +280,20 @@ void DrawableNode::updateCulling()
 			if (overlaps)
 				lastFrameRendered_ = theApplication().numFrames();
 		}
+		return false;
 	}
+
+	// A node that cannot be drawn is not stored, it will be inserted again when it can
+	if (spatialGrid_)
+		spatialGrid_->remove(this);
+	return false;
 }
 
 DrawableNode::DrawableNode(const DrawableNode &other)
     : SceneNode(other),
       width_(other.width_), height_(other.height_),
       renderCommand_(nctl::makeUnique<RenderCommand>()),
-      lastFrameRendered_(0)
+      lastFrameRendered_(0), spatialGrid_(nullptr), spatialGridCell_(0), spatialGridSlot_(0)
 {
 	renderCommand_->setIdSortKey(id());
 	setBlendingEnabled(other.isBlendingEnabled());
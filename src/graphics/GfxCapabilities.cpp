@@ -90,16 +90,21 @@ void GfxCapabilities::init()
 	glGetIntegerv(GL_MAX_VERTEX_ATTRIB_STRIDE, &glIntValues_[GLIntValues::MAX_VERTEX_ATTRIB_STRIDE]);
 #endif
 	glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &glIntValues_[GLIntValues::MAX_COLOR_ATTACHMENTS]);
+#if !defined(__EMSCRIPTEN__) && (!defined(WITH_OPENGLES) || (defined(WITH_OPENGLES) && GL_ES_VERSION_3_2))
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &glIntValues_[GLIntValues::MAX_TEXTURE_BUFFER_SIZE]);
+#endif
 
 #ifndef __EMSCRIPTEN__
 	const char *extensionNames[GLExtensions::COUNT] = {
 		"GL_KHR_debug", "GL_ARB_texture_storage", "GL_EXT_texture_compression_s3tc", "GL_OES_compressed_ETC1_RGB8_texture",
-		"GL_AMD_compressed_ATC_texture", "GL_IMG_texture_compression_pvrtc", "GL_KHR_texture_compression_astc_ldr"
+		"GL_AMD_compressed_ATC_texture", "GL_IMG_texture_compression_pvrtc", "GL_KHR_texture_compression_astc_ldr",
+		"GL_ARB_buffer_storage"
 	};
 #else
 	const char *extensionNames[GLExtensions::COUNT] = {
 		"GL_KHR_debug", "GL_ARB_texture_storage", "WEBGL_compressed_texture_s3tc", "WEBGL_compressed_texture_etc1",
-		"WEBGL_compressed_texture_atc", "WEBGL_compressed_texture_pvrtc", "WEBGL_compressed_texture_astc"
+		"WEBGL_compressed_texture_atc", "WEBGL_compressed_texture_pvrtc", "WEBGL_compressed_texture_astc",
+		"GL_ARB_buffer_storage"
 	};
 #endif
 
@@ -144,6 +149,9 @@ void GfxCapabilities::logGLCaps() const
 	LOGI_X("GL_MAX_VERTEX_ATTRIB_STRIDE: %d", glIntValues_[GLIntValues::MAX_VERTEX_ATTRIB_STRIDE]);
 #endif
 	LOGI_X("GL_MAX_COLOR_ATTACHMENTS: %d", glIntValues_[GLIntValues::MAX_COLOR_ATTACHMENTS]);
+#if !defined(__EMSCRIPTEN__) && (!defined(WITH_OPENGLES) || (defined(WITH_OPENGLES) && GL_ES_VERSION_3_2))
+	LOGI_X("GL_MAX_TEXTURE_BUFFER_SIZE: %d", glIntValues_[GLIntValues::MAX_TEXTURE_BUFFER_SIZE]);
+#endif
 	LOGI("---");
 	LOGI_X("GL_KHR_debug: %d", glExtensions_[GLExtensions::KHR_DEBUG]);
 	LOGI_X("GL_ARB_texture_storage: %d", glExtensions_[GLExtensions::ARB_TEXTURE_STORAGE]);
@@ -152,6 +160,7 @@ void GfxCapabilities::logGLCaps() const
 	LOGI_X("GL_AMD_compressed_ATC_texture: %d", glExtensions_[GLExtensions::AMD_COMPRESSED_ATC_TEXTURE]);
 	LOGI_X("GL_IMG_texture_compression_pvrtc: %d", glExtensions_[GLExtensions::IMG_TEXTURE_COMPRESSION_PVRTC]);
 	LOGI_X("GL_KHR_texture_compression_astc_ldr: %d", glExtensions_[GLExtensions::KHR_TEXTURE_COMPRESSION_ASTC_LDR]);
+	LOGI_X("GL_ARB_buffer_storage: %d", glExtensions_[GLExtensions::ARB_BUFFER_STORAGE]);
 	LOGI("--- OpenGL device capabilities ---");
 }
 
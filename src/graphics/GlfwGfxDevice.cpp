@@ -165,6 +165,9 @@ void GlfwGfxDevice::setWindowSize(int width, int height)
 void GlfwGfxDevice::setWindowIcon(const char *windowIconFilename)
 {
 	nctl::UniquePtr<ITextureLoader> image = ITextureLoader::createFromFile(windowIconFilename);
+	if (image->hasLoaded() == false || image->readStreamedPixels() == false)
+		return;
+
 	GLFWimage glfwImage;
 	glfwImage.width = image->width();
 	glfwImage.height = image->height();
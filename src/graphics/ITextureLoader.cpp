@@ -22,13 +22,13 @@ namespace ncine {
 
 ITextureLoader::ITextureLoader()
     : hasLoaded_(false), width_(0), height_(0),
-      headerSize_(0), dataSize_(0), mipMapCount_(1)
+      headerSize_(0), dataSize_(0), mipMapCount_(1), mappedPixels_(nullptr), isStreamed_(false)
 {
 }
 
 ITextureLoader::ITextureLoader(nctl::UniquePtr<IFile> fileHandle)
     : hasLoaded_(false), fileHandle_(nctl::move(fileHandle)),
-      width_(0), height_(0), headerSize_(0), dataSize_(0), mipMapCount_(1)
+      width_(0), height_(0), headerSize_(0), dataSize_(0), mipMapCount_(1), mappedPixels_(nullptr), isStreamed_(false)
 {
 }
 
@@ -51,18 +51,56 @@ long ITextureLoader::dataSize(unsigned int mipMapLevel) const
 const GLubyte *ITextureLoader::pixels(unsigned int mipMapLevel) const
 {
 	const GLubyte *pixels = nullptr;
+	const GLubyte *basePixels = this->pixels();
 
-	if (pixels_ != nullptr)
+	if (basePixels != nullptr)
 	{
 		if (mipMapCount_ > 1 && int(mipMapLevel) < mipMapCount_)
-			pixels = pixels_.get() + mipDataOffsets_[mipMapLevel];
+			pixels = basePixels + mipDataOffsets_[mipMapLevel];
 		else if (mipMapLevel == 0)
-			pixels = pixels_.get();
+			pixels = basePixels;
 	}
 
 	return pixels;
 }
 
+const GLubyte *ITextureLoader::levelPixels(unsigned int mipMapLevel, GLubyte *levelBuffer) const
+{
+	if (isStreamed_ == false)
+		return pixels(mipMapLevel);
+
+	ASSERT(levelBuffer);
+	const long int levelSize = dataSize(mipMapLevel);
+	if (levelSize == 0)
+		return nullptr;
+
+	const unsigned long levelOffset = (mipMapCount_ > 1) ? mipDataOffsets_[mipMapLevel] : 0;
+	fileHandle_->seek(headerSize_ + levelOffset, SEEK_SET);
+	const unsigned long int bytesRead = fileHandle_->read(levelBuffer, levelSize);
+
+	return (bytesRead == static_cast<unsigned long int>(levelSize)) ? levelBuffer : nullptr;
+}
+
+bool ITextureLoader::readStreamedPixels()
+{
+	if (isStreamed_ == false)
+		return true;
+
+	pixels_ = nctl::makeUnique<GLubyte[]>(dataSize_);
+	fileHandle_->seek(headerSize_, SEEK_SET);
+	const unsigned long int bytesRead = fileHandle_->read(pixels_.get(), dataSize_);
+	if (bytesRead != dataSize_)
+	{
+		LOGE_X("Cannot read %lu bytes of pixel data from \"%s\"", dataSize_, fileHandle_->filename());
+		pixels_.reset(nullptr);
+		hasLoaded_ = false;
+		return false;
+	}
+
+	isStreamed_ = false;
+	return true;
+}
+
 nctl::UniquePtr<ITextureLoader> ITextureLoader::createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
 {
 	LOGI_X("Loading memory file: \"%s\" (0x%lx, %lu bytes)", bufferName, bufferPtr, bufferSize);
@@ -72,8 +110,8 @@ nctl::UniquePtr<ITextureLoader> ITextureLoader::createFromMemory(const char *buf
 nctl::UniquePtr<ITextureLoader> ITextureLoader::createFromFile(const char *filename)
 {
 	LOGI_X("Loading file: \"%s\"", filename);
-	// Creating a handle from IFile static method to detect assets file
-	return createLoader(nctl::move(IFile::createFileHandle(filename)), filename);
+	// Creating a handle from IFile static method to detect assets file, pixel data can then be read from the mapping
+	return createLoader(nctl::move(IFile::createMappedFileHandle(filename)), filename);
 }
 
 ///////////////////////////////////////////////////////////
@@ -126,10 +164,15 @@ void ITextureLoader::loadPixels(GLenum internalFormat, GLenum type)
 		fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 
 	dataSize_ = fileHandle_->size() - headerSize_;
-	fileHandle_->seek(headerSize_, SEEK_SET);
 
-	pixels_ = nctl::makeUnique<unsigned char[]>(dataSize_);
-	fileHandle_->read(pixels_.get(), dataSize_);
+	// Memory-mapped or memory files are not copied, the file handle is kept open as long as the loader
+	if (fileHandle_->data() != nullptr)
+		mappedPixels_ = fileHandle_->data() + headerSize_;
+	else
+	{
+		// Pixel data does not need decoding, levels are read one by one at upload time instead of holding the whole chain
+		isStreamed_ = true;
+	}
 }
 
 }
@@ -17,6 +17,7 @@
 #endif
 
 #include "RenderStatistics.h"
+#include "AllocationCounter.h"
 #ifdef WITH_LUA
 	#include "LuaStatistics.h"
 #endif
@@ -27,6 +28,7 @@
 
 #ifdef WITH_ALLOCATORS
 	#include "allocators_config.h"
+	#include <nctl/FrameAllocator.h>
 #endif
 
 #include "version.h"
@@ -78,7 +80,7 @@ ImGuiDebugOverlay::ImGuiDebugOverlay(float profileTextUpdateTime)
     : IDebugOverlay(profileTextUpdateTime), disableAppInputEvents_(false), appInputHandler_(nullptr),
       lockOverlayPositions_(true), showTopLeftOverlay_(true), showTopRightOverlay_(true),
       showBottomLeftOverlay_(true), showBottomRightOverlay_(true), numValues_(128),
-      maxFrameTime_(0.0f), maxUpdateVisitDraw_(0.0f), index_(0), widgetName_(256),
+      maxFrameTime_(0.0f), maxUpdateVisitDraw_(0.0f), index_(0), widgetName_(256), auxString_(256),
       plotAdditionalFrameValues_(false), plotOverlayValues_(false), comboVideoModes_(4096)
 #ifdef WITH_RENDERDOC
       ,
@@ -476,6 +478,9 @@ void ImGuiDebugOverlay::guiPreprocessorDefines()
 #ifdef WITH_QT5
 			ImGui::TextUnformatted("WITH_QT5");
 #endif
+#ifdef WITH_NULL_GFX
+			ImGui::TextUnformatted("WITH_NULL_GFX");
+#endif
 #ifdef WITH_AUDIO
 			ImGui::TextUnformatted("WITH_AUDIO");
 #endif
@@ -594,6 +599,9 @@ void ImGuiDebugOverlay::guiGraphicsCapabilities()
 		ImGui::Text("GL_MAX_VERTEX_ATTRIB_STRIDE: %d", gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_VERTEX_ATTRIB_STRIDE));
 #endif
 		ImGui::Text("GL_MAX_COLOR_ATTACHMENTS: %d", gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_COLOR_ATTACHMENTS));
+#if !defined(__EMSCRIPTEN__) && (!defined(WITH_OPENGLES) || (defined(WITH_OPENGLES) && GL_ES_VERSION_3_2))
+		ImGui::Text("GL_MAX_TEXTURE_BUFFER_SIZE: %d", gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_TEXTURE_BUFFER_SIZE));
+#endif
 
 		ImGui::Separator();
 		ImGui::Text("GL_KHR_debug: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_DEBUG));
@@ -603,6 +611,7 @@ void ImGuiDebugOverlay::guiGraphicsCapabilities()
 		ImGui::Text("GL_AMD_compressed_ATC_texture: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::AMD_COMPRESSED_ATC_TEXTURE));
 		ImGui::Text("GL_IMG_texture_compression_pvrtc: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::IMG_TEXTURE_COMPRESSION_PVRTC));
 		ImGui::Text("GL_KHR_texture_compression_astc_ldr: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_TEXTURE_COMPRESSION_ASTC_LDR));
+		ImGui::Text("GL_ARB_buffer_storage: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BUFFER_STORAGE));
 	}
 }
 
@@ -648,9 +657,12 @@ void ImGuiDebugOverlay::guiApplicationConfiguration()
 
 		ImGui::Separator();
 		ImGui::Text("Buffer mapping: %s", appCfg.useBufferMapping ? "true" : "false");
+		ImGui::Text("Persistent mapping: %s", appCfg.usePersistentMapping ? "true" : "false");
 		ImGui::Text("Defer shader queries: %s", appCfg.deferShaderQueries ? "true" : "false");
+		ImGui::Text("Texture buffer batching: %s", appCfg.useTextureBufferBatching ? "true" : "false");
 		ImGui::Text("VBO size: %lu", appCfg.vboSize);
 		ImGui::Text("IBO size: %lu", appCfg.iboSize);
+		ImGui::Text("TBO size: %lu", appCfg.tboSize);
 		ImGui::Text("Vao pool size: %u", appCfg.vaoPoolSize);
 		ImGui::Text("RenderCommand pool size: %u", appCfg.renderCommandPoolSize);
 
@@ -658,10 +670,14 @@ void ImGuiDebugOverlay::guiApplicationConfiguration()
 		ImGui::Text("Debug Overlay: %s", appCfg.withDebugOverlay ? "true" : "false");
 		ImGui::Text("Audio: %s", appCfg.withAudio ? "true" : "false");
 		ImGui::Text("Threads: %s", appCfg.withThreads ? "true" : "false");
+		ImGui::Text("Parallel Update: %s (depth: %u, min nodes: %u)", appCfg.withParallelUpdate ? "true" : "false",
+		            appCfg.parallelUpdateDepth, appCfg.parallelUpdateMinNodes);
 		ImGui::Text("Scenegraph: %s", appCfg.withScenegraph ? "true" : "false");
 		ImGui::Text("VSync: %s", appCfg.withVSync ? "true" : "false");
 		ImGui::Text("%s Debug Context: %s", openglApiName, appCfg.withGlDebugContext ? "true" : "false");
 		ImGui::Text("Console Colors: %s", appCfg.withConsoleColors ? "true" : "false");
+		ImGui::Text("Headless Frames: %u", appCfg.headlessFrames);
+		ImGui::Text("Headless report: %s", appCfg.headlessReportFile.data());
 	}
 }
 
@@ -677,8 +693,15 @@ void ImGuiDebugOverlay::guiRenderingSettings()
 		ImGui::SameLine();
 		ImGui::Checkbox("Batching with indices", &settings.batchingWithIndices);
 		ImGui::SameLine();
+		ImGui::Checkbox("Parallel batching", &settings.parallelBatchingEnabled);
+		ImGui::SameLine();
+		ImGui::Checkbox("Glyph instancing", &settings.glyphInstancingEnabled);
+		ImGui::SameLine();
 		ImGui::Checkbox("Culling", &settings.cullingEnabled);
-		ImGui::DragIntRange2("Batch size", &minBatchSize, &maxBatchSize, 1.0f, 0, 512);
+		// Batches are not limited by the size of a uniform buffer when instance data is written to texture buffers
+		const int batchSizeLimit = theApplication().appConfiguration().useTextureBufferBatching ? 32768 : 512;
+		ImGui::DragIntRange2("Batch size", &minBatchSize, &maxBatchSize, 1.0f, 0, batchSizeLimit);
+		ImGui::SliderFloat("Texture upload time", &settings.maxTextureUploadTime, 0.0f, 16.0f, "%.1f ms");
 
 		settings.minBatchSize = minBatchSize;
 		settings.maxBatchSize = maxBatchSize;
@@ -871,14 +894,14 @@ void ImGuiDebugOverlay::guiInputState()
 
 		if (ImGui::TreeNode("Keyboard"))
 		{
-			nctl::String pressedKeys;
+			auxString_.clear();
 			const KeyboardState &keyState = input.keyboardState();
 			for (unsigned int i = 0; i < static_cast<int>(KeySym::COUNT); i++)
 			{
 				if (keyState.isKeyDown(static_cast<KeySym>(i)))
-					pressedKeys.formatAppend("%d ", i);
+					auxString_.formatAppend("%d ", i);
 			}
-			ImGui::Text("Keys pressed: %s", pressedKeys.data());
+			ImGui::Text("Keys pressed: %s", auxString_.data());
 			ImGui::TreePop();
 		}
 
@@ -889,18 +912,18 @@ void ImGuiDebugOverlay::guiInputState()
 			const MouseState &mouseState = input.mouseState();
 			ImGui::Text("Position: %d, %d", mouseState.x, mouseState.y);
 
-			nctl::String pressedMouseButtons(32);
+			auxString_.clear();
 			if (mouseState.isLeftButtonDown())
-				pressedMouseButtons.append("left ");
+				auxString_.append("left ");
 			if (mouseState.isRightButtonDown())
-				pressedMouseButtons.append("right ");
+				auxString_.append("right ");
 			if (mouseState.isMiddleButtonDown())
-				pressedMouseButtons.append("middle ");
+				auxString_.append("middle ");
 			if (mouseState.isFourthButtonDown())
-				pressedMouseButtons.append("fourth ");
+				auxString_.append("fourth ");
 			if (mouseState.isFifthButtonDown())
-				pressedMouseButtons.append("fifth");
-			ImGui::Text("Pressed buttons: %s", pressedMouseButtons.data());
+				auxString_.append("fifth");
+			ImGui::Text("Pressed buttons: %s", auxString_.data());
 			ImGui::TreePop();
 		}
 
@@ -933,13 +956,13 @@ void ImGuiDebugOverlay::guiInputState()
 						ImGui::Separator();
 
 						const JoystickState &joyState = input.joystickState(joyId);
-						nctl::String pressedButtons;
+						auxString_.clear();
 						for (int buttonId = 0; buttonId < input.joyNumButtons(joyId); buttonId++)
 						{
 							if (joyState.isButtonPressed(buttonId))
-								pressedButtons.formatAppend("%d ", buttonId);
+								auxString_.formatAppend("%d ", buttonId);
 						}
-						ImGui::Text("Pressed buttons: %s", pressedButtons.data());
+						ImGui::Text("Pressed buttons: %s", auxString_.data());
 
 						for (int hatId = 0; hatId < input.joyNumHats(joyId); hatId++)
 						{
@@ -961,14 +984,14 @@ void ImGuiDebugOverlay::guiInputState()
 						{
 							ImGui::Separator();
 							const JoyMappedState &joyMappedState = input.joyMappedState(joyId);
-							nctl::String pressedMappedButtons(64);
+							auxString_.clear();
 							for (unsigned int buttonId = 0; buttonId < JoyMappedState::NumButtons; buttonId++)
 							{
 								const ButtonName buttonName = static_cast<ButtonName>(buttonId);
 								if (joyMappedState.isButtonPressed(buttonName))
-									pressedMappedButtons.formatAppend("%s ", mappedButtonNameToString(buttonName));
+									auxString_.formatAppend("%s ", mappedButtonNameToString(buttonName));
 							}
-							ImGui::Text("Pressed buttons: %s", pressedMappedButtons.data());
+							ImGui::Text("Pressed buttons: %s", auxString_.data());
 
 							for (unsigned int axisId = 0; axisId < JoyMappedState::NumAxes; axisId++)
 							{
@@ -1180,6 +1203,11 @@ void ImGuiDebugOverlay::guiAllocators()
 		else
 			ImGui::TextUnformatted("The ImGui allocator is the default one");
 
+		const nctl::FrameAllocator &frameAllocator = nctl::theFrameAllocator();
+		ImGui::BulletText("Frame Allocator \"%s\" (%lu bytes per frame, %lu bytes last frame, %lu bytes peak, %u overflows)",
+		                  frameAllocator.name(), frameAllocator.frameCapacity(), frameAllocator.lastFrameUsedMemory(),
+		                  frameAllocator.highWaterMark(), frameAllocator.lastFrameNumOverflows());
+
 	#ifdef WITH_NUKLEAR
 		if (&nctl::theNuklearAllocator() != &nctl::theDefaultAllocator())
 		{
@@ -1401,13 +1429,13 @@ void ImGuiDebugOverlay::guiRecursiveChildrenNodes(SceneNode *node, unsigned int
 		}
 		if (textnode)
 		{
-			nctl::String textnodeString(textnode->string());
-			if (ImGui::InputTextMultiline("String", textnodeString.data(), textnodeString.capacity(),
+			auxString_ = textnode->string();
+			if (ImGui::InputTextMultiline("String", auxString_.data(), auxString_.capacity(),
 			                              ImVec2(0.0f, 3.0f * ImGui::GetTextLineHeightWithSpacing()),
 			                              ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackResize,
-			                              inputTextCallback, &textnodeString))
+			                              inputTextCallback, &auxString_))
 			{
-				textnode->setString(textnodeString);
+				textnode->setString(auxString_);
 			}
 		}
 
@@ -1471,6 +1499,8 @@ void ImGuiDebugOverlay::guiTopLeft()
 	const RenderStatistics::Buffers &vboBuffers = RenderStatistics::buffers(RenderBuffersManager::BufferTypes::ARRAY);
 	const RenderStatistics::Buffers &iboBuffers = RenderStatistics::buffers(RenderBuffersManager::BufferTypes::ELEMENT_ARRAY);
 	const RenderStatistics::Buffers &uboBuffers = RenderStatistics::buffers(RenderBuffersManager::BufferTypes::UNIFORM);
+	const RenderStatistics::Buffers &tboBuffers = RenderStatistics::buffers(RenderBuffersManager::BufferTypes::TEXTURE);
+	const RenderStatistics::FrameArena &frameArena = RenderStatistics::frameArena();
 
 	const ImVec2 windowPos = ImVec2(Margin, Margin);
 	const ImVec2 windowPosPivot = ImVec2(0.0f, 0.0f);
@@ -1490,8 +1520,8 @@ void ImGuiDebugOverlay::guiTopLeft()
 			ImGui::PlotLines("", plotValues_[ValuesType::CULLED_NODES].get(), numValues_, 0, nullptr, 0.0f, FLT_MAX);
 		}
 
-		ImGui::Text("%u/%u VAOs (%u reuses, %u bindings)", vaoPool.size, vaoPool.capacity, vaoPool.reuses, vaoPool.bindings);
-		ImGui::Text("%u/%u RenderCommands in the pool (%u retrievals)", commandPool.usedSize, commandPool.usedSize + commandPool.freeSize, commandPool.retrievals);
+		ImGui::Text("%u/%u VAOs (%u reuses, %u bindings, %.1f%% hits)", vaoPool.size, vaoPool.capacity, vaoPool.reuses, vaoPool.bindings, vaoPool.hitRate() * 100.0f);
+		ImGui::Text("%u/%u RenderCommands in the pool (%u retrievals, %.1f%% hits)", commandPool.usedSize, commandPool.usedSize + commandPool.freeSize, commandPool.retrievals, commandPool.hitRate() * 100.0f);
 		ImGui::Text("%.2f Kb in %u Texture(s)", textures.dataSize / 1024.0f, textures.count);
 		ImGui::Text("%.2f Kb in %u custom VBO(s)", customVbos.dataSize / 1024.0f, customVbos.count);
 		ImGui::Text("%.2f Kb in %u custom IBO(s)", customIbos.dataSize / 1024.0f, customIbos.count);
@@ -1516,6 +1546,29 @@ void ImGuiDebugOverlay::guiTopLeft()
 			ImGui::PlotLines("", plotValues_[ValuesType::UBO_USED].get(), numValues_, 0, nullptr, 0.0f, uboBuffers.size / 1024.0f);
 		}
 
+		if (tboBuffers.count > 0)
+			ImGui::Text("%.2f/%lu Kb in %u TBO(s)", tboBuffers.usedSpace / 1024.0f, tboBuffers.size / 1024, tboBuffers.count);
+
+		if (vboBuffers.ringSections > 1)
+		{
+			const unsigned int fenceWaits = vboBuffers.fenceWaits + iboBuffers.fenceWaits + uboBuffers.fenceWaits;
+			const float fenceWaitTime = vboBuffers.fenceWaitTime + iboBuffers.fenceWaitTime + uboBuffers.fenceWaitTime;
+			ImGui::Text("%u ring sections in %lu Kb, %u fence waits (%.2f ms)", vboBuffers.ringSections,
+			            (vboBuffers.ringSize + iboBuffers.ringSize + uboBuffers.ringSize) / 1024, fenceWaits, fenceWaitTime);
+		}
+
+		if (frameArena.capacity > 0)
+		{
+			ImGui::Text("%.2f/%lu Kb in the frame arena (%.2f Kb peak, %u overflows)", frameArena.usedMemory / 1024.0f,
+			            frameArena.capacity / 1024, frameArena.highWaterMark / 1024.0f, frameArena.overflows);
+		}
+
+		if (AllocationCounter::isAvailable())
+		{
+			const AllocationCounter::Counters lastFrameAllocations = AllocationCounter::lastFrame();
+			ImGui::Text("%lu allocation(s) of %.2f Kb in the last frame", lastFrameAllocations.numAllocations, lastFrameAllocations.bytes / 1024.0f);
+		}
+
 		ImGui::Text("Viewport chain length: %u", Viewport::chain().size());
 
 		ImGui::End();
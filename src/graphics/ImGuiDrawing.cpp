@@ -12,7 +12,9 @@
 #include "RenderResources.h"
 #include "Application.h"
 
-#if defined(WITH_GLFW)
+#if defined(WITH_NULL_GFX)
+	#include "ImGuiNullInput.h"
+#elif defined(WITH_GLFW)
 	#include "ImGuiGlfwInput.h"
 #elif defined(WITH_SDL)
 	#include "ImGuiSdlInput.h"
@@ -109,7 +111,9 @@ bool ImGuiDrawing::buildFonts()
 
 void ImGuiDrawing::newFrame()
 {
-#if defined(WITH_GLFW)
+#if defined(WITH_NULL_GFX)
+	ImGuiNullInput::newFrame();
+#elif defined(WITH_GLFW)
 	ImGuiGlfwInput::newFrame();
 #elif defined(WITH_SDL)
 	ImGuiSdlInput::newFrame();
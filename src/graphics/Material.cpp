@@ -14,6 +14,9 @@ namespace ncine {
 
 const char *Material::InstanceBlockName = "InstanceBlock";
 const char *Material::InstancesBlockName = "InstancesBlock";
+// The names looked up by the batcher every frame fit in the small buffer of a string, creating the hash map key does not allocate
+const char *Material::InstancesTextureUniformName = "uInstancesTex";
+const char *Material::InstancesOffsetUniformName = "uInstancesBase";
 const char *Material::ModelMatrixUniformName = "modelMatrix";
 
 const char *Material::GuiProjectionMatrixUniformName = "uGuiProjection";
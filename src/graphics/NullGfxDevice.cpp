@@ -0,0 +1,138 @@
+#include "common_macros.h"
+#include "NullGfxDevice.h"
+#include "NullGL.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const char *NullGfxDevice::MonitorName = "Null monitor";
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+NullGfxDevice::NullGfxDevice(const WindowMode &windowMode, const GLContextInfo &glContextInfo, const DisplayMode &displayMode)
+    : IGfxDevice(windowMode, glContextInfo, displayMode), windowPosition_(0, 0), fsModeIndex_(0)
+{
+	initWindowScaling(windowMode);
+
+	// Asking for a video mode that does not change current screen resolution
+	if (width_ <= 0 || height_ <= 0)
+	{
+		width_ = monitors_[0].videoModes[0].width;
+		height_ = monitors_[0].videoModes[0].height;
+		isFullScreen_ = true;
+	}
+	windowedSize_.set(width_, height_);
+
+	if (windowMode.windowPositionX != AppConfiguration::WindowPositionIgnore)
+		windowPosition_.x = windowMode.windowPositionX;
+	if (windowMode.windowPositionY != AppConfiguration::WindowPositionIgnore)
+		windowPosition_.y = windowMode.windowPositionY;
+
+	drawableWidth_ = width_;
+	drawableHeight_ = height_;
+	initGLViewport();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void NullGfxDevice::setFullScreen(bool fullScreen)
+{
+	if (isFullScreen_ == fullScreen)
+		return;
+
+	if (fullScreen)
+	{
+		windowedSize_.set(width_, height_);
+		const VideoMode &mode = monitors_[0].videoModes[fsModeIndex_];
+		width_ = mode.width;
+		height_ = mode.height;
+	}
+	else
+	{
+		width_ = windowedSize_.x;
+		height_ = windowedSize_.y;
+	}
+
+	isFullScreen_ = fullScreen;
+	drawableWidth_ = width_;
+	drawableHeight_ = height_;
+}
+
+void NullGfxDevice::setWindowPosition(int x, int y)
+{
+	windowPosition_.set(x, y);
+}
+
+void NullGfxDevice::setWindowSize(int width, int height)
+{
+	// change resolution only in case it is valid and it really changes
+	if (width <= 0 || height <= 0 || (width == width_ && height == height_) || isFullScreen_)
+		return;
+
+	width_ = width;
+	height_ = height;
+	drawableWidth_ = width;
+	drawableHeight_ = height;
+}
+
+const IGfxDevice::VideoMode &NullGfxDevice::currentVideoMode(unsigned int monitorIndex) const
+{
+	currentVideoMode_ = monitors_[0].videoModes[isFullScreen_ ? fsModeIndex_ : 0];
+	return currentVideoMode_;
+}
+
+bool NullGfxDevice::setVideoMode(unsigned int modeIndex)
+{
+	const unsigned int numVideoModes = monitors_[0].numVideoModes;
+	ASSERT(modeIndex < numVideoModes);
+
+	if (modeIndex < numVideoModes)
+	{
+		fsModeIndex_ = modeIndex;
+		if (isFullScreen_)
+		{
+			const VideoMode &mode = monitors_[0].videoModes[modeIndex];
+			width_ = mode.width;
+			height_ = mode.height;
+			drawableWidth_ = width_;
+			drawableHeight_ = height_;
+		}
+		return true;
+	}
+	return false;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void NullGfxDevice::updateMonitors()
+{
+	numMonitors_ = 1;
+
+	Monitor &monitor = monitors_[0];
+	monitor.name = MonitorName;
+	monitor.position.set(0, 0);
+	monitor.scale.set(1.0f, 1.0f);
+	monitor.dpi.set(DefaultDpi, DefaultDpi);
+
+	monitor.numVideoModes = 1;
+	VideoMode &mode = monitor.videoModes[0];
+	mode.width = 1920;
+	mode.height = 1080;
+	mode.refreshRate = 60.0f;
+}
+
+void NullGfxDevice::update()
+{
+	NullGL::nextFrame();
+}
+
+}
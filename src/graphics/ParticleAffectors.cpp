@@ -1,9 +1,206 @@
+#include <cmath> // for nextafterf()
 #include <nctl/algorithms.h>
 #include "ParticleAffectors.h"
 #include "Particle.h"
+#include "ParticleData.h"
+#include "tracy.h"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define NCINE_AFFECTORS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NCINE_AFFECTORS_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define NCINE_AFFECTORS_NEON
+#endif
 
 namespace ncine {
 
+namespace {
+
+	/// Number of particles processed at a time by range affectors, to keep intermediate data in cache
+	const unsigned int BlockSize = 256;
+	/// The inverse length used for steps with the same age, turning their interpolation into a step function
+	const float MaxInverseLength = 1.0e30f;
+
+	/// Sets every output element to the same value
+	void fillRange(float *output, unsigned int count, float value)
+	{
+		unsigned int i = 0;
+#if defined(NCINE_AFFECTORS_AVX2)
+		const __m256 value8 = _mm256_set1_ps(value);
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(output + i, value8);
+#elif defined(NCINE_AFFECTORS_SSE2)
+		const __m128 value4 = _mm_set1_ps(value);
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(output + i, value4);
+#elif defined(NCINE_AFFECTORS_NEON)
+		const float32x4_t value4 = vdupq_n_f32(value);
+		for (; i + 4 <= count; i += 4)
+			vst1q_f32(output + i, value4);
+#endif
+		for (; i < count; i++)
+			output[i] = value;
+	}
+
+	/// Adds the contribution of a step segment to every output element
+	/*! The formula is `output += delta * clamp((age - startAge) * inverseLength, 0, 1)` */
+	void addSegmentRange(const float *ages, float *output, unsigned int count, float startAge, float inverseLength, float delta)
+	{
+		unsigned int i = 0;
+#if defined(NCINE_AFFECTORS_AVX2)
+		const __m256 startAge8 = _mm256_set1_ps(startAge);
+		const __m256 inverseLength8 = _mm256_set1_ps(inverseLength);
+		const __m256 delta8 = _mm256_set1_ps(delta);
+		const __m256 zero8 = _mm256_setzero_ps();
+		const __m256 one8 = _mm256_set1_ps(1.0f);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 factor = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(ages + i), startAge8), inverseLength8);
+			factor = _mm256_min_ps(_mm256_max_ps(factor, zero8), one8);
+			_mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), _mm256_mul_ps(factor, delta8)));
+		}
+#elif defined(NCINE_AFFECTORS_SSE2)
+		const __m128 startAge4 = _mm_set1_ps(startAge);
+		const __m128 inverseLength4 = _mm_set1_ps(inverseLength);
+		const __m128 delta4 = _mm_set1_ps(delta);
+		const __m128 zero4 = _mm_setzero_ps();
+		const __m128 one4 = _mm_set1_ps(1.0f);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 factor = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(ages + i), startAge4), inverseLength4);
+			factor = _mm_min_ps(_mm_max_ps(factor, zero4), one4);
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(factor, delta4)));
+		}
+#elif defined(NCINE_AFFECTORS_NEON)
+		const float32x4_t startAge4 = vdupq_n_f32(startAge);
+		const float32x4_t inverseLength4 = vdupq_n_f32(inverseLength);
+		const float32x4_t delta4 = vdupq_n_f32(delta);
+		const float32x4_t zero4 = vdupq_n_f32(0.0f);
+		const float32x4_t one4 = vdupq_n_f32(1.0f);
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t factor = vmulq_f32(vsubq_f32(vld1q_f32(ages + i), startAge4), inverseLength4);
+			factor = vminq_f32(vmaxq_f32(factor, zero4), one4);
+			vst1q_f32(output + i, vmlaq_f32(vld1q_f32(output + i), factor, delta4));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			const float factor = nctl::clamp((ages[i] - startAge) * inverseLength, 0.0f, 1.0f);
+			output[i] += factor * delta;
+		}
+	}
+
+	/// Sums two input arrays element by element, the output can be one of the inputs
+	void addRange(float *output, const float *first, const float *second, unsigned int count)
+	{
+		unsigned int i = 0;
+#if defined(NCINE_AFFECTORS_AVX2)
+		for (; i + 8 <= count; i += 8)
+			_mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(first + i), _mm256_loadu_ps(second + i)));
+#elif defined(NCINE_AFFECTORS_SSE2)
+		for (; i + 4 <= count; i += 4)
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(first + i), _mm_loadu_ps(second + i)));
+#elif defined(NCINE_AFFECTORS_NEON)
+		for (; i + 4 <= count; i += 4)
+			vst1q_f32(output + i, vaddq_f32(vld1q_f32(first + i), vld1q_f32(second + i)));
+#endif
+		for (; i < count; i++)
+			output[i] = first[i] + second[i];
+	}
+
+	/// Evaluates the piecewise linear function defined by the steps for every age, multiplying the result by a scale factor
+	/*! The step search is replaced by the sum of the clamped contribution of every segment, so that there is no branch per particle */
+	template <class StepType, class ValueFunc>
+	void evaluateSteps(const nctl::Array<StepType> &steps, ValueFunc value, const float *ages, float *output, unsigned int count, float scale)
+	{
+		fillRange(output, count, value(steps[0]) * scale);
+		for (unsigned int i = 0; i < steps.size() - 1; i++)
+		{
+			const StepType &prevStep = steps[i];
+			const StepType &nextStep = steps[i + 1];
+			const float delta = (value(nextStep) - value(prevStep)) * scale;
+			if (delta == 0.0f)
+				continue;
+
+			const float length = nextStep.age - prevStep.age;
+			if (length > 0.0f)
+				addSegmentRange(ages, output, count, prevStep.age, 1.0f / length, delta);
+			else
+			{
+				// Starting the step function just before its age, so that a particle with the same age gets the next value
+				// like with the per-particle interpolation
+				addSegmentRange(ages, output, count, nextafterf(prevStep.age, -1.0f), MaxInverseLength, delta);
+			}
+		}
+	}
+
+	/// Finds the two steps surrounding the normalized age and returns the interpolation factor between them
+	/*! \note When the age is outside the steps range both indices point to the first or to the last step */
+	template <class StepType>
+	float findSteps(const nctl::Array<StepType> &steps, float normalizedAge, unsigned int &prevIndex, unsigned int &nextIndex)
+	{
+		if (normalizedAge <= steps[0].age)
+		{
+			prevIndex = 0;
+			nextIndex = 0;
+			return 0.0f;
+		}
+		else if (normalizedAge >= steps.back().age)
+		{
+			prevIndex = steps.size() - 1;
+			nextIndex = steps.size() - 1;
+			return 0.0f;
+		}
+
+		unsigned int index = 0;
+		for (index = 0; index < steps.size() - 1; index++)
+		{
+			if (steps[index].age > normalizedAge)
+				break;
+		}
+
+		FATAL_ASSERT(index > 0);
+		prevIndex = index - 1;
+		nextIndex = index;
+
+		return (normalizedAge - steps[prevIndex].age) / (steps[nextIndex].age - steps[prevIndex].age);
+	}
+
+	Colorf interpolateColor(const nctl::Array<ColorAffector::ColorStep> &steps, float normalizedAge)
+	{
+		unsigned int prevIndex = 0;
+		unsigned int nextIndex = 0;
+		const float factor = findSteps(steps, normalizedAge, prevIndex, nextIndex);
+		const ColorAffector::ColorStep &prevStep = steps[prevIndex];
+		const ColorAffector::ColorStep &nextStep = steps[nextIndex];
+
+		const float red = prevStep.color.r() + (nextStep.color.r() - prevStep.color.r()) * factor;
+		const float green = prevStep.color.g() + (nextStep.color.g() - prevStep.color.g()) * factor;
+		const float blue = prevStep.color.b() + (nextStep.color.b() - prevStep.color.b()) * factor;
+		const float alpha = prevStep.color.a() + (nextStep.color.a() - prevStep.color.a()) * factor;
+
+		return Colorf(red, green, blue, alpha);
+	}
+
+	template <class StepType, class ValueType>
+	ValueType interpolateSteps(const nctl::Array<StepType> &steps, float normalizedAge, ValueType StepType::*member)
+	{
+		unsigned int prevIndex = 0;
+		unsigned int nextIndex = 0;
+		const float factor = findSteps(steps, normalizedAge, prevIndex, nextIndex);
+		const ValueType &prevValue = steps[prevIndex].*member;
+		const ValueType &nextValue = steps[nextIndex].*member;
+
+		return prevValue + (nextValue - prevValue) * factor;
+	}
+
+}
+
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -14,6 +211,48 @@ void ParticleAffector::affect(Particle *particle)
 	affect(particle, normalizedAge);
 }
 
+void ParticleAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
+
+	if (enabled_ == false || count == 0)
+		return;
+
+	ZoneScoped;
+	Particle particle(nullptr, nullptr);
+	for (unsigned int i = first; i < first + count; i++)
+	{
+		particle.life_ = data.life[i];
+		particle.startingLife = data.startingLife[i];
+		particle.startingRotation = data.startingRotation[i];
+		particle.velocity_.set(data.velocityX[i], data.velocityY[i]);
+		particle.setPosition(data.positionX[i], data.positionY[i]);
+		particle.setRotation(data.rotation[i]);
+		particle.setScale(data.scaleX[i], data.scaleY[i]);
+		const Color color(Colorf(data.colorR[i], data.colorG[i], data.colorB[i], data.colorA[i]));
+		particle.setColor(color);
+
+		affect(&particle, data.normalizedAge[i]);
+
+		data.velocityX[i] = particle.velocity_.x;
+		data.velocityY[i] = particle.velocity_.y;
+		data.positionX[i] = particle.position().x;
+		data.positionY[i] = particle.position().y;
+		data.rotation[i] = particle.rotation();
+		data.scaleX[i] = particle.scale().x;
+		data.scaleY[i] = particle.scale().y;
+		// The node color has eight bits per channel, the arrays are only written if the affector has changed it
+		if ((particle.color() == color) == false)
+		{
+			const Colorf newColor(particle.color());
+			data.colorR[i] = newColor.r();
+			data.colorG[i] = newColor.g();
+			data.colorB[i] = newColor.b();
+			data.colorA[i] = newColor.a();
+		}
+	}
+}
+
 ///////////////////////////////////////////////////////////
 // COLOR AFFECTOR
 ///////////////////////////////////////////////////////////
@@ -51,36 +290,28 @@ void ColorAffector::affect(Particle *particle, float normalizedAge)
 	if (enabled_ == false || colorSteps_.isEmpty())
 		return;
 
-	if (normalizedAge <= colorSteps_[0].age)
-	{
-		particle->setColor(colorSteps_[0].color);
-		return;
-	}
-	else if (normalizedAge >= colorSteps_.back().age)
-	{
-		particle->setColor(colorSteps_.back().color);
-		return;
-	}
+	particle->setColor(interpolateColor(colorSteps_, normalizedAge));
+}
 
-	unsigned int index = 0;
-	for (index = 0; index < colorSteps_.size() - 1; index++)
-	{
-		if (colorSteps_[index].age > normalizedAge)
-			break;
-	}
+void ColorAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
 
-	FATAL_ASSERT(index > 0);
-	const ColorStep &prevStep = colorSteps_[index - 1];
-	const ColorStep &nextStep = colorSteps_[index];
+	// Affector is disabled or has zero steps
+	if (enabled_ == false || colorSteps_.isEmpty())
+		return;
 
-	const float factor = (normalizedAge - prevStep.age) / (nextStep.age - prevStep.age);
-	const float red = prevStep.color.r() + (nextStep.color.r() - prevStep.color.r()) * factor;
-	const float green = prevStep.color.g() + (nextStep.color.g() - prevStep.color.g()) * factor;
-	const float blue = prevStep.color.b() + (nextStep.color.b() - prevStep.color.b()) * factor;
-	const float alpha = prevStep.color.a() + (nextStep.color.a() - prevStep.color.a()) * factor;
-	const Colorf color(red, green, blue, alpha);
+	ZoneScoped;
+	for (unsigned int offset = first; offset < first + count; offset += BlockSize)
+	{
+		const unsigned int blockCount = nctl::min(BlockSize, first + count - offset);
+		const float *ages = data.normalizedAge.get() + offset;
 
-	particle->setColor(color);
+		evaluateSteps(colorSteps_, [](const ColorStep &step) { return step.color.r(); }, ages, data.colorR.get() + offset, blockCount, 1.0f);
+		evaluateSteps(colorSteps_, [](const ColorStep &step) { return step.color.g(); }, ages, data.colorG.get() + offset, blockCount, 1.0f);
+		evaluateSteps(colorSteps_, [](const ColorStep &step) { return step.color.b(); }, ages, data.colorB.get() + offset, blockCount, 1.0f);
+		evaluateSteps(colorSteps_, [](const ColorStep &step) { return step.color.a(); }, ages, data.colorA.get() + offset, blockCount, 1.0f);
+	}
 }
 
 ///////////////////////////////////////////////////////////
@@ -120,40 +351,39 @@ void SizeAffector::affect(Particle *particle, float normalizedAge)
 	if (enabled_ == false)
 		return;
 
-	// Zero steps in the affector
+	// Applying base scale even with no steps
 	if (sizeSteps_.isEmpty())
-	{
-		// Applying base scale even with no steps
 		particle->setScale(baseScale_);
-		return;
-	}
+	else
+		particle->setScale(baseScale_ * interpolateSteps(sizeSteps_, normalizedAge, &SizeStep::scale));
+}
 
-	if (normalizedAge <= sizeSteps_[0].age)
-	{
-		particle->setScale(baseScale_ * sizeSteps_[0].scale);
+void SizeAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
+
+	// Affector is disabled
+	if (enabled_ == false)
 		return;
-	}
-	else if (normalizedAge >= sizeSteps_.back().age)
+
+	ZoneScoped;
+	// Applying base scale even with no steps
+	if (sizeSteps_.isEmpty())
 	{
-		particle->setScale(baseScale_ * sizeSteps_.back().scale);
+		fillRange(data.scaleX.get() + first, count, baseScale_.x);
+		fillRange(data.scaleY.get() + first, count, baseScale_.y);
 		return;
 	}
 
-	unsigned int index = 0;
-	for (index = 0; index < sizeSteps_.size() - 1; index++)
+	for (unsigned int offset = first; offset < first + count; offset += BlockSize)
 	{
-		if (sizeSteps_[index].age > normalizedAge)
-			break;
-	}
-
-	FATAL_ASSERT(index > 0);
-	const SizeStep &prevStep = sizeSteps_[index - 1];
-	const SizeStep &nextStep = sizeSteps_[index];
+		const unsigned int blockCount = nctl::min(BlockSize, first + count - offset);
+		const float *ages = data.normalizedAge.get() + offset;
 
-	const float factor = (normalizedAge - prevStep.age) / (nextStep.age - prevStep.age);
-	const Vector2f newScale = prevStep.scale + (nextStep.scale - prevStep.scale) * factor;
-
-	particle->setScale(baseScale_ * newScale);
+		// The base scale is applied to step values, once per segment instead of once per particle
+		evaluateSteps(sizeSteps_, [](const SizeStep &step) { return step.scale.x; }, ages, data.scaleX.get() + offset, blockCount, baseScale_.x);
+		evaluateSteps(sizeSteps_, [](const SizeStep &step) { return step.scale.y; }, ages, data.scaleY.get() + offset, blockCount, baseScale_.y);
+	}
 }
 
 ///////////////////////////////////////////////////////////
@@ -193,32 +423,27 @@ void RotationAffector::affect(Particle *particle, float normalizedAge)
 	if (enabled_ == false || rotationSteps_.isEmpty())
 		return;
 
-	if (normalizedAge <= rotationSteps_[0].age)
-	{
-		particle->setRotation(particle->startingRotation + rotationSteps_[0].angle);
-		return;
-	}
-	else if (normalizedAge >= rotationSteps_.back().age)
-	{
-		particle->setRotation(particle->startingRotation + rotationSteps_.back().angle);
-		return;
-	}
+	particle->setRotation(particle->startingRotation + interpolateSteps(rotationSteps_, normalizedAge, &RotationStep::angle));
+}
 
-	unsigned int index = 0;
-	for (index = 0; index < rotationSteps_.size() - 1; index++)
-	{
-		if (rotationSteps_[index].age > normalizedAge)
-			break;
-	}
+void RotationAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
 
-	FATAL_ASSERT(index > 0);
-	const RotationStep &prevStep = rotationSteps_[index - 1];
-	const RotationStep &nextStep = rotationSteps_[index];
+	// Affector is disabled or has zero steps
+	if (enabled_ == false || rotationSteps_.isEmpty())
+		return;
 
-	const float factor = (normalizedAge - prevStep.age) / (nextStep.age - prevStep.age);
-	const float newAngle = prevStep.angle + (nextStep.angle - prevStep.angle) * factor;
+	ZoneScoped;
+	for (unsigned int offset = first; offset < first + count; offset += BlockSize)
+	{
+		const unsigned int blockCount = nctl::min(BlockSize, first + count - offset);
+		const float *ages = data.normalizedAge.get() + offset;
+		float *rotation = data.rotation.get() + offset;
 
-	particle->setRotation(particle->startingRotation + newAngle);
+		evaluateSteps(rotationSteps_, [](const RotationStep &step) { return step.angle; }, ages, rotation, blockCount, 1.0f);
+		addRange(rotation, rotation, data.startingRotation.get() + offset, blockCount);
+	}
 }
 
 ///////////////////////////////////////////////////////////
@@ -258,32 +483,31 @@ void PositionAffector::affect(Particle *particle, float normalizedAge)
 	if (enabled_ == false || positionSteps_.isEmpty())
 		return;
 
-	if (normalizedAge <= positionSteps_[0].age)
-	{
-		particle->move(positionSteps_[0].position);
-		return;
-	}
-	else if (normalizedAge >= positionSteps_.back().age)
-	{
-		particle->move(positionSteps_.back().position);
+	particle->move(interpolateSteps(positionSteps_, normalizedAge, &PositionStep::position));
+}
+
+void PositionAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
+
+	// Affector is disabled or has zero steps
+	if (enabled_ == false || positionSteps_.isEmpty())
 		return;
-	}
 
-	unsigned int index = 0;
-	for (index = 0; index < positionSteps_.size() - 1; index++)
+	ZoneScoped;
+	float values[BlockSize];
+	for (unsigned int offset = first; offset < first + count; offset += BlockSize)
 	{
-		if (positionSteps_[index].age > normalizedAge)
-			break;
+		const unsigned int blockCount = nctl::min(BlockSize, first + count - offset);
+		const float *ages = data.normalizedAge.get() + offset;
+		float *positionX = data.positionX.get() + offset;
+		float *positionY = data.positionY.get() + offset;
+
+		evaluateSteps(positionSteps_, [](const PositionStep &step) { return step.position.x; }, ages, values, blockCount, 1.0f);
+		addRange(positionX, positionX, values, blockCount);
+		evaluateSteps(positionSteps_, [](const PositionStep &step) { return step.position.y; }, ages, values, blockCount, 1.0f);
+		addRange(positionY, positionY, values, blockCount);
 	}
-
-	FATAL_ASSERT(index > 0);
-	const PositionStep &prevStep = positionSteps_[index - 1];
-	const PositionStep &nextStep = positionSteps_[index];
-
-	const float factor = (normalizedAge - prevStep.age) / (nextStep.age - prevStep.age);
-	const Vector2f newPosition = prevStep.position + (nextStep.position - prevStep.position) * factor;
-
-	particle->move(newPosition);
 }
 
 ///////////////////////////////////////////////////////////
@@ -323,32 +547,31 @@ void VelocityAffector::affect(Particle *particle, float normalizedAge)
 	if (enabled_ == false || velocitySteps_.isEmpty())
 		return;
 
-	if (normalizedAge <= velocitySteps_[0].age)
-	{
-		particle->velocity_ += velocitySteps_[0].velocity;
-		return;
-	}
-	else if (normalizedAge >= velocitySteps_.back().age)
-	{
-		particle->velocity_ += velocitySteps_.back().velocity;
+	particle->velocity_ += interpolateSteps(velocitySteps_, normalizedAge, &VelocityStep::velocity);
+}
+
+void VelocityAffector::affectRange(ParticleData &data, unsigned int first, unsigned int count)
+{
+	ASSERT(first + count <= data.numAlive());
+
+	// Affector is disabled or has zero steps
+	if (enabled_ == false || velocitySteps_.isEmpty())
 		return;
-	}
 
-	unsigned int index = 0;
-	for (index = 0; index < velocitySteps_.size() - 1; index++)
+	ZoneScoped;
+	float values[BlockSize];
+	for (unsigned int offset = first; offset < first + count; offset += BlockSize)
 	{
-		if (velocitySteps_[index].age > normalizedAge)
-			break;
+		const unsigned int blockCount = nctl::min(BlockSize, first + count - offset);
+		const float *ages = data.normalizedAge.get() + offset;
+		float *velocityX = data.velocityX.get() + offset;
+		float *velocityY = data.velocityY.get() + offset;
+
+		evaluateSteps(velocitySteps_, [](const VelocityStep &step) { return step.velocity.x; }, ages, values, blockCount, 1.0f);
+		addRange(velocityX, velocityX, values, blockCount);
+		evaluateSteps(velocitySteps_, [](const VelocityStep &step) { return step.velocity.y; }, ages, values, blockCount, 1.0f);
+		addRange(velocityY, velocityY, values, blockCount);
 	}
-
-	FATAL_ASSERT(index > 0);
-	const VelocityStep &prevStep = velocitySteps_[index - 1];
-	const VelocityStep &nextStep = velocitySteps_[index];
-
-	const float factor = (normalizedAge - prevStep.age) / (nextStep.age - prevStep.age);
-	const Vector2f newVelocity = prevStep.velocity + (nextStep.velocity - prevStep.velocity) * factor;
-
-	particle->velocity_ += newVelocity;
 }
 
 }
@@ -0,0 +1,113 @@
+#include "ParticleData.h"
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ParticleData::ParticleData(unsigned int capacity)
+    : life(nctl::makeUnique<float[]>(capacity)), startingLife(nctl::makeUnique<float[]>(capacity)),
+      positionX(nctl::makeUnique<float[]>(capacity)), positionY(nctl::makeUnique<float[]>(capacity)),
+      velocityX(nctl::makeUnique<float[]>(capacity)), velocityY(nctl::makeUnique<float[]>(capacity)),
+      rotation(nctl::makeUnique<float[]>(capacity)), startingRotation(nctl::makeUnique<float[]>(capacity)),
+      scaleX(nctl::makeUnique<float[]>(capacity)), scaleY(nctl::makeUnique<float[]>(capacity)),
+      colorR(nctl::makeUnique<float[]>(capacity)), colorG(nctl::makeUnique<float[]>(capacity)),
+      colorB(nctl::makeUnique<float[]>(capacity)), colorA(nctl::makeUnique<float[]>(capacity)),
+      normalizedAge(nctl::makeUnique<float[]>(capacity)),
+      capacity_(capacity), numAlive_(0)
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int ParticleData::emit(float initialLife, const Vector2f &pos, const Vector2f &vel, float rot)
+{
+	if (numAlive_ >= capacity_)
+		return capacity_;
+
+	const unsigned int index = numAlive_;
+	life[index] = initialLife;
+	startingLife[index] = initialLife;
+	positionX[index] = pos.x;
+	positionY[index] = pos.y;
+	velocityX[index] = vel.x;
+	velocityY[index] = vel.y;
+	rotation[index] = rot;
+	startingRotation[index] = rot;
+	scaleX[index] = 1.0f;
+	scaleY[index] = 1.0f;
+	colorR[index] = 1.0f;
+	colorG[index] = 1.0f;
+	colorB[index] = 1.0f;
+	colorA[index] = 1.0f;
+
+	numAlive_++;
+	return index;
+}
+
+void ParticleData::kill(unsigned int index)
+{
+	ASSERT(index < numAlive_);
+
+	const unsigned int last = numAlive_ - 1;
+	if (index != last)
+	{
+		life[index] = life[last];
+		startingLife[index] = startingLife[last];
+		positionX[index] = positionX[last];
+		positionY[index] = positionY[last];
+		velocityX[index] = velocityX[last];
+		velocityY[index] = velocityY[last];
+		rotation[index] = rotation[last];
+		startingRotation[index] = startingRotation[last];
+		scaleX[index] = scaleX[last];
+		scaleY[index] = scaleY[last];
+		colorR[index] = colorR[last];
+		colorG[index] = colorG[last];
+		colorB[index] = colorB[last];
+		colorA[index] = colorA[last];
+	}
+	numAlive_--;
+}
+
+void ParticleData::calculateNormalizedAges()
+{
+	const float *lifeArray = life.get();
+	const float *startingLifeArray = startingLife.get();
+	float *normalizedAgeArray = normalizedAge.get();
+
+	for (unsigned int i = 0; i < numAlive_; i++)
+		normalizedAgeArray[i] = 1.0f - lifeArray[i] / startingLifeArray[i];
+}
+
+void ParticleData::update(float interval)
+{
+	ZoneScoped;
+
+	float *lifeArray = life.get();
+	float *posX = positionX.get();
+	float *posY = positionY.get();
+	const float *velX = velocityX.get();
+	const float *velY = velocityY.get();
+
+	// Integration pass over contiguous arrays, no branches other than the loop one
+	for (unsigned int i = 0; i < numAlive_; i++)
+	{
+		lifeArray[i] -= interval;
+		posX[i] += velX[i] * interval;
+		posY[i] += velY[i] * interval;
+	}
+
+	// Iterating backwards so that the particle moved in place of a dead one has already been checked
+	for (int i = static_cast<int>(numAlive_) - 1; i >= 0; i--)
+	{
+		if (lifeArray[i] <= 0.0f)
+			kill(static_cast<unsigned int>(i));
+	}
+}
+
+}
@@ -2,8 +2,12 @@
 #include "Random.h"
 #include "Vector2.h"
 #include "Particle.h"
+#include "ParticleData.h"
 #include "ParticleInitializer.h"
 #include "Texture.h"
+#include "RenderQueue.h"
+#include "RenderCommand.h"
+#include "RenderResources.h"
 #include "Application.h"
 
 #ifdef WITH_TRACY
@@ -18,6 +22,28 @@ namespace {
 #ifdef WITH_TRACY
 	nctl::StaticString<128> tracyInfoString;
 #endif
+
+	/// Every particle quad is drawn as two separate triangles
+	const unsigned int VerticesPerParticle = 6;
+	const unsigned int VertexFloats = sizeof(RenderResources::VertexFormatPos2Tex2Color) / sizeof(GLfloat);
+
+	inline void setVertex(RenderResources::VertexFormatPos2Tex2Color &vertex, float x, float y, float u, float v, const GLubyte color[4])
+	{
+		vertex.position[0] = x;
+		vertex.position[1] = y;
+		vertex.texcoords[0] = u;
+		vertex.texcoords[1] = v;
+		vertex.color[0] = color[0];
+		vertex.color[1] = color[1];
+		vertex.color[2] = color[2];
+		vertex.color[3] = color[3];
+	}
+
+	Material::ShaderProgramType particlesShaderProgramType(const Texture *texture)
+	{
+		return (texture == nullptr || texture->numChannels() >= 3) ? Material::ShaderProgramType::PARTICLES
+		                                                             : Material::ShaderProgramType::PARTICLES_GRAY;
+	}
 }
 
 ///////////////////////////////////////////////////////////
@@ -30,9 +56,19 @@ ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *t
 }
 
 ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Recti texRect)
-    : SceneNode(parent, 0, 0), poolSize_(count), poolTop_(count - 1),
-      particlePool_(poolSize_, nctl::ArrayMode::FIXED_CAPACITY),
-      particleArray_(poolSize_, nctl::ArrayMode::FIXED_CAPACITY),
+    : ParticleSystem(parent, count, texture, texRect, Mode::NODES)
+{
+}
+
+ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Mode mode)
+    : ParticleSystem(parent, count, texture, Recti(0, 0, texture->width(), texture->height()), mode)
+{
+}
+
+ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *texture, Recti texRect, Mode mode)
+    : SceneNode(parent, 0, 0), mode_(mode), poolSize_(count), poolTop_(count - 1),
+      particlePool_((mode == Mode::NODES) ? poolSize_ : 0, nctl::ArrayMode::FIXED_CAPACITY),
+      particleArray_((mode == Mode::NODES) ? poolSize_ : 1, nctl::ArrayMode::FIXED_CAPACITY),
       affectors_(4), inLocalSpace_(false),
       particlesUpdateEnabled_(true), affectorsEnabled_(true)
 {
@@ -45,6 +81,16 @@ ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *t
 
 	type_ = ObjectType::PARTICLE_SYSTEM;
 
+	if (mode_ == Mode::ARRAYS)
+	{
+		// The template particle is never added as a child, it only stores the shared sprite properties
+		nctl::UniquePtr<Particle> templateParticle = nctl::makeUnique<Particle>(nullptr, texture);
+		templateParticle->setTexRect(texRect);
+		particleArray_.pushBack(nctl::move(templateParticle));
+		initArrays();
+		return;
+	}
+
 	children_.setCapacity(poolSize_);
 	for (unsigned int i = 0; i < poolSize_; i++)
 	{
@@ -55,6 +101,8 @@ ParticleSystem::ParticleSystem(SceneNode *parent, unsigned int count, Texture *t
 	}
 }
 
+ParticleSystem::~ParticleSystem() = default;
+
 ParticleSystem::ParticleSystem(ParticleSystem &&) = default;
 
 ParticleSystem &ParticleSystem::operator=(ParticleSystem &&) = default;
@@ -108,15 +156,28 @@ void ParticleSystem::emitParticles(const ParticleInitializer &init)
 		if (inLocalSpace_ == false)
 			position += absPosition();
 
-		// Acquiring a particle from the pool
-		particlePool_[poolTop_]->init(life, position, velocity, rotation, inLocalSpace_);
-		addChildNode(particlePool_[poolTop_]);
+		if (mode_ == Mode::ARRAYS)
+			particleData_->emit(life, position, velocity, rotation);
+		else
+		{
+			// Acquiring a particle from the pool
+			particlePool_[poolTop_]->init(life, position, velocity, rotation, inLocalSpace_);
+			addChildNode(particlePool_[poolTop_]);
+		}
 		poolTop_--;
 	}
 }
 
 void ParticleSystem::killParticles()
 {
+	if (mode_ == Mode::ARRAYS)
+	{
+		particleData_->killAll();
+		poolTop_ = poolSize_ - 1;
+		renderCommand_->geometry().setNumVertices(0);
+		return;
+	}
+
 	for (int i = children_.size() - 1; i >= 0; i--)
 	{
 		Particle *particle = static_cast<Particle *>(children_[i]);
@@ -196,39 +257,10 @@ void ParticleSystem::update(float interval)
 	// Overridden `update()` method should call `transform()` like `SceneNode::update()` does
 	SceneNode::transform();
 
-	for (int i = children_.size() - 1; i >= 0; i--)
-	{
-		Particle *particle = static_cast<Particle *>(children_[i]);
-
-		// Update the particle if it's alive
-		if (particle->isAlive())
-		{
-			if (affectorsEnabled_)
-			{
-				// Calculating the normalized age only once per particle
-				const float normalizedAge = 1.0f - particle->life_ / particle->startingLife;
-				for (nctl::UniquePtr<ParticleAffector> &affector : affectors_)
-					affector->affect(particle, normalizedAge);
-			}
-
-			if (particlesUpdateEnabled_)
-			{
-				particle->update(interval);
-
-				// Releasing the particle if it has just died
-				if (particle->isAlive() == false)
-				{
-					poolTop_++;
-					particlePool_[poolTop_] = particle;
-					removeChildNodeAt(i);
-					continue;
-				}
-			}
-
-			// Transforming the particle only if it's still alive
-			particle->transform();
-		}
-	}
+	if (mode_ == Mode::ARRAYS)
+		updateArrays(interval);
+	else
+		updateNodes(interval);
 
 	// A ParticleSystem does not have the `updateRenderCommand()` method to reset the flags
 	dirtyBits_.reset(DirtyBitPositions::TransformationBit);
@@ -242,14 +274,49 @@ void ParticleSystem::update(float interval)
 #endif
 }
 
+bool ParticleSystem::draw(RenderQueue &renderQueue)
+{
+	if (mode_ == Mode::NODES || renderCommand_->geometry().numVertices() == 0)
+		return false;
+
+	// All shared properties are read from the template particle
+	const Particle &templateParticle = *particleArray_.front();
+	const Texture *texture = templateParticle.texture();
+	Material &material = renderCommand_->material();
+
+	if (material.setShaderProgramType(particlesShaderProgramType(texture)))
+	{
+		material.reserveUniformsDataMemory();
+		GLUniformCache *textureUniform = material.uniform(Material::TextureUniformName);
+		if (textureUniform && textureUniform->intValue(0) != 0)
+			textureUniform->setIntValue(0); // GL_TEXTURE0
+	}
+	if (texture)
+		material.setTexture(*texture);
+	else
+		material.setTexture(nullptr);
+
+	const Material &templateMaterial = templateParticle.renderCommand_->material();
+	material.setBlendingEnabled(templateMaterial.isBlendingEnabled());
+	material.setBlendingFactors(templateMaterial.srcBlendingFactor(), templateMaterial.destBlendingFactor());
+
+	// Particles in world space have their vertices already transformed
+	renderCommand_->setTransformation(inLocalSpace_ ? worldMatrix_ : Matrix4x4f::Identity);
+	renderCommand_->setLayer(templateParticle.layer() != 0 ? templateParticle.layer() : absLayer_);
+	renderCommand_->setVisitOrder(withVisitOrder_ ? visitOrderIndex_ : 0);
+	renderQueue.addCommand(renderCommand_.get());
+
+	return true;
+}
+
 ///////////////////////////////////////////////////////////
 // PROTECTED FUNCTIONS
 ///////////////////////////////////////////////////////////
 
 ParticleSystem::ParticleSystem(const ParticleSystem &other)
-    : SceneNode(other), poolSize_(other.poolSize_), poolTop_(other.poolSize_ - 1),
-      particlePool_(other.poolSize_, nctl::ArrayMode::FIXED_CAPACITY),
-      particleArray_(other.poolSize_, nctl::ArrayMode::FIXED_CAPACITY),
+    : SceneNode(other), mode_(other.mode_), poolSize_(other.poolSize_), poolTop_(other.poolSize_ - 1),
+      particlePool_((other.mode_ == Mode::NODES) ? other.poolSize_ : 0, nctl::ArrayMode::FIXED_CAPACITY),
+      particleArray_((other.mode_ == Mode::NODES) ? other.poolSize_ : 1, nctl::ArrayMode::FIXED_CAPACITY),
       affectors_(4), inLocalSpace_(other.inLocalSpace_),
       particlesUpdateEnabled_(other.particlesUpdateEnabled_),
       affectorsEnabled_(other.affectorsEnabled_)
@@ -280,10 +347,17 @@ ParticleSystem::ParticleSystem(const ParticleSystem &other)
 		}
 	}
 
+	if (mode_ == Mode::ARRAYS)
+	{
+		particleArray_.pushBack(nctl::makeUnique<Particle>(other.particleArray_.front()->clone()));
+		initArrays();
+		return;
+	}
+
 	children_.setCapacity(poolSize_);
 	if (poolSize_ > 0)
 	{
-		const Particle &otherParticle = *other.particlePool_.front();
+		const Particle &otherParticle = *other.particleArray_.front();
 		if (otherParticle.texture() && otherParticle.texture()->name() != nullptr)
 		{
 			// When Tracy is disabled the statement body is empty and braces are needed
@@ -299,4 +373,173 @@ ParticleSystem::ParticleSystem(const ParticleSystem &other)
 	}
 }
 
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ParticleSystem::updateNodes(float interval)
+{
+	for (int i = children_.size() - 1; i >= 0; i--)
+	{
+		Particle *particle = static_cast<Particle *>(children_[i]);
+
+		// Update the particle if it's alive
+		if (particle->isAlive())
+		{
+			if (affectorsEnabled_)
+			{
+				// Calculating the normalized age only once per particle
+				const float normalizedAge = 1.0f - particle->life_ / particle->startingLife;
+				for (nctl::UniquePtr<ParticleAffector> &affector : affectors_)
+					affector->affect(particle, normalizedAge);
+			}
+
+			if (particlesUpdateEnabled_)
+			{
+				particle->update(interval);
+
+				// Releasing the particle if it has just died
+				if (particle->isAlive() == false)
+				{
+					poolTop_++;
+					particlePool_[poolTop_] = particle;
+					removeChildNodeAt(i);
+					continue;
+				}
+			}
+
+			// Transforming the particle only if it's still alive
+			particle->transform();
+		}
+	}
+}
+
+void ParticleSystem::initArrays()
+{
+	particleData_ = nctl::makeUnique<ParticleData>(poolSize_);
+
+	renderCommand_ = nctl::makeUnique<RenderCommand>(RenderCommand::CommandTypes::PARTICLE);
+	renderCommand_->setIdSortKey(id());
+
+	Material &material = renderCommand_->material();
+	material.setShaderProgramType(particlesShaderProgramType(particleArray_.front()->texture()));
+	material.reserveUniformsDataMemory();
+	GLUniformCache *textureUniform = material.uniform(Material::TextureUniformName);
+	if (textureUniform && textureUniform->intValue(0) != 0)
+		textureUniform->setIntValue(0); // GL_TEXTURE0
+
+	// The host array is as big as the custom VBO, as it is copied entirely when buffer mapping is not available
+	const unsigned int numFloats = poolSize_ * VerticesPerParticle * VertexFloats;
+	vertices_.setCapacity(numFloats);
+	vertices_.setSize(numFloats);
+
+	Geometry &geometry = renderCommand_->geometry();
+	geometry.setNumElementsPerVertex(VertexFloats);
+	geometry.setDrawParameters(GL_TRIANGLES, 0, 0);
+	geometry.createCustomVbo(numFloats, GL_DYNAMIC_DRAW);
+}
+
+void ParticleSystem::updateArrays(float interval)
+{
+	ParticleData &data = *particleData_;
+
+	if (affectorsEnabled_ && data.numAlive() > 0)
+	{
+		// Calculating the normalized age only once per particle
+		data.calculateNormalizedAges();
+		for (nctl::UniquePtr<ParticleAffector> &affector : affectors_)
+			affector->affectRange(data, 0, data.numAlive());
+	}
+
+	if (particlesUpdateEnabled_)
+		data.update(interval);
+	poolTop_ = poolSize_ - data.numAlive() - 1;
+
+	fillVertices();
+}
+
+void ParticleSystem::fillVertices()
+{
+	ZoneScoped;
+
+	const ParticleData &data = *particleData_;
+	const Particle &templateParticle = *particleArray_.front();
+
+	float texScaleX = 1.0f;
+	float texBiasX = 0.0f;
+	float texScaleY = 1.0f;
+	float texBiasY = 0.0f;
+	const Texture *texture = templateParticle.texture();
+	if (texture)
+	{
+		const Recti texRect = templateParticle.texRect();
+		const Vector2i texSize = texture->size();
+		texScaleX = texRect.w / float(texSize.x);
+		texBiasX = texRect.x / float(texSize.x);
+		texScaleY = texRect.h / float(texSize.y);
+		texBiasY = texRect.y / float(texSize.y);
+	}
+	// Texture coordinates are calculated like in the sprite vertex shader
+	const float leftU = texBiasX;
+	const float rightU = texScaleX + texBiasX;
+	const float topV = texBiasY;
+	const float bottomV = texScaleY + texBiasY;
+
+	// Quad corners relative to the particle position, before scaling and rotation
+	const float halfWidth = templateParticle.width_ * 0.5f;
+	const float halfHeight = templateParticle.height_ * 0.5f;
+	const Vector2f &anchorPoint = templateParticle.anchorPoint_;
+	const float left = -halfWidth - anchorPoint.x;
+	const float right = halfWidth - anchorPoint.x;
+	const float bottom = -halfHeight - anchorPoint.y;
+	const float top = halfHeight - anchorPoint.y;
+
+	const Colorf systemColor(absColor_);
+	RenderResources::VertexFormatPos2Tex2Color *vertices = reinterpret_cast<RenderResources::VertexFormatPos2Tex2Color *>(vertices_.data());
+
+	const unsigned int numAlive = data.numAlive();
+	for (unsigned int i = 0; i < numAlive; i++)
+	{
+		const float radians = data.rotation[i] * fDegToRad;
+		const float sinRot = sinf(radians);
+		const float cosRot = cosf(radians);
+
+		const float scaledLeft = left * data.scaleX[i];
+		const float scaledRight = right * data.scaleX[i];
+		const float scaledBottom = bottom * data.scaleY[i];
+		const float scaledTop = top * data.scaleY[i];
+
+		const float posX = data.positionX[i];
+		const float posY = data.positionY[i];
+		// Rotating the four corners around the particle position
+		const float rightBottomX = posX + scaledRight * cosRot - scaledBottom * sinRot;
+		const float rightBottomY = posY + scaledRight * sinRot + scaledBottom * cosRot;
+		const float rightTopX = posX + scaledRight * cosRot - scaledTop * sinRot;
+		const float rightTopY = posY + scaledRight * sinRot + scaledTop * cosRot;
+		const float leftBottomX = posX + scaledLeft * cosRot - scaledBottom * sinRot;
+		const float leftBottomY = posY + scaledLeft * sinRot + scaledBottom * cosRot;
+		const float leftTopX = posX + scaledLeft * cosRot - scaledTop * sinRot;
+		const float leftTopY = posY + scaledLeft * sinRot + scaledTop * cosRot;
+
+		const GLubyte color[4] = {
+			static_cast<GLubyte>(data.colorR[i] * systemColor.r() * 255.0f),
+			static_cast<GLubyte>(data.colorG[i] * systemColor.g() * 255.0f),
+			static_cast<GLubyte>(data.colorB[i] * systemColor.b() * 255.0f),
+			static_cast<GLubyte>(data.colorA[i] * systemColor.a() * 255.0f)
+		};
+
+		RenderResources::VertexFormatPos2Tex2Color *quad = &vertices[i * VerticesPerParticle];
+		setVertex(quad[0], rightBottomX, rightBottomY, rightU, bottomV, color);
+		setVertex(quad[1], rightTopX, rightTopY, rightU, topV, color);
+		setVertex(quad[2], leftBottomX, leftBottomY, leftU, bottomV, color);
+		setVertex(quad[3], leftBottomX, leftBottomY, leftU, bottomV, color);
+		setVertex(quad[4], rightTopX, rightTopY, rightU, topV, color);
+		setVertex(quad[5], leftTopX, leftTopY, leftU, topV, color);
+	}
+
+	Geometry &geometry = renderCommand_->geometry();
+	geometry.setNumVertices(numAlive * VerticesPerParticle);
+	geometry.setHostVertexPointer(vertices_.data());
+}
+
 }
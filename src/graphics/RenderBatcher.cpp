@@ -4,11 +4,35 @@
 #include "RenderCommand.h"
 #include "RenderCommandPool.h"
 #include "RenderResources.h"
+#include "RenderBuffersManager.h"
 #include "Application.h"
+#include "IThreadPool.h"
+#include "tracy.h"
 #include <nctl/StaticHashMapIterator.h>
 
+#ifdef WITH_ALLOCATORS
+	#include <nctl/AllocManager.h>
+	#include <nctl/FrameAllocator.h>
+#endif
+
 namespace ncine {
 
+namespace {
+
+	/// Packs a color as an unsigned integer, the bits of a color are not always a valid float
+	uint32_t packColor(const float *color)
+	{
+		uint32_t packedColor = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			const float channel = (color[i] < 0.0f) ? 0.0f : ((color[i] > 1.0f) ? 1.0f : color[i]);
+			packedColor |= static_cast<uint32_t>(channel * 255.0f + 0.5f) << (i * 8);
+		}
+		return packedColor;
+	}
+
+}
+
 ///////////////////////////////////////////////////////////
 // STATIC DEFINITIONS
 ///////////////////////////////////////////////////////////
@@ -49,6 +73,8 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 	ASSERT(minBatchSize > 1);
 	ASSERT(maxBatchSize >= minBatchSize);
 
+	fills_.clear();
+
 	unsigned int lastSplit = 0;
 
 	for (unsigned int i = 1; i < srcQueue.size(); i++)
@@ -71,13 +97,14 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 			const GLShaderProgram *batchedShader = RenderResources::batchedShader(prevCommand->material().shaderProgram());
 			if (batchedShader && (endSplit - lastSplit) >= minBatchSize)
 			{
+				const unsigned int spanMaxBatchSize = maxCommandsInBatch(srcQueue[lastSplit], maxBatchSize);
 				// Split point for the maximum batch size
 				while (lastSplit < endSplit)
 				{
 					const unsigned int batchSize = endSplit - lastSplit;
 					unsigned int nextSplit = endSplit;
-					if (batchSize > maxBatchSize)
-						nextSplit = lastSplit + maxBatchSize;
+					if (batchSize > spanMaxBatchSize)
+						nextSplit = lastSplit + spanMaxBatchSize;
 					else if (batchSize < minBatchSize)
 						break;
 
@@ -105,6 +132,26 @@ void RenderBatcher::createBatches(const nctl::Array<RenderCommand *> &srcQueue,
 	// If the queue has only one command the for loop didn't execute, the command has to passthrough
 	if (srcQueue.size() == 1)
 		destQueue.pushBack(srcQueue[0]);
+
+	// Every batch writes to its own memory regions, they can be filled in any order
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	if (theApplication().renderingSettings().parallelBatchingEnabled && threadPool.numThreads() > 0 && fills_.size() > 1)
+		threadPool.parallelFor(fills_.size(), 1, fillBatches, this);
+	else
+	{
+		for (const BatchFill &fill : fills_)
+			fillBatch(fill);
+	}
+
+	for (const BatchFill &fill : fills_)
+	{
+		if (fill.hasAttributes)
+		{
+			fill.batchCommand->geometry().releaseVertexPointer();
+			if (fill.destIdx)
+				fill.batchCommand->geometry().releaseIndexPointer();
+		}
+	}
 }
 
 void RenderBatcher::reset()
@@ -118,6 +165,25 @@ void RenderBatcher::reset()
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+unsigned int RenderBatcher::maxCommandsInBatch(RenderCommand *refCommand, unsigned int maxBatchSize)
+{
+	const GLShaderProgram *batchedShader = RenderResources::batchedShader(refCommand->material().shaderProgram());
+	if (RenderResources::isTextureBufferShader(batchedShader) == false)
+		return maxBatchSize;
+
+	// Same instance size as the one used when collecting commands, with the std140 vec4 layout alignment
+	GLUniformBlockCache *singleInstanceBlock = refCommand->material().uniformBlock(Material::InstanceBlockName);
+	const unsigned int singleInstanceBlockSizePacked = singleInstanceBlock->size() - singleInstanceBlock->alignAmount();
+	const unsigned int singleInstanceBlockSize = singleInstanceBlockSizePacked + (16 - singleInstanceBlockSizePacked % 16) % 16;
+	if (singleInstanceBlockSize == 0)
+		return maxBatchSize;
+
+	// Splits due to the size of vertex, index and texture buffers still happen while collecting
+	const unsigned long tboMaxSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::TEXTURE).maxSize;
+	const unsigned long tboMaxCommands = tboMaxSize / singleInstanceBlockSize;
+	return (tboMaxCommands > maxBatchSize) ? static_cast<unsigned int>(tboMaxCommands) : maxBatchSize;
+}
+
 RenderCommand *RenderBatcher::collectCommands(
     nctl::Array<RenderCommand *>::ConstIterator start,
     nctl::Array<RenderCommand *>::ConstIterator end,
@@ -138,18 +204,59 @@ RenderCommand *RenderBatcher::collectCommands(
 	GLShaderProgram *batchedShader = RenderResources::batchedShader(refShader);
 	// The following check should never fail as it is already checked by the calling function
 	FATAL_ASSERT_MSG(batchedShader != nullptr, "Unsupported shader for batch element");
+	// Sprites with a two-dimensional transformation use a variant of the batched shader with smaller instances
+	GLShaderProgram *compactShader = RenderResources::compactBatchedShader(batchedShader);
+	bool compact = (compactShader != nullptr && refCommand->isTransformation2D());
+	const bool isText = (refCommand->type() == RenderCommand::CommandTypes::TEXT);
+#if defined(__EMSCRIPTEN__) || defined(WITH_ANGLE)
+	// Batched shaders compiled with a fixed batch size declare an instances array of that many elements
+	const unsigned int maxNumInstances = theApplication().appConfiguration().fixedBatchSize;
+#else
+	const unsigned int maxNumInstances = 0;
+#endif
+	if (compact && isText)
+	{
+		// Text nodes use one compact instance for each glyph, the first one has to fit in a uniform block on its own
+		const unsigned int firstNumGlyphs = numGlyphs(refCommand->geometry());
+		const unsigned long firstTextSize = compactShader->uniformsSize() + firstNumGlyphs * CompactTexturedInstanceSize;
+		compact = (theApplication().renderingSettings().glyphInstancingEnabled && firstTextSize <= UboMaxSize &&
+		           (maxNumInstances == 0 || firstNumGlyphs <= maxNumInstances));
+	}
+	const bool glyphInstances = (compact && isText);
+	if (compact)
+		batchedShader = compactShader;
 	bool commandAdded = false;
 	batchCommand = RenderResources::renderCommandPool().retrieveOrAdd(batchedShader, commandAdded);
 
 	// Retrieving the original block instance size without the uniform buffer offset alignment
-	const GLUniformBlockCache *singleInstanceBlock = (*start)->material().uniformBlock(Material::InstanceBlockName);
+	GLUniformBlockCache *singleInstanceBlock = (*start)->material().uniformBlock(Material::InstanceBlockName);
 	const int singleInstanceBlockSizePacked = singleInstanceBlock->size() - singleInstanceBlock->alignAmount(); // remove the uniform buffer offset alignment
-	const int singleInstanceBlockSize = singleInstanceBlockSizePacked + (16 - singleInstanceBlockSizePacked % 16) % 16; // but add the std140 vec4 layout alignment
+	int singleInstanceBlockSize = singleInstanceBlockSizePacked + (16 - singleInstanceBlockSizePacked % 16) % 16; // but add the std140 vec4 layout alignment
+
+	// The offsets of the encoded uniforms are the same for all the commands of a batch
+	CompactOffsets compactOffsets = {};
+	if (compact)
+	{
+		const GLUniformCache *spriteSizeUniform = singleInstanceBlock->uniform(Material::SpriteSizeUniformName);
+		const GLUniformCache *texRectUniform = singleInstanceBlock->uniform(Material::TexRectUniformName);
+		compactOffsets.modelMatrix = singleInstanceBlock->uniform(Material::ModelMatrixUniformName)->uniform()->offset();
+		compactOffsets.color = singleInstanceBlock->uniform(Material::ColorUniformName)->uniform()->offset();
+		compactOffsets.spriteSize = spriteSizeUniform ? spriteSizeUniform->uniform()->offset() : -1;
+		compactOffsets.texRect = texRectUniform ? texRectUniform->uniform()->offset() : -1;
+		// The size and the texture rectangle of a glyph come from its quad vertices
+		singleInstanceBlockSize = (texRectUniform || glyphInstances) ? CompactTexturedInstanceSize : CompactInstanceSize;
+	}
 
 	if (commandAdded)
 		batchCommand->setType(refCommand->type());
-	instancesBlock = batchCommand->material().uniformBlock(Material::InstancesBlockName);
-	FATAL_ASSERT_MSG_X(instancesBlock != nullptr, "Batched shader does not have an %s uniform block", Material::InstancesBlockName);
+
+	// Batched shaders either read instance data from a texture buffer or from a uniform block
+	const bool withTextureBuffer = batchCommand->material().hasUniform(Material::InstancesTextureUniformName);
+	if (withTextureBuffer == false)
+	{
+		instancesBlock = batchCommand->material().uniformBlock(Material::InstancesBlockName);
+		FATAL_ASSERT_MSG_X(instancesBlock != nullptr, "Batched shader does not have an %s uniform block", Material::InstancesBlockName);
+	}
 
 	const unsigned long nonBlockUniformsSize = batchCommand->material().shaderProgram()->uniformsSize();
 	nctl::StaticString<GLUniformBlock::MaxNameLength> uniformBlockName;
@@ -170,25 +277,41 @@ RenderCommand *RenderBatcher::collectCommands(
 
 	// Set to true if at least one command in the batch has indices or forced by a rendering settings
 	bool batchingWithIndices = theApplication().renderingSettings().batchingWithIndices;
+	// Glyph instances are counted to stay within the fixed batch size, if any
+	unsigned int numGlyphInstances = 0;
 	// Sum the amount of UBO memory required by the batch and determine if indices are needed
 	nctl::Array<RenderCommand *>::ConstIterator it = start;
 	while (it != end)
 	{
+		// A compact batch ends before the first command with a transformation that cannot be encoded
+		if (compact && (*it)->isTransformation2D() == false)
+			break;
+
 		if ((*it)->geometry().numIndices() > 0)
 			batchingWithIndices = true;
 
-		// Don't request more bytes than a UBO can hold
-		const unsigned long currentSize = nonBlockUniformsSize + nonInstancesBlocksSize + instancesBlockSize;
-		if (currentSize + singleInstanceBlockSize > UboMaxSize)
+		// Don't request more bytes than a UBO or a texture buffer can hold
+		const unsigned long currentSize = withTextureBuffer ? instancesBlockSize : nonBlockUniformsSize + nonInstancesBlocksSize + instancesBlockSize;
+		const unsigned long maxSize = withTextureBuffer ? RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::TEXTURE).maxSize : UboMaxSize;
+		const unsigned int commandNumInstances = glyphInstances ? numGlyphs((*it)->geometry()) : 1;
+		const unsigned long commandInstancesSize = commandNumInstances * singleInstanceBlockSize;
+		if (currentSize + commandInstancesSize > maxSize)
+			break;
+		else if (glyphInstances && maxNumInstances > 0 && numGlyphInstances + commandNumInstances > maxNumInstances)
 			break;
 		else
-			instancesBlockSize += singleInstanceBlockSize;
+		{
+			instancesBlockSize += commandInstancesSize;
+			numGlyphInstances += commandNumInstances;
+		}
 
 		++it;
 	}
 	nextStart = it;
 
-	batchCommand->material().setUniformsDataPointer(acquireMemory(nonBlockUniformsSize + nonInstancesBlocksSize + instancesBlockSize));
+	// Instance data written to a texture buffer does not need any memory for uniforms
+	const unsigned long uniformsInstancesSize = withTextureBuffer ? 0 : instancesBlockSize;
+	batchCommand->material().setUniformsDataPointer(acquireMemory(nonBlockUniformsSize + nonInstancesBlocksSize + uniformsInstancesSize));
 	// Copying data for non-instances uniform blocks from the first command in the batch
 	for (const GLUniformBlockCache &uniformBlockCache : allUniformBlocks)
 	{
@@ -222,7 +345,8 @@ RenderCommand *RenderBatcher::collectCommands(
 	const unsigned long maxIndexDataSize = RenderResources::buffersManager().specs(RenderBuffersManager::BufferTypes::ELEMENT_ARRAY).maxSize;
 	// Sum the amount of VBO and IBO memory required by the batch
 	it = start;
-	const bool refShaderHasAttributes = (refShader->numAttributes() > 0);
+	// The vertices of text nodes are not copied when their glyphs are encoded as instances
+	const bool refShaderHasAttributes = (refShader->numAttributes() > 0 && glyphInstances == false);
 	while (it != nextStart)
 	{
 		unsigned int vertexDataSize = 0;
@@ -269,6 +393,21 @@ RenderCommand *RenderBatcher::collectCommands(
 
 	float *destVtx = nullptr;
 	GLushort *destIdx = nullptr;
+	GLubyte *destInstances = nullptr;
+	const GLTexture *instancesTexture = nullptr;
+
+	if (withTextureBuffer)
+	{
+		// The texture buffer memory is acquired only now that the final number of commands in the batch is known
+		const unsigned long instancesSize = singleInstanceBlockSize * (nextStart - start);
+		const RenderBuffersManager::Parameters params = RenderResources::buffersManager().acquireMemory(RenderBuffersManager::BufferTypes::TEXTURE, instancesSize);
+		destInstances = params.mapBase + params.offset;
+		instancesTexture = params.texture;
+
+		const int texelOffset = static_cast<int>(params.offset / RenderBuffersManager::TextureBufferTexelSize);
+		batchCommand->material().uniform(Material::InstancesOffsetUniformName)->setIntValue(texelOffset);
+		batchCommand->material().uniform(Material::InstancesTextureUniformName)->setIntValue(InstancesTextureUnit);
+	}
 
 	const bool batchedShaderHasAttributes = (batchedShader->numAttributes() > 1);
 	if (batchedShaderHasAttributes)
@@ -280,7 +419,71 @@ RenderCommand *RenderBatcher::collectCommands(
 			destIdx = batchCommand->geometry().acquireIndexPointer(instancesIndicesAmount);
 	}
 
-	it = start;
+	// The data is copied later, possibly on a worker thread, as the destination memory has already been acquired
+	fills_.pushBack(BatchFill());
+	BatchFill &fill = fills_.back();
+	fill.start = &(*start);
+	fill.end = fill.start + (nextStart - start);
+	fill.batchCommand = batchCommand;
+	fill.instancesBlock = instancesBlock;
+	fill.destInstances = destInstances;
+	fill.singleInstanceBlockSize = singleInstanceBlockSize;
+	fill.destVtx = destVtx;
+	fill.destIdx = destIdx;
+	fill.numFloatsVertexFormat = NumFloatsVertexFormat;
+	fill.batchingWithIndices = batchingWithIndices;
+	fill.hasAttributes = batchedShaderHasAttributes;
+	fill.compact = compact;
+	fill.glyphInstances = glyphInstances;
+	fill.compactOffsets = compactOffsets;
+
+	const unsigned int numInstances = glyphInstances ? instancesBlockSize / singleInstanceBlockSize : nextStart - start;
+	const unsigned int instancesBlockOffset = singleInstanceBlockSize * numInstances;
+	for (unsigned int i = 0; i < GLTexture::MaxTextureUnits; i++)
+		batchCommand->material().setTexture(i, refCommand->material().texture(i));
+	if (withTextureBuffer)
+	{
+		ASSERT(refCommand->material().texture(InstancesTextureUnit) == nullptr);
+		batchCommand->material().setTexture(InstancesTextureUnit, instancesTexture);
+	}
+	batchCommand->material().setBlendingEnabled(refCommand->material().isBlendingEnabled());
+	batchCommand->material().setBlendingFactors(refCommand->material().srcBlendingFactor(), refCommand->material().destBlendingFactor());
+	batchCommand->setBatchSize(nextStart - start);
+	if (instancesBlock != nullptr)
+		instancesBlock->setUsedSize(instancesBlockOffset);
+	batchCommand->setLayer(refCommand->layer());
+	batchCommand->setVisitOrder(refCommand->visitOrder());
+
+	if (batchedShaderHasAttributes)
+	{
+		const unsigned int totalVertices = instancesVertexDataSize / SizeVertexFormatAndIndex;
+		batchCommand->geometry().setDrawParameters(refCommand->geometry().primitiveType(), 0, totalVertices);
+		batchCommand->geometry().setNumElementsPerVertex(NumFloatsVertexFormatAndIndex);
+		batchCommand->geometry().setNumIndices(instancesIndicesAmount);
+	}
+	else
+		batchCommand->geometry().setDrawParameters(GL_TRIANGLES, 0, 6 * numInstances);
+
+	return batchCommand;
+}
+
+void RenderBatcher::fillBatch(const BatchFill &fill)
+{
+	ZoneScoped;
+
+	RenderCommand *const *start = fill.start;
+	RenderCommand *const *nextStart = fill.end;
+	const unsigned int singleInstanceBlockSize = fill.singleInstanceBlockSize;
+	const bool batchingWithIndices = fill.batchingWithIndices;
+
+	const unsigned int NumFloatsVertexFormat = fill.numFloatsVertexFormat;
+	const unsigned int NumFloatsVertexFormatAndIndex = NumFloatsVertexFormat + 1; // index is an `int`, same size as a `float`
+	const unsigned int SizeVertexFormat = NumFloatsVertexFormat * 4;
+
+	float *destVtx = fill.destVtx;
+	GLushort *destIdx = fill.destIdx;
+
+	RenderCommand *const *it = start;
 	unsigned int instancesBlockOffset = 0;
 	unsigned short batchFirstVertexId = 0;
 	while (it != nextStart)
@@ -289,11 +492,28 @@ RenderCommand *RenderBatcher::collectCommands(
 		command->commitNodeTransformation();
 
 		const GLUniformBlockCache *singleInstanceBlock = command->material().uniformBlock(Material::InstanceBlockName);
-		const bool dataCopied = instancesBlock->copyData(instancesBlockOffset, singleInstanceBlock->dataPointer(), singleInstanceBlockSize);
-		ASSERT(dataCopied);
-		instancesBlockOffset += singleInstanceBlockSize;
+		unsigned int numInstances = 1;
+		if (fill.glyphInstances)
+		{
+			numInstances = numGlyphs(command->geometry());
+			ASSERT(instancesBlockOffset + numInstances * singleInstanceBlockSize <= static_cast<unsigned int>(fill.instancesBlock->usedSize()));
+			encodeCompactGlyphs(fill.instancesBlock->dataPointer() + instancesBlockOffset, singleInstanceBlock->dataPointer(), fill.compactOffsets, command->geometry());
+		}
+		else if (fill.compact)
+		{
+			ASSERT(instancesBlockOffset + singleInstanceBlockSize <= static_cast<unsigned int>(fill.instancesBlock->usedSize()));
+			encodeCompactInstance(fill.instancesBlock->dataPointer() + instancesBlockOffset, singleInstanceBlock->dataPointer(), fill.compactOffsets);
+		}
+		else if (fill.destInstances != nullptr)
+			memcpy(fill.destInstances + instancesBlockOffset, singleInstanceBlock->dataPointer(), singleInstanceBlockSize);
+		else
+		{
+			const bool dataCopied = fill.instancesBlock->copyData(instancesBlockOffset, singleInstanceBlock->dataPointer(), singleInstanceBlockSize);
+			ASSERT(dataCopied);
+		}
+		instancesBlockOffset += singleInstanceBlockSize * numInstances;
 
-		if (batchedShaderHasAttributes)
+		if (fill.hasAttributes)
 		{
 			const unsigned int numVertices = command->geometry().numVertices();
 			const int meshIndex = it - start;
@@ -323,7 +543,7 @@ RenderCommand *RenderBatcher::collectCommands(
 				destVtx += NumFloatsVertexFormatAndIndex;
 			}
 
-			if (instancesIndicesAmount > 0)
+			if (destIdx != nullptr)
 			{
 				unsigned short vertexId = 0;
 				const unsigned int numIndices = command->geometry().numIndices() ? command->geometry().numIndices() : numVertices;
@@ -358,40 +578,97 @@ RenderCommand *RenderBatcher::collectCommands(
 
 		++it;
 	}
+}
 
-	if (batchedShaderHasAttributes)
-	{
-		batchCommand->geometry().releaseVertexPointer();
-		if (destIdx)
-			batchCommand->geometry().releaseIndexPointer();
-	}
+void RenderBatcher::fillBatches(unsigned int first, unsigned int count, const void *data)
+{
+	const RenderBatcher *renderBatcher = static_cast<const RenderBatcher *>(data);
+	for (unsigned int i = first; i < first + count; i++)
+		fillBatch(renderBatcher->fills_[i]);
+}
 
-	for (unsigned int i = 0; i < GLTexture::MaxTextureUnits; i++)
-		batchCommand->material().setTexture(i, refCommand->material().texture(i));
-	batchCommand->material().setBlendingEnabled(refCommand->material().isBlendingEnabled());
-	batchCommand->material().setBlendingFactors(refCommand->material().srcBlendingFactor(), refCommand->material().destBlendingFactor());
-	batchCommand->setBatchSize(nextStart - start);
-	batchCommand->material().uniformBlock(Material::InstancesBlockName)->setUsedSize(instancesBlockOffset);
-	batchCommand->setLayer(refCommand->layer());
-	batchCommand->setVisitOrder(refCommand->visitOrder());
+void RenderBatcher::encodeCompactInstance(GLubyte *dest, const GLubyte *src, const CompactOffsets &offsets)
+{
+	const float *modelMatrix = reinterpret_cast<const float *>(src + offsets.modelMatrix);
+	const float *color = reinterpret_cast<const float *>(src + offsets.color);
+	const float *spriteSize = reinterpret_cast<const float *>(src + offsets.spriteSize);
+	float *destFloats = reinterpret_cast<float *>(dest);
+
+	// The first two columns of the model matrix scaled by the sprite size
+	destFloats[0] = modelMatrix[0] * spriteSize[0];
+	destFloats[1] = modelMatrix[1] * spriteSize[0];
+	destFloats[2] = modelMatrix[4] * spriteSize[1];
+	destFloats[3] = modelMatrix[5] * spriteSize[1];
+	// The translation and the depth
+	destFloats[4] = modelMatrix[12];
+	destFloats[5] = modelMatrix[13];
+	destFloats[6] = modelMatrix[14];
+
+	const uint32_t packedColor = packColor(color);
+	memcpy(dest + 7 * sizeof(GLfloat), &packedColor, sizeof(uint32_t));
+
+	if (offsets.texRect >= 0)
+		memcpy(dest + CompactInstanceSize, src + offsets.texRect, 4 * sizeof(GLfloat));
+}
 
-	if (batchedShaderHasAttributes)
+/*! The geometry of a text node is a triangle strip where every glyph quad starts six vertices after the previous one,
+ *  the vertices of a quad are in bottom-left, top-left, bottom-right and top-right order. */
+void RenderBatcher::encodeCompactGlyphs(GLubyte *dest, const GLubyte *src, const CompactOffsets &offsets, const Geometry &geometry)
+{
+	const float *modelMatrix = reinterpret_cast<const float *>(src + offsets.modelMatrix);
+	const float *color = reinterpret_cast<const float *>(src + offsets.color);
+	const uint32_t packedColor = packColor(color);
+
+	const unsigned int numElementsPerVertex = geometry.numElementsPerVertex();
+	const unsigned int count = numGlyphs(geometry);
+	const float *srcVtx = geometry.hostVertexPointer();
+	FATAL_ASSERT(srcVtx != nullptr || count == 0);
+
+	for (unsigned int i = 0; i < count; i++)
 	{
-		const unsigned int totalVertices = instancesVertexDataSize / SizeVertexFormatAndIndex;
-		batchCommand->geometry().setDrawParameters(refCommand->geometry().primitiveType(), 0, totalVertices);
-		batchCommand->geometry().setNumElementsPerVertex(NumFloatsVertexFormatAndIndex);
-		batchCommand->geometry().setNumIndices(instancesIndicesAmount);
+		const float *bottomLeft = srcVtx + i * 6 * numElementsPerVertex;
+		const float *topRight = bottomLeft + 3 * numElementsPerVertex;
+		const float width = topRight[0] - bottomLeft[0];
+		const float height = topRight[1] - bottomLeft[1];
+		const float centerX = bottomLeft[0] + width * 0.5f;
+		const float centerY = bottomLeft[1] + height * 0.5f;
+
+		float *destFloats = reinterpret_cast<float *>(dest);
+		// The first two columns of the model matrix scaled by the glyph size
+		destFloats[0] = modelMatrix[0] * width;
+		destFloats[1] = modelMatrix[1] * width;
+		destFloats[2] = modelMatrix[4] * height;
+		destFloats[3] = modelMatrix[5] * height;
+		// The glyph center transformed by the model matrix and the depth
+		destFloats[4] = modelMatrix[0] * centerX + modelMatrix[4] * centerY + modelMatrix[12];
+		destFloats[5] = modelMatrix[1] * centerX + modelMatrix[5] * centerY + modelMatrix[13];
+		destFloats[6] = modelMatrix[14];
+		memcpy(dest + 7 * sizeof(GLfloat), &packedColor, sizeof(uint32_t));
+
+		// The texture rectangle as scale and offset, the texture coordinates start from the top of the quad
+		destFloats[8] = topRight[2] - bottomLeft[2];
+		destFloats[9] = bottomLeft[2];
+		destFloats[10] = bottomLeft[3] - topRight[3];
+		destFloats[11] = topRight[3];
+
+		dest += CompactTexturedInstanceSize;
 	}
-	else
-		batchCommand->geometry().setDrawParameters(GL_TRIANGLES, 0, 6 * (nextStart - start));
+}
 
-	return batchCommand;
+unsigned int RenderBatcher::numGlyphs(const Geometry &geometry)
+{
+	// Four vertices for every glyph quad and two degenerate ones between adjacent quads
+	return (geometry.numVertices() + 2) / 6;
 }
 
 unsigned char *RenderBatcher::acquireMemory(unsigned int bytes)
 {
 	FATAL_ASSERT(bytes <= UboMaxSize);
 
+#ifdef WITH_ALLOCATORS
+	// The data is committed to the UBOs during the same frame, the memory is reclaimed by the frame allocator
+	return static_cast<unsigned char *>(nctl::theFrameAllocator().allocate(bytes));
+#else
 	unsigned char *ptr = nullptr;
 
 	for (ManagedBuffer &buffer : buffers_)
@@ -413,6 +690,7 @@ unsigned char *RenderBatcher::acquireMemory(unsigned int bytes)
 	}
 
 	return ptr;
+#endif
 }
 
 void RenderBatcher::createBuffer(unsigned int size)
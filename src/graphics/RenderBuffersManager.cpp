@@ -2,22 +2,39 @@
 #include "RenderBuffersManager.h"
 #include "RenderStatistics.h"
 #include "GLDebug.h"
+#include "TimeStamp.h"
 #include "tracy.h"
 
+#if !defined(WITH_OPENGLES) && !defined(__EMSCRIPTEN__) && defined(GL_MAP_PERSISTENT_BIT)
+	#define WITH_PERSISTENT_MAPPING
+#endif
+
 namespace ncine {
 
 namespace {
 	/// The string used to output OpenGL debug group information
 	static nctl::StaticString<64> debugString;
+
+#ifdef WITH_PERSISTENT_MAPPING
+	/// The flags for the storage and the mapping of persistent buffers, the ones in the specifications are still used by custom buffers
+	const GLbitfield PersistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+#endif
 }
 
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
-RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, unsigned long vboMaxSize, unsigned long iboMaxSize)
-    : buffers_(4)
+RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, bool usePersistentMapping, unsigned long vboMaxSize, unsigned long iboMaxSize, unsigned long tboMaxSize)
+    : buffers_(4), ringIndex_(0)
 {
+	for (unsigned int i = 0; i < BufferTypes::COUNT; i++)
+	{
+		ringSectionPending_[i] = false;
+		fenceWaits_[i] = 0;
+		fenceWaitTimes_[i] = 0.0f;
+	}
+
 	BufferSpecifications &vboSpecs = specs_[BufferTypes::ARRAY];
 	vboSpecs.type = BufferTypes::ARRAY;
 	vboSpecs.target = GL_ARRAY_BUFFER;
@@ -25,6 +42,7 @@ RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, unsigned long
 	vboSpecs.usageFlags = GL_STREAM_DRAW;
 	vboSpecs.maxSize = vboMaxSize;
 	vboSpecs.alignment = sizeof(GLfloat);
+	vboSpecs.persistentMapping = false;
 
 	BufferSpecifications &iboSpecs = specs_[BufferTypes::ELEMENT_ARRAY];
 	iboSpecs.type = BufferTypes::ELEMENT_ARRAY;
@@ -33,6 +51,7 @@ RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, unsigned long
 	iboSpecs.usageFlags = GL_STREAM_DRAW;
 	iboSpecs.maxSize = iboMaxSize;
 	iboSpecs.alignment = sizeof(GLushort);
+	iboSpecs.persistentMapping = false;
 
 	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
 	const int maxUniformBlockSize = gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_UNIFORM_BLOCK_SIZE);
@@ -48,16 +67,83 @@ RenderBuffersManager::RenderBuffersManager(bool useBufferMapping, unsigned long
 	uboSpecs.usageFlags = GL_STREAM_DRAW;
 	uboSpecs.maxSize = static_cast<unsigned long>(uboMaxSize);
 	uboSpecs.alignment = static_cast<unsigned int>(offsetAlignment);
+	uboSpecs.persistentMapping = false;
+
+	BufferSpecifications &tboSpecs = specs_[BufferTypes::TEXTURE];
+	tboSpecs.type = BufferTypes::TEXTURE;
+	tboSpecs.target = 0;
+	tboSpecs.mapFlags = useBufferMapping ? GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_FLUSH_EXPLICIT_BIT : 0;
+	tboSpecs.usageFlags = GL_STREAM_DRAW;
+	tboSpecs.maxSize = 0;
+	tboSpecs.alignment = TextureBufferTexelSize;
+	// A ring would triple the size of a texture buffer, that is already limited by the device
+	tboSpecs.persistentMapping = false;
+#if !defined(WITH_OPENGLES) && !defined(__EMSCRIPTEN__)
+	if (tboMaxSize > 0 && hasTextureBuffers())
+	{
+		// The maximum size is expressed in texels
+		const unsigned long maxTextureBufferSize = static_cast<unsigned long>(gfxCaps.value(IGfxCapabilities::GLIntValues::MAX_TEXTURE_BUFFER_SIZE)) * TextureBufferTexelSize;
+		tboSpecs.target = GL_TEXTURE_BUFFER;
+		tboSpecs.maxSize = tboMaxSize <= maxTextureBufferSize ? tboMaxSize : maxTextureBufferSize;
+	}
+#endif
+
+#ifdef WITH_PERSISTENT_MAPPING
+	if (usePersistentMapping)
+	{
+		if (hasPersistentMapping())
+		{
+			for (unsigned int i = BufferTypes::ARRAY; i <= BufferTypes::UNIFORM; i++)
+			{
+				// A section of the ring cannot be aligned to a bigger amount than its padding
+				ASSERT(specs_[i].alignment <= RingSectionPadding);
+				specs_[i].persistentMapping = true;
+			}
+		}
+		else
+			LOGW("Persistent mapping of buffers has been requested but it is not supported");
+	}
+#else
+	if (usePersistentMapping)
+		LOGW("Persistent mapping of buffers has been requested but it is not supported");
+#endif
 
-	// Create the first buffer for each type right away
+	// Create the first buffer for each available type right away
 	for (unsigned int i = 0; i < BufferTypes::COUNT; i++)
-		createBuffer(specs_[i]);
+	{
+		if (specs_[i].maxSize > 0)
+			createBuffer(specs_[i]);
+	}
 }
 
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+bool RenderBuffersManager::hasTextureBuffers()
+{
+#if !defined(WITH_OPENGLES) && !defined(__EMSCRIPTEN__)
+	// Shaders are compiled as GLSL 3.30 on desktop, where buffer samplers are part of the core language
+	return (theServiceLocator().gfxCapabilities().value(IGfxCapabilities::GLIntValues::MAX_TEXTURE_BUFFER_SIZE) > 0);
+#else
+	return false;
+#endif
+}
+
+bool RenderBuffersManager::hasPersistentMapping()
+{
+#ifdef WITH_PERSISTENT_MAPPING
+	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
+	const int majorVersion = gfxCaps.glVersion(IGfxCapabilities::GLVersion::MAJOR);
+	const int minorVersion = gfxCaps.glVersion(IGfxCapabilities::GLVersion::MINOR);
+	// Buffer storage is part of the core profile since OpenGL 4.4
+	return (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4) ||
+	        gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_BUFFER_STORAGE));
+#else
+	return false;
+#endif
+}
+
 namespace {
 
 	const char *bufferTypeToString(RenderBuffersManager::BufferTypes::Enum type)
@@ -67,6 +153,7 @@ namespace {
 			case RenderBuffersManager::BufferTypes::Enum::ARRAY: return "Array";
 			case RenderBuffersManager::BufferTypes::Enum::ELEMENT_ARRAY: return "Element Array";
 			case RenderBuffersManager::BufferTypes::Enum::UNIFORM: return "Uniform";
+			case RenderBuffersManager::BufferTypes::Enum::TEXTURE: return "Texture";
 			case RenderBuffersManager::BufferTypes::Enum::COUNT: return "";
 		}
 
@@ -77,42 +164,32 @@ namespace {
 
 RenderBuffersManager::Parameters RenderBuffersManager::acquireMemory(BufferTypes::Enum type, unsigned long bytes, unsigned int alignment)
 {
+	FATAL_ASSERT_MSG_X(isAvailable(type), "Buffer type \"%s\" is not available", bufferTypeToString(type));
 	FATAL_ASSERT_MSG_X(bytes <= specs_[type].maxSize, "Trying to acquire %lu bytes when the maximum for buffer type \"%s\" is %lu",
 	                   bytes, bufferTypeToString(type), specs_[type].maxSize);
 
 	// Accepting a custom alignment only if it is a multiple of the specification one
 	if (alignment % specs_[type].alignment != 0)
 		alignment = specs_[type].alignment;
+	ASSERT(specs_[type].persistentMapping == false || alignment <= RingSectionPadding);
+
+	// The GPU might still be reading the section of the ring from some frames ago
+	if (ringSectionPending_[type])
+		waitForRingSection(type);
 
 	Parameters params;
 
 	for (ManagedBuffer &buffer : buffers_)
 	{
-		if (buffer.type == type)
-		{
-			const unsigned long offset = buffer.size - buffer.freeSpace;
-			const unsigned int alignAmount = (alignment - offset % alignment) % alignment;
-
-			if (buffer.freeSpace >= bytes + alignAmount)
-			{
-				params.object = buffer.object.get();
-				params.offset = offset + alignAmount;
-				params.size = bytes;
-				buffer.freeSpace -= bytes + alignAmount;
-				params.mapBase = buffer.mapBase;
-				break;
-			}
-		}
+		if (buffer.type == type && acquireFromBuffer(buffer, bytes, alignment, params))
+			break;
 	}
 
 	if (params.object == nullptr)
 	{
 		createBuffer(specs_[type]);
-		params.object = buffers_.back().object.get();
-		params.offset = 0;
-		params.size = bytes;
-		buffers_.back().freeSpace -= bytes;
-		params.mapBase = buffers_.back().mapBase;
+		const bool acquired = acquireFromBuffer(buffers_.back(), bytes, alignment, params);
+		FATAL_ASSERT(acquired);
 	}
 
 	return params;
@@ -122,18 +199,65 @@ RenderBuffersManager::Parameters RenderBuffersManager::acquireMemory(BufferTypes
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+bool RenderBuffersManager::acquireFromBuffer(ManagedBuffer &buffer, unsigned long bytes, unsigned int alignment, Parameters &params)
+{
+	// The alignment is relative to the start of the buffer, not to the one of the section
+	const unsigned long offset = buffer.sectionOffset + buffer.size - buffer.freeSpace;
+	const unsigned int alignAmount = (alignment - offset % alignment) % alignment;
+
+	if (buffer.freeSpace < bytes + alignAmount)
+		return false;
+
+	params.object = buffer.object.get();
+	params.offset = offset + alignAmount;
+	params.size = bytes;
+	buffer.freeSpace -= bytes + alignAmount;
+	params.mapBase = buffer.mapBase;
+	params.texture = buffer.texture.get();
+
+	return true;
+}
+
+void RenderBuffersManager::waitForRingSection(BufferTypes::Enum type)
+{
+	ringSectionPending_[type] = false;
+
+	GLFence &fence = ringFences_[ringIndex_];
+	if (fence.isSignaled())
+		return;
+
+	ZoneScoped;
+	const TimeStamp waitStart = TimeStamp::now();
+	fenceWaits_[type]++;
+
+	GLenum result = fence.clientWait(RingFenceTimeout);
+	while (result == GL_TIMEOUT_EXPIRED)
+		result = fence.clientWait(RingFenceTimeout);
+	if (result == GL_WAIT_FAILED)
+		LOGW_X("Failed waiting for the fence of ring section %u", ringIndex_);
+
+	fenceWaitTimes_[type] += waitStart.millisecondsSince();
+}
+
 void RenderBuffersManager::flushUnmap()
 {
 	ZoneScoped;
 	GLDebug::ScopedGroup scoped("RenderBuffersManager::flushUnmap()");
 
+	for (unsigned int i = 0; i < BufferTypes::COUNT; i++)
+		RenderStatistics::gatherStatistics(static_cast<BufferTypes::Enum>(i), fenceWaits_[i], fenceWaitTimes_[i]);
+
 	for (ManagedBuffer &buffer : buffers_)
 	{
 		RenderStatistics::gatherStatistics(buffer);
 		const unsigned long usedSize = buffer.size - buffer.freeSpace;
-		FATAL_ASSERT(usedSize <= specs_[buffer.type].maxSize);
+		FATAL_ASSERT(usedSize <= buffer.size);
 		buffer.freeSpace = buffer.size;
 
+		// A coherent mapping does not need to be flushed and the buffer stays mapped
+		if (specs_[buffer.type].persistentMapping)
+			continue;
+
 		if (specs_[buffer.type].mapFlags == 0)
 		{
 			if (usedSize > 0)
@@ -155,11 +279,32 @@ void RenderBuffersManager::remap()
 	ZoneScoped;
 	GLDebug::ScopedGroup scoped("RenderBuffersManager::remap()");
 
+	// The commands reading the section of this frame have all been issued, the next frame writes to the following one
+	bool hasRings = false;
+	for (unsigned int i = 0; i < BufferTypes::COUNT; i++)
+	{
+		hasRings |= specs_[i].persistentMapping;
+		ringSectionPending_[i] = specs_[i].persistentMapping;
+		fenceWaits_[i] = 0;
+		fenceWaitTimes_[i] = 0.0f;
+	}
+	if (hasRings)
+	{
+		ringFences_[ringIndex_].insert();
+		ringIndex_ = (ringIndex_ + 1) % NumRingSections;
+	}
+
 	for (ManagedBuffer &buffer : buffers_)
 	{
 		ASSERT(buffer.freeSpace == buffer.size);
-		ASSERT(buffer.mapBase == nullptr);
 
+		if (specs_[buffer.type].persistentMapping)
+		{
+			buffer.sectionOffset = ringIndex_ * buffer.size;
+			continue;
+		}
+
+		ASSERT(buffer.mapBase == nullptr);
 		if (specs_[buffer.type].mapFlags == 0)
 		{
 			buffer.object->bufferData(buffer.size, nullptr, specs_[buffer.type].usageFlags);
@@ -180,7 +325,19 @@ void RenderBuffersManager::createBuffer(const BufferSpecifications &specs)
 	managedBuffer.type = specs.type;
 	managedBuffer.size = specs.maxSize;
 	managedBuffer.object = nctl::makeUnique<GLBufferObject>(specs.target);
-	managedBuffer.object->bufferData(managedBuffer.size, nullptr, specs.usageFlags);
+#ifdef WITH_PERSISTENT_MAPPING
+	if (specs.persistentMapping)
+	{
+		// Every section is written by a different frame, the padding keeps an aligned request of the maximum size inside it
+		managedBuffer.size = specs.maxSize + RingSectionPadding;
+		managedBuffer.numSections = NumRingSections;
+		managedBuffer.sectionOffset = ringIndex_ * managedBuffer.size;
+		managedBuffer.object->bufferStorage(managedBuffer.size * NumRingSections, nullptr, PersistentMapFlags);
+		managedBuffer.mapBase = static_cast<GLubyte *>(managedBuffer.object->mapBufferRange(0, managedBuffer.size * NumRingSections, PersistentMapFlags));
+	}
+	else
+#endif
+		managedBuffer.object->bufferData(managedBuffer.size, nullptr, specs.usageFlags);
 	managedBuffer.freeSpace = managedBuffer.size;
 
 	switch (managedBuffer.type)
@@ -195,15 +352,32 @@ void RenderBuffersManager::createBuffer(const BufferSpecifications &specs)
 		case BufferTypes::Enum::UNIFORM:
 			managedBuffer.object->setObjectLabel("Uniform_ManagedBuffer");
 			break;
+		case BufferTypes::Enum::TEXTURE:
+			managedBuffer.object->setObjectLabel("Texture_ManagedBuffer");
+			break;
 	}
 
-	if (specs.mapFlags == 0)
+#if !defined(WITH_OPENGLES) && !defined(__EMSCRIPTEN__)
+	if (managedBuffer.type == BufferTypes::Enum::TEXTURE)
 	{
-		managedBuffer.hostBuffer = nctl::makeUnique<GLubyte[]>(specs.maxSize);
-		managedBuffer.mapBase = managedBuffer.hostBuffer.get();
+		// Every texel holds four floats of instance data
+		managedBuffer.texture = nctl::makeUnique<GLTexture>(GL_TEXTURE_BUFFER);
+		managedBuffer.texture->bind();
+		managedBuffer.object->texBuffer(GL_RGBA32F);
+		managedBuffer.texture->setObjectLabel("Texture_ManagedBuffer");
+	}
+#endif
+
+	if (specs.persistentMapping == false)
+	{
+		if (specs.mapFlags == 0)
+		{
+			managedBuffer.hostBuffer = nctl::makeUnique<GLubyte[]>(specs.maxSize);
+			managedBuffer.mapBase = managedBuffer.hostBuffer.get();
+		}
+		else
+			managedBuffer.mapBase = static_cast<GLubyte *>(managedBuffer.object->mapBufferRange(0, managedBuffer.size, specs.mapFlags));
 	}
-	else
-		managedBuffer.mapBase = static_cast<GLubyte *>(managedBuffer.object->mapBufferRange(0, managedBuffer.size, specs.mapFlags));
 
 	FATAL_ASSERT(managedBuffer.mapBase != nullptr);
 
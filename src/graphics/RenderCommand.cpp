@@ -20,7 +20,7 @@ const float RenderCommand::LayerStep = 1.0f / static_cast<float>(0xFFFF);
 
 RenderCommand::RenderCommand(CommandTypes::Enum profilingType)
     : materialSortKey_(0), layer_(0),
-      numInstances_(0), batchSize_(0), transformationCommitted_(false),
+      numInstances_(0), batchSize_(0), transformationCommitted_(false), transformation2D_(true),
       profilingType_(profilingType), modelMatrix_(Matrix4x4f::Identity)
 {
 }
@@ -77,6 +77,10 @@ void RenderCommand::setTransformation(const Matrix4x4f &modelMatrix)
 {
 	modelMatrix_ = modelMatrix;
 	transformationCommitted_ = false;
+
+	// A vertex on the XY plane is only transformed by the first two columns and by the translation one
+	transformation2D_ = (modelMatrix[0][2] == 0.0f && modelMatrix[0][3] == 0.0f &&
+	                     modelMatrix[1][2] == 0.0f && modelMatrix[1][3] == 0.0f && modelMatrix[3][3] == 1.0f);
 }
 
 void RenderCommand::commitNodeTransformation()
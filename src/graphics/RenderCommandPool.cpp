@@ -1,15 +1,25 @@
+#include <nctl/HashMapIterator.h>
 #include "RenderCommandPool.h"
 #include "RenderCommand.h"
 #include "RenderStatistics.h"
 
 namespace ncine {
 
+namespace {
+	/// The initial number of buckets of the hashmap of free lists
+	const unsigned int FreeListsHashMapCapacity = 32;
+	/// The number of resets after which the commands of a shader program that is not used anymore are deleted
+	/*! \note A shader program might have been destroyed, its address could then be reused by a new one */
+	const unsigned int MaxIdleResets = 120;
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
 RenderCommandPool::RenderCommandPool(unsigned int poolSize)
-    : freeCommandsPool_(poolSize), usedCommandsPool_(poolSize)
+    : commandsPool_(poolSize), usedCommands_(poolSize),
+      freeCommands_(FreeListsHashMapCapacity), numFreeCommands_(0)
 {
 }
 
@@ -22,9 +32,10 @@ RenderCommandPool::~RenderCommandPool() = default;
 RenderCommand *RenderCommandPool::add()
 {
 	nctl::UniquePtr<RenderCommand> newCommand = nctl::makeUnique<RenderCommand>();
-	usedCommandsPool_.pushBack(nctl::move(newCommand));
+	commandsPool_.pushBack(nctl::move(newCommand));
+	usedCommands_.pushBack(commandsPool_.back().get());
 
-	return usedCommandsPool_.back().get();
+	return usedCommands_.back();
 }
 
 RenderCommand *RenderCommandPool::add(GLShaderProgram *shaderProgram)
@@ -39,22 +50,19 @@ RenderCommand *RenderCommandPool::retrieve(GLShaderProgram *shaderProgram)
 {
 	RenderCommand *retrievedCommand = nullptr;
 
-	for (unsigned int i = 0; i < freeCommandsPool_.size(); i++)
+	FreeList *freeList = freeCommands_.find(shaderProgram);
+	if (freeList && freeList->commands.isEmpty() == false)
 	{
-		const unsigned int poolSize = freeCommandsPool_.size();
-		nctl::UniquePtr<RenderCommand> &command = freeCommandsPool_[i];
-		if (command && command->material().shaderProgram() == shaderProgram)
-		{
-			retrievedCommand = command.get();
-			usedCommandsPool_.pushBack(nctl::move(command));
-			command = nctl::move(freeCommandsPool_[poolSize - 1]);
-			freeCommandsPool_.popBack();
-			break;
-		}
+		retrievedCommand = freeList->commands.back();
+		freeList->commands.popBack();
+		numFreeCommands_--;
+		usedCommands_.pushBack(retrievedCommand);
 	}
 
 	if (retrievedCommand)
 		RenderStatistics::addCommandPoolRetrieval();
+	else
+		RenderStatistics::addCommandPoolMiss();
 
 	return retrievedCommand;
 }
@@ -75,11 +83,70 @@ RenderCommand *RenderCommandPool::retrieveOrAdd(GLShaderProgram *shaderProgram,
 
 void RenderCommandPool::reset()
 {
-	RenderStatistics::gatherCommandPoolStatistics(usedCommandsPool_.size(), freeCommandsPool_.size());
+	RenderStatistics::gatherCommandPoolStatistics(usedCommands_.size(), numFreeCommands_);
+
+	for (nctl::HashMap<const GLShaderProgram *, FreeList>::Iterator i = freeCommands_.begin(); i != freeCommands_.end(); ++i)
+		(*i).numIdleResets++;
+
+	// The shader program is read again as it could have been changed after the command was retrieved
+	for (RenderCommand *command : usedCommands_)
+	{
+		const GLShaderProgram *shaderProgram = command->material().shaderProgram();
+		FreeList *freeList = freeCommands_.find(shaderProgram);
+		if (freeList == nullptr)
+		{
+			if (freeCommands_.loadFactor() >= 0.8f)
+				freeCommands_.rehash(freeCommands_.capacity() * 2);
+			freeCommands_.emplace(shaderProgram);
+			freeList = freeCommands_.find(shaderProgram);
+		}
+		freeList->commands.pushBack(command);
+		freeList->numIdleResets = 0;
+	}
+	numFreeCommands_ += usedCommands_.size();
+	usedCommands_.clear();
+
+	idleShaderPrograms_.clear();
+	for (nctl::HashMap<const GLShaderProgram *, FreeList>::Iterator i = freeCommands_.begin(); i != freeCommands_.end(); ++i)
+	{
+		if (i.value().numIdleResets > MaxIdleResets)
+			idleShaderPrograms_.pushBack(i.key());
+	}
+	if (idleShaderPrograms_.isEmpty() == false)
+		pruneIdleFreeLists();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void RenderCommandPool::pruneIdleFreeLists()
+{
+	// All commands are free after a reset, the ones using an idle shader program are in its free list
+	for (unsigned int i = 0; i < commandsPool_.size();)
+	{
+		const GLShaderProgram *shaderProgram = commandsPool_[i]->material().shaderProgram();
+		bool isIdle = false;
+		for (const GLShaderProgram *idleShaderProgram : idleShaderPrograms_)
+		{
+			if (shaderProgram == idleShaderProgram)
+			{
+				isIdle = true;
+				break;
+			}
+		}
+
+		if (isIdle)
+			commandsPool_.unorderedRemoveAt(i);
+		else
+			i++;
+	}
 
-	for (nctl::UniquePtr<RenderCommand> &command : usedCommandsPool_)
-		freeCommandsPool_.pushBack(nctl::move(command));
-	usedCommandsPool_.clear();
+	for (const GLShaderProgram *idleShaderProgram : idleShaderPrograms_)
+	{
+		numFreeCommands_ -= freeCommands_.find(idleShaderProgram)->commands.size();
+		freeCommands_.remove(idleShaderProgram);
+	}
 }
 
 }
@@ -1,3 +1,4 @@
+#include <cstring> // for memcmp() and memcpy()
 #include <nctl/algorithms.h>
 #include <nctl/StaticString.h>
 #include "RenderQueue.h"
@@ -16,6 +17,11 @@ namespace ncine {
 namespace {
 	/// The string used to output OpenGL debug group information
 	static nctl::StaticString<64> debugString;
+
+	/// The queue whose bucket is filled by the calling thread
+	thread_local const RenderQueue *currentBucketQueue = nullptr;
+	/// The bucket filled by the calling thread, only valid for `currentBucketQueue`
+	thread_local unsigned int currentThreadBucket = RenderQueue::NoBucket;
 }
 
 ///////////////////////////////////////////////////////////
@@ -34,18 +40,79 @@ RenderQueue::RenderQueue()
 
 bool RenderQueue::isEmpty() const
 {
-	return (opaqueQueue_.isEmpty() && transparentQueue_.isEmpty());
+	if (opaqueQueue_.isEmpty() == false || transparentQueue_.isEmpty() == false)
+		return false;
+
+	for (const CommandBucket &bucket : buckets_)
+	{
+		if (bucket.commands.isEmpty() == false)
+			return false;
+	}
+
+	return true;
 }
 
 void RenderQueue::addCommand(RenderCommand *command)
 {
-	// Calculating the material sorting key before adding the command to the queue
-	command->calculateMaterialSortKey();
-
-	if (command->material().isBlendingEnabled() == false)
-		opaqueQueue_.pushBack(command);
+	const unsigned int bucketIndex = threadBucket();
+	if (bucketIndex == NoBucket)
+		enqueueCommand(command);
 	else
-		transparentQueue_.pushBack(command);
+	{
+		// No other thread is writing to the same bucket, the material sort key depends on the visit order fixed when merging
+		FATAL_ASSERT_MSG_X(bucketIndex < buckets_.size(), "Bucket index %u is out of range (%u buckets)", bucketIndex, buckets_.size());
+		buckets_[bucketIndex].commands.pushBack(command);
+	}
+}
+
+void RenderQueue::setNumBuckets(unsigned int numBuckets)
+{
+	while (buckets_.size() > numBuckets)
+	{
+		ASSERT(buckets_.back().commands.isEmpty());
+		buckets_.popBack();
+	}
+	while (buckets_.size() < numBuckets)
+		buckets_.emplaceBack();
+}
+
+void RenderQueue::setThreadBucket(unsigned int bucketIndex)
+{
+	// A thread fills the bucket of a single queue, the commands it adds to the other queues are not redirected
+	currentBucketQueue = (bucketIndex != NoBucket) ? this : nullptr;
+	currentThreadBucket = bucketIndex;
+}
+
+unsigned int RenderQueue::threadBucket() const
+{
+	return (currentBucketQueue == this) ? currentThreadBucket : NoBucket;
+}
+
+unsigned int RenderQueue::mergeBuckets(unsigned int visitOrderIndex)
+{
+	ZoneScoped;
+
+	for (CommandBucket &bucket : buckets_)
+	{
+		// The visit order indices of a bucket restart from zero, zero meaning that the visit order is disabled
+		unsigned int lastVisitOrder = 0;
+		for (RenderCommand *command : bucket.commands)
+		{
+			const unsigned int visitOrder = command->visitOrder();
+			if (visitOrder > 0)
+			{
+				command->setVisitOrder(static_cast<uint16_t>(visitOrderIndex + visitOrder));
+				if (lastVisitOrder < visitOrder)
+					lastVisitOrder = visitOrder;
+			}
+			enqueueCommand(command);
+		}
+
+		visitOrderIndex += lastVisitOrder;
+		bucket.commands.clear();
+	}
+
+	return visitOrderIndex;
 }
 
 namespace {
@@ -64,6 +131,32 @@ namespace {
 		           : a->idSortKey() < b->idSortKey();
 	}
 
+	using CompareFunction = bool (*)(const RenderCommand *, const RenderCommand *);
+
+	/// Sorts an almost sorted array, giving up if it requires more than the specified number of moves
+	bool boundedInsertionSort(RenderCommand **array, unsigned int size, CompareFunction compare, unsigned int maxMoves)
+	{
+		unsigned int numMoves = 0;
+		for (unsigned int i = 1; i < size; i++)
+		{
+			RenderCommand *command = array[i];
+			unsigned int j = i;
+			while (j > 0 && compare(command, array[j - 1]))
+			{
+				array[j] = array[j - 1];
+				j--;
+				if (++numMoves > maxMoves)
+				{
+					array[j] = command;
+					return false;
+				}
+			}
+			array[j] = command;
+		}
+
+		return true;
+	}
+
 	const char *commandTypeString(const RenderCommand &command)
 	{
 		switch (command.type())
@@ -87,22 +180,49 @@ namespace {
 
 void RenderQueue::sortAndCommit()
 {
-	const bool batchingEnabled = theApplication().renderingSettings().batchingEnabled;
+	sort();
+	createBatches();
+	commit();
+}
 
-	// Sorting the queues with the relevant orders
-	nctl::quicksort(opaqueQueue_.begin(), opaqueQueue_.end(), descendingOrder);
-	nctl::quicksort(transparentQueue_.begin(), transparentQueue_.end(), ascendingOrder);
+void RenderQueue::sort()
+{
+	bool unmergedBuckets = false;
+	for (const CommandBucket &bucket : buckets_)
+		unmergedBuckets |= (bucket.commands.isEmpty() == false);
 
-	nctl::Array<RenderCommand *> *opaques = batchingEnabled ? &opaqueBatchedQueue_ : &opaqueQueue_;
-	nctl::Array<RenderCommand *> *transparents = batchingEnabled ? &transparentBatchedQueue_ : &transparentQueue_;
+	// Commands left in the buckets follow the ones added directly to the queues
+	if (unmergedBuckets)
+	{
+		unsigned int lastVisitOrder = 0;
+		for (const RenderCommand *command : opaqueQueue_)
+			lastVisitOrder = nctl::max(lastVisitOrder, static_cast<unsigned int>(command->visitOrder()));
+		for (const RenderCommand *command : transparentQueue_)
+			lastVisitOrder = nctl::max(lastVisitOrder, static_cast<unsigned int>(command->visitOrder()));
+		mergeBuckets(lastVisitOrder);
+	}
+
+	// Sorting the queues with the relevant orders
+	sortCoherentQueue(opaqueQueue_, true, opaqueCache_);
+	sortCoherentQueue(transparentQueue_, false, transparentCache_);
+}
 
-	if (batchingEnabled)
+void RenderQueue::createBatches()
+{
+	if (theApplication().renderingSettings().batchingEnabled)
 	{
 		ZoneScopedN("Batching");
 		// Always create batches after sorting
 		RenderResources::renderBatcher().createBatches(opaqueQueue_, opaqueBatchedQueue_);
 		RenderResources::renderBatcher().createBatches(transparentQueue_, transparentBatchedQueue_);
 	}
+}
+
+void RenderQueue::commit()
+{
+	const bool batchingEnabled = theApplication().renderingSettings().batchingEnabled;
+	nctl::Array<RenderCommand *> *opaques = batchingEnabled ? &opaqueBatchedQueue_ : &opaqueQueue_;
+	nctl::Array<RenderCommand *> *transparents = batchingEnabled ? &transparentBatchedQueue_ : &transparentQueue_;
 
 	// Avoid GPU stalls by uploading to VBOs, IBOs and UBOs before drawing
 	if (opaques->isEmpty() == false)
@@ -205,4 +325,89 @@ void RenderQueue::clear()
 	RenderResources::renderBatcher().reset();
 }
 
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void RenderQueue::enqueueCommand(RenderCommand *command)
+{
+	// Calculating the material sorting key before adding the command to the queue
+	command->calculateMaterialSortKey();
+
+	if (command->material().isBlendingEnabled() == false)
+		opaqueQueue_.pushBack(command);
+	else
+		transparentQueue_.pushBack(command);
+}
+
+void RenderQueue::sortCoherentQueue(nctl::Array<RenderCommand *> &queue, bool descending, CoherenceCache &cache)
+{
+	const unsigned int size = queue.size();
+	// The caches follow the capacity of the queue, to avoid allocating every time a command is added to it
+	if (cache.commands.capacity() < queue.capacity())
+		cache.commands.setCapacity(queue.capacity());
+	if (cache.sortedCommands.capacity() < queue.capacity())
+		cache.sortedCommands.setCapacity(queue.capacity());
+
+	// The previous sorted order is a permutation of the current queue only if the very same commands have been added again
+	const bool sameCommands = (size > 1 && size == cache.commands.size() &&
+	                           memcmp(queue.data(), cache.commands.data(), size * sizeof(RenderCommand *)) == 0);
+
+	bool sorted = false;
+	if (sameCommands)
+	{
+		ZoneScopedN("Coherent sort");
+		// Giving up when the work would be comparable to a full sort
+		sorted = boundedInsertionSort(cache.sortedCommands.data(), size, descending ? descendingOrder : ascendingOrder, size);
+		if (sorted)
+			memcpy(queue.data(), cache.sortedCommands.data(), size * sizeof(RenderCommand *));
+	}
+	else
+		cache.commands = queue;
+
+	if (sorted == false)
+	{
+		sortQueue(queue, descending);
+		cache.sortedCommands = queue;
+	}
+}
+
+void RenderQueue::sortQueue(nctl::Array<RenderCommand *> &queue, bool descending)
+{
+	const unsigned int size = queue.size();
+	if (size < RadixSortThreshold)
+	{
+		nctl::quicksort(queue.begin(), queue.end(), descending ? descendingOrder : ascendingOrder);
+		return;
+	}
+
+	ZoneScoped;
+	if (sortElements_.capacity() < queue.capacity())
+		sortElements_.setCapacity(queue.capacity());
+	if (sortScratch_.capacity() < queue.capacity())
+		sortScratch_.setCapacity(queue.capacity());
+	sortElements_.setSize(size);
+	sortScratch_.setSize(size);
+
+	// Inverting the keys to sort in descending order
+	const uint64_t materialMask = descending ? ~uint64_t(0) : 0;
+	const uint32_t idMask = descending ? ~uint32_t(0) : 0;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		SortElement &element = sortElements_[i];
+		element.materialSortKey = queue[i]->materialSortKey() ^ materialMask;
+		element.idSortKey = queue[i]->idSortKey() ^ idMask;
+		element.command = queue[i];
+	}
+
+	// The radix sort is stable, the secondary key is sorted first
+	SortElement *first = sortElements_.data();
+	SortElement *last = first + size;
+	nctl::radixSort(first, last, sortScratch_.data(), [](const SortElement &element) { return element.idSortKey; });
+	nctl::radixSort(first, last, sortScratch_.data(), [](const SortElement &element) { return element.materialSortKey; });
+
+	for (unsigned int i = 0; i < size; i++)
+		queue[i] = sortElements_[i].command;
+}
+
 }
@@ -26,7 +26,10 @@ nctl::UniquePtr<RenderCommandPool> RenderResources::renderCommandPool_;
 nctl::UniquePtr<RenderBatcher> RenderResources::renderBatcher_;
 
 nctl::UniquePtr<GLShaderProgram> RenderResources::defaultShaderPrograms_[NumDefaultShaderPrograms];
+nctl::UniquePtr<GLShaderProgram> RenderResources::textureBufferShaderPrograms_[NumTextureBufferShaderPrograms];
+nctl::UniquePtr<GLShaderProgram> RenderResources::compactShaderPrograms_[NumCompactShaderPrograms];
 nctl::HashMap<const GLShaderProgram *, GLShaderProgram *> RenderResources::batchedShaders_(32);
+nctl::HashMap<const GLShaderProgram *, GLShaderProgram *> RenderResources::compactBatchedShaders_(8);
 
 unsigned char RenderResources::cameraUniformsBuffer_[UniformsBufferSize];
 nctl::HashMap<GLShaderProgram *, RenderResources::CameraUniformData> RenderResources::cameraUniformDataMap_(32);
@@ -78,6 +81,31 @@ bool RenderResources::unregisterBatchedShader(const GLShaderProgram *shader)
 	return removed;
 }
 
+GLShaderProgram *RenderResources::compactBatchedShader(const GLShaderProgram *batchedShader)
+{
+	GLShaderProgram *compactShader = nullptr;
+
+	GLShaderProgram **findResult = compactBatchedShaders_.find(batchedShader);
+	if (findResult != nullptr)
+		compactShader = *findResult;
+
+	return compactShader;
+}
+
+bool RenderResources::isTextureBufferShader(const GLShaderProgram *batchedShader)
+{
+	if (batchedShader == nullptr)
+		return false;
+
+	for (const nctl::UniquePtr<GLShaderProgram> &shaderProgram : textureBufferShaderPrograms_)
+	{
+		if (shaderProgram.get() == batchedShader)
+			return true;
+	}
+
+	return false;
+}
+
 RenderResources::CameraUniformData *RenderResources::findCameraUniformData(GLShaderProgram *shaderProgram)
 {
 	return cameraUniformDataMap_.find(shaderProgram);
@@ -110,6 +138,7 @@ void RenderResources::setDefaultAttributesParameters(GLShaderProgram &shaderProg
 		GLVertexFormat::Attribute *positionAttribute = shaderProgram.attribute(Material::PositionAttributeName);
 		GLVertexFormat::Attribute *texCoordsAttribute = shaderProgram.attribute(Material::TexCoordsAttributeName);
 		GLVertexFormat::Attribute *meshIndexAttribute = shaderProgram.attribute(Material::MeshIndexAttributeName);
+		GLVertexFormat::Attribute *colorAttribute = shaderProgram.attribute(Material::ColorAttributeName);
 
 		// The stride check avoid overwriting VBO parameters for custom mesh shaders attributes
 		if (positionAttribute != nullptr && texCoordsAttribute != nullptr && meshIndexAttribute != nullptr)
@@ -131,6 +160,21 @@ void RenderResources::setDefaultAttributesParameters(GLShaderProgram &shaderProg
 			if (meshIndexAttribute->stride() == 0)
 				meshIndexAttribute->setVboParameters(sizeof(VertexFormatPos2Index), reinterpret_cast<void *>(offsetof(VertexFormatPos2Index, drawindex)));
 		}
+		else if (positionAttribute != nullptr && texCoordsAttribute != nullptr && colorAttribute != nullptr && meshIndexAttribute == nullptr)
+		{
+			if (positionAttribute->stride() == 0)
+				positionAttribute->setVboParameters(sizeof(VertexFormatPos2Tex2Color), reinterpret_cast<void *>(offsetof(VertexFormatPos2Tex2Color, position)));
+
+			if (texCoordsAttribute->stride() == 0)
+				texCoordsAttribute->setVboParameters(sizeof(VertexFormatPos2Tex2Color), reinterpret_cast<void *>(offsetof(VertexFormatPos2Tex2Color, texcoords)));
+
+			if (colorAttribute->stride() == 0)
+			{
+				colorAttribute->setVboParameters(sizeof(VertexFormatPos2Tex2Color), reinterpret_cast<void *>(offsetof(VertexFormatPos2Tex2Color, color)));
+				colorAttribute->setType(GL_UNSIGNED_BYTE);
+				colorAttribute->setNormalized(true);
+			}
+		}
 		else if (positionAttribute != nullptr && texCoordsAttribute != nullptr && meshIndexAttribute == nullptr)
 		{
 			if (positionAttribute->stride() == 0)
@@ -162,6 +206,26 @@ namespace {
 		const char *objectLabel;
 	};
 
+	void loadShaders(const ShaderLoad *shadersToLoad, unsigned int numShadersToLoad, GLShaderProgram::QueryPhase queryPhase)
+	{
+		for (unsigned int i = 0; i < numShadersToLoad; i++)
+		{
+			const ShaderLoad &shaderToLoad = shadersToLoad[i];
+
+			shaderToLoad.shaderProgram = nctl::makeUnique<GLShaderProgram>(queryPhase);
+#ifndef WITH_EMBEDDED_SHADERS
+			shaderToLoad.shaderProgram->attachShader(GL_VERTEX_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.vertexShader).data());
+			shaderToLoad.shaderProgram->attachShader(GL_FRAGMENT_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.fragmentShader).data());
+#else
+			shaderToLoad.shaderProgram->attachShaderFromString(GL_VERTEX_SHADER, shaderToLoad.vertexShader);
+			shaderToLoad.shaderProgram->attachShaderFromString(GL_FRAGMENT_SHADER, shaderToLoad.fragmentShader);
+#endif
+			shaderToLoad.shaderProgram->setObjectLabel(shaderToLoad.objectLabel);
+			const bool hasLinked = shaderToLoad.shaderProgram->link(shaderToLoad.introspection);
+			FATAL_ASSERT(hasLinked == true);
+		}
+	}
+
 }
 
 void RenderResources::setCurrentCamera(Camera *camera)
@@ -208,7 +272,8 @@ void RenderResources::create()
 	LOGI("Creating rendering resources...");
 
 	const AppConfiguration &appCfg = theApplication().appConfiguration();
-	buffersManager_ = nctl::makeUnique<RenderBuffersManager>(appCfg.useBufferMapping, appCfg.vboSize, appCfg.iboSize);
+	const unsigned long tboSize = appCfg.useTextureBufferBatching ? appCfg.tboSize : 0;
+	buffersManager_ = nctl::makeUnique<RenderBuffersManager>(appCfg.useBufferMapping, appCfg.usePersistentMapping, appCfg.vboSize, appCfg.iboSize, tboSize);
 	vaoPool_ = nctl::makeUnique<RenderVaoPool>(appCfg.vaoPoolSize);
 	renderCommandPool_ = nctl::makeUnique<RenderCommandPool>(appCfg.vaoPoolSize);
 	renderBatcher_ = nctl::makeUnique<RenderBatcher>();
@@ -226,6 +291,7 @@ void RenderResources::create()
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_ALPHA)], "textnode_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::ENABLED, "TextNode_Alpha" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_RED)], "textnode_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::ENABLED, "TextNode_Red" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_SPRITE)], "textnode_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED, "TextNode_Sprite" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_DISTANCE_FIELD)], "textnode_vs.glsl", "textnode_distance_field_fs.glsl", GLShaderProgram::Introspection::ENABLED, "TextNode_DistanceField" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES)], "batched_sprites_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_GRAY)], "batched_sprites_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Gray" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_NO_TEXTURE)], "batched_sprites_notexture_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_NoTexture" },
@@ -234,7 +300,10 @@ void RenderResources::create()
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_MESH_SPRITES_NO_TEXTURE)], "batched_meshsprites_notexture_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_MeshSprites_NoTexture" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA)], "batched_textnodes_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Alpha" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_RED)], "batched_textnodes_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Red" },
-		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)], "batched_textnodes_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite" }
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)], "batched_textnodes_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_DISTANCE_FIELD)], "batched_textnodes_vs.glsl", "textnode_distance_field_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_DistanceField" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::PARTICLES)], "particles_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Particles" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::PARTICLES_GRAY)], "particles_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Particles_Gray" }
 #else
 		// Skipping the initial new line character of the raw string literal
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::SPRITE)], ShaderStrings::sprite_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "Sprite" },
@@ -246,6 +315,7 @@ void RenderResources::create()
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_ALPHA)], ShaderStrings::textnode_vs + 1, ShaderStrings::textnode_alpha_fs + 1, GLShaderProgram::Introspection::ENABLED, "TextNode_Alpha" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_RED)], ShaderStrings::textnode_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::ENABLED, "TextNode_Red" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_SPRITE)], ShaderStrings::textnode_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "TextNode_Sprite" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_DISTANCE_FIELD)], ShaderStrings::textnode_vs + 1, ShaderStrings::textnode_distance_field_fs + 1, GLShaderProgram::Introspection::ENABLED, "TextNode_DistanceField" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES)], ShaderStrings::batched_sprites_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_GRAY)], ShaderStrings::batched_sprites_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Gray" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_NO_TEXTURE)], ShaderStrings::batched_sprites_notexture_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_NoTexture" },
@@ -254,29 +324,71 @@ void RenderResources::create()
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_MESH_SPRITES_NO_TEXTURE)], ShaderStrings::batched_meshsprites_notexture_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_MeshSprites_NoTexture" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_alpha_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Alpha" },
 		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_RED)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Red" },
-		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite" }
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_DISTANCE_FIELD)], ShaderStrings::batched_textnodes_vs + 1, ShaderStrings::textnode_distance_field_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_DistanceField" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::PARTICLES)], ShaderStrings::particles_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "Particles" },
+		{ RenderResources::defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::PARTICLES_GRAY)], ShaderStrings::particles_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::ENABLED, "Particles_Gray" }
 #endif
 	};
 
 	const GLShaderProgram::QueryPhase queryPhase = appCfg.deferShaderQueries ? GLShaderProgram::QueryPhase::DEFERRED : GLShaderProgram::QueryPhase::IMMEDIATE;
 	const unsigned int numShaderToLoad = (sizeof(shadersToLoad) / sizeof(*shadersToLoad));
 	FATAL_ASSERT(numShaderToLoad <= NumDefaultShaderPrograms);
-	for (unsigned int i = 0; i < numShaderToLoad; i++)
-	{
-		const ShaderLoad &shaderToLoad = shadersToLoad[i];
+	loadShaders(shadersToLoad, numShaderToLoad, queryPhase);
+
+	ShaderLoad compactShadersToLoad[] = {
+#ifndef WITH_EMBEDDED_SHADERS
+		{ RenderResources::compactShaderPrograms_[0], "batched_sprites_compact_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Compact" },
+		{ RenderResources::compactShaderPrograms_[1], "batched_sprites_compact_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Gray_Compact" },
+		{ RenderResources::compactShaderPrograms_[2], "batched_sprites_notexture_compact_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_NoTexture_Compact" },
+		{ RenderResources::compactShaderPrograms_[3], "batched_sprites_compact_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Alpha_Compact" },
+		{ RenderResources::compactShaderPrograms_[4], "batched_sprites_compact_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Red_Compact" },
+		{ RenderResources::compactShaderPrograms_[5], "batched_sprites_compact_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite_Compact" },
+		{ RenderResources::compactShaderPrograms_[6], "batched_sprites_compact_vs.glsl", "textnode_distance_field_fs.glsl", GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_DistanceField_Compact" }
+#else
+		{ RenderResources::compactShaderPrograms_[0], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Compact" },
+		{ RenderResources::compactShaderPrograms_[1], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_Gray_Compact" },
+		{ RenderResources::compactShaderPrograms_[2], ShaderStrings::batched_sprites_notexture_compact_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_Sprites_NoTexture_Compact" },
+		{ RenderResources::compactShaderPrograms_[3], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::textnode_alpha_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Alpha_Compact" },
+		{ RenderResources::compactShaderPrograms_[4], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Red_Compact" },
+		{ RenderResources::compactShaderPrograms_[5], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_Sprite_Compact" },
+		{ RenderResources::compactShaderPrograms_[6], ShaderStrings::batched_sprites_compact_vs + 1, ShaderStrings::textnode_distance_field_fs + 1, GLShaderProgram::Introspection::NO_UNIFORMS_IN_BLOCKS, "Batched_TextNodes_DistanceField_Compact" }
+#endif
+	};
+	loadShaders(compactShadersToLoad, NumCompactShaderPrograms, queryPhase);
 
-		shaderToLoad.shaderProgram = nctl::makeUnique<GLShaderProgram>(queryPhase);
+	if (buffersManager_->isAvailable(RenderBuffersManager::BufferTypes::TEXTURE))
+	{
+		LOGI("Batching instance data in texture buffers");
+		ShaderLoad textureBufferShadersToLoad[] = {
 #ifndef WITH_EMBEDDED_SHADERS
-		shaderToLoad.shaderProgram->attachShader(GL_VERTEX_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.vertexShader).data());
-		shaderToLoad.shaderProgram->attachShader(GL_FRAGMENT_SHADER, (fs::dataPath() + "shaders/" + shaderToLoad.fragmentShader).data());
+			{ RenderResources::textureBufferShaderPrograms_[0], "batched_sprites_tbo_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[1], "batched_sprites_tbo_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_Gray_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[2], "batched_sprites_notexture_tbo_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_NoTexture_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[3], "batched_meshsprites_tbo_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[4], "batched_meshsprites_tbo_vs.glsl", "sprite_gray_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_Gray_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[5], "batched_meshsprites_notexture_tbo_vs.glsl", "sprite_notexture_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_NoTexture_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[6], "batched_textnodes_tbo_vs.glsl", "textnode_alpha_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Alpha_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[7], "batched_textnodes_tbo_vs.glsl", "textnode_red_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Red_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[8], "batched_textnodes_tbo_vs.glsl", "sprite_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Sprite_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[9], "batched_textnodes_tbo_vs.glsl", "textnode_distance_field_fs.glsl", GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_DistanceField_TBO" }
 #else
-		shaderToLoad.shaderProgram->attachShaderFromString(GL_VERTEX_SHADER, shaderToLoad.vertexShader);
-		shaderToLoad.shaderProgram->attachShaderFromString(GL_FRAGMENT_SHADER, shaderToLoad.fragmentShader);
+			{ RenderResources::textureBufferShaderPrograms_[0], ShaderStrings::batched_sprites_tbo_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[1], ShaderStrings::batched_sprites_tbo_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_Gray_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[2], ShaderStrings::batched_sprites_notexture_tbo_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_Sprites_NoTexture_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[3], ShaderStrings::batched_meshsprites_tbo_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[4], ShaderStrings::batched_meshsprites_tbo_vs + 1, ShaderStrings::sprite_gray_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_Gray_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[5], ShaderStrings::batched_meshsprites_notexture_tbo_vs + 1, ShaderStrings::sprite_notexture_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_MeshSprites_NoTexture_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[6], ShaderStrings::batched_textnodes_tbo_vs + 1, ShaderStrings::textnode_alpha_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Alpha_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[7], ShaderStrings::batched_textnodes_tbo_vs + 1, ShaderStrings::textnode_red_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Red_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[8], ShaderStrings::batched_textnodes_tbo_vs + 1, ShaderStrings::sprite_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_Sprite_TBO" },
+			{ RenderResources::textureBufferShaderPrograms_[9], ShaderStrings::batched_textnodes_tbo_vs + 1, ShaderStrings::textnode_distance_field_fs + 1, GLShaderProgram::Introspection::ENABLED, "Batched_TextNodes_DistanceField_TBO" }
 #endif
-		shaderToLoad.shaderProgram->setObjectLabel(shaderToLoad.objectLabel);
-		const bool hasLinked = shaderToLoad.shaderProgram->link(shaderToLoad.introspection);
-		FATAL_ASSERT(hasLinked == true);
+		};
+		loadShaders(textureBufferShadersToLoad, NumTextureBufferShaderPrograms, queryPhase);
 	}
+	else if (appCfg.useTextureBufferBatching)
+		LOGW("Texture buffers are not supported, batching instance data in uniform buffers");
 
 	registerDefaultBatchedShaders();
 
@@ -293,7 +405,7 @@ void RenderResources::createMinimal()
 	LOGI("Creating a minimal set of rendering resources...");
 
 	const AppConfiguration &appCfg = theApplication().appConfiguration();
-	buffersManager_ = nctl::makeUnique<RenderBuffersManager>(appCfg.useBufferMapping, appCfg.vboSize, appCfg.iboSize);
+	buffersManager_ = nctl::makeUnique<RenderBuffersManager>(appCfg.useBufferMapping, appCfg.usePersistentMapping, appCfg.vboSize, appCfg.iboSize, 0);
 	vaoPool_ = nctl::makeUnique<RenderVaoPool>(appCfg.vaoPoolSize);
 
 	LOGI("Minimal rendering resources created");
@@ -303,6 +415,10 @@ void RenderResources::dispose()
 {
 	for (nctl::UniquePtr<GLShaderProgram> &shaderProgram : defaultShaderPrograms_)
 		shaderProgram.reset(nullptr);
+	for (nctl::UniquePtr<GLShaderProgram> &shaderProgram : textureBufferShaderPrograms_)
+		shaderProgram.reset(nullptr);
+	for (nctl::UniquePtr<GLShaderProgram> &shaderProgram : compactShaderPrograms_)
+		shaderProgram.reset(nullptr);
 
 	ASSERT(cameraUniformDataMap_.isEmpty());
 
@@ -317,15 +433,27 @@ void RenderResources::dispose()
 
 void RenderResources::registerDefaultBatchedShaders()
 {
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::SPRITE)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::SPRITE_GRAY)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_GRAY)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::SPRITE_NO_TEXTURE)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_NO_TEXTURE)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::MESH_SPRITE)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_MESH_SPRITES)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::MESH_SPRITE_GRAY)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_MESH_SPRITES_GRAY)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::MESH_SPRITE_NO_TEXTURE)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_MESH_SPRITES_NO_TEXTURE)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_ALPHA)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_RED)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_RED)].get());
-	batchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::TEXTNODE_SPRITE)].get(), defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)].get());
+	// The default batched shader programs are in the same order as the ones they batch
+	const bool withTextureBuffers = (textureBufferShaderPrograms_[0].get() != nullptr);
+	const unsigned int firstShader = static_cast<unsigned int>(Material::ShaderProgramType::SPRITE);
+	const unsigned int firstBatchedShader = static_cast<unsigned int>(Material::ShaderProgramType::BATCHED_SPRITES);
+	static_assert(firstBatchedShader - firstShader == NumTextureBufferShaderPrograms, "Every default shader program should have a batched one");
+
+	for (unsigned int i = 0; i < NumTextureBufferShaderPrograms; i++)
+	{
+		GLShaderProgram *batchedShader = withTextureBuffers ? textureBufferShaderPrograms_[i].get() : defaultShaderPrograms_[firstBatchedShader + i].get();
+		batchedShaders_.insert(defaultShaderPrograms_[firstShader + i].get(), batchedShader);
+	}
+
+	// The compact variants are only for the uniform block based batched shaders of sprites and text nodes
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES)].get(), compactShaderPrograms_[0].get());
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_GRAY)].get(), compactShaderPrograms_[1].get());
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_SPRITES_NO_TEXTURE)].get(), compactShaderPrograms_[2].get());
+	// Text nodes are encoded with one compact instance per glyph
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_ALPHA)].get(), compactShaderPrograms_[3].get());
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_RED)].get(), compactShaderPrograms_[4].get());
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_SPRITE)].get(), compactShaderPrograms_[5].get());
+	compactBatchedShaders_.insert(defaultShaderPrograms_[static_cast<int>(Material::ShaderProgramType::BATCHED_TEXTNODES_DISTANCE_FIELD)].get(), compactShaderPrograms_[6].get());
 }
 
 }
@@ -1,6 +1,11 @@
 ﻿#include "RenderStatistics.h"
 #include "tracy.h"
 
+#ifdef WITH_ALLOCATORS
+	#include <nctl/AllocManager.h>
+	#include <nctl/FrameAllocator.h>
+#endif
+
 namespace ncine {
 
 ///////////////////////////////////////////////////////////
@@ -18,6 +23,7 @@ unsigned int RenderStatistics::index_ = 0;
 unsigned int RenderStatistics::culledNodes_[2] = { 0, 0 };
 RenderStatistics::VaoPool RenderStatistics::vaoPool_;
 RenderStatistics::CommandPool RenderStatistics::commandPool_;
+RenderStatistics::FrameArena RenderStatistics::frameArena_;
 
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
@@ -77,6 +83,26 @@ void RenderStatistics::gatherStatistics(const RenderBuffersManager::ManagedBuffe
 	typedBuffers_[typeIndex].count++;
 	typedBuffers_[typeIndex].size += buffer.size;
 	typedBuffers_[typeIndex].usedSpace += buffer.size - buffer.freeSpace;
+	typedBuffers_[typeIndex].ringSections = buffer.numSections;
+	typedBuffers_[typeIndex].ringSize += buffer.size * buffer.numSections;
+}
+
+void RenderStatistics::gatherStatistics(RenderBuffersManager::BufferTypes::Enum type, unsigned int fenceWaits, float fenceWaitTime)
+{
+	typedBuffers_[type].fenceWaits = fenceWaits;
+	typedBuffers_[type].fenceWaitTime = fenceWaitTime;
+}
+
+void RenderStatistics::gatherFrameArenaStatistics()
+{
+#ifdef WITH_ALLOCATORS
+	const nctl::FrameAllocator &frameAllocator = nctl::theFrameAllocator();
+	frameArena_.capacity = frameAllocator.frameCapacity();
+	frameArena_.usedMemory = frameAllocator.lastFrameUsedMemory();
+	frameArena_.highWaterMark = frameAllocator.highWaterMark();
+	frameArena_.overflows = frameAllocator.lastFrameNumOverflows();
+	TracyPlot("Frame Arena", static_cast<int64_t>(frameArena_.usedMemory));
+#endif
 }
 
 }
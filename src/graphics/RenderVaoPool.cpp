@@ -1,4 +1,5 @@
 #include <nctl/StaticString.h>
+#include <nctl/HashFunctions.h>
 #include "RenderVaoPool.h"
 #include "GLVertexArrayObject.h"
 #include "RenderStatistics.h"
@@ -9,6 +10,47 @@ namespace ncine {
 namespace {
 	/// The string used to output OpenGL debug group information
 	static nctl::StaticString<128> debugString;
+
+	/// The attribute values compared by `GLVertexFormat::Attribute::operator==()`
+	struct AttributeHashData
+	{
+		unsigned int attributeIndex;
+		GLuint vboHandle;
+		unsigned int index;
+		GLint size;
+		GLenum type;
+		GLsizei stride;
+		uint64_t pointer;
+		unsigned int baseOffset;
+		unsigned int normalized;
+	};
+
+	uint32_t vertexFormatHash(const GLVertexFormat &format)
+	{
+		static const uint64_t Seed = 1697381921;
+		// Disabled attributes are all equal to each other and do not contribute to the hash
+		uint64_t hash = Seed ^ (format.ibo() ? format.ibo()->glHandle() : 0);
+		for (unsigned int i = 0; i < format.numAttributes(); i++)
+		{
+			const GLVertexFormat::Attribute &attribute = format[i];
+			if (attribute.isEnabled() == false)
+				continue;
+
+			AttributeHashData hashData;
+			hashData.attributeIndex = i;
+			hashData.vboHandle = attribute.vbo() ? attribute.vbo()->glHandle() : 0;
+			hashData.index = attribute.index();
+			hashData.size = attribute.size();
+			hashData.type = attribute.type();
+			hashData.stride = attribute.stride();
+			hashData.pointer = reinterpret_cast<uintptr_t>(attribute.pointer());
+			hashData.baseOffset = attribute.baseOffset();
+			hashData.normalized = attribute.isNormalized() ? 1 : 0;
+			hash = nctl::fasthash64(&hashData, sizeof(AttributeHashData), hash);
+		}
+
+		return static_cast<uint32_t>(hash - (hash >> 32));
+	}
 }
 
 ///////////////////////////////////////////////////////////
@@ -16,7 +58,8 @@ namespace {
 ///////////////////////////////////////////////////////////
 
 RenderVaoPool::RenderVaoPool(unsigned int vaoPoolSize)
-    : vaoPool_(vaoPoolSize, nctl::ArrayMode::FIXED_CAPACITY)
+    : vaoPool_(vaoPoolSize, nctl::ArrayMode::FIXED_CAPACITY),
+      vaoIndices_(vaoPoolSize * 2), bindCounter_(0)
 {
 	// Start with a VAO bound to the OpenGL context
 	GLVertexFormat format;
@@ -29,34 +72,34 @@ RenderVaoPool::RenderVaoPool(unsigned int vaoPoolSize)
 
 void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 {
-	bool vaoFound = false;
-	for (VaoBinding &binding : vaoPool_)
+	const uint32_t formatHash = vertexFormatHash(vertexFormat);
+	bindCounter_++;
+
+	// The format is compared anyway as different formats might have the same hash
+	const unsigned int *vaoIndex = vaoIndices_.find(formatHash);
+	if (vaoIndex && vaoPool_[*vaoIndex].format == vertexFormat)
 	{
-		if (binding.format == vertexFormat)
+		VaoBinding &binding = vaoPool_[*vaoIndex];
+		const bool bindChanged = binding.object->bind();
+		const GLuint iboHandle = vertexFormat.ibo() ? vertexFormat.ibo()->glHandle() : 0;
+		if (bindChanged)
 		{
-			vaoFound = true;
-			const bool bindChanged = binding.object->bind();
-			const GLuint iboHandle = vertexFormat.ibo() ? vertexFormat.ibo()->glHandle() : 0;
-			if (bindChanged)
-			{
-				if (GLDebug::isAvailable())
-					insertGLDebugMessage(binding);
+			if (GLDebug::isAvailable())
+				insertGLDebugMessage(binding);
 
-				// Binding a VAO changes the current bound element array buffer
-				GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
-			}
-			else
-			{
-				// The VAO was already bound but it is not known if the bound element array buffer changed in the meantime
-				GLBufferObject::bindHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
-			}
-			binding.lastBindTime = TimeStamp::now();
-			RenderStatistics::addVaoPoolBinding();
-			break;
+			// Binding a VAO changes the current bound element array buffer
+			GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
 		}
+		else
+		{
+			// The VAO was already bound but it is not known if the bound element array buffer changed in the meantime
+			GLBufferObject::bindHandle(GL_ELEMENT_ARRAY_BUFFER, iboHandle);
+		}
+		binding.lastBind = bindCounter_;
+		RenderStatistics::addVaoPoolBinding();
+		RenderStatistics::addVaoPoolHit();
 	}
-
-	if (vaoFound == false)
+	else
 	{
 		unsigned int index = 0;
 		if (vaoPool_.size() < vaoPool_.capacity())
@@ -77,16 +120,21 @@ void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 		else
 		{
 			// Find the least recently used VAO
-			TimeStamp time = vaoPool_[0].lastBindTime;
+			unsigned long int lastBind = vaoPool_[0].lastBind;
 			for (unsigned int i = 1; i < vaoPool_.size(); i++)
 			{
-				if (vaoPool_[i].lastBindTime < time)
+				if (vaoPool_[i].lastBind < lastBind)
 				{
 					index = i;
-					time = vaoPool_[i].lastBindTime;
+					lastBind = vaoPool_[i].lastBind;
 				}
 			}
 
+			// The hash of the old format might have been remapped to another VAO
+			const unsigned int *oldIndex = vaoIndices_.find(vaoPool_[index].formatHash);
+			if (oldIndex && *oldIndex == index)
+				vaoIndices_.remove(vaoPool_[index].formatHash);
+
 			debugString.format("Reuse and define VAO 0x%lx (%u)", uintptr_t(vaoPool_[index].object.get()), index);
 			GLDebug::messageInsert(debugString.data());
 			RenderStatistics::addVaoPoolReuse();
@@ -99,8 +147,11 @@ void RenderVaoPool::bindVao(const GLVertexFormat &vertexFormat)
 		GLBufferObject::setBoundHandle(GL_ELEMENT_ARRAY_BUFFER, oldIboHandle);
 		vaoPool_[index].format = vertexFormat;
 		vaoPool_[index].format.define();
-		vaoPool_[index].lastBindTime = TimeStamp::now();
+		vaoPool_[index].formatHash = formatHash;
+		vaoPool_[index].lastBind = bindCounter_;
+		vaoIndices_[formatHash] = index;
 		RenderStatistics::addVaoPoolBinding();
+		RenderStatistics::addVaoPoolMiss();
 	}
 
 	RenderStatistics::gatherVaoPoolStatistics(vaoPool_.size(), vaoPool_.capacity());
@@ -1,4 +1,5 @@
 #include "SceneNode.h"
+#include "SpatialGrid.h"
 #include "Application.h"
 #include "tracy.h"
 
@@ -17,7 +18,9 @@ const float SceneNode::MinRotation = 0.5f;
 /*! \param parent The parent can be `nullptr` */
 SceneNode::SceneNode(SceneNode *parent, float x, float y)
     : Object(ObjectType::SCENENODE),
-      updateEnabled_(true), drawEnabled_(true), parent_(nullptr), children_(4),
+      updateEnabled_(true), drawEnabled_(true), isStatic_(false), staticUpdated_(false),
+      staticUpdateSkipped_(false), staticSpatialGridId_(0), spatialGridOrder_(0), staticSpatialGridEndOrder_(0),
+      parent_(nullptr), children_(4),
       childOrderIndex_(0), withVisitOrder_(true),
       visitOrderState_(VisitOrderState::SAME_AS_PARENT), visitOrderIndex_(0),
       position_(x, y), anchorPoint_(0.0f, 0.0f), scaleFactor_(1.0f, 1.0f), rotation_(0.0f),
@@ -65,7 +68,8 @@ SceneNode::~SceneNode()
 SceneNode::SceneNode(SceneNode &&other)
     : Object(nctl::move(other)),
       updateEnabled_(other.updateEnabled_), drawEnabled_(other.drawEnabled_),
-      parent_(other.parent_), children_(nctl::move(other.children_)),
+      isStatic_(other.isStatic_), staticUpdated_(false), staticUpdateSkipped_(false), staticSpatialGridId_(0),
+      spatialGridOrder_(0), staticSpatialGridEndOrder_(0), parent_(other.parent_), children_(nctl::move(other.children_)),
       visitOrderState_(other.visitOrderState_),
       position_(other.position_), anchorPoint_(other.anchorPoint_),
       scaleFactor_(other.scaleFactor_), rotation_(other.rotation_), color_(other.color_),
@@ -83,6 +87,12 @@ SceneNode &SceneNode::operator=(SceneNode &&other)
 
 	updateEnabled_ = other.updateEnabled_;
 	drawEnabled_ = other.drawEnabled_;
+	isStatic_ = other.isStatic_;
+	staticUpdated_ = false;
+	staticUpdateSkipped_ = false;
+	staticSpatialGridId_ = 0;
+	spatialGridOrder_ = 0;
+	staticSpatialGridEndOrder_ = 0;
 	parent_ = other.parent_;
 	children_ = nctl::move(other.children_);
 	visitOrderState_ = other.visitOrderState_;
@@ -181,6 +191,8 @@ bool SceneNode::removeChildNodeAt(unsigned int index)
 		return false;
 
 	children_[index]->parent_ = nullptr;
+	// A detached subtree should not be found by the culling of a viewport anymore
+	SpatialGrid::removeSubtree(children_[index]);
 	dirtyBits_.set(DirtyBitPositions::TransformationBit);
 	dirtyBits_.set(DirtyBitPositions::AabbBit);
 	// Fast removal without preserving the order
@@ -200,6 +212,7 @@ bool SceneNode::removeAllChildrenNodes()
 	for (unsigned int i = 0; i < children_.size(); i++)
 	{
 		children_[i]->parent_ = nullptr;
+		SpatialGrid::removeSubtree(children_[i]);
 		dirtyBits_.set(DirtyBitPositions::TransformationBit);
 		dirtyBits_.set(DirtyBitPositions::AabbBit);
 	}
@@ -279,12 +292,40 @@ bool SceneNode::swapNodeBack()
 	return parent_->swapChildrenNodes(childOrderIndex_, childOrderIndex_ - 1);
 }
 
+void SceneNode::setDrawEnabled(bool drawEnabled)
+{
+	if (drawEnabled_ != drawEnabled)
+	{
+		// A viewport visiting the nodes collected from a spatial grid does not check if their ancestors are enabled
+		if (drawEnabled == false)
+			SpatialGrid::removeSubtree(this);
+		// The nodes of a static ancestor have to be traversed again to be stored in the grid
+		for (SceneNode *ancestor = parent_; ancestor != nullptr; ancestor = ancestor->parent_)
+			ancestor->staticSpatialGridId_ = 0;
+	}
+	drawEnabled_ = drawEnabled;
+}
+
+void SceneNode::setStatic(bool isStatic)
+{
+	isStatic_ = isStatic;
+	staticUpdated_ = false;
+	staticSpatialGridId_ = 0;
+}
+
 void SceneNode::update(float interval)
 {
 	// Early return not needed, the first call to this method is on the root node
 
 	if (updateEnabled_)
 	{
+		staticUpdateSkipped_ = (isStatic_ && canSkipStaticUpdate());
+		if (staticUpdateSkipped_)
+		{
+			lastFrameUpdated_ = theApplication().numFrames();
+			return;
+		}
+
 		transform();
 		for (SceneNode *child : children_)
 			child->update(interval);
@@ -296,6 +337,7 @@ void SceneNode::update(float interval)
 			dirtyBits_.reset(DirtyBitPositions::ColorBit);
 		}
 
+		staticUpdated_ = isStatic_;
 		lastFrameUpdated_ = theApplication().numFrames();
 	}
 }
@@ -306,17 +348,7 @@ void SceneNode::visit(RenderQueue &renderQueue, unsigned int &visitOrderIndex)
 
 	if (drawEnabled_)
 	{
-		// Increment the index without knowing if the node is going to be rendered or not.
-		// It avoids both a one frame delay when the value changes and calling `DrawableNode::setVisitOrder()` from this function.
-		visitOrderIndex_ = (type_ != ObjectType::PARTICLE) ? visitOrderIndex + 1 : visitOrderIndex;
-		const bool rendered = draw(renderQueue);
-
-		visitOrderIndex_ = visitOrderIndex;
-		// Visit order index only incremented for rendered nodes
-		// Particles get their index incremented only once by their parent particle system
-		const bool incrementIndex = (rendered && type_ != ObjectType::PARTICLE) || type_ == ObjectType::PARTICLE_SYSTEM;
-		visitOrderIndex_ = incrementIndex ? visitOrderIndex++ : visitOrderIndex;
-
+		visitNode(renderQueue, visitOrderIndex);
 		for (SceneNode *child : children_)
 			child->visit(renderQueue, visitOrderIndex);
 	}
@@ -327,8 +359,9 @@ void SceneNode::visit(RenderQueue &renderQueue, unsigned int &visitOrderIndex)
 ///////////////////////////////////////////////////////////
 
 SceneNode::SceneNode(const SceneNode &other)
-    : Object(other), updateEnabled_(other.updateEnabled_),
-      drawEnabled_(other.drawEnabled_), parent_(nullptr), children_(4), childOrderIndex_(0),
+    : Object(other), updateEnabled_(other.updateEnabled_), drawEnabled_(other.drawEnabled_),
+      isStatic_(other.isStatic_), staticUpdated_(false), staticUpdateSkipped_(false), staticSpatialGridId_(0),
+      spatialGridOrder_(0), staticSpatialGridEndOrder_(0), parent_(nullptr), children_(4), childOrderIndex_(0),
       withVisitOrder_(true), visitOrderState_(other.visitOrderState_), visitOrderIndex_(0),
       position_(other.position_), anchorPoint_(other.anchorPoint_),
       scaleFactor_(other.scaleFactor_), rotation_(other.rotation_), color_(other.color_),
@@ -360,6 +393,29 @@ void SceneNode::swapChildPointer(SceneNode *first, SceneNode *second)
 	}
 }
 
+void SceneNode::visitNode(RenderQueue &renderQueue, unsigned int &visitOrderIndex)
+{
+	// Increment the index without knowing if the node is going to be rendered or not.
+	// It avoids both a one frame delay when the value changes and calling `DrawableNode::setVisitOrder()` from this function.
+	visitOrderIndex_ = (type_ != ObjectType::PARTICLE) ? visitOrderIndex + 1 : visitOrderIndex;
+	const bool rendered = draw(renderQueue);
+
+	visitOrderIndex_ = visitOrderIndex;
+	// Visit order index only incremented for rendered nodes
+	// Particles get their index incremented only once by their parent particle system
+	const bool incrementIndex = (rendered && type_ != ObjectType::PARTICLE) || type_ == ObjectType::PARTICLE_SYSTEM;
+	visitOrderIndex_ = incrementIndex ? visitOrderIndex++ : visitOrderIndex;
+}
+
+bool SceneNode::canSkipStaticUpdate() const
+{
+	const bool isDirty = dirtyBits_.test(DirtyBitPositions::TransformationBit) || dirtyBits_.test(DirtyBitPositions::ColorBit);
+	const bool parentIsDirty = parent_ && (parent_->dirtyBits_.test(DirtyBitPositions::TransformationBit) ||
+	                                       parent_->dirtyBits_.test(DirtyBitPositions::ColorBit));
+
+	return (staticUpdated_ && isDirty == false && parentIsDirty == false);
+}
+
 void SceneNode::transform()
 {
 	ZoneScoped;
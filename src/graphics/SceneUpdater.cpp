@@ -0,0 +1,116 @@
+#include <nctl/algorithms.h>
+#include "SceneUpdater.h"
+#include "SceneNode.h"
+#include "IThreadPool.h"
+#include "Application.h"
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+SceneUpdater::SceneUpdater(IThreadPool &threadPool, unsigned int maxDepth, unsigned int minNodesPerJob)
+    : threadPool_(threadPool), maxDepth_(maxDepth), minNodesPerJob_(nctl::max(minNodesPerJob, 1U)),
+      batchNodes_(0), interval_(0.0f)
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SceneUpdater::update(SceneNode &rootNode, float interval)
+{
+	if (threadPool_.numThreads() == 0 || maxDepth_ == 0 || rootNode.type_ != Object::ObjectType::SCENENODE ||
+	    rootNode.updateEnabled_ == false || rootNode.isStatic_)
+	{
+		rootNode.update(interval);
+		return;
+	}
+
+	ZoneScoped;
+	splitNodes_.clear();
+	jobRoots_.clear();
+	batches_.clear();
+	batchNodes_ = 0;
+	collect(&rootNode, 0);
+
+	// Every batch already contains enough nodes to be worth a job on its own
+	interval_ = interval;
+	threadPool_.parallelFor(batches_.size(), 1, updateBatches, this);
+
+	// Flags of split nodes are reset only after all of their children have been transformed
+	const unsigned long int numFrames = theApplication().numFrames();
+	for (SceneNode *node : splitNodes_)
+	{
+		node->dirtyBits_.reset(SceneNode::DirtyBitPositions::TransformationBit);
+		node->dirtyBits_.reset(SceneNode::DirtyBitPositions::ColorBit);
+		node->lastFrameUpdated_ = numFrames;
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SceneUpdater::collect(SceneNode *node, unsigned int depth)
+{
+	// Only plain scene nodes are split, as they have no overridden `update()` method to be honored.
+	// Static ones are not split either, their own `update()` method can skip the whole subtree.
+	node->transform();
+	splitNodes_.pushBack(node);
+
+	const unsigned int splitThreshold = minNodesPerJob_ * 2;
+	for (SceneNode *child : node->children_)
+	{
+		const bool canSplit = (depth + 1 < maxDepth_ && child->type_ == Object::ObjectType::SCENENODE &&
+		                       child->updateEnabled_ && child->isStatic_ == false);
+		if (canSplit && countNodes(child, splitThreshold) >= splitThreshold)
+			collect(child, depth + 1);
+		else
+			addJobRoot(child);
+	}
+}
+
+void SceneUpdater::addJobRoot(SceneNode *node)
+{
+	if (batches_.isEmpty() || batchNodes_ >= minNodesPerJob_)
+	{
+		batches_.pushBack(Batch{ jobRoots_.size(), 0 });
+		batchNodes_ = 0;
+	}
+
+	jobRoots_.pushBack(node);
+	batches_.back().count++;
+	batchNodes_ += countNodes(node, minNodesPerJob_ - batchNodes_);
+}
+
+void SceneUpdater::updateBatches(unsigned int first, unsigned int count, const void *data)
+{
+	ZoneScoped;
+	const SceneUpdater *sceneUpdater = static_cast<const SceneUpdater *>(data);
+
+	for (unsigned int i = first; i < first + count; i++)
+	{
+		const Batch &batch = sceneUpdater->batches_[i];
+		for (unsigned int j = batch.first; j < batch.first + batch.count; j++)
+			sceneUpdater->jobRoots_[j]->update(sceneUpdater->interval_);
+	}
+}
+
+unsigned int SceneUpdater::countNodes(const SceneNode *node, unsigned int limit)
+{
+	unsigned int count = 1;
+	for (const SceneNode *child : node->children())
+	{
+		if (count >= limit)
+			break;
+		count += countNodes(child, limit - count);
+	}
+
+	return count;
+}
+
+}
@@ -116,6 +116,9 @@ void SdlGfxDevice::setWindowSize(int width, int height)
 void SdlGfxDevice::setWindowIcon(const char *windowIconFilename)
 {
 	nctl::UniquePtr<ITextureLoader> image = ITextureLoader::createFromFile(windowIconFilename);
+	if (image->hasLoaded() == false || image->readStreamedPixels() == false)
+		return;
+
 	const unsigned int bytesPerPixel = image->texFormat().numChannels();
 	const Uint32 pixelFormat = (bytesPerPixel == 4) ? SDL_PIXELFORMAT_ABGR8888 : SDL_PIXELFORMAT_BGR888;
 
@@ -474,6 +474,9 @@ bool Shader::loadDefaultShader(DefaultFragment fragment)
 		case DefaultFragment::TEXTNODE_SPRITE:
 			fragmentShader = "sprite_fs.glsl";
 			break;
+		case DefaultFragment::TEXTNODE_DISTANCE_FIELD:
+			fragmentShader = "textnode_distance_field_fs.glsl";
+			break;
 	}
 	const bool hasCompiled = glShaderProgram_->attachShader(GL_FRAGMENT_SHADER, (fs::dataPath() + "shaders/" + fragmentShader).data());
 #else
@@ -498,6 +501,9 @@ bool Shader::loadDefaultShader(DefaultFragment fragment)
 		case DefaultFragment::TEXTNODE_SPRITE:
 			fragmentShader = ShaderStrings::sprite_fs + 1;
 			break;
+		case DefaultFragment::TEXTNODE_DISTANCE_FIELD:
+			fragmentShader = ShaderStrings::textnode_distance_field_fs + 1;
+			break;
 	}
 	const bool hasCompiled = glShaderProgram_->attachShaderFromString(GL_FRAGMENT_SHADER, fragmentShader);
 #endif
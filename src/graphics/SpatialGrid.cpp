@@ -0,0 +1,224 @@
+#include <nctl/algorithms.h>
+#include "common_macros.h"
+#include "SpatialGrid.h"
+#include "DrawableNode.h"
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+	/// The initial number of buckets of the hashmap of cells
+	const unsigned int InitialHashMapCapacity = 64;
+
+	uint64_t cellKey(int x, int y)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+unsigned int SpatialGrid::nextId_ = 1;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : id_(nextId_++), cellSize_(cellSize), invCellSize_(1.0f / cellSize), minX_(0), minY_(0), maxX_(-1), maxY_(-1), numNodes_(0), cellIndices_(InitialHashMapCapacity)
+{
+	FATAL_ASSERT(cellSize > 0.0f);
+}
+
+SpatialGrid::~SpatialGrid()
+{
+	for (Cell &cell : cells_)
+	{
+		for (DrawableNode *node : cell.nodes)
+			node->spatialGrid_ = nullptr;
+	}
+	for (DrawableNode *node : oversizedNodes_)
+		node->spatialGrid_ = nullptr;
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void SpatialGrid::update(DrawableNode *node)
+{
+	ASSERT(node->spatialGrid_ == nullptr || node->spatialGrid_ == this);
+
+	const Rectf &aabb = node->aabb_;
+	const Vector2f center = aabb.center();
+	// Only the nodes that fit in a cell can be found by enlarging queries by half a cell
+	const bool oversized = (aabb.w > cellSize_ || aabb.h > cellSize_);
+	const unsigned int cellIndex = oversized ? OversizedCell
+	                                         : retrieveCell(static_cast<int>(floorf(center.x * invCellSize_)),
+	                                                        static_cast<int>(floorf(center.y * invCellSize_)));
+
+	if (node->spatialGrid_ == this)
+	{
+		if (node->spatialGridCell_ == cellIndex)
+			return;
+		removeFromCell(node);
+	}
+	else
+		numNodes_++;
+
+	nctl::Array<DrawableNode *> &nodes = cellNodes(cellIndex);
+	node->spatialGrid_ = this;
+	node->spatialGridCell_ = cellIndex;
+	node->spatialGridSlot_ = nodes.size();
+	nodes.pushBack(node);
+}
+
+void SpatialGrid::remove(DrawableNode *node)
+{
+	ASSERT(node->spatialGrid_ == this);
+
+	removeFromCell(node);
+	node->spatialGrid_ = nullptr;
+	numNodes_--;
+}
+
+void SpatialGrid::replace(DrawableNode *oldNode, DrawableNode *newNode)
+{
+	ASSERT(oldNode->spatialGrid_ == this);
+	ASSERT(newNode->spatialGrid_ == nullptr);
+
+	cellNodes(oldNode->spatialGridCell_)[oldNode->spatialGridSlot_] = newNode;
+	newNode->spatialGrid_ = this;
+	newNode->spatialGridCell_ = oldNode->spatialGridCell_;
+	newNode->spatialGridSlot_ = oldNode->spatialGridSlot_;
+	oldNode->spatialGrid_ = nullptr;
+}
+
+void SpatialGrid::removeSubtree(SceneNode *node)
+{
+	// The subtree will have to be traversed again to be stored in a grid
+	node->staticSpatialGridId_ = 0;
+
+	if (node->type() != Object::ObjectType::SCENENODE &&
+	    node->type() != Object::ObjectType::PARTICLE_SYSTEM)
+	{
+		DrawableNode *drawable = static_cast<DrawableNode *>(node);
+		if (drawable->spatialGrid_)
+			drawable->spatialGrid_->remove(drawable);
+	}
+
+	for (SceneNode *child : node->children_)
+		removeSubtree(child);
+}
+
+void SpatialGrid::collectOverlapping(const Rectf &rect, unsigned long int frame, nctl::Array<SceneNode *> &nodes)
+{
+	if (numNodes_ == 0)
+		return;
+
+	ZoneScoped;
+	collectNodes(oversizedNodes_, rect, frame, nodes);
+
+	// The center of a node that fits in a cell is at most half a cell away from the rectangle
+	const float halfCellSize = cellSize_ * 0.5f;
+	// Clamping in floating point before converting to avoid overflows with very far away rectangles
+	const float firstX = nctl::clamp(floorf((rect.x - halfCellSize) * invCellSize_), float(minX_), float(maxX_ + 1));
+	const float firstY = nctl::clamp(floorf((rect.y - halfCellSize) * invCellSize_), float(minY_), float(maxY_ + 1));
+	const float lastX = nctl::clamp(floorf((rect.x + rect.w + halfCellSize) * invCellSize_), float(minX_ - 1), float(maxX_));
+	const float lastY = nctl::clamp(floorf((rect.y + rect.h + halfCellSize) * invCellSize_), float(minY_ - 1), float(maxY_));
+	if (firstX > lastX || firstY > lastY)
+		return;
+
+	const int x0 = static_cast<int>(firstX);
+	const int y0 = static_cast<int>(firstY);
+	const int x1 = static_cast<int>(lastX);
+	const int y1 = static_cast<int>(lastY);
+
+	// Visiting every created cell is faster than looking up the range when the rectangle covers most of the grid
+	const uint64_t numRangeCells = static_cast<uint64_t>(x1 - x0 + 1) * static_cast<uint64_t>(y1 - y0 + 1);
+	if (numRangeCells >= cells_.size())
+	{
+		for (const Cell &cell : cells_)
+		{
+			if (cell.x >= x0 && cell.x <= x1 && cell.y >= y0 && cell.y <= y1)
+				collectNodes(cell.nodes, rect, frame, nodes);
+		}
+	}
+	else
+	{
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				const unsigned int *cellIndex = cellIndices_.find(cellKey(x, y));
+				if (cellIndex)
+					collectNodes(cells_[*cellIndex].nodes, rect, frame, nodes);
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int SpatialGrid::retrieveCell(int x, int y)
+{
+	const uint64_t key = cellKey(x, y);
+	const unsigned int *cellIndex = cellIndices_.find(key);
+	if (cellIndex)
+		return *cellIndex;
+
+	if (cells_.isEmpty())
+	{
+		minX_ = x;
+		minY_ = y;
+		maxX_ = x;
+		maxY_ = y;
+	}
+	else
+	{
+		minX_ = nctl::min(minX_, x);
+		minY_ = nctl::min(minY_, y);
+		maxX_ = nctl::max(maxX_, x);
+		maxY_ = nctl::max(maxY_, y);
+	}
+
+	const unsigned int newIndex = cells_.size();
+	cells_.emplaceBack(x, y);
+	if (cellIndices_.loadFactor() >= 0.8f)
+		cellIndices_.rehash(cellIndices_.capacity() * 2);
+	cellIndices_.insert(key, newIndex);
+
+	return newIndex;
+}
+
+void SpatialGrid::removeFromCell(DrawableNode *node)
+{
+	nctl::Array<DrawableNode *> &nodes = cellNodes(node->spatialGridCell_);
+	DrawableNode *lastNode = nodes.back();
+	nodes[node->spatialGridSlot_] = lastNode;
+	lastNode->spatialGridSlot_ = node->spatialGridSlot_;
+	nodes.popBack();
+}
+
+nctl::Array<DrawableNode *> &SpatialGrid::cellNodes(unsigned int cellIndex)
+{
+	return (cellIndex == OversizedCell) ? oversizedNodes_ : cells_[cellIndex].nodes;
+}
+
+void SpatialGrid::collectNodes(const nctl::Array<DrawableNode *> &cellNodes, const Rectf &rect, unsigned long int frame, nctl::Array<SceneNode *> &nodes)
+{
+	for (DrawableNode *node : cellNodes)
+	{
+		if (node->aabb_.overlaps(rect))
+		{
+			node->lastFrameRendered_ = frame;
+			nodes.pushBack(node);
+		}
+	}
+}
+
+}
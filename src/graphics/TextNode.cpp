@@ -2,10 +2,34 @@
 #include "FontGlyph.h"
 #include "Texture.h"
 #include "RenderCommand.h"
+#include <nctl/CString.h>
 #include "tracy.h"
 
 namespace ncine {
 
+namespace {
+
+	/// Returns the number of vertices in the triangle strip for the specified number of glyphs
+	/*! Every glyph quad has four vertices, adjacent quads are joined by two degenerate ones. */
+	inline unsigned int numGlyphVertices(unsigned int numGlyphs)
+	{
+		return (numGlyphs > 1) ? numGlyphs * 6 - 2 : numGlyphs * 4;
+	}
+
+	/// Returns the index of the first vertex of a glyph in the triangle strip
+	inline unsigned int firstGlyphVertex(unsigned int glyphIndex)
+	{
+		return (glyphIndex > 0) ? glyphIndex * 6 - 1 : 0;
+	}
+
+	/// Returns true if the byte is a UTF-8 continuation byte, one that does not start a codepoint
+	inline bool isUtf8Continuation(char byte)
+	{
+		return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+	}
+
+}
+
 Material::ShaderProgramType fontRenderModeToShaderProgram(const Font::RenderMode renderMode)
 {
 	switch (renderMode)
@@ -16,6 +40,8 @@ Material::ShaderProgramType fontRenderModeToShaderProgram(const Font::RenderMode
 			return Material::ShaderProgramType::TEXTNODE_RED;
 		case Font::RenderMode::GLYPH_SPRITE:
 			return Material::ShaderProgramType::TEXTNODE_SPRITE;
+		case Font::RenderMode::GLYPH_DISTANCE_FIELD:
+			return Material::ShaderProgramType::TEXTNODE_DISTANCE_FIELD;
 	}
 }
 
@@ -42,7 +68,8 @@ TextNode::TextNode(SceneNode *parent, Font *font, unsigned int maxStringLength)
     : DrawableNode(parent, 0.0f, 0.0f), string_(maxStringLength), dirtyDraw_(true),
       dirtyBoundaries_(true), withKerning_(true), font_(font),
       interleavedVertices_(maxStringLength * 4 + (maxStringLength - 1) * 2),
-      xAdvance_(0.0f), yAdvance_(0.0f), lineLengths_(4), alignment_(Alignment::LEFT),
+      shapedGlyphs_(maxStringLength), dirtyByteStart_(0), dirtyByteEnd_(EndOfString),
+      dirtyGlyphStart_(0), dirtyGlyphEnd_(0), lineLengths_(4), lineOffsets_(4), alignment_(Alignment::LEFT),
       lineHeight_(font ? font->lineHeight() : 0.0f), instanceBlock_(nullptr)
 {
 	ASSERT(maxStringLength > 0);
@@ -103,8 +130,7 @@ void TextNode::setFont(Font *font)
 			shaderHasChanged();
 		renderCommand_->material().setTexture(*font_->texture());
 
-		dirtyDraw_ = true;
-		dirtyBoundaries_ = true;
+		invalidateLayout();
 	}
 	else
 	{
@@ -126,6 +152,8 @@ Font::RenderMode TextNode::renderMode() const
 			return Font::RenderMode::GLYPH_IN_RED;
 		case Material::ShaderProgramType::TEXTNODE_SPRITE:
 			return Font::RenderMode::GLYPH_SPRITE;
+		case Material::ShaderProgramType::TEXTNODE_DISTANCE_FIELD:
+			return Font::RenderMode::GLYPH_DISTANCE_FIELD;
 	}
 }
 
@@ -142,8 +170,7 @@ void TextNode::enableKerning(bool withKerning)
 	if (withKerning != withKerning_)
 	{
 		withKerning_ = withKerning;
-		dirtyDraw_ = true;
-		dirtyBoundaries_ = true;
+		invalidateLayout();
 	}
 }
 
@@ -151,9 +178,9 @@ void TextNode::setAlignment(Alignment alignment)
 {
 	if (alignment != alignment_)
 	{
+		// Boundaries do not depend on alignment, only line offsets need to be updated
 		alignment_ = alignment;
 		dirtyDraw_ = true;
-		dirtyBoundaries_ = true;
 	}
 }
 
@@ -161,9 +188,8 @@ void TextNode::setString(const nctl::String &string)
 {
 	if (string_ != string)
 	{
+		invalidateLayout(string.data(), string.length());
 		string_ = string;
-		dirtyDraw_ = true;
-		dirtyBoundaries_ = true;
 	}
 }
 
@@ -171,9 +197,8 @@ void TextNode::setString(const char *string)
 {
 	if (string != nullptr && string_.compare(string))
 	{
+		invalidateLayout(string, nctl::strnlen(string, nctl::String::MaxCStringLength));
 		string_.assign(string);
-		dirtyDraw_ = true;
-		dirtyBoundaries_ = true;
 	}
 }
 
@@ -210,7 +235,7 @@ Vector2f TextNode::calculateBoundaries(const Font &font, bool withKerning, const
 					{
 						unsigned int nextCodepoint = nctl::Utf8::InvalidUnicode;
 						string.utf8ToCodePoint(i + codePointLength, nextCodepoint);
-						xAdvance += glyph->kerning(nextCodepoint);
+						xAdvance += font.kerning(codepoint, nextCodepoint);
 					}
 				}
 			}
@@ -245,55 +270,8 @@ bool TextNode::draw(RenderQueue &renderQueue)
 	if (font_ && dirtyDraw_)
 	{
 		ZoneScoped;
-		// Clear every previous quad before drawing again
-		interleavedVertices_.clear();
-
-		unsigned int currentLine = 0;
-		xAdvance_ = calculateAlignment(currentLine) - width_ * 0.5f;
-		yAdvance_ = 0.0f - height_ * 0.5f;
-		const unsigned int length = string_.length();
-		for (unsigned int i = 0; i < length;) // increments handled by UTF-8 decoding
-		{
-			if (string_[i] == '\n')
-			{
-				currentLine++;
-				xAdvance_ = calculateAlignment(currentLine) - width_ * 0.5f;
-				yAdvance_ += lineHeight_;
-				i++; // manual increment as newline character is not decoded
-			}
-			else
-			{
-				unsigned int codepoint = nctl::Utf8::InvalidUnicode;
-				const int codePointLength = string_.utf8ToCodePoint(i, codepoint);
-				const FontGlyph *glyph = (codepoint != nctl::Utf8::InvalidUnicode) ? font_->glyph(codepoint) : nullptr;
-				if (glyph)
-				{
-					Degenerate degen = Degenerate::NONE;
-					if (length > 1)
-					{
-						if (i == 0)
-							degen = Degenerate::END;
-						else if (i == length - 1)
-							degen = Degenerate::START;
-						else
-							degen = Degenerate::START_END;
-					}
-					processGlyph(glyph, degen);
-
-					if (withKerning_)
-					{
-						// font kerning
-						if (i + codePointLength < length)
-						{
-							unsigned int nextCodepoint = nctl::Utf8::InvalidUnicode;
-							string_.utf8ToCodePoint(i + codePointLength, nextCodepoint);
-							xAdvance_ += glyph->kerning(nextCodepoint);
-						}
-					}
-				}
-				i += codePointLength; // manual increment to next codepoint
-			}
-		}
+		calculateBoundaries();
+		updateVertices();
 
 		// Vertices are updated only if the string changes
 		renderCommand_->geometry().setNumVertices(interleavedVertices_.size());
@@ -313,7 +291,8 @@ TextNode::TextNode(const TextNode &other)
       string_(other.string_), dirtyDraw_(true), dirtyBoundaries_(true),
       withKerning_(other.withKerning_), font_(other.font_),
       interleavedVertices_(string_.capacity() * 4 + (string_.capacity() - 1) * 2),
-      xAdvance_(0.0f), yAdvance_(0.0f), lineLengths_(4), alignment_(other.alignment_),
+      shapedGlyphs_(string_.capacity()), dirtyByteStart_(0), dirtyByteEnd_(EndOfString),
+      dirtyGlyphStart_(0), dirtyGlyphEnd_(0), lineLengths_(4), lineOffsets_(4), alignment_(other.alignment_),
       lineHeight_(font_ ? font_->lineHeight() : 0.0f), instanceBlock_(nullptr)
 {
 	init();
@@ -350,6 +329,56 @@ void TextNode::init()
 	renderCommand_->geometry().setNumElementsPerVertex(sizeof(Vertex) / sizeof(float));
 }
 
+void TextNode::invalidateLayout()
+{
+	dirtyByteStart_ = 0;
+	dirtyByteEnd_ = EndOfString;
+	dirtyDraw_ = true;
+	dirtyBoundaries_ = true;
+}
+
+/*! \note It should be called before the new string is assigned */
+void TextNode::invalidateLayout(const char *string, unsigned int length)
+{
+	const unsigned int oldLength = string_.length();
+	const unsigned int minLength = (length < oldLength) ? length : oldLength;
+
+	unsigned int start = 0;
+	while (start < minLength && string_[start] == string[start])
+		start++;
+	// A change in the continuation bytes of a codepoint also changes its lead byte glyph and the kerning with the previous one
+	while (start > 0 && ((start < oldLength && isUtf8Continuation(string_[start])) || (start < length && isUtf8Continuation(string[start]))))
+		start--;
+
+	// The bytes after the changed range keep their position only if the length does not change
+	unsigned int end = EndOfString;
+	if (length == oldLength)
+	{
+		end = length;
+		while (end > start && string_[end - 1] == string[end - 1])
+			end--;
+	}
+
+	if (dirtyBoundaries_)
+	{
+		// Merging with the range of a previous change that has not been laid out yet
+		if (start < dirtyByteStart_)
+			dirtyByteStart_ = start;
+		if (end == EndOfString || dirtyByteEnd_ == EndOfString)
+			dirtyByteEnd_ = EndOfString;
+		else if (end > dirtyByteEnd_)
+			dirtyByteEnd_ = end;
+	}
+	else
+	{
+		dirtyByteStart_ = start;
+		dirtyByteEnd_ = end;
+	}
+
+	dirtyDraw_ = true;
+	dirtyBoundaries_ = true;
+}
+
 void TextNode::calculateBoundaries() const
 {
 	if (font_ && dirtyBoundaries_)
@@ -358,60 +387,27 @@ void TextNode::calculateBoundaries() const
 		const float oldWidth = width_;
 		const float oldHeight = height_;
 
-		lineLengths_.clear();
+		shapeString();
+
 		float xAdvanceMax = 0.0f; // longest line
-		xAdvance_ = 0.0f;
-		yAdvance_ = 0.0f;
-		const unsigned int length = string_.length();
-		for (unsigned int i = 0; i < length;) // increments handled by UTF-8 decoding
+		for (unsigned int i = 0; i < lineLengths_.size(); i++)
 		{
-			if (string_[i] == '\n')
-			{
-				lineLengths_.pushBack(xAdvance_);
-				if (xAdvance_ > xAdvanceMax)
-					xAdvanceMax = xAdvance_;
-				xAdvance_ = 0.0f;
-				yAdvance_ += lineHeight_;
-				i++; // manual increment as newline character is not decoded
-			}
-			else
-			{
-				unsigned int codepoint = nctl::Utf8::InvalidUnicode;
-				const int codePointLength = string_.utf8ToCodePoint(i, codepoint);
-				const FontGlyph *glyph = (codepoint != nctl::Utf8::InvalidUnicode) ? font_->glyph(codepoint) : nullptr;
-				if (glyph)
-				{
-					xAdvance_ += glyph->xAdvance();
-					if (withKerning_)
-					{
-						// font kerning
-						if (i + codePointLength < length)
-						{
-							unsigned int nextCodepoint = nctl::Utf8::InvalidUnicode;
-							string_.utf8ToCodePoint(i + codePointLength, nextCodepoint);
-							xAdvance_ += glyph->kerning(nextCodepoint);
-						}
-					}
-				}
-				i += codePointLength; // manual increment to next codepoint
-			}
+			if (lineLengths_[i] > xAdvanceMax)
+				xAdvanceMax = lineLengths_[i];
 		}
 
+		float yAdvance = (lineLengths_.size() - 1) * lineHeight_;
 		// If the string does not end with a new line character,
 		// last line height has not been taken into account before
 		if (!string_.isEmpty() && string_[string_.length() - 1] != '\n')
-			yAdvance_ += lineHeight_;
-
-		lineLengths_.pushBack(xAdvance_);
-		if (xAdvance_ > xAdvanceMax)
-			xAdvanceMax = xAdvance_;
+			yAdvance += lineHeight_;
 
 		// Update node size and anchor points
 		TextNode *mutableNode = const_cast<TextNode *>(this);
 		// Total advance on the X-axis for the longest line (horizontal boundary)
 		mutableNode->width_ = xAdvanceMax;
 		// Total advance on the Y-axis for the entire string (vertical boundary)
-		mutableNode->height_ = yAdvance_;
+		mutableNode->height_ = yAdvance;
 		mutableNode->dirtyBits_.set(DirtyBitPositions::AabbBit);
 
 		if (oldWidth > 0.0f && oldHeight > 0.0f)
@@ -424,6 +420,130 @@ void TextNode::calculateBoundaries() const
 	}
 }
 
+/*! The layout restarts from the last glyph before the first changed byte, as its kerning depends on the following codepoint.
+ *  When the string length has not changed, it stops at the first glyph after the changed bytes that is found
+ *  at the same position as before, as every following glyph and line would be laid out the same way. */
+void TextNode::shapeString() const
+{
+	const unsigned int length = string_.length();
+	const unsigned int numOldGlyphs = shapedGlyphs_.size();
+
+	// Binary search of the first laid out glyph at or after the first changed byte
+	unsigned int glyphIndex = 0;
+	unsigned int count = numOldGlyphs;
+	while (count > 0)
+	{
+		const unsigned int step = count / 2;
+		if (shapedGlyphs_[glyphIndex + step].byteIndex < dirtyByteStart_)
+		{
+			glyphIndex += step + 1;
+			count -= step + 1;
+		}
+		else
+			count = step;
+	}
+
+	unsigned int i = 0;
+	unsigned int line = 0;
+	float xAdvance = 0.0f;
+	if (glyphIndex > 0)
+	{
+		glyphIndex--;
+		const ShapedGlyph &restartGlyph = shapedGlyphs_[glyphIndex];
+		i = restartGlyph.byteIndex;
+		line = restartGlyph.line;
+		xAdvance = restartGlyph.xAdvance;
+	}
+	const unsigned int firstDirtyGlyph = glyphIndex;
+
+	bool hasStoppedEarly = false;
+	while (i < length) // increments handled by UTF-8 decoding
+	{
+		if (string_[i] == '\n')
+		{
+			if (line < lineLengths_.size())
+				lineLengths_[line] = xAdvance;
+			else
+				lineLengths_.pushBack(xAdvance);
+			xAdvance = 0.0f;
+			line++;
+			i++; // manual increment as newline character is not decoded
+		}
+		else
+		{
+			unsigned int codepoint = nctl::Utf8::InvalidUnicode;
+			const int codePointLength = string_.utf8ToCodePoint(i, codepoint);
+			const FontGlyph *glyph = (codepoint != nctl::Utf8::InvalidUnicode) ? font_->glyph(codepoint) : nullptr;
+			if (glyph)
+			{
+				if (dirtyByteEnd_ != EndOfString && i >= dirtyByteEnd_ && glyphIndex < numOldGlyphs)
+				{
+					const ShapedGlyph &oldGlyph = shapedGlyphs_[glyphIndex];
+					if (oldGlyph.byteIndex == i && oldGlyph.line == line && oldGlyph.xAdvance == xAdvance)
+					{
+						hasStoppedEarly = true;
+						break;
+					}
+				}
+
+				const ShapedGlyph shapedGlyph = { glyph, i, line, xAdvance };
+				if (glyphIndex < shapedGlyphs_.size())
+					shapedGlyphs_[glyphIndex] = shapedGlyph;
+				else
+					shapedGlyphs_.pushBack(shapedGlyph);
+				glyphIndex++;
+
+				xAdvance += glyph->xAdvance();
+				if (withKerning_)
+				{
+					// font kerning
+					if (i + codePointLength < length)
+					{
+						unsigned int nextCodepoint = nctl::Utf8::InvalidUnicode;
+						string_.utf8ToCodePoint(i + codePointLength, nextCodepoint);
+						xAdvance += font_->kerning(codepoint, nextCodepoint);
+					}
+				}
+			}
+			i += codePointLength; // manual increment to next codepoint
+		}
+	}
+
+	// When stopping early the lengths of the current and following lines are unchanged
+	if (hasStoppedEarly == false)
+	{
+		if (line < lineLengths_.size())
+			lineLengths_[line] = xAdvance;
+		else
+			lineLengths_.pushBack(xAdvance);
+		lineLengths_.setSize(line + 1);
+		shapedGlyphs_.setSize(glyphIndex);
+	}
+
+	unsigned int dirtyGlyphStart = firstDirtyGlyph;
+	// The last glyph in common gains or loses the degenerate vertex joining it to the next one
+	const unsigned int numGlyphs = shapedGlyphs_.size();
+	if (numGlyphs != numOldGlyphs)
+	{
+		const unsigned int numCommonGlyphs = (numGlyphs < numOldGlyphs) ? numGlyphs : numOldGlyphs;
+		if (numCommonGlyphs > 0 && numCommonGlyphs - 1 < dirtyGlyphStart)
+			dirtyGlyphStart = numCommonGlyphs - 1;
+	}
+
+	if (dirtyGlyphStart_ >= dirtyGlyphEnd_)
+	{
+		dirtyGlyphStart_ = dirtyGlyphStart;
+		dirtyGlyphEnd_ = glyphIndex;
+	}
+	else
+	{
+		if (dirtyGlyphStart < dirtyGlyphStart_)
+			dirtyGlyphStart_ = dirtyGlyphStart;
+		if (glyphIndex > dirtyGlyphEnd_)
+			dirtyGlyphEnd_ = glyphIndex;
+	}
+}
+
 float TextNode::calculateAlignment(unsigned int lineIndex) const
 {
 	float alignOffset = 0.0f;
@@ -444,36 +564,78 @@ float TextNode::calculateAlignment(unsigned int lineIndex) const
 	return alignOffset;
 }
 
-void TextNode::processGlyph(const FontGlyph *glyph, Degenerate degen)
+/*! When the size of the text and the alignment of every line are unchanged, as it happens when a number of digits
+ *  with the same width is updated, only the vertices of the laid out glyphs are written again, in place. */
+void TextNode::updateVertices()
+{
+	const unsigned int numGlyphs = shapedGlyphs_.size();
+	const unsigned int numVertices = numGlyphVertices(numGlyphs);
+	if (numVertices > interleavedVertices_.capacity())
+		interleavedVertices_.setCapacity(numVertices * 2);
+	interleavedVertices_.setSize(numVertices);
+
+	// Lines are offset to center the text around the node position and to follow the alignment
+	bool linesHaveMoved = (lineOffsets_.size() != lineLengths_.size());
+	lineOffsets_.setSize(lineLengths_.size());
+	for (unsigned int i = 0; i < lineOffsets_.size(); i++)
+	{
+		const Vector2f lineOffset(calculateAlignment(i) - width_ * 0.5f, i * lineHeight_ - height_ * 0.5f);
+		if ((lineOffsets_[i] == lineOffset) == false)
+		{
+			lineOffsets_[i] = lineOffset;
+			linesHaveMoved = true;
+		}
+	}
+
+	unsigned int firstGlyph = dirtyGlyphStart_;
+	unsigned int lastGlyph = (dirtyGlyphEnd_ < numGlyphs) ? dirtyGlyphEnd_ : numGlyphs;
+	if (linesHaveMoved)
+	{
+		firstGlyph = 0;
+		lastGlyph = numGlyphs;
+	}
+
+	for (unsigned int i = firstGlyph; i < lastGlyph; i++)
+		processGlyph(i);
+
+	dirtyGlyphStart_ = 0;
+	dirtyGlyphEnd_ = 0;
+}
+
+void TextNode::processGlyph(unsigned int glyphIndex)
 {
-	const Vector2i size = glyph->size();
-	const Vector2i offset = glyph->offset();
+	const ShapedGlyph &shapedGlyph = shapedGlyphs_[glyphIndex];
+	const Vector2f &lineOffset = lineOffsets_[shapedGlyph.line];
+	const Vector2i size = shapedGlyph.glyph->size();
+	const Vector2i offset = shapedGlyph.glyph->offset();
 
-	const float leftPos = xAdvance_ + offset.x;
+	const float leftPos = lineOffset.x + shapedGlyph.xAdvance + offset.x;
 	const float rightPos = leftPos + size.x;
-	const float topPos = -yAdvance_ - offset.y;
+	const float topPos = -lineOffset.y - offset.y;
 	const float bottomPos = topPos - size.y;
 
 	const Vector2i texSize = font_->texture()->size();
-	const Recti texRect = glyph->texRect();
+	const Recti texRect = shapedGlyph.glyph->texRect();
 
 	const float leftCoord = float(texRect.x) / float(texSize.x);
 	const float rightCoord = float(texRect.x + texRect.w) / float(texSize.x);
 	const float bottomCoord = float(texRect.y + texRect.h) / float(texSize.y);
 	const float topCoord = float(texRect.y) / float(texSize.y);
 
-	if (degen == Degenerate::START || degen == Degenerate::START_END)
-		interleavedVertices_.pushBack(Vertex(leftPos, bottomPos, leftCoord, bottomCoord));
+	Vertex *vertices = interleavedVertices_.data() + firstGlyphVertex(glyphIndex);
 
-	interleavedVertices_.pushBack(Vertex(leftPos, bottomPos, leftCoord, bottomCoord));
-	interleavedVertices_.pushBack(Vertex(leftPos, topPos, leftCoord, topCoord));
-	interleavedVertices_.pushBack(Vertex(rightPos, bottomPos, rightCoord, bottomCoord));
-	interleavedVertices_.pushBack(Vertex(rightPos, topPos, rightCoord, topCoord));
+	// Degenerate vertex joining the quad to the previous one
+	if (glyphIndex > 0)
+		*vertices++ = Vertex(leftPos, bottomPos, leftCoord, bottomCoord);
 
-	if (degen == Degenerate::START_END || degen == Degenerate::END)
-		interleavedVertices_.pushBack(Vertex(rightPos, topPos, rightCoord, topCoord));
+	*vertices++ = Vertex(leftPos, bottomPos, leftCoord, bottomCoord);
+	*vertices++ = Vertex(leftPos, topPos, leftCoord, topCoord);
+	*vertices++ = Vertex(rightPos, bottomPos, rightCoord, bottomCoord);
+	*vertices++ = Vertex(rightPos, topPos, rightCoord, topCoord);
 
-	xAdvance_ += glyph->xAdvance();
+	// Degenerate vertex joining the quad to the next one
+	if (glyphIndex + 1 < shapedGlyphs_.size())
+		*vertices = Vertex(rightPos, topPos, rightCoord, topCoord);
 }
 
 void TextNode::shaderHasChanged()
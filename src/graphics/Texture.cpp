@@ -6,6 +6,8 @@
 #include "TextureLoaderRaw.h"
 #include "GLTexture.h"
 #include "RenderStatistics.h"
+#include "Application.h"
+#include "AsyncTextureLoader.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -86,7 +88,7 @@ Texture::Texture()
     : Object(ObjectType::TEXTURE), glTexture_(nctl::makeUnique<GLTexture>(GL_TEXTURE_2D)),
       width_(0), height_(0), mipMapLevels_(0), isCompressed_(false), format_(Format::UNKNOWN), dataSize_(0),
       minFiltering_(Filtering::NEAREST), magFiltering_(Filtering::NEAREST), wrapMode_(Wrap::REPEAT),
-      isChromaKeyEnabled_(false), chromaKeyColor_(Color::Magenta)
+      isChromaKeyEnabled_(false), chromaKeyColor_(Color::Magenta), isLoading_(false)
 {
 }
 
@@ -134,14 +136,58 @@ Texture::Texture(const char *filename)
 
 Texture::~Texture()
 {
+	if (isLoading_)
+		theApplication().asyncTextureLoader_->cancel(this);
+
 	// Don't remove data from statistics if this is a moved out object
 	if (dataSize_ > 0 && glTexture_)
 		RenderStatistics::removeTexture(dataSize_);
 }
 
-Texture::Texture(Texture &&) = default;
+Texture::Texture(Texture &&other)
+    : Object(nctl::move(other)), glTexture_(nctl::move(other.glTexture_)),
+      width_(other.width_), height_(other.height_), mipMapLevels_(other.mipMapLevels_), isCompressed_(other.isCompressed_),
+      format_(other.format_), dataSize_(other.dataSize_), minFiltering_(other.minFiltering_), magFiltering_(other.magFiltering_),
+      wrapMode_(other.wrapMode_), isChromaKeyEnabled_(other.isChromaKeyEnabled_), chromaKeyColor_(other.chromaKeyColor_),
+      isLoading_(other.isLoading_)
+{
+	// A pending asynchronous loading follows the moved texture
+	if (isLoading_)
+	{
+		theApplication().asyncTextureLoader_->replace(&other, this);
+		other.isLoading_ = false;
+	}
+}
 
-Texture &Texture::operator=(Texture &&) = default;
+Texture &Texture::operator=(Texture &&other)
+{
+	if (isLoading_)
+		theApplication().asyncTextureLoader_->cancel(this);
+
+	Object::operator=(nctl::move(other));
+	glTexture_ = nctl::move(other.glTexture_);
+	width_ = other.width_;
+	height_ = other.height_;
+	mipMapLevels_ = other.mipMapLevels_;
+	isCompressed_ = other.isCompressed_;
+	format_ = other.format_;
+	dataSize_ = other.dataSize_;
+	minFiltering_ = other.minFiltering_;
+	magFiltering_ = other.magFiltering_;
+	wrapMode_ = other.wrapMode_;
+	isChromaKeyEnabled_ = other.isChromaKeyEnabled_;
+	chromaKeyColor_ = other.chromaKeyColor_;
+	isLoading_ = other.isLoading_;
+
+	// A pending asynchronous loading follows the moved texture
+	if (isLoading_)
+	{
+		theApplication().asyncTextureLoader_->replace(&other, this);
+		other.isLoading_ = false;
+	}
+
+	return *this;
+}
 
 ///////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
@@ -199,17 +245,11 @@ bool Texture::loadFromMemory(const char *bufferName, const unsigned char *buffer
 	if (texLoader->hasLoaded() == false)
 		return false;
 
-	if (dataSize_ > 0)
-		RenderStatistics::removeTexture(dataSize_);
-
-	glTexture_->bind();
-	setName(bufferName);
-	glTexture_->setObjectLabel(bufferName);
-	initialize(*texLoader);
-	load(*texLoader);
+	// A synchronous loading supersedes a pending asynchronous one
+	if (isLoading_)
+		theApplication().asyncTextureLoader_->cancel(this);
 
-	RenderStatistics::addTexture(dataSize_);
-	return true;
+	return loadFromLoader(bufferName, *texLoader);
 }
 
 bool Texture::loadFromFile(const char *filename)
@@ -221,16 +261,36 @@ bool Texture::loadFromFile(const char *filename)
 	if (texLoader->hasLoaded() == false)
 		return false;
 
-	if (dataSize_ > 0)
-		RenderStatistics::removeTexture(dataSize_);
+	// A synchronous loading supersedes a pending asynchronous one
+	if (isLoading_)
+		theApplication().asyncTextureLoader_->cancel(this);
 
-	glTexture_->bind();
-	setName(filename);
-	glTexture_->setObjectLabel(filename);
-	initialize(*texLoader);
-	load(*texLoader);
+	return loadFromLoader(filename, *texLoader);
+}
 
-	RenderStatistics::addTexture(dataSize_);
+bool Texture::loadFromFileAsync(const char *filename)
+{
+	return loadFromFileAsync(filename, nullptr, nullptr);
+}
+
+/*! The texture keeps its current content until the upload, an empty texture is initialized with a 1x1 white placeholder.
+ *  \note The size of the texture changes only when the upload happens, sprites should reset their texture rectangle in the callback */
+bool Texture::loadFromFileAsync(const char *filename, LoadedCallback callback, void *userData)
+{
+	ZoneScoped;
+	ZoneText(filename, nctl::strnlen(filename, nctl::String::MaxCStringLength));
+
+	AsyncTextureLoader *asyncLoader = theApplication().asyncTextureLoader_.get();
+	FATAL_ASSERT(asyncLoader != nullptr);
+
+	if (dataSize_ == 0)
+	{
+		static const uint32_t PlaceholderTexel = 0xFFFFFFFF;
+		init(filename, Format::RGBA8, 1, 1);
+		loadFromTexels(reinterpret_cast<const unsigned char *>(&PlaceholderTexel));
+	}
+
+	asyncLoader->enqueue(this, filename, callback, userData);
 	return true;
 }
 
@@ -473,7 +533,22 @@ void Texture::initialize(const ITextureLoader &texLoader)
 	dataSize_ = dataSize;
 }
 
-void Texture::load(const ITextureLoader &texLoader)
+bool Texture::loadFromLoader(const char *name, const ITextureLoader &texLoader)
+{
+	if (dataSize_ > 0)
+		RenderStatistics::removeTexture(dataSize_);
+
+	glTexture_->bind();
+	setName(name);
+	glTexture_->setObjectLabel(name);
+	initialize(texLoader);
+	const bool hasLoaded = load(texLoader);
+
+	RenderStatistics::addTexture(dataSize_);
+	return hasLoaded;
+}
+
+bool Texture::load(const ITextureLoader &texLoader)
 {
 #if (defined(WITH_OPENGLES) && GL_ES_VERSION_3_0) || defined(__EMSCRIPTEN__)
 	const bool withTexStorage = true;
@@ -489,24 +564,36 @@ void Texture::load(const ITextureLoader &texLoader)
 	GLenum format = texFormat.format();
 	nctl::UniquePtr<uint32_t[]> chromaPixels;
 
+	// A streamed texture is read one level at a time in a buffer big enough for the first and biggest one
+	nctl::UniquePtr<GLubyte[]> levelBuffer;
+	if (texLoader.isStreamed())
+		levelBuffer = nctl::makeUnique<GLubyte[]>(texLoader.dataSize(0));
+
 	for (int mipIdx = 0; mipIdx < texLoader.mipMapCount(); mipIdx++)
 	{
-		const unsigned char *data = texLoader.pixels(mipIdx);
+		const GLubyte *levelPixels = texLoader.levelPixels(mipIdx, levelBuffer.get());
+		if (levelPixels == nullptr)
+		{
+			LOGE_X("Cannot read the pixels of mip level %d of texture \"%s\"", mipIdx, name());
+			return false;
+		}
+
+		const unsigned char *data = levelPixels;
 		if (texFormat.isCompressed() == false && format == GL_RGB && isChromaKeyEnabled_)
 		{
 			format = GL_RGBA;
 			const unsigned int numPixels = levelWidth * levelHeight;
 			chromaPixels = nctl::makeUnique<uint32_t[]>(numPixels);
-			chromaKeyPixels(chromaPixels.get(), texLoader.pixels(mipIdx), numPixels, chromaKeyColor_);
+			chromaKeyPixels(chromaPixels.get(), levelPixels, numPixels, chromaKeyColor_);
 			data = reinterpret_cast<const unsigned char *>(chromaPixels.get());
 		}
 
 		if (texFormat.isCompressed())
 		{
 			if (withTexStorage)
-				glTexture_->compressedTexSubImage2D(mipIdx, 0, 0, levelWidth, levelHeight, texFormat.internalFormat(), texLoader.dataSize(mipIdx), texLoader.pixels(mipIdx));
+				glTexture_->compressedTexSubImage2D(mipIdx, 0, 0, levelWidth, levelHeight, texFormat.internalFormat(), texLoader.dataSize(mipIdx), levelPixels);
 			else
-				glTexture_->compressedTexImage2D(mipIdx, texFormat.internalFormat(), levelWidth, levelHeight, texLoader.dataSize(mipIdx), texLoader.pixels(mipIdx));
+				glTexture_->compressedTexImage2D(mipIdx, texFormat.internalFormat(), levelWidth, levelHeight, texLoader.dataSize(mipIdx), levelPixels);
 		}
 		else
 			// Storage has already been created at this point
@@ -515,6 +602,8 @@ void Texture::load(const ITextureLoader &texLoader)
 		levelWidth /= 2;
 		levelHeight /= 2;
 	}
+
+	return true;
 }
 
 }
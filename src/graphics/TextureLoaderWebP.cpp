@@ -16,10 +16,17 @@ TextureLoaderWebP::TextureLoaderWebP(nctl::UniquePtr<IFile> fileHandle)
 	fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 	RETURN_ASSERT_MSG_X(fileHandle_->isOpened(), "File \"%s\" cannot be opened", fileHandle_->filename());
 	const long int fileSize = fileHandle_->size();
-	nctl::UniquePtr<unsigned char[]> fileBuffer = nctl::makeUnique<unsigned char[]>(fileSize);
-	fileHandle_->read(fileBuffer.get(), fileSize);
+	nctl::UniquePtr<unsigned char[]> fileBuffer;
+	const unsigned char *fileData = fileHandle_->data();
+	// The file is copied only if it is not already accessible in memory
+	if (fileData == nullptr)
+	{
+		fileBuffer = nctl::makeUnique<unsigned char[]>(fileSize);
+		fileHandle_->read(fileBuffer.get(), fileSize);
+		fileData = fileBuffer.get();
+	}
 
-	if (WebPGetInfo(fileBuffer.get(), fileSize, &width_, &height_) == 0)
+	if (WebPGetInfo(fileData, fileSize, &width_, &height_) == 0)
 	{
 		fileBuffer.reset(nullptr);
 		RETURN_MSG("Cannot read WebP header");
@@ -28,7 +35,7 @@ TextureLoaderWebP::TextureLoaderWebP(nctl::UniquePtr<IFile> fileHandle)
 	LOGI_X("Header found: w:%d h:%d", width_, height_);
 
 	WebPBitstreamFeatures features;
-	if (WebPGetFeatures(fileBuffer.get(), fileSize, &features) != VP8_STATUS_OK)
+	if (WebPGetFeatures(fileData, fileSize, &features) != VP8_STATUS_OK)
 	{
 		fileBuffer.reset(nullptr);
 		RETURN_MSG("Cannot retrieve WebP features from headers");
@@ -44,7 +51,7 @@ TextureLoaderWebP::TextureLoaderWebP(nctl::UniquePtr<IFile> fileHandle)
 
 	if (features.has_alpha)
 	{
-		if (WebPDecodeRGBAInto(fileBuffer.get(), fileSize, pixels_.get(), dataSize_, width_ * 4) == nullptr)
+		if (WebPDecodeRGBAInto(fileData, fileSize, pixels_.get(), dataSize_, width_ * 4) == nullptr)
 		{
 			fileBuffer.reset(nullptr);
 			pixels_.reset(nullptr);
@@ -53,7 +60,7 @@ TextureLoaderWebP::TextureLoaderWebP(nctl::UniquePtr<IFile> fileHandle)
 	}
 	else
 	{
-		if (WebPDecodeRGBInto(fileBuffer.get(), fileSize, pixels_.get(), dataSize_, width_ * 3) == nullptr)
+		if (WebPDecodeRGBInto(fileData, fileSize, pixels_.get(), dataSize_, width_ * 3) == nullptr)
 		{
 			fileBuffer.reset(nullptr);
 			pixels_.reset(nullptr);
@@ -1,6 +1,8 @@
+#include <nctl/algorithms.h>
 #include <nctl/StaticString.h>
 #include "Viewport.h"
 #include "RenderQueue.h"
+#include "SpatialGrid.h"
 #include "RenderResources.h"
 #include "Application.h"
 #include "IAppEventHandler.h"
@@ -14,6 +16,10 @@
 #include "GLDebug.h"
 #include "tracy.h"
 
+#ifdef WITH_THREADS
+	#include "SceneUpdater.h"
+#endif
+
 #ifdef WITH_QT5
 	#include "Qt5GfxDevice.h"
 #endif
@@ -69,7 +75,7 @@ Viewport::Viewport(const char *name, Texture *texture, DepthStencilFormat depthS
       viewportRect_(0, 0, 0, 0), scissorRect_(0, 0, 0, 0),
       depthStencilFormat_(DepthStencilFormat::NONE), lastFrameCleared_(0),
       clearMode_(ClearMode::EVERY_FRAME), clearColor_(Colorf::Black),
-      renderQueue_(nctl::makeUnique<RenderQueue>()),
+      renderQueue_(nctl::makeUnique<RenderQueue>()), spatialGrid_(nullptr), visitFromGrid_(false),
       fbo_(nullptr), rootNode_(nullptr), camera_(nullptr),
       stateBits_(0), numColorAttachments_(0)
 {
@@ -265,6 +271,31 @@ Texture *Viewport::texture(unsigned int index)
 	return texture;
 }
 
+void Viewport::setRootNode(SceneNode *rootNode)
+{
+	// The nodes of the previous scene should not be found by the culling anymore
+	if (spatialGrid_ && rootNode != rootNode_)
+		spatialGrid_ = nctl::makeUnique<SpatialGrid>(spatialGrid_->cellSize());
+
+	rootNode_ = rootNode;
+}
+
+float Viewport::cullingGridCellSize() const
+{
+	return spatialGrid_ ? spatialGrid_->cellSize() : 0.0f;
+}
+
+void Viewport::setCullingGridCellSize(float cellSize)
+{
+	if (cellSize == cullingGridCellSize())
+		return;
+
+	// Destroying the previous grid detaches all of its nodes
+	spatialGrid_.reset(nullptr);
+	if (cellSize > 0.0f)
+		spatialGrid_ = nctl::makeUnique<SpatialGrid>(cellSize);
+}
+
 void Viewport::setGLFramebufferLabel(const char *label)
 {
 	if (fbo_)
@@ -356,10 +387,29 @@ void Viewport::update()
 	{
 		ZoneScoped;
 		if (rootNode_->lastFrameUpdated() < theApplication().numFrames())
-			rootNode_->update(theApplication().interval());
+		{
+#ifdef WITH_THREADS
+			if (theApplication().sceneUpdater_)
+				theApplication().sceneUpdater_->update(*rootNode_, theApplication().interval());
+			else
+#endif
+				rootNode_->update(theApplication().interval());
+		}
 		// AABBs should update after nodes have been transformed
-		updateCulling(rootNode_);
+		visitFromGrid_ = (spatialGrid_ && theApplication().renderingSettings().cullingEnabled);
+		gridVisitNodes_.clear();
+		unsigned int order = 0;
+		updateCulling(rootNode_, order);
+		if (visitFromGrid_)
+		{
+			spatialGrid_->collectOverlapping(cullingRect_, theApplication().numFrames(), gridVisitNodes_);
+			nctl::quicksort(gridVisitNodes_.begin(), gridVisitNodes_.end(), [](const SceneNode *a, const SceneNode *b) {
+				return a->spatialGridOrder_ < b->spatialGridOrder_;
+			});
+		}
 	}
+	else
+		visitFromGrid_ = false;
 
 	stateBits_.set(StateBitPositions::UpdatedBit);
 }
@@ -372,7 +422,14 @@ void Viewport::visit()
 	{
 		ZoneScoped;
 		unsigned int visitOrderIndex = 0;
-		rootNode_->visit(*renderQueue_, visitOrderIndex);
+		if (visitFromGrid_)
+		{
+			// Only the nodes overlapping the culling rectangle are visited, in the same order as the scenegraph
+			for (SceneNode *node : gridVisitNodes_)
+				node->visitNode(*renderQueue_, visitOrderIndex);
+		}
+		else
+			rootNode_->visit(*renderQueue_, visitOrderIndex);
 	}
 
 	stateBits_.set(StateBitPositions::VisitedBit);
@@ -498,17 +555,58 @@ void Viewport::draw(unsigned int nextIndex)
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
-void Viewport::updateCulling(SceneNode *node)
+bool Viewport::updateCulling(SceneNode *node, unsigned int &order)
 {
+	// The nodes of a subtree disabled for drawing are not visited, there is no need to store them
+	if (node->drawEnabled_ == false)
+	{
+		SpatialGrid::removeSubtree(node);
+		return false;
+	}
+
+	// The AABBs of a static subtree that has not been updated are still stored in the grid,
+	// the order of its nodes is still valid if the nodes before it have not changed
+	SpatialGrid *spatialGrid = spatialGrid_.get();
+	if (spatialGrid && node->isStatic_ && node->staticUpdateSkipped_ && node->staticSpatialGridId_ == spatialGrid->id() &&
+	    node->spatialGridOrder_ == order)
+	{
+		order = node->staticSpatialGridEndOrder_;
+		return true;
+	}
+
+	node->spatialGridOrder_ = order++;
+	// Particle systems are not stored in the grid, they are always visited
+	const bool isParticleSystem = (node->type() == Object::ObjectType::PARTICLE_SYSTEM);
+	if (visitFromGrid_ && isParticleSystem)
+		gridVisitNodes_.pushBack(node);
+
+	bool allInGrid = (isParticleSystem == false);
 	for (SceneNode *child : node->children())
-		updateCulling(child);
+		allInGrid = updateCulling(child, order) && allInGrid;
 
 	if (node->type() != Object::ObjectType::SCENENODE &&
 	    node->type() != Object::ObjectType::PARTICLE_SYSTEM)
 	{
 		DrawableNode *drawable = static_cast<DrawableNode *>(node);
-		drawable->updateCulling();
+		const bool inGrid = drawable->updateCulling(spatialGrid);
+		allInGrid = inGrid && allInGrid;
+		// Nodes stored in the grid of another viewport are tested against the culling rectangle when visited
+		if (visitFromGrid_ && inGrid == false)
+			gridVisitNodes_.pushBack(node);
+	}
+
+	if (spatialGrid && node->isStatic_)
+	{
+		if (allInGrid)
+		{
+			node->staticSpatialGridId_ = spatialGrid->id();
+			node->staticSpatialGridEndOrder_ = order;
+		}
+		else if (node->staticSpatialGridId_ == spatialGrid->id())
+			node->staticSpatialGridId_ = 0;
 	}
+
+	return allInGrid;
 }
 
 }
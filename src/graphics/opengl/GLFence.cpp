@@ -0,0 +1,58 @@
+#include "GLFence.h"
+#include "tracy_opengl.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+GLFence::GLFence()
+    : glHandle_(nullptr)
+{
+}
+
+GLFence::~GLFence()
+{
+	reset();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void GLFence::insert()
+{
+	reset();
+	glHandle_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GLFence::reset()
+{
+	if (glHandle_ != nullptr)
+	{
+		glDeleteSync(glHandle_);
+		glHandle_ = nullptr;
+	}
+}
+
+bool GLFence::isSignaled()
+{
+	if (glHandle_ == nullptr)
+		return true;
+
+	const GLenum result = glClientWaitSync(glHandle_, 0, 0);
+	return (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED);
+}
+
+GLenum GLFence::clientWait(GLuint64 timeout)
+{
+	if (glHandle_ == nullptr)
+		return GL_ALREADY_SIGNALED;
+
+	TracyGpuZone("glClientWaitSync");
+	// Flushing the commands to be sure the fence will eventually be signaled
+	return glClientWaitSync(glHandle_, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+}
+
+}
@@ -0,0 +1,1063 @@
+#include <cstring>
+#include <cstdint> // for uintptr_t
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+#include "common_macros.h"
+#include "NullGL.h"
+#include "NullGLProgram.h"
+#include <nctl/Array.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+namespace {
+
+	/// An object that only needs a name
+	struct NamedObject
+	{
+	};
+
+	struct Buffer
+	{
+		Buffer()
+		    : data(nullptr), size(0) {}
+
+		GLubyte *data;
+		GLsizeiptr size;
+	};
+
+	struct VertexArray
+	{
+		VertexArray()
+		    : elementArrayBuffer(0) {}
+
+		/// The element array buffer binding is part of the vertex array state
+		GLuint elementArrayBuffer;
+	};
+
+	struct Shader
+	{
+		Shader()
+		    : type(GL_NONE), numAttachments(0), deletePending(false) {}
+
+		GLenum type;
+		nctl::String source;
+		/// Number of programs the shader is attached to
+		unsigned int numAttachments;
+		/// A shader deleted while attached is only released when detached
+		bool deletePending;
+	};
+
+	struct Sync
+	{
+		Sync()
+		    : frame(0), signaled(false) {}
+
+		/// The frame the fence has been inserted in
+		unsigned long frame;
+		/// True if a client wait has already signaled the fence
+		bool signaled;
+	};
+
+	struct Program
+	{
+		nctl::Array<GLuint> shaders;
+		NullGLProgram interface;
+	};
+
+	/// A table of objects indexed by their names, the name zero is reserved
+	template <class T>
+	class ObjectTable
+	{
+	  public:
+		GLuint create()
+		{
+			if (objects_.isEmpty())
+			{
+				objects_.emplaceBack();
+				used_.pushBack(false);
+			}
+
+			GLuint name = 0;
+			if (freeNames_.isEmpty())
+			{
+				name = objects_.size();
+				objects_.emplaceBack();
+				used_.pushBack(true);
+			}
+			else
+			{
+				name = freeNames_.back();
+				freeNames_.popBack();
+				used_[name] = true;
+			}
+			return name;
+		}
+
+		void destroy(GLuint name)
+		{
+			if (find(name) != nullptr)
+			{
+				objects_[name] = T();
+				used_[name] = false;
+				freeNames_.pushBack(name);
+			}
+		}
+
+		T *find(GLuint name) { return (name > 0 && name < objects_.size() && used_[name]) ? &objects_[name] : nullptr; }
+
+	  private:
+		nctl::Array<T> objects_;
+		nctl::Array<bool> used_;
+		nctl::Array<GLuint> freeNames_;
+	};
+
+	ObjectTable<Buffer> buffers;
+	ObjectTable<VertexArray> vertexArrays;
+	ObjectTable<Shader> shaders;
+	ObjectTable<Program> programs;
+	ObjectTable<NamedObject> textures;
+	ObjectTable<NamedObject> framebuffers;
+	ObjectTable<NamedObject> renderbuffers;
+	ObjectTable<Sync> syncs;
+
+	enum BufferTarget
+	{
+		ARRAY_BUFFER,
+		UNIFORM_BUFFER,
+		TEXTURE_BUFFER,
+		PIXEL_PACK_BUFFER,
+		PIXEL_UNPACK_BUFFER,
+		COPY_READ_BUFFER,
+		COPY_WRITE_BUFFER,
+
+		COUNT
+	};
+
+	GLuint boundBuffers[BufferTarget::COUNT] = {};
+	GLuint boundVertexArray = 0;
+	/// The element array buffer binding when no vertex array is bound
+	GLuint defaultElementArrayBuffer = 0;
+	/// The number of frames since the start of the application
+	unsigned long frameIndex = 0;
+	/// The number of frames after which a fence is signaled
+	unsigned int fenceLatency = 0;
+
+	NullGL::Counters frameCounters;
+	NullGL::Counters lastFrameCounters;
+	NullGL::Counters totalCounters;
+
+	const char *VersionString = "4.5.0 Null";
+	const char *GlslVersionString = "4.50";
+	const char *VendorString = "nCine";
+	const char *RendererString = "Null OpenGL dispatch";
+
+	const char *Extensions[] = { "GL_KHR_debug", "GL_ARB_texture_storage", "GL_EXT_texture_compression_s3tc", "GL_ARB_buffer_storage" };
+	const unsigned int NumExtensions = sizeof(Extensions) / sizeof(Extensions[0]);
+
+	inline void countCall()
+	{
+		frameCounters.numCalls++;
+	}
+
+	inline void countDraw(GLsizei count, GLsizei numInstances)
+	{
+		frameCounters.numDrawCalls++;
+		frameCounters.numInstances += static_cast<unsigned long>(numInstances);
+		frameCounters.numVertices += static_cast<unsigned long>(count);
+	}
+
+	void addCounters(NullGL::Counters &dest, const NullGL::Counters &src)
+	{
+		dest.numCalls += src.numCalls;
+		dest.numDrawCalls += src.numDrawCalls;
+		dest.numInstances += src.numInstances;
+		dest.numVertices += src.numVertices;
+		dest.uploadedBytes += src.uploadedBytes;
+		dest.numMappings += src.numMappings;
+		dest.numFences += src.numFences;
+		dest.numFenceWaits += src.numFenceWaits;
+	}
+
+	GLuint *bufferBinding(GLenum target)
+	{
+		switch (target)
+		{
+			case GL_ARRAY_BUFFER: return &boundBuffers[BufferTarget::ARRAY_BUFFER];
+			case GL_ELEMENT_ARRAY_BUFFER:
+			{
+				VertexArray *vertexArray = vertexArrays.find(boundVertexArray);
+				return (vertexArray != nullptr) ? &vertexArray->elementArrayBuffer : &defaultElementArrayBuffer;
+			}
+			case GL_UNIFORM_BUFFER: return &boundBuffers[BufferTarget::UNIFORM_BUFFER];
+			case GL_TEXTURE_BUFFER: return &boundBuffers[BufferTarget::TEXTURE_BUFFER];
+			case GL_PIXEL_PACK_BUFFER: return &boundBuffers[BufferTarget::PIXEL_PACK_BUFFER];
+			case GL_PIXEL_UNPACK_BUFFER: return &boundBuffers[BufferTarget::PIXEL_UNPACK_BUFFER];
+			case GL_COPY_READ_BUFFER: return &boundBuffers[BufferTarget::COPY_READ_BUFFER];
+			case GL_COPY_WRITE_BUFFER: return &boundBuffers[BufferTarget::COPY_WRITE_BUFFER];
+			default: return nullptr;
+		}
+	}
+
+	Buffer *boundBuffer(GLenum target)
+	{
+		const GLuint *binding = bufferBinding(target);
+		return (binding != nullptr) ? buffers.find(*binding) : nullptr;
+	}
+
+	void allocateStorage(GLenum target, GLsizeiptr size)
+	{
+		Buffer *buffer = boundBuffer(target);
+		if (buffer == nullptr)
+			return;
+
+		// The content of the buffer is never read back, the previous storage is not preserved
+		if (buffer->size != size)
+		{
+			delete[] buffer->data;
+			buffer->data = (size > 0) ? new GLubyte[size] : nullptr;
+			buffer->size = size;
+		}
+	}
+
+	void unbindBuffer(GLuint name)
+	{
+		for (unsigned int i = 0; i < BufferTarget::COUNT; i++)
+		{
+			if (boundBuffers[i] == name)
+				boundBuffers[i] = 0;
+		}
+		if (defaultElementArrayBuffer == name)
+			defaultElementArrayBuffer = 0;
+		VertexArray *vertexArray = vertexArrays.find(boundVertexArray);
+		if (vertexArray != nullptr && vertexArray->elementArrayBuffer == name)
+			vertexArray->elementArrayBuffer = 0;
+	}
+
+	void releaseShader(GLuint name)
+	{
+		Shader *shader = shaders.find(name);
+		if (shader != nullptr && shader->deletePending && shader->numAttachments == 0)
+			shaders.destroy(name);
+	}
+
+	void genNames(ObjectTable<NamedObject> &table, GLsizei n, GLuint *names)
+	{
+		for (GLsizei i = 0; i < n; i++)
+			names[i] = table.create();
+	}
+
+	void deleteNames(ObjectTable<NamedObject> &table, GLsizei n, const GLuint *names)
+	{
+		for (GLsizei i = 0; i < n; i++)
+			table.destroy(names[i]);
+	}
+
+	/// Copies a string to an application buffer, truncating it if needed
+	void copyString(const char *string, GLsizei bufSize, GLsizei *length, GLchar *dest)
+	{
+		GLsizei copied = 0;
+		if (bufSize > 0 && dest != nullptr)
+		{
+			const GLsizei stringLength = static_cast<GLsizei>(strlen(string));
+			copied = (stringLength < bufSize - 1) ? stringLength : bufSize - 1;
+			memcpy(dest, string, copied);
+			dest[copied] = '\0';
+		}
+		if (length != nullptr)
+			*length = copied;
+	}
+
+	unsigned long pixelDataSize(GLsizei width, GLsizei height, GLenum format, GLenum type)
+	{
+		unsigned int numComponents = 4;
+		switch (format)
+		{
+			case GL_RED:
+			case GL_RED_INTEGER:
+			case GL_DEPTH_COMPONENT:
+				numComponents = 1;
+				break;
+			case GL_RG:
+			case GL_RG_INTEGER:
+			case GL_DEPTH_STENCIL:
+				numComponents = 2;
+				break;
+			case GL_RGB:
+			case GL_RGB_INTEGER:
+				numComponents = 3;
+				break;
+			default:
+				break;
+		}
+
+		unsigned int componentSize = 1;
+		switch (type)
+		{
+			case GL_UNSIGNED_SHORT:
+			case GL_SHORT:
+			case GL_HALF_FLOAT:
+				componentSize = 2;
+				break;
+			case GL_UNSIGNED_INT:
+			case GL_INT:
+			case GL_FLOAT:
+				componentSize = 4;
+				break;
+			case GL_UNSIGNED_SHORT_5_6_5:
+			case GL_UNSIGNED_SHORT_4_4_4_4:
+			case GL_UNSIGNED_SHORT_5_5_5_1:
+				// Packed types store all the components of a pixel together
+				numComponents = 1;
+				componentSize = 2;
+				break;
+			default:
+				break;
+		}
+
+		return static_cast<unsigned long>(width) * static_cast<unsigned long>(height) * numComponents * componentSize;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void NullGL::nextFrame()
+{
+	lastFrameCounters = frameCounters;
+	addCounters(totalCounters, frameCounters);
+	frameCounters = Counters();
+	frameIndex++;
+}
+
+void NullGL::setFenceLatency(unsigned int numFrames)
+{
+	ncine::fenceLatency = numFrames;
+}
+
+unsigned int NullGL::fenceLatency()
+{
+	return ncine::fenceLatency;
+}
+
+NullGL::Counters NullGL::lastFrame()
+{
+	return lastFrameCounters;
+}
+
+NullGL::Counters NullGL::total()
+{
+	Counters counters = totalCounters;
+	addCounters(counters, frameCounters);
+	return counters;
+}
+
+}
+
+using ncine::buffers;
+using ncine::vertexArrays;
+using ncine::shaders;
+using ncine::programs;
+using ncine::textures;
+using ncine::framebuffers;
+using ncine::renderbuffers;
+using ncine::syncs;
+using ncine::frameCounters;
+using ncine::countCall;
+using ncine::countDraw;
+
+///////////////////////////////////////////////////////////
+// STATE AND QUERIES
+///////////////////////////////////////////////////////////
+
+GLenum APIENTRY glGetError()
+{
+	countCall();
+	return GL_NO_ERROR;
+}
+
+const GLubyte *APIENTRY glGetString(GLenum name)
+{
+	countCall();
+	const char *string = nullptr;
+	switch (name)
+	{
+		case GL_VENDOR: string = ncine::VendorString; break;
+		case GL_RENDERER: string = ncine::RendererString; break;
+		case GL_VERSION: string = ncine::VersionString; break;
+		case GL_SHADING_LANGUAGE_VERSION: string = ncine::GlslVersionString; break;
+		default: break;
+	}
+	return reinterpret_cast<const GLubyte *>(string);
+}
+
+const GLubyte *APIENTRY glGetStringi(GLenum name, GLuint index)
+{
+	countCall();
+	if (name == GL_EXTENSIONS && index < ncine::NumExtensions)
+		return reinterpret_cast<const GLubyte *>(ncine::Extensions[index]);
+	return nullptr;
+}
+
+void APIENTRY glGetIntegerv(GLenum pname, GLint *params)
+{
+	countCall();
+	switch (pname)
+	{
+		case GL_MAJOR_VERSION: *params = 4; break;
+		case GL_MINOR_VERSION: *params = 5; break;
+		case GL_MAX_TEXTURE_SIZE: *params = 16384; break;
+		case GL_MAX_TEXTURE_IMAGE_UNITS: *params = 32; break;
+		case GL_MAX_UNIFORM_BLOCK_SIZE: *params = 65536; break;
+		case GL_MAX_UNIFORM_BUFFER_BINDINGS: *params = 72; break;
+		case GL_MAX_VERTEX_UNIFORM_BLOCKS: *params = 14; break;
+		case GL_MAX_FRAGMENT_UNIFORM_BLOCKS: *params = 14; break;
+		case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT: *params = 256; break;
+		case GL_MAX_VERTEX_ATTRIB_STRIDE: *params = 2048; break;
+		case GL_MAX_COLOR_ATTACHMENTS: *params = 8; break;
+		case GL_MAX_TEXTURE_BUFFER_SIZE: *params = 134217728; break;
+		case GL_MAX_LABEL_LENGTH: *params = 256; break;
+		case GL_NUM_EXTENSIONS: *params = static_cast<GLint>(ncine::NumExtensions); break;
+		default: *params = 0; break;
+	}
+}
+
+void APIENTRY glEnable(GLenum cap) { countCall(); }
+void APIENTRY glDisable(GLenum cap) { countCall(); }
+void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) { countCall(); }
+void APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) { countCall(); }
+void APIENTRY glCullFace(GLenum mode) { countCall(); }
+void APIENTRY glDepthMask(GLboolean flag) { countCall(); }
+void APIENTRY glClear(GLbitfield mask) { countCall(); }
+void APIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) { countCall(); }
+void APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) { countCall(); }
+void APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height) { countCall(); }
+void APIENTRY glPixelStorei(GLenum pname, GLint param) { countCall(); }
+
+///////////////////////////////////////////////////////////
+// DEBUG
+///////////////////////////////////////////////////////////
+
+void APIENTRY glDebugMessageCallback(GLDEBUGPROC callback, const void *userParam) { countCall(); }
+void APIENTRY glDebugMessageInsert(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *buf) { countCall(); }
+void APIENTRY glPushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar *message) { countCall(); }
+void APIENTRY glPopDebugGroup() { countCall(); }
+void APIENTRY glObjectLabel(GLenum identifier, GLuint name, GLsizei length, const GLchar *label) { countCall(); }
+
+void APIENTRY glGetObjectLabel(GLenum identifier, GLuint name, GLsizei bufSize, GLsizei *length, GLchar *label)
+{
+	countCall();
+	ncine::copyString("", bufSize, length, label);
+}
+
+///////////////////////////////////////////////////////////
+// SYNC OBJECTS
+///////////////////////////////////////////////////////////
+
+GLsync APIENTRY glFenceSync(GLenum condition, GLbitfield flags)
+{
+	countCall();
+	frameCounters.numFences++;
+	// The handle of a fence is the name of its sync object
+	const GLuint name = syncs.create();
+	syncs.find(name)->frame = ncine::frameIndex;
+	return reinterpret_cast<GLsync>(static_cast<uintptr_t>(name));
+}
+
+void APIENTRY glDeleteSync(GLsync sync)
+{
+	countCall();
+	syncs.destroy(static_cast<GLuint>(reinterpret_cast<uintptr_t>(sync)));
+}
+
+GLenum APIENTRY glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+	countCall();
+	ncine::Sync *syncObject = syncs.find(static_cast<GLuint>(reinterpret_cast<uintptr_t>(sync)));
+	if (syncObject == nullptr)
+		return GL_WAIT_FAILED;
+
+	if (syncObject->signaled || ncine::frameIndex - syncObject->frame >= ncine::fenceLatency)
+		return GL_ALREADY_SIGNALED;
+	else if (timeout == 0)
+		return GL_TIMEOUT_EXPIRED;
+
+	// The emulated GPU catches up while the client is waiting
+	frameCounters.numFenceWaits++;
+	syncObject->signaled = true;
+	return GL_CONDITION_SATISFIED;
+}
+
+///////////////////////////////////////////////////////////
+// BUFFERS AND VERTEX ARRAYS
+///////////////////////////////////////////////////////////
+
+void APIENTRY glGenBuffers(GLsizei n, GLuint *names)
+{
+	countCall();
+	for (GLsizei i = 0; i < n; i++)
+		names[i] = buffers.create();
+}
+
+void APIENTRY glDeleteBuffers(GLsizei n, const GLuint *names)
+{
+	countCall();
+	for (GLsizei i = 0; i < n; i++)
+	{
+		ncine::Buffer *buffer = buffers.find(names[i]);
+		if (buffer != nullptr)
+		{
+			delete[] buffer->data;
+			ncine::unbindBuffer(names[i]);
+			buffers.destroy(names[i]);
+		}
+	}
+}
+
+void APIENTRY glBindBuffer(GLenum target, GLuint buffer)
+{
+	countCall();
+	GLuint *binding = ncine::bufferBinding(target);
+	if (binding != nullptr)
+		*binding = buffer;
+}
+
+void APIENTRY glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+	// Binding to an indexed point also binds to the generic one
+	glBindBuffer(target, buffer);
+}
+
+void APIENTRY glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+{
+	glBindBuffer(target, buffer);
+}
+
+void APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage)
+{
+	countCall();
+	ncine::allocateStorage(target, size);
+	if (data != nullptr)
+		frameCounters.uploadedBytes += static_cast<unsigned long>(size);
+}
+
+void APIENTRY glBufferStorage(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags)
+{
+	glBufferData(target, size, data, GL_NONE);
+}
+
+void APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data)
+{
+	countCall();
+	frameCounters.uploadedBytes += static_cast<unsigned long>(size);
+}
+
+void *APIENTRY glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+	countCall();
+	ncine::Buffer *buffer = ncine::boundBuffer(target);
+	if (buffer == nullptr || buffer->data == nullptr || offset + length > buffer->size)
+		return nullptr;
+
+	frameCounters.numMappings++;
+	// Without explicit flushing the whole range is considered modified
+	if ((access & GL_MAP_WRITE_BIT) && (access & GL_MAP_FLUSH_EXPLICIT_BIT) == 0)
+		frameCounters.uploadedBytes += static_cast<unsigned long>(length);
+	return buffer->data + offset;
+}
+
+void APIENTRY glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length)
+{
+	countCall();
+	frameCounters.uploadedBytes += static_cast<unsigned long>(length);
+}
+
+GLboolean APIENTRY glUnmapBuffer(GLenum target)
+{
+	countCall();
+	return GL_TRUE;
+}
+
+void APIENTRY glGenVertexArrays(GLsizei n, GLuint *names)
+{
+	countCall();
+	for (GLsizei i = 0; i < n; i++)
+		names[i] = vertexArrays.create();
+}
+
+void APIENTRY glDeleteVertexArrays(GLsizei n, const GLuint *names)
+{
+	countCall();
+	for (GLsizei i = 0; i < n; i++)
+	{
+		if (ncine::boundVertexArray == names[i])
+			ncine::boundVertexArray = 0;
+		vertexArrays.destroy(names[i]);
+	}
+}
+
+void APIENTRY glBindVertexArray(GLuint array)
+{
+	countCall();
+	ncine::boundVertexArray = array;
+}
+
+void APIENTRY glEnableVertexAttribArray(GLuint index) { countCall(); }
+void APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { countCall(); }
+void APIENTRY glVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void *pointer) { countCall(); }
+
+///////////////////////////////////////////////////////////
+// TEXTURES
+///////////////////////////////////////////////////////////
+
+void APIENTRY glGenTextures(GLsizei n, GLuint *names)
+{
+	countCall();
+	ncine::genNames(textures, n, names);
+}
+
+void APIENTRY glDeleteTextures(GLsizei n, const GLuint *names)
+{
+	countCall();
+	ncine::deleteNames(textures, n, names);
+}
+
+void APIENTRY glActiveTexture(GLenum texture) { countCall(); }
+void APIENTRY glBindTexture(GLenum target, GLuint texture) { countCall(); }
+void APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param) { countCall(); }
+void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) { countCall(); }
+void APIENTRY glTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) { countCall(); }
+void APIENTRY glTexBuffer(GLenum target, GLenum internalformat, GLuint buffer) { countCall(); }
+
+void APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	countCall();
+	if (pixels != nullptr)
+		frameCounters.uploadedBytes += ncine::pixelDataSize(width, height, format, type);
+}
+
+void APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	countCall();
+	frameCounters.uploadedBytes += ncine::pixelDataSize(width, height, format, type);
+}
+
+void APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data)
+{
+	countCall();
+	if (data != nullptr)
+		frameCounters.uploadedBytes += static_cast<unsigned long>(imageSize);
+}
+
+void APIENTRY glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data)
+{
+	countCall();
+	frameCounters.uploadedBytes += static_cast<unsigned long>(imageSize);
+}
+
+void APIENTRY glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, GLvoid *pixels)
+{
+	// The content of textures is not stored, the pixels are left untouched
+	countCall();
+}
+
+///////////////////////////////////////////////////////////
+// FRAMEBUFFERS
+///////////////////////////////////////////////////////////
+
+void APIENTRY glGenFramebuffers(GLsizei n, GLuint *names)
+{
+	countCall();
+	ncine::genNames(framebuffers, n, names);
+}
+
+void APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint *names)
+{
+	countCall();
+	ncine::deleteNames(framebuffers, n, names);
+}
+
+void APIENTRY glGenRenderbuffers(GLsizei n, GLuint *names)
+{
+	countCall();
+	ncine::genNames(renderbuffers, n, names);
+}
+
+void APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint *names)
+{
+	countCall();
+	ncine::deleteNames(renderbuffers, n, names);
+}
+
+void APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer) { countCall(); }
+void APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer) { countCall(); }
+void APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) { countCall(); }
+void APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) { countCall(); }
+void APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) { countCall(); }
+void APIENTRY glDrawBuffers(GLsizei n, const GLenum *bufs) { countCall(); }
+void APIENTRY glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum *attachments) { countCall(); }
+
+GLenum APIENTRY glCheckFramebufferStatus(GLenum target)
+{
+	countCall();
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+///////////////////////////////////////////////////////////
+// SHADERS AND PROGRAMS
+///////////////////////////////////////////////////////////
+
+GLuint APIENTRY glCreateShader(GLenum type)
+{
+	countCall();
+	const GLuint name = shaders.create();
+	shaders.find(name)->type = type;
+	return name;
+}
+
+void APIENTRY glDeleteShader(GLuint shader)
+{
+	countCall();
+	ncine::Shader *shaderObject = shaders.find(shader);
+	if (shaderObject != nullptr)
+	{
+		shaderObject->deletePending = true;
+		ncine::releaseShader(shader);
+	}
+}
+
+void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length)
+{
+	countCall();
+	ncine::Shader *shaderObject = shaders.find(shader);
+	if (shaderObject == nullptr)
+		return;
+
+	shaderObject->source.clear();
+	for (GLsizei i = 0; i < count; i++)
+	{
+		if (length != nullptr && length[i] >= 0)
+			shaderObject->source.replace(string[i], static_cast<unsigned int>(length[i]), shaderObject->source.length());
+		else
+			shaderObject->source.append(string[i]);
+	}
+}
+
+void APIENTRY glCompileShader(GLuint shader) { countCall(); }
+
+void APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+	countCall();
+	const ncine::Shader *shaderObject = shaders.find(shader);
+	switch (pname)
+	{
+		case GL_COMPILE_STATUS: *params = GL_TRUE; break;
+		case GL_DELETE_STATUS: *params = (shaderObject != nullptr && shaderObject->deletePending) ? GL_TRUE : GL_FALSE; break;
+		case GL_SHADER_TYPE: *params = (shaderObject != nullptr) ? static_cast<GLint>(shaderObject->type) : 0; break;
+		case GL_SHADER_SOURCE_LENGTH: *params = (shaderObject != nullptr) ? static_cast<GLint>(shaderObject->source.length() + 1) : 0; break;
+		default: *params = 0; break;
+	}
+}
+
+void APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	countCall();
+	ncine::copyString("", bufSize, length, infoLog);
+}
+
+GLuint APIENTRY glCreateProgram()
+{
+	countCall();
+	return programs.create();
+}
+
+void APIENTRY glDeleteProgram(GLuint program)
+{
+	countCall();
+	ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr)
+		return;
+
+	// Deleting a program detaches its shaders
+	for (unsigned int i = 0; i < programObject->shaders.size(); i++)
+	{
+		ncine::Shader *shaderObject = shaders.find(programObject->shaders[i]);
+		if (shaderObject != nullptr)
+		{
+			shaderObject->numAttachments--;
+			ncine::releaseShader(programObject->shaders[i]);
+		}
+	}
+	programs.destroy(program);
+}
+
+void APIENTRY glAttachShader(GLuint program, GLuint shader)
+{
+	countCall();
+	ncine::Program *programObject = programs.find(program);
+	ncine::Shader *shaderObject = shaders.find(shader);
+	if (programObject != nullptr && shaderObject != nullptr)
+	{
+		programObject->shaders.pushBack(shader);
+		shaderObject->numAttachments++;
+	}
+}
+
+void APIENTRY glDetachShader(GLuint program, GLuint shader)
+{
+	countCall();
+	ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < programObject->shaders.size(); i++)
+	{
+		if (programObject->shaders[i] == shader)
+		{
+			programObject->shaders.removeAt(i);
+			ncine::Shader *shaderObject = shaders.find(shader);
+			if (shaderObject != nullptr)
+			{
+				shaderObject->numAttachments--;
+				ncine::releaseShader(shader);
+			}
+			break;
+		}
+	}
+}
+
+void APIENTRY glLinkProgram(GLuint program)
+{
+	countCall();
+	ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr)
+		return;
+
+	programObject->interface.clear();
+	for (unsigned int i = 0; i < programObject->shaders.size(); i++)
+	{
+		const ncine::Shader *shaderObject = shaders.find(programObject->shaders[i]);
+		if (shaderObject != nullptr)
+			programObject->interface.parseShader(shaderObject->type, shaderObject->source.data());
+	}
+}
+
+void APIENTRY glValidateProgram(GLuint program) { countCall(); }
+void APIENTRY glUseProgram(GLuint program) { countCall(); }
+
+void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr)
+	{
+		*params = 0;
+		return;
+	}
+
+	const ncine::NullGLProgram &interface = programObject->interface;
+	switch (pname)
+	{
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS:
+			*params = GL_TRUE;
+			break;
+		case GL_ATTACHED_SHADERS: *params = static_cast<GLint>(programObject->shaders.size()); break;
+		case GL_ACTIVE_UNIFORMS: *params = static_cast<GLint>(interface.uniforms().size()); break;
+		case GL_ACTIVE_UNIFORM_BLOCKS: *params = static_cast<GLint>(interface.uniformBlocks().size()); break;
+		case GL_ACTIVE_ATTRIBUTES: *params = static_cast<GLint>(interface.attributes().size()); break;
+		default: *params = 0; break;
+	}
+}
+
+void APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	countCall();
+	ncine::copyString("", bufSize, length, infoLog);
+}
+
+///////////////////////////////////////////////////////////
+// PROGRAM INTERFACE
+///////////////////////////////////////////////////////////
+
+void APIENTRY glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr || index >= programObject->interface.uniforms().size())
+	{
+		ncine::copyString("", bufSize, length, name);
+		return;
+	}
+
+	const ncine::NullGLProgram::Uniform &uniform = programObject->interface.uniforms()[index];
+	ncine::copyString(uniform.name.data(), bufSize, length, name);
+	*size = uniform.size;
+	*type = uniform.type;
+}
+
+void APIENTRY glGetActiveUniformName(GLuint program, GLuint uniformIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformName)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject != nullptr && uniformIndex < programObject->interface.uniforms().size())
+		ncine::copyString(programObject->interface.uniforms()[uniformIndex].name.data(), bufSize, length, uniformName);
+	else
+		ncine::copyString("", bufSize, length, uniformName);
+}
+
+void APIENTRY glGetActiveUniformsiv(GLuint program, GLsizei uniformCount, const GLuint *uniformIndices, GLenum pname, GLint *params)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	for (GLsizei i = 0; i < uniformCount; i++)
+	{
+		params[i] = 0;
+		if (programObject == nullptr || uniformIndices[i] >= programObject->interface.uniforms().size())
+			continue;
+
+		const ncine::NullGLProgram::Uniform &uniform = programObject->interface.uniforms()[uniformIndices[i]];
+		switch (pname)
+		{
+			case GL_UNIFORM_TYPE: params[i] = static_cast<GLint>(uniform.type); break;
+			case GL_UNIFORM_SIZE: params[i] = uniform.size; break;
+			case GL_UNIFORM_NAME_LENGTH: params[i] = static_cast<GLint>(uniform.name.length() + 1); break;
+			case GL_UNIFORM_BLOCK_INDEX: params[i] = uniform.blockIndex; break;
+			case GL_UNIFORM_OFFSET: params[i] = uniform.offset; break;
+			case GL_UNIFORM_ARRAY_STRIDE: params[i] = uniform.arrayStride; break;
+			case GL_UNIFORM_MATRIX_STRIDE: params[i] = uniform.matrixStride; break;
+			default: break;
+		}
+	}
+}
+
+GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar *name)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	return (programObject != nullptr) ? programObject->interface.uniformLocation(name) : -1;
+}
+
+void APIENTRY glGetActiveUniformBlockiv(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint *params)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr || uniformBlockIndex >= programObject->interface.uniformBlocks().size())
+	{
+		*params = 0;
+		return;
+	}
+
+	const ncine::NullGLProgram::UniformBlock &block = programObject->interface.uniformBlocks()[uniformBlockIndex];
+	switch (pname)
+	{
+		case GL_UNIFORM_BLOCK_BINDING: *params = static_cast<GLint>(block.binding); break;
+		case GL_UNIFORM_BLOCK_DATA_SIZE: *params = block.dataSize; break;
+		case GL_UNIFORM_BLOCK_NAME_LENGTH: *params = static_cast<GLint>(block.name.length() + 1); break;
+		case GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS: *params = static_cast<GLint>(block.uniformIndices.size()); break;
+		case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES:
+			for (unsigned int i = 0; i < block.uniformIndices.size(); i++)
+				params[i] = block.uniformIndices[i];
+			break;
+		case GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER:
+		case GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER:
+			*params = GL_TRUE;
+			break;
+		default: *params = 0; break;
+	}
+}
+
+void APIENTRY glGetActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei *length, GLchar *uniformBlockName)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject != nullptr && uniformBlockIndex < programObject->interface.uniformBlocks().size())
+		ncine::copyString(programObject->interface.uniformBlocks()[uniformBlockIndex].name.data(), bufSize, length, uniformBlockName);
+	else
+		ncine::copyString("", bufSize, length, uniformBlockName);
+}
+
+void APIENTRY glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+	countCall();
+	ncine::Program *programObject = programs.find(program);
+	if (programObject != nullptr && uniformBlockIndex < programObject->interface.uniformBlocks().size())
+		programObject->interface.uniformBlocks()[uniformBlockIndex].binding = uniformBlockBinding;
+}
+
+void APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	if (programObject == nullptr || index >= programObject->interface.attributes().size())
+	{
+		ncine::copyString("", bufSize, length, name);
+		return;
+	}
+
+	const ncine::NullGLProgram::Attribute &attribute = programObject->interface.attributes()[index];
+	ncine::copyString(attribute.name.data(), bufSize, length, name);
+	*size = attribute.size;
+	*type = attribute.type;
+}
+
+GLint APIENTRY glGetAttribLocation(GLuint program, const GLchar *name)
+{
+	countCall();
+	const ncine::Program *programObject = programs.find(program);
+	return (programObject != nullptr) ? programObject->interface.attributeLocation(name) : -1;
+}
+
+void APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat *value) { countCall(); }
+void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat *value) { countCall(); }
+void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat *value) { countCall(); }
+void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat *value) { countCall(); }
+void APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint *value) { countCall(); }
+void APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint *value) { countCall(); }
+void APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint *value) { countCall(); }
+void APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint *value) { countCall(); }
+void APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { countCall(); }
+void APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { countCall(); }
+void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { countCall(); }
+
+///////////////////////////////////////////////////////////
+// DRAWING
+///////////////////////////////////////////////////////////
+
+void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	countCall();
+	countDraw(count, 1);
+}
+
+void APIENTRY glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+{
+	countCall();
+	countDraw(count, instancecount);
+}
+
+void APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+	countCall();
+	countDraw(count, 1);
+}
+
+void APIENTRY glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLint basevertex)
+{
+	countCall();
+	countDraw(count, 1);
+}
+
+void APIENTRY glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount)
+{
+	countCall();
+	countDraw(count, instancecount);
+}
+
+void APIENTRY glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei instancecount, GLint basevertex)
+{
+	countCall();
+	countDraw(count, instancecount);
+}
@@ -0,0 +1,913 @@
+#include <cstring>
+#include <cstdlib> // for strtol()
+#include "common_macros.h"
+#include "NullGLProgram.h"
+
+namespace ncine {
+
+namespace {
+
+	struct BasicType
+	{
+		const char *name;
+		GLenum type;
+		int alignment;
+		int size;
+		/// Number of columns of a matrix, every one of them is laid out as a `vec4`
+		int columns;
+	};
+
+	const BasicType BasicTypes[] = {
+		{ "float", GL_FLOAT, 4, 4, 0 },
+		{ "vec2", GL_FLOAT_VEC2, 8, 8, 0 },
+		{ "vec3", GL_FLOAT_VEC3, 16, 12, 0 },
+		{ "vec4", GL_FLOAT_VEC4, 16, 16, 0 },
+		{ "int", GL_INT, 4, 4, 0 },
+		{ "ivec2", GL_INT_VEC2, 8, 8, 0 },
+		{ "ivec3", GL_INT_VEC3, 16, 12, 0 },
+		{ "ivec4", GL_INT_VEC4, 16, 16, 0 },
+		{ "uint", GL_UNSIGNED_INT, 4, 4, 0 },
+		{ "uvec2", GL_UNSIGNED_INT_VEC2, 8, 8, 0 },
+		{ "uvec3", GL_UNSIGNED_INT_VEC3, 16, 12, 0 },
+		{ "uvec4", GL_UNSIGNED_INT_VEC4, 16, 16, 0 },
+		{ "bool", GL_BOOL, 4, 4, 0 },
+		{ "bvec2", GL_BOOL_VEC2, 8, 8, 0 },
+		{ "bvec3", GL_BOOL_VEC3, 16, 12, 0 },
+		{ "bvec4", GL_BOOL_VEC4, 16, 16, 0 },
+		{ "mat2", GL_FLOAT_MAT2, 16, 32, 2 },
+		{ "mat3", GL_FLOAT_MAT3, 16, 48, 3 },
+		{ "mat4", GL_FLOAT_MAT4, 16, 64, 4 },
+		{ "sampler1D", GL_SAMPLER_1D, 4, 4, 0 },
+		{ "sampler2D", GL_SAMPLER_2D, 4, 4, 0 },
+		{ "sampler3D", GL_SAMPLER_3D, 4, 4, 0 },
+		{ "samplerCube", GL_SAMPLER_CUBE, 4, 4, 0 },
+		{ "sampler2DArray", GL_SAMPLER_2D_ARRAY, 4, 4, 0 },
+		{ "sampler2DShadow", GL_SAMPLER_2D_SHADOW, 4, 4, 0 },
+		{ "samplerBuffer", GL_SAMPLER_BUFFER, 4, 4, 0 },
+		{ "isampler2D", GL_INT_SAMPLER_2D, 4, 4, 0 },
+		{ "isamplerBuffer", GL_INT_SAMPLER_BUFFER, 4, 4, 0 },
+		{ "usampler2D", GL_UNSIGNED_INT_SAMPLER_2D, 4, 4, 0 },
+		{ "usamplerBuffer", GL_UNSIGNED_INT_SAMPLER_BUFFER, 4, 4, 0 }
+	};
+	const unsigned int NumBasicTypes = sizeof(BasicTypes) / sizeof(BasicTypes[0]);
+	/// The type used for unknown type names
+	const int FallbackBasicType = 3;
+
+	const char *Qualifiers[] = { "highp", "mediump", "lowp", "flat", "smooth", "noperspective", "centroid", "invariant", "precise", "const" };
+	const unsigned int NumQualifiers = sizeof(Qualifiers) / sizeof(Qualifiers[0]);
+
+	/// The maximum number of conditional directives that can be nested
+	const unsigned int MaxNesting = 16;
+	/// The maximum number of nested macro expansions
+	const unsigned int MaxExpansionDepth = 8;
+
+	struct Conditional
+	{
+		bool parentActive;
+		bool active;
+		bool taken;
+	};
+
+	inline int alignUp(int value, int alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	inline bool isDigit(char c)
+	{
+		return (c >= '0' && c <= '9');
+	}
+
+	inline bool isIdentifierStart(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+	}
+
+	inline bool isIdentifierChar(char c)
+	{
+		return isIdentifierStart(c) || isDigit(c);
+	}
+
+	inline bool isSpace(char c)
+	{
+		return (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+	}
+
+	inline char *skipSpaces(char *c)
+	{
+		while (*c == ' ' || *c == '\t' || *c == '\r')
+			c++;
+		return c;
+	}
+
+	inline const char *skipSpaces(const char *c)
+	{
+		while (*c == ' ' || *c == '\t' || *c == '\r')
+			c++;
+		return c;
+	}
+
+	inline unsigned int identifierLength(const char *c)
+	{
+		unsigned int length = 0;
+		if (isIdentifierStart(*c))
+		{
+			while (isIdentifierChar(c[length]))
+				length++;
+		}
+		return length;
+	}
+
+	inline bool equals(const char *chars, unsigned int length, const char *string)
+	{
+		return (strlen(string) == length && strncmp(chars, string, length) == 0);
+	}
+
+	/// Appends characters from a source that is terminated not far from them
+	inline void appendChars(nctl::String &string, const char *chars, unsigned int numChars)
+	{
+		string.replace(chars, numChars, string.length());
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+NullGLProgram::NullGLProgram()
+    : nextUniformLocation_(0), nextAttributeLocation_(0), pos_(0)
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void NullGLProgram::clear()
+{
+	uniforms_.clear();
+	uniformBlocks_.clear();
+	attributes_.clear();
+	nextUniformLocation_ = 0;
+	nextAttributeLocation_ = 0;
+}
+
+void NullGLProgram::parseShader(GLenum shaderType, const char *source)
+{
+	ASSERT(source);
+
+	structs_.clear();
+	defines_.clear();
+
+	nctl::String code(static_cast<unsigned int>(strlen(source)) + 1);
+	preprocess(source, code);
+	tokenize(code.data());
+	parseDeclarations(shaderType);
+	tokens_.clear();
+}
+
+GLint NullGLProgram::uniformLocation(const char *name) const
+{
+	const unsigned int nameLength = static_cast<unsigned int>(strlen(name));
+	for (const Uniform &uniform : uniforms_)
+	{
+		if (uniform.blockIndex >= 0)
+			continue;
+
+		// The name of an array can be used with or without the subscript of its first element
+		if (uniform.name == name ||
+		    (uniform.size > 1 && uniform.name.length() == nameLength + 3 && strncmp(uniform.name.data(), name, nameLength) == 0))
+		{
+			return uniform.location;
+		}
+	}
+
+	return -1;
+}
+
+GLint NullGLProgram::attributeLocation(const char *name) const
+{
+	for (const Attribute &attribute : attributes_)
+	{
+		if (attribute.name == name)
+			return attribute.location;
+	}
+
+	return -1;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+/*! Comments are removed, conditional directives are evaluated and object-like macros are expanded */
+void NullGLProgram::preprocess(const char *source, nctl::String &code)
+{
+	nctl::String text(source);
+
+	// Comments are replaced by spaces, newlines are preserved to keep directives on their own lines
+	char *c = text.data();
+	while (*c != '\0')
+	{
+		if (c[0] == '/' && c[1] == '/')
+		{
+			while (*c != '\0' && *c != '\n')
+				*c++ = ' ';
+		}
+		else if (c[0] == '/' && c[1] == '*')
+		{
+			c[0] = ' ';
+			c[1] = ' ';
+			c += 2;
+			while (*c != '\0' && (c[0] != '*' || c[1] != '/'))
+			{
+				if (*c != '\n')
+					*c = ' ';
+				c++;
+			}
+			if (*c != '\0')
+			{
+				c[0] = ' ';
+				c[1] = ' ';
+				c += 2;
+			}
+		}
+		else
+			c++;
+	}
+
+	Conditional conditionals[MaxNesting];
+	unsigned int depth = 0;
+	bool active = true;
+
+	char *line = text.data();
+	while (*line != '\0')
+	{
+		char *lineEnd = line;
+		while (*lineEnd != '\0' && *lineEnd != '\n')
+			lineEnd++;
+		const bool lastLine = (*lineEnd == '\0');
+		*lineEnd = '\0';
+
+		c = skipSpaces(line);
+		if (*c == '#')
+		{
+			c = skipSpaces(c + 1);
+			const char *directive = c;
+			const unsigned int directiveLength = identifierLength(directive);
+			c = skipSpaces(c + directiveLength);
+			const unsigned int nameLength = identifierLength(c);
+
+			if (equals(directive, directiveLength, "ifdef") || equals(directive, directiveLength, "ifndef") || equals(directive, directiveLength, "if"))
+			{
+				bool condition = false;
+				if (equals(directive, directiveLength, "ifdef"))
+					condition = (findDefine(c, nameLength) != nullptr);
+				else if (equals(directive, directiveLength, "ifndef"))
+					condition = (findDefine(c, nameLength) == nullptr);
+				else
+					condition = evaluateCondition(c);
+
+				FATAL_ASSERT_MSG(depth < MaxNesting, "Too many nested conditional directives");
+				conditionals[depth].parentActive = active;
+				conditionals[depth].active = active && condition;
+				conditionals[depth].taken = condition;
+				depth++;
+			}
+			else if (equals(directive, directiveLength, "elif") && depth > 0)
+			{
+				Conditional &conditional = conditionals[depth - 1];
+				if (conditional.taken)
+					conditional.active = false;
+				else
+				{
+					const bool condition = evaluateCondition(c);
+					conditional.active = conditional.parentActive && condition;
+					conditional.taken = condition;
+				}
+			}
+			else if (equals(directive, directiveLength, "else") && depth > 0)
+			{
+				Conditional &conditional = conditionals[depth - 1];
+				conditional.active = conditional.parentActive && conditional.taken == false;
+				conditional.taken = true;
+			}
+			else if (equals(directive, directiveLength, "endif") && depth > 0)
+				depth--;
+			else if (active && equals(directive, directiveLength, "define") && nameLength > 0 && c[nameLength] != '(')
+			{
+				// Only object-like macros are supported
+				nctl::String *value = const_cast<nctl::String *>(findDefine(c, nameLength));
+				if (value == nullptr)
+				{
+					defines_.pushBack(nctl::String(nameLength + 1));
+					appendChars(defines_.back(), c, nameLength);
+					defines_.pushBack(nctl::String());
+					value = &defines_.back();
+				}
+				value->assign(skipSpaces(c + nameLength), lineEnd - skipSpaces(c + nameLength));
+			}
+			else if (active && equals(directive, directiveLength, "undef"))
+			{
+				for (unsigned int i = 0; i < defines_.size(); i += 2)
+				{
+					if (defines_[i].length() == nameLength && strncmp(defines_[i].data(), c, nameLength) == 0)
+						defines_[i].clear();
+				}
+			}
+
+			active = (depth == 0) || conditionals[depth - 1].active;
+		}
+		else if (active)
+		{
+			expandLine(line, static_cast<unsigned int>(lineEnd - line), code, 0);
+			code.append("\n");
+		}
+
+		if (lastLine)
+			break;
+		line = lineEnd + 1;
+	}
+}
+
+/*! Only numbers, defined macros with numeric values and the `defined` operator, optionally negated, are supported */
+bool NullGLProgram::evaluateCondition(const char *expression) const
+{
+	const char *c = skipSpaces(expression);
+	bool negate = false;
+	while (*c == '!')
+	{
+		negate = !negate;
+		c = skipSpaces(c + 1);
+	}
+
+	bool result = false;
+	if (strncmp(c, "defined", 7) == 0 && isIdentifierChar(c[7]) == false)
+	{
+		c = skipSpaces(c + 7);
+		if (*c == '(')
+			c = skipSpaces(c + 1);
+		result = (findDefine(c, identifierLength(c)) != nullptr);
+	}
+	else if (isDigit(*c))
+		result = (strtol(c, nullptr, 0) != 0);
+	else
+	{
+		const nctl::String *value = findDefine(c, identifierLength(c));
+		result = (value != nullptr && strtol(value->data(), nullptr, 0) != 0);
+	}
+
+	return (result != negate);
+}
+
+const nctl::String *NullGLProgram::findDefine(const char *name, unsigned int length) const
+{
+	if (length == 0)
+		return nullptr;
+
+	for (unsigned int i = 0; i < defines_.size(); i += 2)
+	{
+		if (defines_[i].length() == length && strncmp(defines_[i].data(), name, length) == 0)
+			return &defines_[i + 1];
+	}
+
+	return nullptr;
+}
+
+void NullGLProgram::expandLine(const char *line, unsigned int length, nctl::String &output, unsigned int depth) const
+{
+	const char *c = line;
+	const char *end = line + length;
+	while (c < end)
+	{
+		const char *start = c;
+		if (isIdentifierStart(*c))
+		{
+			while (c < end && isIdentifierChar(*c))
+				c++;
+
+			const nctl::String *value = (depth < MaxExpansionDepth) ? findDefine(start, static_cast<unsigned int>(c - start)) : nullptr;
+			if (value != nullptr)
+			{
+				output.append(" ");
+				expandLine(value->data(), value->length(), output, depth + 1);
+				output.append(" ");
+			}
+			else
+				appendChars(output, start, static_cast<unsigned int>(c - start));
+		}
+		else
+		{
+			while (c < end && isIdentifierStart(*c) == false)
+			{
+				// Suffixes of numeric literals are not identifiers
+				if (isDigit(*c))
+				{
+					while (c < end && (isIdentifierChar(*c) || *c == '.'))
+						c++;
+				}
+				else
+					c++;
+			}
+			appendChars(output, start, static_cast<unsigned int>(c - start));
+		}
+	}
+}
+
+void NullGLProgram::tokenize(const char *code)
+{
+	tokens_.clear();
+
+	const char *c = code;
+	while (*c != '\0')
+	{
+		if (isSpace(*c))
+		{
+			c++;
+			continue;
+		}
+
+		Token token;
+		token.start = c;
+		if (isDigit(*c))
+		{
+			while (isIdentifierChar(*c) || *c == '.')
+				c++;
+		}
+		else if (isIdentifierStart(*c))
+		{
+			while (isIdentifierChar(*c))
+				c++;
+		}
+		else
+			c++;
+
+		token.length = static_cast<unsigned int>(c - token.start);
+		tokens_.pushBack(token);
+	}
+}
+
+void NullGLProgram::parseDeclarations(GLenum shaderType)
+{
+	pos_ = 0;
+	GLint location = -1;
+
+	while (hasToken())
+	{
+		if (isToken("layout"))
+		{
+			pos_++;
+			location = parseLayout();
+			continue;
+		}
+
+		if (isToken("struct"))
+		{
+			pos_++;
+			parseStruct();
+		}
+		else if (isToken("uniform"))
+		{
+			pos_++;
+			parseUniform();
+		}
+		else if (shaderType == GL_VERTEX_SHADER && (isToken("in") || isToken("attribute")))
+		{
+			pos_++;
+			parseAttribute(location);
+		}
+		else
+		{
+			bool isQualifier = false;
+			for (unsigned int i = 0; i < NumQualifiers; i++)
+			{
+				if (isToken(Qualifiers[i]))
+				{
+					isQualifier = true;
+					break;
+				}
+			}
+
+			if (isQualifier)
+			{
+				pos_++;
+				continue;
+			}
+			skipStatement();
+		}
+
+		location = -1;
+	}
+}
+
+void NullGLProgram::parseStruct()
+{
+	if (isIdentifier() == false)
+	{
+		skipStatement();
+		return;
+	}
+
+	Struct layout;
+	tokenToString(tokens_[pos_], layout.name);
+	layout.alignment = 0;
+	layout.size = 0;
+	pos_++;
+
+	if (expect("{") == false)
+	{
+		skipStatement();
+		return;
+	}
+	parseMembers(layout);
+
+	// The alignment and the size of a structure are rounded up to the ones of a `vec4`
+	layout.alignment = alignUp(layout.alignment, 16);
+	layout.size = alignUp(layout.size, layout.alignment);
+	structs_.pushBack(nctl::move(layout));
+
+	if (expect(";") == false)
+		skipStatement();
+}
+
+void NullGLProgram::parseMembers(Struct &layout)
+{
+	while (hasToken() && isToken("}") == false)
+	{
+		skipQualifiers();
+		if (isIdentifier() == false)
+		{
+			pos_++;
+			continue;
+		}
+
+		Member member;
+		resolveType(tokens_[pos_], member);
+		pos_++;
+		const unsigned int typeArraySize = parseArraySize();
+
+		do
+		{
+			if (isIdentifier() == false)
+				break;
+
+			tokenToString(tokens_[pos_], member.name);
+			pos_++;
+			const unsigned int arraySize = parseArraySize();
+			member.arraySize = (arraySize > 0) ? arraySize : typeArraySize;
+			addMember(layout, member);
+		} while (expect(","));
+
+		if (expect(";") == false)
+			skipStatement();
+	}
+
+	expect("}");
+}
+
+void NullGLProgram::parseUniform()
+{
+	skipQualifiers();
+	if (isIdentifier() == false)
+	{
+		skipStatement();
+		return;
+	}
+
+	const Token &typeToken = tokens_[pos_];
+	pos_++;
+
+	if (expect("{"))
+	{
+		Struct layout;
+		layout.alignment = 0;
+		layout.size = 0;
+		parseMembers(layout);
+
+		UniformBlock block;
+		tokenToString(typeToken, block.name);
+		block.dataSize = alignUp(layout.size, 16);
+		block.binding = 0;
+
+		// Members of a block with an instance name are prefixed by the block name
+		nctl::String prefix;
+		if (isIdentifier())
+		{
+			prefix = block.name;
+			prefix.append(".");
+			pos_++;
+			parseArraySize();
+		}
+		if (expect(";") == false)
+			skipStatement();
+
+		// A block shared by more than one stage is added only once
+		for (const UniformBlock &uniformBlock : uniformBlocks_)
+		{
+			if (uniformBlock.name == block.name)
+				return;
+		}
+
+		const GLint blockIndex = static_cast<GLint>(uniformBlocks_.size());
+		uniformBlocks_.pushBack(nctl::move(block));
+		for (const Member &member : layout.members)
+			emitUniform(prefix, member, 0, blockIndex);
+		return;
+	}
+
+	Member member;
+	resolveType(typeToken, member);
+	member.offset = 0;
+	const unsigned int typeArraySize = parseArraySize();
+
+	const nctl::String prefix;
+	do
+	{
+		if (isIdentifier() == false)
+			break;
+
+		tokenToString(tokens_[pos_], member.name);
+		pos_++;
+		const unsigned int arraySize = parseArraySize();
+		member.arraySize = (arraySize > 0) ? arraySize : typeArraySize;
+		emitUniform(prefix, member, 0, -1);
+	} while (expect(","));
+
+	// Initializers are skipped too
+	if (expect(";") == false)
+		skipStatement();
+}
+
+void NullGLProgram::parseAttribute(GLint location)
+{
+	skipQualifiers();
+	if (isIdentifier() == false)
+	{
+		skipStatement();
+		return;
+	}
+
+	Member member;
+	resolveType(tokens_[pos_], member);
+	pos_++;
+	const unsigned int typeArraySize = parseArraySize();
+
+	do
+	{
+		if (isIdentifier() == false)
+			break;
+
+		Attribute attribute;
+		tokenToString(tokens_[pos_], attribute.name);
+		pos_++;
+		const unsigned int arraySize = parseArraySize();
+
+		attribute.type = (member.basicType >= 0) ? BasicTypes[member.basicType].type : GL_FLOAT_VEC4;
+		attribute.size = (arraySize > 0) ? static_cast<GLint>(arraySize) : ((typeArraySize > 0) ? static_cast<GLint>(typeArraySize) : 1);
+		attribute.location = (location >= 0) ? location : nextAttributeLocation_;
+		nextAttributeLocation_ = attribute.location + attribute.size;
+		location = -1;
+		attributes_.pushBack(attribute);
+	} while (expect(","));
+
+	if (expect(";") == false)
+		skipStatement();
+}
+
+/*! \return The value of the `location` qualifier, or -1 if not specified */
+GLint NullGLProgram::parseLayout()
+{
+	GLint location = -1;
+	if (expect("(") == false)
+		return location;
+
+	while (hasToken() && isToken(")") == false)
+	{
+		if (isToken("location"))
+		{
+			pos_++;
+			if (expect("=") && hasToken())
+			{
+				location = static_cast<GLint>(strtol(tokens_[pos_].start, nullptr, 0));
+				pos_++;
+			}
+		}
+		else
+			pos_++;
+	}
+	expect(")");
+
+	return location;
+}
+
+/*! \return The number of elements of an array subscript, or zero if there is none */
+unsigned int NullGLProgram::parseArraySize()
+{
+	if (expect("[") == false)
+		return 0;
+
+	// The size can be surrounded by parentheses when it comes from a macro
+	unsigned int arraySize = 1;
+	while (hasToken() && isToken("]") == false)
+	{
+		if (isDigit(*tokens_[pos_].start))
+			arraySize = static_cast<unsigned int>(strtol(tokens_[pos_].start, nullptr, 0));
+		pos_++;
+	}
+	expect("]");
+
+	return arraySize;
+}
+
+void NullGLProgram::skipQualifiers()
+{
+	while (hasToken())
+	{
+		if (isToken("layout"))
+		{
+			pos_++;
+			parseLayout();
+			continue;
+		}
+
+		bool isQualifier = false;
+		for (unsigned int i = 0; i < NumQualifiers; i++)
+		{
+			if (isToken(Qualifiers[i]))
+			{
+				isQualifier = true;
+				break;
+			}
+		}
+
+		if (isQualifier == false)
+			break;
+		pos_++;
+	}
+}
+
+/*! Skips a declaration or a function definition, together with its body */
+void NullGLProgram::skipStatement()
+{
+	while (hasToken())
+	{
+		if (isToken(";"))
+		{
+			pos_++;
+			return;
+		}
+		else if (isToken("{"))
+		{
+			unsigned int depth = 0;
+			while (hasToken())
+			{
+				if (isToken("{"))
+					depth++;
+				else if (isToken("}"))
+					depth--;
+				pos_++;
+
+				if (depth == 0)
+					break;
+			}
+			expect(";");
+			return;
+		}
+		pos_++;
+	}
+}
+
+bool NullGLProgram::resolveType(const Token &token, Member &member) const
+{
+	member.basicType = -1;
+	member.structType = -1;
+	member.arraySize = 0;
+	member.offset = 0;
+
+	for (unsigned int i = 0; i < NumBasicTypes; i++)
+	{
+		if (equals(token.start, token.length, BasicTypes[i].name))
+		{
+			member.basicType = static_cast<int>(i);
+			return true;
+		}
+	}
+
+	for (unsigned int i = 0; i < structs_.size(); i++)
+	{
+		if (structs_[i].name.length() == token.length && strncmp(structs_[i].name.data(), token.start, token.length) == 0)
+		{
+			member.structType = static_cast<int>(i);
+			return true;
+		}
+	}
+
+	member.basicType = FallbackBasicType;
+	return false;
+}
+
+int NullGLProgram::alignment(const Member &member) const
+{
+	const int elementAlignment = (member.structType >= 0) ? structs_[member.structType].alignment : BasicTypes[member.basicType].alignment;
+	// Arrays are aligned as a `vec4`
+	return (member.arraySize > 0) ? alignUp(elementAlignment, 16) : elementAlignment;
+}
+
+int NullGLProgram::size(const Member &member) const
+{
+	const int elementSize = (member.structType >= 0) ? structs_[member.structType].size : BasicTypes[member.basicType].size;
+	// The stride of array elements is rounded up to the size of a `vec4`
+	return (member.arraySize > 0) ? alignUp(elementSize, 16) * static_cast<int>(member.arraySize) : elementSize;
+}
+
+void NullGLProgram::addMember(Struct &layout, Member &member) const
+{
+	const int memberAlignment = alignment(member);
+	member.offset = alignUp(layout.size, memberAlignment);
+	layout.size = member.offset + size(member);
+	if (layout.alignment < memberAlignment)
+		layout.alignment = memberAlignment;
+	layout.members.pushBack(member);
+}
+
+void NullGLProgram::emitUniform(const nctl::String &prefix, const Member &member, int baseOffset, GLint blockIndex)
+{
+	nctl::String name = prefix + member.name;
+	if (member.arraySize > 0)
+		name.append("[0]");
+
+	if (member.structType >= 0)
+	{
+		// Structures are flattened into their members, only the first element of an array is reported
+		name.append(".");
+		const Struct &layout = structs_[member.structType];
+		for (const Member &structMember : layout.members)
+			emitUniform(name, structMember, baseOffset + member.offset, blockIndex);
+		return;
+	}
+
+	if (blockIndex < 0)
+	{
+		// A uniform shared by more than one stage is added only once
+		for (const Uniform &uniform : uniforms_)
+		{
+			if (uniform.blockIndex < 0 && uniform.name == name)
+				return;
+		}
+	}
+
+	const BasicType &basicType = BasicTypes[member.basicType];
+	Uniform uniform;
+	uniform.name = name;
+	uniform.type = basicType.type;
+	uniform.size = (member.arraySize > 0) ? static_cast<GLint>(member.arraySize) : 1;
+	uniform.blockIndex = blockIndex;
+
+	if (blockIndex >= 0)
+	{
+		uniform.offset = baseOffset + member.offset;
+		uniform.arrayStride = (member.arraySize > 0) ? alignUp(basicType.size, 16) : 0;
+		uniform.matrixStride = (basicType.columns > 0) ? 16 : 0;
+		uniform.location = -1;
+		uniformBlocks_[blockIndex].uniformIndices.pushBack(static_cast<GLint>(uniforms_.size()));
+	}
+	else
+	{
+		uniform.offset = -1;
+		uniform.arrayStride = -1;
+		uniform.matrixStride = -1;
+		uniform.location = nextUniformLocation_;
+		nextUniformLocation_ += uniform.size;
+	}
+
+	uniforms_.pushBack(uniform);
+}
+
+bool NullGLProgram::isToken(const char *string) const
+{
+	return hasToken() && equals(tokens_[pos_].start, tokens_[pos_].length, string);
+}
+
+bool NullGLProgram::isIdentifier() const
+{
+	return hasToken() && isIdentifierStart(*tokens_[pos_].start);
+}
+
+bool NullGLProgram::expect(const char *string)
+{
+	if (isToken(string))
+	{
+		pos_++;
+		return true;
+	}
+	return false;
+}
+
+void NullGLProgram::tokenToString(const Token &token, nctl::String &string) const
+{
+	string.clear();
+	string.replace(token.start, token.length, 0);
+}
+
+}
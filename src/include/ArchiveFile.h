@@ -0,0 +1,47 @@
+#ifndef CLASS_NCINE_ARCHIVEFILE
+#define CLASS_NCINE_ARCHIVEFILE
+
+#include <nctl/SharedPtr.h>
+#include "IFile.h"
+
+namespace ncine {
+
+/// The class reading a file stored inside a mounted asset archive
+/*! The content is a view of the archive mapping, accessible through `data()` without copies. */
+class ArchiveFile : public IFile
+{
+  public:
+	/// Constructs a file object for a blob of an archive
+	/*! \param archiveHandle The opened handle of the archive, kept alive as long as the file exists */
+	ArchiveFile(const char *filename, const nctl::SharedPtr<IFile> &archiveHandle, const unsigned char *blobData, unsigned long int blobSize);
+	~ArchiveFile() override;
+
+	/// Tries to open the file, only read modes are supported
+	void open(unsigned char mode) override;
+	void close() override;
+	long int seek(long int offset, int whence) const override;
+	long int tell() const override;
+	unsigned long int read(void *buffer, unsigned long int bytes) const override;
+	/// Always fails as archives are read-only
+	unsigned long int write(const void *buffer, unsigned long int bytes) override;
+
+	bool isOpened() const override;
+	inline const unsigned char *data() const override { return isOpened_ ? blobData_ : nullptr; }
+
+  private:
+	nctl::SharedPtr<IFile> archiveHandle_;
+	/// The address of the blob, it is `nullptr` for empty files
+	const unsigned char *blobData_;
+	/// \note Modified by `seek` and `tell` constant methods
+	mutable unsigned long int seekOffset_;
+	bool isOpened_;
+
+	/// Deleted copy constructor
+	ArchiveFile(const ArchiveFile &) = delete;
+	/// Deleted assignment operator
+	ArchiveFile &operator=(const ArchiveFile &) = delete;
+};
+
+}
+
+#endif
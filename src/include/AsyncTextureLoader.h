@@ -0,0 +1,78 @@
+#ifndef CLASS_NCINE_ASYNCTEXTURELOADER
+#define CLASS_NCINE_ASYNCTEXTURELOADER
+
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/Atomic.h>
+#include "Texture.h"
+#include "ITextureLoader.h"
+#include "IThreadPool.h"
+
+namespace ncine {
+
+/// A class that reads and decodes texture files on the job system and uploads them on the main thread
+/*! Decoding does not need an OpenGL context and runs in background jobs, which are never executed by the main thread,
+ *  while uploads are performed in request order by `update()` until the frame time budget has been spent.
+ *  Only a limited number of requests is decoded at the same time, the others wait for their turn in the loader. */
+class AsyncTextureLoader
+{
+  public:
+	AsyncTextureLoader();
+	/// Waits for decoding jobs that are still running
+	~AsyncTextureLoader();
+
+	/// Returns the number of requests that have not been uploaded yet
+	inline unsigned int numPendingRequests() const { return requests_.size(); }
+	/// Returns the number of requests whose decoding job is running or waiting to be executed
+	unsigned int numDecodingRequests();
+	/// Returns the maximum number of requests that are decoded at the same time
+	unsigned int maxDecodingRequests() const;
+
+	/// Requests a texture to be loaded from a file, cancelling any previous request for the same texture
+	void enqueue(Texture *texture, const char *filename, Texture::LoadedCallback callback, void *userData);
+	/// Cancels the request for a texture, the decoded data will be discarded
+	void cancel(Texture *texture);
+	/// Transfers the request of a texture to another one, used when textures are moved
+	void replace(Texture *oldTexture, Texture *newTexture);
+
+	/// Uploads decoded textures until the specified time in milliseconds has elapsed, always at least one
+	void update(float maxUploadTime);
+
+  private:
+	/// A texture loading request, its address does not change while a job is decoding it
+	struct Request
+	{
+		Request(Texture *tex, const char *name, Texture::LoadedCallback func, void *data)
+		    : texture(tex), filename(name), callback(func), userData(data), job(nullptr), isDecoded(0) {}
+
+		/// The texture to upload to, set to `nullptr` when the request is cancelled
+		Texture *texture;
+		nctl::String filename;
+		Texture::LoadedCallback callback;
+		void *userData;
+		/// The decoding job, `nullptr` until the request is submitted to the thread pool
+		JobId job;
+		/// The loader holding decoded pixels, written by the job before raising the flag
+		nctl::UniquePtr<ITextureLoader> texLoader;
+		nctl::Atomic32 isDecoded;
+	};
+
+	nctl::Array<nctl::UniquePtr<Request>> requests_;
+
+	/// Returns the index of the active request for the specified texture or -1 if not found
+	int findRequest(const Texture *texture) const;
+	/// Submits the decoding jobs of the oldest requests until the maximum number of decoding requests is reached
+	void submitDecodingJobs();
+	/// The function executed by the job system to read and decode a texture file
+	static void decodeJob(JobId job, const void *data);
+
+	/// Deleted copy constructor
+	AsyncTextureLoader(const AsyncTextureLoader &) = delete;
+	/// Deleted assignment operator
+	AsyncTextureLoader &operator=(const AsyncTextureLoader &) = delete;
+};
+
+}
+
+#endif
@@ -15,6 +15,7 @@ class AudioReaderWav : public IAudioReader
 	AudioReaderWav(nctl::UniquePtr<IFile> fileHandle);
 
 	unsigned long int read(void *buffer, unsigned long int bufferSize) const override;
+	const unsigned char *samples(unsigned long int bufferSize) const override;
 	void rewind() const override;
 
   private:
@@ -0,0 +1,134 @@
+#ifndef CLASS_NCINE_FONTATLAS
+#define CLASS_NCINE_FONTATLAS
+
+#include <cstdint>
+#include <nctl/Array.h>
+
+namespace ncine {
+
+/// A single channel glyph atlas holding a signed distance field for every glyph, generated at runtime
+/*! Glyphs are added from their coverage bitmaps and then packed in the atlas by a skyline packer.
+ *  The field is encoded with the glyph edge at one half and it extends for `spread` pixels on both sides of the edge,
+ *  every glyph is padded by the same amount. The atlas can be saved to a cache file, together with all the font metrics,
+ *  to skip the generation the next time the same source is loaded. */
+class FontAtlas
+{
+  public:
+	/// The cache file header, all numbers are stored as little endian
+	struct Header
+	{
+		char signature[4];
+		uint16_t version;
+		uint16_t spread;
+		/// The hash of the source data and of the generation settings
+		uint64_t sourceHash;
+		uint32_t width;
+		uint32_t height;
+		uint32_t lineHeight;
+		uint32_t base;
+		uint32_t numGlyphs;
+		uint32_t numKernings;
+	};
+
+	/// A glyph in the atlas, its size and offsets take the padding into account
+	struct Glyph
+	{
+		uint32_t id;
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+		int32_t xOffset;
+		int32_t yOffset;
+		int32_t xAdvance;
+	};
+
+	/// The kerning amount between two glyphs
+	struct Kerning
+	{
+		uint32_t first;
+		uint32_t second;
+		int32_t amount;
+	};
+
+	static const char Signature[4];
+	static const uint16_t Version = 1;
+
+	explicit FontAtlas(unsigned int spread);
+
+	/// Sets the line height and the base of the font
+	void setLineMetrics(unsigned int lineHeight, unsigned int base);
+	/// Computes the distance field of a glyph from its coverage bitmap
+	/*! \param coverage The coverage of the top-left pixel of the glyph, from zero to 255
+	 *  \param pixelStride The distance in bytes between the coverage of two adjacent pixels in a row
+	 *  \param rowStride The distance in bytes between two rows of pixels */
+	void addGlyph(unsigned int id, const unsigned char *coverage, unsigned int pixelStride, unsigned int rowStride,
+	              unsigned int width, unsigned int height, int xOffset, int yOffset, int xAdvance);
+	/// Adds a kerning amount between two glyphs
+	void addKerning(unsigned int first, unsigned int second, int amount);
+
+	/// Packs the glyph fields in the smallest power of two atlas that fits them all
+	/*! \return False if the glyphs do not fit in an atlas of the maximum size */
+	bool pack(unsigned int maxSize);
+
+	/// Saves the packed atlas and the font metrics to a cache file
+	bool saveToFile(const char *filename, uint64_t sourceHash) const;
+	/// Loads the atlas from a cache file, if it exists and it has been generated from the same source
+	bool loadFromFile(const char *filename, uint64_t sourceHash);
+
+	/// Returns the distance in pixels covered by the field on both sides of the glyph edges
+	inline unsigned int spread() const { return spread_; }
+	/// Returns the font line height
+	inline unsigned int lineHeight() const { return lineHeight_; }
+	/// Returns the font base
+	inline unsigned int base() const { return base_; }
+	/// Returns the atlas width, it is zero before packing
+	inline unsigned int width() const { return width_; }
+	/// Returns the atlas height, it is zero before packing
+	inline unsigned int height() const { return height_; }
+	/// Returns the atlas texels, one byte each
+	inline const unsigned char *texels() const { return texels_.data(); }
+
+	/// Returns the number of glyphs
+	inline unsigned int numGlyphs() const { return glyphs_.size(); }
+	/// Returns the glyph at the specified index
+	inline const Glyph &glyph(unsigned int index) const { return glyphs_[index]; }
+	/// Returns the number of kerning pairs
+	inline unsigned int numKernings() const { return kernings_.size(); }
+	/// Returns the kerning pair at the specified index
+	inline const Kerning &kerning(unsigned int index) const { return kernings_[index]; }
+
+  private:
+	unsigned int spread_;
+	unsigned int lineHeight_;
+	unsigned int base_;
+	unsigned int width_;
+	unsigned int height_;
+
+	nctl::Array<Glyph> glyphs_;
+	nctl::Array<Kerning> kernings_;
+	nctl::Array<unsigned char> texels_;
+
+	/// The distance fields of the glyphs waiting to be packed, one after the other
+	nctl::Array<unsigned char> fields_;
+	/// The offset of every glyph field, in the same order as the glyphs
+	nctl::Array<unsigned int> fieldOffsets_;
+
+	/// The squared distances to the inside of the glyph, used by the distance transform
+	nctl::Array<float> outerGrid_;
+	/// The squared distances to the outside of the glyph, used by the distance transform
+	nctl::Array<float> innerGrid_;
+	/// Scratch buffers for the one dimensional distance transform
+	nctl::Array<float> sampledFunction_;
+	nctl::Array<float> parabolaBoundaries_;
+	nctl::Array<int> parabolaVertices_;
+
+	/// Runs the squared distance transform on the columns and then on the rows of a grid
+	void distanceTransform(float *grid, unsigned int width, unsigned int height);
+	/// Runs the one dimensional squared distance transform on a column or on a row of a grid
+	void distanceTransform(float *grid, unsigned int offset, unsigned int stride, unsigned int length);
+};
+
+}
+
+#endif
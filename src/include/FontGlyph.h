@@ -1,7 +1,6 @@
 #ifndef CLASS_NCINE_FONTGLYPH
 #define CLASS_NCINE_FONTGLYPH
 
-#include <nctl/Array.h>
 #include "Rect.h"
 
 namespace ncine {
@@ -27,27 +26,7 @@ class FontGlyph
 	/// Returns the X offset to advance in order to start rendering the next glyph
 	inline int xAdvance() const { return xAdvance_; }
 
-	/// Adds the kerning amount for a subsequent glyph
-	inline void addKerning(unsigned int secondGlyph, int amount) { kernings_.pushBack(Kerning(secondGlyph, amount)); }
-	/// Returns the kerning amount for a subsequent glyph
-	int kerning(unsigned int secondGlyph) const;
-
   private:
-	/// A structure holding glyph pairs kerning offsets
-	struct Kerning
-	{
-		unsigned int secondGlyph_;
-		int amount_;
-
-		Kerning()
-		    : secondGlyph_(0), amount_(0) {}
-		Kerning(unsigned int secondGlyph, int amount)
-		{
-			secondGlyph_ = secondGlyph;
-			amount_ = amount;
-		}
-	};
-
 	unsigned int x_;
 	unsigned int y_;
 	unsigned int width_;
@@ -55,7 +34,6 @@ class FontGlyph
 	int xOffset_;
 	int yOffset_;
 	int xAdvance_;
-	nctl::Array<Kerning> kernings_;
 };
 
 }
@@ -0,0 +1,41 @@
+#ifndef CLASS_NCINE_GLFENCE
+#define CLASS_NCINE_GLFENCE
+
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+
+namespace ncine {
+
+/// A class to handle OpenGL fence sync objects
+class GLFence
+{
+  public:
+	GLFence();
+	~GLFence();
+
+	/// Returns true if a fence has been inserted and not yet deleted
+	inline bool isSet() const { return glHandle_ != nullptr; }
+
+	/// Inserts a new fence in the command stream, replacing the previous one
+	void insert();
+	/// Deletes the fence
+	void reset();
+
+	/// Returns true if all the commands before the fence have been completed, without waiting
+	bool isSignaled();
+	/// Waits until all the commands before the fence have been completed or the timeout in nanoseconds expires
+	/*! \return The status returned by `glClientWaitSync()`, `GL_ALREADY_SIGNALED` if there is no fence */
+	GLenum clientWait(GLuint64 timeout);
+
+  private:
+	GLsync glHandle_;
+
+	/// Deleted copy constructor
+	GLFence(const GLFence &) = delete;
+	/// Deleted assignment operator
+	GLFence &operator=(const GLFence &) = delete;
+};
+
+}
+
+#endif
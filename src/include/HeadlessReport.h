@@ -0,0 +1,74 @@
+#ifndef CLASS_NCINE_HEADLESSREPORT
+#define CLASS_NCINE_HEADLESSREPORT
+
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include "Application.h"
+
+namespace ncine {
+
+/// A class that samples the timings and the statistics of every frame of a headless run and writes them as JSON
+class HeadlessReport
+{
+  public:
+	/// Reserves space for the specified number of frames, zero if it is not known in advance
+	explicit HeadlessReport(unsigned int numFrames);
+
+	/// Samples the timings and the statistics of the frame that has just ended
+	void addFrame();
+	/// Returns the number of sampled frames
+	inline unsigned int numFrames() const { return frameTimes_.size(); }
+
+	/// Writes the report to the specified file, returns false if the file cannot be opened
+	bool write(const char *filename) const;
+
+  private:
+	/// The first timing that is measured every frame
+	static const unsigned int FirstFrameTiming = Application::Timings::FRAME_START;
+	static const unsigned int NumFrameTimings = Application::Timings::COUNT - FirstFrameTiming;
+
+	struct Counters
+	{
+		enum Enum
+		{
+			COMMANDS,
+			TRANSPARENTS,
+			VERTICES,
+			INSTANCES,
+			CULLED_NODES,
+
+			GL_CALLS,
+			GL_DRAW_CALLS,
+			GL_INSTANCES,
+			GL_VERTICES,
+			GL_UPLOADED_BYTES,
+			GL_MAPPINGS,
+
+			ALLOCATIONS,
+			ALLOCATED_BYTES,
+
+			COUNT
+		};
+	};
+
+	/// The frame intervals in seconds
+	nctl::Array<float> frameTimes_;
+	/// The per-frame timings in seconds, from `FRAME_START` to `FRAME_END`
+	nctl::Array<float> frameTimings_[NumFrameTimings];
+
+	unsigned long counterSums_[Counters::COUNT];
+	unsigned long counterMaxs_[Counters::COUNT];
+
+	/// Deleted copy constructor
+	HeadlessReport(const HeadlessReport &) = delete;
+	/// Deleted assignment operator
+	HeadlessReport &operator=(const HeadlessReport &) = delete;
+
+	void addCounter(Counters::Enum counter, unsigned long value);
+	void appendSeries(nctl::String &json, const char *name, const nctl::Array<float> &samples, bool isLast) const;
+	void appendCounter(nctl::String &json, const char *name, Counters::Enum counter, bool isLast) const;
+};
+
+}
+
+#endif
@@ -16,6 +16,12 @@ class IAudioReader
 	 * \return Number of bytes read
 	 */
 	virtual unsigned long int read(void *buffer, unsigned long int bufferSize) const = 0;
+	/// Returns a pointer to the audio samples if they can be accessed in memory without decoding or copying
+	/*!
+	 * \param bufferSize Number of bytes that need to be accessible from the pointer
+	 * \return A pointer valid as long as the reader, or `nullptr` if samples need to be read
+	 */
+	virtual const unsigned char *samples(unsigned long int bufferSize) const { return nullptr; }
 
 	/// Resets the audio file seek value
 	virtual void rewind() const = 0;
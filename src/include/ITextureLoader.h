@@ -32,10 +32,18 @@ class ITextureLoader
 	long dataSize(unsigned int mipMapLevel) const;
 	/// Returns the texture format object
 	inline const TextureFormat &texFormat() const { return texFormat_; }
-	/// Returns the pointer to pixel data
-	inline const GLubyte *pixels() const { return pixels_.get(); }
+	/// Returns the pointer to pixel data, `nullptr` for a streamed texture until `readStreamedPixels()` is called
+	inline const GLubyte *pixels() const { return mappedPixels_ ? mappedPixels_ : pixels_.get(); }
 	/// Returns the pointer to pixel data for the specified MIP map level
 	const GLubyte *pixels(unsigned int mipMapLevel) const;
+	/// Returns true if pixel data is not held in memory and each MIP map level is read from the file when needed
+	inline bool isStreamed() const { return isStreamed_; }
+	/// Returns the pixel data for the specified MIP map level, reading it into the buffer if the texture is streamed
+	/*! \note The buffer should be at least `dataSize(mipMapLevel)` bytes long, it is not used if pixel data is in memory */
+	const GLubyte *levelPixels(unsigned int mipMapLevel, GLubyte *levelBuffer) const;
+	/// Reads the whole pixel data of a streamed texture in memory, so that it is accessible through `pixels()`
+	/*! \note Used when the file should not be read at upload time or when the whole data is needed, the loader is marked as not loaded on failure */
+	bool readStreamedPixels();
 
 	/// Returns the proper texture loader according to the memory buffer name extension
 	static nctl::UniquePtr<ITextureLoader> createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
@@ -57,6 +65,10 @@ class ITextureLoader
 	nctl::UniquePtr<unsigned long[]> mipDataSizes_;
 	TextureFormat texFormat_;
 	nctl::UniquePtr<GLubyte[]> pixels_;
+	/// Pixel data read directly from a memory-mapped file, used instead of `pixels_` when not `nullptr`
+	const GLubyte *mappedPixels_;
+	/// A flag indicating that pixel data of GPU-ready formats is read from the file one MIP map level at a time
+	bool isStreamed_;
 
 	/// An empty constructor only used by `TextureLoaderRaw`
 	ITextureLoader();
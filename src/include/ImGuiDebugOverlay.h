@@ -76,6 +76,8 @@ class ImGuiDebugOverlay : public IDebugOverlay
 	float maxUpdateVisitDraw_;
 	unsigned int index_;
 	nctl::String widgetName_;
+	/// The string reused by widgets that compose their text every frame
+	nctl::String auxString_;
 	bool plotAdditionalFrameValues_;
 	bool plotOverlayValues_;
 	nctl::String comboVideoModes_;
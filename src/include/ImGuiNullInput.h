@@ -0,0 +1,17 @@
+#ifndef CLASS_NCINE_IMGUINULLINPUT
+#define CLASS_NCINE_IMGUINULLINPUT
+
+namespace ncine {
+
+/// The class that sets up ImGui for the headless device, no input is ever received
+class ImGuiNullInput
+{
+  public:
+	static void init();
+	static void shutdown();
+	static void newFrame();
+};
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef CLASS_NCINE_JOBPOOL
+#define CLASS_NCINE_JOBPOOL
+
+#include "IThreadPool.h"
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+/// A unit of work executed by a `JobSystem`
+struct Job
+{
+	/// The function to execute
+	IThreadPool::JobFunction function;
+	/// The job that will not finish until this one has
+	Job *parent;
+	/// The number of unfinished jobs, including this one and all of its children
+	nctl::Atomic32 unfinishedJobs;
+	/// The number of continuations to run when this job finishes
+	unsigned int numContinuations;
+	/// The jobs to run when this job finishes
+	Job *continuations[IThreadPool::MaxContinuations];
+	/// A copy of the user data passed to the job function
+	unsigned char data[IThreadPool::MaxJobDataSize];
+};
+
+/// A ring of preallocated jobs, used by a single thread to create jobs without allocating memory
+class JobPool
+{
+  public:
+	/// The number of jobs in the ring, it should be a power of two
+	static const unsigned int Capacity = 4096;
+
+	JobPool();
+
+	/// Returns the next finished job in the ring, initialized with the specified function and data
+	/*! \note Jobs that are still unfinished, like long running ones, are skipped */
+	Job *allocate(IThreadPool::JobFunction function, const void *data, unsigned int dataSize);
+
+  private:
+	nctl::UniquePtr<Job[]> jobs_;
+	/// The total number of allocated jobs, used to find the next one in the ring
+	unsigned int numAllocated_;
+
+	/// Deleted copy constructor
+	JobPool(const JobPool &) = delete;
+	/// Deleted assignment operator
+	JobPool &operator=(const JobPool &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef CLASS_NCINE_JOBQUEUE
+#define CLASS_NCINE_JOBQUEUE
+
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+struct Job;
+
+/// A lock-free work stealing double-ended queue of jobs
+/*! Only the owner thread can push and pop jobs from the bottom, while other threads can steal them from the top.
+ *  The implementation follows the Chase-Lev deque with a fixed capacity. */
+class JobQueue
+{
+  public:
+	/// The maximum number of jobs in the queue, it should be a power of two
+	static const unsigned int Capacity = 4096;
+
+	JobQueue();
+
+	/// Pushes a job at the bottom of the queue, only called by the owner thread
+	/*! \return False if the queue is full */
+	bool push(Job *job);
+	/// Pops a job from the bottom of the queue, only called by the owner thread
+	Job *pop();
+	/// Steals a job from the top of the queue, called by threads other than the owner
+	Job *steal();
+
+  private:
+	nctl::Atomic64 top_;
+	nctl::Atomic64 bottom_;
+	Job *jobs_[Capacity];
+
+	/// Deleted copy constructor
+	JobQueue(const JobQueue &) = delete;
+	/// Deleted assignment operator
+	JobQueue &operator=(const JobQueue &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef CLASS_NCINE_JOBSYSTEM
+#define CLASS_NCINE_JOBSYSTEM
+
+#include "IThreadPool.h"
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+class JobPool;
+class JobQueue;
+
+/// The thread agnostic part of a job system, with a job pool and a work stealing queue for each thread
+/*! Each thread that creates or runs jobs should have a unique index, zero being reserved for the main thread.
+ *  A thread without an index can only create jobs in a job system with more than one queue, using a shared pool
+ *  whose access has to be serialized by the caller. It cannot queue or execute them. */
+class JobSystem
+{
+  public:
+	/// The function called when new jobs are available to be stolen
+	using WakeFunction = void (*)(void *userData);
+	/// The index of a thread that does not belong to any job system
+	static const unsigned int InvalidThreadIndex = ~0U;
+
+	/// Creates a job system for the specified number of threads, including the main one
+	explicit JobSystem(unsigned int numQueues);
+	~JobSystem();
+
+	/// Returns the number of threads that can use the job system, including the main one
+	inline unsigned int numQueues() const { return numQueues_; }
+	/// Returns true if the calling thread has no queue and creates jobs in the shared pool
+	inline bool isForeignThread() const { return (numQueues_ > 1 && threadIndex() >= numQueues_); }
+	/// Sets the function called when new jobs have been queued
+	void setWakeFunction(WakeFunction wakeFunction, void *userData);
+
+	/// Returns the job system index of the calling thread
+	static unsigned int threadIndex();
+	/// Sets the job system index of the calling thread
+	static void setThreadIndex(unsigned int index);
+
+	JobId createJob(IThreadPool::JobFunction jobFunction, const void *data, unsigned int dataSize);
+	JobId createJobAsChild(JobId parent, IThreadPool::JobFunction jobFunction, const void *data, unsigned int dataSize);
+	bool addContinuation(JobId ancestor, JobId continuation);
+	void run(JobId job);
+	static bool isFinished(JobId job);
+	/// Executes a job that has not been queued on the calling thread, then finishes it
+	void execute(Job *job);
+
+	/// Executes a job from the queue of the calling thread or steals one from another queue
+	/*! \return False if there were no jobs to execute */
+	bool executeNext();
+	/// Returns true if there are jobs waiting in any of the queues
+	bool hasQueuedJobs();
+
+	/// Creates the root job of a parallel for, which should then be run and waited for
+	JobId createParallelFor(unsigned int count, unsigned int batchSize, IThreadPool::ParallelForFunction function, const void *data);
+
+  private:
+	unsigned int numQueues_;
+	nctl::UniquePtr<JobPool[]> pools_;
+	nctl::UniquePtr<JobQueue[]> queues_;
+	/// The number of jobs that have been queued but not yet popped or stolen
+	nctl::Atomic32 numQueuedJobs_;
+
+	WakeFunction wakeFunction_;
+	void *wakeUserData_;
+
+	/// Returns the index of the queue for the calling thread
+	unsigned int queueIndex() const;
+	/// Returns the index of the pool for the calling thread, the shared one after the others for a thread without a queue
+	unsigned int poolIndex() const;
+	void finish(Job *job);
+
+	/// Deleted copy constructor
+	JobSystem(const JobSystem &) = delete;
+	/// Deleted assignment operator
+	JobSystem &operator=(const JobSystem &) = delete;
+};
+
+}
+
+#endif
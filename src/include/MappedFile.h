@@ -0,0 +1,51 @@
+#ifndef CLASS_NCINE_MAPPEDFILE
+#define CLASS_NCINE_MAPPEDFILE
+
+#include "IFile.h"
+
+namespace ncine {
+
+/// The class mapping a standard file read-only in memory
+/*! The whole content is accessible through `data()` without copying it in a separate buffer. */
+class MappedFile : public IFile
+{
+  public:
+	/// Constructs a memory-mapped file object
+	/*! \param filename File name including its path */
+	explicit MappedFile(const char *filename);
+	~MappedFile() override;
+
+	/// Tries to open and map the file, only read modes are supported
+	void open(unsigned char mode) override;
+	/// Unmaps and closes the file
+	void close() override;
+	long int seek(long int offset, int whence) const override;
+	long int tell() const override;
+	unsigned long int read(void *buffer, unsigned long int bytes) const override;
+	/// Always fails as the mapping is read-only
+	unsigned long int write(const void *buffer, unsigned long int bytes) override;
+
+	bool isOpened() const override;
+	inline const unsigned char *data() const override { return mappedData_; }
+
+  private:
+	/// The address of the mapping, it is `nullptr` for empty files
+	const unsigned char *mappedData_;
+	/// \note Modified by `seek` and `tell` constant methods
+	mutable unsigned long int seekOffset_;
+	bool isOpened_;
+#ifdef _WIN32
+	/// The file and the mapping object handles
+	void *fileHandle_;
+	void *mappingHandle_;
+#endif
+
+	/// Deleted copy constructor
+	MappedFile(const MappedFile &) = delete;
+	/// Deleted assignment operator
+	MappedFile &operator=(const MappedFile &) = delete;
+};
+
+}
+
+#endif
@@ -37,6 +37,8 @@ class Material
 		TEXTNODE_RED,
 		/// Shader program for TextNode classes with glyph data in all channels (glyphs are colored)
 		TEXTNODE_SPRITE,
+		/// Shader program for TextNode classes with a signed distance field in red channel
+		TEXTNODE_DISTANCE_FIELD,
 		/// Shader program for a batch of Sprite classes
 		BATCHED_SPRITES,
 		/// Shader program for a batch of Sprite classes with grayscale font texture
@@ -55,6 +57,12 @@ class Material
 		BATCHED_TEXTNODES_RED,
 		/// Shader program for a batch of TextNode classes with glyph data in all channels (glyphs are colored)
 		BATCHED_TEXTNODES_SPRITE,
+		/// Shader program for a batch of TextNode classes with a signed distance field in red channel
+		BATCHED_TEXTNODES_DISTANCE_FIELD,
+		/// Shader program for the vertices of all particles of a ParticleSystem
+		PARTICLES,
+		/// Shader program for the vertices of all particles of a ParticleSystem with grayscale texture
+		PARTICLES_GRAY,
 		/// A custom shader program
 		CUSTOM
 	};
@@ -62,6 +70,8 @@ class Material
 	// Shader uniform block and model matrix uniform names
 	static const char *InstanceBlockName;
 	static const char *InstancesBlockName; // for batched shaders
+	static const char *InstancesTextureUniformName; // for batched shaders reading from a texture buffer
+	static const char *InstancesOffsetUniformName; // for batched shaders reading from a texture buffer
 	static const char *ModelMatrixUniformName;
 
 	// Camera related shader uniform names
@@ -0,0 +1,54 @@
+#ifndef CLASS_NCINE_NULLGL
+#define CLASS_NCINE_NULLGL
+
+namespace ncine {
+
+/// The null OpenGL dispatch layer used by the headless graphics device
+/*! The layer defines every OpenGL function called by the engine and replaces the system library at link time.
+ *  No rendering is performed: object names, buffer storage and the interface of shader programs are emulated,
+ *  while calls, draws and uploads are counted for every frame. */
+class NullGL
+{
+  public:
+	/// The number of calls and the amount of work submitted to the dispatch layer
+	struct Counters
+	{
+		Counters()
+		    : numCalls(0), numDrawCalls(0), numInstances(0), numVertices(0), uploadedBytes(0), numMappings(0), numFences(0), numFenceWaits(0) {}
+
+		/// Number of OpenGL functions called
+		unsigned long numCalls;
+		/// Number of draw calls, instanced or not
+		unsigned long numDrawCalls;
+		/// Number of drawn instances, a non-instanced draw counts as one
+		unsigned long numInstances;
+		/// Number of vertices or indices drawn for every instance
+		unsigned long numVertices;
+		/// Number of bytes uploaded to buffers and textures or flushed from mapped ranges
+		unsigned long uploadedBytes;
+		/// Number of buffer ranges mapped
+		unsigned long numMappings;
+		/// Number of fence sync objects inserted
+		unsigned long numFences;
+		/// Number of client waits that had to wait for a fence to be signaled
+		unsigned long numFenceWaits;
+	};
+
+	/// Starts a new frame, the counters of the current one become the last frame ones
+	static void nextFrame();
+
+	/// Sets the number of frames after which a fence is signaled, emulating a GPU that is late by that amount
+	/*! \note With a latency of zero a fence is signaled as soon as it is inserted, a client wait with a timeout always signals it */
+	static void setFenceLatency(unsigned int numFrames);
+	/// Returns the number of frames after which a fence is signaled
+	static unsigned int fenceLatency();
+
+	/// Returns the counters of the last frame
+	static Counters lastFrame();
+	/// Returns the counters of all the frames since the start of the application
+	static Counters total();
+};
+
+}
+
+#endif
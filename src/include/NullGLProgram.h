@@ -0,0 +1,135 @@
+#ifndef CLASS_NCINE_NULLGLPROGRAM
+#define CLASS_NCINE_NULLGLPROGRAM
+
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+#include <nctl/Array.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+/// The interface of a shader program as reported by the null OpenGL dispatch layer
+/*! Uniforms, uniform blocks and vertex attributes are collected by parsing the global declarations
+ *  of the shader sources, members of uniform blocks are laid out following the `std140` rules.
+ *  Every declared variable is considered active, of an array of structures only the first element is reported. */
+class NullGLProgram
+{
+  public:
+	struct Uniform
+	{
+		nctl::String name;
+		GLenum type;
+		GLint size;
+		GLint blockIndex;
+		GLint offset;
+		GLint arrayStride;
+		GLint matrixStride;
+		GLint location;
+	};
+
+	struct UniformBlock
+	{
+		nctl::String name;
+		GLint dataSize;
+		GLuint binding;
+		nctl::Array<GLint> uniformIndices;
+	};
+
+	struct Attribute
+	{
+		nctl::String name;
+		GLenum type;
+		GLint size;
+		GLint location;
+	};
+
+	NullGLProgram();
+
+	/// Removes the interface of a previous link
+	void clear();
+	/// Adds the global declarations of a shader source to the interface
+	void parseShader(GLenum shaderType, const char *source);
+
+	inline const nctl::Array<Uniform> &uniforms() const { return uniforms_; }
+	inline const nctl::Array<UniformBlock> &uniformBlocks() const { return uniformBlocks_; }
+	inline nctl::Array<UniformBlock> &uniformBlocks() { return uniformBlocks_; }
+	inline const nctl::Array<Attribute> &attributes() const { return attributes_; }
+
+	/// Returns the location of a uniform outside of blocks, or -1 if not found
+	GLint uniformLocation(const char *name) const;
+	/// Returns the location of a vertex attribute, or -1 if not found
+	GLint attributeLocation(const char *name) const;
+
+  private:
+	/// A member of a structure or of a uniform block
+	struct Member
+	{
+		nctl::String name;
+		/// Index in the built-in types table, or -1 for a structure
+		int basicType;
+		/// Index in the array of structures, or -1 for a built-in type
+		int structType;
+		/// Number of array elements, zero if the member is not an array
+		unsigned int arraySize;
+		int offset;
+	};
+
+	struct Struct
+	{
+		nctl::String name;
+		nctl::Array<Member> members;
+		int alignment;
+		int size;
+	};
+
+	struct Token
+	{
+		const char *start;
+		unsigned int length;
+	};
+
+	nctl::Array<Uniform> uniforms_;
+	nctl::Array<UniformBlock> uniformBlocks_;
+	nctl::Array<Attribute> attributes_;
+	GLint nextUniformLocation_;
+	GLint nextAttributeLocation_;
+
+	/// Structures declared in the shader being parsed
+	nctl::Array<Struct> structs_;
+	/// Object-like macros defined in the shader being parsed, as name and value pairs
+	nctl::Array<nctl::String> defines_;
+	nctl::Array<Token> tokens_;
+	unsigned int pos_;
+
+	void preprocess(const char *source, nctl::String &code);
+	bool evaluateCondition(const char *expression) const;
+	const nctl::String *findDefine(const char *name, unsigned int length) const;
+	void expandLine(const char *line, unsigned int length, nctl::String &output, unsigned int depth) const;
+	void tokenize(const char *code);
+
+	void parseDeclarations(GLenum shaderType);
+	void parseStruct();
+	void parseMembers(Struct &layout);
+	void parseUniform();
+	void parseAttribute(GLint location);
+	GLint parseLayout();
+	unsigned int parseArraySize();
+	void skipQualifiers();
+	void skipStatement();
+
+	bool resolveType(const Token &token, Member &member) const;
+	int alignment(const Member &member) const;
+	int size(const Member &member) const;
+	void addMember(Struct &layout, Member &member) const;
+	void emitUniform(const nctl::String &prefix, const Member &member, int baseOffset, GLint blockIndex);
+
+	inline bool hasToken() const { return pos_ < tokens_.size(); }
+	bool isToken(const char *string) const;
+	bool isIdentifier() const;
+	bool expect(const char *string);
+	void tokenToString(const Token &token, nctl::String &string) const;
+};
+
+}
+
+#endif
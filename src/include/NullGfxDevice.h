@@ -0,0 +1,56 @@
+#ifndef CLASS_NCINE_NULLGFXDEVICE
+#define CLASS_NCINE_NULLGFXDEVICE
+
+#include "IGfxDevice.h"
+
+namespace ncine {
+
+/// The headless graphics device
+/*! It does not open a window and it renders through the null OpenGL dispatch layer.
+ *  A single virtual monitor is exposed, window operations only update the stored state. */
+class NullGfxDevice : public IGfxDevice
+{
+  public:
+	NullGfxDevice(const WindowMode &windowMode, const GLContextInfo &glContextInfo, const DisplayMode &displayMode);
+
+	inline void setSwapInterval(int interval) override {}
+
+	void setFullScreen(bool fullScreen) override;
+
+	inline int windowPositionX() const override { return windowPosition_.x; }
+	inline int windowPositionY() const override { return windowPosition_.y; }
+	inline const Vector2i windowPosition() const override { return windowPosition_; }
+	void setWindowPosition(int x, int y) override;
+
+	void setWindowSize(int width, int height) override;
+
+	inline void setWindowTitle(const char *windowTitle) override {}
+	inline void setWindowIcon(const char *windowIconFilename) override {}
+
+	const VideoMode &currentVideoMode(unsigned int monitorIndex) const override;
+	bool setVideoMode(unsigned int modeIndex) override;
+
+  private:
+	/// The name of the virtual monitor
+	static const char *MonitorName;
+
+	Vector2i windowPosition_;
+	/// Video mode index to use in full screen
+	unsigned int fsModeIndex_;
+	/// Window size to restore when leaving full screen
+	Vector2i windowedSize_;
+
+	/// Deleted copy constructor
+	NullGfxDevice(const NullGfxDevice &) = delete;
+	/// Deleted assignment operator
+	NullGfxDevice &operator=(const NullGfxDevice &) = delete;
+
+	void updateMonitors() override;
+
+	/// Ends the frame of the null OpenGL dispatch layer
+	void update() override;
+};
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef CLASS_NCINE_NULLINPUTMANAGER
+#define CLASS_NCINE_NULLINPUTMANAGER
+
+#include "IInputManager.h"
+
+namespace ncine {
+
+/// Information about the mouse state of the headless device, no button is ever pressed
+class NullMouseState : public MouseState
+{
+  public:
+	inline bool isLeftButtonDown() const override { return false; }
+	inline bool isMiddleButtonDown() const override { return false; }
+	inline bool isRightButtonDown() const override { return false; }
+	inline bool isFourthButtonDown() const override { return false; }
+	inline bool isFifthButtonDown() const override { return false; }
+};
+
+/// Information about the keyboard state of the headless device, no key is ever pressed
+class NullKeyboardState : public KeyboardState
+{
+  public:
+	inline bool isKeyDown(KeySym key) const override { return false; }
+};
+
+/// Information about the state of a joystick that is never connected
+class NullJoystickState : public JoystickState
+{
+  public:
+	inline bool isButtonPressed(int buttonId) const override { return false; }
+	inline unsigned char hatState(int hatId) const override { return HatState::CENTERED; }
+	inline short int axisValue(int axisId) const override { return 0; }
+	inline float axisNormValue(int axisId) const override { return 0.0f; }
+};
+
+/// The input manager of the headless device, it never dispatches events
+class NullInputManager : public IInputManager
+{
+  public:
+	NullInputManager();
+	~NullInputManager() override;
+
+	inline const MouseState &mouseState() const override { return mouseState_; }
+	inline const KeyboardState &keyboardState() const override { return keyboardState_; }
+
+	inline bool isJoyPresent(int joyId) const override { return false; }
+	inline const char *joyName(int joyId) const override { return nullptr; }
+	inline const char *joyGuid(int joyId) const override { return nullptr; }
+	inline int joyNumButtons(int joyId) const override { return 0; }
+	inline int joyNumHats(int joyId) const override { return 0; }
+	inline int joyNumAxes(int joyId) const override { return 0; }
+	inline const JoystickState &joystickState(int joyId) const override { return nullJoystickState_; }
+
+  private:
+	static NullMouseState mouseState_;
+	static NullKeyboardState keyboardState_;
+	static NullJoystickState nullJoystickState_;
+
+	/// Deleted copy constructor
+	NullInputManager(const NullInputManager &) = delete;
+	/// Deleted assignment operator
+	NullInputManager &operator=(const NullInputManager &) = delete;
+};
+
+}
+
+#endif
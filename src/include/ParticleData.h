@@ -0,0 +1,80 @@
+#ifndef CLASS_NCINE_PARTICLEDATA
+#define CLASS_NCINE_PARTICLEDATA
+
+#include <nctl/UniquePtr.h>
+#include "Vector2.h"
+
+namespace ncine {
+
+/// The structure of arrays storing every particle property of a `ParticleSystem`
+/*! Alive particles are always packed at the beginning of the arrays, in the `[0, numAlive())` range. */
+class ParticleData
+{
+  public:
+	/// Current particles remaining life in seconds
+	nctl::UniquePtr<float[]> life;
+	/// Initial particles remaining life
+	nctl::UniquePtr<float[]> startingLife;
+	/// Particles position on the X axis
+	nctl::UniquePtr<float[]> positionX;
+	/// Particles position on the Y axis
+	nctl::UniquePtr<float[]> positionY;
+	/// Particles velocity on the X axis
+	nctl::UniquePtr<float[]> velocityX;
+	/// Particles velocity on the Y axis
+	nctl::UniquePtr<float[]> velocityY;
+	/// Current particles rotation in degrees
+	nctl::UniquePtr<float[]> rotation;
+	/// Initial particles rotation
+	nctl::UniquePtr<float[]> startingRotation;
+	/// Particles scale factor on the X axis
+	nctl::UniquePtr<float[]> scaleX;
+	/// Particles scale factor on the Y axis
+	nctl::UniquePtr<float[]> scaleY;
+	/// Particles red color component
+	nctl::UniquePtr<float[]> colorR;
+	/// Particles green color component
+	nctl::UniquePtr<float[]> colorG;
+	/// Particles blue color component
+	nctl::UniquePtr<float[]> colorB;
+	/// Particles alpha color component
+	nctl::UniquePtr<float[]> colorA;
+	/// Particles normalized age, only valid after calling `calculateNormalizedAges()`
+	nctl::UniquePtr<float[]> normalizedAge;
+
+	/// Allocates the arrays for the specified maximum number of particles
+	explicit ParticleData(unsigned int capacity);
+
+	/// Returns the maximum number of particles
+	inline unsigned int capacity() const { return capacity_; }
+	/// Returns the number of particles currently alive
+	inline unsigned int numAlive() const { return numAlive_; }
+
+	/// Initializes a new particle with initial life, position, velocity and rotation
+	/*! \return The index of the new particle or `capacity()` if there are no more free particles */
+	unsigned int emit(float initialLife, const Vector2f &pos, const Vector2f &vel, float rot);
+	/// Kills the particle at the specified index by moving the last alive one in its place
+	void kill(unsigned int index);
+	/// Kills all alive particles
+	inline void killAll() { numAlive_ = 0; }
+
+	/// Calculates the normalized age of every alive particle, used by affectors
+	void calculateNormalizedAges();
+	/// Updates the life and the position of every alive particle, killing the ones that reach the end of their life
+	void update(float interval);
+
+  private:
+	/// The maximum number of particles
+	unsigned int capacity_;
+	/// The number of alive particles
+	unsigned int numAlive_;
+
+	/// Deleted copy constructor
+	ParticleData(const ParticleData &) = delete;
+	/// Deleted assignment operator
+	ParticleData &operator=(const ParticleData &) = delete;
+};
+
+}
+
+#endif
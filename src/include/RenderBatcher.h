@@ -1,12 +1,17 @@
 #ifndef CLASS_NCINE_RENDERBATCHER
 #define CLASS_NCINE_RENDERBATCHER
 
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+#include "GLTexture.h"
 #include <nctl/Array.h>
 #include <nctl/UniquePtr.h>
 
 namespace ncine {
 
 class RenderCommand;
+class Geometry;
+class GLUniformBlockCache;
 
 /// A class that batches render commands together
 class RenderBatcher
@@ -20,6 +25,12 @@ class RenderBatcher
 
   private:
 	static unsigned int UboMaxSize;
+	/// The texture unit used to bind the texture buffer with instance data, the last one
+	static const unsigned int InstancesTextureUnit = GLTexture::MaxTextureUnits - 1;
+	/// The size of an instance in the compact layout, as declared in the compact batched shaders
+	static const unsigned int CompactInstanceSize = 32;
+	/// The size of an instance with a texture rectangle in the compact layout
+	static const unsigned int CompactTexturedInstanceSize = 48;
 
 	struct ManagedBuffer
 	{
@@ -31,11 +42,61 @@ class RenderBatcher
 		nctl::UniquePtr<unsigned char[]> buffer;
 	};
 
+	/// The offsets in a single instance block of the uniforms encoded in the compact layout
+	struct CompactOffsets
+	{
+		int modelMatrix;
+		int color;
+		/// The offset of the sprite size, or -1 if the instance block does not have one
+		int spriteSize;
+		/// The offset of the texture rectangle, or -1 if the instance block does not have one
+		int texRect;
+	};
+
+	/// The memory regions of a batch that are filled with the data of its commands
+	struct BatchFill
+	{
+		RenderCommand *const *start;
+		RenderCommand *const *end;
+		RenderCommand *batchCommand;
+		/// The instances uniform block of the batch, or `nullptr` if instance data is written to a texture buffer
+		GLUniformBlockCache *instancesBlock;
+		/// The texture buffer memory for instance data, or `nullptr` if it is written to the uniform block
+		GLubyte *destInstances;
+		unsigned int singleInstanceBlockSize;
+		GLfloat *destVtx;
+		GLushort *destIdx;
+		unsigned int numFloatsVertexFormat;
+		bool batchingWithIndices;
+		bool hasAttributes;
+		/// True if instance data is encoded in the compact layout instead of being copied
+		bool compact;
+		/// True if every glyph of the text node commands is encoded as a compact instance
+		bool glyphInstances;
+		CompactOffsets compactOffsets;
+	};
+
 	/// Memory buffers to collect UBO data before committing it
-	/*! \note It is a RAM buffer and cannot be handled by the `RenderBuffersManager` */
+	/*! \note It is a RAM buffer and cannot be handled by the `RenderBuffersManager`
+	 *  \note The frame allocator is used instead when the custom allocators are enabled */
 	nctl::Array<ManagedBuffer> buffers_;
+	/// The batches created by the last call, their memory is acquired serially but filled later
+	nctl::Array<BatchFill> fills_;
 
+	/// Returns the maximum number of commands in a batch, batches with instance data in a texture buffer are only limited by its size
+	static unsigned int maxCommandsInBatch(RenderCommand *refCommand, unsigned int maxBatchSize);
+	/// Acquires a batch command and the memory for a range of commands, the data is copied later by `fillBatch()`
 	RenderCommand *collectCommands(nctl::Array<RenderCommand *>::ConstIterator start, nctl::Array<RenderCommand *>::ConstIterator end, nctl::Array<RenderCommand *>::ConstIterator &nextStart);
+	/// Copies instance data, vertices and indices of the commands of a batch
+	static void fillBatch(const BatchFill &fill);
+	/// Fills a range of batches, called by the `parallelFor()` jobs
+	static void fillBatches(unsigned int first, unsigned int count, const void *data);
+	/// Encodes the instance block of a command with a two-dimensional transformation in the compact layout
+	static void encodeCompactInstance(GLubyte *dest, const GLubyte *src, const CompactOffsets &offsets);
+	/// Encodes every glyph quad of a text node command as a compact instance with the node transformation and color
+	static void encodeCompactGlyphs(GLubyte *dest, const GLubyte *src, const CompactOffsets &offsets, const Geometry &geometry);
+	/// Returns the number of glyph quads in the triangle strip of a text node command
+	static unsigned int numGlyphs(const Geometry &geometry);
 
 	unsigned char *acquireMemory(unsigned int bytes);
 	void createBuffer(unsigned int size);
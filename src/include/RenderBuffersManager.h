@@ -2,6 +2,8 @@
 #define CLASS_NCINE_RENDERBUFFERSMANAGER
 
 #include "GLBufferObject.h"
+#include "GLTexture.h"
+#include "GLFence.h"
 #include <nctl/Array.h>
 #include <nctl/UniquePtr.h>
 
@@ -18,11 +20,18 @@ class RenderBuffersManager
 			ARRAY = 0,
 			ELEMENT_ARRAY,
 			UNIFORM,
+			/// Texture buffers with batched instance data, only created when supported
+			TEXTURE,
 
 			COUNT
 		};
 	};
 
+	/// The size in bytes of a texel of a texture buffer, four floats
+	static const unsigned int TextureBufferTexelSize = 16;
+	/// The number of sections of a persistently mapped buffer, one for each frame in flight
+	static const unsigned int NumRingSections = 3;
+
 	struct BufferSpecifications
 	{
 		BufferTypes::Enum type;
@@ -31,51 +40,94 @@ class RenderBuffersManager
 		GLenum usageFlags;
 		unsigned long maxSize;
 		GLuint alignment;
+		/// True if the buffers are mapped only once and split in a ring of sections
+		bool persistentMapping;
 	};
 
 	struct Parameters
 	{
 		Parameters()
-		    : object(nullptr), size(0), offset(0), mapBase(nullptr) {}
+		    : object(nullptr), size(0), offset(0), mapBase(nullptr), texture(nullptr) {}
 
 		GLBufferObject *object;
 		unsigned long size;
 		unsigned long offset;
 		GLubyte *mapBase;
+		/// The texture to sample the buffer from a shader, only set for texture buffers
+		const GLTexture *texture;
 	};
 
-	RenderBuffersManager(bool useBufferMapping, unsigned long vboMaxSize, unsigned long iboMaxSize);
+	/// Creates the managed buffers, texture buffers are only created if `tboMaxSize` is not zero and they are supported
+	/*! \note Persistent mapping is only used for vertex, index and uniform buffers, and only when it is supported */
+	RenderBuffersManager(bool useBufferMapping, bool usePersistentMapping, unsigned long vboMaxSize, unsigned long iboMaxSize, unsigned long tboMaxSize);
+
+	/// Returns true if texture buffers are supported by the device and by the shaders
+	static bool hasTextureBuffers();
+	/// Returns true if buffers can be persistently and coherently mapped
+	static bool hasPersistentMapping();
 
 	/// Returns the specifications for a buffer of the specified type
 	inline const BufferSpecifications &specs(BufferTypes::Enum type) const { return specs_[type]; }
+	/// Returns true if buffers of the specified type are available
+	inline bool isAvailable(BufferTypes::Enum type) const { return specs_[type].maxSize > 0; }
 	/// Requests an amount of bytes from the specified buffer type
 	inline Parameters acquireMemory(BufferTypes::Enum type, unsigned long bytes) { return acquireMemory(type, bytes, specs_[type].alignment); }
 	/// Requests an amount of bytes from the specified buffer type with a custom alignment requirement
 	Parameters acquireMemory(BufferTypes::Enum type, unsigned long bytes, unsigned int alignment);
 
+	/// Flushes and unmaps the buffers, to be called once the render commands of a frame have been committed
+	void flushUnmap();
+	/// Maps the buffers again for the next frame, making all of their space available
+	void remap();
+
   private:
+	/// Extra bytes in every section of a ring, so that an aligned request of the maximum size always fits
+	static const unsigned int RingSectionPadding = 256;
+	/// The timeout in nanoseconds of a single wait for the fence of a ring section
+	static const GLuint64 RingFenceTimeout = 1000000;
+
 	BufferSpecifications specs_[BufferTypes::COUNT];
 
 	struct ManagedBuffer
 	{
 		ManagedBuffer()
-		    : type(BufferTypes::ARRAY), size(0), freeSpace(0), mapBase(nullptr) {}
+		    : type(BufferTypes::ARRAY), size(0), freeSpace(0), mapBase(nullptr), numSections(1), sectionOffset(0) {}
 
 		BufferTypes::Enum type;
 		nctl::UniquePtr<GLBufferObject> object;
+		/// The size of a single section
 		unsigned long size;
 		unsigned long freeSpace;
 		GLubyte *mapBase;
 		nctl::UniquePtr<GLubyte[]> hostBuffer;
+		/// The texture associated with a texture buffer
+		nctl::UniquePtr<GLTexture> texture;
+		/// The number of sections of the buffer, more than one if it is persistently mapped
+		unsigned int numSections;
+		/// The offset of the section written during the current frame
+		unsigned long sectionOffset;
 	};
 
 	nctl::Array<ManagedBuffer> buffers_;
 
-	void flushUnmap();
-	void remap();
+	/// The index of the ring section written during the current frame
+	unsigned int ringIndex_;
+	/// The fences inserted after the draw commands reading each ring section
+	GLFence ringFences_[NumRingSections];
+	/// True if the fence of the current section has not been checked yet for a buffer type
+	bool ringSectionPending_[BufferTypes::COUNT];
+	/// Number of fence waits during the current frame for every buffer type
+	unsigned int fenceWaits_[BufferTypes::COUNT];
+	/// Milliseconds spent waiting for fences during the current frame for every buffer type
+	float fenceWaitTimes_[BufferTypes::COUNT];
+
+	/// Takes the requested bytes from the free space of a buffer, returns false if they do not fit
+	bool acquireFromBuffer(ManagedBuffer &buffer, unsigned long bytes, unsigned int alignment, Parameters &params);
+	/// Waits until the GPU has finished reading the ring section of the current frame
+	void waitForRingSection(BufferTypes::Enum type);
+
 	void createBuffer(const BufferSpecifications &specs);
 
-	friend class ScreenViewport;
 	friend class RenderStatistics;
 };
 
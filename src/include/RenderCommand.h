@@ -87,6 +87,8 @@ class RenderCommand
 
 	inline const Matrix4x4f &transformation() const { return modelMatrix_; }
 	void setTransformation(const Matrix4x4f &modelMatrix);
+	/// Returns true if the transformation maps the XY plane to a plane at constant depth, without any perspective
+	inline bool isTransformation2D() const { return transformation2D_; }
 	inline const Material &material() const { return material_; }
 	inline const Geometry &geometry() const { return geometry_; }
 	inline Material &material() { return material_; }
@@ -120,6 +122,7 @@ class RenderCommand
 	int batchSize_;
 
 	bool transformationCommitted_;
+	bool transformation2D_;
 
 	/// Command type for profiling counter
 	CommandTypes::Enum profilingType_;
@@ -2,6 +2,7 @@
 #define CLASS_NCINE_RENDERCOMMANDPOOL
 
 #include <nctl/Array.h>
+#include <nctl/HashMap.h>
 #include <nctl/UniquePtr.h>
 #include "Material.h"
 
@@ -29,12 +30,35 @@ class RenderCommandPool
 	/// Retrieves (or adds) a command with the specified OpenGL shader program
 	RenderCommand *retrieveOrAdd(GLShaderProgram *shaderProgram, bool &commandAdded);
 
-	/// Releases all used commands and returnsi them in the free array
+	/// Releases all used commands and returns them to the free lists of their shader programs
+	/*! \note The commands of a shader program that has not been used for many resets are deleted */
 	void reset();
 
   private:
-	nctl::Array<nctl::UniquePtr<RenderCommand>> freeCommandsPool_;
-	nctl::Array<nctl::UniquePtr<RenderCommand>> usedCommandsPool_;
+	/// The commands not currently used that share the same shader program
+	struct FreeList
+	{
+		FreeList()
+		    : numIdleResets(0) {}
+
+		nctl::Array<RenderCommand *> commands;
+		/// The number of consecutive resets that have not returned any command to the list
+		unsigned int numIdleResets;
+	};
+
+	/// Every command created by the pool, either used or free
+	nctl::Array<nctl::UniquePtr<RenderCommand>> commandsPool_;
+	/// Commands that have been retrieved or added since the last reset
+	nctl::Array<RenderCommand *> usedCommands_;
+	/// Free commands grouped by the shader program they use
+	nctl::HashMap<const GLShaderProgram *, FreeList> freeCommands_;
+	/// The number of commands in all the free lists
+	unsigned int numFreeCommands_;
+	/// Shader programs whose free lists have been idle for too long, collected by `reset()`
+	nctl::Array<const GLShaderProgram *> idleShaderPrograms_;
+
+	/// Deletes the free lists in `idleShaderPrograms_` together with their commands
+	void pruneIdleFreeLists();
 };
 
 }
@@ -2,25 +2,56 @@
 #define CLASS_NCINE_RENDERQUEUE
 
 #include "RenderCommand.h"
+#include "RenderBatcher.h"
 #include <nctl/Array.h>
 
 namespace ncine {
 
 /// A class that sorts and issues the render commands collected by the scenegraph visit
+/*! Commands can also be added concurrently by multiple producers, each one filling its own bucket.
+ *  Buckets are merged in index order, so the queue is the same regardless of how they have been scheduled. */
 class RenderQueue
 {
   public:
+	/// The bucket index of a thread that adds commands directly to the queues
+	static const unsigned int NoBucket = ~0U;
+
 	/// Constructor that sets the owning viewport
 	RenderQueue();
 
 	/// Returns true if the queue does not contain any render commands
 	bool isEmpty() const;
 
-	/// Adds a draw command to the queue
+	/// Adds a draw command to the queue, or to the bucket of the calling thread if it has one
 	void addCommand(RenderCommand *command);
 
+	/// Sets the number of buckets that can be filled concurrently, it should not be called while they are being filled
+	void setNumBuckets(unsigned int numBuckets);
+	/// Returns the number of buckets
+	inline unsigned int numBuckets() const { return buckets_.size(); }
+	/// Sets the bucket of this queue filled by `addCommand()` on the calling thread, or `NoBucket` to fill the queues directly
+	/*! \note A bucket should only be filled by one thread at a time, and a thread only fills the bucket of the last queue it has been set for */
+	void setThreadBucket(unsigned int bucketIndex);
+	/// Returns the bucket of this queue filled by `addCommand()` on the calling thread, or `NoBucket`
+	unsigned int threadBucket() const;
+	/// Appends the commands of all the buckets to the queues, in bucket order
+	/*! Every bucket has been visited with its own visit order indices starting from zero,
+	 *  they are offset to follow the ones of the previous buckets, starting after `visitOrderIndex`.
+	 *  \return The last visit order index used by the merged commands */
+	unsigned int mergeBuckets(unsigned int visitOrderIndex);
+
 	/// Sorts the queues, create batches and commits commands
 	void sortAndCommit();
+	/// Merges the buckets and sorts the queues, the first step of `sortAndCommit()`
+	void sort();
+	/// Creates the batches of the sorted queues, the second step of `sortAndCommit()`
+	void createBatches();
+	/// Commits the commands of the batched queues, or of the sorted ones if batching is disabled, the last step of `sortAndCommit()`
+	void commit();
+	/// Returns the queue of opaque commands, sorted after `sortAndCommit()` has been called
+	inline const nctl::Array<RenderCommand *> &opaqueQueue() const { return opaqueQueue_; }
+	/// Returns the queue of transparent commands, sorted after `sortAndCommit()` has been called
+	inline const nctl::Array<RenderCommand *> &transparentQueue() const { return transparentQueue_; }
 	/// Issues every render command in order
 	void draw();
 
@@ -28,6 +59,36 @@ class RenderQueue
 	void clear();
 
   private:
+	/// The minimum number of commands in a queue to sort them with a radix sort instead of a quicksort
+	static const unsigned int RadixSortThreshold = 2048;
+
+	/// The sorting keys of a render command extracted in a compact structure
+	struct SortElement
+	{
+		uint64_t materialSortKey;
+		uint32_t idSortKey;
+		RenderCommand *command;
+	};
+
+	/// The state of a queue from the previous frame, used to exploit temporal coherence
+	/*! \note Previous frame pointers are only dereferenced after checking that the same commands have been added again */
+	struct CoherenceCache
+	{
+		/// Commands in the order they have been added in the previous frame
+		nctl::Array<RenderCommand *> commands;
+		/// Commands in the sorted order of the previous frame
+		nctl::Array<RenderCommand *> sortedCommands;
+	};
+
+	/// The commands added by a single producer, their material sort keys are calculated when merging
+	struct CommandBucket
+	{
+		nctl::Array<RenderCommand *> commands;
+	};
+
+	/// Buckets filled concurrently by the producers
+	nctl::Array<CommandBucket> buckets_;
+
 	/// Array of opaque render command pointers
 	nctl::Array<RenderCommand *> opaqueQueue_;
 	/// Array of opaque batched render command pointers
@@ -36,6 +97,24 @@ class RenderQueue
 	nctl::Array<RenderCommand *> transparentQueue_;
 	/// Array of transparent batched render command pointers
 	nctl::Array<RenderCommand *> transparentBatchedQueue_;
+
+	/// Array of sorting keys, reused across frames by the radix sort
+	nctl::Array<SortElement> sortElements_;
+	/// Scratch buffer reused across frames by the radix sort
+	nctl::Array<SortElement> sortScratch_;
+
+	/// Previous frame state of the opaque queue
+	CoherenceCache opaqueCache_;
+	/// Previous frame state of the transparent queue
+	CoherenceCache transparentCache_;
+
+	/// Calculates the material sort key of a command and adds it to the opaque or transparent queue
+	void enqueueCommand(RenderCommand *command);
+
+	/// Sorts a queue, starting from the previous frame order if the same commands have been added again
+	void sortCoherentQueue(nctl::Array<RenderCommand *> &queue, bool descending, CoherenceCache &cache);
+	/// Sorts a queue by material and id sort keys, in ascending or descending order
+	void sortQueue(nctl::Array<RenderCommand *> &queue, bool descending);
 };
 
 }
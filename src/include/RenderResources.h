@@ -52,6 +52,14 @@ class RenderResources
 		int drawindex;
 	};
 
+	/// A vertex format structure for vertices with positions, texture coordinates and a packed color
+	struct VertexFormatPos2Tex2Color
+	{
+		GLfloat position[2];
+		GLfloat texcoords[2];
+		GLubyte color[4];
+	};
+
 	struct CameraUniformData
 	{
 		CameraUniformData()
@@ -73,6 +81,10 @@ class RenderResources
 	static GLShaderProgram *batchedShader(const GLShaderProgram *shader);
 	static bool registerBatchedShader(const GLShaderProgram *shader, ncine::GLShaderProgram *batchedShader);
 	static bool unregisterBatchedShader(const GLShaderProgram *shader);
+	/// Returns the variant of a batched shader with a compact instance layout for two-dimensional transformations, if any
+	static GLShaderProgram *compactBatchedShader(const GLShaderProgram *batchedShader);
+	/// Returns true if the batched shader is one of the default ones that read instance data from a texture buffer
+	static bool isTextureBufferShader(const GLShaderProgram *batchedShader);
 
 	static inline unsigned char *cameraUniformsBuffer() { return cameraUniformsBuffer_; }
 	static CameraUniformData *findCameraUniformData(GLShaderProgram *shaderProgram);
@@ -90,9 +102,16 @@ class RenderResources
 	static nctl::UniquePtr<RenderCommandPool> renderCommandPool_;
 	static nctl::UniquePtr<RenderBatcher> renderBatcher_;
 
-	static const unsigned int NumDefaultShaderPrograms = 18;
+	static const unsigned int NumDefaultShaderPrograms = 22;
 	static nctl::UniquePtr<GLShaderProgram> defaultShaderPrograms_[NumDefaultShaderPrograms];
+	/// The batched shader programs reading instance data from a texture buffer, in the same order as the default batched ones
+	static const unsigned int NumTextureBufferShaderPrograms = 10;
+	static nctl::UniquePtr<GLShaderProgram> textureBufferShaderPrograms_[NumTextureBufferShaderPrograms];
+	/// The batched shader programs for sprites and for the glyphs of text nodes with a compact instance layout
+	static const unsigned int NumCompactShaderPrograms = 7;
+	static nctl::UniquePtr<GLShaderProgram> compactShaderPrograms_[NumCompactShaderPrograms];
 	static nctl::HashMap<const GLShaderProgram *, GLShaderProgram *> batchedShaders_;
+	static nctl::HashMap<const GLShaderProgram *, GLShaderProgram *> compactBatchedShaders_;
 
 	static const unsigned int UniformsBufferSize = 128; // two 4x4 float matrices
 	static unsigned char cameraUniformsBuffer_[UniformsBufferSize];
@@ -38,11 +38,23 @@ class RenderStatistics
 	{
 	  public:
 		unsigned int count;
+		/// The size of the sections written during a frame
 		unsigned long size;
 		unsigned long usedSpace;
+		/// The number of sections of every buffer, more than one for persistently mapped rings
+		unsigned int ringSections;
+		/// The memory allocated for all the sections of the buffers
+		unsigned long ringSize;
+		/// Number of times the CPU had to wait for the GPU to release a section of a ring
+		unsigned int fenceWaits;
+		/// Milliseconds spent waiting for the fences of the ring sections
+		float fenceWaitTime;
 
 		Buffers()
-		    : count(0), size(0), usedSpace(0) {}
+		    : count(0), size(0), usedSpace(0), ringSections(0), ringSize(0), fenceWaits(0), fenceWaitTime(0.0f) {}
+
+		/// Returns the ratio of the sections of this frame that is used
+		inline float utilization() const { return (size > 0) ? usedSpace / static_cast<float>(size) : 0.0f; }
 
 	  private:
 		void reset()
@@ -50,6 +62,10 @@ class RenderStatistics
 			count = 0;
 			size = 0;
 			usedSpace = 0;
+			ringSections = 0;
+			ringSize = 0;
+			fenceWaits = 0;
+			fenceWaitTime = 0.0f;
 		}
 		friend RenderStatistics;
 	};
@@ -97,9 +113,16 @@ class RenderStatistics
 		unsigned int capacity;
 		unsigned int reuses;
 		unsigned int bindings;
+		/// Bindings of a VAO already defined with the requested vertex format
+		unsigned int hits;
+		/// Bindings that required a VAO to be defined
+		unsigned int misses;
 
 		VaoPool()
-		    : size(0), capacity(0), reuses(0), bindings(0) {}
+		    : size(0), capacity(0), reuses(0), bindings(0), hits(0), misses(0) {}
+
+		/// Returns the ratio of bindings that did not require a VAO to be defined
+		inline float hitRate() const { return (hits + misses > 0) ? hits / static_cast<float>(hits + misses) : 0.0f; }
 
 	  private:
 		void reset()
@@ -108,6 +131,8 @@ class RenderStatistics
 			capacity = 0;
 			reuses = 0;
 			bindings = 0;
+			hits = 0;
+			misses = 0;
 		}
 		friend RenderStatistics;
 	};
@@ -118,9 +143,14 @@ class RenderStatistics
 		unsigned int usedSize;
 		unsigned int freeSize;
 		unsigned int retrievals;
+		/// Retrievals that did not find a free command with the requested shader program
+		unsigned int misses;
 
 		CommandPool()
-		    : usedSize(0), freeSize(0), retrievals(0) {}
+		    : usedSize(0), freeSize(0), retrievals(0), misses(0) {}
+
+		/// Returns the ratio of successful retrievals
+		inline float hitRate() const { return (retrievals + misses > 0) ? retrievals / static_cast<float>(retrievals + misses) : 0.0f; }
 
 	  private:
 		void reset()
@@ -128,10 +158,27 @@ class RenderStatistics
 			usedSize = 0;
 			freeSize = 0;
 			retrievals = 0;
+			misses = 0;
 		}
 		friend RenderStatistics;
 	};
 
+	class FrameArena
+	{
+	  public:
+		/// The size of the arena of a single frame, zero if the custom allocators are disabled
+		unsigned long capacity;
+		/// Bytes allocated during the last frame
+		unsigned long usedMemory;
+		/// The maximum number of bytes allocated during a single frame
+		unsigned long highWaterMark;
+		/// Allocations of the last frame that did not fit in the arena
+		unsigned int overflows;
+
+		FrameArena()
+		    : capacity(0), usedMemory(0), highWaterMark(0), overflows(0) {}
+	};
+
 	/// Returns the aggregated command statistics for all types
 	static inline const Commands &allCommands() { return allCommands_; }
 	/// Returns the commnad statistics for the specified type
@@ -157,6 +204,8 @@ class RenderStatistics
 
 	/// Returns statistics about the render command pools
 	static inline const CommandPool &commandPool() { return commandPool_; }
+	/// Returns statistics about the frame allocator arena
+	static inline const FrameArena &frameArena() { return frameArena_; }
 
   private:
 	/// The string used to output OpenGL debug group information
@@ -172,10 +221,14 @@ class RenderStatistics
 	static unsigned int culledNodes_[2];
 	static VaoPool vaoPool_;
 	static CommandPool commandPool_;
+	static FrameArena frameArena_;
 
 	static void reset();
 	static void gatherStatistics(const RenderCommand &command);
 	static void gatherStatistics(const RenderBuffersManager::ManagedBuffer &buffer);
+	static void gatherStatistics(RenderBuffersManager::BufferTypes::Enum type, unsigned int fenceWaits, float fenceWaitTime);
+	/// Reads the statistics of the frame allocator, it is called once per frame
+	static void gatherFrameArenaStatistics();
 	static inline void gatherVaoPoolStatistics(unsigned int poolSize, unsigned int poolCapacity)
 	{
 		vaoPool_.size = poolSize;
@@ -219,7 +272,10 @@ class RenderStatistics
 	static inline void addCulledNode() { culledNodes_[index_]++; }
 	static inline void addVaoPoolReuse() { vaoPool_.reuses++; }
 	static inline void addVaoPoolBinding() { vaoPool_.bindings++; }
+	static inline void addVaoPoolHit() { vaoPool_.hits++; }
+	static inline void addVaoPoolMiss() { vaoPool_.misses++; }
 	static inline void addCommandPoolRetrieval() { commandPool_.retrievals++; }
+	static inline void addCommandPoolMiss() { commandPool_.misses++; }
 
 	friend class ScreenViewport;
 	friend class RenderQueue;
@@ -229,6 +285,7 @@ class RenderStatistics
 	friend class DrawableNode;
 	friend class RenderVaoPool;
 	friend class RenderCommandPool;
+	friend class Application;
 };
 
 }
@@ -2,8 +2,8 @@
 #define CLASS_NCINE_RENDERVAOPOOL
 
 #include <nctl/Array.h>
+#include <nctl/HashMap.h>
 #include <nctl/UniquePtr.h>
-#include "TimeStamp.h"
 #include "GLVertexArrayObject.h"
 #include "GLVertexFormat.h"
 
@@ -23,10 +23,17 @@ class RenderVaoPool
 	{
 		nctl::UniquePtr<GLVertexArrayObject> object;
 		GLVertexFormat format;
-		TimeStamp lastBindTime;
+		/// The hash of the vertex format
+		uint32_t formatHash;
+		/// The value of the bind counter the last time the VAO was bound
+		unsigned long int lastBind;
 	};
 
 	nctl::Array<VaoBinding> vaoPool_;
+	/// Maps the hash of a vertex format to the index of the VAO defined with it
+	nctl::HashMap<uint32_t, unsigned int> vaoIndices_;
+	/// A counter incremented at every bind, used to find the least recently used VAO
+	unsigned long int bindCounter_;
 
 	void insertGLDebugMessage(const VaoBinding &binding);
 };
@@ -0,0 +1,67 @@
+#ifndef CLASS_NCINE_SCENEUPDATER
+#define CLASS_NCINE_SCENEUPDATER
+
+#include <nctl/Array.h>
+
+namespace ncine {
+
+class SceneNode;
+class IThreadPool;
+
+/// A class that splits the update of a scenegraph into jobs for the worker threads of a thread pool
+/*! Only plain `SceneNode` objects near the root are transformed on the calling thread,
+ *  their children subtrees are then updated in parallel by the job system and joined before returning. */
+class SceneUpdater
+{
+  public:
+	/// Creates an updater that enqueues its jobs to the specified thread pool
+	SceneUpdater(IThreadPool &threadPool, unsigned int maxDepth, unsigned int minNodesPerJob);
+
+	/// Updates the node and all of its descendants, returning only when every job has finished
+	void update(SceneNode &rootNode, float interval);
+
+  private:
+	/// A range of consecutive subtree roots updated by the same job
+	struct Batch
+	{
+		unsigned int first;
+		unsigned int count;
+	};
+
+	IThreadPool &threadPool_;
+	/// The maximum depth at which subtrees are split
+	unsigned int maxDepth_;
+	/// The minimum number of nodes grouped into a single batch
+	unsigned int minNodesPerJob_;
+
+	/// Plain scene nodes that have been transformed on the calling thread
+	nctl::Array<SceneNode *> splitNodes_;
+	/// Roots of the subtrees updated by the jobs
+	nctl::Array<SceneNode *> jobRoots_;
+	/// Ranges of subtree roots, each one is processed by a single thread
+	nctl::Array<Batch> batches_;
+	/// The number of nodes accumulated in the last batch
+	unsigned int batchNodes_;
+
+	/// The interval of the current update
+	float interval_;
+
+	/// Transforms a plain scene node and collects its children as subtree roots or nodes to be split further
+	void collect(SceneNode *node, unsigned int depth);
+	/// Appends a subtree root to the last batch, closing it when enough nodes have been accumulated
+	void addJobRoot(SceneNode *node);
+	/// Updates the subtrees of a range of batches, called by the `parallelFor()` jobs
+	static void updateBatches(unsigned int first, unsigned int count, const void *data);
+
+	/// Counts the nodes of a subtree, stopping when the limit has been reached
+	static unsigned int countNodes(const SceneNode *node, unsigned int limit);
+
+	/// Deleted copy constructor
+	SceneUpdater(const SceneUpdater &) = delete;
+	/// Deleted assignment operator
+	SceneUpdater &operator=(const SceneUpdater &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef CLASS_NCINE_SKYLINEPACKER
+#define CLASS_NCINE_SKYLINEPACKER
+
+#include <nctl/Array.h>
+#include "Vector2.h"
+
+namespace ncine {
+
+/// A rectangle packer that tracks the bottom edge of the packed area as a list of horizontal segments
+/*! Rectangles are placed with the bottom-left heuristic: the position that keeps their bottom edge
+ *  as high as possible is chosen, preferring the narrowest segment on ties to waste less space.
+ *  The origin is in the top-left corner and the Y axis points down, as in a texture atlas. */
+class SkylinePacker
+{
+  public:
+	SkylinePacker(unsigned int width, unsigned int height);
+
+	/// Removes every rectangle and changes the size of the packing area
+	void reset(unsigned int width, unsigned int height);
+
+	/// Finds a position for a rectangle and adds it to the packed area
+	/*! \return False if there is no space left for the rectangle */
+	bool insert(unsigned int width, unsigned int height, Vector2i &position);
+
+	/// Returns the width of the packing area
+	inline unsigned int width() const { return width_; }
+	/// Returns the height of the packing area
+	inline unsigned int height() const { return height_; }
+	/// Returns the sum of the areas of the packed rectangles
+	inline unsigned long usedArea() const { return usedArea_; }
+
+  private:
+	/// A horizontal segment of the skyline
+	struct Segment
+	{
+		Segment()
+		    : x(0), y(0), width(0) {}
+		Segment(unsigned int xx, unsigned int yy, unsigned int ww)
+		    : x(xx), y(yy), width(ww) {}
+
+		unsigned int x;
+		/// The height of the packed area above the segment
+		unsigned int y;
+		unsigned int width;
+	};
+
+	unsigned int width_;
+	unsigned int height_;
+	unsigned long usedArea_;
+	/// The segments sorted by their X coordinate, they cover the whole width without gaps
+	nctl::Array<Segment> skyline_;
+
+	/// Returns the Y coordinate of a rectangle placed at the start of a segment, or a negative value if it does not fit
+	int fitsAt(unsigned int segmentIndex, unsigned int width, unsigned int height) const;
+	/// Raises the skyline below a newly placed rectangle
+	void addSegment(unsigned int segmentIndex, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+};
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef CLASS_NCINE_SPATIALGRID
+#define CLASS_NCINE_SPATIALGRID
+
+#include <nctl/Array.h>
+#include <nctl/HashMap.h>
+#include "Rect.h"
+
+namespace ncine {
+
+class SceneNode;
+class DrawableNode;
+
+/// A sparse and loose uniform grid of drawable nodes used as a culling broad-phase
+/*! Every node is stored in the cell containing the center of its AABB, queries enlarge the searched area
+ *  by half a cell so that nodes overlapping neighbouring cells are not missed.
+ *  Nodes with an AABB bigger than a cell are kept in a separate array that is always tested. */
+class SpatialGrid
+{
+  public:
+	/// Creates an empty grid with the specified cell size in world units
+	explicit SpatialGrid(float cellSize);
+	/// Removes the grid entries of every node still stored
+	~SpatialGrid();
+
+	/// Returns the unique identifier of the grid, it is never zero
+	inline unsigned int id() const { return id_; }
+	/// Returns the size of a grid cell
+	inline float cellSize() const { return cellSize_; }
+	/// Returns the number of nodes stored in the grid
+	inline unsigned int numNodes() const { return numNodes_; }
+
+	/// Inserts a node or moves it to the cell containing the center of its updated AABB
+	void update(DrawableNode *node);
+	/// Removes a node from the grid
+	void remove(DrawableNode *node);
+	/// Transfers the grid entry of a node to another one, used when nodes are moved
+	void replace(DrawableNode *oldNode, DrawableNode *newNode);
+
+	/// Removes every drawable node of a subtree from the grid storing it
+	/*! \note It is called when a subtree is detached from its parent or disabled for drawing */
+	static void removeSubtree(SceneNode *node);
+
+	/// Marks as rendered in the specified frame every node whose AABB overlaps the rectangle and appends it to the array
+	void collectOverlapping(const Rectf &rect, unsigned long int frame, nctl::Array<SceneNode *> &nodes);
+
+  private:
+	/// The identifier that will be assigned to the next grid
+	static unsigned int nextId_;
+	/// The cell index of the nodes that are too big to be stored in a cell
+	static const unsigned int OversizedCell = ~0U;
+
+	/// A grid cell with the array of nodes whose AABB center is inside it
+	struct Cell
+	{
+		Cell(int xx, int yy)
+		    : x(xx), y(yy) {}
+
+		int x;
+		int y;
+		nctl::Array<DrawableNode *> nodes;
+	};
+
+	unsigned int id_;
+	float cellSize_;
+	float invCellSize_;
+
+	/// The range of coordinates of the cells created so far
+	int minX_;
+	int minY_;
+	int maxX_;
+	int maxY_;
+
+	unsigned int numNodes_;
+	nctl::Array<Cell> cells_;
+	/// The nodes with an AABB wider or taller than a cell
+	nctl::Array<DrawableNode *> oversizedNodes_;
+	/// Cell coordinates packed in a key mapped to an index in the cells array
+	nctl::HashMap<uint64_t, unsigned int> cellIndices_;
+
+	/// Returns the index of the cell at the specified coordinates, creating it if needed
+	unsigned int retrieveCell(int x, int y);
+	/// Removes a node from its current cell by moving the last node of the cell in its place
+	void removeFromCell(DrawableNode *node);
+	/// Returns the array of nodes of a cell, or the one of the oversized nodes
+	nctl::Array<DrawableNode *> &cellNodes(unsigned int cellIndex);
+	/// Marks and collects the nodes of an array that overlap the rectangle
+	void collectNodes(const nctl::Array<DrawableNode *> &cellNodes, const Rectf &rect, unsigned long int frame, nctl::Array<SceneNode *> &nodes);
+
+	/// Deleted copy constructor
+	SpatialGrid(const SpatialGrid &) = delete;
+	/// Deleted assignment operator
+	SpatialGrid &operator=(const SpatialGrid &) = delete;
+};
+
+}
+
+#endif
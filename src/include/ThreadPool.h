@@ -2,14 +2,19 @@
 #define CLASS_NCINE_THREADPOOL
 
 #include "IThreadPool.h"
-#include <nctl/List.h>
 #include "ThreadSync.h"
 #include <nctl/Array.h>
+#include <nctl/Atomic.h>
 #include "Thread.h"
+#include "JobSystem.h"
 
 namespace ncine {
 
 /// Thread pool class
+/*! Worker threads execute jobs from their own queue and steal them from the others when it is empty.
+ *  The thread creating the pool is considered the main one and it helps executing jobs while waiting.
+ *  Background jobs are kept in a separate queue that is only served by worker threads.
+ *  Other threads create jobs in a shared pool under a lock and always run them in the background queue. */
 class ThreadPool : public IThreadPool
 {
   public:
@@ -19,27 +24,54 @@ class ThreadPool : public IThreadPool
 	explicit ThreadPool(unsigned int numThreads);
 	~ThreadPool() override;
 
-	/// Enqueues a command request for a worker thread
+	/// Enqueues a command request for a worker thread, using the background queue
 	void enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand) override;
+	/// Returns the number of worker threads
+	inline unsigned int numThreads() const override { return numThreads_; }
+
+	JobId createJob(JobFunction jobFunction, const void *data, unsigned int dataSize) override;
+	JobId createJobAsChild(JobId parent, JobFunction jobFunction, const void *data, unsigned int dataSize) override;
+	bool addContinuation(JobId ancestor, JobId continuation) override;
+	void run(JobId job) override;
+	void runInBackground(JobId job) override;
+	void wait(JobId job) override;
+	bool isFinished(JobId job) const override;
+
+	void parallelFor(unsigned int count, unsigned int batchSize, ParallelForFunction function, const void *data) override;
 
   private:
 	struct ThreadStruct
 	{
-		nctl::List<nctl::UniquePtr<IThreadCommand>> *queue;
-		Mutex *queueMutex;
-		CondVariable *queueCV;
-		bool shouldQuit;
+		ThreadPool *threadPool;
+		unsigned int index;
 	};
 
-	nctl::List<nctl::UniquePtr<IThreadCommand>> queue_;
 	nctl::Array<Thread> threads_;
-	Mutex queueMutex_;
-	CondVariable queueCV_;
-	Mutex quitMutex_;
+	nctl::Array<ThreadStruct> threadStructs_;
 	unsigned int numThreads_;
 
-	ThreadStruct threadStruct_;
+	JobSystem jobSystem_;
+	/// Mutex and condition variable used by worker threads to sleep when there are no jobs
+	Mutex sleepMutex_;
+	CondVariable sleepCV_;
+	nctl::Atomic32 numSleepingThreads_;
+	nctl::Atomic32 shouldQuit_;
+
+	/// Background jobs in submission order, only executed by worker threads
+	nctl::Array<JobId> backgroundJobs_;
+	/// The index of the next background job to execute
+	unsigned int nextBackgroundJob_;
+	/// The number of background jobs waiting to be executed, read without locking the mutex
+	nctl::Atomic32 numBackgroundJobs_;
+	Mutex backgroundMutex_;
+	/// Serializes the creation of jobs by threads that are neither workers nor the creator of the pool
+	Mutex foreignPoolMutex_;
+
+	/// Executes the oldest background job, returning false if there were none
+	bool executeBackgroundJob();
+
 	static void workerFunction(void *arg);
+	static void wakeWorkers(void *userData);
 
 	/// Deleted copy constructor
 	ThreadPool(const ThreadPool &) = delete;
@@ -0,0 +1,38 @@
+#include "imgui.h"
+#include "ImGuiNullInput.h"
+#include "Application.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ImGuiNullInput::init()
+{
+	IMGUI_CHECKVERSION();
+	ImGui::CreateContext();
+
+	ImGuiIO &io = ImGui::GetIO();
+	io.BackendPlatformName = "nCine_Null";
+}
+
+void ImGuiNullInput::shutdown()
+{
+	ImGui::DestroyContext();
+}
+
+void ImGuiNullInput::newFrame()
+{
+	ImGuiIO &io = ImGui::GetIO();
+	IM_ASSERT(io.Fonts->IsBuilt() && "Font atlas not built! Missing call to ImGuiDrawing::buildFonts() function?");
+	// ImGui asserts on a zero delta time, which is the case on the first frame
+	const float interval = theApplication().interval();
+	io.DeltaTime = (interval > 0.0f) ? interval : 1.0f / 60.0f;
+
+	const IGfxDevice &gfxDevice = theApplication().gfxDevice();
+	io.DisplaySize = ImVec2(static_cast<float>(gfxDevice.width()), static_cast<float>(gfxDevice.height()));
+	io.DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+}
+
+}
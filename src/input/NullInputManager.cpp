@@ -0,0 +1,40 @@
+#include "NullInputManager.h"
+#include "JoyMapping.h"
+
+#ifdef WITH_IMGUI
+	#include "ImGuiNullInput.h"
+#endif
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const int IInputManager::MaxNumJoysticks = 4;
+
+NullMouseState NullInputManager::mouseState_;
+NullKeyboardState NullInputManager::keyboardState_;
+NullJoystickState NullInputManager::nullJoystickState_;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+NullInputManager::NullInputManager()
+{
+	joyMapping_.init(this);
+
+#ifdef WITH_IMGUI
+	ImGuiNullInput::init();
+#endif
+}
+
+NullInputManager::~NullInputManager()
+{
+#ifdef WITH_IMGUI
+	ImGuiNullInput::shutdown();
+#endif
+}
+
+}
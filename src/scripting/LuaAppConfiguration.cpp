@@ -30,20 +30,28 @@ namespace AppConfiguration {
 	static const char *windowIconFilename = "window_icon";
 
 	static const char *useBufferMapping = "buffer_mapping";
+	static const char *usePersistentMapping = "persistent_mapping";
 	static const char *deferShaderQueries = "defer_shader_queries";
 	static const char *fixedBatchSize = "fixed_batch_size";
+	static const char *useTextureBufferBatching = "texture_buffer_batching";
 	static const char *vboSize = "vbo_size";
 	static const char *iboSize = "ibo_size";
+	static const char *tboSize = "tbo_size";
 	static const char *vaoPoolSize = "vao_pool_size";
 	static const char *renderCommandPoolSize = "rendercommand_pool_size";
 
 	static const char *withDebugOverlay = "debug_overlay";
 	static const char *withAudio = "audio";
 	static const char *withThreads = "threads";
+	static const char *withParallelUpdate = "parallel_update";
+	static const char *parallelUpdateDepth = "parallel_update_depth";
+	static const char *parallelUpdateMinNodes = "parallel_update_min_nodes";
 	static const char *withScenegraph = "scenegraph";
 	static const char *withVSync = "vsync";
 	static const char *withGlDebugContext = "gl_debug_context";
 	static const char *withConsoleColors = "console_colors";
+	static const char *headlessFrames = "headless_frames";
+	static const char *headlessReportFile = "headless_report_file";
 
 	static const char *glCoreProfile = "opengl_core_profile";
 	static const char *glForwardCompatible = "opengl_forward_compatible";
@@ -66,7 +74,7 @@ void LuaAppConfiguration::exposeConstants(lua_State *L)
 
 void LuaAppConfiguration::push(lua_State *L, const AppConfiguration &appCfg)
 {
-	lua_createtable(L, 0, 33);
+	lua_createtable(L, 0, 39);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::dataPath, appCfg.dataPath().data());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::logFile, appCfg.logFile.data());
@@ -86,20 +94,28 @@ void LuaAppConfiguration::push(lua_State *L, const AppConfiguration &appCfg)
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::windowIconFilename, appCfg.windowIconFilename.data());
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::useBufferMapping, appCfg.useBufferMapping);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::usePersistentMapping, appCfg.usePersistentMapping);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::deferShaderQueries, appCfg.deferShaderQueries);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::fixedBatchSize, appCfg.fixedBatchSize);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::useTextureBufferBatching, appCfg.useTextureBufferBatching);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::vboSize, static_cast<int64_t>(appCfg.vboSize));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::iboSize, static_cast<int64_t>(appCfg.iboSize));
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::tboSize, static_cast<int64_t>(appCfg.tboSize));
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::vaoPoolSize, appCfg.vaoPoolSize);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::renderCommandPoolSize, appCfg.renderCommandPoolSize);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withDebugOverlay, appCfg.withDebugOverlay);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAudio, appCfg.withAudio);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withThreads, appCfg.withThreads);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withParallelUpdate, appCfg.withParallelUpdate);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::parallelUpdateDepth, appCfg.parallelUpdateDepth);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::parallelUpdateMinNodes, appCfg.parallelUpdateMinNodes);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withScenegraph, appCfg.withScenegraph);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withVSync, appCfg.withVSync);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withGlDebugContext, appCfg.withGlDebugContext);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withConsoleColors, appCfg.withConsoleColors);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::headlessFrames, appCfg.headlessFrames);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::headlessReportFile, appCfg.headlessReportFile.data());
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::glCoreProfile, appCfg.glCoreProfile());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::glForwardCompatible, appCfg.glForwardCompatible());
@@ -161,14 +177,20 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 
 	const bool useBufferMapping = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::useBufferMapping);
 	appCfg.useBufferMapping = useBufferMapping;
+	const bool usePersistentMapping = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::usePersistentMapping);
+	appCfg.usePersistentMapping = usePersistentMapping;
 	const bool deferShaderQueries = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::deferShaderQueries);
 	appCfg.deferShaderQueries = deferShaderQueries;
 	const unsigned int fixedBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::fixedBatchSize);
 	appCfg.fixedBatchSize = fixedBatchSize;
+	const bool useTextureBufferBatching = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::useTextureBufferBatching);
+	appCfg.useTextureBufferBatching = useTextureBufferBatching;
 	const unsigned long vboSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::vboSize);
 	appCfg.vboSize = vboSize;
 	const unsigned long iboSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::iboSize);
 	appCfg.iboSize = iboSize;
+	const unsigned long tboSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::tboSize);
+	appCfg.tboSize = tboSize;
 	const unsigned int vaoPoolSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::vaoPoolSize);
 	appCfg.vaoPoolSize = vaoPoolSize;
 	const unsigned int renderCommandPoolSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::renderCommandPoolSize);
@@ -180,6 +202,12 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.withAudio = withAudio;
 	const bool withThreads = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withThreads);
 	appCfg.withThreads = withThreads;
+	const bool withParallelUpdate = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withParallelUpdate);
+	appCfg.withParallelUpdate = withParallelUpdate;
+	const unsigned int parallelUpdateDepth = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::parallelUpdateDepth);
+	appCfg.parallelUpdateDepth = parallelUpdateDepth;
+	const unsigned int parallelUpdateMinNodes = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::parallelUpdateMinNodes);
+	appCfg.parallelUpdateMinNodes = parallelUpdateMinNodes;
 	const bool withScenegraph = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withScenegraph);
 	appCfg.withScenegraph = withScenegraph;
 	const bool withVSync = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withVSync);
@@ -188,6 +216,10 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.withGlDebugContext = withGlDebugContext;
 	const bool withConsoleColors = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withConsoleColors);
 	appCfg.withConsoleColors = withConsoleColors;
+	const unsigned int headlessFrames = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::headlessFrames);
+	appCfg.headlessFrames = headlessFrames;
+	const char *headlessReportFile = LuaUtils::retrieveField<const char *>(L, -1, LuaNames::AppConfiguration::headlessReportFile);
+	appCfg.headlessReportFile = headlessReportFile;
 }
 
 }
@@ -45,9 +45,12 @@ namespace Application {
 	namespace RenderingSettings {
 		static const char *batchingEnabled = "batching";
 		static const char *batchingWithIndices = "batching_with_indices";
+		static const char *parallelBatchingEnabled = "parallel_batching";
+		static const char *glyphInstancingEnabled = "glyph_instancing";
 		static const char *cullingEnabled = "culling";
 		static const char *minBatchSize = "min_batch_size";
 		static const char *maxBatchSize = "max_batch_size";
+		static const char *maxTextureUploadTime = "max_texture_upload_time";
 	}
 
 	namespace DebugOverlaySettings {
@@ -120,12 +123,15 @@ int LuaApplication::renderingSettings(lua_State *L)
 {
 	const Application::RenderingSettings &settings = theApplication().renderingSettings();
 
-	lua_createtable(L, 0, 5);
+	lua_createtable(L, 0, 8);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingEnabled, settings.batchingEnabled);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::batchingWithIndices, settings.batchingWithIndices);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::parallelBatchingEnabled, settings.parallelBatchingEnabled);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::glyphInstancingEnabled, settings.glyphInstancingEnabled);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::cullingEnabled, settings.cullingEnabled);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::minBatchSize, settings.minBatchSize);
 	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::maxBatchSize, settings.maxBatchSize);
+	LuaUtils::pushField(L, LuaNames::Application::RenderingSettings::maxTextureUploadTime, settings.maxTextureUploadTime);
 
 	return 1;
 }
@@ -142,9 +148,12 @@ int LuaApplication::setRenderingSettings(lua_State *L)
 
 	settings.batchingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingEnabled);
 	settings.batchingWithIndices = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::batchingWithIndices);
+	settings.parallelBatchingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::parallelBatchingEnabled);
+	settings.glyphInstancingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::glyphInstancingEnabled);
 	settings.cullingEnabled = LuaUtils::retrieveField<bool>(L, -1, LuaNames::Application::RenderingSettings::cullingEnabled);
 	settings.minBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::Application::RenderingSettings::minBatchSize);
 	settings.maxBatchSize = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::Application::RenderingSettings::maxBatchSize);
+	settings.maxTextureUploadTime = LuaUtils::retrieveField<float>(L, -1, LuaNames::Application::RenderingSettings::maxTextureUploadTime);
 
 	return 0;
 }
@@ -25,6 +25,7 @@ namespace Font {
 	static const char *GLYPH_IN_ALPHA = "GLYPH_IN_ALPHA";
 	static const char *GLYPH_IN_RED = "GLYPH_IN_RED";
 	static const char *GLYPH_SPRITE = "GLYPH_SPRITE";
+	static const char *GLYPH_DISTANCE_FIELD = "GLYPH_DISTANCE_FIELD";
 	static const char *RenderMode = "font_render_mode";
 }}
 
@@ -59,11 +60,12 @@ void LuaFont::expose(LuaStateManager *stateManager)
 
 void LuaFont::exposeConstants(lua_State *L)
 {
-	lua_createtable(L, 0, 3);
+	lua_createtable(L, 0, 4);
 
 	LuaUtils::pushField(L, LuaNames::Font::GLYPH_IN_ALPHA, static_cast<int64_t>(Font::RenderMode::GLYPH_IN_ALPHA));
 	LuaUtils::pushField(L, LuaNames::Font::GLYPH_IN_RED, static_cast<int64_t>(Font::RenderMode::GLYPH_IN_RED));
 	LuaUtils::pushField(L, LuaNames::Font::GLYPH_SPRITE, static_cast<int64_t>(Font::RenderMode::GLYPH_SPRITE));
+	LuaUtils::pushField(L, LuaNames::Font::GLYPH_DISTANCE_FIELD, static_cast<int64_t>(Font::RenderMode::GLYPH_DISTANCE_FIELD));
 
 	lua_setfield(L, -2, LuaNames::Font::RenderMode);
 }
@@ -33,6 +33,7 @@ namespace Shader {
 	static const char *TEXTNODE_ALPHA = "TEXTNODE_ALPHA";
 	static const char *TEXTNODE_RED = "TEXTNODE_RED";
 	static const char *TEXTNODE_SPRITE = "TEXTNODE_SPRITE";
+	static const char *TEXTNODE_DISTANCE_FIELD = "TEXTNODE_DISTANCE_FIELD";
 	static const char *DefaultFragment = "shader_default_fragment";
 
 	static const char *loadFromMemory = "load_from_memory";
@@ -87,7 +88,7 @@ void LuaShader::exposeConstants(lua_State *L)
 
 	lua_setfield(L, -2, LuaNames::Shader::DefaultVertex);
 
-	lua_createtable(L, 0, 6);
+	lua_createtable(L, 0, 7);
 
 	LuaUtils::pushField(L, LuaNames::Shader::SPRITE, static_cast<int64_t>(Shader::DefaultFragment::SPRITE));
 	LuaUtils::pushField(L, LuaNames::Shader::SPRITE_GRAY, static_cast<int64_t>(Shader::DefaultFragment::SPRITE_GRAY));
@@ -95,6 +96,7 @@ void LuaShader::exposeConstants(lua_State *L)
 	LuaUtils::pushField(L, LuaNames::Shader::TEXTNODE_ALPHA, static_cast<int64_t>(Shader::DefaultFragment::TEXTNODE_ALPHA));
 	LuaUtils::pushField(L, LuaNames::Shader::TEXTNODE_RED, static_cast<int64_t>(Shader::DefaultFragment::TEXTNODE_RED));
 	LuaUtils::pushField(L, LuaNames::Shader::TEXTNODE_SPRITE, static_cast<int64_t>(Shader::DefaultFragment::TEXTNODE_SPRITE));
+	LuaUtils::pushField(L, LuaNames::Shader::TEXTNODE_DISTANCE_FIELD, static_cast<int64_t>(Shader::DefaultFragment::TEXTNODE_DISTANCE_FIELD));
 
 	lua_setfield(L, -2, LuaNames::Shader::DefaultFragment);
 }
@@ -58,6 +58,10 @@
 #include <cstring> // for memchr()
 #include "IFile.h"
 
+#ifdef COUNT_ALLOCATIONS
+	#include "AllocationCounter.h"
+#endif
+
 #include <ncine/config.h>
 #if NCINE_WITH_ALLOCATORS
 	#include <nctl/AllocManager.h>
@@ -162,7 +166,7 @@ void LuaStateManager::reopen()
 
 bool LuaStateManager::loadFromFile(const char *filename, const char *chunkName, nctl::String *errorMsg, int *status)
 {
-	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	nctl::UniquePtr<IFile> fileHandle = IFile::createMappedFileHandle(filename);
 	LOGI_X("Loading file: \"%s\"", fileHandle->filename());
 
 	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
@@ -170,6 +174,10 @@ bool LuaStateManager::loadFromFile(const char *filename, const char *chunkName,
 		return false;
 
 	const unsigned long fileSize = fileHandle->size();
+	// The chunk is loaded directly from the mapping when possible
+	if (fileHandle->data() != nullptr)
+		return loadFromMemory(chunkName, reinterpret_cast<const char *>(fileHandle->data()), fileSize, errorMsg, status);
+
 	nctl::UniquePtr<char[]> buffer = nctl::makeUnique<char[]>(fileSize);
 	fileHandle->read(buffer.get(), fileSize);
 
@@ -347,6 +355,10 @@ void *LuaStateManager::luaAllocator(void *ud, void *ptr, size_t osize, size_t ns
 	else
 	{
 #if !NCINE_WITH_ALLOCATORS
+	#ifdef COUNT_ALLOCATIONS
+		if (ptr == nullptr || nsize > osize)
+			AllocationCounter::countAllocation(nsize);
+	#endif
 		return realloc(ptr, nsize);
 #else
 		return nctl::theLuaAllocator().reallocate(ptr, nsize);
@@ -370,6 +382,10 @@ void *LuaStateManager::luaAllocatorWithStatistics(void *ud, void *ptr, size_t os
 	{
 		LuaStatistics::allocMemory(ptr != nullptr ? (nsize - osize) : nsize);
 #if !NCINE_WITH_ALLOCATORS
+	#ifdef COUNT_ALLOCATIONS
+		if (ptr == nullptr || nsize > osize)
+			AllocationCounter::countAllocation(nsize);
+	#endif
 		return realloc(ptr, nsize);
 #else
 		return nctl::theLuaAllocator().reallocate(ptr, nsize);
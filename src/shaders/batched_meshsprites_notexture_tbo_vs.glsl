@@ -0,0 +1,26 @@
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+
+// Every instance is made of six texels: four for the model matrix, then color and sprite size
+uniform samplerBuffer uInstancesTex;
+uniform int uInstancesBase;
+
+in vec2 aPosition;
+in uint aMeshIndex;
+out vec4 vColor;
+
+#define INSTANCE_TEXELS 6
+
+void main()
+{
+	int base = uInstancesBase + int(aMeshIndex) * INSTANCE_TEXELS;
+	mat4 modelMatrix = mat4(texelFetch(uInstancesTex, base), texelFetch(uInstancesTex, base + 1),
+	                        texelFetch(uInstancesTex, base + 2), texelFetch(uInstancesTex, base + 3));
+	vec4 color = texelFetch(uInstancesTex, base + 4);
+	vec2 spriteSize = texelFetch(uInstancesTex, base + 5).xy;
+
+	vec4 position = vec4(aPosition.x * spriteSize.x, aPosition.y * spriteSize.y, 0.0, 1.0);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * position;
+	vColor = color;
+}
@@ -0,0 +1,33 @@
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+
+// A two-dimensional instance: the 2x2 part of the model matrix already scaled by the sprite size,
+// the translation with the depth and a color packed in RGBA8
+struct Instance
+{
+	vec4 transform;
+	vec3 position;
+	uint color;
+};
+
+layout (std140) uniform InstancesBlock
+{
+#ifdef WITH_FIXED_BATCH_SIZE
+	Instance[BATCH_SIZE] instances;
+#else
+	Instance[2048] instances;
+#endif
+} block;
+
+out vec4 vColor;
+
+#define i block.instances[gl_VertexID / 6]
+
+void main()
+{
+	vec2 aPosition = vec2(-0.5 + float(((gl_VertexID + 2) / 3) % 2), 0.5 - float(((gl_VertexID + 1) / 3) % 2));
+	vec2 position = aPosition.x * i.transform.xy + aPosition.y * i.transform.zw + i.position.xy;
+
+	gl_Position = uProjectionMatrix * uViewMatrix * vec4(position, i.position.z, 1.0);
+	vColor = vec4(uvec4(i.color, i.color >> 8u, i.color >> 16u, i.color >> 24u) & 0xFFu) / 255.0;
+}
@@ -0,0 +1,29 @@
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+
+// Every instance is made of seven texels: four for the model matrix, then color, texture rectangle and sprite size
+uniform samplerBuffer uInstancesTex;
+uniform int uInstancesBase;
+
+out vec2 vTexCoords;
+out vec4 vColor;
+
+#define INSTANCE_TEXELS 7
+
+void main()
+{
+	int base = uInstancesBase + (gl_VertexID / 6) * INSTANCE_TEXELS;
+	mat4 modelMatrix = mat4(texelFetch(uInstancesTex, base), texelFetch(uInstancesTex, base + 1),
+	                        texelFetch(uInstancesTex, base + 2), texelFetch(uInstancesTex, base + 3));
+	vec4 color = texelFetch(uInstancesTex, base + 4);
+	vec4 texRect = texelFetch(uInstancesTex, base + 5);
+	vec2 spriteSize = texelFetch(uInstancesTex, base + 6).xy;
+
+	vec2 aPosition = vec2(-0.5 + float(((gl_VertexID + 2) / 3) % 2), 0.5 - float(((gl_VertexID + 1) / 3) % 2));
+	vec2 aTexCoords = vec2(float(((gl_VertexID + 2) / 3) % 2), float(((gl_VertexID + 1) / 3) % 2));
+	vec4 position = vec4(aPosition.x * spriteSize.x, aPosition.y * spriteSize.y, 0.0, 1.0);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * position;
+	vTexCoords = vec2(aTexCoords.x * texRect.x + texRect.y, aTexCoords.y * texRect.z + texRect.w);
+	vColor = color;
+}
@@ -0,0 +1,26 @@
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+
+// Every instance is made of five texels: four for the model matrix, then color
+uniform samplerBuffer uInstancesTex;
+uniform int uInstancesBase;
+
+in vec2 aPosition;
+in vec2 aTexCoords;
+in uint aMeshIndex;
+out vec2 vTexCoords;
+out vec4 vColor;
+
+#define INSTANCE_TEXELS 5
+
+void main()
+{
+	int base = uInstancesBase + int(aMeshIndex) * INSTANCE_TEXELS;
+	mat4 modelMatrix = mat4(texelFetch(uInstancesTex, base), texelFetch(uInstancesTex, base + 1),
+	                        texelFetch(uInstancesTex, base + 2), texelFetch(uInstancesTex, base + 3));
+	vec4 color = texelFetch(uInstancesTex, base + 4);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * vec4(aPosition, 0.0, 1.0);
+	vTexCoords = aTexCoords;
+	vColor = color;
+}
@@ -0,0 +1,20 @@
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+
+layout (std140) uniform InstanceBlock
+{
+	mat4 modelMatrix;
+};
+
+in vec2 aPosition;
+in vec2 aTexCoords;
+in vec4 aColor;
+out vec2 vTexCoords;
+out vec4 vColor;
+
+void main()
+{
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * vec4(aPosition, 0.0, 1.0);
+	vTexCoords = aTexCoords;
+	vColor = aColor;
+}
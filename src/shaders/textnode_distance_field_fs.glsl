@@ -0,0 +1,18 @@
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D uTexture;
+in vec2 vTexCoords;
+in vec4 vColor;
+out vec4 fragColor;
+
+void main()
+{
+	// The glyph edge is where the distance field crosses one half
+	float distance = texture(uTexture, vTexCoords).r;
+	// Smoothing over about one screen pixel, whatever the scale of the text
+	float smoothing = 0.7 * length(vec2(dFdx(distance), dFdy(distance)));
+	fragColor = vColor;
+	fragColor.a *= smoothstep(0.5 - smoothing, 0.5 + smoothing, distance);
+}
@@ -4,6 +4,33 @@
 #include <ncine/Application.h>
 #include <ncine/AppConfiguration.h>
 #include <ncine/Timer.h>
+#include <nctl/Atomic.h>
+
+namespace {
+
+const unsigned int NumIndices = 100000;
+const unsigned int BatchSize = 1024;
+nctl::Atomic64 indicesSum;
+
+void sumIndices(unsigned int first, unsigned int count, const void *data)
+{
+	int64_t sum = 0;
+	for (unsigned int i = first; i < first + count; i++)
+		sum += i;
+	indicesSum.fetchAdd(sum);
+}
+
+void firstJob(nc::JobId job, const void *data)
+{
+	LOGI_X("APPTEST_THREADPOOL: first job with value %d", *static_cast<const int *>(data));
+}
+
+void continuationJob(nc::JobId job, const void *data)
+{
+	LOGI("APPTEST_THREADPOOL: continuation job executed after the first one");
+}
+
+}
 
 nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
 {
@@ -23,6 +50,20 @@ void MyEventHandler::onInit()
 		LOGI_X("APPTEST_THREADPOOL: enqueued %u", i);
 		nc::Timer::sleep(1.0f);
 	}
+
+	nc::IThreadPool &threadPool = nc::theServiceLocator().threadPool();
+
+	const int value = 42;
+	nc::JobId job = threadPool.createJob(firstJob, &value, sizeof(int));
+	nc::JobId continuation = threadPool.createJob(continuationJob, nullptr, 0);
+	threadPool.addContinuation(job, continuation);
+	threadPool.run(job);
+	threadPool.wait(continuation);
+
+	indicesSum.store(0);
+	threadPool.parallelFor(NumIndices, BatchSize, sumIndices, nullptr);
+	const int64_t expectedSum = static_cast<int64_t>(NumIndices) * (NumIndices - 1) / 2;
+	LOGI_X("APPTEST_THREADPOOL: parallel sum is %lld (expected %lld)", static_cast<long long>(indicesSum.load()), static_cast<long long>(expectedSum));
 }
 
 void MyEventHandler::onKeyReleased(const nc::KeyboardEvent &event)
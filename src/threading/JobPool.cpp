@@ -0,0 +1,44 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "JobPool.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+JobPool::JobPool()
+    : jobs_(nctl::makeUnique<Job[]>(Capacity)), numAllocated_(0)
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity should be a power of two");
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+Job *JobPool::allocate(IThreadPool::JobFunction function, const void *data, unsigned int dataSize)
+{
+	FATAL_ASSERT(function != nullptr);
+	FATAL_ASSERT_MSG_X(dataSize <= IThreadPool::MaxJobDataSize, "Job data size is %u bytes but the maximum is %u", dataSize, IThreadPool::MaxJobDataSize);
+
+	// A job that has never been allocated has zero unfinished jobs too
+	Job *job = &jobs_[numAllocated_++ & (Capacity - 1)];
+	for (unsigned int i = 1; job->unfinishedJobs.load(nctl::Atomic32::MemoryModel::ACQUIRE) != 0; i++)
+	{
+		FATAL_ASSERT_MSG(i < Capacity, "Too many jobs are still unfinished to recycle the job storage");
+		job = &jobs_[numAllocated_++ & (Capacity - 1)];
+	}
+
+	job->function = function;
+	job->parent = nullptr;
+	job->unfinishedJobs.store(1, nctl::Atomic32::MemoryModel::RELAXED);
+	job->numContinuations = 0;
+	if (data && dataSize > 0)
+		memcpy(job->data, data, dataSize);
+
+	return job;
+}
+
+}
@@ -0,0 +1,77 @@
+#include "JobQueue.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+JobQueue::JobQueue()
+    : top_(0), bottom_(0)
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity should be a power of two");
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool JobQueue::push(Job *job)
+{
+	const int64_t bottom = bottom_.load(nctl::Atomic64::MemoryModel::RELAXED);
+	const int64_t top = top_.load(nctl::Atomic64::MemoryModel::ACQUIRE);
+	if (bottom - top >= static_cast<int64_t>(Capacity))
+		return false;
+
+	jobs_[bottom & (Capacity - 1)] = job;
+	// The job should be visible to stealing threads before the new bottom is
+	bottom_.store(bottom + 1, nctl::Atomic64::MemoryModel::RELEASE);
+
+	return true;
+}
+
+Job *JobQueue::pop()
+{
+	const int64_t bottom = bottom_.load(nctl::Atomic64::MemoryModel::RELAXED) - 1;
+	// Sequentially consistent store and load to order the bottom update before reading the top
+	bottom_.store(bottom, nctl::Atomic64::MemoryModel::SEQ_CST);
+	const int64_t top = top_.load(nctl::Atomic64::MemoryModel::SEQ_CST);
+
+	if (top <= bottom)
+	{
+		Job *job = jobs_[bottom & (Capacity - 1)];
+		if (top != bottom)
+			return job; // more than one job left in the queue
+
+		// This is the last job in the queue, racing against stealing threads
+		if (top_.cmpExchange(top + 1, top, nctl::Atomic64::MemoryModel::SEQ_CST) == false)
+			job = nullptr; // a stealing thread won the race
+
+		bottom_.store(top + 1, nctl::Atomic64::MemoryModel::RELAXED);
+		return job;
+	}
+
+	// The queue was already empty
+	bottom_.store(top, nctl::Atomic64::MemoryModel::RELAXED);
+	return nullptr;
+}
+
+Job *JobQueue::steal()
+{
+	const int64_t top = top_.load(nctl::Atomic64::MemoryModel::SEQ_CST);
+	const int64_t bottom = bottom_.load(nctl::Atomic64::MemoryModel::SEQ_CST);
+
+	if (top < bottom)
+	{
+		Job *job = jobs_[top & (Capacity - 1)];
+		// The owner or another stealing thread might have taken the job in the meantime
+		if (top_.cmpExchange(top + 1, top, nctl::Atomic64::MemoryModel::SEQ_CST) == false)
+			return nullptr;
+
+		return job;
+	}
+
+	return nullptr;
+}
+
+}
@@ -0,0 +1,224 @@
+#include <nctl/algorithms.h>
+#include "common_macros.h"
+#include "JobSystem.h"
+#include "JobPool.h"
+#include "JobQueue.h"
+
+namespace ncine {
+
+namespace {
+
+	/// The job system index of the current thread, invalid until it is assigned by the pool that owns the thread
+	thread_local unsigned int currentThreadIndex = JobSystem::InvalidThreadIndex;
+
+	struct ParallelForData
+	{
+		JobSystem *jobSystem;
+		IThreadPool::ParallelForFunction function;
+		const void *data;
+		unsigned int first;
+		unsigned int count;
+		unsigned int batchSize;
+	};
+
+	/// Recursively splits the range in two halves as child jobs, until the batch size is reached
+	void parallelForJob(JobId job, const void *data)
+	{
+		const ParallelForData &forData = *static_cast<const ParallelForData *>(data);
+
+		if (forData.count > forData.batchSize)
+		{
+			const unsigned int leftCount = forData.count / 2;
+
+			ParallelForData leftData = forData;
+			leftData.count = leftCount;
+			ParallelForData rightData = forData;
+			rightData.first = forData.first + leftCount;
+			rightData.count = forData.count - leftCount;
+
+			forData.jobSystem->run(forData.jobSystem->createJobAsChild(job, parallelForJob, &leftData, sizeof(ParallelForData)));
+			forData.jobSystem->run(forData.jobSystem->createJobAsChild(job, parallelForJob, &rightData, sizeof(ParallelForData)));
+		}
+		else
+			forData.function(forData.first, forData.count, forData.data);
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+JobSystem::JobSystem(unsigned int numQueues)
+    : numQueues_(numQueues), pools_(nctl::makeUnique<JobPool[]>(numQueues > 1 ? numQueues + 1 : 1)),
+      queues_(nctl::makeUnique<JobQueue[]>(numQueues)), numQueuedJobs_(0),
+      wakeFunction_(nullptr), wakeUserData_(nullptr)
+{
+	FATAL_ASSERT(numQueues > 0);
+	static_assert(sizeof(ParallelForData) <= IThreadPool::MaxJobDataSize, "Parallel for data does not fit inside a job");
+}
+
+JobSystem::~JobSystem() = default;
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void JobSystem::setWakeFunction(WakeFunction wakeFunction, void *userData)
+{
+	wakeFunction_ = wakeFunction;
+	wakeUserData_ = userData;
+}
+
+unsigned int JobSystem::threadIndex()
+{
+	return currentThreadIndex;
+}
+
+void JobSystem::setThreadIndex(unsigned int index)
+{
+	currentThreadIndex = index;
+}
+
+JobId JobSystem::createJob(IThreadPool::JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	return pools_[poolIndex()].allocate(jobFunction, data, dataSize);
+}
+
+JobId JobSystem::createJobAsChild(JobId parent, IThreadPool::JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	ASSERT(parent);
+	ASSERT_MSG(isFinished(parent) == false, "The parent job has already finished");
+
+	parent->unfinishedJobs.fetchAdd(1);
+	Job *job = pools_[poolIndex()].allocate(jobFunction, data, dataSize);
+	job->parent = parent;
+
+	return job;
+}
+
+bool JobSystem::addContinuation(JobId ancestor, JobId continuation)
+{
+	ASSERT(ancestor);
+	ASSERT(continuation);
+
+	if (ancestor->numContinuations >= IThreadPool::MaxContinuations)
+		return false;
+
+	ancestor->continuations[ancestor->numContinuations++] = continuation;
+	return true;
+}
+
+void JobSystem::run(JobId job)
+{
+	ASSERT(job);
+
+	// Incrementing the counter before pushing, so that a thread going to sleep never misses the new job
+	numQueuedJobs_.fetchAdd(1);
+	if (queues_[queueIndex()].push(job) == false)
+	{
+		// The queue is full, the job is executed immediately instead
+		numQueuedJobs_.fetchSub(1);
+		execute(job);
+		return;
+	}
+
+	if (wakeFunction_)
+		wakeFunction_(wakeUserData_);
+}
+
+bool JobSystem::isFinished(JobId job)
+{
+	ASSERT(job);
+	return (job->unfinishedJobs.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0);
+}
+
+bool JobSystem::executeNext()
+{
+	const unsigned int index = queueIndex();
+	Job *job = queues_[index].pop();
+
+	// Trying to steal from the other queues, starting from the next one
+	for (unsigned int i = 1; i < numQueues_ && job == nullptr; i++)
+		job = queues_[(index + i) % numQueues_].steal();
+
+	if (job == nullptr)
+		return false;
+
+	numQueuedJobs_.fetchSub(1);
+	execute(job);
+	return true;
+}
+
+bool JobSystem::hasQueuedJobs()
+{
+	return (numQueuedJobs_.load() > 0);
+}
+
+JobId JobSystem::createParallelFor(unsigned int count, unsigned int batchSize, IThreadPool::ParallelForFunction function, const void *data)
+{
+	ASSERT(function);
+
+	ParallelForData forData;
+	forData.jobSystem = this;
+	forData.function = function;
+	forData.data = data;
+	forData.first = 0;
+	forData.count = count;
+	forData.batchSize = nctl::max(batchSize, 1U);
+
+	return createJob(parallelForJob, &forData, sizeof(ParallelForData));
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int JobSystem::queueIndex() const
+{
+	// A serial job system is used by a single thread, whatever its index is
+	if (numQueues_ == 1)
+		return 0;
+
+	// Queues are owned by a single thread, a foreign one would race with their owner
+	FATAL_ASSERT_MSG_X(currentThreadIndex < numQueues_, "Thread index %u is not valid, only the workers and the thread that created the pool can queue jobs", currentThreadIndex);
+	return currentThreadIndex;
+}
+
+unsigned int JobSystem::poolIndex() const
+{
+	if (numQueues_ == 1)
+		return 0;
+
+	// Threads without a queue share the last pool
+	return (currentThreadIndex < numQueues_) ? currentThreadIndex : numQueues_;
+}
+
+void JobSystem::execute(Job *job)
+{
+	job->function(job, job->data);
+	finish(job);
+}
+
+void JobSystem::finish(Job *job)
+{
+	// Reading everything needed before the job is marked as finished and its storage can be recycled
+	Job *parent = job->parent;
+	const unsigned int numContinuations = job->numContinuations;
+	Job *continuations[IThreadPool::MaxContinuations];
+	for (unsigned int i = 0; i < numContinuations; i++)
+		continuations[i] = job->continuations[i];
+
+	const int32_t unfinishedJobs = job->unfinishedJobs.fetchSub(1) - 1;
+	ASSERT(unfinishedJobs >= 0);
+	if (unfinishedJobs == 0)
+	{
+		for (unsigned int i = 0; i < numContinuations; i++)
+			run(continuations[i]);
+
+		if (parent)
+			finish(parent);
+	}
+}
+
+}
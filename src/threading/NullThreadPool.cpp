@@ -0,0 +1,82 @@
+#include "common_macros.h"
+#include "IThreadPool.h"
+#include "JobSystem.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+NullThreadPool::NullThreadPool() = default;
+
+NullThreadPool::~NullThreadPool() = default;
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+JobId NullThreadPool::createJob(JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	return jobSystem().createJob(jobFunction, data, dataSize);
+}
+
+JobId NullThreadPool::createJobAsChild(JobId parent, JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	return jobSystem().createJobAsChild(parent, jobFunction, data, dataSize);
+}
+
+bool NullThreadPool::addContinuation(JobId ancestor, JobId continuation)
+{
+	return jobSystem().addContinuation(ancestor, continuation);
+}
+
+void NullThreadPool::run(JobId job)
+{
+	// Jobs are executed as soon as they are run, together with any children or continuation they queue
+	jobSystem().run(job);
+	while (jobSystem_->executeNext()) {}
+}
+
+void NullThreadPool::runInBackground(JobId job)
+{
+	run(job);
+}
+
+void NullThreadPool::wait(JobId job)
+{
+	while (JobSystem::isFinished(job) == false)
+	{
+		const bool executed = jobSystem().executeNext();
+		FATAL_ASSERT_MSG(executed, "Waiting for a job that has not been run");
+	}
+}
+
+bool NullThreadPool::isFinished(JobId job) const
+{
+	return JobSystem::isFinished(job);
+}
+
+void NullThreadPool::parallelFor(unsigned int count, unsigned int batchSize, ParallelForFunction function, const void *data)
+{
+	if (count == 0)
+		return;
+
+	JobId rootJob = jobSystem().createParallelFor(count, batchSize, function, data);
+	run(rootJob);
+	wait(rootJob);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+JobSystem &NullThreadPool::jobSystem()
+{
+	if (jobSystem_ == nullptr)
+		jobSystem_ = nctl::makeUnique<JobSystem>(1);
+
+	return *jobSystem_;
+}
+
+}
@@ -3,6 +3,17 @@
 
 namespace ncine {
 
+namespace {
+
+	/// Executes a legacy thread command and deletes it
+	void commandJob(JobId job, const void *data)
+	{
+		nctl::UniquePtr<IThreadCommand> threadCommand(*static_cast<IThreadCommand *const *>(data));
+		threadCommand->execute();
+	}
+
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -13,19 +24,19 @@ ThreadPool::ThreadPool()
 }
 
 ThreadPool::ThreadPool(unsigned int numThreads)
-    : threads_(numThreads, nctl::ArrayMode::FIXED_CAPACITY), numThreads_(numThreads)
+    : threads_(numThreads, nctl::ArrayMode::FIXED_CAPACITY), threadStructs_(numThreads, nctl::ArrayMode::FIXED_CAPACITY),
+      numThreads_(numThreads), jobSystem_(numThreads + 1), numSleepingThreads_(0), shouldQuit_(0),
+      backgroundJobs_(16), nextBackgroundJob_(0), numBackgroundJobs_(0)
 {
-	threadStruct_.queue = &queue_;
-	threadStruct_.queueMutex = &queueMutex_;
-	threadStruct_.queueCV = &queueCV_;
-	threadStruct_.shouldQuit = false;
-
-	quitMutex_.lock();
+	// The thread creating the pool uses the first queue, any other thread that is not a worker goes through the background queue
+	JobSystem::setThreadIndex(0);
+	jobSystem_.setWakeFunction(wakeWorkers, this);
 
 	nctl::String threadName;
 	for (unsigned int i = 0; i < numThreads_; i++)
 	{
-		threads_.emplaceBack(workerFunction, &threadStruct_);
+		threadStructs_.pushBack({ this, i + 1 });
+		threads_.emplaceBack(workerFunction, &threadStructs_.back());
 #if !defined(__EMSCRIPTEN__)
 	#if !defined(__APPLE__)
 		threadName.format("WorkerThread#%02d", i);
@@ -40,11 +51,16 @@ ThreadPool::ThreadPool(unsigned int numThreads)
 
 ThreadPool::~ThreadPool()
 {
-	threadStruct_.shouldQuit = true;
-	queueCV_.broadcast();
+	sleepMutex_.lock();
+	shouldQuit_.store(1);
+	sleepCV_.broadcast();
+	sleepMutex_.unlock();
 
 	for (unsigned int i = 0; i < numThreads_; i++)
 		threads_[i].join();
+
+	// Nobody else is going to execute the remaining background jobs and they might still be waited for
+	while (executeBackgroundJob()) {}
 }
 
 ///////////////////////////////////////////////////////////
@@ -55,43 +71,164 @@ void ThreadPool::enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand)
 {
 	ASSERT(threadCommand);
 
-	queueMutex_.lock();
-	queue_.pushBack(nctl::move(threadCommand));
-	queueCV_.broadcast();
-	queueMutex_.unlock();
+	// The job takes ownership of the command and deletes it after the execution
+	IThreadCommand *commandPtr = threadCommand.release();
+	// Commands can be long and are only executed by worker threads, like before the job system
+	runInBackground(createJob(commandJob, &commandPtr, sizeof(IThreadCommand *)));
+}
+
+JobId ThreadPool::createJob(JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	if (jobSystem_.isForeignThread() == false)
+		return jobSystem_.createJob(jobFunction, data, dataSize);
+
+	foreignPoolMutex_.lock();
+	JobId job = jobSystem_.createJob(jobFunction, data, dataSize);
+	foreignPoolMutex_.unlock();
+	return job;
+}
+
+JobId ThreadPool::createJobAsChild(JobId parent, JobFunction jobFunction, const void *data, unsigned int dataSize)
+{
+	if (jobSystem_.isForeignThread() == false)
+		return jobSystem_.createJobAsChild(parent, jobFunction, data, dataSize);
+
+	foreignPoolMutex_.lock();
+	JobId job = jobSystem_.createJobAsChild(parent, jobFunction, data, dataSize);
+	foreignPoolMutex_.unlock();
+	return job;
+}
+
+bool ThreadPool::addContinuation(JobId ancestor, JobId continuation)
+{
+	return jobSystem_.addContinuation(ancestor, continuation);
+}
+
+void ThreadPool::run(JobId job)
+{
+	// A thread without a queue cannot push to the work stealing ones
+	if (jobSystem_.isForeignThread())
+		runInBackground(job);
+	else
+		jobSystem_.run(job);
+}
+
+void ThreadPool::runInBackground(JobId job)
+{
+	ASSERT(job);
+
+	// The counter is incremented before the job can be taken, so that it is never lower than the number of jobs
+	backgroundMutex_.lock();
+	backgroundJobs_.pushBack(job);
+	numBackgroundJobs_.fetchAdd(1);
+	backgroundMutex_.unlock();
+
+	wakeWorkers(this);
+}
+
+void ThreadPool::wait(JobId job)
+{
+	// Helping with other jobs instead of blocking, only threads with a queue can execute them
+	const bool canHelp = (jobSystem_.isForeignThread() == false);
+	while (JobSystem::isFinished(job) == false)
+	{
+		if (canHelp == false || jobSystem_.executeNext() == false)
+			Thread::yieldExecution();
+	}
+}
+
+bool ThreadPool::isFinished(JobId job) const
+{
+	return JobSystem::isFinished(job);
+}
+
+void ThreadPool::parallelFor(unsigned int count, unsigned int batchSize, ParallelForFunction function, const void *data)
+{
+	if (count == 0)
+		return;
+
+	JobId rootJob = nullptr;
+	if (jobSystem_.isForeignThread())
+	{
+		foreignPoolMutex_.lock();
+		rootJob = jobSystem_.createParallelFor(count, batchSize, function, data);
+		foreignPoolMutex_.unlock();
+	}
+	else
+		rootJob = jobSystem_.createParallelFor(count, batchSize, function, data);
+
+	run(rootJob);
+	wait(rootJob);
 }
 
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+bool ThreadPool::executeBackgroundJob()
+{
+	if (numBackgroundJobs_.load() == 0)
+		return false;
+
+	JobId job = nullptr;
+	backgroundMutex_.lock();
+	if (nextBackgroundJob_ < backgroundJobs_.size())
+	{
+		job = backgroundJobs_[nextBackgroundJob_++];
+		// The array is only cleared when empty, so that jobs never have to be shifted
+		if (nextBackgroundJob_ == backgroundJobs_.size())
+		{
+			backgroundJobs_.clear();
+			nextBackgroundJob_ = 0;
+		}
+	}
+	backgroundMutex_.unlock();
+
+	if (job == nullptr)
+		return false;
+
+	numBackgroundJobs_.fetchSub(1);
+	jobSystem_.execute(job);
+	return true;
+}
+
 void ThreadPool::workerFunction(void *arg)
 {
 	ThreadStruct *threadStruct = static_cast<ThreadStruct *>(arg);
+	ThreadPool &threadPool = *threadStruct->threadPool;
+	JobSystem::setThreadIndex(threadStruct->index);
 
 	LOGD_X("Worker thread %u is starting", Thread::self());
 
-	while (true)
+	while (threadPool.shouldQuit_.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0)
 	{
-		threadStruct->queueMutex->lock();
-		while (threadStruct->queue->isEmpty() && threadStruct->shouldQuit == false)
-			threadStruct->queueCV->wait(*(threadStruct->queueMutex));
+		// Background jobs are only executed when there is nothing more urgent to do
+		if (threadPool.jobSystem_.executeNext() || threadPool.executeBackgroundJob())
+			continue;
+
+		// Sleeping until new jobs are queued, the counter is incremented before checking for them
+		threadPool.sleepMutex_.lock();
+		threadPool.numSleepingThreads_.fetchAdd(1);
+		while (threadPool.jobSystem_.hasQueuedJobs() == false && threadPool.numBackgroundJobs_.load() == 0 && threadPool.shouldQuit_.load() == 0)
+			threadPool.sleepCV_.wait(threadPool.sleepMutex_);
+		threadPool.numSleepingThreads_.fetchSub(1);
+		threadPool.sleepMutex_.unlock();
+	}
 
-		if (threadStruct->shouldQuit)
-		{
-			threadStruct->queueMutex->unlock();
-			break;
-		}
+	LOGD_X("Worker thread %u is exiting", Thread::self());
+}
 
-		nctl::UniquePtr<IThreadCommand> threadCommand = nctl::move(threadStruct->queue->front());
-		threadStruct->queue->popFront();
-		threadStruct->queueMutex->unlock();
+void ThreadPool::wakeWorkers(void *userData)
+{
+	ThreadPool *threadPool = static_cast<ThreadPool *>(userData);
 
-		LOGD_X("Worker thread %u is executing its command", Thread::self());
-		threadCommand->execute();
+	// The mutex is only locked when there is at least a sleeping thread to wake
+	if (threadPool->numSleepingThreads_.load() > 0)
+	{
+		threadPool->sleepMutex_.lock();
+		threadPool->sleepCV_.signal();
+		threadPool->sleepMutex_.unlock();
 	}
-
-	LOGD_X("Worker thread %u is exiting", Thread::self());
 }
 
 }
@@ -4,11 +4,18 @@
 	#include "allocators_config.h"
 #endif
 
+#ifdef COUNT_ALLOCATIONS
+	#include "AllocationCounter.h"
+#endif
+
 #ifndef OVERRIDE_NEW
 void *operator new(std::size_t count)
 {
 	auto ptr = malloc(count);
 	TracyAllocS(ptr, count, 5);
+	#ifdef COUNT_ALLOCATIONS
+	ncine::AllocationCounter::countAllocation(count);
+	#endif
 	return ptr;
 }
 
@@ -22,6 +29,9 @@ void *operator new[](std::size_t count)
 {
 	auto ptr = malloc(count);
 	TracyAllocS(ptr, count, 5);
+	#ifdef COUNT_ALLOCATIONS
+	ncine::AllocationCounter::countAllocation(count);
+	#endif
 	return ptr;
 }
 
@@ -1,15 +1,19 @@
 #include <ncine/config.h>
 
+#include <cstdlib> // for atoi()
+#include <cstring> // for strcmp()
 #include "apptest_font.h"
 #include <ncine/Application.h>
+#include <ncine/AppConfiguration.h>
 #include <ncine/IAppEventHandler.h>
+#include <ncine/Random.h>
 #include <ncine/TextNode.h>
+#include <nctl/StaticString.h>
 #include "apptest_datapath.h"
 
 #if NCINE_WITH_IMGUI
 	#include <ncine/imgui.h>
 	#include <nctl/CString.h>
-	#include <nctl/StaticString.h>
 	#include <ncine/FileSystem.h>
 #endif
 
@@ -28,9 +32,15 @@ const char *Font1FntFile = "DroidSans32_256.fnt";
 const char *Font2FntFile = "NotoSerif-Regular32_256.fnt";
 const char *Font3FntFile = "Roboto-Regular32_256.fnt";
 
+const unsigned int DefaultNumStressLabels = 2048;
+const float StressLabelMinLifetime = 1.0f;
+const float StressLabelMaxLifetime = 3.0f;
+const float StressLabelSpeed = 40.0f;
+nctl::StaticString<16> auxStressString;
+
 #if NCINE_WITH_IMGUI
 const char *AlignmentLabels[] = { "Left", "Center", "Right" };
-const char *RenderModeLabels[] = { "GLYPH_IN_ALPHA", "GLYPH_IN_RED", "GLYPH_SPRITE" };
+const char *RenderModeLabels[] = { "GLYPH_IN_ALPHA", "GLYPH_IN_RED", "GLYPH_SPRITE", "GLYPH_DISTANCE_FIELD" };
 nctl::StaticString<128> auxString;
 nctl::StaticString<256> comboString;
 nctl::String textNodeString(nc::TextNode::DefaultStringLength);
@@ -47,6 +57,8 @@ const char *renderModeToString(nc::Font::RenderMode renderMode)
 			return "GLYPH_IN_RED";
 		case nc::Font::RenderMode::GLYPH_SPRITE:
 			return "GLYPH_SPRITE";
+		case nc::Font::RenderMode::GLYPH_DISTANCE_FIELD:
+			return "GLYPH_DISTANCE_FIELD";
 	}
 }
 
@@ -60,6 +72,20 @@ nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
 void MyEventHandler::onPreInit(nc::AppConfiguration &config)
 {
 	setDataPath(config);
+
+	// The stress mode can be started from the command line, optionally with the number of labels
+	stressMode_ = false;
+	numStressLabels_ = DefaultNumStressLabels;
+	if (config.argc() > 1 && strcmp(config.argv(1), "stress") == 0)
+	{
+		stressMode_ = true;
+		if (config.argc() > 2)
+		{
+			const int numLabels = atoi(config.argv(2));
+			if (numLabels > 0)
+				numStressLabels_ = (static_cast<unsigned int>(numLabels) < MaxStressLabels) ? static_cast<unsigned int>(numLabels) : MaxStressLabels;
+		}
+	}
 }
 
 void MyEventHandler::onInit()
@@ -72,6 +98,9 @@ void MyEventHandler::onInit()
 	                                           (prefixDataPath("fonts", Font2TextureFile)).data()));
 	fonts_.pushBack(nctl::makeUnique<nc::Font>((prefixDataPath("fonts", Font3FntFile)).data(),
 	                                           (prefixDataPath("fonts", Font3TextureFile)).data()));
+	// The distance field atlas is generated from the first font the first time, then it is loaded from the cache
+	fonts_.pushBack(nctl::makeUnique<nc::Font>());
+	fonts_[3]->loadDistanceFieldFromFile((prefixDataPath("fonts", Font1FntFile)).data(), nc::Font::DistanceFieldSettings());
 
 	const char testString[] = "WAY.P.ATAV";
 	float textHeight = nc::theApplication().height() * 0.8f;
@@ -121,6 +150,13 @@ void MyEventHandler::onInit()
 	texts_[5]->enableKerning(false);
 	texts_[5]->setColor(0, 0, 255, 128);
 
+	texts_.pushBack(nctl::makeUnique<nc::TextNode>(&rootNode, fonts_[3].get()));
+	texts_[6]->setScale(4.0f);
+	texts_[6]->setString(testString);
+	textHeight -= texts_[5]->height() * 0.5f + texts_[5]->height();
+	texts_[6]->setPosition(screenWidth * 0.5f, textHeight);
+	texts_[6]->setColor(255, 255, 255, 255);
+
 #if NCINE_WITH_IMGUI
 	comboString.clear();
 	for (unsigned int i = 0; i < NumFonts; i++)
@@ -132,10 +168,17 @@ void MyEventHandler::onInit()
 	// Append a second '\0' to signal the end of the combo item list
 	comboString[comboString.length() - 1] = '\0';
 #endif
+
+	stressRoot_ = nctl::makeUnique<nc::SceneNode>(&rootNode);
+	stressLabels_.setCapacity(MaxStressLabels);
+	setStressMode(stressMode_);
 }
 
 void MyEventHandler::onFrameStart()
 {
+	if (stressMode_)
+		updateStressLabels(nc::theApplication().interval());
+
 #if NCINE_WITH_IMGUI
 	ImGui::SetNextWindowSize(ImVec2(400.0f, 430.0f), ImGuiCond_FirstUseEver);
 	ImGui::SetNextWindowPos(ImVec2(50.0f, 120.0f), ImGuiCond_FirstUseEver);
@@ -189,6 +232,10 @@ void MyEventHandler::onFrameStart()
 					if (ImGui::Combo("Render mode", &currentRenderMode, RenderModeLabels, IM_ARRAYSIZE(RenderModeLabels)))
 						texts_[i]->setRenderMode(static_cast<nc::Font::RenderMode>(currentRenderMode));
 
+					float scale = texts_[i]->scale().x;
+					if (ImGui::SliderFloat("Scale", &scale, 0.25f, 8.0f))
+						texts_[i]->setScale(scale);
+
 					nc::Colorf color(texts_[i]->color());
 					if (ImGui::ColorEdit4("Color", color.data()))
 						texts_[i]->setColor(color);
@@ -210,6 +257,27 @@ void MyEventHandler::onFrameStart()
 					ImGui::TreePop();
 				}
 			}
+
+			if (ImGui::TreeNode("Stress mode"))
+			{
+				bool stressMode = stressMode_;
+				if (ImGui::Checkbox("Enabled", &stressMode))
+					setStressMode(stressMode);
+
+				int numStressLabels = static_cast<int>(numStressLabels_);
+				if (ImGui::SliderInt("Labels", &numStressLabels, 1, MaxStressLabels))
+				{
+					numStressLabels_ = static_cast<unsigned int>(numStressLabels);
+					if (stressMode_)
+						setStressMode(true);
+				}
+
+				nc::Application::RenderingSettings &settings = nc::theApplication().renderingSettings();
+				ImGui::Checkbox("Glyph instancing", &settings.glyphInstancingEnabled);
+				ImGui::Text("Frame time: %.3f ms", nc::theApplication().interval() * 1000.0f);
+
+				ImGui::TreePop();
+			}
 		}
 		ImGui::End();
 	}
@@ -220,8 +288,69 @@ void MyEventHandler::onKeyReleased(const nc::KeyboardEvent &event)
 {
 	if (event.sym == nc::KeySym::ESCAPE)
 		nc::theApplication().quit();
+	else if (event.sym == nc::KeySym::S)
+		setStressMode(!stressMode_);
+	else if (event.sym == nc::KeySym::G)
+	{
+		nc::Application::RenderingSettings &settings = nc::theApplication().renderingSettings();
+		settings.glyphInstancingEnabled = !settings.glyphInstancingEnabled;
+	}
 #if NCINE_WITH_IMGUI
 	else if (event.mod & nc::KeyMod::CTRL && event.sym == nc::KeySym::H)
 		showImGui = !showImGui;
 #endif
 }
+
+void MyEventHandler::setStressMode(bool enabled)
+{
+	stressMode_ = enabled;
+	stressRoot_->setEnabled(enabled);
+
+	const unsigned int numLabels = enabled ? numStressLabels_ : 0;
+	// Every label uses the same font, their glyphs can be collected into a few batches
+	while (stressLabels_.size() < numLabels)
+	{
+		stressLabels_.emplaceBack();
+		StressLabel &label = stressLabels_.back();
+		label.textNode = nctl::makeUnique<nc::TextNode>(stressRoot_.get(), fonts_[0].get(), 16);
+		label.counting = (stressLabels_.size() % 4 == 0);
+		spawnStressLabel(label);
+	}
+	if (stressLabels_.size() > numLabels)
+		stressLabels_.setSize(numLabels);
+}
+
+void MyEventHandler::updateStressLabels(float interval)
+{
+	for (StressLabel &label : stressLabels_)
+	{
+		label.lifetime -= interval;
+		if (label.lifetime <= 0.0f)
+		{
+			spawnStressLabel(label);
+			continue;
+		}
+
+		label.textNode->moveY(StressLabelSpeed * interval);
+		label.textNode->setAlphaF(label.lifetime < 1.0f ? label.lifetime : 1.0f);
+		if (label.counting)
+		{
+			label.value++;
+			auxStressString.format("%u", label.value);
+			label.textNode->setString(auxStressString.data());
+		}
+	}
+}
+
+void MyEventHandler::spawnStressLabel(StressLabel &label)
+{
+	nc::TextNode &textNode = *label.textNode;
+	textNode.setPosition(nc::random().fastReal(0.0f, nc::theApplication().width()), nc::random().fastReal(0.0f, nc::theApplication().height()));
+	textNode.setScale(nc::random().fastReal(0.3f, 0.6f));
+	textNode.setColor(nc::random().fastInteger(128, 256), nc::random().fastInteger(128, 256), nc::random().fastInteger(128, 256), 255);
+
+	label.lifetime = nc::random().fastReal(StressLabelMinLifetime, StressLabelMaxLifetime);
+	label.value = nc::random().fastInteger(1, 10000);
+	auxStressString.format(label.counting ? "%u" : "-%u", label.value);
+	textNode.setString(auxStressString.data());
+}
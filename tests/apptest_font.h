@@ -4,11 +4,13 @@
 #include <ncine/IAppEventHandler.h>
 #include <ncine/IInputEventHandler.h>
 #include <nctl/StaticArray.h>
+#include <nctl/Array.h>
 
 namespace ncine {
 
 class AppConfiguration;
 class Font;
+class SceneNode;
 class TextNode;
 
 }
@@ -28,11 +30,33 @@ class MyEventHandler :
 	void onKeyReleased(const nc::KeyboardEvent &event) override;
 
   private:
-	static const unsigned int NumFonts = 3;
-	static const unsigned int NumTexts = 6;
+	static const unsigned int NumFonts = 4;
+	static const unsigned int NumTexts = 7;
 
 	nctl::StaticArray<nctl::UniquePtr<nc::Font>, NumFonts> fonts_;
 	nctl::StaticArray<nctl::UniquePtr<nc::TextNode>, NumTexts> texts_;
+
+	/// Maximum number of labels spawned by the stress mode
+	static const unsigned int MaxStressLabels = 8192;
+
+	/// A small label spawned by the stress mode, like a damage number or a name plate
+	struct StressLabel
+	{
+		nctl::UniquePtr<nc::TextNode> textNode;
+		float lifetime;
+		unsigned int value;
+		/// True if the value changes every frame, like a counter
+		bool counting;
+	};
+
+	bool stressMode_;
+	unsigned int numStressLabels_;
+	nctl::UniquePtr<nc::SceneNode> stressRoot_;
+	nctl::Array<StressLabel> stressLabels_;
+
+	void setStressMode(bool enabled);
+	void updateStressLabels(float interval);
+	void spawnStressLabel(StressLabel &label);
 };
 
 #endif
@@ -0,0 +1,136 @@
+#include <cstdlib> // for atoi() and EXIT_FAILURE
+#include <cmath> // for sinf() and cosf()
+#include "apptest_headless.h"
+#include <ncine/Application.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/IFile.h>
+#include <ncine/common_constants.h>
+#include <ncine/Texture.h>
+#include <ncine/Sprite.h>
+#include "apptest_datapath.h"
+
+namespace {
+
+#ifdef __ANDROID__
+const char *Texture1File = "texture1_ETC2.ktx";
+const char *Texture2File = "texture2_ETC2.ktx";
+const char *Texture3File = "texture3_ETC2.ktx";
+const char *Texture4File = "texture4_ETC2.ktx";
+#else
+const char *Texture1File = "texture1.png";
+const char *Texture2File = "texture2.png";
+const char *Texture3File = "texture3.png";
+const char *Texture4File = "texture4.png";
+#endif
+
+const unsigned int DefaultNumFrames = 600;
+const char *DefaultReportFile = "headless_report.json";
+
+const float SpriteScale = 0.15f;
+const float SpriteSpacing = 18.0f;
+const unsigned int SpritesPerRow = 16;
+const float GroupRadius = 0.35f;
+
+/// Returns true if the report file exists, is complete and contains the expected number of frames
+bool isReportValid(const char *filename, unsigned int numFrames)
+{
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename);
+	fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false || fileHandle->size() == 0)
+		return false;
+
+	nctl::String report(fileHandle->size() + 1);
+	report.setLength(fileHandle->read(report.data(), fileHandle->size()));
+	if (report.length() != fileHandle->size() || report[0] != '{' || report.find("\t}\n}\n") < 0)
+		return false;
+
+	nctl::String framesEntry(32);
+	framesEntry.format("\"frames\": %u,", numFrames);
+	return (report.find(framesEntry) >= 0);
+}
+
+}
+
+nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
+{
+	return nctl::makeUnique<MyEventHandler>();
+}
+
+void MyEventHandler::onPreInit(nc::AppConfiguration &config)
+{
+	setDataPath(config);
+
+	config.windowTitle = "apptest_headless";
+	config.resolution.set(1280, 720);
+	config.withVSync = false;
+
+	// The number of frames and the report file can be specified on the command line
+	config.headlessFrames = DefaultNumFrames;
+	config.headlessReportFile = DefaultReportFile;
+	if (config.argc() > 1)
+	{
+		const int numFrames = atoi(config.argv(1));
+		if (numFrames > 0)
+			config.headlessFrames = static_cast<unsigned int>(numFrames);
+	}
+	if (config.argc() > 2)
+		config.headlessReportFile = config.argv(2);
+}
+
+void MyEventHandler::onInit()
+{
+	nc::SceneNode &rootNode = nc::theApplication().rootNode();
+	const float width = nc::theApplication().width();
+	const float height = nc::theApplication().height();
+
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture1File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture2File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture3File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture4File)).data()));
+
+	// Every group is a grid of sprites placed on a circle around the center of the screen
+	const float gridOffset = (SpritesPerRow - 1) * SpriteSpacing * 0.5f;
+	sprites_.setCapacity(NumGroups * SpritesPerGroup);
+	for (unsigned int i = 0; i < NumGroups; i++)
+	{
+		const float groupAngle = 2.0f * nc::fPi * i / static_cast<float>(NumGroups);
+		const float x = width * 0.5f + width * GroupRadius * cosf(groupAngle);
+		const float y = height * 0.5f + height * GroupRadius * sinf(groupAngle);
+		groups_.pushBack(nctl::makeUnique<nc::SceneNode>(&rootNode, x, y));
+
+		for (unsigned int j = 0; j < SpritesPerGroup; j++)
+		{
+			const float spriteX = (j % SpritesPerRow) * SpriteSpacing - gridOffset;
+			const float spriteY = (j / SpritesPerRow) * SpriteSpacing - gridOffset;
+			nc::Texture *texture = textures_[(i + j) % NumTextures].get();
+			sprites_.pushBack(nctl::makeUnique<nc::Sprite>(groups_.back().get(), texture, spriteX, spriteY));
+			sprites_.back()->setScale(SpriteScale);
+		}
+	}
+
+	angle_ = 0.0f;
+}
+
+void MyEventHandler::onShutdown()
+{
+	// The report is written before shutting down, the test fails if it is missing or incomplete
+	const nc::AppConfiguration &appCfg = nc::theApplication().appConfiguration();
+	if (isReportValid(appCfg.headlessReportFile.data(), appCfg.headlessFrames) == false)
+	{
+		LOGE_X("The headless report \"%s\" is missing or invalid", appCfg.headlessReportFile.data());
+		nc::theApplication().setExitCode(EXIT_FAILURE);
+	}
+}
+
+void MyEventHandler::onFrameStart()
+{
+	const float interval = nc::theApplication().interval();
+	angle_ += interval * 20.0f;
+	if (angle_ > 360.0f)
+		angle_ -= 360.0f;
+
+	for (unsigned int i = 0; i < NumGroups; i++)
+		groups_[i]->setRotation((i % 2 == 0) ? angle_ : -angle_);
+	for (unsigned int i = 0; i < sprites_.size(); i++)
+		sprites_[i]->setRotation(angle_ * 2.0f + i);
+}
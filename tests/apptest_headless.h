@@ -0,0 +1,42 @@
+#ifndef CLASS_MYEVENTHANDLER
+#define CLASS_MYEVENTHANDLER
+
+#include <ncine/IAppEventHandler.h>
+#include <nctl/Array.h>
+#include <nctl/StaticArray.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class AppConfiguration;
+class Texture;
+class SceneNode;
+class Sprite;
+
+}
+
+namespace nc = ncine;
+
+/// My nCine event handler
+class MyEventHandler :
+    public nc::IAppEventHandler
+{
+  public:
+	static const unsigned int NumTextures = 4;
+	static const unsigned int NumGroups = 16;
+	static const unsigned int SpritesPerGroup = 256;
+
+	void onPreInit(nc::AppConfiguration &config) override;
+	void onInit() override;
+	void onFrameStart() override;
+	void onShutdown() override;
+
+  private:
+	float angle_;
+
+	nctl::StaticArray<nctl::UniquePtr<nc::Texture>, NumTextures> textures_;
+	nctl::StaticArray<nctl::UniquePtr<nc::SceneNode>, NumGroups> groups_;
+	nctl::Array<nctl::UniquePtr<nc::Sprite>> sprites_;
+};
+
+#endif
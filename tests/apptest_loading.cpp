@@ -97,6 +97,19 @@ int loadedShader = -1;
 
 bool showImGui = true;
 
+const unsigned int MaxStreamedTextures = 64;
+const unsigned int NumBenchmarkFrames = 120;
+bool asyncStreaming = true;
+int numStreamedTextures = 16;
+bool benchmarkRunning = false;
+unsigned long int benchmarkStartFrame = 0;
+unsigned int numStreamedLoaded = 0;
+unsigned int numRecordedFrames = 0;
+float benchmarkFrameTimes[NumBenchmarkFrames];
+float maxFrameTime = 0.0f;
+float averageFrameTime = 0.0f;
+int completionFrame = -1;
+
 const char *audioPlayerStateToString(nc::IAudioPlayer::PlayerState state)
 {
 	switch (state)
@@ -225,6 +238,9 @@ void MyEventHandler::onInit()
 
 void MyEventHandler::onFrameStart()
 {
+	if (benchmarkRunning)
+		recordStreamingBenchmark();
+
 	ImGui::SetNextWindowSize(ImVec2(500.0f, 500.0f), ImGuiCond_FirstUseEver);
 	ImGui::SetNextWindowPos(ImVec2(20.0f, 20.0f), ImGuiCond_FirstUseEver);
 	if (showImGui)
@@ -254,7 +270,7 @@ void MyEventHandler::onFrameStart()
 				{
 					bool textureHasChanged = false;
 					nc::Texture &tex = *textures_[selectedTextureObject];
-					ImGui::Text("Name: \"%s\"", tex.name());
+					ImGui::Text("Name: \"%s\"%s", tex.name(), tex.isLoading() ? " (loading)" : "");
 					ImGui::Text("Size: %d x %d, Channels: %u", tex.width(), tex.height(), tex.numChannels());
 
 					if (ImGui::TreeNode("Load from File or Memory##Textures"))
@@ -276,6 +292,9 @@ void MyEventHandler::onFrameStart()
 							textureHasChanged = hasLoaded;
 						}
 						ImGui::SameLine();
+						if (ImGui::Button("Load Async") && selectedTexture >= 0 && selectedTexture < NumTextures)
+							tex.loadFromFileAsync((prefixDataPath("textures", TextureFiles[selectedTexture])).data(), onTextureLoaded, this);
+						ImGui::SameLine();
 						if (ImGui::Button("Load from Memory") && selectedTexture >= 0 && selectedTexture < NumTextures)
 						{
 							const bool hasLoaded = tex.loadFromMemory(TextureFiles[selectedTexture],
@@ -440,6 +459,26 @@ void MyEventHandler::onFrameStart()
 					ImGui::TextUnformatted("Select a texture object from the list");
 			}
 
+			if (ImGui::CollapsingHeader("Streaming Benchmark"))
+			{
+				ImGui::Checkbox("Asynchronous", &asyncStreaming);
+				ImGui::SliderInt("Textures", &numStreamedTextures, 1, MaxStreamedTextures);
+				if (ImGui::Button("Start") && benchmarkRunning == false)
+					startStreamingBenchmark();
+
+				if (benchmarkRunning)
+					ImGui::Text("Recording: %u/%u frames, %u/%u textures loaded", numRecordedFrames, NumBenchmarkFrames, numStreamedLoaded, streamedTextures_.size());
+				else if (numRecordedFrames > 0)
+				{
+					ImGui::PlotLines("Frame times", benchmarkFrameTimes, numRecordedFrames, 0, nullptr, 0.0f, maxFrameTime, ImVec2(0.0f, 80.0f));
+					ImGui::Text("Max frame time: %.2f ms, Average: %.2f ms", maxFrameTime, averageFrameTime);
+					if (completionFrame >= 0)
+						ImGui::Text("All textures loaded after %d frames", completionFrame);
+					else
+						ImGui::Text("%u/%u textures loaded after %u frames", numStreamedLoaded, streamedTextures_.size(), NumBenchmarkFrames);
+				}
+			}
+
 			if (ImGui::CollapsingHeader("Audio"))
 			{
 				ImGui::Text("Buffer Name: \"%s\"", audioBuffer_->name());
@@ -764,6 +803,79 @@ void MyEventHandler::onFrameStart()
 	}
 }
 
+void MyEventHandler::onTextureLoaded(nc::Texture &texture, bool hasLoaded, void *userData)
+{
+	if (hasLoaded == false)
+	{
+		LOGW_X("Cannot load asynchronously \"%s\"", texture.name());
+		return;
+	}
+
+	MyEventHandler *eventHandler = static_cast<MyEventHandler *>(userData);
+	if (selectedTextureObject >= 0 && selectedTextureObject < NumTextures && eventHandler->textures_[selectedTextureObject].get() == &texture)
+		texelsRegion.set(0, 0, texture.width(), texture.height());
+	for (unsigned int i = 0; i < NumSprites; i++)
+	{
+		if (eventHandler->sprites_[i]->texture() == &texture)
+			eventHandler->sprites_[i]->setTexture(&texture);
+	}
+}
+
+void MyEventHandler::onStreamedTextureLoaded(nc::Texture &texture, bool hasLoaded, void *userData)
+{
+	numStreamedLoaded++;
+}
+
+void MyEventHandler::startStreamingBenchmark()
+{
+	// Pending asynchronous requests are cancelled when their textures are destroyed
+	streamedTextures_.clear();
+	numStreamedLoaded = 0;
+	numRecordedFrames = 0;
+	completionFrame = -1;
+
+	for (int i = 0; i < numStreamedTextures; i++)
+	{
+		streamedTextures_.pushBack(nctl::makeUnique<nc::Texture>());
+		const nctl::String filename = prefixDataPath("textures", TextureFiles[i % NumTextures]);
+		if (asyncStreaming)
+			streamedTextures_.back()->loadFromFileAsync(filename.data(), onStreamedTextureLoaded, nullptr);
+		else
+		{
+			streamedTextures_.back()->loadFromFile(filename.data());
+			numStreamedLoaded++;
+		}
+	}
+
+	benchmarkRunning = true;
+	benchmarkStartFrame = nc::theApplication().numFrames();
+}
+
+void MyEventHandler::recordStreamingBenchmark()
+{
+	// The interval of the frame that started the benchmark includes synchronous loadings only from the next one
+	if (nc::theApplication().numFrames() <= benchmarkStartFrame)
+		return;
+
+	benchmarkFrameTimes[numRecordedFrames] = nc::theApplication().interval() * 1000.0f;
+	numRecordedFrames++;
+	if (completionFrame < 0 && numStreamedLoaded == streamedTextures_.size())
+		completionFrame = static_cast<int>(numRecordedFrames);
+
+	if (numRecordedFrames == NumBenchmarkFrames)
+	{
+		maxFrameTime = 0.0f;
+		float totalFrameTime = 0.0f;
+		for (unsigned int i = 0; i < numRecordedFrames; i++)
+		{
+			maxFrameTime = nctl::max(maxFrameTime, benchmarkFrameTimes[i]);
+			totalFrameTime += benchmarkFrameTimes[i];
+		}
+		averageFrameTime = totalFrameTime / numRecordedFrames;
+		benchmarkRunning = false;
+	}
+}
+
 void MyEventHandler::onKeyReleased(const nc::KeyboardEvent &event)
 {
 	if (event.mod & nc::KeyMod::CTRL && event.sym == nc::KeySym::H)
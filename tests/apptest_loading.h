@@ -4,6 +4,7 @@
 #include <ncine/IAppEventHandler.h>
 #include <ncine/IInputEventHandler.h>
 #include <nctl/StaticArray.h>
+#include <nctl/Array.h>
 #include <ncine/Vector2.h>
 
 namespace ncine {
@@ -56,6 +57,13 @@ class MyEventHandler :
 	nctl::UniquePtr<nc::LuaStateManager> luaState_;
 
 	nctl::UniquePtr<nc::Shader> shader_;
+
+	nctl::Array<nctl::UniquePtr<nc::Texture>> streamedTextures_;
+
+	static void onTextureLoaded(nc::Texture &texture, bool hasLoaded, void *userData);
+	static void onStreamedTextureLoaded(nc::Texture &texture, bool hasLoaded, void *userData);
+	void startStreamingBenchmark();
+	void recordStreamingBenchmark();
 };
 
 #endif
@@ -0,0 +1,275 @@
+#include <cstdlib> // for EXIT_FAILURE
+#include <cstring> // for strlen()
+#include <ncine/config.h>
+
+#include "apptest_steadystate.h"
+#include <ncine/Application.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/AllocationCounter.h>
+#include <ncine/Texture.h>
+#include <ncine/Font.h>
+#include <ncine/Sprite.h>
+#include <ncine/MeshSprite.h>
+#include <ncine/TextNode.h>
+#include <ncine/ParticleSystem.h>
+#include <ncine/ParticleInitializer.h>
+#include <ncine/ParticleAffectors.h>
+#include "apptest_datapath.h"
+
+#if NCINE_WITH_LUA
+	#include <ncine/LuaStateManager.h>
+	#include <ncine/LuaUtils.h>
+	#include <ncine/LuaDebug.h>
+#endif
+
+namespace {
+
+#ifdef __ANDROID__
+const char *Texture1File = "texture1_cutout_ETC2.ktx";
+const char *Texture2File = "texture2_cutout_ETC2.ktx";
+const char *Texture3File = "texture3_cutout_ETC2.ktx";
+const char *Texture4File = "texture4_cutout_ETC2.ktx";
+const char *FontTextureFile = "DroidSans32_256_ETC2.ktx";
+#else
+const char *Texture1File = "texture1_cutout.png";
+const char *Texture2File = "texture2_cutout.png";
+const char *Texture3File = "texture3_cutout.png";
+const char *Texture4File = "texture4_cutout.png";
+const char *FontTextureFile = "DroidSans32_256.png";
+#endif
+const char *FontFntFile = "DroidSans32_256.fnt";
+
+const float SpriteScale = 0.25f;
+const float SpriteSpacing = 40.0f;
+const unsigned int SpritesPerRow = 16;
+const float MeshSpriteScale = 0.35f;
+const unsigned int EmitEveryFrames = 4;
+
+const unsigned int NumTexelPoints = 5;
+const nc::Vector2f TexelPoints[NumTexelPoints] = {
+	{ 3.0f, 79.0f }, { 26.0f, 2.0f }, { 64.0f, 125.0f }, { 102.0f, 2.0f }, { 125.0f, 79.0f }
+};
+
+/// Names of the allocation zones set by the application
+const char *zoneName(unsigned int zone)
+{
+	switch (zone)
+	{
+		case nc::Application::Timings::FRAME_START: return "onFrameStart";
+		case nc::Application::Timings::UPDATE: return "Update";
+		case nc::Application::Timings::POST_UPDATE: return "onPostUpdate";
+		case nc::Application::Timings::VISIT: return "Visit";
+		case nc::Application::Timings::DRAW: return "Draw";
+		case nc::Application::Timings::IMGUI: return "ImGui";
+		case nc::Application::Timings::NUKLEAR: return "Nuklear";
+		case nc::Application::Timings::FRAME_END: return "onFrameEnd";
+		default: return "Other";
+	}
+}
+
+#if NCINE_WITH_LUA
+const char *LuaCallbackName = "on_frame";
+const char *LuaScript =
+    "angle = 0.0\n"
+    "function on_frame(interval)\n"
+    "  angle = (angle + interval * 2.0) % 6.283\n"
+    "  return angle\n"
+    "end\n";
+#endif
+
+nc::ParticleInitializer particleInit;
+
+}
+
+nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
+{
+	return nctl::makeUnique<MyEventHandler>();
+}
+
+void MyEventHandler::onPreInit(nc::AppConfiguration &config)
+{
+	setDataPath(config);
+
+	config.windowTitle = "apptest_steadystate";
+	config.resolution.set(960, 540);
+	config.withVSync = false;
+}
+
+void MyEventHandler::onInit()
+{
+	nc::SceneNode &rootNode = nc::theApplication().rootNode();
+	const float width = nc::theApplication().width();
+	const float height = nc::theApplication().height();
+
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture1File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture2File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture3File)).data()));
+	textures_.pushBack(nctl::makeUnique<nc::Texture>((prefixDataPath("textures", Texture4File)).data()));
+	font_ = nctl::makeUnique<nc::Font>((prefixDataPath("fonts", FontFntFile)).data(),
+	                                   (prefixDataPath("fonts", FontTextureFile)).data());
+
+	// The test runs unattended, it fails instead of rendering a scene with missing resources
+	bool resourcesLoaded = (font_->numGlyphs() > 0);
+	for (unsigned int i = 0; i < NumTextures; i++)
+		resourcesLoaded = resourcesLoaded && (textures_[i]->width() > 0);
+	if (resourcesLoaded == false)
+	{
+		LOGE("Cannot load the resources of the test");
+		nc::theApplication().setExitCode(EXIT_FAILURE);
+		nc::theApplication().quit();
+		return;
+	}
+
+	parentNode_ = nctl::makeUnique<nc::SceneNode>(&rootNode, width * 0.5f, height * 0.5f);
+	const float gridOffsetX = (SpritesPerRow - 1) * SpriteSpacing * 0.5f;
+	const float gridOffsetY = (NumSprites / SpritesPerRow - 1) * SpriteSpacing * 0.5f;
+	for (unsigned int i = 0; i < NumSprites; i++)
+	{
+		const float x = (i % SpritesPerRow) * SpriteSpacing - gridOffsetX;
+		const float y = (i / SpritesPerRow) * SpriteSpacing - gridOffsetY;
+		sprites_.pushBack(nctl::makeUnique<nc::Sprite>(parentNode_.get(), textures_[i % NumTextures].get(), x, y));
+		sprites_.back()->setScale(SpriteScale);
+	}
+
+	for (unsigned int i = 0; i < NumMeshSprites; i++)
+	{
+		const float x = (i % SpritesPerRow) * SpriteSpacing * 1.5f - gridOffsetX * 1.5f;
+		const float y = -height * 0.4f + (i / SpritesPerRow) * SpriteSpacing;
+		meshSprites_.pushBack(nctl::makeUnique<nc::MeshSprite>(&rootNode, textures_[i % NumTextures].get(), width * 0.5f + x, height * 0.5f + y));
+		meshSprites_.back()->setScale(MeshSpriteScale);
+		if (i < NumTextures)
+			meshSprites_.back()->createVerticesFromTexels(NumTexelPoints, TexelPoints);
+		else
+			meshSprites_.back()->setVertices(*meshSprites_[i % NumTextures]);
+	}
+
+	particleSystem_ = nctl::makeUnique<nc::ParticleSystem>(&rootNode, static_cast<unsigned int>(NumParticles), textures_[0].get(), textures_[0]->rect());
+	particleSystem_->setPosition(width * 0.5f, height * 0.2f);
+	nctl::UniquePtr<nc::ColorAffector> colorAffector = nctl::makeUnique<nc::ColorAffector>();
+	colorAffector->addColorStep(0.0f, nc::Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+	colorAffector->addColorStep(1.0f, nc::Colorf(1.0f, 1.0f, 1.0f, 0.0f));
+	particleSystem_->addAffector(nctl::move(colorAffector));
+	nctl::UniquePtr<nc::SizeAffector> sizeAffector = nctl::makeUnique<nc::SizeAffector>(0.2f);
+	sizeAffector->addSizeStep(0.0f, 1.0f);
+	sizeAffector->addSizeStep(1.0f, 0.1f);
+	particleSystem_->addAffector(nctl::move(sizeAffector));
+
+	particleInit.setAmount(3);
+	particleInit.setLife(0.6f, 0.8f);
+	particleInit.setPositionAndRadius(nc::Vector2f::Zero, 10.0f);
+	particleInit.setVelocityAndScale(nc::Vector2f(0.0f, 250.0f), 0.8f, 1.0f);
+
+	textString_ = nctl::String(128);
+	textNode_ = nctl::makeUnique<nc::TextNode>(&rootNode, font_.get(), 128);
+	textNode_->setPosition(width * 0.5f, height - font_->lineHeight());
+	textNode_->setAlignment(nc::TextNode::Alignment::CENTER);
+
+#if NCINE_WITH_LUA
+	luaState_ = nctl::makeUnique<nc::LuaStateManager>(
+	    nc::LuaStateManager::ApiType::NONE,
+	    nc::LuaStateManager::StatisticsTracking::DISABLED,
+	    nc::LuaStateManager::StandardLibraries::NOT_LOADED);
+	if (luaState_->runFromMemory("steadystate_script", LuaScript, strlen(LuaScript)) == false)
+		LOGE("Cannot run the Lua script");
+#endif
+
+	numFrames_ = 0;
+	numAllocatingFrames_ = 0;
+	numSteadyAllocations_ = 0;
+	angle_ = 0.0f;
+
+	if (nc::AllocationCounter::isAvailable() == false)
+	{
+		// Without counting the test cannot check anything, it fails instead of passing vacuously
+		LOGE("The engine has been compiled without the NCINE_COUNT_ALLOCATIONS option, allocations cannot be counted");
+		nc::theApplication().setExitCode(EXIT_FAILURE);
+		nc::theApplication().quit();
+	}
+}
+
+void MyEventHandler::onFrameStart()
+{
+	// The counters of the last frame are complete at the start of a new one
+	if (numFrames_ > WarmupFrames)
+		checkLastFrame();
+
+	if (numFrames_ == WarmupFrames + CheckedFrames)
+	{
+		finish();
+		return;
+	}
+	numFrames_++;
+
+	const float interval = nc::theApplication().interval();
+	angle_ = runLuaCallback(interval);
+
+	parentNode_->setRotation(angle_ * 10.0f);
+	for (unsigned int i = 0; i < NumSprites; i++)
+		sprites_[i]->setRotation(angle_ * 57.3f + i);
+	for (unsigned int i = 0; i < NumMeshSprites; i++)
+		meshSprites_[i]->setRotation(-angle_ * 57.3f);
+
+	if (numFrames_ % EmitEveryFrames == 0)
+		particleSystem_->emitParticles(particleInit);
+
+	// The string has a fixed length to be written in the same memory every frame
+	textString_.format("Frame %06u - %u allocating frame(s)", numFrames_, numAllocatingFrames_);
+	textNode_->setString(textString_);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void MyEventHandler::checkLastFrame()
+{
+	const nc::AllocationCounter::Counters lastFrame = nc::AllocationCounter::lastFrame();
+	if (lastFrame.numAllocations == 0)
+		return;
+
+	numAllocatingFrames_++;
+	numSteadyAllocations_ += lastFrame.numAllocations;
+
+	LOGW_X("Frame %u performed %lu allocation(s) of %lu bytes", numFrames_, lastFrame.numAllocations, lastFrame.bytes);
+	for (unsigned int i = 0; i <= nc::AllocationCounter::MaxZones; i++)
+	{
+		const nc::AllocationCounter::Counters zone = nc::AllocationCounter::lastFrame(i);
+		if (zone.numAllocations > 0)
+			LOGW_X("- %s: %lu allocation(s) of %lu bytes", zoneName(i), zone.numAllocations, zone.bytes);
+	}
+}
+
+void MyEventHandler::finish()
+{
+	if (numAllocatingFrames_ > 0)
+	{
+		LOGE_X("%u of %u steady-state frames allocated memory (%lu allocations)", numAllocatingFrames_, CheckedFrames, numSteadyAllocations_);
+		nc::theApplication().setExitCode(EXIT_FAILURE);
+	}
+	else
+		LOGI_X("None of the %u steady-state frames allocated memory", CheckedFrames);
+
+	nc::theApplication().quit();
+}
+
+float MyEventHandler::runLuaCallback(float interval)
+{
+#if NCINE_WITH_LUA
+	lua_State *L = luaState_->state();
+	nc::LuaUtils::getGlobal(L, LuaCallbackName);
+	nc::LuaUtils::push(L, interval);
+	const int status = nc::LuaUtils::pcall(L, 1, 1);
+	if (nc::LuaUtils::isStatusOk(status) == false)
+	{
+		LOGE_X("Error running Lua function \"%s\" (%s)", LuaCallbackName, nc::LuaDebug::statusToString(status));
+		nc::LuaUtils::pop(L);
+		return angle_;
+	}
+
+	const float angle = nc::LuaUtils::retrieve<float>(L, -1);
+	nc::LuaUtils::pop(L);
+	return angle;
+#else
+	return angle_ + interval * 2.0f;
+#endif
+}
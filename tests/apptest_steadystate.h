@@ -0,0 +1,68 @@
+#ifndef CLASS_MYEVENTHANDLER
+#define CLASS_MYEVENTHANDLER
+
+#include <ncine/config.h>
+#include <ncine/IAppEventHandler.h>
+#include <nctl/StaticArray.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+class AppConfiguration;
+class Texture;
+class Font;
+class SceneNode;
+class Sprite;
+class MeshSprite;
+class TextNode;
+class ParticleSystem;
+class LuaStateManager;
+
+}
+
+namespace nc = ncine;
+
+/// My nCine event handler
+class MyEventHandler :
+    public nc::IAppEventHandler
+{
+  public:
+	static const unsigned int NumTextures = 4;
+	static const unsigned int NumSprites = 128;
+	static const unsigned int NumMeshSprites = 64;
+	static const unsigned int NumParticles = 128;
+	/// Frames that are allowed to allocate while caches and pools are filled
+	static const unsigned int WarmupFrames = 120;
+	/// Frames that are required not to allocate
+	static const unsigned int CheckedFrames = 600;
+
+	void onPreInit(nc::AppConfiguration &config) override;
+	void onInit() override;
+	void onFrameStart() override;
+
+  private:
+	unsigned int numFrames_;
+	unsigned int numAllocatingFrames_;
+	unsigned long numSteadyAllocations_;
+	float angle_;
+
+	nctl::StaticArray<nctl::UniquePtr<nc::Texture>, NumTextures> textures_;
+	nctl::UniquePtr<nc::Font> font_;
+	nctl::UniquePtr<nc::SceneNode> parentNode_;
+	nctl::StaticArray<nctl::UniquePtr<nc::Sprite>, NumSprites> sprites_;
+	nctl::StaticArray<nctl::UniquePtr<nc::MeshSprite>, NumMeshSprites> meshSprites_;
+	nctl::UniquePtr<nc::ParticleSystem> particleSystem_;
+	nctl::String textString_;
+	nctl::UniquePtr<nc::TextNode> textNode_;
+#if NCINE_WITH_LUA
+	nctl::UniquePtr<nc::LuaStateManager> luaState_;
+#endif
+
+	/// Checks the allocations of the last frame and counts the ones happened after the warm-up
+	void checkLastFrame();
+	/// Reports the result of the test and raises the quit flag
+	void finish();
+	float runLuaCallback(float interval);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#include <cstdio>
+#include <cstdlib>
+#include <ncine/AssetArchive.h>
+
+namespace nc = ncine;
+
+/// Builds a packed asset archive from the files inside a directory
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <directory> <archive>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (nc::AssetArchive::build(argv[1], argv[2]) == false)
+	{
+		fprintf(stderr, "Cannot build the archive \"%s\" from \"%s\"\n", argv[2], argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	printf("Archive \"%s\" built from \"%s\"\n", argv[2], argv[1]);
+	return EXIT_SUCCESS;
+}
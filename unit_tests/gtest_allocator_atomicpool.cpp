@@ -0,0 +1,179 @@
+#include "gtest_allocators.h"
+#include <nctl/AtomicPoolAllocator.h>
+#include <nctl/Atomic.h>
+#include "test_thread_functions.h"
+
+namespace {
+
+const unsigned int NumThreads = 8;
+const unsigned int NumIterations = 1000;
+
+class AllocatorAtomicPoolTest : public ::testing::Test
+{
+  public:
+	AllocatorAtomicPoolTest()
+	    : allocator_(ElementSize, BufferSize, &buffer_), threadIndex_(0), numErrors_(0), tr_(this) {}
+
+	uint8_t buffer_[BufferSize];
+	nctl::AtomicPoolAllocator allocator_;
+	nctl::Atomic32 threadIndex_;
+	nctl::Atomic32 numErrors_;
+	ElementType *ptrs_[Capacity];
+	ThreadRunner<NumThreads> tr_;
+};
+
+/// Allocates an element, writes to it and checks that no other thread has modified it before deallocating it
+void allocateDeallocate(AllocatorAtomicPoolTest *test)
+{
+	const unsigned int index = static_cast<unsigned int>(test->threadIndex_.fetchAdd(1));
+	for (unsigned int i = 0; i < NumIterations; i++)
+	{
+		ElementType *ptr = static_cast<ElementType *>(test->allocator_.allocate(ElementSize));
+		// There are more elements than threads, an allocation should never fail
+		if (ptr == nullptr)
+		{
+			test->numErrors_.fetchAdd(1);
+			return;
+		}
+
+		*ptr = ElementType(index, i, 0.0f, 0.0f);
+		if (ptr->a != index || ptr->b != i)
+			test->numErrors_.fetchAdd(1);
+		test->allocator_.deallocate(ptr);
+	}
+}
+
+/// Deallocates from every thread a slice of the elements allocated by the main thread
+void crossThreadDeallocate(AllocatorAtomicPoolTest *test)
+{
+	const unsigned int index = static_cast<unsigned int>(test->threadIndex_.fetchAdd(1));
+	const unsigned int sliceSize = Capacity / NumThreads;
+	for (unsigned int i = 0; i < sliceSize; i++)
+		test->allocator_.deallocate(test->ptrs_[index * sliceSize + i]);
+}
+
+TEST(AllocatorAtomicPoolDeathTest, AllocateZeroBytes)
+{
+	uint8_t buffer[BufferSize];
+	nctl::AtomicPoolAllocator allocator(ElementSize, BufferSize, &buffer);
+
+	printf("Allocating zero bytes with the AtomicPoolAllocator\n");
+	ASSERT_DEATH(allocator.allocate(0, ElementSize), "");
+}
+
+#ifdef NCINE_DEBUG
+TEST(AllocatorAtomicPoolDeathTest, Reallocate)
+{
+	uint8_t buffer[BufferSize];
+	nctl::AtomicPoolAllocator allocator(ElementSize, BufferSize, &buffer);
+
+	printf("Allocating %lu bytes with the AtomicPoolAllocator\n", ElementSize);
+	ElementType *ptr = reinterpret_cast<ElementType *>(allocator.allocate(ElementSize));
+	ASSERT_NE(ptr, nullptr);
+
+	printf("Reallocating the element\n");
+	ASSERT_DEATH(allocator.reallocate(ptr, ElementSize * 2), "");
+
+	allocator.deallocate(ptr);
+}
+#endif
+
+TEST_F(AllocatorAtomicPoolTest, AllocateDeallocate)
+{
+	ElementType *ptrs[NumElements];
+	printf("Allocating %d elements with the AtomicPoolAllocator\n", NumElements);
+	for (unsigned int i = 0; i < NumElements; i++)
+	{
+		ptrs[i] = static_cast<ElementType *>(allocator_.allocate(ElementSize));
+		ASSERT_NE(ptrs[i], nullptr);
+		ASSERT_EQ(allocator_.numAllocatedElements(), static_cast<int32_t>(i + 1));
+		for (unsigned int j = 0; j < i; j++)
+			ASSERT_NE(ptrs[i], ptrs[j]);
+	}
+
+	printf("Filling the memory with %d elements\n", NumElements);
+	for (unsigned int i = 0; i < NumElements; i++)
+		fillElements(ptrs[i], 1);
+
+	printf("Deallocating %d elements from the AtomicPoolAllocator\n", NumElements);
+	for (int i = NumElements - 1; i >= 0; i--)
+	{
+		allocator_.deallocate(ptrs[i]);
+		ASSERT_EQ(allocator_.numAllocatedElements(), i);
+	}
+}
+
+TEST_F(AllocatorAtomicPoolTest, ReuseDeallocatedElement)
+{
+	printf("Allocating an element again after deallocating it\n");
+	void *ptr = allocator_.allocate(ElementSize);
+	ASSERT_NE(ptr, nullptr);
+	allocator_.deallocate(ptr);
+
+	// The free list is a stack, the last deallocated element is the first to be allocated
+	void *newPtr = allocator_.allocate(ElementSize);
+	ASSERT_EQ(newPtr, ptr);
+	allocator_.deallocate(newPtr);
+}
+
+TEST_F(AllocatorAtomicPoolTest, AllocateTooMuch)
+{
+	const unsigned int numElements = allocator_.numElements();
+	printf("Allocating all the %u elements of the AtomicPoolAllocator and one more\n", numElements);
+	for (unsigned int i = 0; i < numElements; i++)
+	{
+		ptrs_[i] = static_cast<ElementType *>(allocator_.allocate(ElementSize));
+		ASSERT_NE(ptrs_[i], nullptr);
+	}
+	ASSERT_EQ(allocator_.allocate(ElementSize), nullptr);
+
+	for (unsigned int i = 0; i < numElements; i++)
+		allocator_.deallocate(ptrs_[i]);
+	ASSERT_EQ(allocator_.numAllocatedElements(), 0);
+}
+
+TEST_F(AllocatorAtomicPoolTest, AllocateDeallocateMultithread)
+{
+	printf("Allocating and deallocating an element %u times from each of %u threads\n", NumIterations, NumThreads);
+	tr_.runThreads([](void *arg) -> ThreadRunner<NumThreads>::threadFuncRet {
+		AllocatorAtomicPoolTest *test = static_cast<AllocatorAtomicPoolTest *>(arg);
+		allocateDeallocate(test);
+		return test->tr_.retFunc();
+	});
+
+	ASSERT_EQ(numErrors_.load(), 0);
+	ASSERT_EQ(allocator_.numAllocatedElements(), 0);
+}
+
+TEST_F(AllocatorAtomicPoolTest, CrossThreadDeallocate)
+{
+	const unsigned int numElements = allocator_.numElements();
+	printf("Allocating %u elements from the main thread and deallocating them from %u threads\n", numElements, NumThreads);
+	for (unsigned int i = 0; i < numElements; i++)
+	{
+		ptrs_[i] = static_cast<ElementType *>(allocator_.allocate(ElementSize));
+		ASSERT_NE(ptrs_[i], nullptr);
+	}
+	for (unsigned int i = numElements; i < Capacity; i++)
+		ptrs_[i] = nullptr;
+
+	tr_.runThreads([](void *arg) -> ThreadRunner<NumThreads>::threadFuncRet {
+		AllocatorAtomicPoolTest *test = static_cast<AllocatorAtomicPoolTest *>(arg);
+		crossThreadDeallocate(test);
+		return test->tr_.retFunc();
+	});
+
+	ASSERT_EQ(allocator_.numAllocatedElements(), 0);
+	// Every element is back in the free list
+	for (unsigned int i = 0; i < numElements; i++)
+	{
+		ptrs_[i] = static_cast<ElementType *>(allocator_.allocate(ElementSize));
+		ASSERT_NE(ptrs_[i], nullptr);
+	}
+	ASSERT_EQ(allocator_.allocate(ElementSize), nullptr);
+
+	for (unsigned int i = 0; i < numElements; i++)
+		allocator_.deallocate(ptrs_[i]);
+}
+
+}
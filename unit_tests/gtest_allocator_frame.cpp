@@ -0,0 +1,202 @@
+#include "gtest_allocators.h"
+#include <nctl/FrameAllocator.h>
+
+namespace {
+
+const size_t FrameBufferSize = 2 * BufferSize;
+const size_t OverflowSize = 2 * BufferSize;
+
+class AllocatorFrameTest : public ::testing::Test
+{
+  public:
+	AllocatorFrameTest()
+	    : allocator_(FrameBufferSize, &buffer_, fallbackAllocator_) {}
+
+  protected:
+	bool isInsideBuffer(const void *ptr) const
+	{
+		const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+		const uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+		return (address >= base && address < base + FrameBufferSize);
+	}
+
+	uint8_t buffer_[FrameBufferSize];
+	nctl::MallocAllocator fallbackAllocator_;
+	nctl::FrameAllocator allocator_;
+};
+
+bool isAligned(const void *ptr, uintptr_t alignment)
+{
+	return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+TEST(AllocatorFrameDeathTest, AllocateZeroBytes)
+{
+	uint8_t buffer[FrameBufferSize];
+	nctl::MallocAllocator fallbackAllocator;
+	nctl::FrameAllocator allocator(FrameBufferSize, &buffer, fallbackAllocator);
+
+	printf("Allocating zero bytes with the FrameAllocator\n");
+	ASSERT_DEATH(allocator.allocate(0), "");
+}
+
+TEST_F(AllocatorFrameTest, AllocateDeallocate)
+{
+	const size_t Bytes = NumElements * ElementSize;
+	printf("Allocating %lu bytes for %d elements with the FrameAllocator\n", Bytes, NumElements);
+	ElementType *ptr = static_cast<ElementType *>(allocator_.allocate(Bytes));
+	ASSERT_NE(ptr, nullptr);
+	ASSERT_TRUE(isInsideBuffer(ptr));
+	ASSERT_EQ(allocator_.numAllocations(), 1);
+	ASSERT_EQ(allocator_.usedMemory(), Bytes);
+
+	printf("Filling the memory with %d elements\n", NumElements);
+	fillElements(ptr, NumElements);
+
+	printf("Deallocating does not reclaim memory until the arena is cleared\n");
+	allocator_.deallocate(ptr);
+	ASSERT_EQ(allocator_.numAllocations(), 1);
+	ASSERT_EQ(allocator_.usedMemory(), Bytes);
+}
+
+TEST_F(AllocatorFrameTest, Alignment)
+{
+	printf("Allocating with all the alignments from 1 to 128 bytes\n");
+	for (unsigned int alignment = 1; alignment <= 128; alignment *= 2)
+	{
+		void *ptr = allocator_.allocate(3, static_cast<uint8_t>(alignment));
+		ASSERT_NE(ptr, nullptr);
+		ASSERT_TRUE(isInsideBuffer(ptr));
+		ASSERT_TRUE(isAligned(ptr, alignment));
+	}
+
+	printf("Allocating with the same alignments from the fallback allocator\n");
+	for (unsigned int alignment = 1; alignment <= 128; alignment *= 2)
+	{
+		void *ptr = allocator_.allocate(OverflowSize, static_cast<uint8_t>(alignment));
+		ASSERT_NE(ptr, nullptr);
+		ASSERT_FALSE(isInsideBuffer(ptr));
+		ASSERT_TRUE(isAligned(ptr, alignment));
+	}
+}
+
+TEST_F(AllocatorFrameTest, ResetPerFrame)
+{
+	const size_t Bytes = NumElements * ElementSize;
+	printf("Allocating %lu bytes in three consecutive frames\n", Bytes);
+	ElementType *firstPtr = static_cast<ElementType *>(allocator_.allocate(Bytes));
+	ASSERT_NE(firstPtr, nullptr);
+	fillElements(firstPtr, NumElements);
+	allocator_.nextFrame();
+
+	// The allocations of the previous frame are still valid
+	ElementType *secondPtr = static_cast<ElementType *>(allocator_.allocate(Bytes));
+	ASSERT_NE(secondPtr, nullptr);
+	ASSERT_NE(secondPtr, firstPtr);
+	ASSERT_EQ(allocator_.numAllocations(), 1);
+	for (unsigned int i = 0; i < NumElements; i++)
+		ASSERT_EQ(firstPtr[i].a, i);
+	allocator_.nextFrame();
+
+	// The arena of two frames ago is reused
+	ElementType *thirdPtr = static_cast<ElementType *>(allocator_.allocate(Bytes));
+	ASSERT_EQ(thirdPtr, firstPtr);
+}
+
+TEST_F(AllocatorFrameTest, FillFrameArena)
+{
+	const size_t frameCapacity = allocator_.frameCapacity();
+	printf("Allocating the whole arena of %lu bytes for %u frames\n", frameCapacity, 4);
+	for (unsigned int frame = 0; frame < 4; frame++)
+	{
+		void *ptr = allocator_.allocate(frameCapacity, 1);
+		ASSERT_NE(ptr, nullptr);
+		ASSERT_TRUE(isInsideBuffer(ptr));
+		allocator_.nextFrame();
+		ASSERT_EQ(allocator_.lastFrameNumOverflows(), 0u);
+	}
+}
+
+TEST_F(AllocatorFrameTest, OutOfCapacityFallback)
+{
+	printf("Allocating %lu bytes, more than the arena capacity of %lu bytes\n", OverflowSize, allocator_.frameCapacity());
+	unsigned char *ptr = static_cast<unsigned char *>(allocator_.allocate(OverflowSize));
+	ASSERT_NE(ptr, nullptr);
+	ASSERT_FALSE(isInsideBuffer(ptr));
+	ASSERT_EQ(fallbackAllocator_.numAllocations(), 1);
+	memset(ptr, 0xAB, OverflowSize);
+
+	allocator_.nextFrame();
+	ASSERT_EQ(allocator_.lastFrameNumOverflows(), 1u);
+	ASSERT_EQ(allocator_.lastFrameUsedMemory(), OverflowSize);
+	// The overflow is valid until the end of the next frame
+	ASSERT_EQ(fallbackAllocator_.numAllocations(), 1);
+	ASSERT_EQ(ptr[OverflowSize - 1], 0xAB);
+
+	allocator_.nextFrame();
+	ASSERT_EQ(allocator_.lastFrameNumOverflows(), 0u);
+	ASSERT_EQ(fallbackAllocator_.numAllocations(), 0);
+}
+
+TEST_F(AllocatorFrameTest, Statistics)
+{
+	printf("Checking the used memory and the high water mark over three frames\n");
+	allocator_.allocate(100);
+	allocator_.allocate(200);
+	allocator_.nextFrame();
+	ASSERT_EQ(allocator_.lastFrameUsedMemory(), 300u);
+	ASSERT_EQ(allocator_.highWaterMark(), 300u);
+	ASSERT_EQ(allocator_.usedMemory(), 0u);
+	ASSERT_EQ(allocator_.numAllocations(), 0);
+
+	allocator_.allocate(50);
+	allocator_.nextFrame();
+	ASSERT_EQ(allocator_.lastFrameUsedMemory(), 50u);
+	ASSERT_EQ(allocator_.highWaterMark(), 300u);
+
+	allocator_.allocate(OverflowSize);
+	allocator_.nextFrame();
+	ASSERT_EQ(allocator_.highWaterMark(), OverflowSize);
+}
+
+TEST_F(AllocatorFrameTest, Reallocate)
+{
+	printf("Reallocating an arena allocation and an overflow one\n");
+	ElementType *ptr = static_cast<ElementType *>(allocator_.allocate(ElementSize * 2));
+	ASSERT_NE(ptr, nullptr);
+	fillElements(ptr, 2);
+
+	ElementType *newPtr = static_cast<ElementType *>(allocator_.reallocate(ptr, ElementSize * NumElements));
+	ASSERT_NE(newPtr, nullptr);
+	ASSERT_NE(newPtr, ptr);
+	ASSERT_EQ(newPtr[0].a, 0u);
+	ASSERT_EQ(newPtr[1].a, 1u);
+
+	ElementType *overflowPtr = static_cast<ElementType *>(allocator_.reallocate(newPtr, OverflowSize));
+	ASSERT_NE(overflowPtr, nullptr);
+	ASSERT_FALSE(isInsideBuffer(overflowPtr));
+	ASSERT_EQ(overflowPtr[0].a, 0u);
+	ASSERT_EQ(overflowPtr[1].a, 1u);
+
+	ElementType *biggerPtr = static_cast<ElementType *>(allocator_.reallocate(overflowPtr, OverflowSize * 2));
+	ASSERT_NE(biggerPtr, nullptr);
+	ASSERT_EQ(biggerPtr[1].b, NumElements - 2);
+}
+
+TEST(AllocatorFrameDestructorTest, ReleaseOverflows)
+{
+	uint8_t buffer[FrameBufferSize];
+	nctl::MallocAllocator fallbackAllocator;
+	printf("Destroying a FrameAllocator releases the allocations of the fallback allocator\n");
+	{
+		nctl::FrameAllocator allocator(FrameBufferSize, &buffer, fallbackAllocator);
+		allocator.allocate(OverflowSize);
+		allocator.nextFrame();
+		allocator.allocate(OverflowSize);
+		ASSERT_EQ(fallbackAllocator.numAllocations(), 2);
+	}
+
+	ASSERT_EQ(fallbackAllocator.numAllocations(), 0);
+}
+
+}
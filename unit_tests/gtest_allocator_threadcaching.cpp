@@ -0,0 +1,211 @@
+#include "gtest_allocators.h"
+#include <nctl/ThreadCachingAllocator.h>
+#include <nctl/Atomic.h>
+#include "test_thread_functions.h"
+
+namespace {
+
+const unsigned int NumThreads = 8;
+const unsigned int NumThreadAllocations = 256;
+const size_t SmallSize = 24;
+const size_t BigSize = 64 * 1024;
+
+class AllocatorThreadCachingTest : public ::testing::Test
+{
+  public:
+	AllocatorThreadCachingTest()
+	    : allocator_(backingAllocator_), threadIndex_(0), numErrors_(0), tr_(this) {}
+
+	nctl::MallocAllocator backingAllocator_;
+	nctl::ThreadCachingAllocator allocator_;
+	nctl::Atomic32 threadIndex_;
+	nctl::Atomic32 numErrors_;
+	void *ptrs_[NumThreads * NumThreadAllocations];
+	ThreadRunner<NumThreads> tr_;
+};
+
+bool isAligned(const void *ptr, uintptr_t alignment)
+{
+	return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+/// Allocates and deallocates blocks of different sizes from every thread, checking their content
+void allocateDeallocate(AllocatorThreadCachingTest *test)
+{
+	unsigned char *ptrs[NumThreadAllocations];
+	const unsigned char value = static_cast<unsigned char>(test->threadIndex_.fetchAdd(1));
+
+	for (unsigned int i = 0; i < NumThreadAllocations; i++)
+	{
+		const size_t bytes = 16 + (i % 64) * 8;
+		ptrs[i] = static_cast<unsigned char *>(test->allocator_.allocate(bytes));
+		if (ptrs[i] == nullptr)
+		{
+			test->numErrors_.fetchAdd(1);
+			return;
+		}
+		memset(ptrs[i], value, bytes);
+	}
+
+	for (unsigned int i = 0; i < NumThreadAllocations; i++)
+	{
+		const size_t bytes = 16 + (i % 64) * 8;
+		for (unsigned int j = 0; j < bytes; j++)
+		{
+			if (ptrs[i][j] != value)
+			{
+				test->numErrors_.fetchAdd(1);
+				break;
+			}
+		}
+		test->allocator_.deallocate(ptrs[i]);
+	}
+	test->allocator_.releaseThreadCache();
+}
+
+/// Deallocates from every thread a slice of the blocks allocated by the main thread
+void crossThreadDeallocate(AllocatorThreadCachingTest *test)
+{
+	const unsigned int index = static_cast<unsigned int>(test->threadIndex_.fetchAdd(1));
+	for (unsigned int i = 0; i < NumThreadAllocations; i++)
+		test->allocator_.deallocate(test->ptrs_[index * NumThreadAllocations + i]);
+	test->allocator_.releaseThreadCache();
+}
+
+TEST_F(AllocatorThreadCachingTest, AllocateDeallocate)
+{
+	const size_t Bytes = NumElements * ElementSize;
+	printf("Allocating %lu bytes for %d elements with the ThreadCachingAllocator\n", Bytes, NumElements);
+	ElementType *ptr = static_cast<ElementType *>(allocator_.allocate(Bytes));
+	ASSERT_NE(ptr, nullptr);
+	ASSERT_TRUE(isAligned(ptr, nctl::IAllocator::DefaultAlignment));
+
+	printf("Filling the memory with %d elements\n", NumElements);
+	fillElements(ptr, NumElements);
+	for (unsigned int i = 0; i < NumElements; i++)
+		ASSERT_EQ(ptr[i].a, i);
+
+	printf("Deallocating %lu bytes of memory\n", Bytes);
+	allocator_.deallocate(ptr);
+}
+
+TEST_F(AllocatorThreadCachingTest, ReuseDeallocatedBlock)
+{
+	printf("Allocating a block again after deallocating it\n");
+	void *ptr = allocator_.allocate(SmallSize);
+	ASSERT_NE(ptr, nullptr);
+	allocator_.deallocate(ptr);
+
+	// The block is at the top of the magazine of the calling thread
+	void *newPtr = allocator_.allocate(SmallSize);
+	ASSERT_EQ(newPtr, ptr);
+	allocator_.deallocate(newPtr);
+}
+
+TEST_F(AllocatorThreadCachingTest, BigAllocation)
+{
+	printf("Allocating %lu bytes, more than the biggest size class\n", BigSize);
+	ASSERT_GT(BigSize, nctl::ThreadCachingAllocator::maxClassSize());
+	unsigned char *ptr = static_cast<unsigned char *>(allocator_.allocate(BigSize, 64));
+	ASSERT_NE(ptr, nullptr);
+	ASSERT_TRUE(isAligned(ptr, 64));
+	memset(ptr, 0xAB, BigSize);
+
+	allocator_.deallocate(ptr);
+}
+
+TEST_F(AllocatorThreadCachingTest, ReallocateInPlace)
+{
+	printf("Reallocating a small block inside its size class\n");
+	unsigned char *ptr = static_cast<unsigned char *>(allocator_.allocate(SmallSize));
+	ASSERT_NE(ptr, nullptr);
+
+	// The block is 32 bytes long and aligned, there is no need to move it
+	unsigned char *newPtr = static_cast<unsigned char *>(allocator_.reallocate(ptr, SmallSize + 4));
+	ASSERT_EQ(newPtr, ptr);
+
+	printf("Reallocating a big block to a smaller size\n");
+	unsigned char *bigPtr = static_cast<unsigned char *>(allocator_.allocate(BigSize));
+	ASSERT_NE(bigPtr, nullptr);
+	unsigned char *newBigPtr = static_cast<unsigned char *>(allocator_.reallocate(bigPtr, BigSize / 2));
+	ASSERT_EQ(newBigPtr, bigPtr);
+
+	allocator_.deallocate(newPtr);
+	allocator_.deallocate(newBigPtr);
+}
+
+TEST_F(AllocatorThreadCachingTest, ReallocateAndCopy)
+{
+	printf("Reallocating a small block to a bigger size class\n");
+	ElementType *ptr = static_cast<ElementType *>(allocator_.allocate(ElementSize * 2));
+	ASSERT_NE(ptr, nullptr);
+	fillElements(ptr, 2);
+
+	ElementType *newPtr = static_cast<ElementType *>(allocator_.reallocate(ptr, ElementSize * NumElements));
+	ASSERT_NE(newPtr, nullptr);
+	ASSERT_NE(newPtr, ptr);
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		ASSERT_EQ(newPtr[i].a, i);
+		ASSERT_EQ(newPtr[i].b, NumElements - i - 1);
+	}
+
+	allocator_.deallocate(newPtr);
+}
+
+TEST_F(AllocatorThreadCachingTest, AllocateDeallocateMultithread)
+{
+	printf("Allocating and deallocating %u blocks from each of %u threads\n", NumThreadAllocations, NumThreads);
+	tr_.runThreads([](void *arg) -> ThreadRunner<NumThreads>::threadFuncRet {
+		AllocatorThreadCachingTest *test = static_cast<AllocatorThreadCachingTest *>(arg);
+		allocateDeallocate(test);
+		return test->tr_.retFunc();
+	});
+
+	ASSERT_EQ(numErrors_.load(), 0);
+}
+
+TEST_F(AllocatorThreadCachingTest, CrossThreadDeallocate)
+{
+	printf("Allocating %u blocks from the main thread and deallocating them from %u threads\n", NumThreads * NumThreadAllocations, NumThreads);
+	for (unsigned int i = 0; i < NumThreads * NumThreadAllocations; i++)
+	{
+		ptrs_[i] = allocator_.allocate(SmallSize);
+		ASSERT_NE(ptrs_[i], nullptr);
+	}
+
+	tr_.runThreads([](void *arg) -> ThreadRunner<NumThreads>::threadFuncRet {
+		AllocatorThreadCachingTest *test = static_cast<AllocatorThreadCachingTest *>(arg);
+		crossThreadDeallocate(test);
+		return test->tr_.retFunc();
+	});
+
+	// The blocks have been returned to the depot by the other threads and can be allocated again
+	for (unsigned int i = 0; i < NumThreads * NumThreadAllocations; i++)
+	{
+		ptrs_[i] = allocator_.allocate(SmallSize);
+		ASSERT_NE(ptrs_[i], nullptr);
+	}
+	for (unsigned int i = 0; i < NumThreads * NumThreadAllocations; i++)
+		allocator_.deallocate(ptrs_[i]);
+}
+
+TEST(AllocatorThreadCachingDestructorTest, ReturnMemory)
+{
+	nctl::MallocAllocator backingAllocator;
+	printf("Destroying a ThreadCachingAllocator returns its memory to the backing allocator\n");
+	{
+		nctl::ThreadCachingAllocator allocator(backingAllocator);
+		void *ptr = allocator.allocate(SmallSize);
+		void *bigPtr = allocator.allocate(BigSize);
+		ASSERT_NE(ptr, nullptr);
+		ASSERT_NE(bigPtr, nullptr);
+		ASSERT_GT(backingAllocator.numAllocations(), 0);
+		allocator.deallocate(bigPtr);
+		allocator.deallocate(ptr);
+	}
+
+	ASSERT_EQ(backingAllocator.numAllocations(), 0);
+}
+
+}
@@ -0,0 +1,211 @@
+#include <nctl/Array.h>
+#include <nctl/algorithms.h>
+#include "gtest/gtest.h"
+
+namespace {
+
+const unsigned int Size = 5000;
+
+struct Element
+{
+	uint64_t key;
+	uint32_t secondaryKey;
+	unsigned int index;
+};
+
+/// A deterministic generator, so that a failure can be reproduced
+class Generator
+{
+  public:
+	Generator()
+	    : state_(0x853c49e6748fea9bULL) {}
+
+	uint64_t next()
+	{
+		// SplitMix64 step
+		state_ += 0x9e3779b97f4a7c15ULL;
+		uint64_t value = state_;
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+		return value ^ (value >> 31);
+	}
+
+  private:
+	uint64_t state_;
+};
+
+class ArrayRadixSortTest : public ::testing::Test
+{
+  public:
+	ArrayRadixSortTest()
+	    : array_(Size), scratch_(Size) {}
+
+  protected:
+	void SetUp() override
+	{
+		scratch_.setSize(Size);
+	}
+
+	/// Fills the array with keys masked by the specified value
+	void fillArray(uint64_t mask)
+	{
+		array_.clear();
+		for (unsigned int i = 0; i < Size; i++)
+			array_.pushBack({ generator_.next() & mask, static_cast<uint32_t>(generator_.next()), i });
+	}
+
+	/// Checks that keys are in ascending order and that elements with equal keys kept their relative order
+	void checkStableOrder()
+	{
+		for (unsigned int i = 1; i < array_.size(); i++)
+		{
+			ASSERT_LE(array_[i - 1].key, array_[i].key);
+			if (array_[i - 1].key == array_[i].key)
+				ASSERT_LT(array_[i - 1].index, array_[i].index);
+		}
+	}
+
+	/// Checks that every element is still present exactly once
+	void checkPermutation()
+	{
+		nctl::Array<unsigned int> counts(array_.size());
+		counts.setSize(array_.size());
+		for (unsigned int i = 0; i < counts.size(); i++)
+			counts[i] = 0;
+		for (unsigned int i = 0; i < array_.size(); i++)
+			counts[array_[i].index]++;
+		for (unsigned int i = 0; i < counts.size(); i++)
+			ASSERT_EQ(counts[i], 1u);
+	}
+
+	void sortOnKey()
+	{
+		nctl::radixSort(array_.data(), array_.data() + array_.size(), scratch_.data(), [](const Element &element) { return element.key; });
+	}
+
+	Generator generator_;
+	nctl::Array<Element> array_;
+	nctl::Array<Element> scratch_;
+};
+
+TEST_F(ArrayRadixSortTest, EmptyRange)
+{
+	printf("Sorting an empty range\n");
+	array_.clear();
+	sortOnKey();
+
+	ASSERT_EQ(array_.size(), 0u);
+}
+
+TEST_F(ArrayRadixSortTest, SingleElement)
+{
+	printf("Sorting a range with a single element\n");
+	array_.clear();
+	array_.pushBack({ 42, 0, 0 });
+	sortOnKey();
+
+	ASSERT_EQ(array_.size(), 1u);
+	ASSERT_EQ(array_[0].key, 42u);
+}
+
+TEST_F(ArrayRadixSortTest, Full64BitKeys)
+{
+	fillArray(~0ULL);
+	printf("Sorting %u elements with random 64 bit keys\n", array_.size());
+	sortOnKey();
+
+	checkStableOrder();
+	checkPermutation();
+	// The most significant bit should have been sorted as well
+	ASSERT_LT(array_.front().key, 1ULL << 63);
+	ASSERT_GE(array_.back().key, 1ULL << 63);
+}
+
+TEST_F(ArrayRadixSortTest, HighBytesOnly)
+{
+	// Keys only differ in the most significant byte, all the other passes are skipped
+	fillArray(0xff00000000000000ULL);
+	printf("Sorting %u elements with keys that only differ in the most significant byte\n", array_.size());
+	sortOnKey();
+
+	checkStableOrder();
+	checkPermutation();
+}
+
+TEST_F(ArrayRadixSortTest, DuplicateKeys)
+{
+	fillArray(0x7);
+	printf("Sorting %u elements with only 8 different keys\n", array_.size());
+	sortOnKey();
+
+	checkStableOrder();
+	checkPermutation();
+}
+
+TEST_F(ArrayRadixSortTest, AllKeysEqual)
+{
+	fillArray(0);
+	printf("Sorting %u elements with the same key\n", array_.size());
+	sortOnKey();
+
+	for (unsigned int i = 0; i < array_.size(); i++)
+		ASSERT_EQ(array_[i].index, i);
+}
+
+TEST_F(ArrayRadixSortTest, AlreadySorted)
+{
+	array_.clear();
+	for (unsigned int i = 0; i < Size; i++)
+		array_.pushBack({ i * 3ULL, 0, i });
+	printf("Sorting %u elements that are already sorted\n", array_.size());
+	sortOnKey();
+
+	for (unsigned int i = 0; i < array_.size(); i++)
+		ASSERT_EQ(array_[i].index, i);
+}
+
+TEST_F(ArrayRadixSortTest, ReverseSorted)
+{
+	array_.clear();
+	for (unsigned int i = 0; i < Size; i++)
+		array_.pushBack({ (Size - i) * 1000ULL, 0, i });
+	printf("Sorting %u elements that are sorted in reverse order\n", array_.size());
+	sortOnKey();
+
+	checkStableOrder();
+	for (unsigned int i = 0; i < array_.size(); i++)
+		ASSERT_EQ(array_[i].index, Size - 1 - i);
+}
+
+TEST_F(ArrayRadixSortTest, MultipleKeys)
+{
+	fillArray(0xf);
+	printf("Sorting %u elements on a secondary key and then on a primary one\n", array_.size());
+	nctl::radixSort(array_.data(), array_.data() + array_.size(), scratch_.data(), [](const Element &element) { return element.secondaryKey; });
+	sortOnKey();
+
+	checkPermutation();
+	for (unsigned int i = 1; i < array_.size(); i++)
+	{
+		ASSERT_LE(array_[i - 1].key, array_[i].key);
+		if (array_[i - 1].key == array_[i].key)
+			ASSERT_LE(array_[i - 1].secondaryKey, array_[i].secondaryKey);
+	}
+}
+
+TEST_F(ArrayRadixSortTest, SameAsQuicksort)
+{
+	fillArray(0xffffffffULL);
+	printf("Comparing the radix sort of %u keys with the quicksort\n", array_.size());
+
+	nctl::Array<uint64_t> keys(array_.size());
+	for (unsigned int i = 0; i < array_.size(); i++)
+		keys.pushBack(array_[i].key);
+	nctl::quicksort(keys.begin(), keys.end());
+	sortOnKey();
+
+	for (unsigned int i = 0; i < array_.size(); i++)
+		ASSERT_EQ(array_[i].key, keys[i]);
+}
+
+}
@@ -0,0 +1,215 @@
+#include <ncine/IFile.h>
+#include <ncine/FileSystem.h>
+#include <ncine/AssetArchive.h>
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *DataDirectory = "gtest_assetarchive_data";
+const char *SubDirectory = "gtest_assetarchive_data/sub";
+const char *ArchiveFilename = "gtest_assetarchive.ncar";
+const char *MountPoint = "archive";
+const unsigned int NumFiles = 4;
+const char *RelativePaths[NumFiles] = { "first.bin", "second.txt", "sub/third.bin", "sub/empty.bin" };
+const unsigned int FileSizes[NumFiles] = { 100, 17, 3000, 0 };
+
+unsigned char fileByte(unsigned int fileIndex, unsigned int byteIndex)
+{
+	return static_cast<unsigned char>(fileIndex * 31 + byteIndex * 7);
+}
+
+bool writeFile(const char *filename, const unsigned char *data, unsigned long int size)
+{
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename);
+	fileHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+	return (size == 0 || fileHandle->write(data, size) == size);
+}
+
+bool readFile(const char *filename, nctl::Array<unsigned char> &data)
+{
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(filename);
+	fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	data.setSize(fileHandle->size());
+	return (data.size() == 0 || fileHandle->read(data.data(), data.size()) == data.size());
+}
+
+uint64_t readLE(const unsigned char *bytes, unsigned int numBytes)
+{
+	uint64_t value = 0;
+	for (unsigned int i = 0; i < numBytes; i++)
+		value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+	return value;
+}
+
+void writeLE(unsigned char *bytes, unsigned int numBytes, uint64_t value)
+{
+	for (unsigned int i = 0; i < numBytes; i++)
+		bytes[i] = static_cast<unsigned char>(value >> (i * 8));
+}
+
+class AssetArchiveTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		nc::fs::createDir(DataDirectory);
+		nc::fs::createDir(SubDirectory);
+
+		nctl::Array<unsigned char> data;
+		for (unsigned int i = 0; i < NumFiles; i++)
+		{
+			data.setSize(FileSizes[i]);
+			for (unsigned int j = 0; j < FileSizes[i]; j++)
+				data[j] = fileByte(i, j);
+			ASSERT_TRUE(writeFile(sourcePath(i).data(), data.data(), FileSizes[i]));
+		}
+	}
+
+	void TearDown() override
+	{
+		nc::AssetArchive::unmountAll();
+		for (unsigned int i = 0; i < NumFiles; i++)
+			nc::fs::deleteFile(sourcePath(i).data());
+		nc::fs::deleteEmptyDir(SubDirectory);
+		nc::fs::deleteEmptyDir(DataDirectory);
+		if (nc::fs::isFile(ArchiveFilename))
+			nc::fs::deleteFile(ArchiveFilename);
+	}
+
+	/// Overwrites a 64 bit number of the first directory entry of the archive
+	void corruptFirstEntry(unsigned int fieldOffset, uint64_t value)
+	{
+		nctl::Array<unsigned char> data;
+		ASSERT_TRUE(readFile(ArchiveFilename, data));
+		const uint64_t directoryOffset = readLE(data.data() + 16, 8);
+		writeLE(data.data() + directoryOffset + fieldOffset, 8, value);
+		ASSERT_TRUE(writeFile(ArchiveFilename, data.data(), data.size()));
+	}
+
+	nctl::String sourcePath(unsigned int index) const { return nc::fs::joinPath(DataDirectory, RelativePaths[index]); }
+	nctl::String archivedPath(unsigned int index) const { return nc::fs::joinPath(MountPoint, RelativePaths[index]); }
+};
+
+TEST_F(AssetArchiveTest, BuildAndRead)
+{
+	printf("Building an archive with %u files and reading them back\n", NumFiles);
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	ASSERT_TRUE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+	ASSERT_EQ(nc::AssetArchive::numMounted(), 1u);
+
+	nctl::Array<unsigned char> data;
+	for (unsigned int i = 0; i < NumFiles; i++)
+	{
+		const nctl::String path = archivedPath(i);
+		ASSERT_TRUE(nc::AssetArchive::contains(path.data()));
+		ASSERT_TRUE(readFile(path.data(), data));
+		ASSERT_EQ(data.size(), FileSizes[i]);
+		for (unsigned int j = 0; j < FileSizes[i]; j++)
+			ASSERT_EQ(data[j], fileByte(i, j));
+	}
+}
+
+TEST_F(AssetArchiveTest, MissingFile)
+{
+	printf("Looking for a file that is not in the archive\n");
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	ASSERT_TRUE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+
+	ASSERT_FALSE(nc::AssetArchive::contains("archive/missing.bin"));
+	ASSERT_FALSE(nc::AssetArchive::contains(RelativePaths[0]));
+	ASSERT_EQ(nc::AssetArchive::createFileHandle("archive/missing.bin"), nullptr);
+}
+
+TEST_F(AssetArchiveTest, LittleEndianHeader)
+{
+	printf("Checking the byte order of the archive header and directory\n");
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+
+	nctl::Array<unsigned char> data;
+	ASSERT_TRUE(readFile(ArchiveFilename, data));
+	ASSERT_GE(data.size(), sizeof(nc::AssetArchive::Header));
+	ASSERT_EQ(memcmp(data.data(), nc::AssetArchive::Signature, 4), 0);
+	const uint16_t version = nc::AssetArchive::Version;
+	ASSERT_EQ(readLE(data.data() + 4, 2), version);
+	ASSERT_EQ(readLE(data.data() + 8, 4), NumFiles);
+
+	const uint64_t directoryOffset = readLE(data.data() + 16, 8);
+	ASSERT_EQ(directoryOffset, sizeof(nc::AssetArchive::Header));
+	// Entries are sorted by path hash, each of them has to match the hash of one of the files
+	uint64_t previousHash = 0;
+	for (unsigned int i = 0; i < NumFiles; i++)
+	{
+		const uint64_t pathHash = readLE(data.data() + directoryOffset + i * sizeof(nc::AssetArchive::Entry), 8);
+		ASSERT_GE(pathHash, previousHash);
+		previousHash = pathHash;
+
+		bool hashFound = false;
+		for (unsigned int j = 0; j < NumFiles; j++)
+			hashFound |= (pathHash == nc::AssetArchive::hashPath(RelativePaths[j]));
+		ASSERT_TRUE(hashFound);
+	}
+}
+
+TEST_F(AssetArchiveTest, SizeLargerThanStored)
+{
+	printf("Mounting an archive with an uncompressed blob bigger than its stored size\n");
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	// The size of the first entry follows its path hash and its offset
+	corruptFirstEntry(16, 1024 * 1024);
+	ASSERT_FALSE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+	ASSERT_EQ(nc::AssetArchive::numMounted(), 0u);
+}
+
+TEST_F(AssetArchiveTest, OffsetWrapAround)
+{
+	printf("Mounting an archive with a blob offset that wraps around when added to its size\n");
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	corruptFirstEntry(8, ~0ULL - 8);
+	// Both sizes are changed, the blob is still uncompressed
+	corruptFirstEntry(16, 16);
+	corruptFirstEntry(24, 16);
+	ASSERT_FALSE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+	ASSERT_EQ(nc::AssetArchive::numMounted(), 0u);
+}
+
+TEST_F(AssetArchiveTest, RebuildArchive)
+{
+	printf("Building an archive twice, replacing the first one\n");
+	ASSERT_TRUE(nc::AssetArchive::build(SubDirectory, ArchiveFilename));
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	ASSERT_FALSE(nc::fs::isFile("gtest_assetarchive.ncar.tmp"));
+
+	ASSERT_TRUE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+	for (unsigned int i = 0; i < NumFiles; i++)
+		ASSERT_TRUE(nc::AssetArchive::contains(archivedPath(i).data()));
+}
+
+TEST_F(AssetArchiveTest, FailedBuild)
+{
+	const char *unwritableFilename = "gtest_assetarchive_missing_dir/gtest_assetarchive.ncar";
+	printf("Building an archive in a directory that does not exist\n");
+
+	ASSERT_FALSE(nc::AssetArchive::build(DataDirectory, unwritableFilename));
+	ASSERT_FALSE(nc::fs::isFile(unwritableFilename));
+}
+
+TEST_F(AssetArchiveTest, FailedBuildKeepsArchive)
+{
+	printf("Failing to build an archive over an existing one\n");
+	ASSERT_TRUE(nc::AssetArchive::build(DataDirectory, ArchiveFilename));
+	ASSERT_FALSE(nc::AssetArchive::build("gtest_assetarchive_missing_dir", ArchiveFilename));
+
+	ASSERT_TRUE(nc::AssetArchive::mount(ArchiveFilename, MountPoint));
+	ASSERT_TRUE(nc::AssetArchive::contains(archivedPath(0).data()));
+}
+
+}
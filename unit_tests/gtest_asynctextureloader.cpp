@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <ncine/FileSystem.h>
+#include <ncine/Timer.h>
+#include "AsyncTextureLoader.h"
+#include "ServiceLocator.h"
+#include "ThreadPool.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumThreads = 4;
+const unsigned int NumTextures = 16;
+const unsigned int TextureSize = 8;
+const unsigned int MaxUpdates = 10000;
+const char *Filename = "gtest_asynctextureloader.dds";
+const char *MissingFilename = "gtest_asynctextureloader_missing.dds";
+
+struct CallbackCounters
+{
+	unsigned int numLoaded = 0;
+	unsigned int numFailed = 0;
+};
+
+void onLoaded(nc::Texture &texture, bool hasLoaded, void *userData)
+{
+	CallbackCounters &counters = *static_cast<CallbackCounters *>(userData);
+	if (hasLoaded)
+		counters.numLoaded++;
+	else
+		counters.numFailed++;
+}
+
+/// Writes a 32 bit value in little-endian order, as required by the DDS format
+void writeLE(FILE *file, uint32_t value)
+{
+	const unsigned char bytes[4] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+	                                 static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24) };
+	fwrite(bytes, 1, 4, file);
+}
+
+/// Writes an uncompressed RGBA DDS file, the simplest format the engine can decode without external libraries
+bool writeDdsFile(const char *filename, unsigned int size)
+{
+	FILE *file = fopen(filename, "wb");
+	if (file == nullptr)
+		return false;
+
+	uint32_t header[32] = {};
+	header[0] = 0x20534444; // "DDS "
+	header[1] = 124; // dwSize
+	header[2] = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000; // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT
+	header[3] = size; // dwHeight
+	header[4] = size; // dwWidth
+	header[5] = size * 4; // dwPitchOrLinearSize
+	header[19] = 32; // ddspf.dwSize
+	header[20] = 0x40 | 0x1; // DDPF_RGB | DDPF_ALPHAPIXELS
+	header[22] = 32; // ddspf.dwRGBBitCount
+	header[23] = 0x00FF0000; // ddspf.dwRBitMask
+	header[24] = 0x0000FF00; // ddspf.dwGBitMask
+	header[25] = 0x000000FF; // ddspf.dwBBitMask
+	header[26] = 0xFF000000; // ddspf.dwABitMask
+	header[27] = 0x1000; // DDSCAPS_TEXTURE
+	for (unsigned int i = 0; i < 32; i++)
+		writeLE(file, header[i]);
+
+	for (unsigned int i = 0; i < size * size; i++)
+		writeLE(file, 0xFF000000 | (i * 0x010203));
+
+	fclose(file);
+	return true;
+}
+
+class AsyncTextureLoaderTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		// The application is headless and has no worker threads, a pool is registered for the test
+		nc::theServiceLocator().registerThreadPool(nctl::makeUnique<nc::ThreadPool>(NumThreads));
+		loader_ = nctl::makeUnique<nc::AsyncTextureLoader>();
+		ASSERT_TRUE(writeDdsFile(Filename, TextureSize));
+	}
+
+	void TearDown() override
+	{
+		// The loader waits for its jobs, it has to be destroyed before the pool
+		loader_.reset(nullptr);
+		nc::theServiceLocator().unregisterThreadPool();
+		nc::fs::deleteFile(Filename);
+	}
+
+	/// Uploads decoded textures until no request is pending, checking the number of decoding ones
+	bool updateUntilDone()
+	{
+		for (unsigned int i = 0; i < MaxUpdates; i++)
+		{
+			if (loader_->numDecodingRequests() > loader_->maxDecodingRequests())
+				return false;
+			if (loader_->numPendingRequests() == 0)
+				return true;
+
+			loader_->update(100.0f);
+			nc::Timer::sleep(0.001f);
+		}
+		return false;
+	}
+
+	nc::Texture textures_[NumTextures];
+	CallbackCounters counters_;
+	nctl::UniquePtr<nc::AsyncTextureLoader> loader_;
+};
+
+TEST_F(AsyncTextureLoaderTest, LoadTextures)
+{
+	for (unsigned int i = 0; i < NumTextures; i++)
+		loader_->enqueue(&textures_[i], Filename, onLoaded, &counters_);
+	printf("Loading %u textures with at most %u decoding jobs at the same time\n", NumTextures, loader_->maxDecodingRequests());
+
+	ASSERT_TRUE(updateUntilDone());
+	ASSERT_EQ(counters_.numLoaded, NumTextures);
+	ASSERT_EQ(counters_.numFailed, 0u);
+	for (unsigned int i = 0; i < NumTextures; i++)
+	{
+		ASSERT_FALSE(textures_[i].isLoading());
+		ASSERT_EQ(textures_[i].width(), static_cast<int>(TextureSize));
+		ASSERT_EQ(textures_[i].height(), static_cast<int>(TextureSize));
+	}
+}
+
+TEST_F(AsyncTextureLoaderTest, BoundedDecoding)
+{
+	for (unsigned int i = 0; i < NumTextures; i++)
+		loader_->enqueue(&textures_[i], Filename, onLoaded, &counters_);
+	printf("Enqueued %u textures, %u of them are being decoded\n", NumTextures, loader_->numDecodingRequests());
+
+	ASSERT_EQ(loader_->maxDecodingRequests(), NumThreads / 2);
+	ASSERT_LE(loader_->numDecodingRequests(), loader_->maxDecodingRequests());
+	ASSERT_EQ(loader_->numPendingRequests(), NumTextures);
+}
+
+TEST_F(AsyncTextureLoaderTest, MissingFile)
+{
+	loader_->enqueue(&textures_[0], MissingFilename, onLoaded, &counters_);
+	printf("Loading a texture from a file that does not exist\n");
+
+	ASSERT_TRUE(updateUntilDone());
+	ASSERT_EQ(counters_.numLoaded, 0u);
+	ASSERT_EQ(counters_.numFailed, 1u);
+	ASSERT_FALSE(textures_[0].isLoading());
+}
+
+TEST_F(AsyncTextureLoaderTest, CancelRequests)
+{
+	for (unsigned int i = 0; i < NumTextures; i++)
+		loader_->enqueue(&textures_[i], Filename, onLoaded, &counters_);
+	printf("Cancelling every other request out of %u\n", NumTextures);
+	for (unsigned int i = 0; i < NumTextures; i += 2)
+		loader_->cancel(&textures_[i]);
+
+	ASSERT_TRUE(updateUntilDone());
+	ASSERT_EQ(counters_.numLoaded, NumTextures / 2);
+	for (unsigned int i = 0; i < NumTextures; i++)
+	{
+		ASSERT_FALSE(textures_[i].isLoading());
+		const int expectedSize = (i % 2 == 0) ? 0 : static_cast<int>(TextureSize);
+		ASSERT_EQ(textures_[i].width(), expectedSize);
+	}
+}
+
+TEST_F(AsyncTextureLoaderTest, DestroyWithPendingRequests)
+{
+	for (unsigned int i = 0; i < NumTextures; i++)
+		loader_->enqueue(&textures_[i], Filename, onLoaded, &counters_);
+	printf("Destroying the loader with %u pending requests\n", loader_->numPendingRequests());
+	loader_.reset(nullptr);
+
+	ASSERT_EQ(counters_.numLoaded, 0u);
+	for (unsigned int i = 0; i < NumTextures; i++)
+		ASSERT_FALSE(textures_[i].isLoading());
+}
+
+}
@@ -0,0 +1,275 @@
+#include <cstring> // for memcmp()
+#include "FontAtlas.h"
+#include <ncine/IFile.h>
+#include <ncine/FileSystem.h>
+#include <nctl/Array.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int Spread = 4;
+const unsigned int MaxAtlasSize = 1024;
+const unsigned int NumGlyphs = 40;
+const unsigned int LineHeight = 24;
+const unsigned int Base = 18;
+const uint64_t SourceHash = 0x0123456789abcdefULL;
+const char *CacheFilename = "gtest_fontatlas.ncdf";
+/// A local copy that can be bound to the references of the assertion macros
+const uint16_t Version = nc::FontAtlas::Version;
+
+/// Builds the coverage of a glyph filled in its central part, with anti-aliased pixels on the left and right borders
+void buildCoverage(unsigned int width, unsigned int height, nctl::Array<unsigned char> &coverage)
+{
+	coverage.setSize(width * height);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const bool border = (x == 0 || y == 0 || x == width - 1 || y == height - 1);
+			coverage[y * width + x] = border ? ((x == 0 || x == width - 1) && y > 0 && y < height - 1 ? 128 : 0) : 255;
+		}
+	}
+}
+
+uint64_t readLE(const unsigned char *bytes, unsigned int numBytes)
+{
+	uint64_t value = 0;
+	for (unsigned int i = 0; i < numBytes; i++)
+		value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+	return value;
+}
+
+class FontAtlasTest : public ::testing::Test
+{
+  public:
+	FontAtlasTest()
+	    : atlas_(Spread) {}
+
+  protected:
+	void TearDown() override
+	{
+		if (nc::fs::isFile(CacheFilename))
+			nc::fs::deleteFile(CacheFilename);
+	}
+
+	/// Adds glyphs of many different sizes, a space with no pixels and some kerning pairs
+	void addGlyphs()
+	{
+		atlas_.setLineMetrics(LineHeight, Base);
+		atlas_.addGlyph(' ', nullptr, 1, 0, 0, 0, 0, 0, 6);
+
+		nctl::Array<unsigned char> coverage;
+		for (unsigned int i = 1; i < NumGlyphs; i++)
+		{
+			const unsigned int width = 3 + (i * 7) % 13;
+			const unsigned int height = 3 + (i * 5) % 17;
+			buildCoverage(width, height, coverage);
+			atlas_.addGlyph(' ' + i, coverage.data(), 1, width, width, height, static_cast<int>(i % 3) - 1, -static_cast<int>(height), width + 1);
+		}
+
+		atlas_.addKerning('A', 'V', -3);
+		atlas_.addKerning('T', 'o', -2);
+		atlas_.addKerning('f', 'f', 1);
+	}
+
+	nc::FontAtlas atlas_;
+};
+
+TEST_F(FontAtlasTest, PackInBounds)
+{
+	addGlyphs();
+	printf("Packing %u glyphs with a spread of %u pixels\n", NumGlyphs, Spread);
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+	ASSERT_EQ(atlas_.numGlyphs(), NumGlyphs);
+	printf("Atlas size: %u x %u\n", atlas_.width(), atlas_.height());
+
+	// The atlas dimensions are powers of two
+	ASSERT_EQ(atlas_.width() & (atlas_.width() - 1), 0u);
+	ASSERT_EQ(atlas_.height() & (atlas_.height() - 1), 0u);
+	ASSERT_LE(atlas_.width(), MaxAtlasSize);
+	ASSERT_LE(atlas_.height(), MaxAtlasSize);
+
+	for (unsigned int i = 0; i < atlas_.numGlyphs(); i++)
+	{
+		const nc::FontAtlas::Glyph &glyph = atlas_.glyph(i);
+		if (glyph.width == 0)
+			continue;
+		ASSERT_LE(glyph.x + glyph.width, atlas_.width());
+		ASSERT_LE(glyph.y + glyph.height, atlas_.height());
+	}
+}
+
+TEST_F(FontAtlasTest, PackWithoutOverlap)
+{
+	addGlyphs();
+	printf("Checking that no two of the %u packed glyphs overlap\n", NumGlyphs);
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+
+	for (unsigned int i = 0; i < atlas_.numGlyphs(); i++)
+	{
+		const nc::FontAtlas::Glyph &glyph = atlas_.glyph(i);
+		if (glyph.width == 0)
+			continue;
+
+		for (unsigned int j = i + 1; j < atlas_.numGlyphs(); j++)
+		{
+			const nc::FontAtlas::Glyph &other = atlas_.glyph(j);
+			if (other.width == 0)
+				continue;
+			const bool separated = (glyph.x + glyph.width <= other.x || other.x + other.width <= glyph.x ||
+			                        glyph.y + glyph.height <= other.y || other.y + other.height <= glyph.y);
+			ASSERT_TRUE(separated) << "Glyphs " << i << " and " << j << " overlap";
+		}
+	}
+}
+
+TEST_F(FontAtlasTest, PackTooSmall)
+{
+	addGlyphs();
+	printf("Packing %u glyphs in an atlas that is too small\n", NumGlyphs);
+	ASSERT_FALSE(atlas_.pack(16));
+	ASSERT_EQ(atlas_.width(), 0u);
+}
+
+TEST_F(FontAtlasTest, EmptyGlyph)
+{
+	printf("Adding a glyph with no pixels\n");
+	atlas_.addGlyph(' ', nullptr, 1, 0, 0, 0, 1, 2, 6);
+	ASSERT_EQ(atlas_.numGlyphs(), 1u);
+	const nc::FontAtlas::Glyph &glyph = atlas_.glyph(0);
+	ASSERT_EQ(glyph.width, 0u);
+	ASSERT_EQ(glyph.height, 0u);
+	ASSERT_EQ(glyph.xOffset, 1);
+	ASSERT_EQ(glyph.yOffset, 2);
+	ASSERT_EQ(glyph.xAdvance, 6);
+}
+
+TEST_F(FontAtlasTest, FieldSign)
+{
+	const unsigned int size = 12;
+	nctl::Array<unsigned char> coverage;
+	buildCoverage(size, size, coverage);
+	printf("Checking the sign of the distance field of a %u x %u square\n", size, size);
+	atlas_.addGlyph('#', coverage.data(), 1, size, size, size, 2, -10, size);
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+
+	// The glyph is padded by the spread on every side
+	const nc::FontAtlas::Glyph &glyph = atlas_.glyph(0);
+	ASSERT_EQ(glyph.width, size + 2 * Spread);
+	ASSERT_EQ(glyph.height, size + 2 * Spread);
+	ASSERT_EQ(glyph.xOffset, 2 - static_cast<int>(Spread));
+	ASSERT_EQ(glyph.yOffset, -10 - static_cast<int>(Spread));
+
+	const unsigned char *texels = atlas_.texels();
+	const unsigned int pitch = atlas_.width();
+	const unsigned char *origin = texels + glyph.y * pitch + glyph.x;
+	const unsigned int center = glyph.width / 2;
+	// Inside the glyph the field is above one half, outside it is below and it fades to zero at the spread distance
+	ASSERT_GT(origin[center * pitch + center], 128);
+	ASSERT_LT(origin[center * pitch + 1], 128);
+	ASSERT_EQ(origin[0], 0);
+	ASSERT_EQ(origin[(glyph.height - 1) * pitch + glyph.width - 1], 0);
+
+	// The field grows monotonically from the left border to the center of the glyph
+	for (unsigned int x = 1; x <= center; x++)
+		ASSERT_GE(origin[center * pitch + x], origin[center * pitch + x - 1]);
+}
+
+TEST_F(FontAtlasTest, CacheRoundTrip)
+{
+	addGlyphs();
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+	printf("Saving the atlas to \"%s\" and loading it back\n", CacheFilename);
+	ASSERT_TRUE(atlas_.saveToFile(CacheFilename, SourceHash));
+
+	nc::FontAtlas loadedAtlas(Spread);
+	ASSERT_TRUE(loadedAtlas.loadFromFile(CacheFilename, SourceHash));
+	ASSERT_EQ(loadedAtlas.lineHeight(), LineHeight);
+	ASSERT_EQ(loadedAtlas.base(), Base);
+	ASSERT_EQ(loadedAtlas.width(), atlas_.width());
+	ASSERT_EQ(loadedAtlas.height(), atlas_.height());
+	ASSERT_EQ(loadedAtlas.numGlyphs(), atlas_.numGlyphs());
+	ASSERT_EQ(loadedAtlas.numKernings(), atlas_.numKernings());
+	for (unsigned int i = 0; i < atlas_.numGlyphs(); i++)
+		ASSERT_EQ(memcmp(&loadedAtlas.glyph(i), &atlas_.glyph(i), sizeof(nc::FontAtlas::Glyph)), 0);
+	for (unsigned int i = 0; i < atlas_.numKernings(); i++)
+		ASSERT_EQ(loadedAtlas.kerning(i).amount, atlas_.kerning(i).amount);
+	ASSERT_EQ(memcmp(loadedAtlas.texels(), atlas_.texels(), atlas_.width() * atlas_.height()), 0);
+}
+
+TEST_F(FontAtlasTest, CacheLittleEndian)
+{
+	addGlyphs();
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+	printf("Checking that the numbers in \"%s\" are stored as little endian\n", CacheFilename);
+	ASSERT_TRUE(atlas_.saveToFile(CacheFilename, SourceHash));
+
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(CacheFilename);
+	fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+	ASSERT_TRUE(fileHandle->isOpened());
+	nctl::Array<unsigned char> data;
+	data.setSize(fileHandle->size());
+	ASSERT_EQ(fileHandle->read(data.data(), data.size()), data.size());
+
+	const unsigned char *header = data.data();
+	ASSERT_EQ(memcmp(header, nc::FontAtlas::Signature, sizeof(nc::FontAtlas::Signature)), 0);
+	ASSERT_EQ(readLE(header + 4, 2), Version);
+	ASSERT_EQ(readLE(header + 6, 2), Spread);
+	ASSERT_EQ(readLE(header + 8, 8), SourceHash);
+	ASSERT_EQ(readLE(header + 16, 4), atlas_.width());
+	ASSERT_EQ(readLE(header + 20, 4), atlas_.height());
+	ASSERT_EQ(readLE(header + 32, 4), NumGlyphs);
+
+	// The offsets of glyphs and the kerning amounts are negative
+	const unsigned char *glyphs = header + sizeof(nc::FontAtlas::Header);
+	const unsigned char *lastGlyph = glyphs + (NumGlyphs - 1) * sizeof(nc::FontAtlas::Glyph);
+	ASSERT_EQ(static_cast<int32_t>(readLE(lastGlyph + 24, 4)), atlas_.glyph(NumGlyphs - 1).yOffset);
+	const unsigned char *firstKerning = glyphs + NumGlyphs * sizeof(nc::FontAtlas::Glyph);
+	ASSERT_EQ(readLE(firstKerning, 4), static_cast<uint64_t>('A'));
+	ASSERT_EQ(static_cast<int32_t>(readLE(firstKerning + 8, 4)), -3);
+}
+
+TEST_F(FontAtlasTest, CacheStale)
+{
+	addGlyphs();
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+	printf("Loading the atlas with a different source hash or spread\n");
+	ASSERT_TRUE(atlas_.saveToFile(CacheFilename, SourceHash));
+
+	nc::FontAtlas loadedAtlas(Spread);
+	ASSERT_FALSE(loadedAtlas.loadFromFile(CacheFilename, SourceHash + 1));
+	nc::FontAtlas otherSpreadAtlas(Spread + 1);
+	ASSERT_FALSE(otherSpreadAtlas.loadFromFile(CacheFilename, SourceHash));
+	ASSERT_FALSE(loadedAtlas.loadFromFile("gtest_fontatlas_missing.ncdf", SourceHash));
+	ASSERT_EQ(loadedAtlas.width(), 0u);
+}
+
+TEST_F(FontAtlasTest, CacheTruncated)
+{
+	addGlyphs();
+	ASSERT_TRUE(atlas_.pack(MaxAtlasSize));
+	printf("Loading an atlas from a truncated file\n");
+	ASSERT_TRUE(atlas_.saveToFile(CacheFilename, SourceHash));
+
+	nctl::Array<unsigned char> data;
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(CacheFilename);
+		fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+		ASSERT_TRUE(fileHandle->isOpened());
+		data.setSize(fileHandle->size());
+		fileHandle->read(data.data(), data.size());
+	}
+	{
+		nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(CacheFilename);
+		fileHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+		ASSERT_TRUE(fileHandle->isOpened());
+		fileHandle->write(data.data(), data.size() - 1);
+	}
+
+	nc::FontAtlas loadedAtlas(Spread);
+	ASSERT_FALSE(loadedAtlas.loadFromFile(CacheFilename, SourceHash));
+}
+
+}
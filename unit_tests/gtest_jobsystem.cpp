@@ -0,0 +1,213 @@
+#include "ThreadPool.h"
+#include "Thread.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumThreads = 4;
+const unsigned int NumRounds = 20;
+const unsigned int NumChildren = 1000;
+const unsigned int NumIndices = 10000;
+
+/// Keeps a worker busy for a while, so that the other ones have the time to steal jobs
+void busyWork()
+{
+	volatile unsigned int value = 0;
+	for (unsigned int i = 0; i < 100; i++)
+		value = value + i;
+}
+
+void emptyJob(nc::JobId job, const void *data) {}
+
+void incrementJob(nc::JobId job, const void *data)
+{
+	busyWork();
+	nctl::Atomic32 *counter = *static_cast<nctl::Atomic32 *const *>(data);
+	counter->fetchAdd(1);
+}
+
+struct IndicesData
+{
+	nctl::Atomic32 *visits;
+	nctl::Atomic32 *numInvalidIndices;
+};
+
+void visitIndices(unsigned int first, unsigned int count, const void *data)
+{
+	const IndicesData &indicesData = *static_cast<const IndicesData *>(data);
+	if (nc::JobSystem::threadIndex() > NumThreads)
+		indicesData.numInvalidIndices->fetchAdd(1);
+
+	busyWork();
+	for (unsigned int i = first; i < first + count; i++)
+		indicesData.visits[i].fetchAdd(1);
+}
+
+void readThreadIndex(void *arg)
+{
+	*static_cast<unsigned int *>(arg) = nc::JobSystem::threadIndex();
+}
+
+void storeThreadIndexJob(nc::JobId job, const void *data)
+{
+	nctl::Atomic32 *threadIndex = *static_cast<nctl::Atomic32 *const *>(data);
+	threadIndex->store(static_cast<int32_t>(nc::JobSystem::threadIndex()));
+}
+
+class StoreThreadIndexCommand : public nc::IThreadCommand
+{
+  public:
+	explicit StoreThreadIndexCommand(nctl::Atomic32 *threadIndex)
+	    : threadIndex_(threadIndex) {}
+
+	void execute() override { threadIndex_->store(static_cast<int32_t>(nc::JobSystem::threadIndex())); }
+
+  private:
+	nctl::Atomic32 *threadIndex_;
+};
+
+struct ForeignThreadData
+{
+	nc::ThreadPool *threadPool;
+	nctl::Atomic32 *counter;
+	nctl::Atomic32 *threadIndex;
+};
+
+/// Creates, runs and waits for jobs from a thread that does not belong to the pool
+void submitFromForeignThread(void *arg)
+{
+	ForeignThreadData &foreignData = *static_cast<ForeignThreadData *>(arg);
+	nc::ThreadPool &threadPool = *foreignData.threadPool;
+
+	nc::JobId root = threadPool.createJob(storeThreadIndexJob, &foreignData.threadIndex, sizeof(nctl::Atomic32 *));
+	for (unsigned int i = 0; i < NumChildren; i++)
+		threadPool.run(threadPool.createJobAsChild(root, incrementJob, &foreignData.counter, sizeof(nctl::Atomic32 *)));
+	threadPool.run(root);
+	threadPool.wait(root);
+}
+
+class JobSystemTest : public ::testing::Test
+{
+  public:
+	JobSystemTest()
+	    : threadPool_(NumThreads) {}
+
+  protected:
+	nc::ThreadPool threadPool_;
+};
+
+TEST_F(JobSystemTest, MainThreadIndex)
+{
+	printf("The thread that creates the pool has index %u\n", nc::JobSystem::threadIndex());
+	ASSERT_EQ(nc::JobSystem::threadIndex(), 0u);
+}
+
+TEST_F(JobSystemTest, ForeignThreadIndex)
+{
+	unsigned int threadIndex = 0;
+	nc::Thread thread(readThreadIndex, &threadIndex);
+	thread.join();
+	printf("A thread that does not belong to the pool has index %u\n", threadIndex);
+
+	const unsigned int invalidIndex = nc::JobSystem::InvalidThreadIndex;
+	ASSERT_EQ(threadIndex, invalidIndex);
+}
+
+TEST_F(JobSystemTest, SubmitFromForeignThreads)
+{
+	const unsigned int NumForeignThreads = 2;
+	nctl::Atomic32 counter(0);
+	nctl::Atomic32 threadIndices[NumForeignThreads];
+	ForeignThreadData foreignData[NumForeignThreads];
+	printf("Submitting %u jobs from each of %u threads that do not belong to the pool\n", NumChildren, NumForeignThreads);
+
+	nc::Thread threads[NumForeignThreads];
+	for (unsigned int i = 0; i < NumForeignThreads; i++)
+	{
+		foreignData[i] = { &threadPool_, &counter, &threadIndices[i] };
+		threads[i].run(submitFromForeignThread, &foreignData[i]);
+	}
+	for (unsigned int i = 0; i < NumForeignThreads; i++)
+		threads[i].join();
+
+	ASSERT_EQ(counter.load(), static_cast<int32_t>(NumForeignThreads * NumChildren));
+	// The jobs of a foreign thread are executed by the workers
+	for (unsigned int i = 0; i < NumForeignThreads; i++)
+	{
+		ASSERT_GE(threadIndices[i].load(), 1);
+		ASSERT_LE(threadIndices[i].load(), static_cast<int32_t>(NumThreads));
+	}
+}
+
+TEST_F(JobSystemTest, CommandsRunOnWorkers)
+{
+	const int32_t invalidIndex = -1;
+	nctl::Atomic32 threadIndex(invalidIndex);
+	printf("Enqueueing a command from the main thread\n");
+
+	threadPool_.enqueueCommand(nctl::makeUnique<StoreThreadIndexCommand>(&threadIndex));
+	// The main thread helping with jobs never executes a command
+	nc::JobId job = threadPool_.createJob(emptyJob, nullptr, 0);
+	threadPool_.run(job);
+	threadPool_.wait(job);
+	while (threadIndex.load() == invalidIndex)
+		nc::Thread::yieldExecution();
+
+	ASSERT_GE(threadIndex.load(), 1);
+	ASSERT_LE(threadIndex.load(), static_cast<int32_t>(NumThreads));
+}
+
+TEST_F(JobSystemTest, SubmitFromMainThreadWhileWorkersSteal)
+{
+	nctl::Atomic32 counter(0);
+	nctl::Atomic32 *counterPtr = &counter;
+	printf("Submitting %u rounds of %u jobs from the main thread\n", NumRounds, NumChildren);
+
+	for (unsigned int round = 0; round < NumRounds; round++)
+	{
+		nc::JobId root = threadPool_.createJob(emptyJob, nullptr, 0);
+		// Children are run one by one, so that workers are stealing while the main thread keeps pushing
+		for (unsigned int i = 0; i < NumChildren; i++)
+			threadPool_.run(threadPool_.createJobAsChild(root, incrementJob, &counterPtr, sizeof(nctl::Atomic32 *)));
+		threadPool_.run(root);
+		threadPool_.wait(root);
+
+		ASSERT_TRUE(threadPool_.isFinished(root));
+		ASSERT_EQ(counter.load(), static_cast<int32_t>((round + 1) * NumChildren));
+	}
+}
+
+TEST_F(JobSystemTest, Continuation)
+{
+	nctl::Atomic32 counter(0);
+	nctl::Atomic32 *counterPtr = &counter;
+	printf("Running a job with a continuation from the main thread\n");
+
+	nc::JobId ancestor = threadPool_.createJob(incrementJob, &counterPtr, sizeof(nctl::Atomic32 *));
+	nc::JobId continuation = threadPool_.createJob(incrementJob, &counterPtr, sizeof(nctl::Atomic32 *));
+	ASSERT_TRUE(threadPool_.addContinuation(ancestor, continuation));
+	threadPool_.run(ancestor);
+	threadPool_.wait(continuation);
+
+	ASSERT_TRUE(threadPool_.isFinished(ancestor));
+	ASSERT_EQ(counter.load(), 2);
+}
+
+TEST_F(JobSystemTest, ParallelForVisitsEveryIndexOnce)
+{
+	nctl::UniquePtr<nctl::Atomic32[]> visits = nctl::makeUnique<nctl::Atomic32[]>(NumIndices);
+	nctl::Atomic32 numInvalidIndices(0);
+	const IndicesData indicesData = { visits.get(), &numInvalidIndices };
+	printf("Visiting %u indices %u times with a parallel for\n", NumIndices, NumRounds);
+
+	for (unsigned int round = 0; round < NumRounds; round++)
+		threadPool_.parallelFor(NumIndices, 16, visitIndices, &indicesData);
+
+	ASSERT_EQ(numInvalidIndices.load(), 0);
+	for (unsigned int i = 0; i < NumIndices; i++)
+		ASSERT_EQ(visits[i].load(), static_cast<int32_t>(NumRounds));
+}
+
+}
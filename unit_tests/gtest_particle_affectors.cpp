@@ -0,0 +1,215 @@
+#include <cmath> // for fmodf()
+#include <ncine/ParticleAffectors.h>
+#include "Particle.h"
+#include "ParticleData.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumParticles = 300;
+const float Epsilon = 0.0001f;
+const float ColorEpsilon = 1.0f / 255.0f;
+
+/// An affector that only implements the per-particle interface, as one written before the arrays storage existed
+class CustomAffector : public nc::ParticleAffector
+{
+  public:
+	CustomAffector()
+	    : nc::ParticleAffector(Type::POSITION) {}
+
+	void affect(nc::Particle *particle, float normalizedAge) override
+	{
+		particle->move(normalizedAge, -normalizedAge);
+		particle->setRotation(particle->startingRotation + normalizedAge * 90.0f);
+		particle->velocity_ *= 0.5f;
+	}
+
+	unsigned int numSteps() const override { return 0; }
+	void removeStep(unsigned int index) override {}
+	void clearSteps() override {}
+};
+
+class ParticleAffectorsTest : public ::testing::Test
+{
+  public:
+	ParticleAffectorsTest()
+	    : data_(NumParticles) {}
+
+  protected:
+	void SetUp() override
+	{
+		for (unsigned int i = 0; i < NumParticles; i++)
+		{
+			const float life = 1.0f + (i % 7) * 0.5f;
+			const nc::Vector2f position(i * 2.0f, i * -3.0f);
+			const nc::Vector2f velocity(10.0f + i, 5.0f - i);
+			const float rotation = (i % 36) * 10.0f;
+
+			const unsigned int index = data_.emit(life, position, velocity, rotation);
+			ASSERT_EQ(index, i);
+			// Spreading the ages between zero and one, including both ends
+			data_.life[index] = life * (1.0f - float(i % 11) / 10.0f);
+
+			particles_.pushBack(nctl::makeUnique<nc::Particle>(nullptr, nullptr));
+			nc::Particle &particle = *particles_.back();
+			particle.life_ = data_.life[index];
+			particle.startingLife = life;
+			particle.startingRotation = rotation;
+			particle.velocity_ = velocity;
+			particle.setPosition(position);
+			particle.setRotation(rotation);
+			particle.setScale(data_.scaleX[index], data_.scaleY[index]);
+			particle.setColor(nc::Colorf(data_.colorR[index], data_.colorG[index], data_.colorB[index], data_.colorA[index]));
+		}
+		data_.calculateNormalizedAges();
+	}
+
+	/// Applies the affector to both storages and checks that every particle property is the same
+	void affectAndCompare(nc::ParticleAffector &affector)
+	{
+		for (unsigned int i = 0; i < NumParticles; i++)
+			affector.affect(particles_[i].get());
+		affector.affectRange(data_, 0, NumParticles);
+
+		for (unsigned int i = 0; i < NumParticles; i++)
+		{
+			const nc::Particle &particle = *particles_[i];
+			ASSERT_NEAR(data_.positionX[i], particle.position().x, Epsilon);
+			ASSERT_NEAR(data_.positionY[i], particle.position().y, Epsilon);
+			ASSERT_NEAR(data_.velocityX[i], particle.velocity_.x, Epsilon);
+			ASSERT_NEAR(data_.velocityY[i], particle.velocity_.y, Epsilon);
+			// Node rotations are wrapped in the [0, 360) range, array ones are not
+			const float rotation = fmodf(data_.rotation[i], 360.0f);
+			ASSERT_NEAR((rotation < 0.0f) ? rotation + 360.0f : rotation, particle.rotation(), Epsilon);
+			ASSERT_NEAR(data_.scaleX[i], particle.scale().x, Epsilon);
+			ASSERT_NEAR(data_.scaleY[i], particle.scale().y, Epsilon);
+
+			const nc::Colorf color(particle.color());
+			ASSERT_NEAR(data_.colorR[i], color.r(), ColorEpsilon);
+			ASSERT_NEAR(data_.colorG[i], color.g(), ColorEpsilon);
+			ASSERT_NEAR(data_.colorB[i], color.b(), ColorEpsilon);
+			ASSERT_NEAR(data_.colorA[i], color.a(), ColorEpsilon);
+		}
+	}
+
+	nc::ParticleData data_;
+	nctl::Array<nctl::UniquePtr<nc::Particle>> particles_;
+};
+
+TEST_F(ParticleAffectorsTest, ColorAffector)
+{
+	nc::ColorAffector affector;
+	affector.addColorStep(0.0f, nc::Colorf(1.0f, 0.0f, 0.0f, 1.0f));
+	affector.addColorStep(0.3f, nc::Colorf(0.0f, 1.0f, 0.5f, 0.8f));
+	affector.addColorStep(1.0f, nc::Colorf(0.0f, 0.0f, 1.0f, 0.0f));
+	printf("Comparing a color affector with %u steps\n", affector.numSteps());
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, SizeAffector)
+{
+	nc::SizeAffector affector(2.0f, 0.5f);
+	affector.addSizeStep(0.0f, 1.0f);
+	affector.addSizeStep(0.5f, 3.0f, 2.0f);
+	affector.addSizeStep(1.0f, 0.0f);
+	printf("Comparing a size affector with %u steps\n", affector.numSteps());
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, SizeAffectorWithoutSteps)
+{
+	nc::SizeAffector affector(1.5f);
+	printf("Comparing a size affector without steps\n");
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, RotationAffector)
+{
+	nc::RotationAffector affector;
+	affector.addRotationStep(0.0f, 0.0f);
+	affector.addRotationStep(0.6f, 180.0f);
+	affector.addRotationStep(1.0f, 360.0f);
+	printf("Comparing a rotation affector with %u steps\n", affector.numSteps());
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, PositionAffector)
+{
+	nc::PositionAffector affector;
+	affector.addPositionStep(0.0f, 0.0f, 0.0f);
+	affector.addPositionStep(0.5f, 4.0f, -2.0f);
+	affector.addPositionStep(1.0f, -1.0f, 3.0f);
+	printf("Comparing a position affector with %u steps\n", affector.numSteps());
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, VelocityAffector)
+{
+	nc::VelocityAffector affector;
+	affector.addVelocityStep(0.0f, 1.0f, 1.0f);
+	affector.addVelocityStep(0.4f, 0.5f, 2.0f);
+	affector.addVelocityStep(1.0f, 0.0f, 0.0f);
+	printf("Comparing a velocity affector with %u steps\n", affector.numSteps());
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, StepsWithTheSameAge)
+{
+	nc::ColorAffector affector;
+	affector.addColorStep(0.0f, nc::Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+	affector.addColorStep(0.5f, nc::Colorf(1.0f, 1.0f, 1.0f, 1.0f));
+	affector.addColorStep(0.5f, nc::Colorf(0.0f, 0.0f, 0.0f, 0.0f));
+	affector.addColorStep(1.0f, nc::Colorf(0.0f, 0.0f, 0.0f, 0.0f));
+	printf("Comparing a color affector with two steps at the same age\n");
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, DisabledAffector)
+{
+	nc::PositionAffector affector;
+	affector.addPositionStep(0.0f, 4.0f, 4.0f);
+	affector.addPositionStep(1.0f, 4.0f, 4.0f);
+	affector.setEnabled(false);
+	printf("Comparing a disabled position affector\n");
+
+	affectAndCompare(affector);
+	ASSERT_EQ(data_.positionX[1], 2.0f);
+}
+
+TEST_F(ParticleAffectorsTest, DefaultRangeImplementation)
+{
+	CustomAffector affector;
+	printf("Comparing an affector that only implements the per-particle interface\n");
+
+	affectAndCompare(affector);
+}
+
+TEST_F(ParticleAffectorsTest, PartialRange)
+{
+	nc::VelocityAffector affector;
+	affector.addVelocityStep(0.0f, 2.0f, 2.0f);
+	affector.addVelocityStep(1.0f, 2.0f, 2.0f);
+	const unsigned int first = 10;
+	const unsigned int count = 5;
+	printf("Affecting the range of %u particles starting from index %u\n", count, first);
+
+	const float velocityBefore = data_.velocityX[first - 1];
+	const float velocityAfter = data_.velocityX[first + count];
+	affector.affectRange(data_, first, count);
+
+	ASSERT_EQ(data_.velocityX[first - 1], velocityBefore);
+	ASSERT_EQ(data_.velocityX[first + count], velocityAfter);
+	for (unsigned int i = first; i < first + count; i++)
+		ASSERT_NEAR(data_.velocityX[i], particles_[i]->velocity_.x + 2.0f, Epsilon);
+}
+
+}
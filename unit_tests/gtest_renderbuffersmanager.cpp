@@ -0,0 +1,195 @@
+#include <cstring>
+#include "RenderBuffersManager.h"
+#include "GLFence.h"
+#include "NullGL.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned long VboMaxSize = 16 * 1024;
+const unsigned long IboMaxSize = 8 * 1024;
+const unsigned int NumRingSections = nc::RenderBuffersManager::NumRingSections;
+/// More frames than there are sections, for the ring to wrap around a few times
+const unsigned int NumFrames = NumRingSections * 3 + 1;
+const unsigned long NumBytes = 1000;
+
+class RenderBuffersManagerTest : public ::testing::Test
+{
+  public:
+	RenderBuffersManagerTest()
+	    : buffersManager_(true, true, VboMaxSize, IboMaxSize, 0) {}
+
+  protected:
+	void TearDown() override
+	{
+		nc::NullGL::setFenceLatency(0);
+	}
+
+	/// Ends the frame like the application does, the null device is told that a new frame has started
+	void nextFrame()
+	{
+		buffersManager_.flushUnmap();
+		buffersManager_.remap();
+		nc::NullGL::nextFrame();
+	}
+
+	/// Acquires memory for vertices and indices in every frame, returns the number of fence waits
+	unsigned long runFrames(unsigned int numFrames)
+	{
+		const unsigned long numWaits = nc::NullGL::total().numFenceWaits;
+		for (unsigned int i = 0; i < numFrames; i++)
+		{
+			buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::ARRAY, NumBytes);
+			buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::ELEMENT_ARRAY, NumBytes);
+			buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::ARRAY, NumBytes);
+			nextFrame();
+		}
+		return nc::NullGL::total().numFenceWaits - numWaits;
+	}
+
+	nc::RenderBuffersManager buffersManager_;
+};
+
+TEST(GLFenceTest, SignaledWithoutFence)
+{
+	nc::GLFence fence;
+	printf("Checking a fence that has not been inserted\n");
+	ASSERT_FALSE(fence.isSet());
+	ASSERT_TRUE(fence.isSignaled());
+	ASSERT_EQ(fence.clientWait(0), static_cast<GLenum>(GL_ALREADY_SIGNALED));
+}
+
+TEST(GLFenceTest, SignaledAfterLatency)
+{
+	nc::NullGL::setFenceLatency(2);
+	nc::GLFence fence;
+	printf("Inserting a fence that is signaled after %u frames\n", nc::NullGL::fenceLatency());
+	fence.insert();
+	ASSERT_TRUE(fence.isSet());
+	ASSERT_FALSE(fence.isSignaled());
+
+	nc::NullGL::nextFrame();
+	ASSERT_FALSE(fence.isSignaled());
+	nc::NullGL::nextFrame();
+	ASSERT_TRUE(fence.isSignaled());
+
+	fence.reset();
+	ASSERT_FALSE(fence.isSet());
+	nc::NullGL::setFenceLatency(0);
+}
+
+TEST(GLFenceTest, ClientWait)
+{
+	nc::NullGL::setFenceLatency(1);
+	nc::GLFence fence;
+	printf("Waiting for a fence that is not signaled yet\n");
+	fence.insert();
+	const unsigned long numWaits = nc::NullGL::total().numFenceWaits;
+
+	ASSERT_EQ(fence.clientWait(0), static_cast<GLenum>(GL_TIMEOUT_EXPIRED));
+	ASSERT_EQ(fence.clientWait(1000), static_cast<GLenum>(GL_CONDITION_SATISFIED));
+	ASSERT_EQ(nc::NullGL::total().numFenceWaits, numWaits + 1);
+	ASSERT_TRUE(fence.isSignaled());
+	ASSERT_EQ(fence.clientWait(1000), static_cast<GLenum>(GL_ALREADY_SIGNALED));
+	nc::NullGL::setFenceLatency(0);
+}
+
+TEST_F(RenderBuffersManagerTest, PersistentMapping)
+{
+	printf("Checking that vertex, index and uniform buffers are persistently mapped\n");
+	ASSERT_TRUE(nc::RenderBuffersManager::hasPersistentMapping());
+	ASSERT_TRUE(buffersManager_.specs(nc::RenderBuffersManager::BufferTypes::ARRAY).persistentMapping);
+	ASSERT_TRUE(buffersManager_.specs(nc::RenderBuffersManager::BufferTypes::ELEMENT_ARRAY).persistentMapping);
+	ASSERT_TRUE(buffersManager_.specs(nc::RenderBuffersManager::BufferTypes::UNIFORM).persistentMapping);
+	ASSERT_FALSE(buffersManager_.isAvailable(nc::RenderBuffersManager::BufferTypes::TEXTURE));
+}
+
+TEST_F(RenderBuffersManagerTest, OffsetsWrapAround)
+{
+	printf("Acquiring %lu bytes for %u frames from a ring of %u sections\n", NumBytes, NumFrames, NumRingSections);
+	nc::RenderBuffersManager::Parameters firstParams[NumFrames];
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		firstParams[i] = buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::ARRAY, NumBytes);
+		const nc::RenderBuffersManager::Parameters secondParams = buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::ARRAY, NumBytes);
+		ASSERT_NE(firstParams[i].mapBase, nullptr);
+		ASSERT_EQ(secondParams.object, firstParams[i].object);
+		ASSERT_EQ(secondParams.offset, firstParams[i].offset + NumBytes);
+
+		// The whole ring stays mapped, writing to a section is always possible
+		memset(firstParams[i].mapBase + firstParams[i].offset, i, NumBytes * 2);
+		nextFrame();
+	}
+
+	// The persistently mapped buffers are neither mapped again nor flushed
+	ASSERT_EQ(nc::NullGL::lastFrame().numMappings, 0u);
+	ASSERT_EQ(nc::NullGL::lastFrame().uploadedBytes, 0u);
+
+	const unsigned long sectionSize = firstParams[1].offset - firstParams[0].offset;
+	ASSERT_GE(sectionSize, VboMaxSize);
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		ASSERT_EQ(firstParams[i].object, firstParams[0].object);
+		ASSERT_EQ(firstParams[i].mapBase, firstParams[0].mapBase);
+		ASSERT_EQ(firstParams[i].offset, firstParams[0].offset + (i % NumRingSections) * sectionSize);
+	}
+}
+
+TEST_F(RenderBuffersManagerTest, AlignedOffsets)
+{
+	const unsigned int alignment = buffersManager_.specs(nc::RenderBuffersManager::BufferTypes::UNIFORM).alignment;
+	printf("Acquiring uniform buffer memory aligned to %u bytes for %u frames\n", alignment, NumFrames);
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		for (unsigned long bytes = 1; bytes <= alignment * 4; bytes *= 3)
+		{
+			const nc::RenderBuffersManager::Parameters params = buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::UNIFORM, bytes);
+			ASSERT_EQ(params.offset % alignment, 0u);
+			ASSERT_EQ(params.size, bytes);
+		}
+		nextFrame();
+	}
+}
+
+TEST_F(RenderBuffersManagerTest, MaximumSizeInEverySection)
+{
+	const unsigned long uboMaxSize = buffersManager_.specs(nc::RenderBuffersManager::BufferTypes::UNIFORM).maxSize;
+	printf("Acquiring the maximum size of %lu bytes after a misaligned request for %u frames\n", uboMaxSize, NumFrames);
+	const nc::RenderBuffersManager::Parameters firstParams = buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::UNIFORM, 1);
+
+	// The padding of the sections keeps an aligned request of the maximum size in the same buffer
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		if (i > 0)
+			buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::UNIFORM, 1);
+		const nc::RenderBuffersManager::Parameters params = buffersManager_.acquireMemory(nc::RenderBuffersManager::BufferTypes::UNIFORM, uboMaxSize);
+		ASSERT_EQ(params.object, firstParams.object);
+		nextFrame();
+	}
+}
+
+TEST_F(RenderBuffersManagerTest, NoFenceWaits)
+{
+	nc::NullGL::setFenceLatency(NumRingSections);
+	printf("Running %u frames with a GPU that is %u frames late\n", NumFrames, nc::NullGL::fenceLatency());
+
+	const unsigned long numFences = nc::NullGL::total().numFences;
+	ASSERT_EQ(runFrames(NumFrames), 0u);
+	// A single fence is inserted every frame for all the buffer types
+	ASSERT_EQ(nc::NullGL::total().numFences - numFences, NumFrames);
+}
+
+TEST_F(RenderBuffersManagerTest, FenceWaits)
+{
+	nc::NullGL::setFenceLatency(NumRingSections + 1);
+	printf("Running %u frames with a GPU that is %u frames late\n", NumFrames, nc::NullGL::fenceLatency());
+
+	// The first frames write to sections that have never been read
+	ASSERT_EQ(runFrames(NumRingSections), 0u);
+	// Every following frame waits for the section of the ring it writes to
+	ASSERT_EQ(runFrames(NumFrames), NumFrames);
+}
+
+}
@@ -0,0 +1,119 @@
+#include "RenderCommandPool.h"
+#include "RenderCommand.h"
+#include "RenderResources.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int PoolSize = 16;
+const unsigned int NumCommands = 4;
+/// More than the number of resets after which an idle free list is deleted
+const unsigned int ManyResets = 200;
+
+class RenderCommandPoolTest : public ::testing::Test
+{
+  public:
+	RenderCommandPoolTest()
+	    : pool_(PoolSize),
+	      spriteShader_(nc::RenderResources::shaderProgram(nc::Material::ShaderProgramType::SPRITE)),
+	      meshShader_(nc::RenderResources::shaderProgram(nc::Material::ShaderProgramType::MESH_SPRITE)) {}
+
+  protected:
+	void SetUp() override
+	{
+		ASSERT_NE(spriteShader_, nullptr);
+		ASSERT_NE(meshShader_, nullptr);
+	}
+
+	nc::RenderCommandPool pool_;
+	nc::GLShaderProgram *spriteShader_;
+	nc::GLShaderProgram *meshShader_;
+};
+
+TEST_F(RenderCommandPoolTest, RetrieveFromEmptyPool)
+{
+	printf("Retrieving a command from an empty pool\n");
+	ASSERT_EQ(pool_.retrieve(spriteShader_), nullptr);
+}
+
+TEST_F(RenderCommandPoolTest, RetrieveAfterReset)
+{
+	nc::RenderCommand *commands[NumCommands];
+	for (unsigned int i = 0; i < NumCommands; i++)
+		commands[i] = pool_.add(spriteShader_);
+	printf("Retrieving %u commands after a reset\n", NumCommands);
+	pool_.reset();
+
+	for (unsigned int i = 0; i < NumCommands; i++)
+	{
+		nc::RenderCommand *command = pool_.retrieve(spriteShader_);
+		ASSERT_NE(command, nullptr);
+		ASSERT_EQ(command->material().shaderProgram(), spriteShader_);
+	}
+	ASSERT_EQ(pool_.retrieve(spriteShader_), nullptr);
+	ASSERT_EQ(pool_.retrieve(meshShader_), nullptr);
+}
+
+TEST_F(RenderCommandPoolTest, RetrieveOrAdd)
+{
+	bool commandAdded = false;
+	nc::RenderCommand *command = pool_.retrieveOrAdd(spriteShader_, commandAdded);
+	printf("Retrieving or adding a command before and after a reset\n");
+	ASSERT_TRUE(commandAdded);
+	pool_.reset();
+
+	ASSERT_EQ(pool_.retrieveOrAdd(spriteShader_, commandAdded), command);
+	ASSERT_FALSE(commandAdded);
+}
+
+TEST_F(RenderCommandPoolTest, ChangedShaderProgram)
+{
+	nc::RenderCommand *command = pool_.add(spriteShader_);
+	command->material().setShaderProgram(meshShader_);
+	printf("Returning a command to the free list of the shader program it uses at reset time\n");
+	pool_.reset();
+
+	ASSERT_EQ(pool_.retrieve(spriteShader_), nullptr);
+	ASSERT_EQ(pool_.retrieve(meshShader_), command);
+}
+
+TEST_F(RenderCommandPoolTest, KeepUsedFreeLists)
+{
+	for (unsigned int i = 0; i < NumCommands; i++)
+		pool_.add(spriteShader_);
+	printf("Retrieving the commands of a shader program for %u resets\n", ManyResets);
+	pool_.reset();
+
+	for (unsigned int i = 0; i < ManyResets; i++)
+	{
+		ASSERT_NE(pool_.retrieve(spriteShader_), nullptr);
+		pool_.reset();
+	}
+
+	for (unsigned int i = 0; i < NumCommands; i++)
+		ASSERT_NE(pool_.retrieve(spriteShader_), nullptr);
+}
+
+TEST_F(RenderCommandPoolTest, PruneIdleFreeLists)
+{
+	for (unsigned int i = 0; i < NumCommands; i++)
+	{
+		pool_.add(spriteShader_);
+		pool_.add(meshShader_);
+	}
+	printf("Only retrieving the commands of one of two shader programs for %u resets\n", ManyResets);
+	pool_.reset();
+
+	for (unsigned int i = 0; i < ManyResets; i++)
+	{
+		ASSERT_NE(pool_.retrieve(spriteShader_), nullptr);
+		pool_.reset();
+	}
+
+	ASSERT_NE(pool_.retrieve(spriteShader_), nullptr);
+	ASSERT_EQ(pool_.retrieve(meshShader_), nullptr);
+}
+
+}
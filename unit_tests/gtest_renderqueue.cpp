@@ -0,0 +1,162 @@
+#include "RenderQueue.h"
+#include "RenderCommand.h"
+#include "RenderResources.h"
+#include <nctl/Atomic.h>
+#include "gtest/gtest.h"
+#include "test_thread_functions.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumBuckets = 4;
+const unsigned int CommandsPerBucket = 8;
+const unsigned int NumCommands = NumBuckets * CommandsPerBucket;
+/// A local copy that can be bound to the references of the assertion macros
+const unsigned int NoBucket = nc::RenderQueue::NoBucket;
+
+class RenderQueueTest : public ::testing::Test
+{
+  public:
+	RenderQueueTest()
+	    : threadIndex_(0), tr_(this) {}
+
+	/// Adds the commands of a bucket from the calling thread, with visit order indices starting from one
+	void fillBucket(unsigned int bucketIndex)
+	{
+		queue_.setThreadBucket(bucketIndex);
+		for (unsigned int i = 0; i < CommandsPerBucket; i++)
+		{
+			nc::RenderCommand &command = commands_[bucketIndex * CommandsPerBucket + i];
+			command.setVisitOrder(static_cast<uint16_t>(i + 1));
+			queue_.addCommand(&command);
+		}
+		queue_.setThreadBucket(nc::RenderQueue::NoBucket);
+	}
+
+	nc::RenderQueue queue_;
+	nc::RenderQueue otherQueue_;
+	nc::RenderCommand commands_[NumCommands];
+	nctl::Atomic32 threadIndex_;
+	ThreadRunner<NumBuckets> tr_;
+
+  protected:
+	void SetUp() override
+	{
+		nc::GLShaderProgram *shader = nc::RenderResources::shaderProgram(nc::Material::ShaderProgramType::SPRITE);
+		ASSERT_NE(shader, nullptr);
+		for (unsigned int i = 0; i < NumCommands; i++)
+			commands_[i].material().setShaderProgram(shader);
+		queue_.setNumBuckets(NumBuckets);
+	}
+
+	/// Checks that the commands have been merged in bucket order, with visit order indices following `visitOrderIndex`
+	void checkMergedQueue(unsigned int visitOrderIndex)
+	{
+		const nctl::Array<nc::RenderCommand *> &opaqueQueue = queue_.opaqueQueue();
+		ASSERT_EQ(opaqueQueue.size(), NumCommands);
+		for (unsigned int i = 0; i < NumCommands; i++)
+		{
+			ASSERT_EQ(opaqueQueue[i], &commands_[i]);
+			ASSERT_EQ(opaqueQueue[i]->visitOrder(), visitOrderIndex + i + 1);
+		}
+	}
+};
+
+TEST_F(RenderQueueTest, NoThreadBucket)
+{
+	printf("Adding a command without setting a bucket\n");
+	ASSERT_EQ(queue_.numBuckets(), NumBuckets);
+	ASSERT_EQ(queue_.threadBucket(), NoBucket);
+
+	queue_.addCommand(&commands_[0]);
+	ASSERT_EQ(queue_.opaqueQueue().size(), 1u);
+	ASSERT_EQ(queue_.opaqueQueue()[0], &commands_[0]);
+}
+
+TEST_F(RenderQueueTest, MergeInBucketOrder)
+{
+	printf("Filling %u buckets in reverse order and merging them\n", NumBuckets);
+	for (int i = NumBuckets - 1; i >= 0; i--)
+		fillBucket(static_cast<unsigned int>(i));
+	ASSERT_TRUE(queue_.opaqueQueue().isEmpty());
+	ASSERT_FALSE(queue_.isEmpty());
+
+	ASSERT_EQ(queue_.mergeBuckets(0), NumCommands);
+	checkMergedQueue(0);
+}
+
+TEST_F(RenderQueueTest, MergeAfterVisitOrderIndex)
+{
+	const unsigned int visitOrderIndex = 100;
+	printf("Merging %u buckets after visit order index %u\n", NumBuckets, visitOrderIndex);
+	for (unsigned int i = 0; i < NumBuckets; i++)
+		fillBucket(i);
+
+	ASSERT_EQ(queue_.mergeBuckets(visitOrderIndex), visitOrderIndex + NumCommands);
+	checkMergedQueue(visitOrderIndex);
+}
+
+TEST_F(RenderQueueTest, DisabledVisitOrder)
+{
+	printf("Merging commands whose visit order is disabled\n");
+	fillBucket(0);
+	queue_.setThreadBucket(1);
+	commands_[CommandsPerBucket].setVisitOrder(0);
+	queue_.addCommand(&commands_[CommandsPerBucket]);
+	queue_.setThreadBucket(nc::RenderQueue::NoBucket);
+
+	// The command without a visit order neither gets an index nor advances the following ones
+	ASSERT_EQ(queue_.mergeBuckets(0), CommandsPerBucket);
+	ASSERT_EQ(queue_.opaqueQueue().size(), CommandsPerBucket + 1);
+	ASSERT_EQ(queue_.opaqueQueue()[CommandsPerBucket]->visitOrder(), 0u);
+}
+
+TEST_F(RenderQueueTest, MergeMultithread)
+{
+	printf("Filling %u buckets from %u threads and merging them twice\n", NumBuckets, NumBuckets);
+	for (unsigned int run = 0; run < 2; run++)
+	{
+		threadIndex_ = 0;
+		tr_.runThreads([](void *arg) -> ThreadRunner<NumBuckets>::threadFuncRet {
+			RenderQueueTest *test = static_cast<RenderQueueTest *>(arg);
+			const unsigned int index = static_cast<unsigned int>(test->threadIndex_.fetchAdd(1));
+			test->fillBucket(NumBuckets - index - 1);
+			return test->tr_.retFunc();
+		});
+
+		// The merged queue does not depend on the order in which the threads have been scheduled
+		ASSERT_EQ(queue_.mergeBuckets(0), NumCommands);
+		checkMergedQueue(0);
+		queue_.clear();
+	}
+}
+
+TEST_F(RenderQueueTest, ThreadBucketPerQueue)
+{
+	printf("Adding a command to a queue while filling the bucket of another one\n");
+	queue_.setThreadBucket(0);
+	ASSERT_EQ(queue_.threadBucket(), 0u);
+	ASSERT_EQ(otherQueue_.threadBucket(), NoBucket);
+
+	// The other queue has no buckets, the command goes directly to its queues
+	commands_[1].setVisitOrder(1);
+	otherQueue_.addCommand(&commands_[0]);
+	ASSERT_EQ(otherQueue_.opaqueQueue().size(), 1u);
+	queue_.addCommand(&commands_[1]);
+	ASSERT_TRUE(queue_.opaqueQueue().isEmpty());
+
+	// Setting a bucket of the other queue replaces the one of the first queue
+	otherQueue_.setNumBuckets(1);
+	otherQueue_.setThreadBucket(0);
+	ASSERT_EQ(queue_.threadBucket(), NoBucket);
+	ASSERT_EQ(otherQueue_.threadBucket(), 0u);
+	otherQueue_.setThreadBucket(nc::RenderQueue::NoBucket);
+	ASSERT_EQ(otherQueue_.threadBucket(), NoBucket);
+
+	ASSERT_EQ(queue_.mergeBuckets(0), 1u);
+	ASSERT_EQ(queue_.opaqueQueue().size(), 1u);
+	ASSERT_EQ(queue_.opaqueQueue()[0], &commands_[1]);
+}
+
+}
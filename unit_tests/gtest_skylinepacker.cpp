@@ -0,0 +1,154 @@
+#include "SkylinePacker.h"
+#include <ncine/Random.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int Width = 128;
+const unsigned int Height = 64;
+const unsigned int MaxRectSize = 20;
+const unsigned int MaxRects = 256;
+const uint64_t RandomState = 0x853c49e6748fea9bULL;
+const uint64_t RandomSequence = 0xda3e39cb94b95bdbULL;
+
+struct PackedRect
+{
+	nc::Vector2i position;
+	unsigned int width;
+	unsigned int height;
+};
+
+class SkylinePackerTest : public ::testing::Test
+{
+  public:
+	SkylinePackerTest()
+	    : packer_(Width, Height), numRects_(0) {}
+
+  protected:
+	/// Inserts a rectangle and records its position, returns false if it does not fit
+	bool insert(unsigned int width, unsigned int height)
+	{
+		PackedRect &rect = rects_[numRects_];
+		if (packer_.insert(width, height, rect.position) == false)
+			return false;
+		rect.width = width;
+		rect.height = height;
+		numRects_++;
+		return true;
+	}
+
+	/// Checks that every packed rectangle is inside the packing area and that none of them overlap
+	void checkPackedRects() const
+	{
+		unsigned long area = 0;
+		for (unsigned int i = 0; i < numRects_; i++)
+		{
+			const PackedRect &rect = rects_[i];
+			ASSERT_GE(rect.position.x, 0);
+			ASSERT_GE(rect.position.y, 0);
+			ASSERT_LE(rect.position.x + rect.width, packer_.width());
+			ASSERT_LE(rect.position.y + rect.height, packer_.height());
+			area += rect.width * rect.height;
+
+			for (unsigned int j = i + 1; j < numRects_; j++)
+			{
+				const PackedRect &other = rects_[j];
+				const bool separated = (rect.position.x + static_cast<int>(rect.width) <= other.position.x ||
+				                        other.position.x + static_cast<int>(other.width) <= rect.position.x ||
+				                        rect.position.y + static_cast<int>(rect.height) <= other.position.y ||
+				                        other.position.y + static_cast<int>(other.height) <= rect.position.y);
+				ASSERT_TRUE(separated) << "Rectangles " << i << " and " << j << " overlap";
+			}
+		}
+		ASSERT_EQ(packer_.usedArea(), area);
+	}
+
+	nc::SkylinePacker packer_;
+	PackedRect rects_[MaxRects];
+	unsigned int numRects_;
+};
+
+TEST_F(SkylinePackerTest, EmptyRectangle)
+{
+	printf("Inserting rectangles with no area\n");
+	nc::Vector2i position(-1, -1);
+	ASSERT_TRUE(packer_.insert(0, 10, position));
+	ASSERT_EQ(position, nc::Vector2i(0, 0));
+	ASSERT_TRUE(packer_.insert(10, 0, position));
+	ASSERT_EQ(packer_.usedArea(), 0u);
+}
+
+TEST_F(SkylinePackerTest, TooBig)
+{
+	printf("Inserting rectangles bigger than the %u x %u packing area\n", Width, Height);
+	ASSERT_FALSE(insert(Width + 1, 1));
+	ASSERT_FALSE(insert(1, Height + 1));
+	ASSERT_TRUE(insert(Width, Height));
+	ASSERT_FALSE(insert(1, 1));
+}
+
+TEST_F(SkylinePackerTest, FillCompletely)
+{
+	const unsigned int size = 16;
+	const unsigned int numRects = (Width / size) * (Height / size);
+	printf("Filling the %u x %u packing area with %u squares of %u pixels\n", Width, Height, numRects, size);
+	for (unsigned int i = 0; i < numRects; i++)
+		ASSERT_TRUE(insert(size, size));
+	checkPackedRects();
+	ASSERT_EQ(packer_.usedArea(), static_cast<unsigned long>(Width * Height));
+	ASSERT_FALSE(insert(1, 1));
+}
+
+TEST_F(SkylinePackerTest, BottomLeft)
+{
+	printf("Placing a rectangle in the lowest position of the skyline\n");
+	ASSERT_TRUE(insert(32, 30));
+	ASSERT_TRUE(insert(32, 10));
+	ASSERT_TRUE(insert(32, 20));
+	ASSERT_EQ(rects_[1].position, nc::Vector2i(32, 0));
+	ASSERT_EQ(rects_[2].position, nc::Vector2i(64, 0));
+
+	// The empty segment on the right is lower than the one on top of the shortest rectangle
+	ASSERT_TRUE(insert(32, 10));
+	ASSERT_EQ(rects_[3].position, nc::Vector2i(96, 0));
+	// A rectangle spanning the whole width rests on the tallest one
+	ASSERT_TRUE(insert(Width, 10));
+	ASSERT_EQ(rects_[4].position, nc::Vector2i(0, 30));
+	checkPackedRects();
+}
+
+TEST_F(SkylinePackerTest, RandomRectangles)
+{
+	nc::Random random(RandomState, RandomSequence);
+	printf("Inserting random rectangles up to %u pixels until the packing area is full\n", MaxRectSize);
+	unsigned int numFailures = 0;
+	while (numRects_ < MaxRects && numFailures < 16)
+	{
+		const unsigned int width = random.integer(1, MaxRectSize + 1);
+		const unsigned int height = random.integer(1, MaxRectSize + 1);
+		if (insert(width, height) == false)
+			numFailures++;
+	}
+	printf("%u rectangles packed, %.1f%% of the area is used\n", numRects_, 100.0f * packer_.usedArea() / (Width * Height));
+	ASSERT_GT(numRects_, 0u);
+	checkPackedRects();
+}
+
+TEST_F(SkylinePackerTest, Reset)
+{
+	printf("Resetting the packer to a bigger area\n");
+	ASSERT_TRUE(insert(Width, Height));
+	packer_.reset(Width * 2, Height);
+	numRects_ = 0;
+	ASSERT_EQ(packer_.width(), Width * 2);
+	ASSERT_EQ(packer_.usedArea(), 0u);
+
+	ASSERT_TRUE(insert(Width, Height));
+	ASSERT_TRUE(insert(Width, Height));
+	ASSERT_EQ(rects_[1].position, nc::Vector2i(Width, 0));
+	checkPackedRects();
+}
+
+}
@@ -0,0 +1,334 @@
+#include <ncine/Application.h>
+#include <ncine/Sprite.h>
+#include <ncine/Viewport.h>
+#include "SpatialGrid.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const float CellSize = 64.0f;
+const float SpriteSize = 10.0f;
+const unsigned int NumSpritesPerSide = 8;
+const unsigned int NumSprites = NumSpritesPerSide * NumSpritesPerSide;
+const float SpriteDistance = 50.0f;
+
+/// A sprite that exposes the culling functions called by a viewport
+class TestSprite : public nc::Sprite
+{
+  public:
+	TestSprite(nc::SceneNode *parent, float xx, float yy)
+	    : nc::Sprite(parent, nullptr, xx, yy)
+	{
+		setSize(SpriteSize, SpriteSize);
+	}
+
+	using nc::DrawableNode::updateCulling;
+};
+
+/// A viewport that exposes the functions called by the application every frame
+class TestViewport : public nc::Viewport
+{
+  public:
+	using nc::Viewport::update;
+	using nc::Viewport::visit;
+};
+
+class SpatialGridTest : public ::testing::Test
+{
+  public:
+	SpatialGridTest()
+	    : grid_(CellSize), frame_(nc::theApplication().numFrames() + 1) {}
+
+  protected:
+	void SetUp() override
+	{
+		// Sprites are owned by the array
+		root_.setDeleteChildrenOnDestruction(false);
+		for (unsigned int y = 0; y < NumSpritesPerSide; y++)
+		{
+			for (unsigned int x = 0; x < NumSpritesPerSide; x++)
+				sprites_.pushBack(nctl::makeUnique<TestSprite>(&root_, x * SpriteDistance, y * SpriteDistance));
+		}
+	}
+
+	/// Transforms the scene and updates the grid like a viewport would
+	void updateCulling()
+	{
+		root_.update(0.0f);
+		for (nctl::UniquePtr<TestSprite> &sprite : sprites_)
+		{
+			if (sprite->parent())
+				sprite->updateCulling(&grid_);
+		}
+	}
+
+	/// Updates and visits the viewport, returning the visit order of the sprites overlapping its culling rectangle
+	void visitOrders(TestViewport &viewport, nctl::Array<unsigned int> &orders)
+	{
+		// The viewport only updates the scene once per frame and the test runs in a single frame
+		root_.update(0.0f);
+		viewport.update();
+		viewport.visit();
+
+		orders.clear();
+		for (const nctl::UniquePtr<TestSprite> &sprite : sprites_)
+		{
+			if (sprite->aabb().overlaps(viewport.cullingRect()))
+				orders.pushBack(sprite->visitOrderIndex());
+		}
+	}
+
+	/// Marks and collects the sprites overlapping the rectangle, using a new frame number every time
+	void markOverlapping(const nc::Rectf &rect)
+	{
+		frame_++;
+		collected_.clear();
+		grid_.collectOverlapping(rect, frame_, collected_);
+	}
+
+	/// Returns the number of sprites marked by the last call to `markOverlapping()`, checking that they have all been collected
+	unsigned int numMarked() const
+	{
+		unsigned int count = 0;
+		for (const nctl::UniquePtr<TestSprite> &sprite : sprites_)
+		{
+			if (sprite->lastFrameRendered() == frame_)
+				count++;
+		}
+		EXPECT_EQ(count, collected_.size());
+		return count;
+	}
+
+	nc::SceneNode root_;
+	nctl::Array<nctl::UniquePtr<TestSprite>> sprites_;
+	nc::SpatialGrid grid_;
+	unsigned long int frame_;
+	nctl::Array<nc::SceneNode *> collected_;
+};
+
+TEST_F(SpatialGridTest, InsertAllNodes)
+{
+	updateCulling();
+	printf("Inserting %u sprites in a grid with cells of %.0f units\n", NumSprites, CellSize);
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+}
+
+TEST_F(SpatialGridTest, MarkEverything)
+{
+	updateCulling();
+	const float side = NumSpritesPerSide * SpriteDistance;
+	markOverlapping(nc::Rectf(-SpriteDistance, -SpriteDistance, side + SpriteDistance, side + SpriteDistance));
+	printf("Marked %u sprites with a rectangle covering the whole scene\n", numMarked());
+
+	ASSERT_EQ(numMarked(), NumSprites);
+}
+
+TEST_F(SpatialGridTest, MarkOverlappingOnly)
+{
+	updateCulling();
+	// Only the first two columns and rows are overlapped, including the sprites straddling the rectangle edges
+	markOverlapping(nc::Rectf(0.0f, 0.0f, SpriteDistance, SpriteDistance));
+	printf("Marked %u sprites with a rectangle covering four of them\n", numMarked());
+
+	ASSERT_EQ(numMarked(), 4u);
+	ASSERT_EQ(sprites_[0]->lastFrameRendered(), frame_);
+	ASSERT_EQ(sprites_[1]->lastFrameRendered(), frame_);
+	ASSERT_EQ(sprites_[NumSpritesPerSide]->lastFrameRendered(), frame_);
+	ASSERT_EQ(sprites_[NumSpritesPerSide + 1]->lastFrameRendered(), frame_);
+}
+
+TEST_F(SpatialGridTest, MarkOutside)
+{
+	updateCulling();
+	markOverlapping(nc::Rectf(-1000.0f, -1000.0f, 100.0f, 100.0f));
+	printf("Marked %u sprites with a rectangle outside of the scene\n", numMarked());
+
+	ASSERT_EQ(numMarked(), 0u);
+}
+
+TEST_F(SpatialGridTest, MoveNode)
+{
+	updateCulling();
+	TestSprite &sprite = *sprites_.back();
+	printf("Moving the last sprite to the origin\n");
+	sprite.setPosition(0.0f, 0.0f);
+	updateCulling();
+
+	markOverlapping(nc::Rectf(-1.0f, -1.0f, 2.0f, 2.0f));
+	ASSERT_EQ(numMarked(), 2u);
+	ASSERT_EQ(sprite.lastFrameRendered(), frame_);
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+}
+
+TEST_F(SpatialGridTest, OversizedNode)
+{
+	updateCulling();
+	TestSprite &sprite = *sprites_[0];
+	const float bigSize = CellSize * 6.0f;
+	printf("Resizing the first sprite to %.0f units, bigger than a cell\n", bigSize);
+	sprite.setSize(bigSize, bigSize);
+	updateCulling();
+
+	// The rectangle is far from the cell of the sprite center but inside its AABB
+	const nc::Rectf rect(bigSize * 0.5f - 10.0f, bigSize * 0.5f - 10.0f, 2.0f, 2.0f);
+	markOverlapping(rect);
+	ASSERT_EQ(numMarked(), 1u);
+	ASSERT_EQ(collected_[0], &sprite);
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+
+	printf("Resizing the first sprite back to %.0f units\n", SpriteSize);
+	sprite.setSize(SpriteSize, SpriteSize);
+	updateCulling();
+
+	markOverlapping(rect);
+	ASSERT_EQ(numMarked(), 0u);
+	markOverlapping(nc::Rectf(-1.0f, -1.0f, 2.0f, 2.0f));
+	ASSERT_EQ(numMarked(), 1u);
+	ASSERT_EQ(collected_[0], &sprite);
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+}
+
+TEST_F(SpatialGridTest, VisitInSceneOrder)
+{
+	// Moving the second row of sprites in a subtree that is visited after all the other sprites
+	nc::SceneNode group(&root_);
+	group.setDeleteChildrenOnDestruction(false);
+	for (unsigned int i = NumSpritesPerSide; i < NumSpritesPerSide * 2; i++)
+		sprites_[i]->setParent(&group);
+
+	// The default camera covers the whole resolution, the scissor rectangle limits the culling to the first three rows and columns
+	const int side = static_cast<int>(SpriteDistance * 2.5f);
+	TestViewport viewport;
+	viewport.setViewportRect(nc::theApplication().resolutionInt());
+	viewport.setScissorRect(0, 0, side, side);
+	viewport.setRootNode(&root_);
+	viewport.setCullingGridCellSize(CellSize);
+
+	nctl::Array<unsigned int> gridOrders;
+	visitOrders(viewport, gridOrders);
+	printf("Visiting %u sprites from the grid of a viewport\n", gridOrders.size());
+
+	// The order of the siblings changes after the sprites have been stored in the grid
+	root_.swapChildrenNodes(0, 1);
+	visitOrders(viewport, gridOrders);
+
+	nctl::Array<unsigned int> treeOrders;
+	viewport.setCullingGridCellSize(0.0f);
+	visitOrders(viewport, treeOrders);
+	printf("Visiting %u sprites from the scenegraph\n", treeOrders.size());
+
+	ASSERT_EQ(gridOrders.size(), 9u);
+	ASSERT_EQ(gridOrders.size(), treeOrders.size());
+	for (unsigned int i = 0; i < gridOrders.size(); i++)
+		ASSERT_EQ(gridOrders[i], treeOrders[i]);
+	ASSERT_GT(sprites_[0]->visitOrderIndex(), sprites_[1]->visitOrderIndex());
+	ASSERT_GT(sprites_[NumSpritesPerSide]->visitOrderIndex(), sprites_[2]->visitOrderIndex());
+}
+
+TEST_F(SpatialGridTest, DisableNode)
+{
+	updateCulling();
+	TestSprite &sprite = *sprites_[0];
+	printf("Disabling the drawing of the first sprite\n");
+	sprite.setDrawEnabled(false);
+	updateCulling();
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites - 1);
+	markOverlapping(nc::Rectf(-1.0f, -1.0f, 2.0f, 2.0f));
+	ASSERT_EQ(numMarked(), 0u);
+
+	printf("Enabling the drawing of the first sprite again\n");
+	sprite.setDrawEnabled(true);
+	updateCulling();
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+	markOverlapping(nc::Rectf(-1.0f, -1.0f, 2.0f, 2.0f));
+	ASSERT_EQ(numMarked(), 1u);
+}
+
+TEST_F(SpatialGridTest, ZeroSizeNode)
+{
+	updateCulling();
+	printf("Setting the size of the first sprite to zero\n");
+	sprites_[0]->setSize(0.0f, 0.0f);
+	updateCulling();
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites - 1);
+}
+
+TEST_F(SpatialGridTest, DetachNode)
+{
+	updateCulling();
+	TestSprite &sprite = *sprites_[0];
+	printf("Detaching the first sprite from the scene\n");
+	root_.removeChildNode(&sprite);
+
+	// The node is removed right away, as a viewport would not traverse it anymore
+	ASSERT_EQ(grid_.numNodes(), NumSprites - 1);
+	markOverlapping(nc::Rectf(-1.0f, -1.0f, 2.0f, 2.0f));
+	ASSERT_EQ(numMarked(), 0u);
+
+	printf("Attaching the first sprite again\n");
+	root_.addChildNode(&sprite);
+	updateCulling();
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+}
+
+TEST_F(SpatialGridTest, DetachAllNodes)
+{
+	updateCulling();
+	printf("Detaching all sprites from the scene\n");
+	root_.removeAllChildrenNodes();
+
+	ASSERT_EQ(grid_.numNodes(), 0u);
+}
+
+TEST_F(SpatialGridTest, DetachSubtree)
+{
+	nc::SceneNode parent(&root_);
+	parent.setDeleteChildrenOnDestruction(false);
+	for (unsigned int i = 0; i < NumSpritesPerSide; i++)
+		sprites_[i]->setParent(&parent);
+	updateCulling();
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+
+	printf("Detaching a subtree with %u sprites from the scene\n", NumSpritesPerSide);
+	parent.setParent(nullptr);
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites - NumSpritesPerSide);
+}
+
+TEST_F(SpatialGridTest, DeleteNode)
+{
+	updateCulling();
+	printf("Deleting the last sprite\n");
+	sprites_.popBack();
+
+	ASSERT_EQ(grid_.numNodes(), NumSprites - 1);
+}
+
+TEST_F(SpatialGridTest, DeleteGrid)
+{
+	updateCulling();
+	printf("Moving all sprites to a second grid and deleting it\n");
+	{
+		// The grid fixture member cannot be deleted, a second one is used to test the destructor
+		nctl::UniquePtr<nc::SpatialGrid> grid = nctl::makeUnique<nc::SpatialGrid>(CellSize);
+		ASSERT_NE(grid->id(), grid_.id());
+		root_.removeAllChildrenNodes();
+		for (nctl::UniquePtr<TestSprite> &sprite : sprites_)
+		{
+			sprite->setParent(&root_);
+			sprite->updateCulling(grid.get());
+		}
+		ASSERT_EQ(grid->numNodes(), NumSprites);
+	}
+
+	updateCulling();
+	ASSERT_EQ(grid_.numNodes(), NumSprites);
+}
+
+}
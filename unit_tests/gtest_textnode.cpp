@@ -0,0 +1,194 @@
+#include <cstring> // for memcmp()
+#include <ncine/Application.h>
+#include <ncine/TextNode.h>
+#include <ncine/Font.h>
+#include <ncine/Texture.h>
+#include <ncine/Random.h>
+#include <nctl/UniquePtr.h>
+#include "RenderQueue.h"
+#include "RenderCommand.h"
+#include "FontGlyph.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int MaxStringLength = 256;
+const unsigned int TextureSize = 256;
+const unsigned int GlyphSize = 16;
+/// Pieces of text from one to four bytes long, one of them is a newline
+const char *Pieces[] = { "a", "b", "T", "V", "A", " ", "\n", "\xc3\xa9", "\xc3\xa8", "\xc3\xbc", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+const unsigned int NumPieces = sizeof(Pieces) / sizeof(*Pieces);
+const unsigned int GlyphIds[] = { 'a', 'b', 'T', 'V', 'A', ' ', 0xe9, 0xe8, 0xfc, 0x20ac, 0x1f600 };
+const unsigned int NumGlyphIds = sizeof(GlyphIds) / sizeof(*GlyphIds);
+/// Kerning pairs as first glyph, second glyph and amount
+const int Kernings[][3] = { { 'T', 0xe9, -3 }, { 'T', 0xe8, -1 }, { 'V', 'a', -2 }, { 'A', 'V', -4 }, { 0xe9, 'T', -2 }, { 0x20ac, 0xfc, 3 } };
+const unsigned int NumKernings = sizeof(Kernings) / sizeof(*Kernings);
+
+const unsigned int MaxPieces = 48;
+const unsigned int NumEdits = 2000;
+const uint64_t RandomState = 0x2545f4914f6cdd1dULL;
+const uint64_t RandomSequence = 0x9e3779b97f4a7c15ULL;
+
+class TextNodeTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		nc::Application::RenderingSettings &settings = nc::theApplication().renderingSettings();
+		cullingEnabled_ = settings.cullingEnabled;
+		settings.cullingEnabled = false;
+
+		// Every glyph has a different advance, so that a misplaced glyph changes the layout
+		nctl::String fntBuffer(4096);
+		fntBuffer.format("info face=\"Test\" size=%u bold=0 italic=0 charset=\"\" unicode=1 stretchH=100 smooth=1 aa=1 padding=0,0,0,0 spacing=0,0 outline=0\n", GlyphSize);
+		fntBuffer.formatAppend("common lineHeight=%u base=%u scaleW=%u scaleH=%u pages=1 packed=0 alphaChnl=0 redChnl=4 greenChnl=4 blueChnl=4\n",
+		                       GlyphSize, GlyphSize - 4, TextureSize, TextureSize);
+		fntBuffer.formatAppend("page id=0 file=\"Test.png\"\n");
+		fntBuffer.formatAppend("chars count=%u\n", NumGlyphIds);
+		for (unsigned int i = 0; i < NumGlyphIds; i++)
+		{
+			fntBuffer.formatAppend("char id=%u x=%u y=0 width=%u height=%u xoffset=0 yoffset=0 xadvance=%u page=0 chnl=15\n",
+			                       GlyphIds[i], i * GlyphSize, GlyphSize, GlyphSize, 5 + i * 2);
+		}
+		fntBuffer.formatAppend("kernings count=%u\n", NumKernings);
+		for (unsigned int i = 0; i < NumKernings; i++)
+			fntBuffer.formatAppend("kerning first=%d second=%d amount=%d\n", Kernings[i][0], Kernings[i][1], Kernings[i][2]);
+
+		texture_ = nctl::makeUnique<nc::Texture>("TextNodeTest", nc::Texture::Format::R8, TextureSize, TextureSize);
+		font_ = nctl::makeUnique<nc::Font>("Test.fnt", reinterpret_cast<const unsigned char *>(fntBuffer.data()), fntBuffer.length(), texture_.get());
+		ASSERT_EQ(font_->numGlyphs(), NumGlyphIds);
+		ASSERT_EQ(font_->numKernings(), NumKernings);
+	}
+
+	void TearDown() override
+	{
+		nc::theApplication().renderingSettings().cullingEnabled = cullingEnabled_;
+	}
+
+	/// Checks that a node laid out incrementally has the same size and vertices as a new one with the same string
+	void checkSameLayout(nc::TextNode &node)
+	{
+		nc::TextNode freshNode(nullptr, font_.get(), MaxStringLength);
+		freshNode.setAlignment(node.alignment());
+		freshNode.setString(node.string());
+
+		const nc::Vector2f boundaries = nc::TextNode::calculateBoundaries(*font_, true, node.string());
+		ASSERT_EQ(node.width(), boundaries.x) << "String: \"" << node.string().data() << "\"";
+		ASSERT_EQ(node.height(), boundaries.y);
+		ASSERT_EQ(freshNode.width(), boundaries.x);
+
+		const nc::RenderCommand *command = drawNode(node);
+		const nc::RenderCommand *freshCommand = drawNode(freshNode);
+		ASSERT_EQ(command == nullptr, freshCommand == nullptr);
+		if (command == nullptr)
+			return;
+
+		const nc::Geometry &geometry = command->geometry();
+		const nc::Geometry &freshGeometry = freshCommand->geometry();
+		ASSERT_EQ(geometry.numVertices(), freshGeometry.numVertices());
+		// Every vertex has a position and texture coordinates
+		const size_t numBytes = geometry.numVertices() * 4 * sizeof(float);
+		ASSERT_EQ(memcmp(geometry.hostVertexPointer(), freshGeometry.hostVertexPointer(), numBytes), 0) << "String: \"" << node.string().data() << "\"";
+	}
+
+	/// Draws a node in a queue of its own, returning its render command or `nullptr` if it has nothing to draw
+	const nc::RenderCommand *drawNode(nc::TextNode &node)
+	{
+		nc::RenderQueue renderQueue;
+		if (node.draw(renderQueue) == false)
+			return nullptr;
+		return renderQueue.transparentQueue().isEmpty() ? renderQueue.opaqueQueue()[0] : renderQueue.transparentQueue()[0];
+	}
+
+	nctl::UniquePtr<nc::Texture> texture_;
+	nctl::UniquePtr<nc::Font> font_;
+	bool cullingEnabled_;
+};
+
+/// Concatenates the pieces of text with the specified indices
+void buildString(const unsigned int *pieces, unsigned int numPieces, nctl::String &string)
+{
+	string.clear();
+	for (unsigned int i = 0; i < numPieces; i++)
+		string.append(Pieces[pieces[i]]);
+}
+
+TEST_F(TextNodeTest, ChangeContinuationByte)
+{
+	nc::TextNode node(nullptr, font_.get(), MaxStringLength);
+	printf("Changing only the continuation byte of the last codepoint, with a different kerning\n");
+	node.setString("T\xc3\xa9");
+	checkSameLayout(node);
+
+	node.setString("T\xc3\xa8");
+	checkSameLayout(node);
+	const float expectedWidth = font_->glyph('T')->xAdvance() + font_->glyph(0xe8)->xAdvance() + font_->kerning('T', 0xe8);
+	ASSERT_EQ(node.width(), expectedWidth);
+}
+
+TEST_F(TextNodeTest, ChangeLastContinuationByte)
+{
+	nc::TextNode node(nullptr, font_.get(), MaxStringLength);
+	printf("Changing only the last continuation byte of a codepoint in the middle of the string\n");
+	node.setString("A\xe2\x82\xac\xc3\xbc");
+	checkSameLayout(node);
+
+	// The Euro sign becomes U+20AD, which has no glyph nor kerning
+	node.setString("A\xe2\x82\xad\xc3\xbc");
+	checkSameLayout(node);
+	node.setString("A\xe2\x82\xac\xc3\xbc");
+	checkSameLayout(node);
+}
+
+TEST_F(TextNodeTest, RandomEdits)
+{
+	nc::Random random(RandomState, RandomSequence);
+	unsigned int pieces[MaxPieces];
+	unsigned int numPieces = 0;
+	nctl::String string(MaxStringLength);
+
+	nc::TextNode node(nullptr, font_.get(), MaxStringLength);
+	node.setAlignment(nc::TextNode::Alignment::CENTER);
+	printf("Laying out a string incrementally after %u random edits and comparing it with a new layout\n", NumEdits);
+	for (unsigned int edit = 0; edit < NumEdits; edit++)
+	{
+		const unsigned int operation = random.integer(0, 4);
+		const unsigned int index = (numPieces > 0) ? random.integer(0, numPieces) : 0;
+		if (operation == 0 && numPieces < MaxPieces)
+		{
+			// Inserting a piece
+			for (unsigned int i = numPieces; i > index; i--)
+				pieces[i] = pieces[i - 1];
+			pieces[index] = random.integer(0, NumPieces);
+			numPieces++;
+		}
+		else if (operation == 1 && numPieces > 0)
+		{
+			// Removing a piece
+			for (unsigned int i = index; i < numPieces - 1; i++)
+				pieces[i] = pieces[i + 1];
+			numPieces--;
+		}
+		else if (numPieces > 0)
+		{
+			// Replacing a piece, often with one of the same length that only differs in its continuation bytes
+			const unsigned int oldPiece = pieces[index];
+			if (operation == 2 && (oldPiece == 7 || oldPiece == 8 || oldPiece == 9))
+				pieces[index] = 7 + random.integer(0, 3);
+			else
+				pieces[index] = random.integer(0, NumPieces);
+		}
+		else
+			pieces[numPieces++] = random.integer(0, NumPieces);
+
+		buildString(pieces, numPieces, string);
+		node.setString(string);
+		// Some edits are merged with the following one before the string is laid out
+		if (random.integer(0, 4) > 0)
+			checkSameLayout(node);
+	}
+}
+
+}
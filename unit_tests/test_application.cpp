@@ -0,0 +1,39 @@
+#include <ncine/Application.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/IAppEventHandler.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+/// The event handler of a headless application that runs all the tests from its initialization callback
+/*! \note It is used by the tests that need the rendering resources of a running application, like a node or a texture */
+class TestEventHandler : public nc::IAppEventHandler
+{
+  public:
+	void onPreInit(nc::AppConfiguration &config) override
+	{
+		// Tests can still be selected with the `GTEST_FILTER` environment variable
+		::testing::InitGoogleTest();
+
+		config.consoleLogLevel = nc::ILogger::LogLevel::WARN;
+		config.withAudio = false;
+		config.withDebugOverlay = false;
+		config.headlessFrames = 1;
+	}
+
+	void onInit() override
+	{
+		const int result = RUN_ALL_TESTS();
+		nc::theApplication().setExitCode(result);
+		nc::theApplication().quit();
+	}
+};
+
+}
+
+nctl::UniquePtr<nc::IAppEventHandler> createAppEventHandler()
+{
+	return nctl::makeUnique<TestEventHandler>();
+}